@@ -0,0 +1,27 @@
+# Check for LZ4.
+# If LZ4 isn't found, extlib/lz4/ will be used instead.
+IF(NOT DEFINED HAVE_LZ4)
+
+IF(NOT USE_INTERNAL_LZ4)
+	FIND_PATH(LZ4_INCLUDE_DIR lz4.h)
+	FIND_LIBRARY(LZ4_LIBRARY lz4)
+	IF(LZ4_INCLUDE_DIR AND LZ4_LIBRARY)
+		# System LZ4 was found.
+		SET(LZ4_FOUND 1)
+	ENDIF(LZ4_INCLUDE_DIR AND LZ4_LIBRARY)
+ENDIF(NOT USE_INTERNAL_LZ4)
+
+IF(NOT LZ4_FOUND)
+	# System LZ4 was not found.
+	# Use the included copy of LZ4.
+	SET(LZ4_LIBRARY lz4)
+	SET(LZ4_FOUND 1)
+	SET(LZ4_INCLUDE_DIR "${CMAKE_SOURCE_DIR}/extlib/lz4/")
+	SET(USE_INTERNAL_LZ4 1)
+	MESSAGE(STATUS "Using internal LZ4")
+ENDIF(NOT LZ4_FOUND)
+
+# LZ4 is always available.
+SET(HAVE_LZ4 1)
+
+ENDIF(NOT DEFINED HAVE_LZ4)
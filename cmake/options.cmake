@@ -37,6 +37,10 @@ ENDIF(NOT WIN32)
 # Default is to use external popt if available.
 OPTION(USE_INTERNAL_POPT "Always use the internal copy of popt." 0)
 
+# Internal LZ4.
+# Default is to use external LZ4 if available.
+OPTION(USE_INTERNAL_LZ4 "Always use the internal copy of LZ4." 0)
+
 # Frontends.
 OPTION(ENABLE_GENS_QT4 "Enable the Qt4 UI. (EXPERIMENTAL; has frame dropping issues)" 0)
 OPTION(ENABLE_GENS_SDL "Enable the SDL2 UI. (Technical Preview)" 1)
@@ -44,6 +48,9 @@ OPTION(ENABLE_GENS_SDL "Enable the SDL2 UI. (Technical Preview)" 1)
 # Additional stuff.
 OPTION(BUILD_DOC "Build documentation." 1)
 
+# Long-running tests. (ZEXDOC/ZEXALL take several minutes.)
+OPTION(GENS_LONG_TESTS "Add long-running tests to the default test run." 0)
+
 # ANSI Windows support. (32-bit Windows only.)
 IF(WIN32 AND CMAKE_SIZEOF_VOID_P EQUAL 4)
 	OPTION(ENABLE_ANSI_WINDOWS "Enable support for ANSI Windows." 1)
@@ -53,6 +60,10 @@ ELSE()
 	SET(ENABLE_ANSI_WINDOWS 0)
 ENDIF()
 
+# Hot-path profiler.
+# This adds timing overhead to the emulation core.
+OPTION(ENABLE_PROFILER "Enable the libgens hot-path profiler." 0)
+
 # Link-time optimization.
 OPTION(ENABLE_LTO "Enable link-time optimization. (Release builds only)" 0)
 
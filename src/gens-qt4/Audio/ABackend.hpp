@@ -61,6 +61,13 @@ class ABackend
 		 */
 		virtual int write(void) = 0;
 
+		/**
+		 * Get the number of segments waiting in the audio buffer.
+		 * Used by the emulation thread to pace itself to audio.
+		 * @return Number of buffered segments, or 0 if audio isn't open.
+		 */
+		virtual int bufferedSegments(void) = 0;
+
 		virtual void wpSegWait(void) const = 0;
 		virtual bool isBufferEmpty(void) const = 0;
 
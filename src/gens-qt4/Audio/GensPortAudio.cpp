@@ -35,6 +35,8 @@ using LibGens::SoundMgr;
 
 // aligned_malloc()
 #include "libcompat/aligned_malloc.h"
+// Atomic operations.
+#include "libcompat/atomic.h"
 
 // Qt includes.
 #include <QtCore/QMutexLocker>
@@ -46,6 +48,8 @@ GensPortAudio::GensPortAudio()
 	// Clear internal variables.
 	m_bufferPos = 0;
 	m_sampleSize = 0;
+	thread_sched_params_init(&m_threadSched);
+	m_threadSchedPending = 0;
 
 	// FIXME: SoundMgr::writeStereo() requires a 16-byte
 	// aligned destination buffer for SSE2.
@@ -246,6 +250,17 @@ int GensPortAudio::gensPaCallback(const void *inputBuffer, void *outputBuffer,
 	((void)timeInfo);
 	((void)statusFlags);
 
+	// Apply the callback thread scheduling parameters, if requested.
+	if (ATOMIC_LOAD_ACQUIRE(&m_threadSchedPending) &&
+	    ATOMIC_CMPXCHG(&m_threadSchedPending, 1, 0))
+	{
+		int ret = thread_sched_apply(&m_threadSched);
+		if (ret != 0) {
+			LOG_MSG(audio, LOG_MSG_LEVEL_WARNING,
+				"Could not set audio thread scheduling: %s", strerror(-ret));
+		}
+	}
+
 	QMutexLocker locker(&m_mtxBuffer);
 
 	// NOTE: Sample size is 16-bit, but we're using 8-bit here
@@ -275,6 +290,9 @@ int GensPortAudio::gensPaCallback(const void *inputBuffer, void *outputBuffer,
 		}
 	}
 
+	// Wake up the emulation thread if it's
+	// waiting for room in the buffer.
+	m_cvBuffer.wakeAll();
 	return 0;
 }
 
@@ -310,7 +328,8 @@ int GensPortAudio::write(void)
 	memcpy(buf, m_tmpWriteBuf, written * m_sampleSize);
 
 	// Increment the buffer position.
-	m_bufferPos += written;
+	// NOTE: m_bufferPos is in bytes, not samples.
+	m_bufferPos += written * m_sampleSize;
 
 	// Unlock the ring buffer.
 	// TODO
@@ -321,4 +340,59 @@ int GensPortAudio::write(void)
 	return (written == segLength ? 0 : 1);
 }
 
+/**
+ * Get the number of segments waiting in the audio buffer.
+ * Used by the emulation thread to pace itself to audio.
+ * @return Number of buffered segments, or 0 if audio isn't open.
+ */
+int GensPortAudio::bufferedSegments(void)
+{
+	QMutexLocker locker(&m_mtxBuffer);
+
+	if (!m_open || m_sampleSize == 0)
+		return 0;
+
+	const int cbSegSize = SoundMgr::GetSegLength() * m_sampleSize;
+	return (int)(m_bufferPos / cbSegSize);
+}
+
+/**
+ * Wait for the PortAudio callback to consume audio
+ * if more than maxSegments segments are buffered.
+ * Used by the emulation thread to pace itself to audio.
+ * @param maxSegments Maximum number of buffered segments.
+ * @param timeout Maximum time to wait, in milliseconds.
+ * @return Number of buffered segments, or 0 if audio isn't open.
+ */
+int GensPortAudio::waitForBuffer(int maxSegments, unsigned long timeout)
+{
+	QMutexLocker locker(&m_mtxBuffer);
+
+	if (!m_open || m_sampleSize == 0)
+		return 0;
+
+	const int cbSegSize = SoundMgr::GetSegLength() * m_sampleSize;
+	if ((int)(m_bufferPos / cbSegSize) > maxSegments) {
+		// The callback signals m_cvBuffer after consuming data.
+		m_cvBuffer.wait(&m_mtxBuffer, timeout);
+		if (!m_open || m_sampleSize == 0)
+			return 0;
+	}
+
+	return (int)(m_bufferPos / cbSegSize);
+}
+
+/**
+ * Set scheduling parameters for the PortAudio callback thread.
+ * PortAudio creates the thread internally, so the parameters
+ * are applied by the first callback after open().
+ * NOTE: Call this before open().
+ * @param params Thread scheduling parameters.
+ */
+void GensPortAudio::setThreadSched(const thread_sched_params_t *params)
+{
+	m_threadSched = *params;
+	ATOMIC_STORE_RELEASE(&m_threadSchedPending, 1);
+}
+
 }
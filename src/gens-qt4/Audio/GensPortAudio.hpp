@@ -34,10 +34,14 @@
 
 // Qt includes.
 #include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
 
 // Audio Ring Buffer.
 #include "ARingBuffer.hpp"
 
+// Thread scheduling.
+#include "libcompat/thread_sched.h"
+
 namespace GensQt4 {
 
 class GensPortAudio : public ABackend
@@ -67,6 +71,32 @@ class GensPortAudio : public ABackend
 		 */
 		int write(void);
 
+		/**
+		 * Get the number of segments waiting in the audio buffer.
+		 * Used by the emulation thread to pace itself to audio.
+		 * @return Number of buffered segments, or 0 if audio isn't open.
+		 */
+		int bufferedSegments(void);
+
+		/**
+		 * Wait for the PortAudio callback to consume audio
+		 * if more than maxSegments segments are buffered.
+		 * Used by the emulation thread to pace itself to audio.
+		 * @param maxSegments Maximum number of buffered segments.
+		 * @param timeout Maximum time to wait, in milliseconds.
+		 * @return Number of buffered segments, or 0 if audio isn't open.
+		 */
+		int waitForBuffer(int maxSegments, unsigned long timeout);
+
+		/**
+		 * Set scheduling parameters for the PortAudio callback thread.
+		 * PortAudio creates the thread internally, so the parameters
+		 * are applied by the first callback after open().
+		 * NOTE: Call this before open().
+		 * @param params Thread scheduling parameters.
+		 */
+		void setThreadSched(const thread_sched_params_t *params);
+
 		void wpSegWait(void) const { /*m_buffer.wpSegWait();*/ }
 		bool isBufferEmpty(void) const { return true; /*return m_buffer.isBufferEmpty();*/ }
 
@@ -98,6 +128,7 @@ class GensPortAudio : public ABackend
 		int16_t m_buffer[1024*SEGMENTS_TO_BUFFER*2];
 		unsigned long m_bufferPos; // Byte position in m_buffer.
 		QMutex m_mtxBuffer;
+		QWaitCondition m_cvBuffer; // Signaled when the callback consumes data.
 
 		// Sample size. (Calculated on open().)
 		int m_sampleSize;
@@ -107,6 +138,12 @@ class GensPortAudio : public ABackend
 		// GensPortAudio will be removed later, so I'm using
 		// a bounce buffer as a workaround.
 		int16_t *m_tmpWriteBuf;
+
+		// Callback thread scheduling parameters.
+		// m_threadSchedPending is set if the callback
+		// should apply them. (Accessed atomically.)
+		thread_sched_params_t m_threadSched;
+		int m_threadSchedPending;
 };
 
 }
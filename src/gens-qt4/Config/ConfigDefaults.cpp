@@ -103,6 +103,19 @@ const ConfigDefaults::DefaultSetting ConfigDefaults::DefaultSettings[] =
 	/** Emulation options. (Options menu) **/
 	{"Options/enableSRam", "true", 0, 0, DefaultSetting::VT_BOOL, 0, 0},
 
+	/** Thread placement and scheduling. **/
+	// These settings take effect when a ROM is loaded.
+	// CPU numbers are 0-based; -1 allows any CPU.
+	// schedPolicy is thread_sched_policy_t. (0 == normal, 1 == FIFO, 2 == RR)
+	{"Threads/emuCpu",		"-1", 0, 0,		DefaultSetting::VT_RANGE, -1, 1023},
+	{"Threads/audioCpu",		"-1", 0, 0,		DefaultSetting::VT_RANGE, -1, 1023},
+	{"Threads/renderCpu",		"-1", 0, 0,		DefaultSetting::VT_RANGE, -1, 1023},
+	{"Threads/schedPolicy",		"0", 0, 0,		DefaultSetting::VT_RANGE, 0, 2},
+	{"Threads/rtPriority",		"10", 0, 0,		DefaultSetting::VT_RANGE, 1, 98},
+	{"Threads/nice",		"0", 0, 0,		DefaultSetting::VT_RANGE, -20, 19},
+	{"Threads/lockMemory",		"false", 0, 0,		DefaultSetting::VT_BOOL, 0, 0},
+	{"Threads/jitterReport",	"false", 0, 0,		DefaultSetting::VT_BOOL, 0, 0},
+
 	/** End of array. **/
 	{nullptr, nullptr, 0, 0, DefaultSetting::VT_NONE, 0, 0}
 };
@@ -29,6 +29,7 @@
 // LibGens includes.
 #include "libgens/Util/Timing.hpp"
 #include "libgens/Rom.hpp"
+#include "libgens/macros/log_msg.h"
 using LibGens::Rom;
 
 #include "libgens/EmuContext/EmuContext.hpp"
@@ -45,9 +46,13 @@ using LibGens::SysVersion;
 // Audio backend.
 #include "Audio/GensPortAudio.hpp"
 
+// Thread scheduling.
+#include "libcompat/thread_sched.h"
+
 // LibGens video includes.
 #include "libgens/Vdp/Vdp.hpp"
 #include "libgens/Vdp/VdpPalette.hpp"
+#include "libgens/Util/MdFbTriple.hpp"
 
 // M68K_Mem.hpp has SysRegion.
 #include "libgens/cpu/M68K_Mem.hpp"
@@ -58,6 +63,9 @@ using LibGens::SysVersion;
 // libzomg. Needed for savestate preview images.
 #include "libzomg/Zomg.hpp"
 
+// C includes. (C++ namespace)
+#include <cstring>
+
 // Qt includes.
 #include <QtCore/QTimer>
 #include <QtGui/QApplication>
@@ -84,11 +92,15 @@ EmuManager::EmuManager(QObject *parent, VBackend *vBackend)
 	, m_vBackend(vBackend)
 	, m_romClosedFb(nullptr)
 {
-	// Initialize timing information.
-	m_lastTime = 0;
+	// Initialize the FPS counter.
 	m_lastTime_fps = 0;
 	m_frames = 0;
 
+	// No I/O state has been latched yet.
+	memset(&m_ioState, 0, sizeof(m_ioState));
+	memset(&m_ioLatch, 0, sizeof(m_ioLatch));
+	m_ioLatchDirty = false;
+
 	// No ROM is loaded at startup.
 	m_rom = nullptr;
 	m_paused.data = 0;
@@ -459,17 +471,49 @@ int EmuManager::loadRom_int(LibGens::Rom *rom)
 	// indicates that a game is running.
 	// TODO: Use gqt4_emuContext instead?
 
+	// Thread scheduling parameters.
+	thread_sched_params_t emuSched, audioSched, renderSched;
+	thread_sched_params_init(&emuSched);
+	emuSched.cpu = gqt4_cfg->getInt(QLatin1String("Threads/emuCpu"));
+	emuSched.policy = gqt4_cfg->getInt(QLatin1String("Threads/schedPolicy"));
+	emuSched.priority = gqt4_cfg->getInt(QLatin1String("Threads/rtPriority"));
+	emuSched.nice = gqt4_cfg->getInt(QLatin1String("Threads/nice"));
+
+	// The audio thread runs one priority level above the
+	// emulation thread so it can preempt it.
+	audioSched = emuSched;
+	audioSched.cpu = gqt4_cfg->getInt(QLatin1String("Threads/audioCpu"));
+	if (audioSched.policy != THREAD_SCHED_NORMAL)
+		audioSched.priority++;
+
+	// The render thread is the GUI thread. It only gets
+	// CPU placement and niceness; a real-time GUI thread
+	// could starve the rest of the system.
+	thread_sched_params_init(&renderSched);
+	renderSched.cpu = gqt4_cfg->getInt(QLatin1String("Threads/renderCpu"));
+	renderSched.nice = emuSched.nice;
+	int ret = thread_sched_apply(&renderSched);
+	if (ret != 0) {
+		LOG_MSG(gens, LOG_MSG_LEVEL_WARNING,
+			"Could not set render thread scheduling: %s", strerror(-ret));
+	}
+
 	// Open audio.
+	m_audio->setThreadSched(&audioSched);
 	m_audio->open();
 
-	// Initialize timing information.
-	m_lastTime = 0;
-	m_lastTime_fps = m_lastTime;
+	// Initialize the FPS counter.
+	m_lastTime_fps = 0;
 	m_frames = 0;
 
 	// Initialize controllers.
+	// The emulation thread hasn't been started yet,
+	// so the I/O Manager can be updated directly.
 	// TODO: Clear key state?
-	gqt4_cfg->m_keyManager->updateIoManager(gqt4_emuContext->m_ioManager);
+	gqt4_cfg->m_keyManager->getIoState(&m_ioState);
+	LibGensKeys::KeyManager::applyIoState(&m_ioState, gqt4_emuContext->m_ioManager);
+	m_ioLatch = m_ioState;
+	m_ioLatchDirty = false;
 
 	// Set the EmuContext settings.
 	// TODO: Load these in EmuContext directly?
@@ -498,11 +542,24 @@ int EmuManager::loadRom_int(LibGens::Rom *rom)
 
 	// Start the emulation thread.
 	m_paused.data = 0;
-	gqt4_emuThread = new EmuThread();
-	QObject::connect(gqt4_emuThread, SIGNAL(frameDone(bool)),
-			 this, SLOT(emuFrameDone(bool)));
+	gqt4_emuThread = new EmuThread(this);
+	gqt4_emuThread->setThreadSched(&emuSched,
+		gqt4_cfg->get(QLatin1String("Threads/jitterReport")).toBool());
+	QObject::connect(gqt4_emuThread, SIGNAL(frameDone()),
+			 this, SLOT(emuFrameDone()));
 	gqt4_emuThread->start();
 
+	if (gqt4_cfg->get(QLatin1String("Threads/lockMemory")).toBool()) {
+		// Lock the pages that are currently mapped.
+		// This is done after everything above has been
+		// allocated, so the emulation state is included.
+		ret = mem_lock_all();
+		if (ret != 0) {
+			LOG_MSG(gens, LOG_MSG_LEVEL_WARNING,
+				"Could not lock memory: %s", strerror(-ret));
+		}
+	}
+
 	// Update the Gens title.
 	emit stateChanged();
 	return 0;
@@ -550,6 +607,14 @@ int EmuManager::closeRom(bool emitStateChanged)
 		gqt4_emuThread = nullptr;
 	}
 
+	// Finish any requests that were queued before the ROM
+	// was closed, e.g. savestates. The emulation thread has
+	// stopped, so they're processed on this thread.
+	processQEmuRequest();
+
+	// Requests for this ROM can't be processed anymore.
+	clearQEmuRequest();
+
 	if (gqt4_emuContext) {
 		if (emitStateChanged) {
 			LibGens::MdFb *prevFb = m_romClosedFb;
@@ -688,113 +753,74 @@ QString EmuManager::getSaveStateFilename(void)
 }
 
 /**
- * Emulation thread is finished rendering a frame.
- * @param wasFastFrame The frame was rendered "fast", i.e. no VDP updates.
+ * Emulation thread has published a frame.
  */
-void EmuManager::emuFrameDone(bool wasFastFrame)
+void EmuManager::emuFrameDone(void)
 {
 	// Make sure the emulation thread is still running.
 	if (!gqt4_emuThread || gqt4_emuThread->isStopRequested())
 		return;
 
-	// FIXME: This code is terrible.
-	if (!wasFastFrame)
-		m_frames++;
+	// Acknowledge the frame first so a frame published
+	// while we're updating video isn't missed.
+	gqt4_emuThread->frameAck();
 
-	uint64_t timeDiff;
-	uint64_t thisTime = m_timing.getTime();
-	
-	if (m_lastTime < 1000) {
+	// Update the FPS counter.
+	// NOTE: The emulation thread may have rendered more
+	// frames than we've been notified about.
+	const uint64_t thisTime = m_timing.getTime();
+	const unsigned int frames = gqt4_emuThread->framesRendered();
+	if (m_lastTime_fps == 0) {
 		// Just started.
-		m_lastTime = thisTime;
-		m_lastTime_fps = m_lastTime;
-		timeDiff = 0;
+		m_lastTime_fps = thisTime;
+		m_frames = frames;
 	} else {
-		// Get the time difference.
-		timeDiff = (thisTime - m_lastTime);
-
-		// Check the FPS counter.
-		uint64_t timeDiff_fps = (thisTime - m_lastTime_fps);
+		const uint64_t timeDiff_fps = (thisTime - m_lastTime_fps);
 		if (timeDiff_fps >= 250000) {
 			// More than 250ms since last FPS update.
 			// Push the current fps.
 			// (Updated four times per second.)
-			double fps = ((double)m_frames / (timeDiff_fps / 1000000.0));
+			const double fps = ((double)(frames - m_frames) / (timeDiff_fps / 1000000.0));
 			emit updateFps(fps);
 
 			// Reset the timer and frame counter.
 			m_lastTime_fps = thisTime;
-			m_frames = 0;
+			m_frames = frames;
 		}
 	}
 
-	// Check for SRam/EEPRom autosave.
-	// TODO: Frames elapsed.
-	gqt4_emuContext->autoSaveData(1);
-
-	// Check for requests in the emulation queue.
-	if (!m_qEmuRequest.isEmpty())
-		processQEmuRequest();
-
-	// Update the I/O Manager.
-	if (m_keyManager) {
-		m_keyManager->updateIoManager(gqt4_emuContext->m_ioManager);
-	}
+	// Latch the current controller state.
+	// Key events latch it as soon as they arrive;
+	// this picks up anything that changed otherwise.
+	updateIoState();
 
 	// Update the Video Backend.
-	if (!wasFastFrame)
-		updateVBackend();
+	updateVBackend();
+}
 
-	// If emulation is paused, don't resume the emulation thread.
-	if (m_paused.data)
+/**
+ * Latch the current I/O state for the emulation thread.
+ * The KeyManager is only accessed on the UI thread.
+ * Call this whenever the controller state changes.
+ * Nothing is latched if the I/O state hasn't changed.
+ */
+void EmuManager::updateIoState(void)
+{
+	if (!m_keyManager)
 		return;
 
-	/** Auto Frame Skip **/
-	// TODO: Figure out how to properly implement the old Gens method of synchronizing to audio.
-#if 0
-	// Check if we should do a fast frame.
-	// TODO: Audio stutters a bit if the video drops below 60.0 fps.
-	m_audio->wpSegWait();	// Wait for the buffer to empty.
-	m_audio->write();	// Write audio.
-	bool doFastFrame = !m_audio->isBufferEmpty();
-#else
-	// TODO: Remove the ring buffer and just use the classic SDL-esque method.
-	m_audio->write();	// Write audio.
-#endif
-
-	// Check if we're higher or lower than the required framerate.
-	bool doFastFrame = false;
-	const uint64_t frameRate = (1000000 /
-			(gqt4_emuContext->versionRegisterObject()->isPal() ? 50 : 60));
-	const uint64_t threshold = 1000;
-	if (timeDiff > (frameRate + threshold)) {
-		// Lower than the required framerate.
-		// Do a fast frame.
-		//printf("doing fast frame; ");
-		doFastFrame = true;
-	} else if (timeDiff < (frameRate - threshold)) {
-		// Higher than the required framerate.
-		// Wait for the required amount of time.
-		do {
-			thisTime = m_timing.getTime();
-			timeDiff = (thisTime - m_lastTime);
-
-			// NOTE: Putting usleep(0) here reduces CPU usage,
-			// but increases stuttering.
-			// TODO: Fix framedropping entirely.
-			//usleep(0);
-		} while (timeDiff < frameRate);
-		
-		// TODO: This causes some issues...
-		if (timeDiff > (frameRate + threshold))
-			doFastFrame = true;
-	}
-	// Update the last time value.
-	m_lastTime = thisTime;
-
-	// Tell the emulation thread that we're ready for another frame.
-	if (gqt4_emuThread)
-		gqt4_emuThread->resume(doFastFrame);
+	LibGensKeys::KeyManager::IoState_t ioState;
+	m_keyManager->getIoState(&ioState);
+	if (!memcmp(&ioState, &m_ioState, sizeof(ioState)))
+		return;
+	m_ioState = ioState;
+
+	// The emulation thread applies the latched
+	// state before it runs the next frame.
+	m_mtxIoLatch.lock();
+	m_ioLatch = ioState;
+	m_ioLatchDirty = true;
+	m_mtxIoLatch.unlock();
 }
 
 /** Video Backend. **/
@@ -839,14 +865,23 @@ void EmuManager::updateVBackend(void)
 	if (!m_vBackend)
 		return;
 
-	m_vBackend->setMdScreenDirty();
 	m_vBackend->setVbDirty();
 
-	if (gqt4_emuContext) {
+	if (gqt4_emuThread) {
+		// Pick up the most recent frame from the emulation thread.
+		// If there isn't a new one, the previous frame is redrawn
+		// without re-uploading it. (Unchanged frames aren't published.)
+		LibGens::MdFbTriple *const fbTriple = gqt4_emuThread->fbTriple();
+		if (fbTriple->acquire())
+			m_vBackend->setMdScreenDirty();
+		m_vBackend->vbUpdate(fbTriple->frontFb());
+	} else if (gqt4_emuContext) {
 		const LibGens::Vdp *vdp = gqt4_emuContext->m_vdp;
+		m_vBackend->setMdScreenDirty();
 		m_vBackend->vbUpdate(vdp->MD_Screen);
 	} else {
 		// TODO: Create blank MdFb with default color depth from ConfigStore?
+		m_vBackend->setMdScreenDirty();
 		m_vBackend->vbUpdate(nullptr);
 	}
 }
@@ -26,7 +26,7 @@
 
 // Qt includes.
 #include <QtCore/QObject>
-#include <QtCore/QQueue>
+#include <QtCore/QMutex>
 #include <QtGui/QImage>
 
 // LibGens includes.
@@ -42,11 +42,17 @@
 // Video Backend.
 #include "VBackend/VBackend.hpp"
 
+// Emulation Request Queue.
+#include "libgens/Util/MpscQueue.hpp"
+
 namespace GensQt4 {
 
 // Audio backend.
 class GensPortAudio;
 
+// Emulation thread.
+class EmuThread;
+
 class EmuManager : public QObject
 {
 	Q_OBJECT
@@ -146,11 +152,10 @@ class EmuManager : public QObject
 		 */
 		int closeRom(bool emitStateChanged);
 
-		// Timing management.
+		// FPS counter.
 		LibGens::Timing m_timing;
-		uint64_t m_lastTime;		// Last time a frame was updated.
 		uint64_t m_lastTime_fps;	// Last time value used for FPS counter.
-		int m_frames;
+		unsigned int m_frames;		// EmuThread::framesRendered() at m_lastTime_fps.
 
 		// ROM object.
 		LibGens::Rom *m_rom;
@@ -174,7 +179,7 @@ class EmuManager : public QObject
 
 	protected slots:
 		// Frame done signal from EmuThread.
-		void emuFrameDone(bool wasFastFrame);
+		void emuFrameDone(void);
 
 		// Calls openRom_int() with the stored filename.
 		// HACK: Works around the threading issue when opening a new ROM without closing the old one.
@@ -194,6 +199,27 @@ class EmuManager : public QObject
 			{ return m_keyManager; }
 		void setKeyManager(LibGensKeys::KeyManager *keyManager)
 			{ m_keyManager = keyManager; }
+	protected:
+		// Last I/O state latched for the emulation thread.
+		// (UI thread only.)
+		LibGensKeys::KeyManager::IoState_t m_ioState;
+
+		// I/O state latch. (Protected by m_mtxIoLatch.)
+		// Written by the UI thread when the controller state
+		// changes; applied by the emulation thread before
+		// every frame, including fast frames.
+		QMutex m_mtxIoLatch;
+		LibGensKeys::KeyManager::IoState_t m_ioLatch;
+		bool m_ioLatchDirty;
+
+	public slots:
+		/**
+		 * Latch the current I/O state for the emulation thread.
+		 * The KeyManager is only accessed on the UI thread.
+		 * Call this whenever the controller state changes.
+		 * Nothing is latched if the I/O state hasn't changed.
+		 */
+		void updateIoState(void);
 
 	/** Video Backend. **/
 	public:
@@ -302,7 +328,6 @@ class EmuManager : public QObject
 				RQT_RESET,
 				RQT_AUTOFIX_CHANGE,
 				RQT_PALETTE_SETTING,
-				RQT_SAVE_SLOT,
 				RQT_RESET_CPU,
 				RQT_REGION_CODE,
 				RQT_ENABLE_SRAM,
@@ -374,8 +399,43 @@ class EmuManager : public QObject
 
 		/**
 		 * Emulation Request Queue.
+		 * Lock-free queue with any number of producers and
+		 * a single consumer. (the emulation thread if it's
+		 * running; otherwise, the UI thread)
+		 */
+		static const unsigned int EMU_REQUEST_QUEUE_SIZE = 64;
+		LibGens::MpscQueue<EmuRequest_t, EMU_REQUEST_QUEUE_SIZE> m_qEmuRequest;
+
+		/**
+		 * Queue an emulation request.
+		 * If the emulation thread is running, it will process
+		 * the request before the next frame. Otherwise, the
+		 * request is processed immediately.
+		 * @param rq Emulation request.
+		 */
+		void queueEmuRequest(const EmuRequest_t &rq);
+
+		/**
+		 * Discard all pending emulation requests.
+		 * The emulation thread must not be running.
+		 */
+		void clearQEmuRequest(void);
+
+		/**
+		 * Get the coalescing key for an emulation request.
+		 * Requests with the same non-zero key replace each other;
+		 * only the last one queued needs to be processed.
+		 * @param rq Emulation request.
+		 * @return Coalescing key, or 0 if the request can't be coalesced.
 		 */
-		QQueue<EmuRequest_t> m_qEmuRequest;
+		static uint32_t coalesceKey(const EmuRequest_t &rq);
+
+		/**
+		 * Finish an emulation request.
+		 * Frees the request's data.
+		 * @param rq Emulation request.
+		 */
+		static void finishEmuRequest(EmuRequest_t &rq);
 
 	/** Emulation Request Queue: Submission functions. **/
 
@@ -456,19 +516,27 @@ class EmuManager : public QObject
 		void enableInterlacedMode_changed_slot(const QVariant &enableInterlacedMode);
 
 	/** Emulation Request Queue: Processing functions. **/
+	/** NOTE: These are run on the emulation thread if it's running. **/
 
 	private:
+		friend class EmuThread;
 		void processQEmuRequest(void);
 
+		/**
+		 * Apply the latched I/O state to the I/O Manager.
+		 * Called by the emulation thread before every frame.
+		 */
+		void applyIoLatch(void);
+
 		QImage getMDScreen(void) const;
-		void doScreenShot(void);
+		int doScreenShot(void);
 
 		void doAudioRate(int newRate);
 		void doAudioStereo(bool newStereo);
 
 		/** Savestates. **/
-		void doSaveState(QString filename, int saveSlot);
-		void doLoadState(QString filename, int saveSlot);
+		int doSaveState(QString filename, int saveSlot);
+		int doLoadState(QString filename, int saveSlot);
 		void doSaveSlot(int newSaveSlot);
 
 		void doPauseRequest(paused_t newPaused);
@@ -55,6 +55,7 @@ using LibGens::Screenshot;
 #include <QtCore/QFile>
 #include <QtCore/QVariant>
 #include <QtCore/QIODevice>
+#include <QtCore/QThread>
 #include <QtGui/QApplication>
 #include <QtGui/QImage>
 #include <QtGui/QImageReader>
@@ -62,6 +63,7 @@ using LibGens::Screenshot;
 // LibZomg's image writer class.
 #include "libzomg/img_data.h"
 
+
 namespace GensQt4 {
 
 /** Emulation Request Queue: Submission functions. **/
@@ -76,10 +78,7 @@ void EmuManager::screenShot(void)
 
 	EmuRequest_t rq;
 	rq.rqType = EmuRequest_t::RQT_SCREENSHOT;
-	m_qEmuRequest.enqueue(rq);
-
-	if (m_paused.data)
-		processQEmuRequest();
+	queueEmuRequest(rq);
 }
 
 /**
@@ -94,10 +93,7 @@ void EmuManager::setAudioRate(int newRate)
 	EmuRequest_t rq;
 	rq.rqType = EmuRequest_t::RQT_AUDIO_RATE;
 	rq.audioRate = newRate;
-	m_qEmuRequest.enqueue(rq);
-
-	if (!m_rom || m_paused.data)
-		processQEmuRequest();
+	queueEmuRequest(rq);
 }
 
 /**
@@ -109,10 +105,7 @@ void EmuManager::setStereo(bool newStereo)
 	EmuRequest_t rq;
 	rq.rqType = EmuRequest_t::RQT_AUDIO_STEREO;
 	rq.audioStereo = newStereo;
-	m_qEmuRequest.enqueue(rq);
-
-	if (!m_rom || m_paused.data)
-		processQEmuRequest();
+	queueEmuRequest(rq);
 }
 
 /**
@@ -128,10 +121,7 @@ void EmuManager::resetCpu(int cpu_idx)
 	EmuRequest_t rq;
 	rq.rqType = EmuRequest_t::RQT_RESET_CPU;
 	rq.cpu_idx = (ResetCpuIndex)cpu_idx;
-	m_qEmuRequest.enqueue(rq);
-
-	if (m_paused.data)
-		processQEmuRequest();
+	queueEmuRequest(rq);
 }
 
 /**
@@ -149,10 +139,7 @@ void EmuManager::saveState(void)
 	rq.rqType = EmuRequest_t::RQT_SAVE_STATE;
 	rq.saveState.filename = new QString(filename);
 	rq.saveState.saveSlot = m_saveSlot;
-	m_qEmuRequest.enqueue(rq);
-
-	if (m_paused.data)
-		processQEmuRequest();
+	queueEmuRequest(rq);
 }
 
 /**
@@ -170,10 +157,7 @@ void EmuManager::loadState(void)
 	rq.rqType = EmuRequest_t::RQT_LOAD_STATE;
 	rq.saveState.filename = new QString(filename);
 	rq.saveState.saveSlot = m_saveSlot;
-	m_qEmuRequest.enqueue(rq);
-
-	if (m_paused.data)
-		processQEmuRequest();
+	queueEmuRequest(rq);
 }
 
 /**
@@ -211,30 +195,20 @@ void EmuManager::pauseRequest(paused_t newPaused)
 	if (!m_rom)
 		return;
 
-	if (!!(m_paused.data) == !!(newPaused.data)) {
-		// Paused state is effectively the same.
-		// Simply update the emulator state.
-		m_paused = newPaused;
-		emit stateChanged();
-		return;
-	}
+	const bool wasPaused = !!(m_paused.data);
+	m_paused = newPaused;
 
-	// Check if we should pause or unpause the emulator.
-	if (!newPaused.data) {
-		// Unpause the ROM immediately.
+	if (wasPaused != !!(newPaused.data)) {
+		// Queue the pause/unpause request.
 		// TODO: Reset the FPS counter?
-		m_paused = newPaused;
-		m_audio->open();	// TODO: Add a resume() function.
-		if (gqt4_emuThread)
-			gqt4_emuThread->resume(false);
-		emit stateChanged();
-	} else {
-		// Queue the pause request.
 		EmuRequest_t rq;
 		rq.rqType = EmuRequest_t::RQT_PAUSE_EMULATION;
 		rq.newPaused = newPaused;
-		m_qEmuRequest.enqueue(rq);
+		queueEmuRequest(rq);
 	}
+
+	// Emulation state has changed.
+	emit stateChanged();
 }
 
 /**
@@ -246,14 +220,9 @@ void EmuManager::saveSlot_changed_slot(const QVariant &saveSlot)
 	// NOTE: Don't check if the save slot is the same.
 	// This allows users to recheck a savestate's preview image.
 
-	// Queue the save slot request.
-	EmuRequest_t rq;
-	rq.rqType = EmuRequest_t::RQT_SAVE_SLOT;
-	rq.saveState.saveSlot = saveSlot.toInt();
-	m_qEmuRequest.enqueue(rq);
-
-	if (!m_rom || m_paused.data)
-		processQEmuRequest();
+	// The save slot doesn't affect emulation,
+	// so it's handled on the UI thread.
+	doSaveSlot(saveSlot.toInt());
 }
 
 /**
@@ -266,10 +235,7 @@ void EmuManager::enableSRam_changed_slot(const QVariant &enableSRam)
 	EmuRequest_t rq;
 	rq.rqType = EmuRequest_t::RQT_ENABLE_SRAM;
 	rq.enableSRam = enableSRam.toBool();
-	m_qEmuRequest.enqueue(rq);
-
-	if (!m_rom || m_paused.data)
-		processQEmuRequest();
+	queueEmuRequest(rq);
 }
 
 /**
@@ -282,10 +248,7 @@ void EmuManager::autoFixChecksum_changed_slot(const QVariant &autoFixChecksum)
 	EmuRequest_t rq;
 	rq.rqType = EmuRequest_t::RQT_AUTOFIX_CHANGE;
 	rq.autoFixChecksum = autoFixChecksum.toBool();
-	m_qEmuRequest.enqueue(rq);
-
-	if (!m_rom || m_paused.data)
-		processQEmuRequest();
+	queueEmuRequest(rq);
 }
 
 /**
@@ -301,10 +264,7 @@ void EmuManager::regionCode_changed_slot(const QVariant &regionCode)
 	EmuRequest_t rq;
 	rq.rqType = EmuRequest_t::RQT_REGION_CODE;
 	rq.region = (LibGens::SysVersion::RegionCode_t)regionCode.toInt();
-	m_qEmuRequest.enqueue(rq);
-
-	if (!m_rom || m_paused.data)
-		processQEmuRequest();
+	queueEmuRequest(rq);
 }
 
 /**
@@ -332,10 +292,7 @@ void EmuManager::regionCodeOrder_changed_slot(const QVariant &regionCodeOrder)
 	EmuRequest_t rq;
 	rq.rqType = EmuRequest_t::RQT_REGION_CODE;
 	rq.region = LibGens::SysVersion::REGION_AUTO;
-	m_qEmuRequest.enqueue(rq);
-
-	if (!m_rom || m_paused.data)
-		processQEmuRequest();
+	queueEmuRequest(rq);
 }
 
 /**
@@ -351,10 +308,7 @@ void EmuManager::resetEmulator(bool hardReset)
 	EmuRequest_t rq;
 	rq.rqType = EmuRequest_t::RQT_RESET;
 	rq.hardReset = hardReset;
-	m_qEmuRequest.enqueue(rq);
-
-	if (m_paused.data)
-		processQEmuRequest();
+	queueEmuRequest(rq);
 }
 
 /**
@@ -369,10 +323,7 @@ void EmuManager::changePaletteSetting(EmuRequest_t::PaletteSettingType type, int
 	rq.rqType = EmuRequest_t::RQT_PALETTE_SETTING;
 	rq.PaletteSettings.ps_type = type;
 	rq.PaletteSettings.ps_val = val;
-	m_qEmuRequest.enqueue(rq);
-
-	if (!m_rom || m_paused.data)
-		processQEmuRequest();
+	queueEmuRequest(rq);
 }
 
 /** Graphics settings. **/
@@ -397,15 +348,145 @@ void EmuManager::updatePaletteInVBlankOnly_changed_slot(const QVariant &updatePa
 void EmuManager::enableInterlacedMode_changed_slot(const QVariant &enableInterlacedMode)
 	{ changePaletteSetting(EmuRequest_t::RQT_PS_ENABLEINTERLACEDMODE, (int)enableInterlacedMode.toBool()); }
 
+/**
+ * Queue an emulation request.
+ * If the emulation thread is running, it will process
+ * the request before the next frame. Otherwise, the
+ * request is processed immediately.
+ * @param rq Emulation request.
+ */
+void EmuManager::queueEmuRequest(const EmuRequest_t &rq)
+{
+	while (!m_qEmuRequest.push(rq)) {
+		// Queue is full. The emulation thread empties it
+		// before every frame, so this won't take long.
+		if (gqt4_emuThread)
+			gqt4_emuThread->wake();
+		QThread::yieldCurrentThread();
+	}
+
+	if (gqt4_emuThread) {
+		// Make sure the emulation thread sees the
+		// request even if emulation is paused.
+		gqt4_emuThread->wake();
+	} else {
+		// Emulation isn't running.
+		// Process the request immediately.
+		processQEmuRequest();
+	}
+}
+
+/**
+ * Discard all pending emulation requests.
+ * The emulation thread must not be running.
+ */
+void EmuManager::clearQEmuRequest(void)
+{
+	EmuRequest_t rq;
+	while (m_qEmuRequest.pop(&rq)) {
+		finishEmuRequest(rq);
+	}
+}
+
+/**
+ * Get the coalescing key for an emulation request.
+ * Requests with the same non-zero key replace each other;
+ * only the last one queued needs to be processed.
+ * @param rq Emulation request.
+ * @return Coalescing key, or 0 if the request can't be coalesced.
+ */
+uint32_t EmuManager::coalesceKey(const EmuRequest_t &rq)
+{
+	switch (rq.rqType) {
+		case EmuRequest_t::RQT_AUDIO_RATE:
+		case EmuRequest_t::RQT_AUDIO_STEREO:
+		case EmuRequest_t::RQT_AUTOFIX_CHANGE:
+		case EmuRequest_t::RQT_REGION_CODE:
+		case EmuRequest_t::RQT_ENABLE_SRAM:
+			// Settings. Only the most recent value matters.
+			return (uint32_t)rq.rqType;
+
+		case EmuRequest_t::RQT_PALETTE_SETTING:
+			// Each palette setting is separate.
+			return ((uint32_t)rq.rqType << 16) | (uint32_t)rq.PaletteSettings.ps_type;
+
+		default:
+			// Everything else has side effects, so it
+			// has to be processed every time.
+			break;
+	}
+
+	return 0;
+}
+
+/**
+ * Finish an emulation request.
+ * Frees the request's data.
+ * @param rq Emulation request.
+ */
+void EmuManager::finishEmuRequest(EmuRequest_t &rq)
+{
+	if (rq.rqType == EmuRequest_t::RQT_SAVE_STATE ||
+	    rq.rqType == EmuRequest_t::RQT_LOAD_STATE)
+	{
+		delete rq.saveState.filename;
+		rq.saveState.filename = nullptr;
+	}
+}
+
 /** Emulation Request Queue: Processing functions. **/
 
 /**
  * Process the Emulation Request queue.
+ * This is run on the emulation thread if it's running.
  */
 void EmuManager::processQEmuRequest(void)
 {
-	while (!m_qEmuRequest.isEmpty()) {
-		EmuRequest_t rq = m_qEmuRequest.dequeue();
+	// Take everything that's currently queued.
+	// Requests queued after this will be handled next time.
+	EmuRequest_t batch[EMU_REQUEST_QUEUE_SIZE];
+	unsigned int count = 0;
+	while (count < EMU_REQUEST_QUEUE_SIZE && m_qEmuRequest.pop(&batch[count])) {
+		count++;
+	}
+	if (count == 0)
+		return;
+
+	// Coalesce settings changes: if the same setting is changed
+	// more than once, only the last change is applied.
+	// Requests that can't be coalesced act as barriers, so
+	// settings are never reordered relative to e.g. resets.
+	bool skip[EMU_REQUEST_QUEUE_SIZE];
+	uint32_t seen[EMU_REQUEST_QUEUE_SIZE];
+	unsigned int seenCount = 0;
+	for (int i = (int)count - 1; i >= 0; i--) {
+		skip[i] = false;
+		const uint32_t key = coalesceKey(batch[i]);
+		if (key == 0) {
+			// Barrier.
+			seenCount = 0;
+			continue;
+		}
+
+		for (unsigned int j = 0; j < seenCount; j++) {
+			if (seen[j] == key) {
+				// Superseded by a later request.
+				skip[i] = true;
+				break;
+			}
+		}
+		if (!skip[i])
+			seen[seenCount++] = key;
+	}
+
+	for (unsigned int i = 0; i < count; i++) {
+		EmuRequest_t &rq = batch[i];
+		if (skip[i]) {
+			// Superseded. The newer request will
+			// take care of it.
+			finishEmuRequest(rq);
+			continue;
+		}
 
 		switch (rq.rqType) {
 			case EmuRequest_t::RQT_SCREENSHOT:
@@ -426,23 +507,15 @@ void EmuManager::processQEmuRequest(void)
 			case EmuRequest_t::RQT_SAVE_STATE:
 				// Save a savestate.
 				doSaveState(*rq.saveState.filename, rq.saveState.saveSlot);
-				delete rq.saveState.filename;
 				break;
 
 			case EmuRequest_t::RQT_LOAD_STATE:
 				// Load a savestate.
 				doLoadState(*rq.saveState.filename, rq.saveState.saveSlot);
-				delete rq.saveState.filename;
-				break;
-
-			case EmuRequest_t::RQT_SAVE_SLOT:
-				// Set the save slot.
-				doSaveSlot(rq.saveState.saveSlot);
 				break;
 
 			case EmuRequest_t::RQT_PAUSE_EMULATION:
-				// Pause emulation.
-				// Unpausing emulation is handled in EmuManager::pauseRequest().
+				// Pause or unpause emulation.
 				doPauseRequest(rq.newPaused);
 				break;
 
@@ -481,14 +554,35 @@ void EmuManager::processQEmuRequest(void)
 				// Unknown emulation request.
 				break;
 		}
+
+		finishEmuRequest(rq);
 	}
 }
 
+/**
+ * Apply the latched I/O state to the I/O Manager.
+ * Called by the emulation thread before every frame.
+ */
+void EmuManager::applyIoLatch(void)
+{
+	m_mtxIoLatch.lock();
+	if (!m_ioLatchDirty) {
+		m_mtxIoLatch.unlock();
+		return;
+	}
+	const LibGensKeys::KeyManager::IoState_t ioState = m_ioLatch;
+	m_ioLatchDirty = false;
+	m_mtxIoLatch.unlock();
+
+	LibGensKeys::KeyManager::applyIoState(&ioState, gqt4_emuContext->m_ioManager);
+}
+
 /**
  * Do a screenshot.
  * Called from processQEmuRequest().
+ * @return 0 on success; negative POSIX error code on error.
  */
-void EmuManager::doScreenShot(void)
+int EmuManager::doScreenShot(void)
 {
 	// Get the ROM filename (without extension).
 	// TODO: Remove all extensions, not just the base?
@@ -513,7 +607,6 @@ void EmuManager::doScreenShot(void)
 	// Take the screenshot.
 	MdFb *fb = gqt4_emuContext->m_vdp->MD_Screen->ref();
 	int ret = Screenshot::toFile(scrFilename.toUtf8().constData(), fb, m_rom);
-	fb->unref();
 
 	// Done using the framebuffer.
 	fb->unref();
@@ -530,6 +623,7 @@ void EmuManager::doScreenShot(void)
 	}
 
 	emit osdPrintMsg(1500, osdMsg);
+	return ret;
 }
 
 /**
@@ -574,8 +668,9 @@ void EmuManager::doAudioStereo(bool newStereo)
  * Save the current emulation state to a file.
  * @param filename Filename.
  * @param saveSlot Save slot number. (0-9)
+ * @return 0 on success; negative POSIX error code on error.
  */
-void EmuManager::doSaveState(QString filename, int saveSlot)
+int EmuManager::doSaveState(QString filename, int saveSlot)
 {
 	// Save the ZOMG file.
 	const QString nativeFilename = QDir::toNativeSeparators(filename);
@@ -599,14 +694,16 @@ void EmuManager::doSaveState(QString filename, int saveSlot)
 
 	// Print the message to the OSD.
 	emit osdPrintMsg(1500, osdMsg);
+	return ret;
 }
 
 /**
  * Load the emulation state from a file.
  * @param filename Filename.
  * @param saveSlot Save slot number. (0-9)
+ * @return 0 on success; negative POSIX error code on error.
  */
-void EmuManager::doLoadState(QString filename, int saveSlot)
+int EmuManager::doLoadState(QString filename, int saveSlot)
 {
 	// TODO: Redraw the screen if emulation is paused.
 
@@ -632,6 +729,7 @@ void EmuManager::doLoadState(QString filename, int saveSlot)
 
 	// Print the message to the OSD.
 	emit osdPrintMsg(1500, osdMsg);
+	return ret;
 }
 
 /**
@@ -702,29 +800,23 @@ void EmuManager::doSaveSlot(int newSaveSlot)
 }
 
 /**
- * Pause emulation.
- * Unpausing emulation is handled in EmuManager::pauseRequest().
+ * Pause or unpause emulation.
+ * m_paused has already been updated by pauseRequest().
  * @param newPaused New paused state.
  */
 void EmuManager::doPauseRequest(paused_t newPaused)
 {
-	if (m_paused.data) {
-		// Emulator is already paused.
-		// Simply update the paused state.
-		m_paused = newPaused;
-		emit stateChanged();
-		return;
+	if (newPaused.data) {
+		// Turn off audio and autosave SRam/EEPRom.
+		m_audio->close();	// TODO: Add a pause() function.
+		gqt4_emuContext->autoSaveData(-1);
+	} else {
+		// Turn on audio.
+		m_audio->open();	// TODO: Add a resume() function.
 	}
 
-	// Pause the emulator.
-	m_paused = newPaused;
-
-	// Turn off audio and autosave SRam/EEPRom.
-	m_audio->close();	// TODO: Add a pause() function.
-	gqt4_emuContext->autoSaveData(-1);
-
-	// Emulation state has changed.
-	emit stateChanged();
+	if (gqt4_emuThread)
+		gqt4_emuThread->setPaused(!!newPaused.data);
 }
 
 /**
@@ -22,15 +22,61 @@
  ***************************************************************************/
 
 #include "EmuThread.hpp"
+#include "EmuManager.hpp"
 #include "gqt4_main.hpp"
 
+// LibGens includes.
+#include "libgens/EmuContext/EmuContext.hpp"
+#include "libgens/EmuContext/SysVersion.hpp"
+#include "libgens/Vdp/Vdp.hpp"
+#include "libgens/Util/MdFbTriple.hpp"
+
+// Audio backend.
+#include "Audio/GensPortAudio.hpp"
+
+// Atomic operations.
+#include "libcompat/atomic.h"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstring>
+
 namespace GensQt4 {
 
-EmuThread::EmuThread(QObject *parent)
+/**
+ * Maximum number of consecutive fast frames.
+ * If emulation is still behind after this many fast frames,
+ * a frame is rendered anyway so the display doesn't freeze.
+ */
+static const int MAX_FAST_FRAMES = 8;
+
+/**
+ * Maximum number of frames emulation can fall behind the
+ * system clock before it stops trying to catch up.
+ */
+static const int MAX_LAG_FRAMES = 8;
+
+/**
+ * Number of segments to keep in the audio buffer
+ * when pacing emulation to audio.
+ */
+static const int AUDIO_BUFFER_SEGMENTS = 3;
+
+EmuThread::EmuThread(EmuManager *emuManager, QObject *parent)
 	: super(parent)
+	, m_emuManager(emuManager)
+	, m_fbTriple(new LibGens::MdFbTriple())
+	, m_wakeup(false)
+	, m_paused(false)
+	, m_lastFrameSig(0)
+	, m_stop(0)
+	, m_framePending(0)
+	, m_framesRendered(0)
+	, m_nextTime(0)
+	, m_fastFrames(0)
+	, m_jitterReport(false)
 {
-	m_stop = false;
-	m_doFastFrame = false;
+	thread_sched_params_init(&m_threadSched);
 }
 
 EmuThread::~EmuThread()
@@ -41,22 +87,147 @@ EmuThread::~EmuThread()
 	this->stop();
 	this->wait();
 #endif
+
+	// NOTE: VBackend may still have a reference
+	// to one of the framebuffers. That's fine,
+	// since MdFb is reference-counted.
+	delete m_fbTriple;
+}
+
+/**
+ * Check if a stop is requested.
+ * @return True if a stop is requested; false otherwise.
+ */
+bool EmuThread::isStopRequested(void) const
+{
+	return !!ATOMIC_LOAD_ACQUIRE(&m_stop);
+}
+
+/**
+ * Get the number of frames rendered by the emulation thread.
+ * Fast frames aren't rendered, so they aren't counted.
+ * @return Number of frames rendered.
+ */
+unsigned int EmuThread::framesRendered(void) const
+{
+	return ATOMIC_LOAD_ACQUIRE(&m_framesRendered);
 }
 
-void EmuThread::resume(bool doFastFrame)
+/**
+ * Pause or unpause the emulation thread.
+ * This must be called from the emulation thread,
+ * i.e. while processing an EmuManager request.
+ * @param paused True to pause; false to unpause.
+ */
+void EmuThread::setPaused(bool paused)
+{
+	m_paused = paused;
+	if (!paused) {
+		// Don't try to catch up on the time spent paused.
+		m_nextTime = 0;
+		m_fastFrames = 0;
+	}
+
+	// Don't count the time spent paused as jitter.
+	m_jitter.skipFrame();
+}
+
+/**
+ * Set scheduling parameters for the emulation thread.
+ * They're applied when the thread starts.
+ * NOTE: Call this before start().
+ * @param params Thread scheduling parameters.
+ * @param jitterReport If true, print a frame-time jitter report when the thread stops.
+ */
+void EmuThread::setThreadSched(const thread_sched_params_t *params, bool jitterReport)
+{
+	m_threadSched = *params;
+	m_jitterReport = jitterReport;
+}
+
+/**
+ * Acknowledge the last frameDone() signal.
+ * Call this before picking up the frame.
+ */
+void EmuThread::frameAck(void)
+{
+	ATOMIC_STORE_RELEASE(&m_framePending, 0);
+}
+
+/**
+ * Wake up the emulation thread if it's paused.
+ * Call this after queueing an EmuManager request.
+ */
+void EmuThread::wake(void)
 {
 	m_mutex.lock();
-	m_doFastFrame = doFastFrame;
+	m_wakeup = true;
 	m_wait.wakeAll();
 	m_mutex.unlock();
 }
 
 void EmuThread::stop(void)
 {
-	m_mutex.lock();
-	m_stop = true;
-	m_wait.wakeAll();
-	m_mutex.unlock();
+	ATOMIC_STORE_RELEASE(&m_stop, 1);
+	wake();
+}
+
+/**
+ * Wait until the next frame should be run.
+ * @param frameTime Frame duration, in microseconds.
+ * @return True if emulation is behind and the next frame should be a fast frame.
+ */
+bool EmuThread::waitForNextFrame(uint64_t frameTime)
+{
+	GensPortAudio *const audio = m_emuManager->m_audio;
+	if (audio->isOpen()) {
+		// Pace emulation to audio.
+		// If the audio buffer ran dry, we're behind.
+		int segs = audio->bufferedSegments();
+		if (segs == 0)
+			return true;
+
+		// Wait for the audio callback to drain the buffer.
+		// Each wait is limited to one frame, so a stop
+		// request or a stalled audio device can't hang
+		// the emulation thread.
+		const unsigned long timeout = (unsigned long)(frameTime / 1000);
+		while (segs > AUDIO_BUFFER_SEGMENTS && !isStopRequested()) {
+			segs = audio->waitForBuffer(AUDIO_BUFFER_SEGMENTS, timeout);
+		}
+		return false;
+	}
+
+	// Pace emulation to the system clock.
+	uint64_t now = m_timing.getTime();
+	if (m_nextTime == 0) {
+		// First frame since starting or unpausing.
+		m_nextTime = now;
+	}
+	m_nextTime += frameTime;
+
+	if (now >= m_nextTime) {
+		// Behind schedule.
+		if ((now - m_nextTime) > (frameTime * MAX_LAG_FRAMES)) {
+			// Too far behind to catch up.
+			// Restart the schedule from the current time.
+			m_nextTime = now;
+			return false;
+		}
+		return true;
+	}
+
+	// Ahead of schedule.
+	// Sleep for most of the remaining time, then
+	// yield until the next frame is due, since
+	// usleep() granularity is usually 1 ms or worse.
+	const uint64_t remaining = (m_nextTime - now);
+	if (remaining > 2000)
+		usleep((unsigned long)(remaining - 2000));
+	while (m_timing.getTime() < m_nextTime && !isStopRequested()) {
+		yieldCurrentThread();
+	}
+	return false;
 }
 
 void EmuThread::run(void)
@@ -64,27 +235,89 @@ void EmuThread::run(void)
 	// NOTE: LibGens initialization is done elsewhere.
 	// The emulation thread doesn't initialize anything;
 	// it merely runs what's already been initialized.
-	
+
+	// Apply the thread scheduling parameters.
+	int ret = thread_sched_apply(&m_threadSched);
+	if (ret != 0) {
+		fprintf(stderr, "Warning: Could not set emulation thread scheduling: %s\n",
+			strerror(-ret));
+	}
+
 	// Default to full frames.
-	m_doFastFrame = false;
-	
+	bool doFastFrame = false;
+	m_nextTime = 0;
+	m_fastFrames = 0;
+	m_jitter.reset();
+
 	// Run the emulation thread.
-	m_mutex.lock();
-	while (!m_stop)
-	{
+	while (!isStopRequested()) {
+		// Process requests from the UI thread.
+		m_emuManager->processQEmuRequest();
+
+		if (m_paused) {
+			// Wait for another request or a stop command.
+			m_mutex.lock();
+			while (!m_wakeup)
+				m_wait.wait(&m_mutex);
+			m_wakeup = false;
+			m_mutex.unlock();
+			continue;
+		}
+
+		// Latch the controller state for this frame.
+		// Fast frames need current input, too.
+		m_emuManager->applyIoLatch();
+
 		// Run a frame of emulation.
-		if (!m_doFastFrame)
+		if (!doFastFrame) {
 			gqt4_emuContext->execFrame();
-		else
+			m_fastFrames = 0;
+
+			// Publish the frame, unless it's identical
+			// to the previously-published frame.
+			const uint64_t frameSig = gqt4_emuContext->m_vdp->frameSignature();
+			if (frameSig != m_lastFrameSig) {
+				m_fbTriple->publish(gqt4_emuContext->m_vdp->MD_Screen);
+				m_lastFrameSig = frameSig;
+			}
+			ATOMIC_ADD_FETCH(&m_framesRendered, 1);
+			m_jitter.addFrame(m_timing.getTime());
+
+			// Notify the UI thread, unless the
+			// previous notification is still pending.
+			if (ATOMIC_CMPXCHG(&m_framePending, 0, 1))
+				emit frameDone();
+		} else {
 			gqt4_emuContext->execFrameFast();
-		
-		// Signal that the frame has been drawn.
-		emit frameDone(m_doFastFrame);
-		
-		// Wait for a resume command.
-		m_wait.wait(&m_mutex);
+			m_fastFrames++;
+		}
+
+		// Check for SRam/EEPRom autosave.
+		// TODO: Frames elapsed.
+		gqt4_emuContext->autoSaveData(1);
+
+		// Write audio.
+		m_emuManager->m_audio->write();
+
+		// Wait for the next frame.
+		const uint64_t frameTime = (1000000 /
+			(gqt4_emuContext->versionRegisterObject()->isPal() ? 50 : 60));
+		if (m_jitter.targetInterval() != frameTime)
+			m_jitter.setTargetInterval((unsigned int)frameTime);
+		doFastFrame = (waitForNextFrame(frameTime) &&
+			       m_fastFrames < MAX_FAST_FRAMES);
+	}
+
+	if (m_jitterReport) {
+		// Include the scheduling parameters so runs
+		// with different settings can be compared.
+		char label[128];
+		snprintf(label, sizeof(label), "emu-cpu=%d sched=%s/%d nice=%d",
+			m_threadSched.cpu,
+			thread_sched_policy_name((thread_sched_policy_t)m_threadSched.policy),
+			m_threadSched.priority, m_threadSched.nice);
+		m_jitter.printReport(stderr, label);
 	}
-	m_mutex.unlock();
 }
 
 }
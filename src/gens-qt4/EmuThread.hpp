@@ -28,14 +28,39 @@
 #include <QtCore/QWaitCondition>
 #include <QtCore/QMutex>
 
+// C includes.
+#include <stdint.h>
+
+// LibGens includes.
+#include "libgens/Util/Timing.hpp"
+#include "libgens/Util/FrameJitter.hpp"
+
+// Thread scheduling.
+#include "libcompat/thread_sched.h"
+
+namespace LibGens {
+	class MdFbTriple;
+}
+
 namespace GensQt4 {
 
+class EmuManager;
+
+/**
+ * Emulation thread.
+ *
+ * The emulation thread runs autonomously, paced by the
+ * audio buffer if audio is open, or by the system clock
+ * if it isn't. It never waits for the UI thread:
+ * - Completed frames are published to fbTriple().
+ * - EmuManager requests are processed between frames.
+ */
 class EmuThread : public QThread
 {
 	Q_OBJECT
 
 	public:
-		EmuThread(QObject *parent = 0);
+		EmuThread(EmuManager *emuManager, QObject *parent = 0);
 		~EmuThread();
 
 	private:
@@ -44,35 +69,106 @@ class EmuThread : public QThread
 		Q_DISABLE_COPY(EmuThread)
 
 	public:
-		inline bool isStopRequested(void);
+		bool isStopRequested(void) const;
+
+		/**
+		 * Get the triple-buffered framebuffer set.
+		 * The UI thread is the consumer.
+		 * @return MdFbTriple.
+		 */
+		inline LibGens::MdFbTriple *fbTriple(void) const
+			{ return m_fbTriple; }
+
+		/**
+		 * Get the number of frames rendered by the emulation thread.
+		 * Fast frames aren't rendered, so they aren't counted.
+		 * @return Number of frames rendered.
+		 */
+		unsigned int framesRendered(void) const;
+
+		/**
+		 * Pause or unpause the emulation thread.
+		 * This must be called from the emulation thread,
+		 * i.e. while processing an EmuManager request.
+		 * @param paused True to pause; false to unpause.
+		 */
+		void setPaused(bool paused);
+
+		/**
+		 * Set scheduling parameters for the emulation thread.
+		 * They're applied when the thread starts.
+		 * NOTE: Call this before start().
+		 * @param params Thread scheduling parameters.
+		 * @param jitterReport If true, print a frame-time jitter report when the thread stops.
+		 */
+		void setThreadSched(const thread_sched_params_t *params, bool jitterReport);
 
 	signals:
-		void frameDone(bool wasFastFrame);
+		/**
+		 * A new frame has been published to fbTriple().
+		 * This signal isn't emitted again until frameAck()
+		 * is called, so a busy UI thread won't build up
+		 * a backlog of queued signals.
+		 */
+		void frameDone(void);
 
 	public slots:
-		void resume(bool doFastFrame = false);
+		/**
+		 * Acknowledge the last frameDone() signal.
+		 * Call this before picking up the frame.
+		 */
+		void frameAck(void);
+
+		/**
+		 * Wake up the emulation thread if it's paused.
+		 * Call this after queueing an EmuManager request.
+		 */
+		void wake(void);
+
 		void stop(void);
 
 	protected:
 		void run(void);
+
+		/**
+		 * Wait until the next frame should be run.
+		 * @param frameTime Frame duration, in microseconds.
+		 * @return True if emulation is behind and the next frame should be a fast frame.
+		 */
+		bool waitForNextFrame(uint64_t frameTime);
+
+		EmuManager *const m_emuManager;
+		LibGens::MdFbTriple *const m_fbTriple;
+
+		// Wakeup handling while paused.
 		QWaitCondition m_wait;
 		QMutex m_mutex;
+		bool m_wakeup;
 
-		bool m_stop;
-		bool m_doFastFrame;
-};
+		// Paused state. (Emulation thread only.)
+		bool m_paused;
 
-/**
- * Check if a stop is requested.
- * @return True if a stop is requested; false otherwise.
- */
-inline bool EmuThread::isStopRequested(void)
-{
-	m_mutex.lock();
-	bool ret = m_stop;
-	m_mutex.unlock();
-	return ret;
-}
+		// Frame signature of the last published frame.
+		// (Emulation thread only.)
+		uint64_t m_lastFrameSig;
+
+		// Shared with the UI thread. (Atomic access only.)
+		uint32_t m_stop;
+		uint32_t m_framePending;
+		uint32_t m_framesRendered;
+
+		// Clock pacing. (Emulation thread only.)
+		LibGens::Timing m_timing;
+		uint64_t m_nextTime;
+		int m_fastFrames;
+
+		// Thread scheduling. (Set before start().)
+		thread_sched_params_t m_threadSched;
+		bool m_jitterReport;
+
+		// Frame-time jitter statistics. (Emulation thread only.)
+		LibGens::FrameJitter m_jitter;
+};
 
 }
 
@@ -95,6 +95,7 @@ void KeyHandlerQt::keyPressEvent(QKeyEvent *event)
 	// Not an event key. Mark it as pressed.
 	if (m_keyManager) {
 		m_keyManager->keyDown(gensKey);
+		emit ioStateChanged();
 	}
 }
 
@@ -111,6 +112,7 @@ void KeyHandlerQt::keyReleaseEvent(QKeyEvent *event)
 	int gensKey = QKeyEventToKeyVal(event);
 	if (m_keyManager) {
 		m_keyManager->keyUp(gensKey);
+		emit ioStateChanged();
 	}
 }
 
@@ -166,6 +168,7 @@ void KeyHandlerQt::mousePressEvent(QMouseEvent *event)
 	// Mark the key as pressed.
 	if (m_keyManager) {
 		m_keyManager->keyDown(KEYV_MOUSE_UNKNOWN + gensButton);
+		emit ioStateChanged();
 	}
 }
 
@@ -191,6 +194,7 @@ void KeyHandlerQt::mouseReleaseEvent(QMouseEvent *event)
 	// Mark the key as pressed.
 	if (m_keyManager) {
 		m_keyManager->keyUp(KEYV_MOUSE_UNKNOWN + gensButton);
+		emit ioStateChanged();
 	}
 }
 
@@ -384,7 +388,7 @@ GensKey_t KeyHandlerQt::NativeModifierToKeyVal(QKeyEvent *event)
 	// NOTE: Shift, Control, and Alt are NOT tested here.
 	// WM_KEYDOWN/WM_KEYUP report VK_SHIFT, VK_CONTORL, and VK_MENU (Alt).
 	// These are useless for testing left/right keys.
-	// Instead, GetAsyncKeyState() is used in LibGensKeys::KeyManager::updateIoManager().
+	// Instead, GetAsyncKeyState() is used in LibGensKeys::KeyManager::getIoState().
 	switch (event->nativeVirtualKey()) {
 		case VK_LWIN:		return KEYV_LSUPER;
 		case VK_RWIN:		return KEYV_RSUPER;
@@ -74,6 +74,12 @@ class KeyHandlerQt : public QObject
 		void mousePressEvent(QMouseEvent *event);
 		void mouseReleaseEvent(QMouseEvent *event);
 
+	signals:
+		/**
+		 * A controller key was pressed or released.
+		 */
+		void ioStateChanged(void);
+
 	private:
 		// TODO: Move to a private class?
 
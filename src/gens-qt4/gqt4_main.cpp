@@ -33,6 +33,7 @@
 #include <QtCore/QLocale>
 #include <QtCore/QLibraryInfo>
 #include <QtCore/QDir>
+#include <QtCore/QThread>
 
 #include "GensQApplication.hpp"
 #include "windows/GensWindow.hpp"
@@ -73,6 +74,8 @@ void gqt4_log_msg_critical(const char *channel, const char *msg)
 
 /**
  * LibGens OSD handler.
+ * This may be called from the emulation thread,
+ * e.g. when SRam is autosaved.
  * @param osd_type: OSD type.
  * @param param: Integer parameter.
  */
@@ -82,6 +85,14 @@ void gqt4_osd(OsdType osd_type, int param)
 	if (!gens_window)
 		return;
 
+	if (QThread::currentThread() != gens_window->thread()) {
+		// Not on the UI thread. Widgets can only be
+		// accessed from the UI thread, so queue the call.
+		QMetaObject::invokeMethod(gens_window, "osd", Qt::QueuedConnection,
+			Q_ARG(OsdType, osd_type), Q_ARG(int, param));
+		return;
+	}
+
 	gens_window->osd(osd_type, param);
 }
 
@@ -174,6 +185,8 @@ int gens_main(int argc, char *argv[])
 	log_msg_register_critical_fn(gqt4_log_msg_critical);
 
 	// Register the LibGens OSD handler.
+	// OsdType is passed to GensWindow::osd() in queued calls.
+	qRegisterMetaType<OsdType>("OsdType");
 	lg_set_osd_fn(gqt4_osd);
 
 	// Set the EmuContext paths.
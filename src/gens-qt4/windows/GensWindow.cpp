@@ -205,6 +205,8 @@ GensWindow::GensWindow(QWidget *parent, Qt::WindowFlags flags)
 	// Initialize the Key Manager and KeyHandlerQt.
 	d->emuManager->setKeyManager(gqt4_cfg->m_keyManager);
 	d->keyHandler = new KeyHandlerQt(this, gqt4_cfg->m_keyManager);
+	QObject::connect(d->keyHandler, SIGNAL(ioStateChanged()),
+		d->emuManager, SLOT(updateIoState()));
 
 	// Create the Video Backend.
 	// TODO: Allow selection of all available VBackend classes.
@@ -62,10 +62,15 @@ class GensWindow : public QMainWindow
 	private:
 		Q_DISABLE_COPY(GensWindow)
 
-	public:
-		// LibGens OSD handler.
+	public slots:
+		/**
+		 * LibGens OSD handler.
+		 * NOTE: Must be called from the UI thread.
+		 * gqt4_osd() queues the call if necessary.
+		 */
 		void osd(OsdType osd_type, int param);
 
+	public:
 		/**
 		 * Rescale the window.
 		 * @param scale New scale value.
@@ -228,4 +233,7 @@ class GensWindow : public QMainWindow
 
 }
 
+// Needed for queued osd() calls.
+Q_DECLARE_METATYPE(OsdType)
+
 #endif /* __GENS_QT4_GENSWINDOW_HPP__ */
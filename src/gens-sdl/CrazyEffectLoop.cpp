@@ -107,10 +107,10 @@ int CrazyEffectLoop::run(const Options *options)
 
 	// Initialize the SDL handlers.
 	d->sdlHandler = new SdlHandler();
-	if (d->sdlHandler->init_video() < 0)
+	if (d->sdlHandler->init_video(options->gl_upload().c_str()) < 0)
 		return EXIT_FAILURE;
 	// No audio here.
-	//if (d->sdlHandler->init_audio(options->sound_freq(), options->stereo()) < 0)
+	//if (d->sdlHandler->init_audio(options->sound_freq(), options->stereo(), options->resampler()) < 0)
 	//	return EXIT_FAILURE;
 	d->vBackend = d->sdlHandler->vBackend();
 
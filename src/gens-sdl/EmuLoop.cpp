@@ -51,8 +51,10 @@ using LibGens::SysVersion;
 // Emulation Context.
 #include "libgens/EmuContext/EmuContext.hpp"
 #include "libgens/EmuContext/EmuContextFactory.hpp"
+#include "libgens/Cartridge/RomProfileDB.hpp"
 using LibGens::EmuContext;
 using LibGens::EmuContextFactory;
+using LibGens::RomProfile;
 
 // LibGensKeys
 #include "libgens/IO/IoManager.hpp"
@@ -62,6 +64,25 @@ using LibGens::EmuContextFactory;
 using LibGens::IoManager;
 using LibGensKeys::KeyManager;
 
+// Input movies.
+#include "libgens/IO/InputMovie.hpp"
+using LibGens::InputMovie;
+
+// Hash logs.
+#include "libgens/Util/HashLog.hpp"
+using LibGens::HashLog;
+
+// WAV/VGM/video capture.
+#include "libgens/Util/Capture.hpp"
+using LibGens::Capture;
+
+// Profiler.
+#include "libgens/Util/Profiler.hpp"
+using LibGens::Profiler;
+
+// Thread scheduling.
+#include "libcompat/thread_sched.h"
+
 // LibZomg
 #include "libzomg/Zomg.hpp"
 #include "libzomg/img_data.h"
@@ -73,10 +94,18 @@ using LibZomg::Zomg;
 
 // C includes. (C++ namespace)
 #include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <csignal>
+#endif
 
 // C++ includes.
 #include <string>
+#include <vector>
 using std::string;
+using std::vector;
 
 #include "EventLoop_p.hpp"
 namespace GensSdl {
@@ -100,6 +129,19 @@ class EmuLoopPrivate : public EventLoopPrivate
 		EmuContext *emuContext;
 		KeyManager *keyManager;
 
+		// Input movie.
+		InputMovie *movie;
+
+		// Video/audio hash log.
+		HashLog *hashLog;
+
+		// WAV/VGM/video capture.
+		Capture *capture;
+
+		// Profiler frame records for the Chrome trace.
+		bool profTrace;
+		vector<Profiler::FrameRecord> profFrames;
+
 		// Save slot.
 		int saveSlot_selected;
 
@@ -112,6 +154,10 @@ class EmuLoopPrivate : public EventLoopPrivate
 		// should be autosaved.
 		paused_t last_paused;
 
+		// Frame signature of the last full frame.
+		// Used to skip uploading unchanged frames.
+		uint64_t lastFrameSig;
+
 		/**
 		 * Get the modification time string for the specified save file.
 		 * @param zomg Save file.
@@ -151,6 +197,78 @@ class EmuLoopPrivate : public EventLoopPrivate
 		 * and the ROM name.
 		 */
 		void updateWinTitleInfo(void);
+
+		/**
+		 * Start recording or playing back a movie,
+		 * if requested on the command line.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int startMovie(void);
+
+		/**
+		 * Process one frame of movie input.
+		 * Called before every emulated frame.
+		 */
+		void doMovieFrame(void);
+
+		/**
+		 * Start the hash log, if requested on the command line.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int startHashLog(void);
+
+		/**
+		 * Finish the hash log and compare it to the golden log,
+		 * if requested on the command line.
+		 * @return 0 if the logs match or no comparison was requested;
+		 * non-zero if the logs diverge or on error.
+		 */
+		int finishHashLog(void);
+
+		/**
+		 * Start capturing, if requested on the command line.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int startCapture(void);
+
+		/**
+		 * Stop capturing.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int finishCapture(void);
+
+		/**
+		 * Start collecting profiler frame records,
+		 * if requested on the command line.
+		 */
+		void startProfileTrace(void);
+
+		/**
+		 * Collect profiler frame records.
+		 * The profiler's ring buffer only holds a few seconds
+		 * of frames, so this must be called after every frame.
+		 */
+		void readProfileTrace(void);
+
+		/**
+		 * Write the collected profiler frame records
+		 * to the Chrome trace, if requested.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int finishProfileTrace(void);
+
+		/**
+		 * Apply the thread options from the command line.
+		 * This must be called from the emulation thread,
+		 * after audio has been initialized.
+		 */
+		void applyThreadOptions(void);
+
+		/**
+		 * Print the frame-time jitter report,
+		 * if requested on the command line.
+		 */
+		void reportJitter(void) const;
 };
 
 /** EmuLoopPrivate **/
@@ -174,13 +292,21 @@ EmuLoopPrivate::EmuLoopPrivate()
 	, isPico(false)
 	, emuContext(nullptr)
 	, keyManager(nullptr)
+	, movie(nullptr)
+	, hashLog(nullptr)
+	, capture(nullptr)
+	, profTrace(false)
 	, saveSlot_selected(0)
+	, lastFrameSig(0)
 {
 	last_paused.data = 0;
 }
 
 EmuLoopPrivate::~EmuLoopPrivate()
 {
+	delete movie;
+	delete hashLog;
+	delete capture;
 	delete rom;
 	delete emuContext;
 	delete keyManager;
@@ -484,6 +610,310 @@ void EmuLoopPrivate::updateWinTitleInfo(void)
 	updateWindowTitle(winTitle.c_str());
 }
 
+/**
+ * Start recording or playing back a movie,
+ * if requested on the command line.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int EmuLoopPrivate::startMovie(void)
+{
+	const string record_movie = options->record_movie();
+	const string play_movie = options->play_movie();
+	if (record_movie.empty() && play_movie.empty())
+		return 0;
+
+	movie = new InputMovie();
+	int ret;
+	if (!record_movie.empty()) {
+		// Make sure the I/O devices are set up
+		// before the start state is saved.
+		keyManager->updateIoManager(emuContext->m_ioManager);
+		const string startState = record_movie + ".zomg";
+		ret = movie->record(record_movie.c_str(), startState.c_str(),
+				    emuContext, emuContext->m_ioManager);
+		if (ret != 0) {
+			fprintf(stderr, "Error recording movie '%s': %s\n",
+				record_movie.c_str(), strerror(-ret));
+		}
+	} else {
+		ret = movie->play(play_movie.c_str(), emuContext, emuContext->m_ioManager);
+		if (ret != 0) {
+			fprintf(stderr, "Error playing movie '%s': %s\n",
+				play_movie.c_str(), strerror(-ret));
+		}
+	}
+
+	if (ret != 0) {
+		delete movie;
+		movie = nullptr;
+	}
+	return ret;
+}
+
+/**
+ * Process one frame of movie input.
+ * Called before every emulated frame.
+ */
+void EmuLoopPrivate::doMovieFrame(void)
+{
+	if (!movie || movie->mode() == InputMovie::MODE_NONE)
+		return;
+
+	int ret = movie->frame();
+	if (ret == 1) {
+		vBackend->osd_printf(1500, "Movie finished. (%u frames)", movie->curFrame());
+		if (hashLog) {
+			// Scripted regression run. Stop emulation.
+			running = false;
+		}
+	} else if (ret != 0) {
+		vBackend->osd_printf(1500, "Movie error:\n* %s", strerror(-ret));
+	}
+}
+
+/**
+ * Start the hash log, if requested on the command line.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int EmuLoopPrivate::startHashLog(void)
+{
+	const string hash_log = options->hash_log();
+	if (hash_log.empty())
+		return 0;
+
+	hashLog = new HashLog();
+	int ret = hashLog->create(hash_log.c_str(), emuContext->m_vdp->MD_Screen->bpp());
+	if (ret != 0) {
+		fprintf(stderr, "Error creating hash log '%s': %s\n",
+			hash_log.c_str(), strerror(-ret));
+		delete hashLog;
+		hashLog = nullptr;
+	}
+	return ret;
+}
+
+/**
+ * Finish the hash log and compare it to the golden log,
+ * if requested on the command line.
+ * @return 0 if the logs match or no comparison was requested;
+ * non-zero if the logs diverge or on error.
+ */
+int EmuLoopPrivate::finishHashLog(void)
+{
+	if (!hashLog)
+		return 0;
+
+	const uint32_t frames = hashLog->frameCount();
+	int ret = hashLog->close();
+	delete hashLog;
+	hashLog = nullptr;
+	const string hash_log = options->hash_log();
+	if (ret != 0) {
+		fprintf(stderr, "Error writing hash log '%s': %s\n",
+			hash_log.c_str(), strerror(-ret));
+		return ret;
+	}
+
+	const string golden_log = options->golden_log();
+	if (golden_log.empty())
+		return 0;
+
+	HashLog::Divergence div;
+	ret = HashLog::Compare(hash_log.c_str(), golden_log.c_str(), &div);
+	if (ret < 0) {
+		fprintf(stderr, "Error comparing hash log to '%s': %s\n",
+			golden_log.c_str(), strerror(-ret));
+	} else if (ret == 0) {
+		printf("Hash log matches golden log. (%u frames)\n", frames);
+	} else {
+		printf("Hash log diverges from golden log at frame %u: %s\n",
+			div.frame, HashLog::SubsystemName(div.subsystems));
+		if (div.subsystems & HashLog::SUB_VIDEO) {
+			printf("* video: %016llX, expected %016llX\n",
+				(unsigned long long)div.video[0],
+				(unsigned long long)div.video[1]);
+		}
+		if (div.subsystems & HashLog::SUB_AUDIO) {
+			printf("* audio: %016llX, expected %016llX\n",
+				(unsigned long long)div.audio[0],
+				(unsigned long long)div.audio[1]);
+		}
+	}
+	return ret;
+}
+
+/**
+ * Start capturing, if requested on the command line.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int EmuLoopPrivate::startCapture(void)
+{
+	const string capture_wav = options->capture_wav();
+	const string capture_vgm = options->capture_vgm();
+	const string capture_video = options->capture_video();
+	if (capture_wav.empty() && capture_vgm.empty() && capture_video.empty())
+		return 0;
+
+#ifndef _WIN32
+	if (!capture_video.empty() && capture_video[0] == '|') {
+		// If the encoder exits early, writes should fail
+		// with EPIPE instead of killing the emulator.
+		signal(SIGPIPE, SIG_IGN);
+	}
+#endif
+
+	capture = new Capture();
+	int ret = capture->start(
+		(capture_wav.empty() ? nullptr : capture_wav.c_str()),
+		(capture_vgm.empty() ? nullptr : capture_vgm.c_str()),
+		(capture_video.empty() ? nullptr : capture_video.c_str()),
+		Capture::VideoFormatFromName(options->capture_video_format().c_str()));
+	if (ret != 0) {
+		fprintf(stderr, "Error starting capture: %s\n", strerror(-ret));
+		delete capture;
+		capture = nullptr;
+	}
+	return ret;
+}
+
+/**
+ * Stop capturing.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int EmuLoopPrivate::finishCapture(void)
+{
+	if (!capture)
+		return 0;
+
+	const uint32_t frames = capture->frameCount();
+	int ret = capture->stop();
+	const uint32_t dropped = capture->droppedCount();
+	delete capture;
+	capture = nullptr;
+	if (ret != 0) {
+		fprintf(stderr, "Error writing capture: %s\n", strerror(-ret));
+	} else if (dropped != 0) {
+		fprintf(stderr, "Capture: %u frames; %u items dropped.\n", frames, dropped);
+	}
+	return ret;
+}
+
+/**
+ * Start collecting profiler frame records,
+ * if requested on the command line.
+ */
+void EmuLoopPrivate::startProfileTrace(void)
+{
+	profTrace = !options->profile_trace().empty();
+	if (!profTrace)
+		return;
+
+	// Discard anything recorded before the ROM started.
+	Profiler::Reset();
+	profFrames.clear();
+}
+
+/**
+ * Collect profiler frame records.
+ * The profiler's ring buffer only holds a few seconds
+ * of frames, so this must be called after every frame.
+ */
+void EmuLoopPrivate::readProfileTrace(void)
+{
+	if (!profTrace)
+		return;
+
+	Profiler::FrameRecord frames[16];
+	int count;
+	while ((count = Profiler::ReadFrames(frames, ARRAY_SIZE(frames))) > 0) {
+		profFrames.insert(profFrames.end(), frames, frames + count);
+	}
+}
+
+/**
+ * Write the collected profiler frame records
+ * to the Chrome trace, if requested.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int EmuLoopPrivate::finishProfileTrace(void)
+{
+	if (!profTrace)
+		return 0;
+
+	readProfileTrace();
+	const string profile_trace = options->profile_trace();
+	int ret = Profiler::ExportChromeTrace(profile_trace.c_str(),
+		(profFrames.empty() ? nullptr : &profFrames[0]), (int)profFrames.size());
+	if (ret != 0) {
+		fprintf(stderr, "Error writing profiler trace '%s': %s\n",
+			profile_trace.c_str(), strerror(-ret));
+	} else {
+		fprintf(stderr, "Profiler trace: %u frames; %u frames dropped.\n",
+			(unsigned int)profFrames.size(), Profiler::DroppedFrames());
+	}
+	profFrames.clear();
+	profTrace = false;
+	return ret;
+}
+
+/**
+ * Apply the thread options from the command line.
+ * This must be called from the emulation thread,
+ * after audio has been initialized.
+ */
+void EmuLoopPrivate::applyThreadOptions(void)
+{
+	// Emulation thread. (gens-sdl also renders on this thread.)
+	thread_sched_params_t params;
+	thread_sched_params_init(&params);
+	params.cpu = options->emu_cpu();
+	params.policy = options->sched_policy();
+	params.priority = options->rt_priority();
+	params.nice = options->nice();
+	int ret = thread_sched_apply(&params);
+	if (ret != 0) {
+		fprintf(stderr, "Warning: Could not set emulation thread scheduling: %s\n",
+			strerror(-ret));
+	}
+
+	// Audio thread.
+	// It has a higher priority than the emulation thread
+	// so it can't be starved while a frame is running.
+	params.cpu = options->audio_cpu();
+	params.priority = options->rt_priority() + 1;
+	sdlHandler->set_audio_thread_sched(&params);
+
+	// Lock memory after everything has been allocated.
+	if (options->mlock()) {
+		ret = mem_lock_all();
+		if (ret != 0) {
+			fprintf(stderr, "Warning: Could not lock memory: %s\n",
+				strerror(-ret));
+		}
+	}
+}
+
+/**
+ * Print the frame-time jitter report,
+ * if requested on the command line.
+ */
+void EmuLoopPrivate::reportJitter(void) const
+{
+	if (!options->jitter_report())
+		return;
+
+	// Include the thread options so runs
+	// with different settings can be compared.
+	char label[128];
+	snprintf(label, sizeof(label),
+		"emu-cpu=%d audio-cpu=%d sched=%s/%d nice=%d mlock=%s",
+		options->emu_cpu(), options->audio_cpu(),
+		thread_sched_policy_name((thread_sched_policy_t)options->sched_policy()),
+		options->rt_priority(), options->nice(),
+		(options->mlock() ? "on" : "off"));
+	jitter.printReport(stderr, label);
+}
+
 /** EmuLoop **/
 
 EmuLoop::EmuLoop()
@@ -672,11 +1102,31 @@ int EmuLoop::run(const Options *options)
 	// Set some static EmuContext properties.
 	// TODO: Make these non-static?
 	EmuContext::SetAutoFixChecksum(options->auto_fix_checksum());
+	EmuContext::SetIdleLoopSkip(options->idle_skip());
+	EmuContext::SetM68KIdleLoopSkip(options->m68k_idle_skip());
+	EmuContext::SetZomgVersion(options->zomg_version());
 	if (options->is_tmss_enabled()) {
 		EmuContext::SetTmssRomFilename(options->tmss_rom_filename());
 		EmuContext::SetTmssEnabled(true);
 	}
 
+	// Load the ROM profile database.
+	// A missing default database is not an error.
+	if (options->rom_profile()) {
+		string db_filename = options->rom_profile_db();
+		const bool db_default = db_filename.empty();
+		if (db_default) {
+			db_filename = getConfigDir();
+			db_filename += DIR_SEP_CHR;
+			db_filename += "romprofile.db";
+		}
+		int ret = EmuContext::LoadRomProfileDB(db_filename);
+		if (ret != 0 && !(db_default && ret == -ENOENT)) {
+			fprintf(stderr, "Warning: Could not load ROM profile database %s: %s\n",
+				db_filename.c_str(), (ret == -EBADMSG ? "Invalid database" : strerror(-ret)));
+		}
+	}
+
 	// Detect the ROM region.
 	SysVersion::RegionCode_t region = options->region();
 	SysVersion::RegionCode_t region_auto = SysVersion::REGION_AUTO;
@@ -706,14 +1156,31 @@ int EmuLoop::run(const Options *options)
 
 	// Set VDP properties.
 	// TODO: More properties?
+	// Command line options take precedence over ROM profile hints.
 	Vdp *vdp = d->emuContext->m_vdp;
-	vdp->options.spriteLimits = options->sprite_limits();
+	const RomProfile *profile = d->emuContext->romProfile();
+	if (!profile || !profile->has(RomProfile::FIELD_SPRITE_LIMITS) ||
+	    options->sprite_limits_set())
+	{
+		vdp->options.spriteLimits = options->sprite_limits();
+	}
+
+	// Frontend hints from the ROM profile.
+	bool resampler = options->resampler();
+	if (profile) {
+		if (profile->has(RomProfile::FIELD_IDLE_SKIP) && !options->idle_skip_set()) {
+			EmuContext::SetIdleLoopSkip(profile->idleSkip);
+		}
+		if (profile->has(RomProfile::FIELD_RESAMPLER) && !options->resampler_set()) {
+			resampler = profile->resampler;
+		}
+	}
 
 	// Initialize the SDL handlers.
 	d->sdlHandler = new SdlHandler();
-	if (d->sdlHandler->init_video() < 0)
+	if (d->sdlHandler->init_video(options->gl_upload().c_str()) < 0)
 		return EXIT_FAILURE;
-	if (d->sdlHandler->init_audio(options->sound_freq(), options->stereo()) < 0)
+	if (d->sdlHandler->init_audio(options->sound_freq(), options->stereo(), resampler) < 0)
 		return EXIT_FAILURE;
 	d->vBackend = d->sdlHandler->vBackend();
 
@@ -733,6 +1200,12 @@ int EmuLoop::run(const Options *options)
 		d->vBackend->osd_printf(1500, "ROM region detected as %s.", region_str);
 	}
 
+	// If a ROM profile was applied, print a message.
+	if (profile) {
+		d->vBackend->osd_printf(1500, "ROM profile applied: %s",
+			(profile->title[0] != 0 ? profile->title : rom_filename.c_str()));
+	}
+
 	// Set frame timing.
 	// TODO: SysVersion convenience function to check if a RegionCode_t is PAL.
 	bool isPal;
@@ -782,8 +1255,21 @@ int EmuLoop::run(const Options *options)
 		d->keyManager->setIoType(IoManager::VIRTPORT_2, IoManager::IOT_NONE);
 	}
 
+	// Start the movie, hash log, and capture, if any.
+	if (d->startMovie() != 0 || d->startHashLog() != 0 || d->startCapture() != 0) {
+		// Don't run without the requested movie, hash log, or capture.
+		d->running = false;
+	} else {
+		d->running = true;
+	}
+
+	// Apply the thread options.
+	d->applyThreadOptions();
+
+	// Start collecting profiler frame records.
+	d->startProfileTrace();
+
 	// TODO: Move some more common stuff back to gens-sdl.cpp.
-	d->running = true;
 	d->paused.data = 0;
 	d->last_paused.data = 0;
 	while (d->running) {
@@ -818,15 +1304,42 @@ int EmuLoop::run(const Options *options)
 		// Run a frame.
 		// EventLoop::runFrame() handles frameskip timing.
 		runFrame();
+		d->readProfileTrace();
 
 		// Autosave SRAM/EEPROM.
 		// TODO: EmuContext::execFrame() should probably do this itself...
 		d->emuContext->autoSaveData(1);
 
 		// Update the I/O manager.
-		d->keyManager->updateIoManager(d->emuContext->m_ioManager);
+		// During movie playback, the movie provides all input.
+		if (!d->movie || d->movie->mode() != InputMovie::MODE_PLAYBACK) {
+			d->keyManager->updateIoManager(d->emuContext->m_ioManager);
+		}
+	}
+
+	// Finish the movie.
+	if (d->movie) {
+		int ret = d->movie->stop();
+		if (ret != 0) {
+			fprintf(stderr, "Error finishing movie: %s\n", strerror(-ret));
+		}
+		delete d->movie;
+		d->movie = nullptr;
 	}
 
+	// Report frame-time jitter.
+	d->reportJitter();
+
+	// Finish the capture.
+	d->finishCapture();
+
+	// Write the profiler trace.
+	d->finishProfileTrace();
+
+	// Finish the hash log.
+	// A divergence from the golden log is reported in the exit code.
+	const int exitCode = (d->finishHashLog() != 0 ? EXIT_FAILURE : 0);
+
 	// Unreference the framebuffer.
 	fb->unref();
 
@@ -839,6 +1352,7 @@ int EmuLoop::run(const Options *options)
 	d->keyManager = nullptr;
 	delete d->emuContext;
 	d->emuContext = nullptr;
+	EmuContext::UnloadRomProfileDB();
 	delete d->rom;
 	d->rom = nullptr;
 
@@ -855,7 +1369,7 @@ int EmuLoop::run(const Options *options)
 	d->vBackend = nullptr;
 
 	// Done running the emulation loop.
-	return 0;
+	return exitCode;
 }
 
 /**
@@ -867,7 +1381,20 @@ int EmuLoop::run(const Options *options)
 void EmuLoop::runFullFrame(void)
 {
 	EmuLoopPrivate *const d = d_func();
+	d->doMovieFrame();
 	d->emuContext->execFrame();
+
+	// Only upload the framebuffer if it changed.
+	const uint64_t frameSig = d->emuContext->m_vdp->frameSignature();
+	d->fbDirty = (frameSig != d->lastFrameSig);
+	d->lastFrameSig = frameSig;
+
+	if (d->hashLog) {
+		d->hashLog->frame(d->emuContext->m_vdp->MD_Screen);
+	}
+	if (d->capture) {
+		d->capture->frame(d->emuContext->m_vdp->MD_Screen);
+	}
 }
 
 /**
@@ -879,6 +1406,12 @@ void EmuLoop::runFullFrame(void)
 void EmuLoop::runFastFrame(void)
 {
 	EmuLoopPrivate *const d = d_func();
+	if (d->hashLog || d->capture) {
+		// Every frame must be rendered for the hash log and capture.
+		runFullFrame();
+		return;
+	}
+	d->doMovieFrame();
 	d->emuContext->execFrameFast();
 }
 
@@ -61,6 +61,7 @@ EventLoopPrivate::EventLoopPrivate()
 	, frameskip(true)
 	, options(nullptr)
 	, exposed(false)
+	, fbDirty(true)
 	, lastF1time(0)
 	, usec_per_frame(0)
 	, win_title("Gens/GS II [SDL]")
@@ -92,6 +93,22 @@ void EventLoopPrivate::doFastBlur(void)
 	}
 }
 
+/**
+ * Cycle through the software scalers.
+ */
+void EventLoopPrivate::doScalerMode(void)
+{
+	int mode = (int)vBackend->scalerMode() + 1;
+	if (mode >= LibGens::Scaler::SCALER_MAX) {
+		mode = LibGens::Scaler::SCALER_NONE;
+	}
+	vBackend->setScalerMode((LibGens::Scaler::Mode)mode);
+
+	// Show an OSD message.
+	vBackend->osd_printf(1500, "Scaler: %s",
+		LibGens::Scaler::ModeName((LibGens::Scaler::Mode)mode));
+}
+
 /**
  * Common pause processing function.
  * Called by doPause() and doAutoPause().
@@ -110,6 +127,8 @@ void EventLoopPrivate::doPauseProcessing(void)
 
 	// Reset the clocks and counters.
 	clks.reset();
+	// Don't count the time spent paused as jitter.
+	jitter.skipFrame();
 	// Pause audio.
 	sdlHandler->pause_audio(any);
 
@@ -182,6 +201,7 @@ void EventLoopPrivate::setFrameTiming(int framerate)
 {
 	usec_per_frame = (1000000 / framerate);
 	clks.reset();
+	jitter.setTargetInterval(usec_per_frame);
 }
 
 /**
@@ -306,6 +326,11 @@ int EventLoop::processSdlEvent(const SDL_Event *event)
 					d_ptr->doFastBlur();
 					break;
 
+				case SDLK_F10:
+					// Software scaler.
+					d_ptr->doScalerMode();
+					break;
+
 				case SDLK_F12:
 					// FIXME: TEMPORARY KEY BINDING for debugging.
 					d_ptr->vBackend->setAspectRatioConstraint(!d_ptr->vBackend->aspectRatioConstraint());
@@ -483,17 +508,19 @@ void EventLoop::runFrame(void)
 			// Run a frame and render it.
 			runFullFrame();
 			d_ptr->sdlHandler->update_audio();
-			d_ptr->sdlHandler->update_video();
+			d_ptr->sdlHandler->update_video(d_ptr->fbDirty);
 			// Increment the frame counter.
 			d_ptr->clks.frames++;
+			d_ptr->jitter.addFrame(d_ptr->clks.timing.getTime());
 		}
 	} else {
 		// Run a frame and render it.
 		runFullFrame();
 		d_ptr->sdlHandler->update_audio();
-		d_ptr->sdlHandler->update_video();
+		d_ptr->sdlHandler->update_video(d_ptr->fbDirty);
 		// Increment the frame counter.
 		d_ptr->clks.frames++;
+		d_ptr->jitter.addFrame(d_ptr->clks.timing.getTime());
 	}
 }
 
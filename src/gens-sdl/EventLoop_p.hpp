@@ -46,6 +46,7 @@
 #endif
 
 #include "libgens/Util/Timing.hpp"
+#include "libgens/Util/FrameJitter.hpp"
 
 // C++ includes.
 #include <string>
@@ -76,6 +77,11 @@ class EventLoopPrivate
 		 */
 		void doFastBlur(void);
 
+		/**
+		 * Cycle through the software scalers.
+		 */
+		void doScalerMode(void);
+
 		/**
 		 * Common pause processing function.
 		 * Called by doPause() and doAutoPause().
@@ -125,6 +131,10 @@ class EventLoopPrivate
 		// Video should be updated if emulation is paused.
 		bool exposed;
 
+		// Framebuffer was changed by the last full frame.
+		// If false, the texture upload can be skipped.
+		bool fbDirty;
+
 		class clks_t {
 			public:
 				// Reset frameskip timers.
@@ -169,6 +179,10 @@ class EventLoopPrivate
 		// Microseconds per frame.
 		unsigned int usec_per_frame;
 
+		// Frame-time jitter statistics.
+		// Reported on exit if --jitter-report is specified.
+		LibGens::FrameJitter jitter;
+
 		/**
 		 * Set frame timing.
 		 * This resets the frameskip timers.
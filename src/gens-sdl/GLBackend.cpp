@@ -27,13 +27,17 @@ using LibGens::MdFb;
 // Effects.
 #include "libgens/Effects/PausedEffect.hpp"
 #include "libgens/Effects/FastBlur.hpp"
+#include "libgens/Effects/Scaler.hpp"
 using LibGens::PausedEffect;
 using LibGens::FastBlur;
+using LibGens::Scaler;
 
 // C includes. (C++ namespace)
+#include <cerrno>
 #include <cstdlib>
 #include <climits>
 #include <cstdio>
+#include <cstring>
 
 // OpenGL (GLEW)
 #include <GL/glew.h>
@@ -67,6 +71,11 @@ class GLBackendPrivate {
 		// Last MdFb bpp.
 		LibGens::MdFb::ColorDepth lastBpp;
 
+		// Software scaler.
+		Scaler scaler;
+		// Last scale factor.
+		int lastScaleFactor;
+
 		// OpenGL texture.
 		GLTex tex;
 
@@ -110,6 +119,25 @@ class GLBackendPrivate {
 		 */
 		const MdFb *applySoftwareEffects(void);
 
+		/**
+		 * Upload the MdFb to the texture, applying software effects.
+		 *
+		 * If streaming uploads are available, the final effect
+		 * is rendered directly into the mapped buffer, so the
+		 * frame isn't copied to an intermediate framebuffer.
+		 */
+		void uploadFb(void);
+
+		/**
+		 * Upload an image to the texture.
+		 * Streaming uploads are used if available.
+		 * @param data Image data.
+		 * @param w Width.
+		 * @param h Height.
+		 * @param pxPitch Pitch, in pixels.
+		 */
+		void uploadImage(const void *data, int w, int h, int pxPitch);
+
 		/**
 		 * Start applying shader effects.
 		 */
@@ -126,6 +154,7 @@ class GLBackendPrivate {
 GLBackendPrivate::GLBackendPrivate(GLBackend *q)
 	: q(q)
 	, lastBpp(MdFb::BPP_MAX)
+	, lastScaleFactor(1)
 	, prevMD_W(0), prevMD_H(0)
 	, prevStretchMode(VBackend::STRETCH_MAX)
 	, prevAspectRatioConstraint(true)
@@ -188,7 +217,11 @@ void GLBackendPrivate::reallocTexture(void)
 	}
 
 	// Allocate the GL texture.
-	tex.alloc(format, fb->pxPerLine(), fb->numLines());
+	// If a software scaler is in use, the texture
+	// has to be large enough for the scaled image.
+	lastScaleFactor = Scaler::ScaleFactor(q->m_scalerMode);
+	tex.alloc(format, fb->pxPerLine() * lastScaleFactor,
+		  fb->numLines() * lastScaleFactor);
 
 	// Recalculate the texture rectangle.
 	recalcTexRectF();
@@ -223,7 +256,7 @@ void GLBackendPrivate::recalcTexRectF(void)
 		if (imgXStart > 0) {
 			// Less than 320 pixels wide.
 			// Adjust horizontal stretch.
-			x = (double)imgXStart / (double)tex.texW;
+			x = (double)(imgXStart * lastScaleFactor) / (double)tex.texW;
 			w -= (2*x);
 		}
 	}
@@ -236,7 +269,7 @@ void GLBackendPrivate::recalcTexRectF(void)
 		if (imgYStart > 0) {
 			// Less than 240 pixels tall.
 			// Adjust vertical stretch.
-			y = (double)imgYStart / (double)tex.texH;
+			y = (double)(imgYStart * lastScaleFactor) / (double)tex.texH;
 			h -= (2*y);
 		}
 	}
@@ -352,6 +385,90 @@ const MdFb *GLBackendPrivate::applySoftwareEffects(void)
 	return fb;
 }
 
+/**
+ * Upload the MdFb to the texture, applying software effects.
+ *
+ * If streaming uploads are available, the final effect
+ * is rendered directly into the mapped buffer, so the
+ * frame isn't copied to an intermediate framebuffer.
+ */
+void GLBackendPrivate::uploadFb(void)
+{
+	const MdFb *fb = q->m_fb;
+	void *buf = tex.beginUpload(fb->pxPitch(), fb->numLines());
+	if (!buf) {
+		// Streaming isn't available.
+		fb = applySoftwareEffects();
+		const GLvoid *screen;
+		if (fb->bpp() != MdFb::BPP_32) {
+			screen = fb->fb16();
+		} else {
+			screen = fb->fb32();
+		}
+
+		// (Re-)Upload the texture.
+		tex.subImage2D(fb->pxPerLine(), fb->numLines(),
+				fb->pxPitch(), screen);
+		return;
+	}
+
+	const MdFb::ColorDepth bpp = fb->bpp();
+	const unsigned int pxCount = fb->pxPitch() * fb->numLines();
+	const bool doFastBlur = (q->m_fastBlur && !fastBlurShader->isUsable());
+	const bool doPausedEffect = q->m_pausedEffect;
+
+	// NOTE: Mapped buffers may be write-combined, so reading
+	// them back is slow. Only the last effect writes to the
+	// buffer; earlier effects use the internal framebuffer.
+	const MdFb *src = fb;
+	if (doFastBlur && doPausedEffect) {
+		if (!q->m_int_fb) {
+			q->m_int_fb = new MdFb();
+		}
+		FastBlur::DoFastBlur(q->m_int_fb, fb);
+		src = q->m_int_fb;
+	}
+
+	const void *screen;
+	if (bpp != MdFb::BPP_32) {
+		screen = src->fb16();
+	} else {
+		screen = src->fb32();
+	}
+
+	if (doPausedEffect) {
+		PausedEffect::DoPausedEffect(buf, screen, bpp, pxCount);
+	} else if (doFastBlur) {
+		FastBlur::DoFastBlur(buf, screen, bpp, pxCount);
+	} else {
+		memcpy(buf, screen, pxCount * (bpp == MdFb::BPP_32 ? 4 : 2));
+	}
+
+	tex.endUpload(fb->pxPerLine(), fb->numLines(), fb->pxPitch());
+}
+
+/**
+ * Upload an image to the texture.
+ * Streaming uploads are used if available.
+ * @param data Image data.
+ * @param w Width.
+ * @param h Height.
+ * @param pxPitch Pitch, in pixels.
+ */
+void GLBackendPrivate::uploadImage(const void *data, int w, int h, int pxPitch)
+{
+	void *buf = tex.beginUpload(pxPitch, h);
+	if (!buf) {
+		// Streaming isn't available.
+		tex.subImage2D(w, h, pxPitch, data);
+		return;
+	}
+
+	const int bytesPerPx = (lastBpp == MdFb::BPP_32 ? 4 : 2);
+	memcpy(buf, data, pxPitch * h * bytesPerPx);
+	tex.endUpload(w, h, pxPitch);
+}
+
 /**
  * Start applying shader effects.
  */
@@ -427,26 +544,31 @@ void GLBackend::update(bool fb_dirty)
 	if (m_fb && (fb_dirty || isForceFbDirty())) {
 		// Check if the bpp or texture size has changed.
 		// TODO: texVisSizeChanged?
-		if (m_fb->bpp() != d->lastBpp /*|| d->texVisSizeChanged*/) {
-			// Bpp has changed. reallocate the texture.
+		if (m_fb->bpp() != d->lastBpp ||
+		    Scaler::ScaleFactor(m_scalerMode) != d->lastScaleFactor
+		    /*|| d->texVisSizeChanged*/)
+		{
+			// Bpp or scale factor has changed. reallocate the texture.
 			// VDP palettes will be recalculated on the next frame.
 			d->reallocTexture();
 		}
 
-		// Apply software framebuffer effects.
-		const MdFb *fb = d->applySoftwareEffects();
-
-		// Get the screen buffer.
-		const GLvoid *screen;
-		if (fb->bpp() != MdFb::BPP_32) {
-			screen = fb->fb16();
+		if (m_scalerMode != Scaler::SCALER_NONE) {
+			// Apply software framebuffer effects.
+			const MdFb *fb = d->applySoftwareEffects();
+
+			// Scale the framebuffer.
+			d->scaler.setMode(m_scalerMode);
+			if (d->scaler.scale(fb) == 0) {
+				// (Re-)Upload the texture.
+				const Scaler *const scaler = &d->scaler;
+				d->uploadImage(scaler->fb(), scaler->width(),
+						scaler->height(), scaler->pxPitch());
+			}
 		} else {
-			screen = fb->fb32();
+			// (Re-)Upload the texture.
+			d->uploadFb();
 		}
-
-		// (Re-)Upload the texture.
-		d->tex.subImage2D(fb->pxPerLine(), fb->numLines(),
-				fb->pxPitch(), screen);
 	}
 
 	// Bind the texture.
@@ -525,6 +647,23 @@ void GLBackend::resize(int width, int height)
 	d->recalcAspectRatio();
 }
 
+/**
+ * Set the OpenGL texture upload method.
+ * @param method Upload method name, e.g. "auto", "pbo", or "persistent".
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int GLBackend::setUploadMethod(const char *method)
+{
+	const GLTex::UploadMethod uploadMethod = GLTex::UploadMethodFromName(method);
+	if (uploadMethod == GLTex::UPLOAD_MAX)
+		return -EINVAL;
+
+	// TODO: makeCurrent()?
+	d->tex.setUploadMethod(uploadMethod);
+	setForceFbDirty();
+	return 0;
+}
+
 /** OpenGL functions. **/
 
 /**
@@ -575,10 +714,9 @@ void GLBackend::endGL(void)
 	// Shut down the OSD.
 	d->osd->end();
 
-	if (d->tex.name > 0) {
-		glDeleteTextures(1, &d->tex.name);
-		d->tex.name = 0;
-	}
+	// Free the texture and its streaming buffers
+	// while the GL context is still active.
+	d->tex.dealloc();
 }
 
 /** Onscreen Display functions. **/
@@ -67,6 +67,13 @@ class GLBackend : public VBackend {
 		 */
 		virtual void resize(int width, int height) override;
 
+		/**
+		 * Set the OpenGL texture upload method.
+		 * @param method Upload method name, e.g. "auto", "pbo", or "persistent".
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int setUploadMethod(const char *method);
+
 	public:
 		/** Onscreen Display functions. **/
 
@@ -44,9 +44,19 @@ GLTex::GLTex()
 	: name(0)
 	, format(0)
 	, type(0)
+	, streamBufSz(0)
+	, streamIdx(0)
+	, m_uploadMethod(UPLOAD_AUTO)
+	, m_activeUploadMethod(UPLOAD_AUTO)
 	, texW(0), texH(0)
 	, texVisW(0), texVisH(0)
-{ }
+{
+	for (int i = 0; i < NUM_STREAM_BUFS; i++) {
+		streamBuf[i] = 0;
+		streamMap[i] = nullptr;
+		streamFence[i] = nullptr;
+	}
+}
 
 GLTex::~GLTex()
 {
@@ -201,6 +211,7 @@ int GLTex::alloc(Format format, int w, int h)
 
 void GLTex::dealloc(void)
 {
+	freeStreamBufs();
 	if (name > 0) {
 		glDeleteTextures(1, &name);
 		name = 0;
@@ -213,7 +224,7 @@ void GLTex::dealloc(void)
  * @param w Width.
  * @param h Height.
  * @param pxPitch Pitch, in pixels.
- * @param data Image data.
+ * @param data Image data. (If a pixel unpack buffer is bound, offset into the buffer.)
  */
 void GLTex::subImage2D(int w, int h, int pxPitch, const void *data)
 {
@@ -232,9 +243,337 @@ void GLTex::subImage2D(int w, int h, int pxPitch, const void *data)
 			this->format, this->type, data);
 
 	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);	// GL default.
 
 	glDisable(GL_TEXTURE_2D);
 }
 
+/** Streaming uploads. **/
+
+// Upload method names.
+static const char *const uploadMethodNames[GLTex::UPLOAD_MAX] = {
+	"auto", "texsubimage", "pbo", "persistent"
+};
+
+/**
+ * Get the name of an upload method.
+ * @param method Upload method.
+ * @return Upload method name, or nullptr if invalid.
+ */
+const char *GLTex::UploadMethodName(UploadMethod method)
+{
+	if (method < UPLOAD_AUTO || method >= UPLOAD_MAX)
+		return nullptr;
+	return uploadMethodNames[method];
+}
+
+/**
+ * Get an upload method from its name.
+ * @param name Upload method name. (case-insensitive)
+ * @return Upload method, or UPLOAD_MAX if the name is invalid.
+ */
+GLTex::UploadMethod GLTex::UploadMethodFromName(const char *name)
+{
+	if (!name)
+		return UPLOAD_MAX;
+	for (int i = 0; i < UPLOAD_MAX; i++) {
+		if (!strcasecmp(name, uploadMethodNames[i]))
+			return (UploadMethod)i;
+	}
+	return UPLOAD_MAX;
+}
+
+/**
+ * Set the upload method.
+ * If the method isn't supported by the GL implementation,
+ * the next best method will be used.
+ * @param method Upload method.
+ */
+void GLTex::setUploadMethod(UploadMethod method)
+{
+	if (method < UPLOAD_AUTO || method >= UPLOAD_MAX)
+		method = UPLOAD_AUTO;
+	if (m_uploadMethod == method)
+		return;
+
+	// The streaming buffers will be reallocated
+	// on the next call to beginUpload().
+	freeStreamBufs();
+	m_uploadMethod = method;
+	m_activeUploadMethod = UPLOAD_AUTO;
+}
+
+/**
+ * Bytes per pixel for the current texture format.
+ * @return Bytes per pixel.
+ */
+int GLTex::bytesPerPixel(void) const
+{
+	if (this->format == GL_ALPHA)
+		return 1;
+	return (this->type == SDLGL_UNSIGNED_BYTE ? 4 : 2);
+}
+
+/**
+ * Resolve the requested upload method based on
+ * the GL implementation's capabilities.
+ * @return Upload method to use.
+ */
+GLTex::UploadMethod GLTex::resolveUploadMethod(void) const
+{
+	// Pixel buffer objects require OpenGL 2.1 or GL_ARB_pixel_buffer_object.
+	// NOTE: Buffer object functions are part of OpenGL 1.5.
+	const bool hasPbo = GLEW_VERSION_1_5 &&
+		(GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object);
+
+	// Persistent mapping requires GL_ARB_buffer_storage,
+	// and GL_ARB_sync is needed to avoid overwriting
+	// buffers that the GL is still reading from.
+	const bool hasPersistent = hasPbo &&
+		GLEW_ARB_buffer_storage &&
+		GLEW_ARB_map_buffer_range &&
+		GLEW_ARB_sync;
+
+	switch (m_uploadMethod) {
+		case UPLOAD_AUTO:
+		case UPLOAD_PERSISTENT:
+		default:
+			if (hasPersistent)
+				return UPLOAD_PERSISTENT;
+			// fall-through
+		case UPLOAD_PBO:
+			if (hasPbo)
+				return UPLOAD_PBO;
+			// fall-through
+		case UPLOAD_TEXSUBIMAGE:
+			break;
+	}
+
+	return UPLOAD_TEXSUBIMAGE;
+}
+
+/**
+ * (Re-)allocate the streaming buffers.
+ * @param size Size of each buffer, in bytes.
+ * @return 0 on success; non-zero on error.
+ */
+int GLTex::allocStreamBufs(size_t size)
+{
+	freeStreamBufs();
+
+	glGenBuffers(NUM_STREAM_BUFS, streamBuf);
+	int ret = 0;
+	for (int i = 0; i < NUM_STREAM_BUFS; i++) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, streamBuf[i]);
+		if (m_activeUploadMethod == UPLOAD_PERSISTENT) {
+			// Immutable storage, mapped for the lifetime of the buffer.
+			// GL_MAP_COHERENT_BIT makes CPU writes visible to
+			// subsequent GL commands without explicit flushes.
+			static const GLbitfield flags =
+				GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+			streamMap[i] = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+			if (!streamMap[i]) {
+				ret = -ENOMEM;
+				break;
+			}
+		} else {
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+		}
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (ret != 0) {
+		freeStreamBufs();
+		return ret;
+	}
+
+	streamBufSz = size;
+	streamIdx = 0;
+	return 0;
+}
+
+/**
+ * Free the streaming buffers.
+ */
+void GLTex::freeStreamBufs(void)
+{
+	if (streamBuf[0] == 0) {
+		// No buffers allocated.
+		return;
+	}
+
+	for (int i = 0; i < NUM_STREAM_BUFS; i++) {
+		if (streamFence[i]) {
+			glDeleteSync(streamFence[i]);
+			streamFence[i] = nullptr;
+		}
+		if (streamMap[i]) {
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, streamBuf[i]);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			streamMap[i] = nullptr;
+		}
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	glDeleteBuffers(NUM_STREAM_BUFS, streamBuf);
+	for (int i = 0; i < NUM_STREAM_BUFS; i++) {
+		streamBuf[i] = 0;
+	}
+	streamBufSz = 0;
+}
+
+/**
+ * Wait for the GL to finish reading a streaming buffer.
+ * @param idx Buffer index.
+ * @return 0 if the buffer is idle; -EBUSY if the GL is still reading it.
+ */
+int GLTex::waitStreamFence(int idx)
+{
+	if (!streamFence[idx]) {
+		// No pending upload.
+		return 0;
+	}
+
+	// With three buffers, the fence is usually already signaled.
+	// Each wait is 100 ms, in nanoseconds.
+	static const GLuint64 STREAM_FENCE_TIMEOUT = 100000000;
+	static const int STREAM_FENCE_TRIES = 5;
+	GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	for (int i = 0; i < STREAM_FENCE_TRIES; i++) {
+		switch (glClientWaitSync(streamFence[idx], flags, STREAM_FENCE_TIMEOUT)) {
+			case GL_ALREADY_SIGNALED:
+			case GL_CONDITION_SATISFIED:
+				glDeleteSync(streamFence[idx]);
+				streamFence[idx] = nullptr;
+				return 0;
+
+			case GL_TIMEOUT_EXPIRED:
+				// Commands have already been flushed.
+				// Wait again.
+				flags = 0;
+				break;
+
+			case GL_WAIT_FAILED:
+			default:
+				// The fence can't be waited on.
+				// Wait for all GL commands to finish instead.
+				fprintf(stderr, "GLTex: glClientWaitSync() failed; using glFinish().\n");
+				glFinish();
+				glDeleteSync(streamFence[idx]);
+				streamFence[idx] = nullptr;
+				return 0;
+		}
+	}
+
+	// Still not signaled. Keep the fence so the
+	// buffer isn't reused until it's signaled.
+	return -EBUSY;
+}
+
+/**
+ * Start a streaming upload.
+ *
+ * The returned buffer is owned by the GL and must be
+ * completely written by the caller before endUpload().
+ * If streaming isn't available, or if the GL is still
+ * reading the next buffer, nullptr is returned, and
+ * the caller should use subImage2D() instead.
+ *
+ * @param pxPitch Pitch, in pixels.
+ * @param h Height.
+ * @return Buffer to write the image to, or nullptr if streaming isn't available.
+ */
+void *GLTex::beginUpload(int pxPitch, int h)
+{
+	if (name == 0)
+		return nullptr;
+
+	if (m_activeUploadMethod == UPLOAD_AUTO) {
+		// Determine the upload method.
+		m_activeUploadMethod = resolveUploadMethod();
+		fprintf(stderr, "GLTex: Using texture upload method '%s'.\n",
+			UploadMethodName(m_activeUploadMethod));
+	}
+	if (m_activeUploadMethod == UPLOAD_TEXSUBIMAGE)
+		return nullptr;
+
+	const size_t size = (size_t)pxPitch * h * bytesPerPixel();
+	if (size != streamBufSz) {
+		if (allocStreamBufs(size) != 0) {
+			// Unable to allocate the buffers.
+			// Fall back to the next best method.
+			m_activeUploadMethod = (m_activeUploadMethod == UPLOAD_PERSISTENT
+						? UPLOAD_PBO : UPLOAD_TEXSUBIMAGE);
+			fprintf(stderr, "GLTex: Unable to allocate streaming buffers; "
+				"falling back to '%s'.\n",
+				UploadMethodName(m_activeUploadMethod));
+			return beginUpload(pxPitch, h);
+		}
+	}
+
+	// Next buffer in the ring.
+	// Wait for the GL to finish reading it first.
+	const int idx = (streamIdx + 1) % NUM_STREAM_BUFS;
+	if (waitStreamFence(idx) != 0) {
+		// The GL is still reading this buffer.
+		// Don't advance the ring; the caller will use
+		// subImage2D() for this upload instead.
+		return nullptr;
+	}
+	streamIdx = idx;
+
+	if (m_activeUploadMethod == UPLOAD_PERSISTENT) {
+		// Buffer is already mapped.
+		return streamMap[idx];
+	}
+
+	// Map the buffer for writing.
+	void *ptr;
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, streamBuf[idx]);
+	if (GLEW_ARB_map_buffer_range) {
+		// Invalidate the buffer so the driver doesn't have to
+		// preserve its contents. If fences are available, the
+		// buffer is known to be idle, so skip synchronization.
+		GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+		if (GLEW_ARB_sync) {
+			access |= GL_MAP_UNSYNCHRONIZED_BIT;
+		}
+		ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, access);
+	} else {
+		// Orphan the buffer, then map it.
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+		ptr = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	return ptr;
+}
+
+/**
+ * Finish a streaming upload started by beginUpload().
+ * The texture is updated asynchronously.
+ * @param w Width.
+ * @param h Height.
+ * @param pxPitch Pitch, in pixels.
+ */
+void GLTex::endUpload(int w, int h, int pxPitch)
+{
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, streamBuf[streamIdx]);
+	if (m_activeUploadMethod != UPLOAD_PERSISTENT) {
+		// Unmap the buffer before the GL reads from it.
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	}
+
+	// Upload the sub-image from the bound buffer.
+	// NOTE: data is an offset into the buffer object.
+	subImage2D(w, h, pxPitch, nullptr);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (GLEW_ARB_sync) {
+		// Fence the upload so the buffer isn't
+		// overwritten while the GL is reading it.
+		streamFence[streamIdx] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+}
+
 }
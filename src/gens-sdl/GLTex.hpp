@@ -72,10 +72,82 @@ class GLTex
 		 * @param w Width.
 		 * @param h Height.
 		 * @param pxPitch Pitch, in pixels.
-		 * @param data Image data.
+		 * @param data Image data. (If a pixel unpack buffer is bound, offset into the buffer.)
 		 */
 		void subImage2D(int w, int h, int pxPitch, const void *data);
 
+	public:
+		/** Streaming uploads. **/
+
+		// Texture upload method.
+		enum UploadMethod {
+			UPLOAD_AUTO,		// Best available method.
+			UPLOAD_TEXSUBIMAGE,	// glTexSubImage2D() from client memory.
+			UPLOAD_PBO,		// Ring of pixel buffer objects. (GL 2.1)
+			UPLOAD_PERSISTENT,	// Persistently-mapped buffer ring. (GL 4.4)
+
+			UPLOAD_MAX
+		};
+
+		/**
+		 * Get the name of an upload method.
+		 * @param method Upload method.
+		 * @return Upload method name, or nullptr if invalid.
+		 */
+		static const char *UploadMethodName(UploadMethod method);
+
+		/**
+		 * Get an upload method from its name.
+		 * @param name Upload method name. (case-insensitive)
+		 * @return Upload method, or UPLOAD_MAX if the name is invalid.
+		 */
+		static UploadMethod UploadMethodFromName(const char *name);
+
+		/**
+		 * Get the requested upload method.
+		 * @return Requested upload method.
+		 */
+		inline UploadMethod uploadMethod(void) const;
+
+		/**
+		 * Get the upload method that's actually in use.
+		 * UPLOAD_AUTO is resolved once the first upload starts.
+		 * @return Active upload method.
+		 */
+		inline UploadMethod activeUploadMethod(void) const;
+
+		/**
+		 * Set the upload method.
+		 * If the method isn't supported by the GL implementation,
+		 * the next best method will be used.
+		 * @param method Upload method.
+		 */
+		void setUploadMethod(UploadMethod method);
+
+		/**
+		 * Start a streaming upload.
+		 *
+		 * The returned buffer is owned by the GL and must be
+		 * completely written by the caller before endUpload().
+		 * If streaming isn't available, or if the GL is still
+		 * reading the next buffer, nullptr is returned, and
+		 * the caller should use subImage2D() instead.
+		 *
+		 * @param pxPitch Pitch, in pixels.
+		 * @param h Height.
+		 * @return Buffer to write the image to, or nullptr if streaming isn't available.
+		 */
+		void *beginUpload(int pxPitch, int h);
+
+		/**
+		 * Finish a streaming upload started by beginUpload().
+		 * The texture is updated asynchronously.
+		 * @param w Width.
+		 * @param h Height.
+		 * @param pxPitch Pitch, in pixels.
+		 */
+		void endUpload(int w, int h, int pxPitch);
+
 	public:
 		/**
 		 * Convert x/y/width/height to texture or vertex coordinates.
@@ -117,6 +189,54 @@ class GLTex
 		GLenum format;		// Texture format. (GL_RGB, GL_BGRA)
 		GLenum type;		// Texture type. (GL_UNSIGNED_BYTE, etc.)
 
+		/**
+		 * Streaming buffer ring.
+		 * Three buffers are used so the CPU can write one buffer
+		 * while the GL reads from another, and a third is still
+		 * in flight, without stalling either side.
+		 */
+		static const int NUM_STREAM_BUFS = 3;
+		GLuint streamBuf[NUM_STREAM_BUFS];	// Buffer object names.
+		void *streamMap[NUM_STREAM_BUFS];	// Persistent mappings.
+		GLsync streamFence[NUM_STREAM_BUFS];	// Fences for pending uploads.
+		size_t streamBufSz;	// Size of each buffer, in bytes.
+		int streamIdx;		// Current buffer index.
+
+		UploadMethod m_uploadMethod;		// Requested upload method.
+		UploadMethod m_activeUploadMethod;	// Active upload method.
+
+		/**
+		 * Bytes per pixel for the current texture format.
+		 * @return Bytes per pixel.
+		 */
+		int bytesPerPixel(void) const;
+
+		/**
+		 * Resolve the requested upload method based on
+		 * the GL implementation's capabilities.
+		 * @return Upload method to use.
+		 */
+		UploadMethod resolveUploadMethod(void) const;
+
+		/**
+		 * (Re-)allocate the streaming buffers.
+		 * @param size Size of each buffer, in bytes.
+		 * @return 0 on success; non-zero on error.
+		 */
+		int allocStreamBufs(size_t size);
+
+		/**
+		 * Free the streaming buffers.
+		 */
+		void freeStreamBufs(void);
+
+		/**
+		 * Wait for the GL to finish reading a streaming buffer.
+		 * @param idx Buffer index.
+		 * @return 0 if the buffer is idle; -EBUSY if the GL is still reading it.
+		 */
+		int waitStreamFence(int idx);
+
 	public:
 		// TODO: Accessors.
 		// TODO: Size type?
@@ -182,6 +302,25 @@ inline void GLTex::toCoords(T coords[8], T x, T y, T width, T height)
 	coords[7] = y+height;
 }
 
+/**
+ * Get the requested upload method.
+ * @return Requested upload method.
+ */
+inline GLTex::UploadMethod GLTex::uploadMethod(void) const
+{
+	return m_uploadMethod;
+}
+
+/**
+ * Get the upload method that's actually in use.
+ * UPLOAD_AUTO is resolved once the first upload starts.
+ * @return Active upload method.
+ */
+inline GLTex::UploadMethod GLTex::activeUploadMethod(void) const
+{
+	return m_activeUploadMethod;
+}
+
 /**
  * Get the visible texture ratio. (width)
  * @return Visible texture ratio. (width)
@@ -39,6 +39,19 @@ using std::string;
 // popt
 #include <popt.h>
 
+// OpenGL texture upload methods.
+#include "GLTex.hpp"
+
+// Video capture formats.
+#include "libgens/Util/Capture.hpp"
+using LibGens::Capture;
+
+// Thread scheduling.
+#include "libcompat/thread_sched.h"
+
+// GENS_ENABLE_PROFILER
+#include "libgens/config.libgens.h"
+
 namespace GensSdl {
 
 class OptionsPrivate
@@ -74,20 +87,51 @@ class OptionsPrivate
 		// Audio options.
 		int sound_freq;			// Sound frequency.
 		int stereo;			// Stereo audio?
+		int resampler;			// Use the resampler?
 
 		// Emulation options.
 		int sprite_limits;		// Enable sprite limits?
 		int auto_fix_checksum;		// Auto fix checksum?
+		int idle_skip;			// Skip idle loops?
+		int m68k_idle_skip;		// Skip M68K idle loops?
+		int zomg_version;		// ZOMG format version for savestates.
 		SysVersion::RegionCode_t region;	// Region code.
+		int rom_profile;		// Use the ROM profile database?
+		string rom_profile_db;		// ROM profile database filename.
+
+		// Options that were explicitly specified on the
+		// command line. These override ROM profile hints.
+		bool resampler_set;
+		bool sprite_limits_set;
+		bool idle_skip_set;
 
 		// UI options.
 		int fps_counter;		// Enable FPS counter?
 		int auto_pause;			// Auto pause?
 		int paused_effect;		// Paused effect?
 		MdFb::ColorDepth bpp;		// Color depth. (15, 16, 32)
+		string gl_upload;		// OpenGL texture upload method.
+
+		// Thread options.
+		int emu_cpu;			// CPU for the emulation thread. (-1 for any)
+		int audio_cpu;			// CPU for the audio thread. (-1 for any)
+		int sched_policy;		// Scheduling policy. (thread_sched_policy_t)
+		int rt_priority;		// Real-time priority.
+		int nice;			// Niceness.
+		int mlock;			// Lock memory?
+		int jitter_report;		// Report frame-time jitter on exit?
 
 		// Special run modes.
 		int run_crazy_effect;		// Run the Crazy Effect
+		string record_movie;		// Movie to record.
+		string play_movie;		// Movie to play back.
+		string hash_log;		// Hash log to write.
+		string golden_log;		// Golden hash log to compare against.
+		string capture_wav;		// WAV file to capture audio to.
+		string capture_vgm;		// VGM file to capture sound chip writes to.
+		string capture_video;		// Video file or "|command" to capture video to.
+		string capture_video_format;	// Video capture format.
+		string profile_trace;		// Chrome trace to write the profiler data to.
 };
 
 /** OptionsPrivate **/
@@ -112,20 +156,48 @@ void OptionsPrivate::reset(void)
 	// Audio options.
 	sound_freq = 44100;
 	stereo = true;
+	resampler = false;
 
 	// Emulation options.
 	sprite_limits = true;
 	auto_fix_checksum = false;
+	idle_skip = true;
+	m68k_idle_skip = false;
+	zomg_version = 1;
 	region = SysVersion::REGION_AUTO;
+	rom_profile = true;
+	rom_profile_db.clear();
+	resampler_set = false;
+	sprite_limits_set = false;
+	idle_skip_set = false;
 
 	// UI options.
 	fps_counter = true;
 	auto_pause = false;
 	paused_effect = true;
 	bpp = MdFb::BPP_32;
+	gl_upload = "auto";
+
+	// Thread options.
+	emu_cpu = -1;
+	audio_cpu = -1;
+	sched_policy = THREAD_SCHED_NORMAL;
+	rt_priority = 10;
+	nice = 0;
+	mlock = false;
+	jitter_report = false;
 
 	// Special run modes.
 	run_crazy_effect = false;
+	record_movie.clear();
+	play_movie.clear();
+	hash_log.clear();
+	golden_log.clear();
+	capture_wav.clear();
+	capture_vgm.clear();
+	capture_video.clear();
+	capture_video_format = "raw";
+	profile_trace.clear();
 }
 
 /** Options **/
@@ -200,6 +272,16 @@ int Options::parse(int argc, const char *argv[])
 	// Reset the options.
 	reset();
 
+	// Options that can be overridden by ROM profiles
+	// start out as -1 so we can tell if they were
+	// specified on the command line.
+	const int def_resampler = d->resampler;
+	const int def_sprite_limits = d->sprite_limits;
+	const int def_idle_skip = d->idle_skip;
+	d->resampler = -1;
+	d->sprite_limits = -1;
+	d->idle_skip = -1;
+
 	// Temporary internal option variables.
 	// Required for strings, since popt uses
 	// const char*, so we have to copy them
@@ -208,7 +290,19 @@ int Options::parse(int argc, const char *argv[])
 		const char *rom_filename;
 		const char *tmss_rom_filename;
 		const char *region;
+		const char *rom_profile_db;
 		int bpp;
+		const char *gl_upload;
+		const char *sched;
+		const char *record_movie;
+		const char *play_movie;
+		const char *hash_log;
+		const char *golden_log;
+		const char *capture_wav;
+		const char *capture_vgm;
+		const char *capture_video;
+		const char *capture_video_format;
+		const char *profile_trace;
 	} tmp;
 	memset(&tmp, 0, sizeof(tmp));
 	tmp.bpp = 32;
@@ -232,6 +326,11 @@ int Options::parse(int argc, const char *argv[])
 			"  Use monaural audio.", NULL},
 		{"stereo", '\0', POPT_ARG_VAL, &d->stereo, 1,
 			"  Use stereo audio.", NULL},
+		{"resampler", '\0', POPT_ARG_VAL, &d->resampler, 1,
+			"  Synthesize audio at the YM2612's native rate and\n"
+			"  resample it to FREQ. (Allows up to 192000 Hz.)", NULL},
+		{"no-resampler", '\0', POPT_ARG_VAL, &d->resampler, 0,
+			"* Synthesize audio directly at FREQ. (Up to 48000 Hz.)", NULL},
 		POPT_TABLEEND
 	};
 
@@ -245,6 +344,25 @@ int Options::parse(int argc, const char *argv[])
 			"  Automatically fix checksums.", NULL},
 		{"no-auto-fix-checksum", '\0', POPT_ARG_VAL, &d->auto_fix_checksum, 0,
 			"* Don't automatically fix checksums.", NULL},
+		{"idle-skip", '\0', POPT_ARG_VAL, &d->idle_skip, 1,
+			"* Skip Z80 idle loops.", NULL},
+		{"no-idle-skip", '\0', POPT_ARG_VAL, &d->idle_skip, 0,
+			"  Don't skip Z80 idle loops.", NULL},
+		{"m68k-idle-skip", '\0', POPT_ARG_VAL, &d->m68k_idle_skip, 1,
+			"  Skip M68K idle loops. (experimental)", NULL},
+		{"no-m68k-idle-skip", '\0', POPT_ARG_VAL, &d->m68k_idle_skip, 0,
+			"* Don't skip M68K idle loops.", NULL},
+		{"zomg-v2", '\0', POPT_ARG_VAL, &d->zomg_version, 2,
+			"  Save states in ZOMG v2 format. (LZ4 payload)", NULL},
+		{"zomg-v1", '\0', POPT_ARG_VAL, &d->zomg_version, 1,
+			"* Save states in ZOMG v1 format.", NULL},
+		{"rom-profile-db", '\0', POPT_ARG_STRING, &tmp.rom_profile_db, 0,
+			"  ROM profile database. (default: romprofile.db\n"
+			"  in the configuration directory)", "FILENAME"},
+		{"rom-profile", '\0', POPT_ARG_VAL, &d->rom_profile, 1,
+			"* Apply per-ROM profiles from the database.", NULL},
+		{"no-rom-profile", '\0', POPT_ARG_VAL, &d->rom_profile, 0,
+			"  Don't apply per-ROM profiles.", NULL},
 		{"region", '\0', POPT_ARG_STRING, &tmp.region, 0,
 			"  Set the region code: J,U,E,Asia,Auto (default is auto)", "REGION"},
 		POPT_TABLEEND
@@ -266,6 +384,32 @@ int Options::parse(int argc, const char *argv[])
 			"  Don't tint the window when paused.", NULL},
 		{"bpp", '\0', POPT_ARG_INT, &tmp.bpp, 0,
 			"  Set the internal color depth. (15, 16, 32)", "BPP"},
+		{"gl-upload", '\0', POPT_ARG_STRING, &tmp.gl_upload, 0,
+			"  Set the OpenGL texture upload method:\n"
+			"  auto, texsubimage, pbo, persistent (default is auto)", "METHOD"},
+		POPT_TABLEEND
+	};
+
+	// popt: thread options table.
+	struct poptOption threadOptionsTable[] = {
+		{"emu-cpu", '\0', POPT_ARG_INT, &d->emu_cpu, 0,
+			"  Pin the emulation and rendering thread to a CPU.", "CPU"},
+		{"audio-cpu", '\0', POPT_ARG_INT, &d->audio_cpu, 0,
+			"  Pin the audio thread to a CPU.", "CPU"},
+		{"sched", '\0', POPT_ARG_STRING, &tmp.sched, 0,
+			"  Scheduling policy for the emulation and audio threads:\n"
+			"  normal, fifo, rr (default is normal)", "POLICY"},
+		{"rt-priority", '\0', POPT_ARG_INT, &d->rt_priority, 0,
+			"  Real-time priority for --sched=fifo or rr. (1-98)\n"
+			"  The audio thread uses PRIO+1. (default is 10)", "PRIO"},
+		{"nice", '\0', POPT_ARG_INT, &d->nice, 0,
+			"  Niceness for the emulation and audio threads. (-20 to 19)", "NICE"},
+		{"mlock", '\0', POPT_ARG_VAL, &d->mlock, 1,
+			"  Lock the emulator's memory so it can't be paged out.", NULL},
+		{"no-mlock", '\0', POPT_ARG_VAL, &d->mlock, 0,
+			"* Don't lock memory.", NULL},
+		{"jitter-report", '\0', POPT_ARG_VAL, &d->jitter_report, 1,
+			"  Report frame-time jitter on exit.", NULL},
 		POPT_TABLEEND
 	};
 
@@ -273,6 +417,29 @@ int Options::parse(int argc, const char *argv[])
 	struct poptOption runModesTable[] = {
 		{"crazy-effect", '\0', POPT_ARG_VAL, &d->run_crazy_effect, 1,
 			"  Run the \"Crazy\" Effect instead of loading a ROM.", NULL},
+		{"record-movie", '\0', POPT_ARG_STRING, &tmp.record_movie, 0,
+			"  Record input to a movie file. The start state is saved\n"
+			"  as FILENAME.zomg.", "FILENAME"},
+		{"play-movie", '\0', POPT_ARG_STRING, &tmp.play_movie, 0,
+			"  Play back input from a movie file.", "FILENAME"},
+		{"hash-log", '\0', POPT_ARG_STRING, &tmp.hash_log, 0,
+			"  Write a hash of every frame's video and audio to a log.\n"
+			"  Emulation exits when movie playback finishes.", "FILENAME"},
+		{"golden-log", '\0', POPT_ARG_STRING, &tmp.golden_log, 0,
+			"  Compare the hash log to a golden log on exit, and\n"
+			"  report the first divergent frame.", "FILENAME"},
+		{"capture-wav", '\0', POPT_ARG_STRING, &tmp.capture_wav, 0,
+			"  Capture audio to a WAV file.", "FILENAME"},
+		{"capture-vgm", '\0', POPT_ARG_STRING, &tmp.capture_vgm, 0,
+			"  Capture YM2612 and PSG register writes to a VGM file.", "FILENAME"},
+		{"capture-video", '\0', POPT_ARG_STRING, &tmp.capture_video, 0,
+			"  Capture video to a file. If FILENAME starts with '|',\n"
+			"  the video is piped to the rest of it as a command.", "FILENAME"},
+		{"capture-video-format", '\0', POPT_ARG_STRING, &tmp.capture_video_format, 0,
+			"  Video capture format: raw (RGB24), y4m", "FORMAT"},
+		{"profile-trace", '\0', POPT_ARG_STRING, &tmp.profile_trace, 0,
+			"  Write the profiler's frame records to a Chrome trace\n"
+			"  on exit. (Requires ENABLE_PROFILER.)", "FILENAME"},
 		POPT_TABLEEND
 	};
 
@@ -286,6 +453,8 @@ int Options::parse(int argc, const char *argv[])
 			"Emulation options: (* indicates default)", NULL},
 		{NULL, '\0', POPT_ARG_INCLUDE_TABLE, uiOptionsTable, 0,
 			"UI options: (* indicates default)", NULL},
+		{NULL, '\0', POPT_ARG_INCLUDE_TABLE, threadOptionsTable, 0,
+			"Thread options: (* indicates default)", NULL},
 		{NULL, '\0', POPT_ARG_INCLUDE_TABLE, runModesTable, 0,
 			"Special run modes:", NULL},
 		{NULL, '\0', POPT_ARG_INCLUDE_TABLE, helpOptionsTable, 0,
@@ -373,12 +542,89 @@ int Options::parse(int argc, const char *argv[])
 
 	// Process arguments to ensure that they're valid.
 
+	// Options that weren't specified use the default values.
+	d->resampler_set = (d->resampler >= 0);
+	if (!d->resampler_set)
+		d->resampler = def_resampler;
+	d->sprite_limits_set = (d->sprite_limits >= 0);
+	if (!d->sprite_limits_set)
+		d->sprite_limits = def_sprite_limits;
+	d->idle_skip_set = (d->idle_skip >= 0);
+	if (!d->idle_skip_set)
+		d->idle_skip = def_idle_skip;
+
+	// ROM profile database.
+	if (tmp.rom_profile_db != nullptr) {
+		d->rom_profile_db = string(tmp.rom_profile_db);
+	}
+
 	// TMSS ROM filename.
 	if (tmp.tmss_rom_filename != nullptr) {
 		// TMSS ROM filename was specified.
 		d->tmss_rom_filename = string(tmp.tmss_rom_filename);
 	}
 
+	// Movies.
+	if (tmp.record_movie != nullptr && tmp.play_movie != nullptr) {
+		fprintf(stderr, "%s: --record-movie and --play-movie cannot be used together.\n", argv[0]);
+		poptFreeContext(optCon);
+		return -EINVAL;
+	}
+	if (tmp.record_movie != nullptr) {
+		d->record_movie = string(tmp.record_movie);
+	}
+	if (tmp.play_movie != nullptr) {
+		d->play_movie = string(tmp.play_movie);
+	}
+
+	// Hash logs.
+	if (tmp.golden_log != nullptr && tmp.hash_log == nullptr) {
+		fprintf(stderr, "%s: --golden-log requires --hash-log.\n", argv[0]);
+		poptFreeContext(optCon);
+		return -EINVAL;
+	}
+	if (tmp.hash_log != nullptr) {
+		d->hash_log = string(tmp.hash_log);
+	}
+	if (tmp.golden_log != nullptr) {
+		d->golden_log = string(tmp.golden_log);
+	}
+
+	// Capture.
+	if (tmp.capture_wav != nullptr) {
+		d->capture_wav = string(tmp.capture_wav);
+	}
+	if (tmp.capture_vgm != nullptr) {
+		d->capture_vgm = string(tmp.capture_vgm);
+	}
+	if (tmp.capture_video != nullptr) {
+		d->capture_video = string(tmp.capture_video);
+	}
+	if (tmp.capture_video_format != nullptr) {
+		if (Capture::VideoFormatFromName(tmp.capture_video_format) == Capture::VIDEO_MAX) {
+			// Invalid video format.
+			fprintf(stderr, "%s: '--capture-video-format=%s': invalid video format\n"
+				"Valid options are raw and y4m.\n"
+				"Try `%s --help` for more information.\n",
+				argv[0], tmp.capture_video_format, argv[0]);
+			poptFreeContext(optCon);
+			return -EINVAL;
+		}
+		d->capture_video_format = string(tmp.capture_video_format);
+	}
+
+	// Profiler trace.
+	if (tmp.profile_trace != nullptr) {
+#ifdef GENS_ENABLE_PROFILER
+		d->profile_trace = string(tmp.profile_trace);
+#else /* !GENS_ENABLE_PROFILER */
+		fprintf(stderr, "%s: --profile-trace requires a build with ENABLE_PROFILER.\n",
+			argv[0]);
+		poptFreeContext(optCon);
+		return -EINVAL;
+#endif /* GENS_ENABLE_PROFILER */
+	}
+
 	// Region code.
 	if (tmp.region != nullptr) {
 		// Region code specified.
@@ -427,6 +673,56 @@ int Options::parse(int argc, const char *argv[])
 		}
 	}
 
+	// OpenGL texture upload method.
+	if (tmp.gl_upload != nullptr) {
+		if (GLTex::UploadMethodFromName(tmp.gl_upload) == GLTex::UPLOAD_MAX) {
+			// Invalid upload method.
+			fprintf(stderr, "%s: '--gl-upload=%s': invalid upload method\n"
+				"Valid options are auto, texsubimage, pbo, and persistent.\n"
+				"Try `%s --help` for more information.\n",
+				argv[0], tmp.gl_upload, argv[0]);
+			poptFreeContext(optCon);
+			return -EINVAL;
+		}
+		d->gl_upload = string(tmp.gl_upload);
+	}
+
+	// Thread options.
+	if (tmp.sched != nullptr) {
+		d->sched_policy = thread_sched_policy_from_name(tmp.sched);
+		if (d->sched_policy < 0) {
+			// Invalid scheduling policy.
+			fprintf(stderr, "%s: '--sched=%s': invalid scheduling policy\n"
+				"Valid options are normal, fifo, and rr.\n"
+				"Try `%s --help` for more information.\n",
+				argv[0], tmp.sched, argv[0]);
+			poptFreeContext(optCon);
+			return -EINVAL;
+		}
+	}
+	const int cpu_count = thread_cpu_count();
+	if (d->emu_cpu < -1 || d->emu_cpu >= cpu_count ||
+	    d->audio_cpu < -1 || d->audio_cpu >= cpu_count)
+	{
+		fprintf(stderr, "%s: invalid CPU for --emu-cpu or --audio-cpu\n"
+			"Valid CPUs are 0 to %d.\n",
+			argv[0], cpu_count - 1);
+		poptFreeContext(optCon);
+		return -EINVAL;
+	}
+	if (d->rt_priority < 1 || d->rt_priority > 98) {
+		fprintf(stderr, "%s: '--rt-priority=%d': priority must be 1 to 98\n",
+			argv[0], d->rt_priority);
+		poptFreeContext(optCon);
+		return -EINVAL;
+	}
+	if (d->nice < -20 || d->nice > 19) {
+		fprintf(stderr, "%s: '--nice=%d': niceness must be -20 to 19\n",
+			argv[0], d->nice);
+		poptFreeContext(optCon);
+		return -EINVAL;
+	}
+
 	// Verify certain options.
 	d->bpp = MdFb::bppToColorDepth(tmp.bpp);
 	if (d->bpp < 0 || d->bpp >= MdFb::BPP_MAX) {
@@ -526,19 +822,47 @@ bool Options::is_tmss_enabled(void) const
 /** Audio options. **/
 ACCESSOR(int, sound_freq)
 ACCESSOR_BOOL(stereo)
+ACCESSOR_BOOL(resampler)
 
 /** Emulation options. **/
 ACCESSOR_BOOL(sprite_limits)
 ACCESSOR_BOOL(auto_fix_checksum)
+ACCESSOR_BOOL(idle_skip)
+ACCESSOR_BOOL(m68k_idle_skip)
+ACCESSOR(int, zomg_version)
 ACCESSOR(SysVersion::RegionCode_t, region);
+ACCESSOR_BOOL(rom_profile)
+ACCESSOR(string, rom_profile_db)
+ACCESSOR(bool, resampler_set)
+ACCESSOR(bool, sprite_limits_set)
+ACCESSOR(bool, idle_skip_set)
 
 /** UI options. **/
 ACCESSOR_BOOL(fps_counter)
 ACCESSOR_BOOL(auto_pause)
 ACCESSOR_BOOL(paused_effect)
 ACCESSOR(MdFb::ColorDepth, bpp)
+ACCESSOR(string, gl_upload)
+
+/** Thread options. **/
+ACCESSOR(int, emu_cpu)
+ACCESSOR(int, audio_cpu)
+ACCESSOR(int, sched_policy)
+ACCESSOR(int, rt_priority)
+ACCESSOR(int, nice)
+ACCESSOR_BOOL(mlock)
+ACCESSOR_BOOL(jitter_report)
 
 /** Special run modes. **/
 ACCESSOR_BOOL(run_crazy_effect)
+ACCESSOR(string, record_movie)
+ACCESSOR(string, play_movie)
+ACCESSOR(string, hash_log)
+ACCESSOR(string, golden_log)
+ACCESSOR(string, capture_wav)
+ACCESSOR(string, capture_vgm)
+ACCESSOR(string, capture_video)
+ACCESSOR(string, capture_video_format)
+ACCESSOR(string, profile_trace)
 
 }
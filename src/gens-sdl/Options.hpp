@@ -110,6 +110,12 @@ class Options
 		 */
 		bool stereo(void) const;
 
+		/**
+		 * Use the resampler?
+		 * @return True to synthesize at the YM2612's native rate and resample.
+		 */
+		bool resampler(void) const;
+
 		/** Emulation options. **/
 
 		/**
@@ -124,12 +130,61 @@ class Options
 		 */
 		bool auto_fix_checksum(void) const;
 
+		/**
+		 * Skip Z80 idle loops?
+		 * @return True to skip; false to interpret them normally.
+		 */
+		bool idle_skip(void) const;
+
+		/**
+		 * Skip M68K idle loops?
+		 * @return True to skip; false to interpret them normally.
+		 */
+		bool m68k_idle_skip(void) const;
+
+		/**
+		 * ZOMG format version for new savestates.
+		 * @return 1 for ZOMG v1; 2 for ZOMG v2.
+		 */
+		int zomg_version(void) const;
+
 		/**
 		 * Region code.
 		 * @return Region code.
 		 */
 		LibGens::SysVersion::RegionCode_t region(void) const;
 
+		/**
+		 * Apply per-ROM profiles from the ROM profile database?
+		 * @return True to apply; false to ignore the database.
+		 */
+		bool rom_profile(void) const;
+
+		/**
+		 * Get the filename of the ROM profile database.
+		 * @return ROM profile database, or empty string for the default.
+		 */
+		std::string rom_profile_db(void) const;
+
+		/**
+		 * Was --resampler or --no-resampler specified?
+		 * Explicit options take precedence over ROM profile hints.
+		 * @return True if specified; false if the default is in use.
+		 */
+		bool resampler_set(void) const;
+
+		/**
+		 * Was --sprite-limits or --no-sprite-limits specified?
+		 * @return True if specified; false if the default is in use.
+		 */
+		bool sprite_limits_set(void) const;
+
+		/**
+		 * Was --idle-skip or --no-idle-skip specified?
+		 * @return True if specified; false if the default is in use.
+		 */
+		bool idle_skip_set(void) const;
+
 		/** UI options. **/
 
 		/**
@@ -156,6 +211,58 @@ class Options
 		 */
 		LibGens::MdFb::ColorDepth bpp(void) const;
 
+		/**
+		 * OpenGL texture upload method.
+		 * @return Upload method name, e.g. "auto" or "pbo".
+		 */
+		std::string gl_upload(void) const;
+
+		/** Thread options. **/
+
+		/**
+		 * CPU for the emulation thread.
+		 * gens-sdl renders on the emulation thread.
+		 * @return CPU number, or -1 for any CPU.
+		 */
+		int emu_cpu(void) const;
+
+		/**
+		 * CPU for the audio thread.
+		 * @return CPU number, or -1 for any CPU.
+		 */
+		int audio_cpu(void) const;
+
+		/**
+		 * Scheduling policy for the emulation and audio threads.
+		 * @return Scheduling policy. (thread_sched_policy_t)
+		 */
+		int sched_policy(void) const;
+
+		/**
+		 * Real-time priority for the emulation thread.
+		 * The audio thread uses rt_priority() + 1.
+		 * @return Real-time priority. (1-98)
+		 */
+		int rt_priority(void) const;
+
+		/**
+		 * Niceness for the emulation and audio threads.
+		 * @return Niceness. (-20 to 19; 0 to leave unchanged)
+		 */
+		int nice(void) const;
+
+		/**
+		 * Lock the emulator's memory?
+		 * @return True to lock; false to not.
+		 */
+		bool mlock(void) const;
+
+		/**
+		 * Report frame-time jitter on exit?
+		 * @return True to report; false to not.
+		 */
+		bool jitter_report(void) const;
+
 		/** Special run modes. **/
 
 		/**
@@ -163,6 +270,64 @@ class Options
 		 * @return True to run the Crazy Effect.
 		 */
 		bool run_crazy_effect(void) const;
+
+		/**
+		 * Get the filename of the movie to record.
+		 * @return Movie filename, or empty string if not recording.
+		 */
+		std::string record_movie(void) const;
+
+		/**
+		 * Get the filename of the movie to play back.
+		 * @return Movie filename, or empty string if not playing back.
+		 */
+		std::string play_movie(void) const;
+
+		/**
+		 * Get the filename of the video/audio hash log to write.
+		 * @return Hash log filename, or empty string if not logging.
+		 */
+		std::string hash_log(void) const;
+
+		/**
+		 * Get the filename of the golden hash log
+		 * to compare the hash log against on exit.
+		 * @return Golden hash log filename, or empty string if not comparing.
+		 */
+		std::string golden_log(void) const;
+
+		/**
+		 * Get the filename of the WAV file to capture audio to.
+		 * @return WAV filename, or empty string if not capturing.
+		 */
+		std::string capture_wav(void) const;
+
+		/**
+		 * Get the filename of the VGM file to capture
+		 * sound chip register writes to.
+		 * @return VGM filename, or empty string if not capturing.
+		 */
+		std::string capture_vgm(void) const;
+
+		/**
+		 * Get the filename of the video file to capture video to.
+		 * If it starts with '|', the video is piped to a command.
+		 * @return Video filename, or empty string if not capturing.
+		 */
+		std::string capture_video(void) const;
+
+		/**
+		 * Get the video capture format.
+		 * @return Video capture format name, e.g. "raw".
+		 */
+		std::string capture_video_format(void) const;
+
+		/**
+		 * Get the filename of the Chrome trace to write
+		 * the profiler's frame records to on exit.
+		 * @return Trace filename, or empty string if not tracing.
+		 */
+		std::string profile_trace(void) const;
 };
 
 }
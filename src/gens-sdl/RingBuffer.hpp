@@ -58,6 +58,20 @@ class RingBuffer
 		 */
 		void clear(void);
 
+		/**
+		 * Get the amount of data in the buffer.
+		 * @return Amount of data in the buffer, in bytes.
+		 */
+		inline unsigned int dataSize(void) const
+			{ return m_s; }
+
+		/**
+		 * Get the size of the buffer.
+		 * @return Size of the buffer, in bytes.
+		 */
+		inline unsigned int bufferSize(void) const
+			{ return m_size; }
+
 	protected:
 		unsigned int m_i;	// Data start index.
 		unsigned int m_s;	// Data size, in bytes.
@@ -65,12 +79,13 @@ class RingBuffer
 		unsigned int m_size;	// Buffer size, in bytes.
 
 		// Data buffer.
-		// Stores up to 32,768 16-bit samples.
-		// (16,384 16-bit samples in stereo.)
-		// TODO: Does it need to be larger?
+		// Stores up to 65,536 16-bit samples.
+		// (32,768 16-bit samples in stereo.)
+		// This is enough for one frame at 192 kHz,
+		// plus the SDL audio buffer.
 		union {
-			uint8_t u8[65536];
-			int16_t i16[32768];
+			uint8_t u8[131072];
+			int16_t i16[65536];
 		} m_data;
 };
 
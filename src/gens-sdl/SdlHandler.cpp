@@ -28,9 +28,12 @@ using LibGens::SoundMgr;
 
 // C includes. (C++ namespace)
 #include <cstdio>
+#include <cstring>
 
 // aligned_malloc()
 #include "libcompat/aligned_malloc.h"
+// Atomic operations.
+#include "libcompat/atomic.h"
 
 #include <SDL.h>
 
@@ -50,7 +53,10 @@ SdlHandler::SdlHandler()
 	, m_segBuffer(nullptr)
 	, m_segBufferLen(0)
 	, m_segBufferSamples(0)
-{ }
+	, m_audioSchedPending(0)
+{
+	thread_sched_params_init(&m_audioSched);
+}
 
 SdlHandler::~SdlHandler()
 {
@@ -62,9 +68,10 @@ SdlHandler::~SdlHandler()
 /**
  * Initialize SDL video.
  * TODO: Parameter for GL rendering.
+ * @param gl_upload OpenGL texture upload method, e.g. "auto" or "pbo".
  * @return 0 on success; non-zero on error.
  */
-int SdlHandler::init_video(void)
+int SdlHandler::init_video(const char *gl_upload)
 {
 	if (m_vBackend) {
 		// Video is already initialized.
@@ -82,7 +89,11 @@ int SdlHandler::init_video(void)
 
 	// Initialize the video backend.
 	// TODO: Fullscreen; GL vs. SW selection; VSync.
-	m_vBackend = new SdlGLBackend();
+	SdlGLBackend *glBackend = new SdlGLBackend();
+	if (gl_upload) {
+		glBackend->setUploadMethod(gl_upload);
+	}
+	m_vBackend = glBackend;
 	return 0;
 }
 
@@ -123,12 +134,12 @@ void SdlHandler::set_video_source(MdFb *fb)
 
 /**
  * Update SDL video.
+ * @param fb_dirty If false, MdFb hasn't changed since the last update.
  */
-void SdlHandler::update_video(void)
+void SdlHandler::update_video(bool fb_dirty)
 {
 	if (m_vBackend) {
-		// TODO: Don't set fb_dirty == true when paused.
-		m_vBackend->update(true);
+		m_vBackend->update(fb_dirty);
 	}
 
 	// Update the screen.
@@ -186,9 +197,10 @@ VBackend *SdlHandler::vBackend(void) const
  * Initialize SDL audio.
  * @param freq Frequency.
  * @param stereo If true, use stereo.
+ * @param resampler If true, use SoundMgr's resampler.
  * @return 0 on success; non-zero on error.
  */
-int SdlHandler::init_audio(int freq, bool stereo)
+int SdlHandler::init_audio(int freq, bool stereo, bool resampler)
 {
 	SDL_AudioSpec wanted_spec, actual_spec;
 
@@ -222,6 +234,8 @@ int SdlHandler::init_audio(int freq, bool stereo)
 
 	// Initialize SoundMgr.
 	// TODO: NTSC/PAL setting.
+	SoundMgr::SetRateAdjust(1.0);
+	SoundMgr::SetResampler(resampler, true);
 	SoundMgr::ReInit(actual_spec.freq, false, true);
 
 	// TODO: Verify the actual spec has the correct
@@ -235,13 +249,15 @@ int SdlHandler::init_audio(int freq, bool stereo)
 	m_stereo = stereo;
 	m_sampleSize = (stereo ? 4 : 2);
 
-	// Buffer should be: (SegLength * m_sampleSize) + actual samples.
-	int samples = (SoundMgr::GetSegLength() * m_sampleSize) + actual_spec.samples;
+	// Buffer should be: (OutputLength * m_sampleSize) + actual samples.
+	int samples = (SoundMgr::GetOutputLength() * m_sampleSize) + actual_spec.samples;
 	m_audioBuffer = new RingBuffer(samples);
 
 	// Segment buffer.
 	// Needed to convert "int32_t" to int16_t.
-	m_segBufferSamples = SoundMgr::GetSegLength();
+	// NOTE: If the resampler is enabled, the number of
+	// samples written per frame varies slightly.
+	m_segBufferSamples = SoundMgr::GetOutputLength();
 	m_segBufferLen = m_segBufferSamples * m_sampleSize;
 	m_segBuffer = (int16_t*)aligned_malloc(16, m_segBufferLen);
 	memset(m_segBuffer, 0, m_segBufferLen);
@@ -310,6 +326,17 @@ void SdlHandler::sdl_audio_callback(void *userdata, uint8_t *stream, int len)
 {
 	SdlHandler *handler = (SdlHandler*)userdata;
 
+	// Apply the audio thread scheduling parameters, if requested.
+	if (ATOMIC_LOAD_ACQUIRE(&handler->m_audioSchedPending) &&
+	    ATOMIC_CMPXCHG(&handler->m_audioSchedPending, 1, 0))
+	{
+		int ret = thread_sched_apply(&handler->m_audioSched);
+		if (ret != 0) {
+			fprintf(stderr, "Warning: Could not set audio thread scheduling: %s\n",
+				strerror(-ret));
+		}
+	}
+
 	// Read data from the RingBuffer.
 	unsigned int wrote = handler->m_audioBuffer->read(stream, len);
 	//printf("callback: request %d, read %u\n", len, wrote);
@@ -322,6 +349,20 @@ void SdlHandler::sdl_audio_callback(void *userdata, uint8_t *stream, int len)
 	memset(&stream[wrote], 0, ((unsigned int)len - wrote));
 }
 
+/**
+ * Set scheduling parameters for the SDL audio thread.
+ * SDL creates the audio thread internally, so the
+ * parameters are applied by the next audio callback.
+ * @param params Thread scheduling parameters.
+ */
+void SdlHandler::set_audio_thread_sched(const thread_sched_params_t *params)
+{
+	// NOTE: This should be called before audio starts,
+	// since m_audioSched isn't protected by a lock.
+	m_audioSched = *params;
+	ATOMIC_STORE_RELEASE(&m_audioSchedPending, 1);
+}
+
 /**
  * Update SDL audio using SoundMgr.
  */
@@ -344,7 +385,18 @@ void SdlHandler::update_audio(void)
 		const int bytes = samples * m_sampleSize;
 		SDL_LockAudioDevice(m_audioDevice);
 		m_audioBuffer->write(reinterpret_cast<const uint8_t*>(m_segBuffer), bytes);
+		const unsigned int fill = m_audioBuffer->dataSize();
 		SDL_UnlockAudioDevice(m_audioDevice);
+
+		if (SoundMgr::IsResamplerEnabled()) {
+			// Dynamic rate control: Adjust the resampling ratio
+			// to keep the ringbuffer half-full. This compensates
+			// for drift between the emulation and audio clocks
+			// without audible pitch changes. (max 0.5%)
+			const double target = m_audioBuffer->bufferSize() / 2.0;
+			const double delta = ((double)fill - target) / target;
+			SoundMgr::SetRateAdjust(1.0 - (delta * 0.005));
+		}
 	}
 }
 
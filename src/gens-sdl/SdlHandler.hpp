@@ -34,6 +34,9 @@
 #include "libgens/Util/MdFb.hpp"
 #include "libgenskeys/GensKey_t.h"
 
+// Thread scheduling.
+#include "libcompat/thread_sched.h"
+
 // TODO: Minimum gcc version, other compilers?
 // TODO: Move to libgens/macros/common.h?
 #ifdef __GNUC__
@@ -63,9 +66,10 @@ class SdlHandler {
 		/**
 		 * Initialize SDL video.
 		 * TODO: Parameter for GL rendering.
+		 * @param gl_upload OpenGL texture upload method, e.g. "auto" or "pbo".
 		 * @return 0 on success; non-zero on error.
 		 */
-		int init_video(void);
+		int init_video(const char *gl_upload);
 
 		/**
 		 * Shut down SDL video.
@@ -88,8 +92,9 @@ class SdlHandler {
 
 		/**
 		 * Update video.
+		 * @param fb_dirty If false, MdFb hasn't changed since the last update.
 		 */
-		void update_video(void);
+		void update_video(bool fb_dirty = true);
 
 		/**
 		 * Update video while emulation is paused.
@@ -122,9 +127,10 @@ class SdlHandler {
 		 * Initialize SDL audio.
 		 * @param freq Frequency.
 		 * @param stereo If true, use stereo.
+		 * @param resampler If true, use SoundMgr's resampler.
 		 * @return 0 on success; non-zero on error.
 		 */
-		int init_audio(int freq, bool stereo);
+		int init_audio(int freq, bool stereo, bool resampler = false);
 
 		/**
 		 * Shut down SDL audio.
@@ -143,6 +149,14 @@ class SdlHandler {
 		 */
 		void update_audio(void);
 
+		/**
+		 * Set scheduling parameters for the SDL audio thread.
+		 * SDL creates the audio thread internally, so the
+		 * parameters are applied by the next audio callback.
+		 * @param params Thread scheduling parameters.
+		 */
+		void set_audio_thread_sched(const thread_sched_params_t *params);
+
 		/**
 		 * Convert an SDL2 scancode to a Gens keycode.
 		 * @param scancode SDL2 scancode.
@@ -178,6 +192,12 @@ class SdlHandler {
 		unsigned int m_segBufferLen;
 		// Number of samples in m_segBuffer.
 		unsigned int m_segBufferSamples;
+
+		// Audio thread scheduling parameters.
+		// m_audioSchedPending is set if the audio callback
+		// should apply them. (Accessed atomically.)
+		thread_sched_params_t m_audioSched;
+		int m_audioSchedPending;
 };
 
 }
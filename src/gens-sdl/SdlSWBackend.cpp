@@ -24,6 +24,10 @@
 #include "libgens/Util/MdFb.hpp"
 using LibGens::MdFb;
 
+// Software scaler.
+#include "libgens/Effects/Scaler.hpp"
+using LibGens::Scaler;
+
 // C includes. (C++ namespace)
 #include <cassert>
 
@@ -62,11 +66,17 @@ class SdlSWBackendPrivate
 		// Last color depth.
 		MdFb::ColorDepth lastBpp;
 
+		// Software scaler.
+		Scaler scaler;
+		// Last scale factor.
+		int lastScaleFactor;
+
 	public:
 		/**
 		 * (Re-)Initialize the texture.
 		 * If m_fb is set, uses m_fb's color depth.
 		 * Otherwise, BPP_32 is used.
+		 * The texture size depends on the scaler mode.
 		 */
 		void reinitTexture(void);
 };
@@ -79,6 +89,7 @@ SdlSWBackendPrivate::SdlSWBackendPrivate(SdlSWBackend *q)
 	, renderer(nullptr)
 	, texture(nullptr)
 	, lastBpp(MdFb::BPP_MAX)
+	, lastScaleFactor(1)
 {
 	// lastBpp is initialized to MdFb::BPP_MAX in order to
 	// ensure that the texture is initialized. If it's set
@@ -97,6 +108,7 @@ SdlSWBackendPrivate::~SdlSWBackendPrivate()
  * (Re-)Initialize the texture.
  * If m_fb is set, uses m_fb's color depth.
  * Otherwise, BPP_32 is used.
+ * The texture size depends on the scaler mode.
  */
 void SdlSWBackendPrivate::reinitTexture(void)
 {
@@ -106,8 +118,9 @@ void SdlSWBackendPrivate::reinitTexture(void)
 	}
 
 	const MdFb::ColorDepth bpp = q->m_fb->bpp();
-	if (lastBpp == bpp) {
-		// Color depth hasn't changed.
+	const int factor = Scaler::ScaleFactor(q->m_scalerMode);
+	if (lastBpp == bpp && lastScaleFactor == factor) {
+		// Color depth and scale factor haven't changed.
 		return;
 	}
 
@@ -134,9 +147,10 @@ void SdlSWBackendPrivate::reinitTexture(void)
 	// Create the texture.
 	texture = SDL_CreateTexture(renderer, format,
 			SDL_TEXTUREACCESS_STREAMING,
-			320, 240);
-	// Save the last color depth.
+			320 * factor, 240 * factor);
+	// Save the last color depth and scale factor.
 	lastBpp = bpp;
+	lastScaleFactor = factor;
 }
 
 /** SdlSWBackend **/
@@ -229,13 +243,24 @@ void SdlSWBackend::update(bool fb_dirty)
 	if (m_fb) {
 		// Source surface is available.
 		const MdFb::ColorDepth bpp = m_fb->bpp();
-		if (bpp != d->lastBpp) {
-			// Color depth has changed.
+		if (bpp != d->lastBpp ||
+		    Scaler::ScaleFactor(m_scalerMode) != d->lastScaleFactor)
+		{
+			// Color depth or scale factor has changed.
 			d->reinitTexture();
 		}
 
 		// Update the texture.
-		if (bpp == MdFb::BPP_32) {
+		if (m_scalerMode != Scaler::SCALER_NONE) {
+			// Scale the framebuffer first.
+			d->scaler.setMode(m_scalerMode);
+			if (d->scaler.scale(m_fb) == 0) {
+				const int bytespp = (bpp == MdFb::BPP_32
+					? sizeof(uint32_t) : sizeof(uint16_t));
+				SDL_UpdateTexture(d->texture, nullptr,
+					d->scaler.fb(), d->scaler.pxPitch() * bytespp);
+			}
+		} else if (bpp == MdFb::BPP_32) {
 			SDL_UpdateTexture(d->texture, nullptr,
 				m_fb->fb32(), m_fb->pxPitch() * sizeof(uint32_t));
 		} else {
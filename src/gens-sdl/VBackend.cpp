@@ -39,6 +39,7 @@ VBackend::VBackend()
 	, m_aspectRatioConstraint(true)
 	, m_pausedEffect(false)
 	, m_fastBlur(false)
+	, m_scalerMode(LibGens::Scaler::SCALER_NONE)
 { }
 
 VBackend::~VBackend()
@@ -90,6 +91,15 @@ void VBackend::setFastBlur(bool fastBlur)
 	setForceFbDirty();
 }
 
+void VBackend::setScalerMode(LibGens::Scaler::Mode scalerMode)
+{
+	if (m_scalerMode == scalerMode)
+		return;
+	m_scalerMode = scalerMode;
+	// Framebuffer must be rescaled and reuploaded.
+	setForceFbDirty();
+}
+
 /** Onscreen Display functions. **/
 
 /**
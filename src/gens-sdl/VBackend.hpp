@@ -42,6 +42,7 @@ struct _Zomg_Img_Data_t;
 
 // LibGens includes.
 #include "libgens/Util/MdFb.hpp"
+#include "libgens/Effects/Scaler.hpp"
 namespace LibGens {
 	class EmuContext;
 }
@@ -131,6 +132,11 @@ class VBackend {
 		bool fastBlur(void) const;
 		void setFastBlur(bool fastBlur);
 
+		// Software scaler.
+		// Applied after all other software effects.
+		LibGens::Scaler::Mode scalerMode(void) const;
+		void setScalerMode(LibGens::Scaler::Mode scalerMode);
+
 	public:
 		/** Onscreen Display functions. **/
 
@@ -212,6 +218,7 @@ class VBackend {
 		bool m_aspectRatioConstraint;
 		bool m_pausedEffect;
 		bool m_fastBlur;
+		LibGens::Scaler::Mode m_scalerMode;
 };
 
 /** Property accessors. **/
@@ -236,6 +243,8 @@ inline bool VBackend::pausedEffect(void) const
 	{ return m_pausedEffect; }
 inline bool VBackend::fastBlur(void) const
 	{ return m_fastBlur; }
+inline LibGens::Scaler::Mode VBackend::scalerMode(void) const
+	{ return m_scalerMode; }
 
 }
 
@@ -0,0 +1,388 @@
+/***************************************************************************
+ * gens-sdl/tests: Gens/GS II basic SDL frontend. (Test Suite)             *
+ * GLTexTest.cpp: GLTex streaming upload tests.                            *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// GLTex
+#include "GLTex.hpp"
+using GensSdl::GLTex;
+
+// EGL is used to create a GL context without a window.
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+// System byte order.
+#include "libcompat/byteorder.h"
+
+// C includes.
+#include <stdint.h>
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstring>
+
+// C++ includes.
+#include <vector>
+
+namespace GensSdl { namespace Tests {
+
+// GL context. Created in test_main().
+static EGLDisplay egl_dpy = EGL_NO_DISPLAY;
+static EGLContext egl_ctx = EGL_NO_CONTEXT;
+
+struct GLTexTest_mode {
+	GLTex::UploadMethod method;
+	GLTex::Format format;
+};
+
+class GLTexTest : public ::testing::TestWithParam<GLTexTest_mode>
+{
+	protected:
+		GLTexTest()
+			: ::testing::TestWithParam<GLTexTest_mode>() { }
+		virtual ~GLTexTest() { }
+
+	protected:
+		// Image size. The pitch is wider than the visible
+		// width, and the texture size isn't a power of two.
+		static const int IMG_W = 320;
+		static const int IMG_H = 240;
+		static const int IMG_PITCH = 336;
+
+		/**
+		 * Bytes per pixel for a texture format.
+		 * @param format Texture format.
+		 * @return Bytes per pixel.
+		 */
+		static int bytesPerPixel(GLTex::Format format);
+
+		/**
+		 * Generate a test image.
+		 * @param buf Image buffer.
+		 * @param format Texture format.
+		 * @param frame Frame number.
+		 */
+		static void genImage(std::vector<uint8_t> &buf, GLTex::Format format, int frame);
+
+		/**
+		 * Read back a texture and compare it to an image.
+		 * @param tex Texture.
+		 * @param buf Image buffer.
+		 * @param format Texture format.
+		 * @return Number of mismatched pixels.
+		 */
+		static int compareTex(const GLTex &tex, const std::vector<uint8_t> &buf, GLTex::Format format);
+};
+
+/**
+ * Bytes per pixel for a texture format.
+ * @param format Texture format.
+ * @return Bytes per pixel.
+ */
+int GLTexTest::bytesPerPixel(GLTex::Format format)
+{
+	return (format == GLTex::FMT_XRGB8888 ? 4 : 2);
+}
+
+/**
+ * Generate a test image.
+ * @param buf Image buffer.
+ * @param format Texture format.
+ * @param frame Frame number.
+ */
+void GLTexTest::genImage(std::vector<uint8_t> &buf, GLTex::Format format, int frame)
+{
+	buf.resize(IMG_PITCH * IMG_H * bytesPerPixel(format));
+	for (size_t i = 0; i < buf.size(); i++) {
+		buf[i] = (uint8_t)((i * 7) + (frame * 13));
+	}
+}
+
+/**
+ * Read back a texture and compare it to an image.
+ * @param tex Texture.
+ * @param buf Image buffer.
+ * @param format Texture format.
+ * @return Number of mismatched pixels.
+ */
+int GLTexTest::compareTex(const GLTex &tex, const std::vector<uint8_t> &buf, GLTex::Format format)
+{
+	GLenum gl_format, gl_type;
+	uint32_t mask;
+	switch (format) {
+		case GLTex::FMT_XRGB1555:
+			gl_format = GL_BGRA;
+			gl_type = GL_UNSIGNED_SHORT_1_5_5_5_REV;
+			mask = 0x7FFF;
+			break;
+		case GLTex::FMT_RGB565:
+			gl_format = GL_RGB;
+			gl_type = GL_UNSIGNED_SHORT_5_6_5;
+			mask = 0xFFFF;
+			break;
+		case GLTex::FMT_XRGB8888:
+		default:
+			gl_format = GL_BGRA;
+#if SYS_BYTEORDER == SYS_BIG_ENDIAN
+			gl_type = GL_UNSIGNED_INT_8_8_8_8_REV;
+#else /* SYS_BYTEORDER == SYS_LIL_ENDIAN */
+			gl_type = GL_UNSIGNED_BYTE;
+#endif
+			mask = 0x00FFFFFF;
+			break;
+	}
+
+	const int bpp = bytesPerPixel(format);
+	std::vector<uint8_t> out(tex.texW * tex.texH * bpp);
+	glBindTexture(GL_TEXTURE_2D, tex.name);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glGetTexImage(GL_TEXTURE_2D, 0, gl_format, gl_type, &out[0]);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);	// GL default.
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	int mismatches = 0;
+	for (int y = 0; y < IMG_H; y++) {
+		const uint8_t *src = &buf[y * IMG_PITCH * bpp];
+		const uint8_t *dest = &out[y * tex.texW * bpp];
+		for (int x = 0; x < IMG_W; x++, src += bpp, dest += bpp) {
+			uint32_t px_src, px_dest;
+			if (bpp == 4) {
+				px_src = *(const uint32_t*)src;
+				px_dest = *(const uint32_t*)dest;
+			} else {
+				px_src = *(const uint16_t*)src;
+				px_dest = *(const uint16_t*)dest;
+			}
+			if ((px_src & mask) != (px_dest & mask)) {
+				mismatches++;
+			}
+		}
+	}
+	return mismatches;
+}
+
+/**
+ * Upload several frames and verify each one by reading back the texture.
+ */
+TEST_P(GLTexTest, upload)
+{
+	const GLTexTest_mode mode = GetParam();
+
+	GLTex tex;
+	tex.setUploadMethod(mode.method);
+	ASSERT_EQ(0, tex.alloc(mode.format, IMG_W, IMG_H));
+
+	const int bpp = bytesPerPixel(mode.format);
+	std::vector<uint8_t> img;
+	for (int frame = 0; frame < 8; frame++) {
+		genImage(img, mode.format, frame);
+		void *buf = tex.beginUpload(IMG_PITCH, IMG_H);
+		if (buf) {
+			memcpy(buf, &img[0], IMG_PITCH * IMG_H * bpp);
+			tex.endUpload(IMG_W, IMG_H, IMG_PITCH);
+		} else {
+			tex.subImage2D(IMG_W, IMG_H, IMG_PITCH, &img[0]);
+		}
+
+		EXPECT_EQ(0, compareTex(tex, img, mode.format)) << "frame == " << frame;
+		EXPECT_EQ((GLenum)GL_NO_ERROR, glGetError()) << "frame == " << frame;
+	}
+
+	// The requested method should have been resolved.
+	EXPECT_NE(GLTex::UPLOAD_AUTO, tex.activeUploadMethod());
+	if (mode.method == GLTex::UPLOAD_TEXSUBIMAGE) {
+		EXPECT_EQ(GLTex::UPLOAD_TEXSUBIMAGE, tex.activeUploadMethod());
+	}
+	printf("Requested '%s', using '%s'.\n",
+		GLTex::UploadMethodName(mode.method),
+		GLTex::UploadMethodName(tex.activeUploadMethod()));
+}
+
+/**
+ * Changing the upload method and image size between
+ * uploads should reallocate the streaming buffers.
+ */
+TEST_P(GLTexTest, reallocate)
+{
+	const GLTexTest_mode mode = GetParam();
+
+	GLTex tex;
+	tex.setUploadMethod(mode.method);
+	ASSERT_EQ(0, tex.alloc(mode.format, IMG_W, IMG_H));
+
+	const int bpp = bytesPerPixel(mode.format);
+	std::vector<uint8_t> img;
+	genImage(img, mode.format, 0);
+
+	// Upload a smaller image first.
+	void *buf = tex.beginUpload(IMG_PITCH, IMG_H / 2);
+	if (buf) {
+		memcpy(buf, &img[0], IMG_PITCH * (IMG_H / 2) * bpp);
+		tex.endUpload(IMG_W, IMG_H / 2, IMG_PITCH);
+	} else {
+		tex.subImage2D(IMG_W, IMG_H / 2, IMG_PITCH, &img[0]);
+	}
+
+	// Switch to texsubimage, then back.
+	tex.setUploadMethod(GLTex::UPLOAD_TEXSUBIMAGE);
+	EXPECT_TRUE(tex.beginUpload(IMG_PITCH, IMG_H) == nullptr);
+	tex.setUploadMethod(mode.method);
+
+	// Full-size upload.
+	genImage(img, mode.format, 1);
+	buf = tex.beginUpload(IMG_PITCH, IMG_H);
+	if (buf) {
+		memcpy(buf, &img[0], IMG_PITCH * IMG_H * bpp);
+		tex.endUpload(IMG_W, IMG_H, IMG_PITCH);
+	} else {
+		tex.subImage2D(IMG_W, IMG_H, IMG_PITCH, &img[0]);
+	}
+
+	EXPECT_EQ(0, compareTex(tex, img, mode.format));
+	EXPECT_EQ((GLenum)GL_NO_ERROR, glGetError());
+}
+
+static const GLTexTest_mode modes[] = {
+	{GLTex::UPLOAD_TEXSUBIMAGE,	GLTex::FMT_XRGB1555},
+	{GLTex::UPLOAD_TEXSUBIMAGE,	GLTex::FMT_RGB565},
+	{GLTex::UPLOAD_TEXSUBIMAGE,	GLTex::FMT_XRGB8888},
+	{GLTex::UPLOAD_PBO,		GLTex::FMT_XRGB1555},
+	{GLTex::UPLOAD_PBO,		GLTex::FMT_RGB565},
+	{GLTex::UPLOAD_PBO,		GLTex::FMT_XRGB8888},
+	{GLTex::UPLOAD_PERSISTENT,	GLTex::FMT_XRGB1555},
+	{GLTex::UPLOAD_PERSISTENT,	GLTex::FMT_RGB565},
+	{GLTex::UPLOAD_PERSISTENT,	GLTex::FMT_XRGB8888},
+	{GLTex::UPLOAD_AUTO,		GLTex::FMT_XRGB8888},
+};
+
+INSTANTIATE_TEST_CASE_P(GLTexUpload, GLTexTest,
+	::testing::ValuesIn(modes));
+
+/**
+ * Create a GL context without a window.
+ * @return 0 on success; non-zero on error.
+ */
+static int initEgl(void)
+{
+	// Prefer Mesa's surfaceless platform, since there's
+	// usually no display server on test machines.
+	const char *const exts = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	if (exts && strstr(exts, "EGL_MESA_platform_surfaceless")) {
+		PFNEGLGETPLATFORMDISPLAYEXTPROC pEglGetPlatformDisplayEXT =
+			(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		if (pEglGetPlatformDisplayEXT) {
+			egl_dpy = pEglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA,
+							    EGL_DEFAULT_DISPLAY, nullptr);
+		}
+	}
+	if (egl_dpy == EGL_NO_DISPLAY) {
+		egl_dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+	if (egl_dpy == EGL_NO_DISPLAY || !eglInitialize(egl_dpy, nullptr, nullptr)) {
+		fprintf(stderr, "Unable to initialize EGL.\n");
+		return -1;
+	}
+
+	// GLTex uses the compatibility profile.
+	if (!eglBindAPI(EGL_OPENGL_API)) {
+		fprintf(stderr, "EGL does not support OpenGL.\n");
+		return -1;
+	}
+
+	// NOTE: EGL_SURFACE_TYPE defaults to EGL_WINDOW_BIT,
+	// which isn't available on the surfaceless platform.
+	static const EGLint cfgAttribs[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLConfig cfg;
+	EGLint numCfg = 0;
+	if (!eglChooseConfig(egl_dpy, cfgAttribs, &cfg, 1, &numCfg) || numCfg < 1) {
+		fprintf(stderr, "No suitable EGL configuration.\n");
+		return -1;
+	}
+
+	egl_ctx = eglCreateContext(egl_dpy, cfg, EGL_NO_CONTEXT, nullptr);
+	if (egl_ctx == EGL_NO_CONTEXT) {
+		fprintf(stderr, "Unable to create an OpenGL context.\n");
+		return -1;
+	}
+
+	// No surface is needed, since nothing is drawn.
+	if (!eglMakeCurrent(egl_dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, egl_ctx)) {
+		fprintf(stderr, "Unable to make the OpenGL context current.\n");
+		return -1;
+	}
+
+	GLenum err = glewInit();
+	if (err != GLEW_OK) {
+		fprintf(stderr, "glewInit() failed: %s\n", glewGetErrorString(err));
+		return -1;
+	}
+
+	fprintf(stderr, "GL_RENDERER: %s\nGL_VERSION:  %s\n\n",
+		(const char*)glGetString(GL_RENDERER),
+		(const char*)glGetString(GL_VERSION));
+	return 0;
+}
+
+/**
+ * Destroy the GL context.
+ */
+static void endEgl(void)
+{
+	if (egl_dpy != EGL_NO_DISPLAY) {
+		eglMakeCurrent(egl_dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (egl_ctx != EGL_NO_CONTEXT) {
+			eglDestroyContext(egl_dpy, egl_ctx);
+			egl_ctx = EGL_NO_CONTEXT;
+		}
+		eglTerminate(egl_dpy);
+		egl_dpy = EGL_NO_DISPLAY;
+	}
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "gens-sdl test suite: GLTex streaming uploads.\n\n");
+	::testing::InitGoogleTest(&argc, argv);
+
+	if (GensSdl::Tests::initEgl() != 0) {
+		// No GL implementation is available.
+		// This isn't a failure in GLTex.
+		fprintf(stderr, "*** Skipping the GLTex tests.\n");
+		GensSdl::Tests::endEgl();
+		return 0;
+	}
+
+	int ret = RUN_ALL_TESTS();
+	GensSdl::Tests::endEgl();
+	return ret;
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
@@ -0,0 +1,98 @@
+/***************************************************************************
+ * libcompat: Compatibility library.                                       *
+ * atomic.h: Atomic operations compatibility header.                       *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth                                       *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// References:
+// - https://gcc.gnu.org/onlinedocs/gcc/_005f_005fatomic-Builtins.html
+// - https://gcc.gnu.org/onlinedocs/gcc/_005f_005fsync-Builtins.html
+// - https://msdn.microsoft.com/en-us/library/ttk2z1ws.aspx
+
+#ifndef __LIBCOMPAT_ATOMIC_H__
+#define __LIBCOMPAT_ATOMIC_H__
+
+/**
+ * This header defines a minimal set of atomic operations
+ * for use by lock-free queues and ring buffers.
+ *
+ * NOTE: Only naturally-aligned 32-bit integers are supported.
+ * MSVC's Interlocked*() functions operate on LONG, so using
+ * other sizes will result in incorrect behavior.
+ *
+ * - ATOMIC_LOAD_ACQUIRE(ptr): Load with acquire semantics.
+ * - ATOMIC_STORE_RELEASE(ptr, val): Store with release semantics.
+ * - ATOMIC_ADD_FETCH(ptr, val): Add a value; returns the new value.
+ * - ATOMIC_EXCHANGE(ptr, val): Store a value; returns the old value.
+ * - ATOMIC_CMPXCHG(ptr, oldval, newval): Compare and swap.
+ *   Returns non-zero if the value was swapped.
+ */
+
+#if defined(__GNUC__) && \
+    ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+
+// gcc-4.7 and later: __atomic builtins.
+#define ATOMIC_LOAD_ACQUIRE(ptr) \
+	__atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE_RELEASE(ptr, val) \
+	__atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define ATOMIC_ADD_FETCH(ptr, val) \
+	__atomic_add_fetch((ptr), (val), __ATOMIC_SEQ_CST)
+#define ATOMIC_EXCHANGE(ptr, val) \
+	__atomic_exchange_n((ptr), (val), __ATOMIC_ACQ_REL)
+#define ATOMIC_CMPXCHG(ptr, oldval, newval) \
+	__sync_bool_compare_and_swap((ptr), (oldval), (newval))
+
+#elif defined(__GNUC__)
+
+// Older gcc: __sync builtins.
+// These are full barriers, which is stronger than needed.
+#define ATOMIC_LOAD_ACQUIRE(ptr) \
+	__sync_add_and_fetch((ptr), 0)
+#define ATOMIC_STORE_RELEASE(ptr, val) \
+	do { __sync_synchronize(); *(ptr) = (val); } while (0)
+#define ATOMIC_ADD_FETCH(ptr, val) \
+	__sync_add_and_fetch((ptr), (val))
+// __sync_lock_test_and_set() is only an acquire barrier.
+#define ATOMIC_EXCHANGE(ptr, val) \
+	(__sync_synchronize(), __sync_lock_test_and_set((ptr), (val)))
+#define ATOMIC_CMPXCHG(ptr, oldval, newval) \
+	__sync_bool_compare_and_swap((ptr), (oldval), (newval))
+
+#elif defined(_MSC_VER)
+
+// MSVC: Interlocked functions.
+// On x86 and x64, volatile loads and stores have
+// acquire/release semantics by default. (/volatile:ms)
+#include <intrin.h>
+#define ATOMIC_LOAD_ACQUIRE(ptr) \
+	(*(volatile long*)(ptr))
+#define ATOMIC_STORE_RELEASE(ptr, val) \
+	do { _ReadWriteBarrier(); *(volatile long*)(ptr) = (long)(val); } while (0)
+#define ATOMIC_ADD_FETCH(ptr, val) \
+	(_InterlockedExchangeAdd((volatile long*)(ptr), (long)(val)) + (long)(val))
+#define ATOMIC_EXCHANGE(ptr, val) \
+	_InterlockedExchange((volatile long*)(ptr), (long)(val))
+#define ATOMIC_CMPXCHG(ptr, oldval, newval) \
+	(_InterlockedCompareExchange((volatile long*)(ptr), (long)(newval), (long)(oldval)) == (long)(oldval))
+
+#else
+#error Missing atomic operations for this compiler.
+#endif
+
+#endif /* __LIBCOMPAT_ATOMIC_H__ */
@@ -255,10 +255,22 @@ uint32_t LibCompat_GetCPUFlags(void)
 #endif /* defined(__i386__) || defined(_M_IX86) */
 
 	// Check for XSAVE.
-	if (__ecx & CPUFLAG_IA32_ECX_XSAVE) {
+	if ((__ecx & CPUFLAG_IA32_ECX_XSAVE) && can_FXSAVE) {
 		// CPU supports XSAVE. Does the OS?
-		/* FIXME: Detect XSAVE. */
-		can_XSAVE = 0;
+#ifdef XGETBV
+		if (__ecx & CPUFLAG_IA32_ECX_OSXSAVE) {
+			// OS has enabled XSAVE. Make sure it saves
+			// both the SSE and AVX register state.
+			unsigned int xcr0_lo, xcr0_hi;
+			XGETBV(0, xcr0_lo, xcr0_hi);
+			((void)xcr0_hi);
+			if ((xcr0_lo & (IA32_XCR0_SSE | IA32_XCR0_AVX)) ==
+			    (IA32_XCR0_SSE | IA32_XCR0_AVX))
+			{
+				can_XSAVE = 1;
+			}
+		}
+#endif /* XGETBV */
 	}
 
 	// Check for AVX.
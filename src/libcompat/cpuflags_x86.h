@@ -55,6 +55,10 @@
 #define CPUFLAG_IA32_ECX_AVX		((uint32_t)(1U << 28))
 #define CPUFLAG_IA32_ECX_FMA3		((uint32_t)(1U << 12))
 
+// XCR0: XSAVE-enabled state components. (read with XGETBV)
+#define IA32_XCR0_SSE		(1U << 1)
+#define IA32_XCR0_AVX		(1U << 2)
+
 // CPUID function 7: Extended Features
 
 // Flags stored in the %ebx register.
@@ -89,6 +93,9 @@
 #include <intrin.h>
 #endif
 
+// NOTE: %ecx is cleared before executing CPUID, since some
+// functions (e.g. 7: Extended Features) have subleaves.
+// (MSVC's __cpuid() clears %ecx.)
 #if defined(__GNUC__)
 // CPUID macro with PIC support.
 // See http://gcc.gnu.org/ml/gcc-patches/2007-09/msg00324.html
@@ -99,7 +106,7 @@
 		"cpuid\n"					\
 		"xchgl	%%ebx, %1\n"				\
 		: "=a" (a), "=r" (b), "=c" (c), "=d" (d)	\
-		: "0" (level)					\
+		: "0" (level), "2" (0)				\
 		);						\
 	} while (0)
 #else
@@ -107,10 +114,20 @@
 	__asm__ (						\
 		"cpuid\n"					\
 		: "=a" (a), "=b" (b), "=c" (c), "=d" (d)	\
-		: "0" (level)					\
+		: "0" (level), "2" (0)				\
 		);						\
 	} while (0)
 #endif
+
+// XGETBV macro.
+// NOTE: Encoded as bytes for assemblers that don't know 'xgetbv'.
+#define XGETBV(xcr, lo, hi) do {				\
+	__asm__ (						\
+		".byte 0x0F, 0x01, 0xD0\n"			\
+		: "=a" (lo), "=d" (hi)				\
+		: "c" (xcr)					\
+		);						\
+	} while (0)
 #elif defined(_MSC_VER) && MSC_VER >= 1400
 // CPUID macro for MSVC 2005+
 #define CPUID(level, a, b, c, d) do {				\
@@ -121,6 +138,15 @@
 	(c) = cpuInfo[2];					\
 	(d) = cpuInfo[3];					\
 } while (0)
+#if _MSC_FULL_VER >= 160040219
+// XGETBV macro for MSVC 2010 SP1+.
+#include <immintrin.h>
+#define XGETBV(xcr, lo, hi) do {				\
+	unsigned __int64 xcrVal = _xgetbv(xcr);			\
+	(lo) = (unsigned int)xcrVal;				\
+	(hi) = (unsigned int)(xcrVal >> 32);			\
+} while (0)
+#endif
 #elif defined(_MSC_VER) && MSC_VER < 1400 && defined(_M_IX86)
 // CPUID macro for old MSVC that doesn't support intrinsics.
 // (TODO: Check MSVC 2002 and 2003?)
@@ -0,0 +1,304 @@
+/***************************************************************************
+ * libcompat: Compatibility library.                                       *
+ * thread_sched.c: Thread placement and scheduling.                        *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1	/* pthread_setaffinity_np(), CPU_SET() */
+#endif
+
+#include "thread_sched.h"
+#include <libcompat/config.libcompat.h>
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else /* !_WIN32 */
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#ifdef HAVE_SETPRIORITY
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+#ifdef HAVE_MLOCKALL
+#include <sys/mman.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif /* _WIN32 */
+
+/**
+ * Initialize thread scheduling parameters to the defaults.
+ * The defaults don't change anything.
+ * @param params Thread scheduling parameters.
+ */
+void thread_sched_params_init(thread_sched_params_t *params)
+{
+	params->cpu = -1;
+	params->policy = THREAD_SCHED_NORMAL;
+	params->priority = 0;
+	params->nice = 0;
+}
+
+/**
+ * Get the number of online CPUs.
+ * @return Number of online CPUs, or 1 if it can't be determined.
+ */
+int thread_cpu_count(void)
+{
+#if defined(_WIN32)
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return (si.dwNumberOfProcessors > 0 ? (int)si.dwNumberOfProcessors : 1);
+#elif defined(_SC_NPROCESSORS_ONLN)
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return (n > 0 ? (int)n : 1);
+#else
+	return 1;
+#endif
+}
+
+/**
+ * Pin the calling thread to a CPU.
+ * @param cpu CPU number, starting at 0.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int thread_set_affinity(int cpu)
+{
+	if (cpu < 0 || cpu >= thread_cpu_count())
+		return -EINVAL;
+
+#if defined(_WIN32)
+	if (cpu >= (int)(sizeof(DWORD_PTR) * 8))
+		return -EINVAL;
+	if (!SetThreadAffinityMask(GetCurrentThread(), ((DWORD_PTR)1 << cpu)))
+		return -EPERM;
+	return 0;
+#elif defined(HAVE_PTHREAD_SETAFFINITY_NP) && defined(CPU_SET)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	// NOTE: pthread functions return the error code
+	// instead of setting errno.
+	return -pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+	// Mac OS X only has affinity "tags", which aren't
+	// the same thing, and other systems vary.
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * Set the calling thread's scheduling policy.
+ * @param policy Scheduling policy.
+ * @param priority Real-time priority. (1-99; ignored for THREAD_SCHED_NORMAL)
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int thread_set_sched(thread_sched_policy_t policy, int priority)
+{
+	if ((int)policy < 0 || policy >= THREAD_SCHED_MAX)
+		return -EINVAL;
+
+#if defined(_WIN32)
+	// Windows doesn't have real-time policies for threads.
+	// The closest equivalent is the time-critical priority.
+	((void)priority);
+	if (!SetThreadPriority(GetCurrentThread(),
+		(policy == THREAD_SCHED_NORMAL
+			? THREAD_PRIORITY_NORMAL
+			: THREAD_PRIORITY_TIME_CRITICAL)))
+	{
+		return -EPERM;
+	}
+	return 0;
+#elif defined(HAVE_PTHREAD_SETSCHEDPARAM)
+	struct sched_param param;
+	int posix_policy;
+	memset(&param, 0, sizeof(param));
+	switch (policy) {
+		case THREAD_SCHED_FIFO:
+			posix_policy = SCHED_FIFO;
+			break;
+		case THREAD_SCHED_RR:
+			posix_policy = SCHED_RR;
+			break;
+		default:
+			posix_policy = SCHED_OTHER;
+			priority = 0;
+			break;
+	}
+
+	if (posix_policy != SCHED_OTHER) {
+		const int prio_min = sched_get_priority_min(posix_policy);
+		const int prio_max = sched_get_priority_max(posix_policy);
+		if (priority < prio_min || priority > prio_max)
+			return -EINVAL;
+	}
+	param.sched_priority = priority;
+	return -pthread_setschedparam(pthread_self(), posix_policy, &param);
+#else
+	((void)priority);
+	return (policy == THREAD_SCHED_NORMAL ? 0 : -ENOSYS);
+#endif
+}
+
+/**
+ * Set the calling thread's niceness.
+ * NOTE: On Unix systems other than Linux, this
+ * affects the entire process.
+ * @param nice Niceness. (-20 to 19)
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int thread_set_nice(int nice)
+{
+	if (nice < -20 || nice > 19)
+		return -EINVAL;
+
+#if defined(_WIN32)
+	// Map niceness to the closest thread priority.
+	int prio;
+	if (nice <= -15)
+		prio = THREAD_PRIORITY_HIGHEST;
+	else if (nice < 0)
+		prio = THREAD_PRIORITY_ABOVE_NORMAL;
+	else if (nice == 0)
+		prio = THREAD_PRIORITY_NORMAL;
+	else if (nice < 15)
+		prio = THREAD_PRIORITY_BELOW_NORMAL;
+	else
+		prio = THREAD_PRIORITY_LOWEST;
+	if (!SetThreadPriority(GetCurrentThread(), prio))
+		return -EPERM;
+	return 0;
+#elif defined(HAVE_SETPRIORITY)
+	// Linux: setpriority() with a thread ID only
+	// affects that thread. Elsewhere, it affects
+	// the entire process.
+# if defined(__linux__) && defined(SYS_gettid)
+	const id_t who = (id_t)syscall(SYS_gettid);
+# else
+	const id_t who = 0;
+# endif
+	if (setpriority(PRIO_PROCESS, who, nice) != 0)
+		return -errno;
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * Apply thread scheduling parameters to the calling thread.
+ * All settings are attempted, even if one of them fails.
+ * @param params Thread scheduling parameters.
+ * @return 0 on success; first negative POSIX error code on error.
+ */
+int thread_sched_apply(const thread_sched_params_t *params)
+{
+	int ret = 0, err;
+
+	if (params->cpu >= 0) {
+		err = thread_set_affinity(params->cpu);
+		if (err != 0 && ret == 0)
+			ret = err;
+	}
+	if (params->policy != THREAD_SCHED_NORMAL) {
+		err = thread_set_sched((thread_sched_policy_t)params->policy, params->priority);
+		if (err != 0 && ret == 0)
+			ret = err;
+	}
+	if (params->nice != 0) {
+		// NOTE: Niceness has no effect on real-time threads,
+		// but it will apply if the policy change failed.
+		err = thread_set_nice(params->nice);
+		if (err != 0 && ret == 0)
+			ret = err;
+	}
+
+	return ret;
+}
+
+/**
+ * Lock all of the process's currently-mapped pages in memory,
+ * so the emulation state can't be paged out.
+ * Memory allocated afterwards is not locked.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int mem_lock_all(void)
+{
+#ifdef HAVE_MLOCKALL
+	// NOTE: MCL_FUTURE isn't used, since it makes later
+	// allocations fail once RLIMIT_MEMLOCK is reached.
+	if (mlockall(MCL_CURRENT) != 0)
+		return -errno;
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * Unlock all of the process's locked pages.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int mem_unlock_all(void)
+{
+#ifdef HAVE_MLOCKALL
+	if (munlockall() != 0)
+		return -errno;
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+static const char *const thread_sched_policy_names[THREAD_SCHED_MAX] = {
+	"normal", "fifo", "rr"
+};
+
+/**
+ * Get the name of a scheduling policy.
+ * @param policy Scheduling policy.
+ * @return Policy name, e.g. "fifo", or NULL if invalid.
+ */
+const char *thread_sched_policy_name(thread_sched_policy_t policy)
+{
+	if ((int)policy < 0 || policy >= THREAD_SCHED_MAX)
+		return NULL;
+	return thread_sched_policy_names[policy];
+}
+
+/**
+ * Look up a scheduling policy by name.
+ * @param name Policy name: "normal", "fifo", or "rr".
+ * @return Scheduling policy, or -1 if the name is invalid.
+ */
+int thread_sched_policy_from_name(const char *name)
+{
+	int i;
+	for (i = 0; i < THREAD_SCHED_MAX; i++) {
+		if (!strcmp(name, thread_sched_policy_names[i]))
+			return i;
+	}
+	return -1;
+}
@@ -0,0 +1,141 @@
+/***************************************************************************
+ * libcompat: Compatibility library.                                       *
+ * thread_sched.h: Thread placement and scheduling.                        *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBCOMPAT_THREAD_SCHED_H__
+#define __LIBCOMPAT_THREAD_SCHED_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Thread placement and scheduling.
+ *
+ * These functions apply to the *calling* thread, so each thread
+ * (emulation, audio, rendering) must apply its own settings.
+ * This works for threads we don't create, e.g. audio callback
+ * threads: apply the settings in the first callback.
+ *
+ * All functions return 0 on success or a negative POSIX error code
+ * on error. -ENOSYS means the platform doesn't support the setting.
+ * -EPERM usually means the user isn't allowed to use real-time
+ * scheduling or lock memory. (Linux: RLIMIT_RTPRIO, RLIMIT_MEMLOCK)
+ */
+
+/**
+ * Scheduling policy.
+ */
+typedef enum {
+	THREAD_SCHED_NORMAL	= 0,	/* Default time-sharing scheduler. */
+	THREAD_SCHED_FIFO	= 1,	/* Real-time, first in first out. */
+	THREAD_SCHED_RR		= 2,	/* Real-time, round robin. */
+
+	THREAD_SCHED_MAX
+} thread_sched_policy_t;
+
+/**
+ * Thread scheduling parameters.
+ */
+typedef struct _thread_sched_params_t {
+	int cpu;		/* CPU to pin the thread to. (-1 for any CPU) */
+	int policy;		/* thread_sched_policy_t */
+	int priority;		/* Real-time priority. (1-99; ignored for THREAD_SCHED_NORMAL) */
+	int nice;		/* Niceness. (-20 to 19; 0 to leave unchanged) */
+} thread_sched_params_t;
+
+/**
+ * Initialize thread scheduling parameters to the defaults.
+ * The defaults don't change anything.
+ * @param params Thread scheduling parameters.
+ */
+void thread_sched_params_init(thread_sched_params_t *params);
+
+/**
+ * Get the number of online CPUs.
+ * @return Number of online CPUs, or 1 if it can't be determined.
+ */
+int thread_cpu_count(void);
+
+/**
+ * Pin the calling thread to a CPU.
+ * @param cpu CPU number, starting at 0.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int thread_set_affinity(int cpu);
+
+/**
+ * Set the calling thread's scheduling policy.
+ * @param policy Scheduling policy.
+ * @param priority Real-time priority. (1-99; ignored for THREAD_SCHED_NORMAL)
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int thread_set_sched(thread_sched_policy_t policy, int priority);
+
+/**
+ * Set the calling thread's niceness.
+ * NOTE: On Unix systems other than Linux, this
+ * affects the entire process.
+ * @param nice Niceness. (-20 to 19)
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int thread_set_nice(int nice);
+
+/**
+ * Apply thread scheduling parameters to the calling thread.
+ * All settings are attempted, even if one of them fails.
+ * @param params Thread scheduling parameters.
+ * @return 0 on success; first negative POSIX error code on error.
+ */
+int thread_sched_apply(const thread_sched_params_t *params);
+
+/**
+ * Lock all of the process's currently-mapped pages in memory,
+ * so the emulation state can't be paged out.
+ * Memory allocated afterwards is not locked.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int mem_lock_all(void);
+
+/**
+ * Unlock all of the process's locked pages.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int mem_unlock_all(void);
+
+/**
+ * Get the name of a scheduling policy.
+ * @param policy Scheduling policy.
+ * @return Policy name, e.g. "fifo", or NULL if invalid.
+ */
+const char *thread_sched_policy_name(thread_sched_policy_t policy);
+
+/**
+ * Look up a scheduling policy by name.
+ * @param name Policy name: "normal", "fifo", or "rr".
+ * @return Scheduling policy, or -1 if the name is invalid.
+ */
+int thread_sched_policy_from_name(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LIBCOMPAT_THREAD_SCHED_H__ */
@@ -31,6 +31,7 @@
 #include "libcompat/byteswap.h"
 #include "macros/common.h"
 #include "Rom.hpp"
+#include "RomProfileDB.hpp"
 #include "cpu/M68K.hpp"
 #include "lg_osd.h"
 
@@ -42,6 +43,7 @@
 #include "libcompat/aligned_malloc.h"
 
 // C includes. (C++ namespace)
+#include <cassert>
 #include <cstdlib>
 
 // C++ includes.
@@ -143,6 +145,19 @@ class RomCartridgeMDPrivate
 		// EEPROM type.
 		// If less than 0, no EEPROM is in use.
 		int eprType;
+
+		// ROM profile from the ROM profile database.
+		// Fields set in the profile override the
+		// built-in fixups and the EEPROM database.
+		RomProfile profile;
+		bool hasProfile;
+
+		/**
+		 * Convert a ROM profile mapper type to MD_MapperType_t.
+		 * @param mapper ROM profile mapper type.
+		 * @return MD_MapperType_t.
+		 */
+		static RomCartridgeMD::MD_MapperType_t ProfileMapperType(RomProfile::Mapper mapper);
 };
 
 /**
@@ -329,7 +344,28 @@ RomCartridgeMDPrivate::RomCartridgeMDPrivate(RomCartridgeMD *q, Rom *rom)
 	, rom(rom)
 	, romFixup(-1)
 	, eprType(-1)
-{ }
+	, hasProfile(false)
+{
+	memset(&profile, 0, sizeof(profile));
+}
+
+/**
+ * Convert a ROM profile mapper type to MD_MapperType_t.
+ * @param mapper ROM profile mapper type.
+ * @return MD_MapperType_t.
+ */
+RomCartridgeMD::MD_MapperType_t RomCartridgeMDPrivate::ProfileMapperType(RomProfile::Mapper mapper)
+{
+	switch (mapper) {
+		default:
+		case RomProfile::MAPPER_FLAT:
+			return RomCartridgeMD::MAPPER_MD_FLAT;
+		case RomProfile::MAPPER_SSF2:
+			return RomCartridgeMD::MAPPER_MD_SSF2;
+		case RomProfile::MAPPER_REGISTERS_RO:
+			return RomCartridgeMD::MAPPER_MD_REGISTERS_RO;
+	}
+}
 
 RomCartridgeMDPrivate::~RomCartridgeMDPrivate()
 { }
@@ -486,6 +522,15 @@ bool RomCartridgeMD::isRomLoaded(void) const
 	return (m_romData != nullptr);
 }
 
+/**
+ * Get the ROM profile for the loaded ROM.
+ * @return ROM profile, or nullptr if the ROM doesn't have one.
+ */
+const RomProfile *RomCartridgeMD::romProfile(void) const
+{
+	return (d->hasProfile ? &d->profile : nullptr);
+}
+
 /**
  * Update M68K CPU program access structs for bankswitching purposes.
  * @param M68K_Fetch Pointer to first STARSCREAM_PROGRAMREGION to update.
@@ -542,6 +587,12 @@ int RomCartridgeMD::fixChecksum(void)
 			&RomCartridgeMDPrivate::MD_RomFixups[d->romFixup];
 		checksumType = fixup->checksumType;
 	}
+	if (d->hasProfile && d->profile.has(RomProfile::FIELD_CHECKSUM)) {
+		// The ROM profile overrides the built-in fixup.
+		checksumType = (d->profile.checksum == RomProfile::CHECKSUM_NONE
+				? CHKSUM_DISABLED
+				: CHKSUM_SEGA);
+	}
 
 	switch (checksumType) {
 		case CHKSUM_DISABLED:
@@ -718,19 +769,12 @@ int RomCartridgeMD::initSRam(void)
 	m_SRam.setWrite(enableSRam);
 
 	// Check if a ROM fixup needs to be applied.
+	bool sramForceOff = false;
 	if (d->romFixup >= 0) {
 		// Apply a ROM fixup.
 		const RomCartridgeMDPrivate::MD_RomFixup_t *fixup =
 			&RomCartridgeMDPrivate::MD_RomFixups[d->romFixup];
-
-		if (fixup->sram.force_off) {
-			// Force SRAM off.
-			m_SRam.setOn(false);
-			m_SRam.setWrite(false);
-			m_SRam.setStart(1);
-			m_SRam.setEnd(0);
-			return 0;
-		}
+		sramForceOff = fixup->sram.force_off;
 
 		// Fix SRAM start/end addresses.
 		if (fixup->sram.start_addr != 0)
@@ -739,6 +783,25 @@ int RomCartridgeMD::initSRam(void)
 			sramEndAddr = fixup->sram.end_addr;
 	}
 
+	// The ROM profile overrides the built-in fixup.
+	if (d->hasProfile) {
+		if (d->profile.has(RomProfile::FIELD_SRAM_OFF))
+			sramForceOff = true;
+		if (d->profile.has(RomProfile::FIELD_SRAM)) {
+			sramStartAddr = d->profile.sram.start;
+			sramEndAddr = d->profile.sram.end;
+		}
+	}
+
+	if (sramForceOff) {
+		// Force SRAM off.
+		m_SRam.setOn(false);
+		m_SRam.setWrite(false);
+		m_SRam.setStart(1);
+		m_SRam.setEnd(0);
+		return 0;
+	}
+
 	// Set the addresses.
 	m_SRam.setStart(sramStartAddr);
 	m_SRam.setEnd(sramEndAddr);
@@ -769,11 +832,33 @@ int RomCartridgeMD::initEEPRom(void)
 
 	// Reset the EEPRom and set the type.
 	m_EEPRom.reset();
-	m_EEPRom.setEEPRomType(d->eprType);
+	if (d->hasProfile && d->profile.has(RomProfile::FIELD_EEPROM)) {
+		// The ROM profile overrides the EEPRom database.
+		EEPRomI2C::EEPRomSpec_t spec;
+		spec.mode = d->profile.eeprom.mode;
+		spec.dev_addr = d->profile.eeprom.dev_addr;
+		spec.sz_mask = d->profile.eeprom.sz_mask;
+		spec.pg_mask = d->profile.eeprom.pg_mask;
+		spec.sda_in_adr = d->profile.eeprom.sda_in_adr;
+		spec.sda_out_adr = d->profile.eeprom.sda_out_adr;
+		spec.scl_adr = d->profile.eeprom.scl_adr;
+		spec.sda_in_bit = d->profile.eeprom.sda_in_bit;
+		spec.sda_out_bit = d->profile.eeprom.sda_out_bit;
+		spec.scl_bit = d->profile.eeprom.scl_bit;
+
+		// NOTE: EPR_NONE is rejected by setEEPRomSpec(),
+		// which disables EEPRom for this ROM.
+		if (m_EEPRom.setEEPRomSpec(&spec) != 0) {
+			m_EEPRom.setEEPRomType(-1);
+			return -1;
+		}
+	} else {
+		m_EEPRom.setEEPRomType(d->eprType);
 
-	// Don't do anything if the ROM isn't in the EEPRom database.
-	if (d->eprType < 0)
-		return -1;
+		// Don't do anything if the ROM isn't in the EEPRom database.
+		if (d->eprType < 0)
+			return -1;
+	}
 
 	// Load the EEPRom file.
 	// NOTE: EEPRomI2C::setFilename() uses LibGensText::FilenameNoExt().
@@ -1090,6 +1175,50 @@ uint16_t RomCartridgeMD::readWord(uint32_t address)
 	}
 }
 
+/**
+ * Get a direct pointer to ROM data for bulk DMA transfers.
+ * This only works for physical ROM banks, and only if
+ * save data can't be mapped over the ROM.
+ * @param address Cartridge address. (Must be 16-bit aligned!)
+ * @param words [in] Maximum number of words; [out] Number of contiguous words available.
+ * @return Pointer to ROM data, or nullptr if readWord() must be used.
+ */
+const uint16_t *RomCartridgeMD::dmaRomPtr(uint32_t address, unsigned int *words) const
+{
+	assert((address & 1) == 0);
+	address &= 0xFFFFFF;
+
+	if (EmuContext::GetSaveDataEnable() &&
+	    (m_EEPRom.isEEPRomTypeSet() || m_SRam.canRead()))
+	{
+		// Save data may be mapped over the ROM.
+		return nullptr;
+	}
+
+	const uint8_t phys_bank = ((address >> 19) & 0x1F);
+	if (phys_bank >= ARRAY_SIZE(m_cartBanks) ||
+	    m_cartBanks[phys_bank] > BANK_ROM_3F)
+	{
+		// Not a physical ROM bank.
+		return nullptr;
+	}
+
+	// See T_readWord_Rom().
+	const uint32_t rom_address = ((address & 0x7FFFF) | (m_cartBanks[phys_bank] << 19));
+	if (rom_address >= m_romData_size)
+		return nullptr;
+
+	// Don't cross the end of the bank or the end of the ROM.
+	unsigned int avail = ((0x80000 - (address & 0x7FFFF)) >> 1);
+	const unsigned int rom_avail = ((m_romData_size - rom_address) >> 1);
+	if (avail > rom_avail)
+		avail = rom_avail;
+	if (*words > avail)
+		*words = avail;
+
+	return &(reinterpret_cast<const uint16_t*>(m_romData))[rom_address >> 1];
+}
+
 /**
  * Write a byte to the standard cartridge area. ($000000-$9FFFFF)
  * @param address Cartridge address.
@@ -1298,6 +1427,11 @@ void RomCartridgeMD::initMemoryMap(void)
 	const uint32_t crc32 = d->rom->rom_crc32();
 	d->romFixup = d->CheckRomFixups(serialNumber, checksum, crc32);
 
+	// Check the ROM profile database.
+	const RomProfileDB *profileDB = EmuContext::RomProfileDatabase();
+	d->hasProfile = (profileDB && serialNumber.size() >= ROM_PROFILE_SERIAL_LEN &&
+			 profileDB->find(crc32, serialNumber.c_str(), &d->profile));
+
 	// Check for EEPROM.
 	// TODO: Change DetectEEPRomType to use a full serial?
 	const char *eep_serial = (serialNumber.c_str() + 3);
@@ -1316,6 +1450,10 @@ void RomCartridgeMD::initMemoryMap(void)
 		// Use flat addressing.
 		m_mapper.type = MAPPER_MD_FLAT;
 	}
+	if (d->hasProfile && d->profile.has(RomProfile::FIELD_MAPPER)) {
+		// The ROM profile overrides the built-in fixup.
+		m_mapper.type = RomCartridgeMDPrivate::ProfileMapperType(d->profile.mapper);
+	}
 
 	// Set mapper registers based on type.
 	switch (m_mapper.type) {
@@ -1344,9 +1482,27 @@ void RomCartridgeMD::initMemoryMap(void)
 			for (int i = 8; i < ARRAY_SIZE(m_cartBanks); i++)
 				m_cartBanks[i] = BANK_MD_REGISTERS_RO;
 
-			// Copy the register data from the fixups table.
-			memcpy(&m_mapper.registers_ro, &fixup->registers_ro,
-				sizeof(m_mapper.registers_ro));
+			// Copy the register data from the ROM profile
+			// or the fixups table.
+			if (d->hasProfile && d->profile.has(RomProfile::FIELD_REGISTERS_RO)) {
+				memcpy(m_mapper.registers_ro.addr_mask, d->profile.registers_ro.addr_mask,
+					sizeof(m_mapper.registers_ro.addr_mask));
+				memcpy(m_mapper.registers_ro.addr, d->profile.registers_ro.addr,
+					sizeof(m_mapper.registers_ro.addr));
+				memcpy(m_mapper.registers_ro.reg, d->profile.registers_ro.reg,
+					sizeof(m_mapper.registers_ro.reg));
+			} else if (fixup) {
+				memcpy(&m_mapper.registers_ro, &fixup->registers_ro,
+					sizeof(m_mapper.registers_ro));
+			} else {
+				// No register data. All registers read as 0xFF.
+				// (Address 0 is never in the register area.)
+				for (int i = 0; i < ARRAY_SIZE(m_mapper.registers_ro.reg); i++) {
+					m_mapper.registers_ro.addr_mask[i] = 0xFFFFFF;
+					m_mapper.registers_ro.addr[i] = 0;
+					m_mapper.registers_ro.reg[i] = 0;
+				}
+			}
 			break;
 
 #if 0
@@ -41,6 +41,7 @@ namespace LibZomg {
 namespace LibGens {
 
 class Rom;
+struct RomProfile;
 
 class RomCartridgeMDPrivate;
 
@@ -79,6 +80,14 @@ class RomCartridgeMD
 		 */
 		bool isRomLoaded(void) const;
 
+		/**
+		 * Get the ROM profile for the loaded ROM.
+		 * The profile is looked up in EmuContext::RomProfileDatabase()
+		 * when the ROM is loaded.
+		 * @return ROM profile, or nullptr if the ROM doesn't have one.
+		 */
+		const RomProfile *romProfile(void) const;
+
 		/**
 		 * Update M68K CPU program access structs for bankswitching purposes.
 		 * @param M68K_Fetch Pointer to first STARSCREAM_PROGRAMREGION to update.
@@ -159,6 +168,14 @@ class RomCartridgeMD
 		void writeByte(uint32_t address, uint8_t data);
 		void writeWord(uint32_t address, uint16_t data);
 
+		/**
+		 * Get a direct pointer to ROM data for bulk DMA transfers.
+		 * @param address Cartridge address. (Must be 16-bit aligned!)
+		 * @param words [in] Maximum number of words; [out] Number of contiguous words available.
+		 * @return Pointer to ROM data, or nullptr if readWord() must be used.
+		 */
+		const uint16_t *dmaRomPtr(uint32_t address, unsigned int *words) const;
+
 		// /TIME register access functions. ($A130xx)
 		// Only the low byte of the address is needed here.
 		uint8_t readByte_TIME(uint8_t address);
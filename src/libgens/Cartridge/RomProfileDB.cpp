@@ -0,0 +1,439 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * RomProfileDB.cpp: Per-ROM profile database.                             *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include <libgens/config.libgens.h>
+
+#include "RomProfileDB.hpp"
+
+#include "libcompat/byteswap.h"
+
+// zlib: crc32()
+#include <zlib.h>
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif /* HAVE_MMAP */
+
+#ifdef _WIN32
+// Win32 Unicode Translation Layer.
+// Needed for proper Unicode filename support on Windows.
+#include "libcompat/W32U/W32U_mini.h"
+#endif
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace LibGens {
+
+class RomProfileDBPrivate
+{
+	public:
+		RomProfileDBPrivate();
+		~RomProfileDBPrivate();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		RomProfileDBPrivate(const RomProfileDBPrivate &);
+		RomProfileDBPrivate &operator=(const RomProfileDBPrivate &);
+
+	public:
+		// Database image.
+		// If mapped is true, this was mapped with mmap();
+		// otherwise, it was allocated with malloc().
+		const uint8_t *data;
+		size_t size;
+		bool mapped;
+
+		// Pointers into the database image.
+		const RomProfileDB_Entry_t *entries;
+		const uint32_t *buckets;
+		uint32_t entry_count;
+		uint32_t bucket_mask;
+		uint32_t revision;
+
+		/**
+		 * Free the database image.
+		 */
+		void unload(void);
+
+		/**
+		 * Validate the database image and initialize the pointers.
+		 * @return 0 on success; -EBADMSG if the image is invalid.
+		 */
+		int init(void);
+
+		/**
+		 * Find an entry.
+		 * @param key Key.
+		 * @param key_type Key type.
+		 * @param serial Serial number. (KEY_SERIAL only)
+		 * @return Entry, or nullptr if not found.
+		 */
+		const RomProfileDB_Entry_t *findEntry(uint32_t key, uint8_t key_type, const char *serial) const;
+
+		/**
+		 * Convert a database entry to a RomProfile.
+		 * @param entry Database entry.
+		 * @param profile [out] RomProfile.
+		 */
+		static void toProfile(const RomProfileDB_Entry_t *entry, RomProfile *profile);
+};
+
+RomProfileDBPrivate::RomProfileDBPrivate()
+	: data(nullptr)
+	, size(0)
+	, mapped(false)
+	, entries(nullptr)
+	, buckets(nullptr)
+	, entry_count(0)
+	, bucket_mask(0)
+	, revision(0)
+{ }
+
+RomProfileDBPrivate::~RomProfileDBPrivate()
+{
+	unload();
+}
+
+/**
+ * Free the database image.
+ */
+void RomProfileDBPrivate::unload(void)
+{
+	if (data) {
+#ifdef HAVE_MMAP
+		if (mapped) {
+			munmap((void*)data, size);
+		} else
+#endif /* HAVE_MMAP */
+		{
+			free((void*)data);
+		}
+	}
+
+	data = nullptr;
+	size = 0;
+	mapped = false;
+	entries = nullptr;
+	buckets = nullptr;
+	entry_count = 0;
+	bucket_mask = 0;
+	revision = 0;
+}
+
+/**
+ * Validate the database image and initialize the pointers.
+ * @return 0 on success; -EBADMSG if the image is invalid.
+ */
+int RomProfileDBPrivate::init(void)
+{
+	if (size < sizeof(RomProfileDB_Header_t))
+		return -EBADMSG;
+
+	const RomProfileDB_Header_t *header = (const RomProfileDB_Header_t*)data;
+	if (be32_to_cpu(header->magic) != ROM_PROFILE_DB_MAGIC ||
+	    be32_to_cpu(header->version) != ROM_PROFILE_DB_VERSION ||
+	    be32_to_cpu(header->file_size) != size)
+	{
+		return -EBADMSG;
+	}
+
+	const uint32_t count = be32_to_cpu(header->entry_count);
+	const uint32_t bucket_count = be32_to_cpu(header->bucket_count);
+	const uint32_t entry_offset = be32_to_cpu(header->entry_offset);
+	const uint32_t bucket_offset = be32_to_cpu(header->bucket_offset);
+
+	// Bucket count must be a power of two,
+	// and there must be at least one empty bucket.
+	if (bucket_count == 0 || (bucket_count & (bucket_count - 1)) != 0 ||
+	    count >= bucket_count)
+	{
+		return -EBADMSG;
+	}
+
+	// Make sure the tables are within the file.
+	// NOTE: Using 64-bit arithmetic to prevent overflow.
+	if ((uint64_t)entry_offset + ((uint64_t)count * sizeof(RomProfileDB_Entry_t)) > size ||
+	    (uint64_t)bucket_offset + ((uint64_t)bucket_count * sizeof(uint32_t)) > size ||
+	    (bucket_offset % sizeof(uint32_t)) != 0)
+	{
+		return -EBADMSG;
+	}
+
+	entries = (const RomProfileDB_Entry_t*)(data + entry_offset);
+	buckets = (const uint32_t*)(data + bucket_offset);
+	entry_count = count;
+	bucket_mask = bucket_count - 1;
+	revision = be32_to_cpu(header->revision);
+	return 0;
+}
+
+/**
+ * Find an entry.
+ * @param key Key.
+ * @param key_type Key type.
+ * @param serial Serial number. (KEY_SERIAL only)
+ * @return Entry, or nullptr if not found.
+ */
+const RomProfileDB_Entry_t *RomProfileDBPrivate::findEntry(uint32_t key, uint8_t key_type, const char *serial) const
+{
+	uint32_t i = (key & bucket_mask);
+	for (uint32_t n = 0; n <= bucket_mask; n++, i = ((i + 1) & bucket_mask)) {
+		const uint32_t idx = be32_to_cpu(buckets[i]);
+		if (idx == 0) {
+			// Empty bucket. Entry not found.
+			return nullptr;
+		}
+		if (idx > entry_count) {
+			// Invalid entry index.
+			continue;
+		}
+
+		const RomProfileDB_Entry_t *entry = &entries[idx - 1];
+		if (be32_to_cpu(entry->key) != key || entry->key_type != key_type)
+			continue;
+		if (key_type == ROM_PROFILE_KEY_SERIAL &&
+		    memcmp(entry->serial, serial, ROM_PROFILE_SERIAL_LEN) != 0)
+		{
+			// Hash collision.
+			continue;
+		}
+
+		// Found the entry.
+		return entry;
+	}
+
+	// All buckets were checked.
+	// This only happens if the bucket table is corrupted.
+	return nullptr;
+}
+
+/**
+ * Convert a database entry to a RomProfile.
+ * @param entry Database entry.
+ * @param profile [out] RomProfile.
+ */
+void RomProfileDBPrivate::toProfile(const RomProfileDB_Entry_t *entry, RomProfile *profile)
+{
+	memset(profile, 0, sizeof(*profile));
+	profile->fields = be32_to_cpu(entry->fields);
+	memcpy(profile->title, entry->title, sizeof(profile->title));
+	profile->title[sizeof(profile->title)-1] = 0;
+
+	// Cartridge.
+	profile->mapper = (entry->mapper < ROM_PROFILE_MAPPER_MAX
+			? (RomProfile::Mapper)entry->mapper
+			: RomProfile::MAPPER_FLAT);
+	profile->checksum = (entry->checksum < ROM_PROFILE_CHECKSUM_MAX
+			? (RomProfile::Checksum)entry->checksum
+			: RomProfile::CHECKSUM_SEGA);
+	profile->sram.start = be32_to_cpu(entry->sram_start);
+	profile->sram.end = be32_to_cpu(entry->sram_end);
+	for (int i = 0; i < 4; i++) {
+		profile->registers_ro.addr_mask[i] = be32_to_cpu(entry->ro_addr_mask[i]);
+		profile->registers_ro.addr[i] = be32_to_cpu(entry->ro_addr[i]);
+		profile->registers_ro.reg[i] = be16_to_cpu(entry->ro_reg[i]);
+	}
+
+	// EEPROM.
+	profile->eeprom.mode = entry->eeprom_mode;
+	profile->eeprom.dev_addr = entry->eeprom_dev_addr;
+	profile->eeprom.sz_mask = be16_to_cpu(entry->eeprom_sz_mask);
+	profile->eeprom.pg_mask = entry->eeprom_pg_mask;
+	profile->eeprom.sda_in_adr = be32_to_cpu(entry->eeprom_sda_in_adr);
+	profile->eeprom.sda_out_adr = be32_to_cpu(entry->eeprom_sda_out_adr);
+	profile->eeprom.scl_adr = be32_to_cpu(entry->eeprom_scl_adr);
+	profile->eeprom.sda_in_bit = entry->eeprom_sda_in_bit;
+	profile->eeprom.sda_out_bit = entry->eeprom_sda_out_bit;
+	profile->eeprom.scl_bit = entry->eeprom_scl_bit;
+
+	// Emulation hints.
+	profile->spriteLimits = !!(entry->hints & ROM_PROFILE_HINT_SPRITE_LIMITS);
+	profile->zeroLengthDMA = !!(entry->hints & ROM_PROFILE_HINT_ZERO_LENGTH_DMA);
+	profile->idleSkip = !!(entry->hints & ROM_PROFILE_HINT_IDLE_SKIP);
+	profile->resampler = !!(entry->hints & ROM_PROFILE_HINT_RESAMPLER);
+}
+
+/** RomProfileDB **/
+
+RomProfileDB::RomProfileDB()
+	: d(new RomProfileDBPrivate())
+{ }
+
+RomProfileDB::~RomProfileDB()
+{
+	delete d;
+}
+
+/**
+ * Open a ROM profile database.
+ * Any previously-opened database is closed.
+ * @param filename Database filename.
+ * @return 0 on success; negative POSIX error code on error.
+ * (-EBADMSG if the file isn't a valid database.)
+ */
+int RomProfileDB::open(const char *filename)
+{
+	d->unload();
+
+#ifdef HAVE_MMAP
+	int fd = ::open(filename, O_RDONLY);
+	if (fd < 0)
+		return -errno;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		int err = -errno;
+		::close(fd);
+		return err;
+	}
+	if (st.st_size < (off_t)sizeof(RomProfileDB_Header_t)) {
+		::close(fd);
+		return -EBADMSG;
+	}
+
+	void *map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	int err = (map == MAP_FAILED ? -errno : 0);
+	::close(fd);
+	if (err != 0)
+		return err;
+
+	d->data = (const uint8_t*)map;
+	d->size = (size_t)st.st_size;
+	d->mapped = true;
+#else /* !HAVE_MMAP */
+	// mmap() isn't available. Read the whole file.
+	FILE *f = fopen(filename, "rb");
+	if (!f)
+		return -errno;
+
+	fseek(f, 0, SEEK_END);
+	long fileSize = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (fileSize < (long)sizeof(RomProfileDB_Header_t)) {
+		fclose(f);
+		return -EBADMSG;
+	}
+
+	uint8_t *buf = (uint8_t*)malloc(fileSize);
+	if (!buf) {
+		fclose(f);
+		return -ENOMEM;
+	}
+	size_t rd = fread(buf, 1, fileSize, f);
+	fclose(f);
+	if (rd != (size_t)fileSize) {
+		free(buf);
+		return -EIO;
+	}
+
+	d->data = buf;
+	d->size = (size_t)fileSize;
+	d->mapped = false;
+#endif /* HAVE_MMAP */
+
+	int ret = d->init();
+	if (ret != 0) {
+		d->unload();
+	}
+	return ret;
+}
+
+/**
+ * Close the database.
+ */
+void RomProfileDB::close(void)
+{
+	d->unload();
+}
+
+/**
+ * Is a database open?
+ * @return True if open; false if not.
+ */
+bool RomProfileDB::isOpen(void) const
+{
+	return (d->data != nullptr);
+}
+
+/**
+ * Get the database revision.
+ * @return Database revision, or 0 if no database is open.
+ */
+uint32_t RomProfileDB::revision(void) const
+{
+	return d->revision;
+}
+
+/**
+ * Get the number of profiles in the database.
+ * @return Number of profiles.
+ */
+unsigned int RomProfileDB::count(void) const
+{
+	return d->entry_count;
+}
+
+/**
+ * Find the profile for a ROM.
+ * CRC32 entries take precedence over serial number entries.
+ * @param crc32 ROM CRC32. (0 to skip the CRC32 lookup)
+ * @param serial ROM header serial number. (At least 11 characters, or nullptr)
+ * @param profile [out] Profile.
+ * @return True if a profile was found; false if not.
+ */
+bool RomProfileDB::find(uint32_t crc32, const char *serial, RomProfile *profile) const
+{
+	if (!d->data)
+		return false;
+
+	const RomProfileDB_Entry_t *entry = nullptr;
+	if (crc32 != 0) {
+		entry = d->findEntry(crc32, ROM_PROFILE_KEY_CRC32, nullptr);
+	}
+	if (!entry && serial != nullptr) {
+		entry = d->findEntry(SerialKey(serial), ROM_PROFILE_KEY_SERIAL, serial);
+	}
+	if (!entry)
+		return false;
+
+	RomProfileDBPrivate::toProfile(entry, profile);
+	return true;
+}
+
+/**
+ * Calculate the key for a serial number.
+ * @param serial Serial number. (First 11 characters are used.)
+ * @return Key.
+ */
+uint32_t RomProfileDB::SerialKey(const char *serial)
+{
+	return crc32(0, (const Bytef*)serial, ROM_PROFILE_SERIAL_LEN);
+}
+
+}
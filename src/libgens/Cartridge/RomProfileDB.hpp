@@ -0,0 +1,242 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * RomProfileDB.hpp: Per-ROM profile database.                             *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_CARTRIDGE_ROMPROFILEDB_HPP__
+#define __LIBGENS_CARTRIDGE_ROMPROFILEDB_HPP__
+
+#include "rom_profile_db.h"
+
+// C includes.
+#include <stdint.h>
+// C includes. (C++ namespace)
+#include <cstddef>
+// C++ includes.
+#include <string>
+#include <vector>
+
+namespace LibGens {
+
+/**
+ * ROM profile.
+ * Per-ROM settings from the ROM profile database.
+ * Only the fields listed in 'fields' are valid.
+ */
+struct RomProfile {
+	enum Field {
+		FIELD_MAPPER		= ROM_PROFILE_FIELD_MAPPER,
+		FIELD_CHECKSUM		= ROM_PROFILE_FIELD_CHECKSUM,
+		FIELD_SRAM		= ROM_PROFILE_FIELD_SRAM,
+		FIELD_SRAM_OFF		= ROM_PROFILE_FIELD_SRAM_OFF,
+		FIELD_REGISTERS_RO	= ROM_PROFILE_FIELD_REGISTERS_RO,
+		FIELD_EEPROM		= ROM_PROFILE_FIELD_EEPROM,
+		FIELD_SPRITE_LIMITS	= ROM_PROFILE_FIELD_SPRITE_LIMITS,
+		FIELD_ZERO_LENGTH_DMA	= ROM_PROFILE_FIELD_ZERO_LENGTH_DMA,
+		FIELD_IDLE_SKIP		= ROM_PROFILE_FIELD_IDLE_SKIP,
+		FIELD_RESAMPLER		= ROM_PROFILE_FIELD_RESAMPLER,
+	};
+
+	enum Mapper {
+		MAPPER_FLAT		= ROM_PROFILE_MAPPER_FLAT,
+		MAPPER_SSF2		= ROM_PROFILE_MAPPER_SSF2,
+		MAPPER_REGISTERS_RO	= ROM_PROFILE_MAPPER_REGISTERS_RO,
+	};
+
+	enum Checksum {
+		CHECKSUM_NONE		= ROM_PROFILE_CHECKSUM_NONE,
+		CHECKSUM_SEGA		= ROM_PROFILE_CHECKSUM_SEGA,
+	};
+
+	uint32_t fields;
+	char title[48];
+
+	// Cartridge.
+	Mapper mapper;
+	Checksum checksum;
+	struct {
+		uint32_t start;
+		uint32_t end;
+	} sram;
+	struct {
+		uint32_t addr_mask[4];
+		uint32_t addr[4];
+		uint16_t reg[4];
+	} registers_ro;
+	struct {
+		uint8_t mode;		// EEPRomI2C::EEPRomMode_t (EPR_NONE == no EEPROM)
+		uint8_t dev_addr;
+		uint16_t sz_mask;
+		uint8_t pg_mask;
+		uint32_t sda_in_adr;
+		uint32_t sda_out_adr;
+		uint32_t scl_adr;
+		uint8_t sda_in_bit;
+		uint8_t sda_out_bit;
+		uint8_t scl_bit;
+	} eeprom;
+
+	// Emulation hints.
+	bool spriteLimits;
+	bool zeroLengthDMA;
+	bool idleSkip;
+	bool resampler;
+
+	inline bool has(Field field) const
+		{ return !!(fields & field); }
+};
+
+class RomProfileDBPrivate;
+
+/**
+ * ROM profile database.
+ *
+ * The database is a binary file compiled by gens-profiledb.
+ * It's mapped into memory as-is, and entries are found with
+ * a single hash table probe sequence, so looking up a ROM
+ * costs the same regardless of the database size.
+ */
+class RomProfileDB
+{
+	public:
+		RomProfileDB();
+		~RomProfileDB();
+
+	private:
+		friend class RomProfileDBPrivate;
+		RomProfileDBPrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		RomProfileDB(const RomProfileDB &);
+		RomProfileDB &operator=(const RomProfileDB &);
+
+	public:
+		/**
+		 * Open a ROM profile database.
+		 * Any previously-opened database is closed.
+		 * @param filename Database filename.
+		 * @return 0 on success; negative POSIX error code on error.
+		 * (-EBADMSG if the file isn't a valid database.)
+		 */
+		int open(const char *filename);
+
+		/**
+		 * Close the database.
+		 */
+		void close(void);
+
+		/**
+		 * Is a database open?
+		 * @return True if open; false if not.
+		 */
+		bool isOpen(void) const;
+
+		/**
+		 * Get the database revision.
+		 * @return Database revision, or 0 if no database is open.
+		 */
+		uint32_t revision(void) const;
+
+		/**
+		 * Get the number of profiles in the database.
+		 * @return Number of profiles.
+		 */
+		unsigned int count(void) const;
+
+		/**
+		 * Find the profile for a ROM.
+		 * CRC32 entries take precedence over serial number entries.
+		 * @param crc32 ROM CRC32. (0 to skip the CRC32 lookup)
+		 * @param serial ROM header serial number. (At least 11 characters, or nullptr)
+		 * @param profile [out] Profile.
+		 * @return True if a profile was found; false if not.
+		 */
+		bool find(uint32_t crc32, const char *serial, RomProfile *profile) const;
+
+		/**
+		 * Calculate the key for a serial number.
+		 * @param serial Serial number. (First 11 characters are used.)
+		 * @return Key.
+		 */
+		static uint32_t SerialKey(const char *serial);
+};
+
+class RomProfileDBCompilerPrivate;
+
+/**
+ * ROM profile database compiler.
+ * Parses text sources and builds the binary database.
+ * See doc/RomProfileDB.txt for the text format.
+ */
+class RomProfileDBCompiler
+{
+	public:
+		RomProfileDBCompiler();
+		~RomProfileDBCompiler();
+
+	private:
+		friend class RomProfileDBCompilerPrivate;
+		RomProfileDBCompilerPrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		RomProfileDBCompiler(const RomProfileDBCompiler &);
+		RomProfileDBCompiler &operator=(const RomProfileDBCompiler &);
+
+	public:
+		/**
+		 * Parse a text source.
+		 * Profiles are added to the database being built.
+		 * @param text Source text.
+		 * @param len Length of the source text.
+		 * @param srcname Source name, for error messages.
+		 * @return 0 on success; -EINVAL on a syntax error. (See lastError().)
+		 */
+		int parse(const char *text, size_t len, const char *srcname);
+
+		/**
+		 * Get the last error message.
+		 * @return Error message, e.g. "file.txt:12: unknown key 'foo'".
+		 */
+		const std::string &lastError(void) const;
+
+		/**
+		 * Get the number of profiles parsed so far.
+		 * @return Number of profiles.
+		 */
+		unsigned int count(void) const;
+
+		/**
+		 * Build the binary database.
+		 * @param out [out] Database image.
+		 */
+		void build(std::vector<uint8_t> &out) const;
+
+		/**
+		 * Build the binary database and write it to a file.
+		 * @param filename Database filename.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int write(const char *filename) const;
+};
+
+}
+
+#endif /* __LIBGENS_CARTRIDGE_ROMPROFILEDB_HPP__ */
@@ -0,0 +1,635 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * RomProfileDB_Compile.cpp: ROM profile database compiler.                *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "RomProfileDB.hpp"
+
+#include "Save/EEPRomI2C.hpp"
+#include "libcompat/byteswap.h"
+
+#ifdef _WIN32
+// Win32 Unicode Translation Layer.
+// Needed for proper Unicode filename support on Windows.
+#include "libcompat/W32U/W32U_mini.h"
+#endif
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ includes.
+#include <string>
+#include <vector>
+using std::string;
+using std::vector;
+
+namespace LibGens {
+
+class RomProfileDBCompilerPrivate
+{
+	public:
+		RomProfileDBCompilerPrivate();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		RomProfileDBCompilerPrivate(const RomProfileDBCompilerPrivate &);
+		RomProfileDBCompilerPrivate &operator=(const RomProfileDBCompilerPrivate &);
+
+	public:
+		// Database revision.
+		uint32_t revision;
+
+		// Completed entries. (Stored in database format.)
+		vector<RomProfileDB_Entry_t> entries;
+
+		// Current entry.
+		RomProfileDB_Entry_t cur;
+		bool inEntry;
+
+		// EEPROM lines seen in the current entry.
+		enum {
+			EPR_SEEN_SIZE	= (1 << 0),
+			EPR_SEEN_PAGE	= (1 << 1),
+			EPR_SEEN_SDA_IN	= (1 << 2),
+			EPR_SEEN_SDA_OUT = (1 << 3),
+			EPR_SEEN_SCL	= (1 << 4),
+			EPR_SEEN_ALL	= 0x1F,
+		};
+		unsigned int eprSeen;
+
+		// Error reporting.
+		string lastError;
+		const char *srcname;
+		int line;
+
+		/**
+		 * Set the error message.
+		 * @param fmt Format string.
+		 * @return -EINVAL
+		 */
+		int error(const char *fmt, ...)
+#ifdef __GNUC__
+			__attribute__ ((format (printf, 2, 3)))
+#endif
+			;
+
+		/**
+		 * Start a new entry.
+		 * @param section Section header, without brackets.
+		 * @return 0 on success; -EINVAL on error.
+		 */
+		int beginEntry(const string &section);
+
+		/**
+		 * Finish the current entry.
+		 * @return 0 on success; -EINVAL on error.
+		 */
+		int endEntry(void);
+
+		/**
+		 * Process a key/value pair.
+		 * @param key Key.
+		 * @param value Value.
+		 * @return 0 on success; -EINVAL on error.
+		 */
+		int setValue(const string &key, const string &value);
+
+		/** Value parsers. **/
+		static bool parseHex(const string &str, uint32_t max, uint32_t *out);
+		static bool parseBool(const string &str, bool *out);
+		static bool parseAddrBit(const string &str, uint32_t *addr, uint8_t *bit);
+		static string trim(const string &str);
+};
+
+RomProfileDBCompilerPrivate::RomProfileDBCompilerPrivate()
+	: revision(0)
+	, inEntry(false)
+	, eprSeen(0)
+	, srcname("")
+	, line(0)
+{
+	memset(&cur, 0, sizeof(cur));
+}
+
+/**
+ * Set the error message.
+ * @param fmt Format string.
+ * @return -EINVAL
+ */
+int RomProfileDBCompilerPrivate::error(const char *fmt, ...)
+{
+	char msg[256];
+	va_list ap;
+	va_start(ap, fmt);
+	vsnprintf(msg, sizeof(msg), fmt, ap);
+	va_end(ap);
+
+	char loc[256];
+	snprintf(loc, sizeof(loc), "%s:%d: ", srcname, line);
+	lastError = string(loc) + msg;
+	return -EINVAL;
+}
+
+/**
+ * Remove leading and trailing whitespace.
+ * @param str String.
+ * @return Trimmed string.
+ */
+string RomProfileDBCompilerPrivate::trim(const string &str)
+{
+	static const char ws[] = " \t\r\n";
+	size_t start = str.find_first_not_of(ws);
+	if (start == string::npos)
+		return string();
+	size_t end = str.find_last_not_of(ws);
+	return str.substr(start, end - start + 1);
+}
+
+/**
+ * Parse a hexadecimal value.
+ * An optional "0x" or "$" prefix is allowed.
+ * @param str String.
+ * @param max Maximum value.
+ * @param out [out] Value.
+ * @return True on success; false on error.
+ */
+bool RomProfileDBCompilerPrivate::parseHex(const string &str, uint32_t max, uint32_t *out)
+{
+	const char *s = str.c_str();
+	if (s[0] == '$') {
+		s++;
+	} else if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+		s += 2;
+	}
+	if (*s == 0)
+		return false;
+
+	char *endptr;
+	errno = 0;
+	unsigned long val = strtoul(s, &endptr, 16);
+	if (errno != 0 || *endptr != 0 || *s == '-' || val > max)
+		return false;
+	*out = (uint32_t)val;
+	return true;
+}
+
+/**
+ * Parse a boolean value.
+ * @param str String. ("on", "off", "yes", "no", "true", "false", "1", "0")
+ * @param out [out] Value.
+ * @return True on success; false on error.
+ */
+bool RomProfileDBCompilerPrivate::parseBool(const string &str, bool *out)
+{
+	static const char *const true_str[] = {"on", "yes", "true", "1"};
+	static const char *const false_str[] = {"off", "no", "false", "0"};
+	for (int i = 0; i < 4; i++) {
+		if (str == true_str[i]) {
+			*out = true;
+			return true;
+		} else if (str == false_str[i]) {
+			*out = false;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Parse an EEPROM line specification.
+ * @param str String. ("ADDR:BIT", e.g. "200001:7")
+ * @param addr [out] Address.
+ * @param bit [out] Bit.
+ * @return True on success; false on error.
+ */
+bool RomProfileDBCompilerPrivate::parseAddrBit(const string &str, uint32_t *addr, uint8_t *bit)
+{
+	size_t colon = str.find(':');
+	if (colon == string::npos)
+		return false;
+	uint32_t b;
+	if (!parseHex(trim(str.substr(0, colon)), 0xFFFFFF, addr) ||
+	    !parseHex(trim(str.substr(colon + 1)), 7, &b))
+	{
+		return false;
+	}
+	*bit = (uint8_t)b;
+	return true;
+}
+
+/**
+ * Start a new entry.
+ * @param section Section header, without brackets.
+ * @return 0 on success; -EINVAL on error.
+ */
+int RomProfileDBCompilerPrivate::beginEntry(const string &section)
+{
+	memset(&cur, 0, sizeof(cur));
+	eprSeen = 0;
+
+	// Unused read-only registers only match address 0,
+	// which is never in the register area.
+	for (int i = 0; i < 4; i++) {
+		cur.ro_addr_mask[i] = cpu_to_be32(0xFFFFFF);
+	}
+
+	if (section.compare(0, 6, "crc32 ") == 0) {
+		uint32_t crc;
+		if (!parseHex(trim(section.substr(6)), 0xFFFFFFFF, &crc))
+			return error("invalid CRC32 in section header");
+		cur.key = cpu_to_be32(crc);
+		cur.key_type = ROM_PROFILE_KEY_CRC32;
+	} else if (section.compare(0, 7, "serial ") == 0) {
+		// Serial number must be quoted, since trailing
+		// spaces are significant.
+		const string q = trim(section.substr(7));
+		if (q.size() < 2 || q[0] != '"' || q[q.size()-1] != '"')
+			return error("serial number must be quoted");
+		const string serial = q.substr(1, q.size() - 2);
+		if (serial.empty() || serial.size() > ROM_PROFILE_SERIAL_LEN)
+			return error("serial number must be 1-%d characters", ROM_PROFILE_SERIAL_LEN);
+
+		// Pad the serial number with spaces, as in the ROM header.
+		memset(cur.serial, ' ', ROM_PROFILE_SERIAL_LEN);
+		memcpy(cur.serial, serial.data(), serial.size());
+		cur.key = cpu_to_be32(RomProfileDB::SerialKey(cur.serial));
+		cur.key_type = ROM_PROFILE_KEY_SERIAL;
+	} else {
+		return error("unknown section type '%s'", section.c_str());
+	}
+
+	// Check for duplicates.
+	for (size_t i = 0; i < entries.size(); i++) {
+		if (entries[i].key == cur.key && entries[i].key_type == cur.key_type &&
+		    !memcmp(entries[i].serial, cur.serial, sizeof(cur.serial)))
+		{
+			return error("duplicate profile [%s]", section.c_str());
+		}
+	}
+
+	inEntry = true;
+	return 0;
+}
+
+/**
+ * Finish the current entry.
+ * @return 0 on success; -EINVAL on error.
+ */
+int RomProfileDBCompilerPrivate::endEntry(void)
+{
+	if (!inEntry)
+		return 0;
+	inEntry = false;
+
+	const uint32_t fields = be32_to_cpu(cur.fields);
+	if ((fields & ROM_PROFILE_FIELD_MAPPER) &&
+	    cur.mapper == ROM_PROFILE_MAPPER_REGISTERS_RO &&
+	    !(fields & ROM_PROFILE_FIELD_REGISTERS_RO))
+	{
+		return error("mapper 'registers_ro' requires ro_reg0-ro_reg3");
+	}
+	if ((fields & ROM_PROFILE_FIELD_EEPROM) &&
+	    cur.eeprom_mode != EEPRomI2C::EPR_NONE &&
+	    eprSeen != EPR_SEEN_ALL)
+	{
+		return error("eeprom requires eeprom_size_mask, eeprom_page_mask, "
+			"eeprom_sda_in, eeprom_sda_out, and eeprom_scl");
+	}
+	if (fields & ROM_PROFILE_FIELD_SRAM) {
+		const uint32_t start = be32_to_cpu(cur.sram_start);
+		const uint32_t end = be32_to_cpu(cur.sram_end);
+		if (start > end || (end - start) > 0xFFFF)
+			return error("invalid SRAM range (must be 1-64 KB)");
+	}
+
+	entries.push_back(cur);
+	return 0;
+}
+
+/**
+ * Process a key/value pair.
+ * @param key Key.
+ * @param value Value.
+ * @return 0 on success; -EINVAL on error.
+ */
+int RomProfileDBCompilerPrivate::setValue(const string &key, const string &value)
+{
+	if (!inEntry) {
+		// Global settings.
+		if (key == "revision") {
+			if (!parseHex(value, 0xFFFFFFFF, &revision))
+				return error("invalid revision '%s'", value.c_str());
+			return 0;
+		}
+		return error("'%s' must be in a profile section", key.c_str());
+	}
+
+	uint32_t fields = be32_to_cpu(cur.fields);
+	uint32_t val;
+	bool b;
+
+	if (key == "title") {
+		strncpy(cur.title, value.c_str(), sizeof(cur.title) - 1);
+		return 0;
+	} else if (key == "mapper") {
+		static const char *const mappers[ROM_PROFILE_MAPPER_MAX] = {
+			"flat", "ssf2", "registers_ro"
+		};
+		for (val = 0; val < ROM_PROFILE_MAPPER_MAX; val++) {
+			if (value == mappers[val])
+				break;
+		}
+		if (val >= ROM_PROFILE_MAPPER_MAX)
+			return error("unknown mapper '%s'", value.c_str());
+		cur.mapper = (uint8_t)val;
+		fields |= ROM_PROFILE_FIELD_MAPPER;
+	} else if (key == "checksum") {
+		if (value == "none") {
+			cur.checksum = ROM_PROFILE_CHECKSUM_NONE;
+		} else if (value == "sega") {
+			cur.checksum = ROM_PROFILE_CHECKSUM_SEGA;
+		} else {
+			return error("unknown checksum type '%s'", value.c_str());
+		}
+		fields |= ROM_PROFILE_FIELD_CHECKSUM;
+	} else if (key == "sram") {
+		if (value == "off") {
+			fields |= ROM_PROFILE_FIELD_SRAM_OFF;
+		} else {
+			size_t dash = value.find('-');
+			uint32_t start, end;
+			if (dash == string::npos ||
+			    !parseHex(trim(value.substr(0, dash)), 0xFFFFFF, &start) ||
+			    !parseHex(trim(value.substr(dash + 1)), 0xFFFFFF, &end))
+			{
+				return error("invalid SRAM range '%s'", value.c_str());
+			}
+			cur.sram_start = cpu_to_be32(start);
+			cur.sram_end = cpu_to_be32(end);
+			fields |= ROM_PROFILE_FIELD_SRAM;
+		}
+	} else if (key.size() == 7 && key.compare(0, 6, "ro_reg") == 0 &&
+		   key[6] >= '0' && key[6] <= '3')
+	{
+		// Read-only register: MASK ADDR VALUE
+		const int i = key[6] - '0';
+		char mask_s[16], addr_s[16], reg_s[16], extra;
+		uint32_t mask, addr, reg;
+		if (sscanf(value.c_str(), "%15s %15s %15s %c", mask_s, addr_s, reg_s, &extra) != 3 ||
+		    !parseHex(mask_s, 0xFFFFFF, &mask) ||
+		    !parseHex(addr_s, 0xFFFFFF, &addr) ||
+		    !parseHex(reg_s, 0xFFFF, &reg))
+		{
+			return error("invalid register '%s' (expected MASK ADDR VALUE)", value.c_str());
+		}
+		cur.ro_addr_mask[i] = cpu_to_be32(mask);
+		cur.ro_addr[i] = cpu_to_be32(addr);
+		cur.ro_reg[i] = cpu_to_be16((uint16_t)reg);
+		fields |= ROM_PROFILE_FIELD_REGISTERS_RO;
+	} else if (key == "eeprom") {
+		static const char *const modes[EEPRomI2C::EPR_MAX] = {
+			"none", "mode1", "mode2", "mode3"
+		};
+		for (val = 0; val < EEPRomI2C::EPR_MAX; val++) {
+			if (value == modes[val])
+				break;
+		}
+		if (val >= EEPRomI2C::EPR_MAX)
+			return error("unknown EEPROM mode '%s'", value.c_str());
+		cur.eeprom_mode = (uint8_t)val;
+		fields |= ROM_PROFILE_FIELD_EEPROM;
+	} else if (key == "eeprom_dev_addr") {
+		if (!parseHex(value, 0x07, &val))
+			return error("invalid EEPROM device address '%s'", value.c_str());
+		cur.eeprom_dev_addr = (uint8_t)val;
+	} else if (key == "eeprom_size_mask") {
+		// Must be (2^n)-1, and fit in EEPRomI2C's buffer.
+		if (!parseHex(value, EEPRomI2C::MAX_SIZE - 1, &val) || (val & (val + 1)) != 0 || val == 0)
+			return error("invalid EEPROM size mask '%s'", value.c_str());
+		cur.eeprom_sz_mask = cpu_to_be16((uint16_t)val);
+		eprSeen |= EPR_SEEN_SIZE;
+	} else if (key == "eeprom_page_mask") {
+		if (!parseHex(value, EEPRomI2C::MAX_PAGE_SIZE - 1, &val) || (val & (val + 1)) != 0 || val == 0)
+			return error("invalid EEPROM page mask '%s'", value.c_str());
+		cur.eeprom_pg_mask = (uint8_t)val;
+		eprSeen |= EPR_SEEN_PAGE;
+	} else if (key == "eeprom_sda_in" || key == "eeprom_sda_out" || key == "eeprom_scl") {
+		uint32_t addr;
+		uint8_t bit;
+		if (!parseAddrBit(value, &addr, &bit))
+			return error("invalid EEPROM line '%s' (expected ADDR:BIT)", value.c_str());
+		if (key == "eeprom_sda_in") {
+			cur.eeprom_sda_in_adr = cpu_to_be32(addr);
+			cur.eeprom_sda_in_bit = bit;
+			eprSeen |= EPR_SEEN_SDA_IN;
+		} else if (key == "eeprom_sda_out") {
+			cur.eeprom_sda_out_adr = cpu_to_be32(addr);
+			cur.eeprom_sda_out_bit = bit;
+			eprSeen |= EPR_SEEN_SDA_OUT;
+		} else {
+			cur.eeprom_scl_adr = cpu_to_be32(addr);
+			cur.eeprom_scl_bit = bit;
+			eprSeen |= EPR_SEEN_SCL;
+		}
+	} else {
+		// Boolean hints.
+		static const struct {
+			const char *key;
+			uint32_t field;
+			uint8_t hint;
+		} hints[] = {
+			{"sprite_limits",	ROM_PROFILE_FIELD_SPRITE_LIMITS,	ROM_PROFILE_HINT_SPRITE_LIMITS},
+			{"zero_length_dma",	ROM_PROFILE_FIELD_ZERO_LENGTH_DMA,	ROM_PROFILE_HINT_ZERO_LENGTH_DMA},
+			{"idle_skip",		ROM_PROFILE_FIELD_IDLE_SKIP,		ROM_PROFILE_HINT_IDLE_SKIP},
+			{"resampler",		ROM_PROFILE_FIELD_RESAMPLER,		ROM_PROFILE_HINT_RESAMPLER},
+		};
+
+		int i;
+		for (i = 0; i < (int)(sizeof(hints)/sizeof(hints[0])); i++) {
+			if (key == hints[i].key)
+				break;
+		}
+		if (i >= (int)(sizeof(hints)/sizeof(hints[0])))
+			return error("unknown key '%s'", key.c_str());
+		if (!parseBool(value, &b))
+			return error("invalid boolean '%s' for '%s'", value.c_str(), key.c_str());
+
+		if (b) {
+			cur.hints |= hints[i].hint;
+		} else {
+			cur.hints &= ~hints[i].hint;
+		}
+		fields |= hints[i].field;
+	}
+
+	cur.fields = cpu_to_be32(fields);
+	return 0;
+}
+
+/** RomProfileDBCompiler **/
+
+RomProfileDBCompiler::RomProfileDBCompiler()
+	: d(new RomProfileDBCompilerPrivate())
+{ }
+
+RomProfileDBCompiler::~RomProfileDBCompiler()
+{
+	delete d;
+}
+
+/**
+ * Parse a text source.
+ * Profiles are added to the database being built.
+ * @param text Source text.
+ * @param len Length of the source text.
+ * @param srcname Source name, for error messages.
+ * @return 0 on success; -EINVAL on a syntax error. (See lastError().)
+ */
+int RomProfileDBCompiler::parse(const char *text, size_t len, const char *srcname)
+{
+	d->srcname = srcname;
+	d->line = 0;
+	d->inEntry = false;
+
+	size_t pos = 0;
+	while (pos < len) {
+		size_t eol = pos;
+		while (eol < len && text[eol] != '\n')
+			eol++;
+		const string ln = RomProfileDBCompilerPrivate::trim(string(&text[pos], eol - pos));
+		pos = eol + 1;
+		d->line++;
+
+		if (ln.empty() || ln[0] == '#' || ln[0] == ';') {
+			// Empty line or comment.
+			continue;
+		}
+
+		int ret;
+		if (ln[0] == '[') {
+			// Section header.
+			if (ln[ln.size()-1] != ']')
+				return d->error("missing ']' in section header");
+			ret = d->endEntry();
+			if (ret != 0)
+				return ret;
+			ret = d->beginEntry(RomProfileDBCompilerPrivate::trim(ln.substr(1, ln.size() - 2)));
+		} else {
+			// Key/value pair.
+			size_t eq = ln.find('=');
+			if (eq == string::npos)
+				return d->error("expected 'key = value'");
+			ret = d->setValue(RomProfileDBCompilerPrivate::trim(ln.substr(0, eq)),
+					  RomProfileDBCompilerPrivate::trim(ln.substr(eq + 1)));
+		}
+		if (ret != 0)
+			return ret;
+	}
+
+	return d->endEntry();
+}
+
+/**
+ * Get the last error message.
+ * @return Error message, e.g. "file.txt:12: unknown key 'foo'".
+ */
+const string &RomProfileDBCompiler::lastError(void) const
+{
+	return d->lastError;
+}
+
+/**
+ * Get the number of profiles parsed so far.
+ * @return Number of profiles.
+ */
+unsigned int RomProfileDBCompiler::count(void) const
+{
+	return (unsigned int)d->entries.size();
+}
+
+/**
+ * Build the binary database.
+ * @param out [out] Database image.
+ */
+void RomProfileDBCompiler::build(vector<uint8_t> &out) const
+{
+	const uint32_t count = (uint32_t)d->entries.size();
+
+	// At least twice as many buckets as entries.
+	uint32_t bucket_count = 8;
+	while (bucket_count < count * 2)
+		bucket_count <<= 1;
+
+	const uint32_t entry_offset = sizeof(RomProfileDB_Header_t);
+	const uint32_t bucket_offset = entry_offset + (count * sizeof(RomProfileDB_Entry_t));
+	const uint32_t file_size = bucket_offset + (bucket_count * sizeof(uint32_t));
+	out.assign(file_size, 0);
+
+	RomProfileDB_Header_t *header = (RomProfileDB_Header_t*)&out[0];
+	header->magic = cpu_to_be32(ROM_PROFILE_DB_MAGIC);
+	header->version = cpu_to_be32(ROM_PROFILE_DB_VERSION);
+	header->revision = cpu_to_be32(d->revision);
+	header->entry_count = cpu_to_be32(count);
+	header->bucket_count = cpu_to_be32(bucket_count);
+	header->entry_offset = cpu_to_be32(entry_offset);
+	header->bucket_offset = cpu_to_be32(bucket_offset);
+	header->file_size = cpu_to_be32(file_size);
+
+	if (count > 0) {
+		memcpy(&out[entry_offset], &d->entries[0], count * sizeof(RomProfileDB_Entry_t));
+	}
+
+	// Fill the hash buckets.
+	uint32_t *buckets = (uint32_t*)&out[bucket_offset];
+	const uint32_t mask = bucket_count - 1;
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t b = (be32_to_cpu(d->entries[i].key) & mask);
+		while (buckets[b] != 0) {
+			b = ((b + 1) & mask);
+		}
+		buckets[b] = cpu_to_be32(i + 1);
+	}
+}
+
+/**
+ * Build the binary database and write it to a file.
+ * @param filename Database filename.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int RomProfileDBCompiler::write(const char *filename) const
+{
+	vector<uint8_t> out;
+	build(out);
+
+	FILE *f = fopen(filename, "wb");
+	if (!f)
+		return -errno;
+	size_t wr = fwrite(&out[0], 1, out.size(), f);
+	int err = (wr != out.size() ? -EIO : 0);
+	if (fclose(f) != 0 && err == 0)
+		err = -errno;
+	return err;
+}
+
+}
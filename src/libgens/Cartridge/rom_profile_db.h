@@ -0,0 +1,155 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * rom_profile_db.h: ROM profile database format.                          *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_CARTRIDGE_ROM_PROFILE_DB_H__
+#define __LIBGENS_CARTRIDGE_ROM_PROFILE_DB_H__
+
+#include <stdint.h>
+#include "../macros/common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ROM profile database. (Binary format)
+ * Compiled from text sources by gens-profiledb.
+ * See doc/RomProfileDB.txt for the text format.
+ *
+ * All multi-byte values are big-endian.
+ *
+ * File layout:
+ * - RomProfileDB_Header_t
+ * - Entries: RomProfileDB_Entry_t[entry_count]
+ * - Hash buckets: uint32_t[bucket_count]
+ *
+ * Each bucket contains an entry index plus one, or 0 if the bucket
+ * is empty. bucket_count is a power of two, and at least twice the
+ * number of entries. An entry's initial bucket is its key masked
+ * with (bucket_count - 1); collisions are resolved with linear
+ * probing, so a lookup ends at the first empty bucket.
+ */
+#define ROM_PROFILE_DB_MAGIC	0x47525044	/* "GRPD" */
+#define ROM_PROFILE_DB_VERSION	1
+
+/**
+ * Entry key types.
+ * KEY_CRC32:  Key is the CRC32 of the ROM image.
+ * KEY_SERIAL: Key is the CRC32 of the first 11 characters of the
+ *             ROM header's serial number, e.g. "GM T-12056 ".
+ *             The serial number is also stored in the entry.
+ */
+typedef enum {
+	ROM_PROFILE_KEY_CRC32	= 0,
+	ROM_PROFILE_KEY_SERIAL	= 1,
+} RomProfileDB_Key_t;
+#define ROM_PROFILE_SERIAL_LEN	11
+
+/**
+ * Entry fields.
+ * Fields that aren't set use the emulator's defaults.
+ */
+#define ROM_PROFILE_FIELD_MAPPER		(1U << 0)
+#define ROM_PROFILE_FIELD_CHECKSUM		(1U << 1)
+#define ROM_PROFILE_FIELD_SRAM			(1U << 2)	/* sram_start, sram_end */
+#define ROM_PROFILE_FIELD_SRAM_OFF		(1U << 3)
+#define ROM_PROFILE_FIELD_REGISTERS_RO		(1U << 4)
+#define ROM_PROFILE_FIELD_EEPROM		(1U << 5)	/* eeprom_mode == 0: no EEPROM */
+#define ROM_PROFILE_FIELD_SPRITE_LIMITS		(1U << 8)
+#define ROM_PROFILE_FIELD_ZERO_LENGTH_DMA	(1U << 9)
+#define ROM_PROFILE_FIELD_IDLE_SKIP		(1U << 10)
+#define ROM_PROFILE_FIELD_RESAMPLER		(1U << 11)
+
+/**
+ * Boolean hints. (RomProfileDB_Entry_t.hints)
+ * Only valid if the corresponding field is set.
+ */
+#define ROM_PROFILE_HINT_SPRITE_LIMITS		(1U << 0)
+#define ROM_PROFILE_HINT_ZERO_LENGTH_DMA	(1U << 1)
+#define ROM_PROFILE_HINT_IDLE_SKIP		(1U << 2)
+#define ROM_PROFILE_HINT_RESAMPLER		(1U << 3)
+
+/** Mapper types. **/
+typedef enum {
+	ROM_PROFILE_MAPPER_FLAT		= 0,
+	ROM_PROFILE_MAPPER_SSF2		= 1,
+	ROM_PROFILE_MAPPER_REGISTERS_RO	= 2,
+	ROM_PROFILE_MAPPER_MAX
+} RomProfileDB_Mapper_t;
+
+/** Checksum types. **/
+typedef enum {
+	ROM_PROFILE_CHECKSUM_NONE	= 0,
+	ROM_PROFILE_CHECKSUM_SEGA	= 1,
+	ROM_PROFILE_CHECKSUM_MAX
+} RomProfileDB_Checksum_t;
+
+#pragma pack(1)
+typedef struct PACKED _RomProfileDB_Header_t {
+	uint32_t magic;		// 32BE: Should be "GRPD" (0x47525044)
+	uint32_t version;	// 32BE: Format version.
+	uint32_t revision;	// 32BE: Database revision, from the text sources.
+	uint32_t entry_count;	// 32BE: Number of entries.
+	uint32_t bucket_count;	// 32BE: Number of hash buckets. (power of two)
+	uint32_t entry_offset;	// 32BE: Offset of the entry table.
+	uint32_t bucket_offset;	// 32BE: Offset of the bucket table.
+	uint32_t file_size;	// 32BE: Total file size.
+} RomProfileDB_Header_t;
+
+typedef struct PACKED _RomProfileDB_Entry_t {
+	uint32_t key;		// 32BE: Key. (See RomProfileDB_Key_t.)
+	uint8_t key_type;	// RomProfileDB_Key_t
+	uint8_t mapper;		// RomProfileDB_Mapper_t
+	uint8_t checksum;	// RomProfileDB_Checksum_t
+	uint8_t eeprom_mode;	// EEPRomI2C::EEPRomMode_t (0 == none)
+	uint32_t fields;	// 32BE: ROM_PROFILE_FIELD_*
+	char serial[16];	// KEY_SERIAL: Serial number. (NULL-padded)
+	char title[48];		// Title, for reference. (NULL-terminated)
+
+	// SRAM.
+	uint32_t sram_start;	// 32BE
+	uint32_t sram_end;	// 32BE
+
+	// MAPPER_REGISTERS_RO.
+	uint32_t ro_addr_mask[4];	// 32BE
+	uint32_t ro_addr[4];		// 32BE
+	uint16_t ro_reg[4];		// 16BE
+
+	// EEPROM.
+	uint32_t eeprom_sda_in_adr;	// 32BE
+	uint32_t eeprom_sda_out_adr;	// 32BE
+	uint32_t eeprom_scl_adr;	// 32BE
+	uint16_t eeprom_sz_mask;	// 16BE
+	uint8_t eeprom_sda_in_bit;
+	uint8_t eeprom_sda_out_bit;
+	uint8_t eeprom_scl_bit;
+	uint8_t eeprom_dev_addr;
+	uint8_t eeprom_pg_mask;
+
+	uint8_t hints;		// ROM_PROFILE_HINT_*
+} RomProfileDB_Entry_t;
+#pragma pack()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LIBGENS_CARTRIDGE_ROM_PROFILE_DB_H__ */
@@ -0,0 +1,111 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * FastBlur.avx2.inc.cpp: Fast Blur effect. (AVX2-optimized.)              *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __IN_LIBGENS_FASTBLUR_CPP__
+#error FastBlur.avx2.inc.cpp should only be included by FastBlur.cpp.
+#endif
+
+#ifndef HAVE_AVX2_INTRIN
+#error FastBlur.avx2.inc.cpp should only be compiled if AVX2 intrinsics are available.
+#endif
+
+// AVX2 intrinsics.
+#include <immintrin.h>
+
+namespace LibGens {
+
+/**
+ * 15/16-bit color Fast Blur, AVX2-optimized.
+ * NOTE: outScreen and mdScreen may be the same buffer.
+ * @param outScreen	[out] Destination screen.
+ * @param mdScreen	[in]  Source screen.
+ * @param pxCount	[in]  Pixel count.
+ * @param mask		[in]  Division mask to use. (MASK_DIV2_15 or MASK_DIV2_16)
+ */
+FUNC_TARGET("avx2")
+void FastBlurPrivate::DoFastBlur_16_AVX2(
+	uint16_t *outScreen,
+	const uint16_t *mdScreen,
+	unsigned int pxCount,
+	uint16_t mask)
+{
+	const __m256i vMask = _mm256_set1_epi16((short)mask);
+
+	// Blur 16px at a time.
+	// Both source vectors are loaded before the destination
+	// is written, so this works in place.
+	// NOTE: This reads 1px over at the end of the buffer.
+	for (; pxCount >= 16; pxCount -= 16) {
+		__m256i px0 = _mm256_loadu_si256((const __m256i*)mdScreen);
+		__m256i px1 = _mm256_loadu_si256((const __m256i*)(mdScreen + 1));
+		px0 = _mm256_and_si256(_mm256_srli_epi16(px0, 1), vMask);
+		px1 = _mm256_and_si256(_mm256_srli_epi16(px1, 1), vMask);
+		_mm256_storeu_si256((__m256i*)outScreen, _mm256_add_epi16(px0, px1));
+
+		// Next group of pixels.
+		outScreen += 16;
+		mdScreen += 16;
+	}
+
+	// Remaining pixels.
+	for (; pxCount > 0; pxCount--, outScreen++, mdScreen++) {
+		*outScreen = ((mdScreen[0] >> 1) & mask) + ((mdScreen[1] >> 1) & mask);
+	}
+}
+
+/**
+ * 32-bit color Fast Blur, AVX2-optimized.
+ * NOTE: outScreen and mdScreen may be the same buffer.
+ * @param outScreen	[out] Destination screen.
+ * @param mdScreen	[in]  Source screen.
+ * @param pxCount	[in]  Pixel count.
+ */
+FUNC_TARGET("avx2")
+void FastBlurPrivate::DoFastBlur_32_AVX2(
+	uint32_t *outScreen,
+	const uint32_t *mdScreen,
+	unsigned int pxCount)
+{
+	const __m256i vMask = _mm256_set1_epi32(MASK_DIV2_32);
+
+	// Blur 8px at a time.
+	// Both source vectors are loaded before the destination
+	// is written, so this works in place.
+	// NOTE: This reads 1px over at the end of the buffer.
+	for (; pxCount >= 8; pxCount -= 8) {
+		__m256i px0 = _mm256_loadu_si256((const __m256i*)mdScreen);
+		__m256i px1 = _mm256_loadu_si256((const __m256i*)(mdScreen + 1));
+		px0 = _mm256_and_si256(_mm256_srli_epi32(px0, 1), vMask);
+		px1 = _mm256_and_si256(_mm256_srli_epi32(px1, 1), vMask);
+		_mm256_storeu_si256((__m256i*)outScreen, _mm256_add_epi32(px0, px1));
+
+		// Next group of pixels.
+		outScreen += 8;
+		mdScreen += 8;
+	}
+
+	// Remaining pixels.
+	for (; pxCount > 0; pxCount--, outScreen++, mdScreen++) {
+		*outScreen = ((mdScreen[0] >> 1) & MASK_DIV2_32) + ((mdScreen[1] >> 1) & MASK_DIV2_32);
+	}
+}
+
+}
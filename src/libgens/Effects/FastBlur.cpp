@@ -24,6 +24,7 @@
 #include "FastBlur.hpp"
 #include "Util/MdFb.hpp"
 #include "libcompat/cpuflags.h"
+#include "macros/simd.h"
 
 // C includes.
 #include <stdlib.h>
@@ -56,6 +57,7 @@ class FastBlurPrivate
 		// Mask constants.
 		static const uint16_t MASK_DIV2_15 = 0x3DEF;
 		static const uint16_t MASK_DIV2_16 = 0x7BCF;
+		static const uint32_t MASK_DIV2_32 = 0x007F7F7F;
 
 		static void DoFastBlur_16(
 			uint16_t* RESTRICT outScreen,
@@ -79,18 +81,6 @@ class FastBlurPrivate
 		static const uint32_t MASK_DIV2_15_MMX[2];
 		static const uint32_t MASK_DIV2_16_MMX[2];
 
-#if 0
-// FIXME: SSE2 Fast Blur is generally slow due to
-// unaligned access requirements.
-		static void DoFastBlur_32_SSE2(
-			uint32_t* RESTRICT outScreen,
-			unsigned int pxCount);
-		static void DoFastBlur_32_SSE2(
-			uint32_t* RESTRICT outScreen,
-			const uint32_t* RESTRICT mdScreen,
-			unsigned int pxCount);
-#endif
-
 		static void DoFastBlur_16_MMX(
 			uint16_t* RESTRICT outScreen,
 			unsigned int pxCount,
@@ -109,6 +99,86 @@ class FastBlurPrivate
 			const uint32_t* RESTRICT mdScreen,
 			unsigned int pxCount);
 #endif /* HAVE_MMX */
+
+		// Intrinsics versions.
+		// These handle both 1-FB and 2-FB, since they
+		// load the source pixels before writing.
+#ifdef HAVE_SSE2_INTRIN
+		static FUNC_TARGET("sse2") void DoFastBlur_16_SSE2(
+			uint16_t *outScreen,
+			const uint16_t *mdScreen,
+			unsigned int pxCount,
+			uint16_t mask);
+		static FUNC_TARGET("sse2") void DoFastBlur_32_SSE2(
+			uint32_t *outScreen,
+			const uint32_t *mdScreen,
+			unsigned int pxCount);
+#endif /* HAVE_SSE2_INTRIN */
+
+#ifdef HAVE_AVX2_INTRIN
+		static FUNC_TARGET("avx2") void DoFastBlur_16_AVX2(
+			uint16_t *outScreen,
+			const uint16_t *mdScreen,
+			unsigned int pxCount,
+			uint16_t mask);
+		static FUNC_TARGET("avx2") void DoFastBlur_32_AVX2(
+			uint32_t *outScreen,
+			const uint32_t *mdScreen,
+			unsigned int pxCount);
+#endif /* HAVE_AVX2_INTRIN */
+
+#ifdef HAVE_NEON_INTRIN
+		static void DoFastBlur_16_NEON(
+			uint16_t *outScreen,
+			const uint16_t *mdScreen,
+			unsigned int pxCount,
+			uint16_t mask);
+		static void DoFastBlur_32_NEON(
+			uint32_t *outScreen,
+			const uint32_t *mdScreen,
+			unsigned int pxCount);
+#endif /* HAVE_NEON_INTRIN */
+
+		/**
+		 * Use SSE2 on this CPU?
+		 * SSE2 is skipped if it's known to be slow.
+		 * @return True if SSE2 should be used.
+		 */
+		static inline bool useSSE2(void)
+		{
+#ifdef HAVE_SSE2_INTRIN
+			return ((CPU_Flags & (MDP_CPUFLAG_X86_SSE2 | MDP_CPUFLAG_X86_SSE2SLOW))
+				== MDP_CPUFLAG_X86_SSE2);
+#else
+			return false;
+#endif
+		}
+
+		/**
+		 * Apply Fast Blur. (15/16-bit)
+		 * Selects the best implementation for the current CPU.
+		 * @param outScreen [out] Destination screen.
+		 * @param mdScreen  [in]  Source screen, or nullptr for 1-FB.
+		 * @param pxCount   [in]  Pixel count.
+		 * @param mask      [in]  Division mask to use. (MASK_DIV2_15 or MASK_DIV2_16)
+		 */
+		static void DoFastBlur_16_dispatch(
+			uint16_t *outScreen,
+			const uint16_t *mdScreen,
+			unsigned int pxCount,
+			uint16_t mask);
+
+		/**
+		 * Apply Fast Blur. (32-bit)
+		 * Selects the best implementation for the current CPU.
+		 * @param outScreen [out] Destination screen.
+		 * @param mdScreen  [in]  Source screen, or nullptr for 1-FB.
+		 * @param pxCount   [in]  Pixel count.
+		 */
+		static void DoFastBlur_32_dispatch(
+			uint32_t *outScreen,
+			const uint32_t *mdScreen,
+			unsigned int pxCount);
 };
 
 #ifdef HAVE_MMX
@@ -137,8 +207,123 @@ const uint32_t FastBlurPrivate::MASK_DIV2_16_MMX[2] = {0x7BCF7BCF, 0x7BCF7BCF};
 #undef DO_2FB
 #endif /* HAVE_MMX */
 
+// Intrinsics versions.
+#ifdef HAVE_SSE2_INTRIN
+#include "FastBlur.sse2.inc.cpp"
+#endif
+#ifdef HAVE_AVX2_INTRIN
+#include "FastBlur.avx2.inc.cpp"
+#endif
+#ifdef HAVE_NEON_INTRIN
+#include "FastBlur.neon.inc.cpp"
+#endif
+
 namespace LibGens {
 
+/**
+ * Apply Fast Blur. (15/16-bit)
+ * Selects the best implementation for the current CPU.
+ * @param outScreen [out] Destination screen.
+ * @param mdScreen  [in]  Source screen, or nullptr for 1-FB.
+ * @param pxCount   [in]  Pixel count.
+ * @param mask      [in]  Division mask to use. (MASK_DIV2_15 or MASK_DIV2_16)
+ */
+void FastBlurPrivate::DoFastBlur_16_dispatch(
+	uint16_t *outScreen,
+	const uint16_t *mdScreen,
+	unsigned int pxCount,
+	uint16_t mask)
+{
+#ifdef HAVE_AVX2_INTRIN
+	if (CPU_Flags & MDP_CPUFLAG_X86_AVX2) {
+		DoFastBlur_16_AVX2(outScreen,
+			(mdScreen ? mdScreen : outScreen), pxCount, mask);
+		return;
+	}
+#endif /* HAVE_AVX2_INTRIN */
+#ifdef HAVE_SSE2_INTRIN
+	if (useSSE2()) {
+		DoFastBlur_16_SSE2(outScreen,
+			(mdScreen ? mdScreen : outScreen), pxCount, mask);
+		return;
+	}
+#endif /* HAVE_SSE2_INTRIN */
+#ifdef HAVE_NEON_INTRIN
+	DoFastBlur_16_NEON(outScreen,
+		(mdScreen ? mdScreen : outScreen), pxCount, mask);
+	return;
+#endif /* HAVE_NEON_INTRIN */
+
+#ifdef HAVE_MMX
+	if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
+		const uint32_t *const maskMMX = (mask == MASK_DIV2_15
+				? MASK_DIV2_15_MMX : MASK_DIV2_16_MMX);
+		if (mdScreen) {
+			DoFastBlur_16_MMX(outScreen, mdScreen, pxCount, maskMMX);
+		} else {
+			DoFastBlur_16_MMX(outScreen, pxCount, maskMMX);
+		}
+		return;
+	}
+#endif /* HAVE_MMX */
+
+	if (mdScreen) {
+		DoFastBlur_16(outScreen, mdScreen, pxCount, mask);
+	} else {
+		DoFastBlur_16(outScreen, pxCount, mask);
+	}
+}
+
+/**
+ * Apply Fast Blur. (32-bit)
+ * Selects the best implementation for the current CPU.
+ * @param outScreen [out] Destination screen.
+ * @param mdScreen  [in]  Source screen, or nullptr for 1-FB.
+ * @param pxCount   [in]  Pixel count.
+ */
+void FastBlurPrivate::DoFastBlur_32_dispatch(
+	uint32_t *outScreen,
+	const uint32_t *mdScreen,
+	unsigned int pxCount)
+{
+#ifdef HAVE_AVX2_INTRIN
+	if (CPU_Flags & MDP_CPUFLAG_X86_AVX2) {
+		DoFastBlur_32_AVX2(outScreen,
+			(mdScreen ? mdScreen : outScreen), pxCount);
+		return;
+	}
+#endif /* HAVE_AVX2_INTRIN */
+#ifdef HAVE_SSE2_INTRIN
+	if (useSSE2()) {
+		DoFastBlur_32_SSE2(outScreen,
+			(mdScreen ? mdScreen : outScreen), pxCount);
+		return;
+	}
+#endif /* HAVE_SSE2_INTRIN */
+#ifdef HAVE_NEON_INTRIN
+	DoFastBlur_32_NEON(outScreen,
+		(mdScreen ? mdScreen : outScreen), pxCount);
+	return;
+#endif /* HAVE_NEON_INTRIN */
+
+#ifdef HAVE_MMX
+	if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
+		if (mdScreen) {
+			DoFastBlur_32_MMX(outScreen, mdScreen, pxCount);
+		} else {
+			DoFastBlur_32_MMX(outScreen, pxCount);
+		}
+		return;
+	}
+#endif /* HAVE_MMX */
+
+	if (mdScreen) {
+		DoFastBlur_32(outScreen, mdScreen, pxCount);
+	} else {
+		DoFastBlur_32(outScreen, pxCount);
+	}
+}
+
 /**
  * Apply a Fast Blur effect to the screen buffer.
  * @param outScreen Source and destination screen.
@@ -151,47 +336,21 @@ void FastBlur::DoFastBlur(MdFb* RESTRICT outScreen)
 
 	switch (outScreen->bpp()) {
 		case MdFb::BPP_15:
-#ifdef HAVE_MMX
-			if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
-				FastBlurPrivate::DoFastBlur_16_MMX(
-					outScreen->fb16(), pxCount,
-					FastBlurPrivate::MASK_DIV2_15_MMX);
-			} else
-#endif /* HAVE_MMX */
-			{
-				FastBlurPrivate::DoFastBlur_16(
-					outScreen->fb16(), pxCount,
-					FastBlurPrivate::MASK_DIV2_15);
-			}
+			FastBlurPrivate::DoFastBlur_16_dispatch(
+				outScreen->fb16(), nullptr, pxCount,
+				FastBlurPrivate::MASK_DIV2_15);
 			break;
 
 		case MdFb::BPP_16:
-#ifdef HAVE_MMX
-			if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
-				FastBlurPrivate::DoFastBlur_16_MMX(
-					outScreen->fb16(), pxCount,
-					FastBlurPrivate::MASK_DIV2_16_MMX);
-			} else
-#endif /* HAVE_MMX */
-			{
-				FastBlurPrivate::DoFastBlur_16(
-					outScreen->fb16(), pxCount,
-					FastBlurPrivate::MASK_DIV2_16);
-			}
+			FastBlurPrivate::DoFastBlur_16_dispatch(
+				outScreen->fb16(), nullptr, pxCount,
+				FastBlurPrivate::MASK_DIV2_16);
 			break;
 
 		case MdFb::BPP_32:
 		default:
-#ifdef HAVE_MMX
-			if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
-				FastBlurPrivate::DoFastBlur_32_MMX(
-					outScreen->fb32(), pxCount);
-			} else
-#endif /* HAVE_MMX */
-			{
-				FastBlurPrivate::DoFastBlur_32(
-					outScreen->fb32(), pxCount);
-			}
+			FastBlurPrivate::DoFastBlur_32_dispatch(
+				outScreen->fb32(), nullptr, pxCount);
 			break;
 	}
 
@@ -219,47 +378,21 @@ void FastBlur::DoFastBlur(MdFb* RESTRICT outScreen, const MdFb* RESTRICT mdScree
 
 	switch (outScreen->bpp()) {
 		case MdFb::BPP_15:
-#ifdef HAVE_MMX
-			if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
-				FastBlurPrivate::DoFastBlur_16_MMX(
-					outScreen->fb16(), mdScreen->fb16(), pxCount,
-					FastBlurPrivate::MASK_DIV2_15_MMX);
-			} else
-#endif /* HAVE_MMX */
-			{
-				FastBlurPrivate::DoFastBlur_16(
-					outScreen->fb16(), mdScreen->fb16(),
-					pxCount, FastBlurPrivate::MASK_DIV2_15);
-			}
+			FastBlurPrivate::DoFastBlur_16_dispatch(
+				outScreen->fb16(), mdScreen->fb16(), pxCount,
+				FastBlurPrivate::MASK_DIV2_15);
 			break;
 
 		case MdFb::BPP_16:
-#ifdef HAVE_MMX
-			if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
-				FastBlurPrivate::DoFastBlur_16_MMX(
-					outScreen->fb16(), mdScreen->fb16(), pxCount,
-					FastBlurPrivate::MASK_DIV2_16_MMX);
-			} else
-#endif /* HAVE_MMX */
-			{
-				FastBlurPrivate::DoFastBlur_16(
-					outScreen->fb16(), mdScreen->fb16(),
-					pxCount, FastBlurPrivate::MASK_DIV2_16);
-			}
+			FastBlurPrivate::DoFastBlur_16_dispatch(
+				outScreen->fb16(), mdScreen->fb16(), pxCount,
+				FastBlurPrivate::MASK_DIV2_16);
 			break;
 
 		case MdFb::BPP_32:
 		default:
-#ifdef HAVE_MMX
-			if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
-				FastBlurPrivate::DoFastBlur_32_MMX(
-					outScreen->fb32(), mdScreen->fb32(), pxCount);
-			}
-#endif /* HAVE_MMX */
-			{
-				FastBlurPrivate::DoFastBlur_32(
-					outScreen->fb32(), mdScreen->fb32(), pxCount);
-			}
+			FastBlurPrivate::DoFastBlur_32_dispatch(
+				outScreen->fb32(), mdScreen->fb32(), pxCount);
 			break;
 	}
 
@@ -268,4 +401,42 @@ void FastBlur::DoFastBlur(MdFb* RESTRICT outScreen, const MdFb* RESTRICT mdScree
 	mdScreen->unref();
 }
 
+/**
+ * Apply a Fast Blur effect to a raw screen buffer.
+ * This is used to render into buffers that aren't MdFbs,
+ * e.g. a mapped OpenGL pixel buffer object.
+ * @param outBuf Destination buffer.
+ * @param mdBuf Source buffer. (If nullptr or outBuf, the effect is applied in place.)
+ * @param bpp Color depth.
+ * @param pxCount Pixel count.
+ */
+void FastBlur::DoFastBlur(void *outBuf, const void *mdBuf,
+			  MdFb::ColorDepth bpp, unsigned int pxCount)
+{
+	if (mdBuf == outBuf) {
+		// In-place operation.
+		mdBuf = nullptr;
+	}
+
+	switch (bpp) {
+		case MdFb::BPP_15:
+			FastBlurPrivate::DoFastBlur_16_dispatch(
+				(uint16_t*)outBuf, (const uint16_t*)mdBuf, pxCount,
+				FastBlurPrivate::MASK_DIV2_15);
+			break;
+
+		case MdFb::BPP_16:
+			FastBlurPrivate::DoFastBlur_16_dispatch(
+				(uint16_t*)outBuf, (const uint16_t*)mdBuf, pxCount,
+				FastBlurPrivate::MASK_DIV2_16);
+			break;
+
+		case MdFb::BPP_32:
+		default:
+			FastBlurPrivate::DoFastBlur_32_dispatch(
+				(uint32_t*)outBuf, (const uint32_t*)mdBuf, pxCount);
+			break;
+	}
+}
+
 }
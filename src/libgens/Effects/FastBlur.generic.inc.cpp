@@ -98,7 +98,6 @@ void FastBlurPrivate::DoFastBlur_32(
 #endif
 	unsigned int pxCount)
 {
-	static const uint32_t MASK_DIV2_32 = 0x007F7F7F;
 	uint32_t px, px_prev;
 
 	// Read the first pixel as the previous pixel
@@ -40,16 +40,28 @@
 
 #include <stdint.h>
 
-namespace LibGens {
+#include "../Util/MdFb.hpp"
 
-class MdFb;
+namespace LibGens {
 
 class FastBlur
 {
 	public:
 		static void DoFastBlur(MdFb* RESTRICT outScreen);
 		static void DoFastBlur(MdFb* RESTRICT outScreen, const MdFb* RESTRICT mdScreen);
-	
+
+		/**
+		 * Apply a Fast Blur effect to a raw screen buffer.
+		 * This is used to render into buffers that aren't MdFbs,
+		 * e.g. a mapped OpenGL pixel buffer object.
+		 * @param outBuf Destination buffer.
+		 * @param mdBuf Source buffer. (If nullptr or outBuf, the effect is applied in place.)
+		 * @param bpp Color depth.
+		 * @param pxCount Pixel count.
+		 */
+		static void DoFastBlur(void *outBuf, const void *mdBuf,
+				       MdFb::ColorDepth bpp, unsigned int pxCount);
+
 	private:
 		FastBlur() { }
 		~FastBlur() { }
@@ -0,0 +1,109 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * FastBlur.neon.inc.cpp: Fast Blur effect. (NEON-optimized.)              *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __IN_LIBGENS_FASTBLUR_CPP__
+#error FastBlur.neon.inc.cpp should only be included by FastBlur.cpp.
+#endif
+
+#ifndef HAVE_NEON_INTRIN
+#error FastBlur.neon.inc.cpp should only be compiled if NEON intrinsics are available.
+#endif
+
+// NEON intrinsics.
+#include <arm_neon.h>
+
+namespace LibGens {
+
+/**
+ * 15/16-bit color Fast Blur, NEON-optimized.
+ * NOTE: outScreen and mdScreen may be the same buffer.
+ * @param outScreen	[out] Destination screen.
+ * @param mdScreen	[in]  Source screen.
+ * @param pxCount	[in]  Pixel count.
+ * @param mask		[in]  Division mask to use. (MASK_DIV2_15 or MASK_DIV2_16)
+ */
+void FastBlurPrivate::DoFastBlur_16_NEON(
+	uint16_t *outScreen,
+	const uint16_t *mdScreen,
+	unsigned int pxCount,
+	uint16_t mask)
+{
+	const uint16x8_t vMask = vdupq_n_u16(mask);
+
+	// Blur 8px at a time.
+	// Both source vectors are loaded before the destination
+	// is written, so this works in place.
+	// NOTE: This reads 1px over at the end of the buffer.
+	for (; pxCount >= 8; pxCount -= 8) {
+		uint16x8_t px0 = vld1q_u16(mdScreen);
+		uint16x8_t px1 = vld1q_u16(mdScreen + 1);
+		px0 = vandq_u16(vshrq_n_u16(px0, 1), vMask);
+		px1 = vandq_u16(vshrq_n_u16(px1, 1), vMask);
+		vst1q_u16(outScreen, vaddq_u16(px0, px1));
+
+		// Next group of pixels.
+		outScreen += 8;
+		mdScreen += 8;
+	}
+
+	// Remaining pixels.
+	for (; pxCount > 0; pxCount--, outScreen++, mdScreen++) {
+		*outScreen = ((mdScreen[0] >> 1) & mask) + ((mdScreen[1] >> 1) & mask);
+	}
+}
+
+/**
+ * 32-bit color Fast Blur, NEON-optimized.
+ * NOTE: outScreen and mdScreen may be the same buffer.
+ * @param outScreen	[out] Destination screen.
+ * @param mdScreen	[in]  Source screen.
+ * @param pxCount	[in]  Pixel count.
+ */
+void FastBlurPrivate::DoFastBlur_32_NEON(
+	uint32_t *outScreen,
+	const uint32_t *mdScreen,
+	unsigned int pxCount)
+{
+	const uint32x4_t vMask = vdupq_n_u32(MASK_DIV2_32);
+
+	// Blur 4px at a time.
+	// Both source vectors are loaded before the destination
+	// is written, so this works in place.
+	// NOTE: This reads 1px over at the end of the buffer.
+	for (; pxCount >= 4; pxCount -= 4) {
+		uint32x4_t px0 = vld1q_u32(mdScreen);
+		uint32x4_t px1 = vld1q_u32(mdScreen + 1);
+		px0 = vandq_u32(vshrq_n_u32(px0, 1), vMask);
+		px1 = vandq_u32(vshrq_n_u32(px1, 1), vMask);
+		vst1q_u32(outScreen, vaddq_u32(px0, px1));
+
+		// Next group of pixels.
+		outScreen += 4;
+		mdScreen += 4;
+	}
+
+	// Remaining pixels.
+	for (; pxCount > 0; pxCount--, outScreen++, mdScreen++) {
+		*outScreen = ((mdScreen[0] >> 1) & MASK_DIV2_32) + ((mdScreen[1] >> 1) & MASK_DIV2_32);
+	}
+}
+
+}
@@ -0,0 +1,168 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * PausedEffect.avx2.inc.cpp: "Paused" effect. (AVX2-optimized.)           *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __IN_LIBGENS_PAUSEDEFFECT_CPP__
+#error PausedEffect.avx2.inc.cpp should only be included by PausedEffect.cpp.
+#endif
+
+#ifndef HAVE_AVX2_INTRIN
+#error PausedEffect.avx2.inc.cpp should only be compiled if AVX2 intrinsics are available.
+#endif
+
+// AVX2 intrinsics.
+#include <immintrin.h>
+
+namespace LibGens {
+
+/**
+ * Tint 16 pixels a purple hue. (15/16-bit color, AVX2)
+ * This matches T_DoPausedEffect() exactly.
+ * @param RBits Number of bits for Red.
+ * @param GBits Number of bits for Green.
+ * @param BBits Number of bits for Blue.
+ * @param px Source pixels.
+ * @return Tinted pixels.
+ */
+template<uint8_t RBits, uint8_t GBits, uint8_t BBits>
+static FUNC_TARGET("avx2") inline __m256i T_PausedPx16_AVX2(__m256i px)
+{
+	// Get the color components, expanded to 8 bits.
+	const __m256i r = _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(px, GBits + BBits),
+		_mm256_set1_epi16(MMASK(RBits))), 8 - RBits);
+	const __m256i g = _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(px, BBits),
+		_mm256_set1_epi16(MMASK(GBits))), 8 - GBits);
+	const __m256i b = _mm256_slli_epi16(_mm256_and_si256(px,
+		_mm256_set1_epi16(MMASK(BBits))), 8 - BBits);
+
+	// Integer grayscale vector: [0x4D, 0x96, 0x1D]
+	// The sum is always less than 65536, so 16-bit
+	// wraparound arithmetic gives the exact result.
+	__m256i mono = _mm256_mullo_epi16(r, _mm256_set1_epi16(0x4D));
+	mono = _mm256_add_epi16(mono, _mm256_mullo_epi16(g, _mm256_set1_epi16(0x96)));
+	mono = _mm256_add_epi16(mono, _mm256_mullo_epi16(b, _mm256_set1_epi16(0x1D)));
+	mono = _mm256_srli_epi16(mono, 8);
+
+	// Double the blue component to tint the image.
+	const __m256i nB = _mm256_min_epi16(_mm256_add_epi16(mono, mono), _mm256_set1_epi16(0xFF));
+
+	// Pack the new pixels.
+	return _mm256_or_si256(_mm256_or_si256(
+		_mm256_slli_epi16(_mm256_srli_epi16(mono, 8 - RBits), GBits + BBits),
+		_mm256_slli_epi16(_mm256_srli_epi16(mono, 8 - GBits), BBits)),
+		_mm256_srli_epi16(nB, 8 - BBits));
+}
+
+/**
+ * Tint the screen a purple hue to indicate that emulation is paused.
+ * (15/16-bit color, AVX2-optimized.)
+ * NOTE: outScreen and mdScreen may be the same buffer.
+ * @param RBits Number of bits for Red.
+ * @param GBits Number of bits for Green.
+ * @param BBits Number of bits for Blue.
+ * @param outScreen Pointer to the destination screen buffer.
+ * @param mdScreen Pointer to the source screen buffer.
+ * @param pxCount Pixel count.
+ */
+template<uint8_t RBits, uint8_t GBits, uint8_t BBits>
+FUNC_TARGET("avx2")
+void PausedEffectPrivate::T_DoPausedEffect_16_AVX2(
+	uint16_t *outScreen,
+	const uint16_t *mdScreen,
+	unsigned int pxCount)
+{
+	// Process 16px at a time.
+	for (; pxCount >= 16; pxCount -= 16) {
+		const __m256i px = _mm256_loadu_si256((const __m256i*)mdScreen);
+		_mm256_storeu_si256((__m256i*)outScreen, T_PausedPx16_AVX2<RBits, GBits, BBits>(px));
+
+		// Next group of pixels.
+		outScreen += 16;
+		mdScreen += 16;
+	}
+
+	if (pxCount > 0) {
+		// Remaining pixels.
+		uint16_t tmp[16] = {0};
+		memcpy(tmp, mdScreen, pxCount * sizeof(uint16_t));
+		const __m256i px = _mm256_loadu_si256((const __m256i*)tmp);
+		_mm256_storeu_si256((__m256i*)tmp, T_PausedPx16_AVX2<RBits, GBits, BBits>(px));
+		memcpy(outScreen, tmp, pxCount * sizeof(uint16_t));
+	}
+}
+
+/**
+ * Tint the screen a purple hue to indicate that emulation is paused.
+ * (32-bit color, AVX2-optimized.)
+ * NOTE: outScreen and mdScreen may be the same buffer.
+ * @param outScreen Pointer to the destination screen buffer.
+ * @param mdScreen Pointer to the source screen buffer.
+ * @param pxCount Pixel count.
+ */
+FUNC_TARGET("avx2")
+void PausedEffectPrivate::DoPausedEffect_32_AVX2(
+	uint32_t *outScreen,
+	const uint32_t *mdScreen,
+	unsigned int pxCount)
+{
+	// Integer grayscale vector: [0x4D, 0x96, 0x1D]
+	// R and B are multiplied together using pmaddwd,
+	// with B in the low word and R in the high word.
+	const __m256i maskRB = _mm256_set1_epi32(0x00FF00FF);
+	const __m256i maskG = _mm256_set1_epi32(0x000000FF);
+	const __m256i mulRB = _mm256_set1_epi32(0x004D001D);
+	const __m256i mulG = _mm256_set1_epi32(0x00000096);
+
+	// Process 8px at a time.
+	for (; pxCount >= 8; pxCount -= 8) {
+		const __m256i px = _mm256_loadu_si256((const __m256i*)mdScreen);
+		const __m256i rb = _mm256_and_si256(px, maskRB);
+		const __m256i g = _mm256_and_si256(_mm256_srli_epi32(px, 8), maskG);
+		__m256i mono = _mm256_add_epi32(_mm256_madd_epi16(rb, mulRB),
+						_mm256_madd_epi16(g, mulG));
+		mono = _mm256_srli_epi32(mono, 8);
+
+		// Double the blue component to tint the image.
+		// NOTE: The high word of each pixel is 0, so a
+		// 16-bit minimum works here.
+		const __m256i nB = _mm256_min_epi16(_mm256_add_epi32(mono, mono), maskG);
+
+		// Put the new pixels.
+		_mm256_storeu_si256((__m256i*)outScreen, _mm256_or_si256(
+			_mm256_or_si256(_mm256_slli_epi32(mono, 16), _mm256_slli_epi32(mono, 8)), nB));
+
+		// Next group of pixels.
+		outScreen += 8;
+		mdScreen += 8;
+	}
+
+	// Remaining pixels.
+	for (; pxCount > 0; pxCount--) {
+		const uint32_t px = *mdScreen++;
+		unsigned int mono = (((px >> 16) & 0xFF) * 0x4D) +
+				    (((px >> 8) & 0xFF) * 0x96) +
+				    ((px & 0xFF) * 0x1D);
+		mono >>= 8;
+		const unsigned int nB = (mono < 0x80 ? (mono << 1) : 0xFF);
+		*outScreen++ = (mono << 16) | (mono << 8) | nB;
+	}
+}
+
+}
@@ -45,6 +45,10 @@
 
 // CPU flags.
 #include "libcompat/cpuflags.h"
+#include "macros/simd.h"
+
+// Mask with the specified number of bits set.
+#define MMASK(bits) ((1 << (bits)) - 1)
 
 #if defined(__GNUC__) && (defined(__i386__) || defined(__amd64__) || defined(__x86_64__))
 #define HAVE_MMX 1
@@ -95,13 +99,78 @@ class PausedEffectPrivate
 			const uint32_t* RESTRICT mdScreen,
 			unsigned int pxCount);
 #endif
+
+		// Intrinsics versions.
+		// These handle both 1-FB and 2-FB, since each
+		// pixel is read before it's written.
+#ifdef HAVE_SSE2_INTRIN
+		template<uint8_t RBits, uint8_t GBits, uint8_t BBits>
+		static FUNC_TARGET("sse2") void T_DoPausedEffect_16_SSE2(
+			uint16_t *outScreen,
+			const uint16_t *mdScreen,
+			unsigned int pxCount);
+#endif /* HAVE_SSE2_INTRIN */
+
+#ifdef HAVE_AVX2_INTRIN
+		template<uint8_t RBits, uint8_t GBits, uint8_t BBits>
+		static FUNC_TARGET("avx2") void T_DoPausedEffect_16_AVX2(
+			uint16_t *outScreen,
+			const uint16_t *mdScreen,
+			unsigned int pxCount);
+
+		static FUNC_TARGET("avx2") void DoPausedEffect_32_AVX2(
+			uint32_t *outScreen,
+			const uint32_t *mdScreen,
+			unsigned int pxCount);
+#endif /* HAVE_AVX2_INTRIN */
+
+#ifdef HAVE_NEON_INTRIN
+		template<uint8_t RBits, uint8_t GBits, uint8_t BBits>
+		static void T_DoPausedEffect_16_NEON(
+			uint16_t *outScreen,
+			const uint16_t *mdScreen,
+			unsigned int pxCount);
+
+		static void DoPausedEffect_32_NEON(
+			uint32_t *outScreen,
+			const uint32_t *mdScreen,
+			unsigned int pxCount);
+#endif /* HAVE_NEON_INTRIN */
+
+		/**
+		 * Tint the screen a purple hue. (15/16-bit color)
+		 * Selects the best implementation for the current CPU.
+		 * @param RBits Number of bits for Red.
+		 * @param GBits Number of bits for Green.
+		 * @param BBits Number of bits for Blue.
+		 * @param outScreen Pointer to the destination screen buffer.
+		 * @param mdScreen Pointer to the source screen buffer, or nullptr for 1-FB.
+		 * @param pxCount Pixel count.
+		 */
+		template<uint8_t RBits, uint8_t GBits, uint8_t BBits>
+		static void T_DoPausedEffect_16_dispatch(
+			uint16_t *outScreen,
+			const uint16_t *mdScreen,
+			unsigned int pxCount);
+
+		/**
+		 * Tint the screen a purple hue. (32-bit color)
+		 * Selects the best implementation for the current CPU.
+		 * @param outScreen Pointer to the destination screen buffer.
+		 * @param mdScreen Pointer to the source screen buffer, or nullptr for 1-FB.
+		 * @param pxCount Pixel count.
+		 */
+		static void DoPausedEffect_32_dispatch(
+			uint32_t *outScreen,
+			const uint32_t *mdScreen,
+			unsigned int pxCount);
 };
 
 }
 
+#define __IN_LIBGENS_PAUSEDEFFECT_CPP__
 #if defined(HAVE_MMX)
 // MMX/SSE2-optimized functions.
-#define __IN_LIBGENS_PAUSEDEFFECT_CPP__
 #define DO_1FB
 #include "PausedEffect.x86.inc.cpp"
 #undef DO_1FB
@@ -110,9 +179,18 @@ class PausedEffectPrivate
 #undef DO_2FB
 #endif
 
-namespace LibGens {
+// Intrinsics versions.
+#ifdef HAVE_SSE2_INTRIN
+#include "PausedEffect.sse2.inc.cpp"
+#endif
+#ifdef HAVE_AVX2_INTRIN
+#include "PausedEffect.avx2.inc.cpp"
+#endif
+#ifdef HAVE_NEON_INTRIN
+#include "PausedEffect.neon.inc.cpp"
+#endif
 
-#define MMASK(bits) ((1 << (bits)) - 1)
+namespace LibGens {
 
 // TODO: Use an include file for the C++ version,
 // using DO_1FB and DO_2FB?
@@ -228,6 +306,98 @@ inline void PausedEffectPrivate::T_DoPausedEffect(
 	}
 }
 
+/**
+ * Tint the screen a purple hue. (15/16-bit color)
+ * Selects the best implementation for the current CPU.
+ * @param RBits Number of bits for Red.
+ * @param GBits Number of bits for Green.
+ * @param BBits Number of bits for Blue.
+ * @param outScreen Pointer to the destination screen buffer.
+ * @param mdScreen Pointer to the source screen buffer, or nullptr for 1-FB.
+ * @param pxCount Pixel count.
+ */
+template<uint8_t RBits, uint8_t GBits, uint8_t BBits>
+void PausedEffectPrivate::T_DoPausedEffect_16_dispatch(
+	uint16_t *outScreen,
+	const uint16_t *mdScreen,
+	unsigned int pxCount)
+{
+#ifdef HAVE_AVX2_INTRIN
+	if (CPU_Flags & MDP_CPUFLAG_X86_AVX2) {
+		T_DoPausedEffect_16_AVX2<RBits, GBits, BBits>(outScreen,
+			(mdScreen ? mdScreen : outScreen), pxCount);
+		return;
+	}
+#endif /* HAVE_AVX2_INTRIN */
+#ifdef HAVE_SSE2_INTRIN
+	if (CPU_Flags & MDP_CPUFLAG_X86_SSE2) {
+		T_DoPausedEffect_16_SSE2<RBits, GBits, BBits>(outScreen,
+			(mdScreen ? mdScreen : outScreen), pxCount);
+		return;
+	}
+#endif /* HAVE_SSE2_INTRIN */
+#ifdef HAVE_NEON_INTRIN
+	T_DoPausedEffect_16_NEON<RBits, GBits, BBits>(outScreen,
+		(mdScreen ? mdScreen : outScreen), pxCount);
+	return;
+#endif /* HAVE_NEON_INTRIN */
+
+	if (mdScreen) {
+		T_DoPausedEffect<uint16_t, RBits, GBits, BBits>(outScreen, mdScreen, pxCount);
+	} else {
+		T_DoPausedEffect<uint16_t, RBits, GBits, BBits>(outScreen, pxCount);
+	}
+}
+
+/**
+ * Tint the screen a purple hue. (32-bit color)
+ * Selects the best implementation for the current CPU.
+ * @param outScreen Pointer to the destination screen buffer.
+ * @param mdScreen Pointer to the source screen buffer, or nullptr for 1-FB.
+ * @param pxCount Pixel count.
+ */
+void PausedEffectPrivate::DoPausedEffect_32_dispatch(
+	uint32_t *outScreen,
+	const uint32_t *mdScreen,
+	unsigned int pxCount)
+{
+#ifdef HAVE_AVX2_INTRIN
+	if (CPU_Flags & MDP_CPUFLAG_X86_AVX2) {
+		DoPausedEffect_32_AVX2(outScreen,
+			(mdScreen ? mdScreen : outScreen), pxCount);
+		return;
+	}
+#endif /* HAVE_AVX2_INTRIN */
+#ifdef HAVE_MMX
+	if (CPU_Flags & MDP_CPUFLAG_X86_SSE2) {
+		if (mdScreen) {
+			DoPausedEffect_32_SSE2(outScreen, mdScreen, pxCount);
+		} else {
+			DoPausedEffect_32_SSE2(outScreen, pxCount);
+		}
+		return;
+	} else if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
+		if (mdScreen) {
+			DoPausedEffect_32_MMX(outScreen, mdScreen, pxCount);
+		} else {
+			DoPausedEffect_32_MMX(outScreen, pxCount);
+		}
+		return;
+	}
+#endif /* HAVE_MMX */
+#ifdef HAVE_NEON_INTRIN
+	DoPausedEffect_32_NEON(outScreen,
+		(mdScreen ? mdScreen : outScreen), pxCount);
+	return;
+#endif /* HAVE_NEON_INTRIN */
+
+	if (mdScreen) {
+		T_DoPausedEffect<uint32_t, 8, 8, 8>(outScreen, mdScreen, pxCount);
+	} else {
+		T_DoPausedEffect<uint32_t, 8, 8, 8>(outScreen, pxCount);
+	}
+}
+
 /**
  * Tint the screen a purple hue to indicate that emulation is paused.
  * @param outScreen Source and destination screen.
@@ -241,28 +411,17 @@ void PausedEffect::DoPausedEffect(MdFb *outScreen)
 	// Render to outScreen.
 	switch (outScreen->bpp()) {
 		case MdFb::BPP_15:
-			PausedEffectPrivate::T_DoPausedEffect<uint16_t, 5, 5, 5>
-				(outScreen->fb16(), pxCount);
+			PausedEffectPrivate::T_DoPausedEffect_16_dispatch<5, 5, 5>
+				(outScreen->fb16(), nullptr, pxCount);
 			break;
 		case MdFb::BPP_16:
-			PausedEffectPrivate::T_DoPausedEffect<uint16_t, 5, 6, 5>
-				(outScreen->fb16(), pxCount);
+			PausedEffectPrivate::T_DoPausedEffect_16_dispatch<5, 6, 5>
+				(outScreen->fb16(), nullptr, pxCount);
 			break;
 		case MdFb::BPP_32:
 		default:
-#ifdef HAVE_MMX
-			if (CPU_Flags & MDP_CPUFLAG_X86_SSE2) {
-				PausedEffectPrivate::DoPausedEffect_32_SSE2(
-					outScreen->fb32(), pxCount);
-			} else if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
-				PausedEffectPrivate::DoPausedEffect_32_MMX(
-					outScreen->fb32(), pxCount);
-			} else
-#endif /* HAVE_MMX */
-			{
-				PausedEffectPrivate::T_DoPausedEffect<uint32_t, 8, 8, 8>
-					(outScreen->fb32(), pxCount);
-			}
+			PausedEffectPrivate::DoPausedEffect_32_dispatch
+				(outScreen->fb32(), nullptr, pxCount);
 			break;
 	}
 
@@ -291,28 +450,17 @@ void PausedEffect::DoPausedEffect(MdFb* RESTRICT outScreen, const MdFb* RESTRICT
 	// Render to outScreen.
 	switch (outScreen->bpp()) {
 		case MdFb::BPP_15:
-			PausedEffectPrivate::T_DoPausedEffect<uint16_t, 5, 5, 5>
+			PausedEffectPrivate::T_DoPausedEffect_16_dispatch<5, 5, 5>
 				(outScreen->fb16(), mdScreen->fb16(), pxCount);
 			break;
 		case MdFb::BPP_16:
-			PausedEffectPrivate::T_DoPausedEffect<uint16_t, 5, 6, 5>
+			PausedEffectPrivate::T_DoPausedEffect_16_dispatch<5, 6, 5>
 				(outScreen->fb16(), mdScreen->fb16(), pxCount);
 			break;
 		case MdFb::BPP_32:
 		default:
-#ifdef HAVE_MMX
-			if (CPU_Flags & MDP_CPUFLAG_X86_SSE2) {
-				PausedEffectPrivate::DoPausedEffect_32_SSE2(
-					outScreen->fb32(), mdScreen->fb32(), pxCount);
-			} else if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
-				PausedEffectPrivate::DoPausedEffect_32_MMX(
-					outScreen->fb32(), mdScreen->fb32(), pxCount);
-			} else
-#endif /* HAVE_MMX */
-			{
-				PausedEffectPrivate::T_DoPausedEffect<uint32_t, 8, 8, 8>
-					(outScreen->fb32(), mdScreen->fb32(), pxCount);
-			}
+			PausedEffectPrivate::DoPausedEffect_32_dispatch
+				(outScreen->fb32(), mdScreen->fb32(), pxCount);
 			break;
 	}
 
@@ -321,4 +469,39 @@ void PausedEffect::DoPausedEffect(MdFb* RESTRICT outScreen, const MdFb* RESTRICT
 	mdScreen->unref();
 }
 
+/**
+ * Tint a raw screen buffer a purple hue to indicate that emulation is paused.
+ * This is used to render into buffers that aren't MdFbs,
+ * e.g. a mapped OpenGL pixel buffer object.
+ * @param outBuf Destination buffer.
+ * @param mdBuf Source buffer. (If nullptr or outBuf, the effect is applied in place.)
+ * @param bpp Color depth.
+ * @param pxCount Pixel count.
+ */
+void PausedEffect::DoPausedEffect(void *outBuf, const void *mdBuf,
+				  MdFb::ColorDepth bpp, unsigned int pxCount)
+{
+	if (mdBuf == outBuf) {
+		// In-place operation.
+		mdBuf = nullptr;
+	}
+
+	// Render to outBuf.
+	switch (bpp) {
+		case MdFb::BPP_15:
+			PausedEffectPrivate::T_DoPausedEffect_16_dispatch<5, 5, 5>
+				((uint16_t*)outBuf, (const uint16_t*)mdBuf, pxCount);
+			break;
+		case MdFb::BPP_16:
+			PausedEffectPrivate::T_DoPausedEffect_16_dispatch<5, 6, 5>
+				((uint16_t*)outBuf, (const uint16_t*)mdBuf, pxCount);
+			break;
+		case MdFb::BPP_32:
+		default:
+			PausedEffectPrivate::DoPausedEffect_32_dispatch
+				((uint32_t*)outBuf, (const uint32_t*)mdBuf, pxCount);
+			break;
+	}
+}
+
 }
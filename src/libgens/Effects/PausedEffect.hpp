@@ -25,17 +25,28 @@
 #define __LIBGENS_EFFECTS_PAUSEDEFFECT_HPP__
 
 #include "../macros/common.h"
+#include "../Util/MdFb.hpp"
 
 namespace LibGens {
 
-class MdFb;
-
 class PausedEffect
 {
 	public:
 		static void DoPausedEffect(MdFb* RESTRICT outScreen);
 		static void DoPausedEffect(MdFb* RESTRICT outScreen, const MdFb* RESTRICT mdScreen);
 
+		/**
+		 * Tint a raw screen buffer a purple hue to indicate that emulation is paused.
+		 * This is used to render into buffers that aren't MdFbs,
+		 * e.g. a mapped OpenGL pixel buffer object.
+		 * @param outBuf Destination buffer.
+		 * @param mdBuf Source buffer. (If nullptr or outBuf, the effect is applied in place.)
+		 * @param bpp Color depth.
+		 * @param pxCount Pixel count.
+		 */
+		static void DoPausedEffect(void *outBuf, const void *mdBuf,
+					   MdFb::ColorDepth bpp, unsigned int pxCount);
+
 	private:
 		PausedEffect() { }
 		~PausedEffect() { }
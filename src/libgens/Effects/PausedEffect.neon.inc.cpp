@@ -0,0 +1,160 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * PausedEffect.neon.inc.cpp: "Paused" effect. (NEON-optimized.)           *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __IN_LIBGENS_PAUSEDEFFECT_CPP__
+#error PausedEffect.neon.inc.cpp should only be included by PausedEffect.cpp.
+#endif
+
+#ifndef HAVE_NEON_INTRIN
+#error PausedEffect.neon.inc.cpp should only be compiled if NEON intrinsics are available.
+#endif
+
+// NEON intrinsics.
+#include <arm_neon.h>
+
+namespace LibGens {
+
+/**
+ * Tint 8 pixels a purple hue. (15/16-bit color, NEON)
+ * This matches T_DoPausedEffect() exactly.
+ * @param RBits Number of bits for Red.
+ * @param GBits Number of bits for Green.
+ * @param BBits Number of bits for Blue.
+ * @param px Source pixels.
+ * @return Tinted pixels.
+ */
+template<uint8_t RBits, uint8_t GBits, uint8_t BBits>
+static inline uint16x8_t T_PausedPx16_NEON(uint16x8_t px)
+{
+	// Get the color components, expanded to 8 bits.
+	const uint16x8_t r = vshlq_n_u16(vandq_u16(vshrq_n_u16(px, GBits + BBits),
+		vdupq_n_u16(MMASK(RBits))), 8 - RBits);
+	const uint16x8_t g = vshlq_n_u16(vandq_u16(vshrq_n_u16(px, BBits),
+		vdupq_n_u16(MMASK(GBits))), 8 - GBits);
+	const uint16x8_t b = vshlq_n_u16(vandq_u16(px,
+		vdupq_n_u16(MMASK(BBits))), 8 - BBits);
+
+	// Integer grayscale vector: [0x4D, 0x96, 0x1D]
+	// The sum is always less than 65536.
+	uint16x8_t mono = vmulq_n_u16(r, 0x4D);
+	mono = vmlaq_n_u16(mono, g, 0x96);
+	mono = vmlaq_n_u16(mono, b, 0x1D);
+	mono = vshrq_n_u16(mono, 8);
+
+	// Double the blue component to tint the image.
+	const uint16x8_t nB = vminq_u16(vshlq_n_u16(mono, 1), vdupq_n_u16(0xFF));
+
+	// Pack the new pixels.
+	return vorrq_u16(vorrq_u16(
+		vshlq_n_u16(vshrq_n_u16(mono, 8 - RBits), GBits + BBits),
+		vshlq_n_u16(vshrq_n_u16(mono, 8 - GBits), BBits)),
+		vshrq_n_u16(nB, 8 - BBits));
+}
+
+/**
+ * Tint the screen a purple hue to indicate that emulation is paused.
+ * (15/16-bit color, NEON-optimized.)
+ * NOTE: outScreen and mdScreen may be the same buffer.
+ * @param RBits Number of bits for Red.
+ * @param GBits Number of bits for Green.
+ * @param BBits Number of bits for Blue.
+ * @param outScreen Pointer to the destination screen buffer.
+ * @param mdScreen Pointer to the source screen buffer.
+ * @param pxCount Pixel count.
+ */
+template<uint8_t RBits, uint8_t GBits, uint8_t BBits>
+void PausedEffectPrivate::T_DoPausedEffect_16_NEON(
+	uint16_t *outScreen,
+	const uint16_t *mdScreen,
+	unsigned int pxCount)
+{
+	// Process 8px at a time.
+	for (; pxCount >= 8; pxCount -= 8) {
+		const uint16x8_t px = vld1q_u16(mdScreen);
+		vst1q_u16(outScreen, T_PausedPx16_NEON<RBits, GBits, BBits>(px));
+
+		// Next group of pixels.
+		outScreen += 8;
+		mdScreen += 8;
+	}
+
+	if (pxCount > 0) {
+		// Remaining pixels.
+		uint16_t tmp[8] = {0};
+		memcpy(tmp, mdScreen, pxCount * sizeof(uint16_t));
+		vst1q_u16(tmp, T_PausedPx16_NEON<RBits, GBits, BBits>(vld1q_u16(tmp)));
+		memcpy(outScreen, tmp, pxCount * sizeof(uint16_t));
+	}
+}
+
+/**
+ * Tint the screen a purple hue to indicate that emulation is paused.
+ * (32-bit color, NEON-optimized.)
+ * NOTE: outScreen and mdScreen may be the same buffer.
+ * @param outScreen Pointer to the destination screen buffer.
+ * @param mdScreen Pointer to the source screen buffer.
+ * @param pxCount Pixel count.
+ */
+void PausedEffectPrivate::DoPausedEffect_32_NEON(
+	uint32_t *outScreen,
+	const uint32_t *mdScreen,
+	unsigned int pxCount)
+{
+	const uint32x4_t mask8 = vdupq_n_u32(0xFF);
+
+	// Process 4px at a time.
+	for (; pxCount >= 4; pxCount -= 4) {
+		const uint32x4_t px = vld1q_u32(mdScreen);
+		const uint32x4_t r = vandq_u32(vshrq_n_u32(px, 16), mask8);
+		const uint32x4_t g = vandq_u32(vshrq_n_u32(px, 8), mask8);
+		const uint32x4_t b = vandq_u32(px, mask8);
+
+		// Integer grayscale vector: [0x4D, 0x96, 0x1D]
+		uint32x4_t mono = vmulq_n_u32(r, 0x4D);
+		mono = vmlaq_n_u32(mono, g, 0x96);
+		mono = vmlaq_n_u32(mono, b, 0x1D);
+		mono = vshrq_n_u32(mono, 8);
+
+		// Double the blue component to tint the image.
+		const uint32x4_t nB = vminq_u32(vshlq_n_u32(mono, 1), mask8);
+
+		// Put the new pixels.
+		vst1q_u32(outScreen, vorrq_u32(vorrq_u32(
+			vshlq_n_u32(mono, 16), vshlq_n_u32(mono, 8)), nB));
+
+		// Next group of pixels.
+		outScreen += 4;
+		mdScreen += 4;
+	}
+
+	// Remaining pixels.
+	for (; pxCount > 0; pxCount--) {
+		const uint32_t px = *mdScreen++;
+		unsigned int mono = (((px >> 16) & 0xFF) * 0x4D) +
+				    (((px >> 8) & 0xFF) * 0x96) +
+				    ((px & 0xFF) * 0x1D);
+		mono >>= 8;
+		const unsigned int nB = (mono < 0x80 ? (mono << 1) : 0xFF);
+		*outScreen++ = (mono << 16) | (mono << 8) | nB;
+	}
+}
+
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * PausedEffect.sse2.inc.cpp: "Paused" effect. (SSE2-optimized.)           *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __IN_LIBGENS_PAUSEDEFFECT_CPP__
+#error PausedEffect.sse2.inc.cpp should only be included by PausedEffect.cpp.
+#endif
+
+#ifndef HAVE_SSE2_INTRIN
+#error PausedEffect.sse2.inc.cpp should only be compiled if SSE2 intrinsics are available.
+#endif
+
+// SSE2 intrinsics.
+#include <emmintrin.h>
+
+namespace LibGens {
+
+/**
+ * Tint 8 pixels a purple hue. (15/16-bit color, SSE2)
+ * This matches T_DoPausedEffect() exactly.
+ * @param RBits Number of bits for Red.
+ * @param GBits Number of bits for Green.
+ * @param BBits Number of bits for Blue.
+ * @param px Source pixels.
+ * @return Tinted pixels.
+ */
+template<uint8_t RBits, uint8_t GBits, uint8_t BBits>
+static FUNC_TARGET("sse2") inline __m128i T_PausedPx16_SSE2(__m128i px)
+{
+	// Get the color components, expanded to 8 bits.
+	const __m128i r = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(px, GBits + BBits),
+		_mm_set1_epi16(MMASK(RBits))), 8 - RBits);
+	const __m128i g = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(px, BBits),
+		_mm_set1_epi16(MMASK(GBits))), 8 - GBits);
+	const __m128i b = _mm_slli_epi16(_mm_and_si128(px,
+		_mm_set1_epi16(MMASK(BBits))), 8 - BBits);
+
+	// Integer grayscale vector: [0x4D, 0x96, 0x1D]
+	// The sum is always less than 65536, so 16-bit
+	// wraparound arithmetic gives the exact result.
+	__m128i mono = _mm_mullo_epi16(r, _mm_set1_epi16(0x4D));
+	mono = _mm_add_epi16(mono, _mm_mullo_epi16(g, _mm_set1_epi16(0x96)));
+	mono = _mm_add_epi16(mono, _mm_mullo_epi16(b, _mm_set1_epi16(0x1D)));
+	mono = _mm_srli_epi16(mono, 8);
+
+	// Double the blue component to tint the image.
+	const __m128i nB = _mm_min_epi16(_mm_add_epi16(mono, mono), _mm_set1_epi16(0xFF));
+
+	// Pack the new pixels.
+	return _mm_or_si128(_mm_or_si128(
+		_mm_slli_epi16(_mm_srli_epi16(mono, 8 - RBits), GBits + BBits),
+		_mm_slli_epi16(_mm_srli_epi16(mono, 8 - GBits), BBits)),
+		_mm_srli_epi16(nB, 8 - BBits));
+}
+
+/**
+ * Tint the screen a purple hue to indicate that emulation is paused.
+ * (15/16-bit color, SSE2-optimized.)
+ * NOTE: outScreen and mdScreen may be the same buffer.
+ * @param RBits Number of bits for Red.
+ * @param GBits Number of bits for Green.
+ * @param BBits Number of bits for Blue.
+ * @param outScreen Pointer to the destination screen buffer.
+ * @param mdScreen Pointer to the source screen buffer.
+ * @param pxCount Pixel count.
+ */
+template<uint8_t RBits, uint8_t GBits, uint8_t BBits>
+FUNC_TARGET("sse2")
+void PausedEffectPrivate::T_DoPausedEffect_16_SSE2(
+	uint16_t *outScreen,
+	const uint16_t *mdScreen,
+	unsigned int pxCount)
+{
+	// Process 8px at a time.
+	for (; pxCount >= 8; pxCount -= 8) {
+		const __m128i px = _mm_loadu_si128((const __m128i*)mdScreen);
+		_mm_storeu_si128((__m128i*)outScreen, T_PausedPx16_SSE2<RBits, GBits, BBits>(px));
+
+		// Next group of pixels.
+		outScreen += 8;
+		mdScreen += 8;
+	}
+
+	if (pxCount > 0) {
+		// Remaining pixels.
+		uint16_t tmp[8] = {0};
+		memcpy(tmp, mdScreen, pxCount * sizeof(uint16_t));
+		const __m128i px = _mm_loadu_si128((const __m128i*)tmp);
+		_mm_storeu_si128((__m128i*)tmp, T_PausedPx16_SSE2<RBits, GBits, BBits>(px));
+		memcpy(outScreen, tmp, pxCount * sizeof(uint16_t));
+	}
+}
+
+}
@@ -0,0 +1,1724 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Scaler.cpp: Software scalers.                                           *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "Scaler.hpp"
+#include "Util/TaskPool.hpp"
+#include "macros/common.h"
+#include "libcompat/cpuflags.h"
+#include "libcompat/aligned_malloc.h"
+
+// C includes. (C++ namespace)
+#include <cassert>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+// SSE2 intrinsics are always available on amd64.
+// On i386, they're only available if the compiler targets SSE2.
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVE_SSE2
+#endif
+
+namespace LibGens {
+
+/**
+ * Pixel formats for the interpolating scalers.
+ * Colors are interpolated per component, rounding down.
+ * The alpha channel is not preserved in 32-bit color.
+ */
+struct PxFmt15 {
+	typedef uint16_t pixel;
+	static const uint32_t MASK_RB = 0x7C1F;
+	static const uint32_t MASK_G  = 0x03E0;
+
+	/**
+	 * Convert a pixel to RGB888.
+	 * @param px Pixel.
+	 * @param r, g, b RGB components.
+	 */
+	static inline void toRgb(pixel px, int &r, int &g, int &b)
+	{
+		r = (px >> 10) & 0x1F;
+		g = (px >> 5) & 0x1F;
+		b = px & 0x1F;
+		r = (r << 3) | (r >> 2);
+		g = (g << 3) | (g >> 2);
+		b = (b << 3) | (b >> 2);
+	}
+};
+
+struct PxFmt16 {
+	typedef uint16_t pixel;
+	static const uint32_t MASK_RB = 0xF81F;
+	static const uint32_t MASK_G  = 0x07E0;
+
+	static inline void toRgb(pixel px, int &r, int &g, int &b)
+	{
+		r = (px >> 11) & 0x1F;
+		g = (px >> 5) & 0x3F;
+		b = px & 0x1F;
+		r = (r << 3) | (r >> 2);
+		g = (g << 2) | (g >> 4);
+		b = (b << 3) | (b >> 2);
+	}
+};
+
+struct PxFmt32 {
+	typedef uint32_t pixel;
+	static const uint32_t MASK_RB = 0xFF00FF;
+	static const uint32_t MASK_G  = 0x00FF00;
+
+	static inline void toRgb(pixel px, int &r, int &g, int &b)
+	{
+		r = (px >> 16) & 0xFF;
+		g = (px >> 8) & 0xFF;
+		b = px & 0xFF;
+	}
+};
+
+/**
+ * Scaler private class.
+ */
+class ScalerPrivate
+{
+	public:
+		ScalerPrivate();
+		~ScalerPrivate();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		ScalerPrivate(const ScalerPrivate &);
+		ScalerPrivate &operator=(const ScalerPrivate &);
+
+	public:
+		Scaler::Mode mode;
+		int threads;		// Requested thread count. (0 == default)
+		TaskPool *pool;		// Allocated on first use.
+
+		// Output buffer.
+		void *fb;
+		size_t fb_sz;
+		MdFb::ColorDepth bpp;
+		int width;
+		int height;
+		int pxPitch;
+
+		// YUV buffer for hq2x/hq3x and xBR.
+		// Format: 0x00YYUUVV
+		uint32_t *yuv;
+		size_t yuv_sz;
+		int yuvPitch;
+
+		/**
+		 * Scaling job.
+		 * Passed to the task function.
+		 */
+		struct Job {
+			ScalerPrivate *d;
+			const MdFb *src;
+			int factor;
+			bool sse2;
+		};
+
+		/**
+		 * Does a scaler mode use the YUV buffer?
+		 * @param mode Scaler mode.
+		 * @return True if the mode uses the YUV buffer.
+		 */
+		static inline bool usesYuv(Scaler::Mode mode)
+			{ return (mode >= Scaler::SCALER_HQ2X && mode <= Scaler::SCALER_XBR3X); }
+
+		/**
+		 * Convert one row band to YUV.
+		 * @param param Job.
+		 * @param index Band index.
+		 * @param count Number of bands.
+		 */
+		static void yuvBand(void *param, int index, int count);
+
+		/**
+		 * Scale one row band.
+		 * @param param Job.
+		 * @param index Band index.
+		 * @param count Number of bands.
+		 */
+		static void scaleBand(void *param, int index, int count);
+
+		/**
+		 * Convert lines of a framebuffer to YUV.
+		 * @param job Job.
+		 * @param yStart First source line.
+		 * @param yEnd Last source line, plus one.
+		 */
+		template<typename Fmt>
+		void yuvLines(const Job *job, int yStart, int yEnd);
+
+		/**
+		 * Scale lines of a framebuffer.
+		 * @param job Job.
+		 * @param yStart First source line.
+		 * @param yEnd Last source line, plus one.
+		 */
+		template<typename Fmt>
+		void scaleLines(const Job *job, int yStart, int yEnd);
+
+		/**
+		 * Scale lines of a framebuffer using hq2x/hq3x.
+		 * @param job Job.
+		 * @param yStart First source line.
+		 * @param yEnd Last source line, plus one.
+		 */
+		template<typename Fmt, int factor>
+		void hqxLines(const Job *job, int yStart, int yEnd);
+
+		/**
+		 * Scale lines of a framebuffer using xBR.
+		 * @param job Job.
+		 * @param yStart First source line.
+		 * @param yEnd Last source line, plus one.
+		 */
+		template<typename Fmt, int factor>
+		void xbrLines(const Job *job, int yStart, int yEnd);
+
+		/** Generic kernels. **/
+
+		/**
+		 * Nearest-neighbor: Scale one line horizontally.
+		 * @param dest Destination line.
+		 * @param src Source line.
+		 * @param w Source width.
+		 * @param factor Scaling factor.
+		 */
+		template<typename pixel>
+		static void T_nearestLine(pixel* RESTRICT dest,
+			const pixel* RESTRICT src, int w, int factor);
+
+		/**
+		 * Scale2x: Scale one line.
+		 * @param d0, d1 Destination lines.
+		 * @param B Source line above E.
+		 * @param E Source line.
+		 * @param H Source line below E.
+		 * @param x Start pixel.
+		 * @param xEnd End pixel, plus one.
+		 * @param w Source width.
+		 */
+		template<typename pixel>
+		static void T_scale2xLine(pixel* RESTRICT d0, pixel* RESTRICT d1,
+			const pixel *B, const pixel *E, const pixel *H,
+			int x, int xEnd, int w);
+
+		/**
+		 * Scale3x: Scale one line.
+		 * @param d0, d1, d2 Destination lines.
+		 * @param B Source line above E.
+		 * @param E Source line.
+		 * @param H Source line below E.
+		 * @param w Source width.
+		 */
+		template<typename pixel>
+		static void T_scale3xLine(pixel* RESTRICT d0, pixel* RESTRICT d1, pixel* RESTRICT d2,
+			const pixel *B, const pixel *E, const pixel *H, int w);
+
+		/** Interpolation. **/
+
+		/**
+		 * Interpolate two pixels.
+		 * Weights must add up to (1 << s).
+		 * @param c1, c2 Pixels.
+		 * @param w1, w2 Weights.
+		 * @param s Shift.
+		 * @return (c1*w1 + c2*w2) >> s
+		 */
+		template<typename Fmt>
+		static inline typename Fmt::pixel T_interp2(typename Fmt::pixel c1, int w1,
+			typename Fmt::pixel c2, int w2, int s);
+
+		/**
+		 * Interpolate three pixels.
+		 * Weights must add up to (1 << s).
+		 * @param c1, c2, c3 Pixels.
+		 * @param w1, w2, w3 Weights.
+		 * @param s Shift.
+		 * @return (c1*w1 + c2*w2 + c3*w3) >> s
+		 */
+		template<typename Fmt>
+		static inline typename Fmt::pixel T_interp3(typename Fmt::pixel c1, int w1,
+			typename Fmt::pixel c2, int w2, typename Fmt::pixel c3, int w3, int s);
+
+		/** YUV. **/
+
+		/**
+		 * Convert RGB888 to YUV.
+		 * @param r, g, b RGB components.
+		 * @return YUV. (0x00YYUUVV)
+		 */
+		static inline uint32_t rgbToYuv(int r, int g, int b);
+
+		/**
+		 * Convert one line to YUV.
+		 * @param dest YUV line.
+		 * @param src Source line.
+		 * @param w Source width.
+		 */
+		template<typename Fmt>
+		static void T_yuvLine(uint32_t* RESTRICT dest,
+			const typename Fmt::pixel* RESTRICT src, int w);
+
+		/**
+		 * hq2x/hq3x: Are two YUV values different?
+		 * @param a, b YUV values.
+		 * @return True if the difference exceeds the thresholds.
+		 */
+		static inline bool yuvDiff(uint32_t a, uint32_t b);
+
+		/**
+		 * xBR: Distance between two YUV values.
+		 * @param a, b YUV values.
+		 * @return |Y1-Y2| + |U1-U2| + |V1-V2|
+		 */
+		static inline unsigned int yuvDist(uint32_t a, uint32_t b);
+
+		/** hq2x/hq3x. **/
+
+		/**
+		 * hq2x/hq3x neighborhood:
+		 * 0 1 2
+		 * 3 4 5
+		 * 6 7 8
+		 *
+		 * The difference pattern has one bit per neighbor.
+		 * Bits 0-7 are pixels 0-3 and 5-8.
+		 *
+		 * Each output pixel is calculated for the top-left corner
+		 * (and top edge for hq3x), and the neighborhood is
+		 * permuted for the other corners.
+		 */
+		static const uint8_t hqxPatternBit[9];
+		static const uint8_t hq2xPerm[4][9];
+		static const uint8_t hq3xPerm[4][9];
+		static const uint8_t hq3xCorner[4];
+		static const uint8_t hq3xEdge[4];
+
+		/**
+		 * hq2x/hq3x: Get the difference pattern for a permuted neighborhood.
+		 * @param k Difference pattern.
+		 * @param p Permutation.
+		 * @return Permuted difference pattern.
+		 */
+		static inline int hqxPattern(int k, const uint8_t *p);
+
+		/**
+		 * hq2x: Calculate the top-left output pixel.
+		 * @param w Neighborhood pixels.
+		 * @param y Neighborhood YUV values.
+		 * @param k Difference pattern.
+		 * @param p Permutation.
+		 * @return Output pixel.
+		 */
+		template<typename Fmt>
+		static inline typename Fmt::pixel T_hq2xRule(const typename Fmt::pixel *w,
+			const uint32_t *y, int k, const uint8_t *p);
+
+		/**
+		 * hq3x: Calculate the top-left and top-center output pixels.
+		 * @param c [out] Top-left output pixel.
+		 * @param e [out] Top-center output pixel.
+		 * @param w Neighborhood pixels.
+		 * @param y Neighborhood YUV values.
+		 * @param k Difference pattern.
+		 * @param p Permutation.
+		 */
+		template<typename Fmt>
+		static inline void T_hq3xRule(typename Fmt::pixel &c, typename Fmt::pixel &e,
+			const typename Fmt::pixel *w, const uint32_t *y, int k, const uint8_t *p);
+
+		/**
+		 * hq2x/hq3x: Scale one pixel.
+		 * @param dest Destination lines.
+		 * @param x Source pixel.
+		 * @param w Neighborhood pixels.
+		 * @param y Neighborhood YUV values.
+		 * @param k Difference pattern.
+		 */
+		template<typename Fmt, int factor>
+		static inline void T_hqxPixel(typename Fmt::pixel *const *dest, int x,
+			const typename Fmt::pixel *w, const uint32_t *y, int k);
+
+		/**
+		 * hq2x/hq3x: Scale one line.
+		 * @param dest Destination lines.
+		 * @param src Source lines. (above, current, below)
+		 * @param yuv YUV lines. (above, current, below)
+		 * @param x Start pixel.
+		 * @param xEnd End pixel, plus one.
+		 * @param w Source width.
+		 */
+		template<typename Fmt, int factor>
+		static void T_hqxLine(typename Fmt::pixel *const *dest,
+			const typename Fmt::pixel *const *src, const uint32_t *const *yuv,
+			int x, int xEnd, int w);
+
+		/** xBR. **/
+
+		/**
+		 * xBR neighborhood: 5x5, indexed as (dy+2)*5 + (dx+2).
+		 *
+		 *    A1 B1 C1
+		 * A0 A  B  C  C4
+		 * D0 D  E  F  F4
+		 * G0 G  H  I  I4
+		 *    G5 H5 I5
+		 *
+		 * Each corner is calculated as the bottom-right corner,
+		 * and the neighborhood is rotated for the other corners.
+		 */
+		enum XbrPx {
+			XBR_E, XBR_I, XBR_H, XBR_F, XBR_G, XBR_C,
+			XBR_D, XBR_B, XBR_H5, XBR_F4, XBR_I5, XBR_I4,
+
+			XBR_MAX
+		};
+		static const uint8_t xbrRot[4][XBR_MAX];
+		static const uint8_t xbrSub2[4][4];
+		static const uint8_t xbrSub3[4][9];
+
+		/**
+		 * xBR: Calculate the edge distances for a corner.
+		 * @param y Neighborhood YUV values.
+		 * @param r Rotation.
+		 * @param e [out] Distance across the E-I diagonal.
+		 * @param i [out] Distance along the E-I diagonal.
+		 */
+		static inline void xbrCornerDist(const uint32_t *y, int r,
+			unsigned int &e, unsigned int &i);
+
+		/**
+		 * xBR: Blend one corner of the output block.
+		 * @param out Output block.
+		 * @param w Neighborhood pixels.
+		 * @param y Neighborhood YUV values.
+		 * @param r Rotation.
+		 * @param ei Edge distances for this corner, or nullptr to calculate them.
+		 */
+		template<typename Fmt, int factor>
+		static inline void T_xbrCorner(typename Fmt::pixel *out,
+			const typename Fmt::pixel *w, const uint32_t *y, int r,
+			const unsigned int *ei);
+
+		/**
+		 * xBR: Scale one pixel.
+		 * @param dest Destination lines.
+		 * @param x Source pixel.
+		 * @param w Neighborhood pixels.
+		 * @param y Neighborhood YUV values.
+		 * @param ei Edge distances for the four corners, or nullptr to calculate them.
+		 */
+		template<typename Fmt, int factor>
+		static inline void T_xbrPixel(typename Fmt::pixel *const *dest, int x,
+			const typename Fmt::pixel *w, const uint32_t *y, const unsigned int *ei);
+
+		/**
+		 * xBR: Get the 5x5 neighborhood of a pixel.
+		 * Pixels outside of the image are clamped to the nearest edge pixel.
+		 * @param nw [out] Neighborhood pixels.
+		 * @param ny [out] Neighborhood YUV values.
+		 * @param src Source lines. (y-2 to y+2)
+		 * @param yuv YUV lines. (y-2 to y+2)
+		 * @param x Source pixel.
+		 * @param w Source width.
+		 */
+		template<typename pixel>
+		static inline void T_xbrNeighborhood(pixel *nw, uint32_t *ny,
+			const pixel *const *src, const uint32_t *const *yuv, int x, int w);
+
+		/**
+		 * xBR: Scale one line.
+		 * @param dest Destination lines.
+		 * @param src Source lines. (y-2 to y+2)
+		 * @param yuv YUV lines. (y-2 to y+2)
+		 * @param x Start pixel.
+		 * @param xEnd End pixel, plus one.
+		 * @param w Source width.
+		 */
+		template<typename Fmt, int factor>
+		static void T_xbrLine(typename Fmt::pixel *const *dest,
+			const typename Fmt::pixel *const *src, const uint32_t *const *yuv,
+			int x, int xEnd, int w);
+
+#ifdef HAVE_SSE2
+		/** SSE2 kernels. **/
+		static void nearest2xLine_16_SSE2(uint16_t* RESTRICT dest, const uint16_t* RESTRICT src, int w);
+		static void nearest2xLine_32_SSE2(uint32_t* RESTRICT dest, const uint32_t* RESTRICT src, int w);
+		static void nearest4xLine_16_SSE2(uint16_t* RESTRICT dest, const uint16_t* RESTRICT src, int w);
+		static void nearest4xLine_32_SSE2(uint32_t* RESTRICT dest, const uint32_t* RESTRICT src, int w);
+		static void scale2xLine_16_SSE2(uint16_t* RESTRICT d0, uint16_t* RESTRICT d1,
+			const uint16_t *B, const uint16_t *E, const uint16_t *H, int w);
+		static void scale2xLine_32_SSE2(uint32_t* RESTRICT d0, uint32_t* RESTRICT d1,
+			const uint32_t *B, const uint32_t *E, const uint32_t *H, int w);
+
+		/**
+		 * Nearest-neighbor: Scale one line horizontally. (SSE2)
+		 * Falls back to the generic version for 3x.
+		 */
+		static inline void nearestLine_SSE2(uint16_t* RESTRICT dest,
+			const uint16_t* RESTRICT src, int w, int factor);
+		static inline void nearestLine_SSE2(uint32_t* RESTRICT dest,
+			const uint32_t* RESTRICT src, int w, int factor);
+
+		static inline void scale2xLine_SSE2(uint16_t* RESTRICT d0, uint16_t* RESTRICT d1,
+			const uint16_t *B, const uint16_t *E, const uint16_t *H, int w)
+			{ scale2xLine_16_SSE2(d0, d1, B, E, H, w); }
+		static inline void scale2xLine_SSE2(uint32_t* RESTRICT d0, uint32_t* RESTRICT d1,
+			const uint32_t *B, const uint32_t *E, const uint32_t *H, int w)
+			{ scale2xLine_32_SSE2(d0, d1, B, E, H, w); }
+
+		/**
+		 * hq2x/hq3x: Scale one line. (SSE2)
+		 * @param dest Destination lines.
+		 * @param src Source lines. (above, current, below)
+		 * @param yuv YUV lines. (above, current, below)
+		 * @param w Source width.
+		 */
+		template<typename Fmt, int factor>
+		static void T_hqxLine_SSE2(typename Fmt::pixel *const *dest,
+			const typename Fmt::pixel *const *src, const uint32_t *const *yuv, int w);
+
+		/**
+		 * xBR: Scale one line. (SSE2)
+		 * @param dest Destination lines.
+		 * @param src Source lines. (y-2 to y+2)
+		 * @param yuv YUV lines. (y-2 to y+2)
+		 * @param w Source width.
+		 */
+		template<typename Fmt, int factor>
+		static void T_xbrLine_SSE2(typename Fmt::pixel *const *dest,
+			const typename Fmt::pixel *const *src, const uint32_t *const *yuv, int w);
+#endif /* HAVE_SSE2 */
+
+		/**
+		 * Copy a pixel to a factor x factor block.
+		 * @param dest Destination lines.
+		 * @param x Source pixel.
+		 * @param px Pixel.
+		 */
+		template<typename pixel, int factor>
+		static inline void T_fillBlock(pixel *const *dest, int x, pixel px)
+		{
+			for (int i = 0; i < factor; i++) {
+				for (int j = 0; j < factor; j++) {
+					dest[i][x*factor + j] = px;
+				}
+			}
+		}
+
+		/**
+		 * Get a source line.
+		 * @param src Source framebuffer.
+		 * @param line Line number.
+		 * @return Line buffer.
+		 */
+		static inline const uint16_t *srcLine(const MdFb *src, int line, const uint16_t*)
+			{ return src->lineBuf16(line); }
+		static inline const uint32_t *srcLine(const MdFb *src, int line, const uint32_t*)
+			{ return src->lineBuf32(line); }
+};
+
+ScalerPrivate::ScalerPrivate()
+	: mode(Scaler::SCALER_NONE)
+	, threads(0)
+	, pool(nullptr)
+	, fb(nullptr)
+	, fb_sz(0)
+	, bpp(MdFb::BPP_32)
+	, width(0)
+	, height(0)
+	, pxPitch(0)
+	, yuv(nullptr)
+	, yuv_sz(0)
+	, yuvPitch(0)
+{ }
+
+ScalerPrivate::~ScalerPrivate()
+{
+	delete pool;
+	aligned_free(fb);
+	aligned_free(yuv);
+}
+
+/**
+ * Nearest-neighbor: Scale one line horizontally.
+ * @param dest Destination line.
+ * @param src Source line.
+ * @param w Source width.
+ * @param factor Scaling factor.
+ */
+template<typename pixel>
+void ScalerPrivate::T_nearestLine(pixel* RESTRICT dest,
+	const pixel* RESTRICT src, int w, int factor)
+{
+	for (int x = 0; x < w; x++) {
+		const pixel px = src[x];
+		for (int i = factor; i > 0; i--) {
+			*dest++ = px;
+		}
+	}
+}
+
+/**
+ * Scale2x: Scale one line.
+ *
+ * A B C    E0 E1
+ * D E F => E2 E3
+ * G H I
+ *
+ * Pixels outside of the image are clamped to the nearest edge pixel.
+ *
+ * @param d0, d1 Destination lines.
+ * @param B Source line above E.
+ * @param E Source line.
+ * @param H Source line below E.
+ * @param x Start pixel.
+ * @param xEnd End pixel, plus one.
+ * @param w Source width.
+ */
+template<typename pixel>
+void ScalerPrivate::T_scale2xLine(pixel* RESTRICT d0, pixel* RESTRICT d1,
+	const pixel *B, const pixel *E, const pixel *H,
+	int x, int xEnd, int w)
+{
+	for (; x < xEnd; x++) {
+		const pixel e = E[x];
+		const pixel b = B[x];
+		const pixel h = H[x];
+		const pixel d = (x > 0 ? E[x-1] : e);
+		const pixel f = (x < w-1 ? E[x+1] : e);
+
+		if (b != h && d != f) {
+			d0[x*2]   = (d == b ? d : e);
+			d0[x*2+1] = (b == f ? f : e);
+			d1[x*2]   = (d == h ? d : e);
+			d1[x*2+1] = (h == f ? f : e);
+		} else {
+			d0[x*2] = d0[x*2+1] = e;
+			d1[x*2] = d1[x*2+1] = e;
+		}
+	}
+}
+
+/**
+ * Scale3x: Scale one line.
+ *
+ * A B C    E0 E1 E2
+ * D E F => E3 E4 E5
+ * G H I    E6 E7 E8
+ *
+ * Pixels outside of the image are clamped to the nearest edge pixel.
+ *
+ * @param d0, d1, d2 Destination lines.
+ * @param B Source line above E.
+ * @param E Source line.
+ * @param H Source line below E.
+ * @param w Source width.
+ */
+template<typename pixel>
+void ScalerPrivate::T_scale3xLine(pixel* RESTRICT d0, pixel* RESTRICT d1, pixel* RESTRICT d2,
+	const pixel *B, const pixel *E, const pixel *H, int w)
+{
+	for (int x = 0; x < w; x++, d0 += 3, d1 += 3, d2 += 3) {
+		const pixel e = E[x];
+		const pixel b = B[x];
+		const pixel h = H[x];
+		const bool left = (x > 0);
+		const bool right = (x < w-1);
+		const pixel a = (left ? B[x-1] : b);
+		const pixel c = (right ? B[x+1] : b);
+		const pixel d = (left ? E[x-1] : e);
+		const pixel f = (right ? E[x+1] : e);
+		const pixel g = (left ? H[x-1] : h);
+		const pixel i = (right ? H[x+1] : h);
+
+		if (b != h && d != f) {
+			d0[0] = (d == b ? d : e);
+			d0[1] = ((d == b && e != c) || (b == f && e != a)) ? b : e;
+			d0[2] = (b == f ? f : e);
+			d1[0] = ((d == b && e != g) || (d == h && e != a)) ? d : e;
+			d1[1] = e;
+			d1[2] = ((b == f && e != i) || (h == f && e != c)) ? f : e;
+			d2[0] = (d == h ? d : e);
+			d2[1] = ((d == h && e != i) || (h == f && e != g)) ? h : e;
+			d2[2] = (h == f ? f : e);
+		} else {
+			d0[0] = d0[1] = d0[2] = e;
+			d1[0] = d1[1] = d1[2] = e;
+			d2[0] = d2[1] = d2[2] = e;
+		}
+	}
+}
+
+/** Interpolation. **/
+
+/**
+ * Interpolate two pixels.
+ * Weights must add up to (1 << s).
+ * @param c1, c2 Pixels.
+ * @param w1, w2 Weights.
+ * @param s Shift.
+ * @return (c1*w1 + c2*w2) >> s
+ */
+template<typename Fmt>
+inline typename Fmt::pixel ScalerPrivate::T_interp2(typename Fmt::pixel c1, int w1,
+	typename Fmt::pixel c2, int w2, int s)
+{
+	const uint32_t rb = ((c1 & Fmt::MASK_RB) * w1 + (c2 & Fmt::MASK_RB) * w2) >> s;
+	const uint32_t g  = ((c1 & Fmt::MASK_G)  * w1 + (c2 & Fmt::MASK_G)  * w2) >> s;
+	return (typename Fmt::pixel)((rb & Fmt::MASK_RB) | (g & Fmt::MASK_G));
+}
+
+/**
+ * Interpolate three pixels.
+ * Weights must add up to (1 << s).
+ * @param c1, c2, c3 Pixels.
+ * @param w1, w2, w3 Weights.
+ * @param s Shift.
+ * @return (c1*w1 + c2*w2 + c3*w3) >> s
+ */
+template<typename Fmt>
+inline typename Fmt::pixel ScalerPrivate::T_interp3(typename Fmt::pixel c1, int w1,
+	typename Fmt::pixel c2, int w2, typename Fmt::pixel c3, int w3, int s)
+{
+	const uint32_t rb = ((c1 & Fmt::MASK_RB) * w1 + (c2 & Fmt::MASK_RB) * w2 +
+			     (c3 & Fmt::MASK_RB) * w3) >> s;
+	const uint32_t g  = ((c1 & Fmt::MASK_G)  * w1 + (c2 & Fmt::MASK_G)  * w2 +
+			     (c3 & Fmt::MASK_G)  * w3) >> s;
+	return (typename Fmt::pixel)((rb & Fmt::MASK_RB) | (g & Fmt::MASK_G));
+}
+
+/** YUV. **/
+
+/**
+ * Convert RGB888 to YUV.
+ * @param r, g, b RGB components.
+ * @return YUV. (0x00YYUUVV)
+ */
+inline uint32_t ScalerPrivate::rgbToYuv(int r, int g, int b)
+{
+	// U and V are rounded towards zero before adding the bias.
+	const int y = (299*r + 587*g + 114*b) / 1000;
+	const int u = ((-169*(r-g) + 500*(b-g)) / 1000) + 128;
+	const int v = (( 500*(r-g) -  81*(b-g)) / 1000) + 128;
+	return (y << 16) | (u << 8) | v;
+}
+
+/**
+ * Convert one line to YUV.
+ * @param dest YUV line.
+ * @param src Source line.
+ * @param w Source width.
+ */
+template<typename Fmt>
+void ScalerPrivate::T_yuvLine(uint32_t* RESTRICT dest,
+	const typename Fmt::pixel* RESTRICT src, int w)
+{
+	int r, g, b;
+	for (int x = 0; x < w; x++) {
+		Fmt::toRgb(src[x], r, g, b);
+		dest[x] = rgbToYuv(r, g, b);
+	}
+}
+
+/**
+ * hq2x/hq3x: Are two YUV values different?
+ * @param a, b YUV values.
+ * @return True if the difference exceeds the thresholds.
+ */
+inline bool ScalerPrivate::yuvDiff(uint32_t a, uint32_t b)
+{
+	// Thresholds: Y == 48, U == 7, V == 6
+	return (abs((int)(a >> 16) - (int)(b >> 16)) > 48 ||
+		abs((int)((a >> 8) & 0xFF) - (int)((b >> 8) & 0xFF)) > 7 ||
+		abs((int)(a & 0xFF) - (int)(b & 0xFF)) > 6);
+}
+
+/**
+ * xBR: Distance between two YUV values.
+ * @param a, b YUV values.
+ * @return |Y1-Y2| + |U1-U2| + |V1-V2|
+ */
+inline unsigned int ScalerPrivate::yuvDist(uint32_t a, uint32_t b)
+{
+	return abs((int)(a >> 16) - (int)(b >> 16)) +
+	       abs((int)((a >> 8) & 0xFF) - (int)((b >> 8) & 0xFF)) +
+	       abs((int)(a & 0xFF) - (int)(b & 0xFF));
+}
+
+/** hq2x/hq3x. **/
+
+// Difference pattern bit for each neighbor.
+const uint8_t ScalerPrivate::hqxPatternBit[9] = {0, 1, 2, 3, 0xFF, 4, 5, 6, 7};
+
+// hq2x: Mirrored neighborhoods for the top-left, top-right,
+// bottom-left, and bottom-right output pixels.
+const uint8_t ScalerPrivate::hq2xPerm[4][9] = {
+	{0, 1, 2, 3, 4, 5, 6, 7, 8},
+	{2, 1, 0, 5, 4, 3, 8, 7, 6},
+	{6, 7, 8, 3, 4, 5, 0, 1, 2},
+	{8, 7, 6, 5, 4, 3, 2, 1, 0},
+};
+
+// hq3x: Neighborhoods rotated clockwise by 0, 90, 180,
+// and 270 degrees, and the output pixels for each rotation.
+const uint8_t ScalerPrivate::hq3xPerm[4][9] = {
+	{0, 1, 2, 3, 4, 5, 6, 7, 8},
+	{2, 5, 8, 1, 4, 7, 0, 3, 6},
+	{8, 7, 6, 5, 4, 3, 2, 1, 0},
+	{6, 3, 0, 7, 4, 1, 8, 5, 2},
+};
+const uint8_t ScalerPrivate::hq3xCorner[4] = {0, 2, 8, 6};
+const uint8_t ScalerPrivate::hq3xEdge[4] = {1, 5, 7, 3};
+
+/**
+ * hq2x/hq3x: Get the difference pattern for a permuted neighborhood.
+ * @param k Difference pattern.
+ * @param p Permutation.
+ * @return Permuted difference pattern.
+ */
+inline int ScalerPrivate::hqxPattern(int k, const uint8_t *p)
+{
+	int kp = 0;
+	for (int n = 0; n < 9; n++) {
+		if (n == 4)
+			continue;
+		kp |= ((k >> hqxPatternBit[p[n]]) & 1) << hqxPatternBit[n];
+	}
+	return kp;
+}
+
+// Check the permuted difference pattern.
+// m == mask of neighbors to check
+// r == expected differences
+#define P(m, r) ((kp & (m)) == (r))
+
+/**
+ * hq2x: Calculate the top-left output pixel.
+ * @param w Neighborhood pixels.
+ * @param y Neighborhood YUV values.
+ * @param k Difference pattern.
+ * @param p Permutation.
+ * @return Output pixel.
+ */
+template<typename Fmt>
+inline typename Fmt::pixel ScalerPrivate::T_hq2xRule(const typename Fmt::pixel *w,
+	const uint32_t *y, int k, const uint8_t *p)
+{
+	typedef typename Fmt::pixel pixel;
+	const int kp = hqxPattern(k, p);
+	const pixel w0 = w[p[0]], w1 = w[p[1]], w3 = w[p[3]], w4 = w[p[4]];
+
+	if ((P(0xBF,0x37) || P(0xDB,0x13)) && yuvDiff(y[p[1]], y[p[5]]))
+		return T_interp2<Fmt>(w4, 3, w3, 1, 2);
+	if ((P(0xDB,0x49) || P(0xEF,0x6D)) && yuvDiff(y[p[7]], y[p[3]]))
+		return T_interp2<Fmt>(w4, 3, w1, 1, 2);
+	if ((P(0x0B,0x0B) || P(0xFE,0x4A) || P(0xFE,0x1A)) && yuvDiff(y[p[3]], y[p[1]]))
+		return w4;
+	if ((P(0x6F,0x2A) || P(0x5B,0x0A) || P(0xBF,0x3A) || P(0xDF,0x5A) ||
+	     P(0x9F,0x8A) || P(0xCF,0x8A) || P(0xEF,0x4E) || P(0x3F,0x0E) ||
+	     P(0xFB,0x5A) || P(0xBB,0x8A) || P(0x7F,0x5A) || P(0xAF,0x8A) ||
+	     P(0xEB,0x8A)) && yuvDiff(y[p[3]], y[p[1]]))
+		return T_interp2<Fmt>(w4, 3, w0, 1, 2);
+	if (P(0x0B,0x08))
+		return T_interp3<Fmt>(w4, 2, w0, 1, w1, 1, 2);
+	if (P(0x0B,0x02))
+		return T_interp3<Fmt>(w4, 2, w0, 1, w3, 1, 2);
+	if (P(0x2F,0x2F))
+		return T_interp3<Fmt>(w4, 14, w3, 1, w1, 1, 4);
+	if (P(0xBF,0x37) || P(0xDB,0x13))
+		return T_interp3<Fmt>(w4, 5, w1, 2, w3, 1, 3);
+	if (P(0xDB,0x49) || P(0xEF,0x6D))
+		return T_interp3<Fmt>(w4, 5, w3, 2, w1, 1, 3);
+	if (P(0x1B,0x03) || P(0x4F,0x43) || P(0x8B,0x83) || P(0x6B,0x43))
+		return T_interp2<Fmt>(w4, 3, w3, 1, 2);
+	if (P(0x4B,0x09) || P(0x8B,0x89) || P(0x1F,0x19) || P(0x3B,0x19))
+		return T_interp2<Fmt>(w4, 3, w1, 1, 2);
+	if (P(0x7E,0x2A) || P(0xEF,0xAB) || P(0xBF,0x8F) || P(0x7E,0x0E))
+		return T_interp3<Fmt>(w4, 2, w3, 3, w1, 3, 3);
+	if (P(0xFB,0x6A) || P(0x6F,0x6E) || P(0x3F,0x3E) || P(0xFB,0xFA) ||
+	    P(0xDF,0xDE) || P(0xDF,0x1E))
+		return T_interp2<Fmt>(w4, 3, w0, 1, 2);
+	if (P(0x0A,0x00) || P(0x4F,0x4B) || P(0x9F,0x1B) || P(0x2F,0x0B) ||
+	    P(0xBE,0x0A) || P(0xEE,0x0A) || P(0x7E,0x0A) || P(0xEB,0x4B) ||
+	    P(0x3B,0x1B))
+		return T_interp3<Fmt>(w4, 2, w3, 1, w1, 1, 2);
+	return T_interp3<Fmt>(w4, 6, w3, 1, w1, 1, 3);
+}
+
+/**
+ * hq3x: Calculate the top-left and top-center output pixels.
+ * @param c [out] Top-left output pixel.
+ * @param e [out] Top-center output pixel.
+ * @param w Neighborhood pixels.
+ * @param y Neighborhood YUV values.
+ * @param k Difference pattern.
+ * @param p Permutation.
+ */
+template<typename Fmt>
+inline void ScalerPrivate::T_hq3xRule(typename Fmt::pixel &c, typename Fmt::pixel &e,
+	const typename Fmt::pixel *w, const uint32_t *y, int k, const uint8_t *p)
+{
+	typedef typename Fmt::pixel pixel;
+	const int kp = hqxPattern(k, p);
+	const pixel w0 = w[p[0]], w1 = w[p[1]], w3 = w[p[3]], w4 = w[p[4]];
+
+	// Corner.
+	if ((P(0xBF,0x37) || P(0xDB,0x13)) && yuvDiff(y[p[1]], y[p[5]]))
+		c = T_interp2<Fmt>(w4, 3, w3, 1, 2);
+	else if ((P(0xDB,0x49) || P(0xEF,0x6D)) && yuvDiff(y[p[7]], y[p[3]]))
+		c = T_interp2<Fmt>(w4, 3, w1, 1, 2);
+	else if ((P(0x0B,0x0B) || P(0xFE,0x4A) || P(0xFE,0x1A)) && yuvDiff(y[p[3]], y[p[1]]))
+		c = w4;
+	else if ((P(0x6F,0x2A) || P(0x5B,0x0A) || P(0xBF,0x3A) || P(0xDF,0x5A) ||
+		  P(0x9F,0x8A) || P(0xCF,0x8A) || P(0xEF,0x4E) || P(0x3F,0x0E) ||
+		  P(0xFB,0x5A) || P(0xBB,0x8A) || P(0x7F,0x5A) || P(0xAF,0x8A) ||
+		  P(0xEB,0x8A)) && yuvDiff(y[p[3]], y[p[1]]))
+		c = T_interp2<Fmt>(w4, 3, w0, 1, 2);
+	else if (P(0x4B,0x09) || P(0x8B,0x89) || P(0x1F,0x19) || P(0x3B,0x19))
+		c = T_interp2<Fmt>(w4, 3, w1, 1, 2);
+	else if (P(0x1B,0x03) || P(0x4F,0x43) || P(0x8B,0x83) || P(0x6B,0x43))
+		c = T_interp2<Fmt>(w4, 3, w3, 1, 2);
+	else if (P(0x7E,0x2A) || P(0xEF,0xAB) || P(0xBF,0x8F) || P(0x7E,0x0E))
+		c = T_interp3<Fmt>(w4, 2, w3, 7, w1, 7, 4);
+	else if (P(0x4F,0x4B) || P(0x9F,0x1B) || P(0x2F,0x0B) || P(0xBE,0x0A) ||
+		 P(0xEE,0x0A) || P(0x7E,0x0A) || P(0xEB,0x4B) || P(0x3B,0x1B))
+		c = T_interp2<Fmt>(w3, 1, w1, 1, 1);
+	else if (P(0x0B,0x08) || P(0xF9,0x68) || P(0xF3,0x62) || P(0x6D,0x6C) ||
+		 P(0x67,0x66) || P(0x3D,0x3C) || P(0x37,0x36) || P(0xF9,0xF8) ||
+		 P(0xDD,0xDC) || P(0xF3,0xF2) || P(0xD7,0xD6) || P(0xDD,0x1C) ||
+		 P(0xD7,0x16) || P(0x0B,0x02))
+		c = T_interp2<Fmt>(w4, 3, w0, 1, 2);
+	else
+		c = T_interp3<Fmt>(w4, 2, w3, 1, w1, 1, 2);
+
+	// Edge.
+	if ((P(0xFE,0xDE) || P(0x9E,0x16) || P(0xDA,0x12) || P(0x17,0x16) ||
+	     P(0x5B,0x12) || P(0xBB,0x12)) && yuvDiff(y[p[1]], y[p[5]]))
+		e = w4;
+	else if ((P(0x0F,0x0B) || P(0x5E,0x0A) || P(0xFB,0x7B) || P(0x3B,0x0B) ||
+		  P(0xBE,0x0A) || P(0x7A,0x0A)) && yuvDiff(y[p[3]], y[p[1]]))
+		e = w4;
+	else if (P(0xBF,0x8F) || P(0x7E,0x0E) || P(0xBF,0x37) || P(0xDB,0x13))
+		e = T_interp2<Fmt>(w1, 3, w4, 1, 2);
+	else if (P(0x02,0x00) || P(0x7C,0x28) || P(0xED,0xA9) || P(0xF5,0xB4) ||
+		 P(0xD9,0x90))
+		e = T_interp2<Fmt>(w4, 3, w1, 1, 2);
+	else if (P(0x4F,0x4B) || P(0xFB,0x7B) || P(0xFE,0x7E) || P(0x9F,0x1B) ||
+		 P(0x2F,0x0B) || P(0xBE,0x0A) || P(0x7E,0x0A) || P(0xFB,0x4B) ||
+		 P(0xFB,0xDB) || P(0xFE,0xDE) || P(0xFE,0x56) || P(0x57,0x56) ||
+		 P(0x97,0x16) || P(0x3F,0x1E) || P(0xDB,0x12) || P(0xBB,0x12))
+		e = T_interp2<Fmt>(w4, 7, w1, 1, 3);
+	else
+		e = w4;
+}
+
+#undef P
+
+/**
+ * hq2x/hq3x: Scale one pixel.
+ * @param dest Destination lines.
+ * @param x Source pixel.
+ * @param w Neighborhood pixels.
+ * @param y Neighborhood YUV values.
+ * @param k Difference pattern.
+ */
+template<typename Fmt, int factor>
+inline void ScalerPrivate::T_hqxPixel(typename Fmt::pixel *const *dest, int x,
+	const typename Fmt::pixel *w, const uint32_t *y, int k)
+{
+	typedef typename Fmt::pixel pixel;
+	if (factor == 2) {
+		pixel *const d0 = &dest[0][x*2];
+		pixel *const d1 = &dest[1][x*2];
+		d0[0] = T_hq2xRule<Fmt>(w, y, k, hq2xPerm[0]);
+		d0[1] = T_hq2xRule<Fmt>(w, y, k, hq2xPerm[1]);
+		d1[0] = T_hq2xRule<Fmt>(w, y, k, hq2xPerm[2]);
+		d1[1] = T_hq2xRule<Fmt>(w, y, k, hq2xPerm[3]);
+	} else {
+		pixel out[9];
+		out[4] = w[4];
+		for (int r = 0; r < 4; r++) {
+			T_hq3xRule<Fmt>(out[hq3xCorner[r]], out[hq3xEdge[r]], w, y, k, hq3xPerm[r]);
+		}
+		for (int i = 0; i < 3; i++) {
+			pixel *const d = &dest[i][x*3];
+			d[0] = out[i*3];
+			d[1] = out[i*3+1];
+			d[2] = out[i*3+2];
+		}
+	}
+}
+
+/**
+ * hq2x/hq3x: Scale one line.
+ * Pixels outside of the image are clamped to the nearest edge pixel.
+ * @param dest Destination lines.
+ * @param src Source lines. (above, current, below)
+ * @param yuv YUV lines. (above, current, below)
+ * @param x Start pixel.
+ * @param xEnd End pixel, plus one.
+ * @param w Source width.
+ */
+template<typename Fmt, int factor>
+void ScalerPrivate::T_hqxLine(typename Fmt::pixel *const *dest,
+	const typename Fmt::pixel *const *src, const uint32_t *const *yuv,
+	int x, int xEnd, int w)
+{
+	typedef typename Fmt::pixel pixel;
+	pixel nw[9];
+	uint32_t ny[9];
+
+	for (; x < xEnd; x++) {
+		const int xl = (x > 0 ? x-1 : x);
+		const int xr = (x < w-1 ? x+1 : x);
+		for (int i = 0; i < 3; i++) {
+			nw[i*3]   = src[i][xl];
+			nw[i*3+1] = src[i][x];
+			nw[i*3+2] = src[i][xr];
+			ny[i*3]   = yuv[i][xl];
+			ny[i*3+1] = yuv[i][x];
+			ny[i*3+2] = yuv[i][xr];
+		}
+
+		int k = 0;
+		for (int n = 0; n < 9; n++) {
+			if (n != 4 && yuvDiff(ny[4], ny[n])) {
+				k |= (1 << hqxPatternBit[n]);
+			}
+		}
+
+		T_hqxPixel<Fmt, factor>(dest, x, nw, ny, k);
+	}
+}
+
+/** xBR. **/
+
+// Neighborhood indexes for the bottom-right, top-right,
+// top-left, and bottom-left corners. (XbrPx order)
+const uint8_t ScalerPrivate::xbrRot[4][XBR_MAX] = {
+	{12, 18, 17, 13, 16,  8, 11,  7, 22, 14, 23, 19},
+	{12,  8, 13,  7, 18,  6, 17, 11, 14,  2,  9,  3},
+	{12,  6,  7, 11,  8, 16, 13, 17,  2, 10,  1,  5},
+	{12, 16, 11, 17,  6, 18,  7, 13, 10, 22, 15, 21},
+};
+
+// Output pixels for each corner, in bottom-right order.
+const uint8_t ScalerPrivate::xbrSub2[4][4] = {
+	{0, 1, 2, 3},
+	{2, 0, 3, 1},
+	{3, 2, 1, 0},
+	{1, 3, 0, 2},
+};
+const uint8_t ScalerPrivate::xbrSub3[4][9] = {
+	{0, 1, 2, 3, 4, 5, 6, 7, 8},
+	{6, 3, 0, 7, 4, 1, 8, 5, 2},
+	{8, 7, 6, 5, 4, 3, 2, 1, 0},
+	{2, 5, 8, 1, 4, 7, 0, 3, 6},
+};
+
+/**
+ * xBR: Calculate the edge distances for a corner.
+ * @param y Neighborhood YUV values.
+ * @param r Rotation.
+ * @param e [out] Distance across the E-I diagonal.
+ * @param i [out] Distance along the E-I diagonal.
+ */
+inline void ScalerPrivate::xbrCornerDist(const uint32_t *y, int r,
+	unsigned int &e, unsigned int &i)
+{
+	const uint8_t *const p = xbrRot[r];
+	e = yuvDist(y[p[XBR_E]], y[p[XBR_C]]) + yuvDist(y[p[XBR_E]], y[p[XBR_G]]) +
+	    yuvDist(y[p[XBR_I]], y[p[XBR_H5]]) + yuvDist(y[p[XBR_I]], y[p[XBR_F4]]) +
+	    (yuvDist(y[p[XBR_H]], y[p[XBR_F]]) << 2);
+	i = yuvDist(y[p[XBR_H]], y[p[XBR_D]]) + yuvDist(y[p[XBR_H]], y[p[XBR_I5]]) +
+	    yuvDist(y[p[XBR_F]], y[p[XBR_I4]]) + yuvDist(y[p[XBR_F]], y[p[XBR_B]]) +
+	    (yuvDist(y[p[XBR_E]], y[p[XBR_I]]) << 2);
+}
+
+/**
+ * xBR: Blend one corner of the output block.
+ * @param out Output block.
+ * @param w Neighborhood pixels.
+ * @param y Neighborhood YUV values.
+ * @param r Rotation.
+ * @param ei Edge distances for this corner, or nullptr to calculate them.
+ */
+template<typename Fmt, int factor>
+inline void ScalerPrivate::T_xbrCorner(typename Fmt::pixel *out,
+	const typename Fmt::pixel *w, const uint32_t *y, int r,
+	const unsigned int *ei)
+{
+	typedef typename Fmt::pixel pixel;
+	const uint8_t *const p = xbrRot[r];
+	const pixel E = w[p[XBR_E]];
+	const pixel F = w[p[XBR_F]];
+	const pixel H = w[p[XBR_H]];
+	if (E == H || E == F)
+		return;
+
+	unsigned int e, i;
+	if (ei) {
+		e = ei[0];
+		i = ei[1];
+	} else {
+		xbrCornerDist(y, r, e, i);
+	}
+	if (e > i)
+		return;
+
+	// Distances and similarity. (eq)
+	#define DIST(a, b) yuvDist(y[p[XBR_##a]], y[p[XBR_##b]])
+	#define EQ(a, b) (DIST(a, b) < 155)
+
+	const pixel px = (DIST(E, F) <= DIST(E, H) ? F : H);
+	const uint8_t *const sub = (factor == 2 ? xbrSub2[r] : xbrSub3[r]);
+	pixel *const N8 = &out[sub[factor * factor - 1]];
+
+	bool edge;
+	if (factor == 2) {
+		edge = (e < i && ((!EQ(F, B) && !EQ(H, D)) ||
+			(EQ(E, I) && (!EQ(F, I4) && !EQ(H, I5))) ||
+			EQ(E, G) || EQ(E, C)));
+	} else {
+		edge = (e < i && ((!EQ(F, B) && !EQ(F, C)) ||
+			(!EQ(H, D) && !EQ(H, G)) ||
+			(EQ(E, I) && ((!EQ(F, F4) && !EQ(F, I4)) ||
+				      (!EQ(H, H5) && !EQ(H, I5)))) ||
+			EQ(E, G) || EQ(E, C)));
+	}
+
+	if (!edge) {
+		*N8 = T_interp2<Fmt>(*N8, 1, px, 1, 1);
+		return;
+	}
+
+	// Check for shallow and steep edges.
+	const pixel G = w[p[XBR_G]];
+	const pixel C = w[p[XBR_C]];
+	const unsigned int ke = DIST(F, G);
+	const unsigned int ki = DIST(H, C);
+	const bool left = ((ke << 1) <= ki && E != G && w[p[XBR_D]] != G);
+	const bool up = (ke >= (ki << 1) && E != C && w[p[XBR_B]] != C);
+
+	#undef EQ
+	#undef DIST
+
+	if (factor == 2) {
+		pixel *const N1 = &out[sub[1]];
+		pixel *const N2 = &out[sub[2]];
+		if (left && up) {
+			*N8 = T_interp2<Fmt>(*N8, 1, px, 7, 3);
+			*N2 = T_interp2<Fmt>(*N2, 3, px, 1, 2);
+			*N1 = *N2;
+		} else if (left) {
+			*N8 = T_interp2<Fmt>(*N8, 1, px, 3, 2);
+			*N2 = T_interp2<Fmt>(*N2, 3, px, 1, 2);
+		} else if (up) {
+			*N8 = T_interp2<Fmt>(*N8, 1, px, 3, 2);
+			*N1 = T_interp2<Fmt>(*N1, 3, px, 1, 2);
+		} else {
+			// Diagonal.
+			*N8 = T_interp2<Fmt>(*N8, 1, px, 1, 1);
+		}
+	} else {
+		pixel *const N2 = &out[sub[2]];
+		pixel *const N5 = &out[sub[5]];
+		pixel *const N6 = &out[sub[6]];
+		pixel *const N7 = &out[sub[7]];
+		if (left && up) {
+			*N7 = T_interp2<Fmt>(*N7, 1, px, 3, 2);
+			*N6 = T_interp2<Fmt>(*N6, 3, px, 1, 2);
+			*N5 = *N7;
+			*N2 = *N6;
+			*N8 = px;
+		} else if (left) {
+			*N7 = T_interp2<Fmt>(*N7, 1, px, 3, 2);
+			*N5 = T_interp2<Fmt>(*N5, 3, px, 1, 2);
+			*N6 = T_interp2<Fmt>(*N6, 3, px, 1, 2);
+			*N8 = px;
+		} else if (up) {
+			*N5 = T_interp2<Fmt>(*N5, 1, px, 3, 2);
+			*N7 = T_interp2<Fmt>(*N7, 3, px, 1, 2);
+			*N2 = T_interp2<Fmt>(*N2, 3, px, 1, 2);
+			*N8 = px;
+		} else {
+			// Diagonal.
+			*N8 = T_interp2<Fmt>(*N8, 1, px, 7, 3);
+			*N5 = T_interp2<Fmt>(*N5, 7, px, 1, 3);
+			*N7 = T_interp2<Fmt>(*N7, 7, px, 1, 3);
+		}
+	}
+}
+
+/**
+ * xBR: Scale one pixel.
+ * @param dest Destination lines.
+ * @param x Source pixel.
+ * @param w Neighborhood pixels.
+ * @param y Neighborhood YUV values.
+ * @param ei Edge distances for the four corners, or nullptr to calculate them.
+ */
+template<typename Fmt, int factor>
+inline void ScalerPrivate::T_xbrPixel(typename Fmt::pixel *const *dest, int x,
+	const typename Fmt::pixel *w, const uint32_t *y, const unsigned int *ei)
+{
+	typedef typename Fmt::pixel pixel;
+	pixel out[factor * factor];
+	for (int i = 0; i < factor * factor; i++) {
+		out[i] = w[12];
+	}
+
+	// Corners are blended in order, so later corners
+	// may modify pixels set by earlier corners.
+	for (int r = 0; r < 4; r++) {
+		T_xbrCorner<Fmt, factor>(out, w, y, r, (ei ? &ei[r*2] : nullptr));
+	}
+
+	for (int i = 0; i < factor; i++) {
+		pixel *const d = &dest[i][x*factor];
+		for (int j = 0; j < factor; j++) {
+			d[j] = out[i*factor + j];
+		}
+	}
+}
+
+/**
+ * xBR: Get the 5x5 neighborhood of a pixel.
+ * Pixels outside of the image are clamped to the nearest edge pixel.
+ * @param nw [out] Neighborhood pixels.
+ * @param ny [out] Neighborhood YUV values.
+ * @param src Source lines. (y-2 to y+2)
+ * @param yuv YUV lines. (y-2 to y+2)
+ * @param x Source pixel.
+ * @param w Source width.
+ */
+template<typename pixel>
+inline void ScalerPrivate::T_xbrNeighborhood(pixel *nw, uint32_t *ny,
+	const pixel *const *src, const uint32_t *const *yuv, int x, int w)
+{
+	int xs[5];
+	for (int j = 0; j < 5; j++) {
+		const int xc = x + j - 2;
+		xs[j] = (xc < 0 ? 0 : (xc >= w ? w-1 : xc));
+	}
+	for (int i = 0; i < 5; i++) {
+		for (int j = 0; j < 5; j++) {
+			nw[i*5 + j] = src[i][xs[j]];
+			ny[i*5 + j] = yuv[i][xs[j]];
+		}
+	}
+}
+
+/**
+ * xBR: Scale one line.
+ * @param dest Destination lines.
+ * @param src Source lines. (y-2 to y+2)
+ * @param yuv YUV lines. (y-2 to y+2)
+ * @param x Start pixel.
+ * @param xEnd End pixel, plus one.
+ * @param w Source width.
+ */
+template<typename Fmt, int factor>
+void ScalerPrivate::T_xbrLine(typename Fmt::pixel *const *dest,
+	const typename Fmt::pixel *const *src, const uint32_t *const *yuv,
+	int x, int xEnd, int w)
+{
+	typedef typename Fmt::pixel pixel;
+	pixel nw[25];
+	uint32_t ny[25];
+
+	for (; x < xEnd; x++) {
+		T_xbrNeighborhood(nw, ny, src, yuv, x, w);
+		T_xbrPixel<Fmt, factor>(dest, x, nw, ny, nullptr);
+	}
+}
+
+}
+
+// SSE2-optimized versions.
+#ifdef HAVE_SSE2
+#define __IN_LIBGENS_SCALER_CPP__
+#include "Scaler.x86.inc.cpp"
+#endif /* HAVE_SSE2 */
+
+namespace LibGens {
+
+/**
+ * Convert lines of a framebuffer to YUV.
+ * @param job Job.
+ * @param yStart First source line.
+ * @param yEnd Last source line, plus one.
+ */
+template<typename Fmt>
+void ScalerPrivate::yuvLines(const Job *job, int yStart, int yEnd)
+{
+	typedef typename Fmt::pixel pixel;
+	const MdFb *const src = job->src;
+	const int w = src->pxPerLine();
+	const pixel *const tag = nullptr;
+
+	for (int y = yStart; y < yEnd; y++) {
+		T_yuvLine<Fmt>(&yuv[y * yuvPitch], srcLine(src, y, tag), w);
+	}
+}
+
+/**
+ * Scale lines of a framebuffer.
+ * @param job Job.
+ * @param yStart First source line.
+ * @param yEnd Last source line, plus one.
+ */
+template<typename Fmt>
+void ScalerPrivate::scaleLines(const Job *job, int yStart, int yEnd)
+{
+	typedef typename Fmt::pixel pixel;
+	const MdFb *const src = job->src;
+	const int w = src->pxPerLine();
+	const int lastLine = src->numLines() - 1;
+	const int factor = job->factor;
+	const size_t lineBytes = width * sizeof(pixel);
+	pixel *dest = (pixel*)fb + (yStart * factor * pxPitch);
+	const pixel *const tag = nullptr;
+
+	switch (mode) {
+		case Scaler::SCALER_NONE:
+		case Scaler::SCALER_NEAREST_2X:
+		case Scaler::SCALER_NEAREST_3X:
+		case Scaler::SCALER_NEAREST_4X:
+			for (int y = yStart; y < yEnd; y++) {
+				const pixel *line = srcLine(src, y, tag);
+#ifdef HAVE_SSE2
+				if (job->sse2) {
+					nearestLine_SSE2(dest, line, w, factor);
+				} else
+#endif /* HAVE_SSE2 */
+				{
+					T_nearestLine(dest, line, w, factor);
+				}
+
+				// Duplicate the line vertically.
+				pixel *const first = dest;
+				dest += pxPitch;
+				for (int i = factor - 1; i > 0; i--, dest += pxPitch) {
+					memcpy(dest, first, lineBytes);
+				}
+			}
+			break;
+
+		case Scaler::SCALER_SCALE2X:
+			for (int y = yStart; y < yEnd; y++, dest += pxPitch * 2) {
+				const pixel *E = srcLine(src, y, tag);
+				const pixel *B = (y > 0 ? srcLine(src, y-1, tag) : E);
+				const pixel *H = (y < lastLine ? srcLine(src, y+1, tag) : E);
+#ifdef HAVE_SSE2
+				if (job->sse2) {
+					scale2xLine_SSE2(dest, dest + pxPitch, B, E, H, w);
+				} else
+#endif /* HAVE_SSE2 */
+				{
+					T_scale2xLine(dest, dest + pxPitch, B, E, H, 0, w, w);
+				}
+			}
+			break;
+
+		case Scaler::SCALER_SCALE3X:
+			for (int y = yStart; y < yEnd; y++, dest += pxPitch * 3) {
+				const pixel *E = srcLine(src, y, tag);
+				const pixel *B = (y > 0 ? srcLine(src, y-1, tag) : E);
+				const pixel *H = (y < lastLine ? srcLine(src, y+1, tag) : E);
+				T_scale3xLine(dest, dest + pxPitch, dest + pxPitch * 2, B, E, H, w);
+			}
+			break;
+
+		case Scaler::SCALER_HQ2X:
+			hqxLines<Fmt, 2>(job, yStart, yEnd);
+			break;
+		case Scaler::SCALER_HQ3X:
+			hqxLines<Fmt, 3>(job, yStart, yEnd);
+			break;
+		case Scaler::SCALER_XBR2X:
+			xbrLines<Fmt, 2>(job, yStart, yEnd);
+			break;
+		case Scaler::SCALER_XBR3X:
+			xbrLines<Fmt, 3>(job, yStart, yEnd);
+			break;
+
+		default:
+			assert(!"Invalid scaler mode.");
+			break;
+	}
+}
+
+/**
+ * Scale lines of a framebuffer using hq2x/hq3x.
+ * The YUV buffer must already be filled in.
+ * @param job Job.
+ * @param yStart First source line.
+ * @param yEnd Last source line, plus one.
+ */
+template<typename Fmt, int factor>
+void ScalerPrivate::hqxLines(const Job *job, int yStart, int yEnd)
+{
+	typedef typename Fmt::pixel pixel;
+	const MdFb *const src = job->src;
+	const int w = src->pxPerLine();
+	const int lastLine = src->numLines() - 1;
+	const pixel *const tag = nullptr;
+
+	const pixel *lines[3];
+	const uint32_t *yuvRows[3];
+	pixel *dest[factor];
+
+	for (int y = yStart; y < yEnd; y++) {
+		for (int i = 0; i < 3; i++) {
+			int line = y + i - 1;
+			line = (line < 0 ? 0 : (line > lastLine ? lastLine : line));
+			lines[i] = srcLine(src, line, tag);
+			yuvRows[i] = &yuv[line * yuvPitch];
+		}
+		for (int i = 0; i < factor; i++) {
+			dest[i] = (pixel*)fb + ((y * factor + i) * pxPitch);
+		}
+
+#ifdef HAVE_SSE2
+		if (job->sse2) {
+			T_hqxLine_SSE2<Fmt, factor>(dest, lines, yuvRows, w);
+		} else
+#endif /* HAVE_SSE2 */
+		{
+			T_hqxLine<Fmt, factor>(dest, lines, yuvRows, 0, w, w);
+		}
+	}
+}
+
+/**
+ * Scale lines of a framebuffer using xBR.
+ * The YUV buffer must already be filled in.
+ * @param job Job.
+ * @param yStart First source line.
+ * @param yEnd Last source line, plus one.
+ */
+template<typename Fmt, int factor>
+void ScalerPrivate::xbrLines(const Job *job, int yStart, int yEnd)
+{
+	typedef typename Fmt::pixel pixel;
+	const MdFb *const src = job->src;
+	const int w = src->pxPerLine();
+	const int lastLine = src->numLines() - 1;
+	const pixel *const tag = nullptr;
+
+	const pixel *lines[5];
+	const uint32_t *yuvRows[5];
+	pixel *dest[factor];
+
+	for (int y = yStart; y < yEnd; y++) {
+		for (int i = 0; i < 5; i++) {
+			int line = y + i - 2;
+			line = (line < 0 ? 0 : (line > lastLine ? lastLine : line));
+			lines[i] = srcLine(src, line, tag);
+			yuvRows[i] = &yuv[line * yuvPitch];
+		}
+		for (int i = 0; i < factor; i++) {
+			dest[i] = (pixel*)fb + ((y * factor + i) * pxPitch);
+		}
+
+#ifdef HAVE_SSE2
+		if (job->sse2) {
+			T_xbrLine_SSE2<Fmt, factor>(dest, lines, yuvRows, w);
+		} else
+#endif /* HAVE_SSE2 */
+		{
+			T_xbrLine<Fmt, factor>(dest, lines, yuvRows, 0, w, w);
+		}
+	}
+}
+
+/**
+ * Convert one row band to YUV.
+ * @param param Job.
+ * @param index Band index.
+ * @param count Number of bands.
+ */
+void ScalerPrivate::yuvBand(void *param, int index, int count)
+{
+	const Job *const job = (const Job*)param;
+	const int lines = job->src->numLines();
+	const int yStart = (lines * index) / count;
+	const int yEnd = (lines * (index + 1)) / count;
+
+	switch (job->d->bpp) {
+		case MdFb::BPP_15:
+			job->d->yuvLines<PxFmt15>(job, yStart, yEnd);
+			break;
+		case MdFb::BPP_16:
+			job->d->yuvLines<PxFmt16>(job, yStart, yEnd);
+			break;
+		case MdFb::BPP_32:
+		default:
+			job->d->yuvLines<PxFmt32>(job, yStart, yEnd);
+			break;
+	}
+}
+
+/**
+ * Scale one row band.
+ * @param param Job.
+ * @param index Band index.
+ * @param count Number of bands.
+ */
+void ScalerPrivate::scaleBand(void *param, int index, int count)
+{
+	const Job *const job = (const Job*)param;
+	const int lines = job->src->numLines();
+	const int yStart = (lines * index) / count;
+	const int yEnd = (lines * (index + 1)) / count;
+
+	switch (job->d->bpp) {
+		case MdFb::BPP_15:
+			job->d->scaleLines<PxFmt15>(job, yStart, yEnd);
+			break;
+		case MdFb::BPP_16:
+			job->d->scaleLines<PxFmt16>(job, yStart, yEnd);
+			break;
+		case MdFb::BPP_32:
+		default:
+			job->d->scaleLines<PxFmt32>(job, yStart, yEnd);
+			break;
+	}
+}
+
+/** Scaler **/
+
+Scaler::Scaler()
+	: d(new ScalerPrivate())
+{ }
+
+Scaler::~Scaler()
+{
+	delete d;
+}
+
+/**
+ * Get the scaling factor for a scaler mode.
+ * @param mode Scaler mode.
+ * @return Scaling factor, or 0 if the mode is invalid.
+ */
+int Scaler::ScaleFactor(Mode mode)
+{
+	static const uint8_t factors[SCALER_MAX] = {1, 2, 3, 4, 2, 3, 2, 3, 2, 3};
+	if (mode < 0 || mode >= SCALER_MAX)
+		return 0;
+	return factors[mode];
+}
+
+/**
+ * Get the name of a scaler mode.
+ * @param mode Scaler mode.
+ * @return Name, or nullptr if the mode is invalid.
+ */
+const char *Scaler::ModeName(Mode mode)
+{
+	static const char *const names[SCALER_MAX] = {
+		"None", "Nearest 2x", "Nearest 3x", "Nearest 4x",
+		"Scale2x", "Scale3x",
+		"hq2x", "hq3x",
+		"xBR 2x", "xBR 3x",
+	};
+	if (mode < 0 || mode >= SCALER_MAX)
+		return nullptr;
+	return names[mode];
+}
+
+/**
+ * Get the scaler mode.
+ * @return Scaler mode.
+ */
+Scaler::Mode Scaler::mode(void) const
+{
+	return d->mode;
+}
+
+/**
+ * Set the scaler mode.
+ * @param mode Scaler mode.
+ */
+void Scaler::setMode(Mode mode)
+{
+	assert(mode >= SCALER_NONE && mode < SCALER_MAX);
+	if (mode < SCALER_NONE || mode >= SCALER_MAX)
+		return;
+	d->mode = mode;
+}
+
+/**
+ * Get the number of threads used for scaling.
+ * @return Number of threads, or 0 for the default.
+ */
+int Scaler::threadCount(void) const
+{
+	return d->threads;
+}
+
+/**
+ * Set the number of threads used for scaling.
+ * @param threads Number of threads, or 0 for the default.
+ */
+void Scaler::setThreadCount(int threads)
+{
+	if (threads < 0)
+		threads = 0;
+	if (d->threads == threads)
+		return;
+	d->threads = threads;
+
+	// Recreate the thread pool on the next scale().
+	delete d->pool;
+	d->pool = nullptr;
+}
+
+/**
+ * Scale a framebuffer.
+ * @param src Source framebuffer.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int Scaler::scale(const MdFb *src)
+{
+	const int factor = ScaleFactor(d->mode);
+	const MdFb::ColorDepth bpp = src->bpp();
+	const int width = src->pxPerLine() * factor;
+	const int height = src->numLines() * factor;
+	// Round the pitch up to a multiple of 16 bytes.
+	const int pxPitch = (bpp == MdFb::BPP_32 ? (width + 3) & ~3 : (width + 7) & ~7);
+	const size_t fb_sz = (size_t)pxPitch * height *
+		(bpp == MdFb::BPP_32 ? sizeof(uint32_t) : sizeof(uint16_t));
+
+	if (fb_sz > d->fb_sz) {
+		aligned_free(d->fb);
+		d->fb = aligned_malloc(16, fb_sz);
+		if (!d->fb) {
+			d->fb_sz = 0;
+			d->width = d->height = d->pxPitch = 0;
+			return -ENOMEM;
+		}
+		d->fb_sz = fb_sz;
+	}
+	d->bpp = bpp;
+	d->width = width;
+	d->height = height;
+	d->pxPitch = pxPitch;
+
+	if (!d->pool) {
+		d->pool = new TaskPool(d->threads);
+	}
+
+	ScalerPrivate::Job job;
+	job.d = d;
+	job.src = src;
+	job.factor = factor;
+#ifdef HAVE_SSE2
+	job.sse2 = !!(CPU_Flags & MDP_CPUFLAG_X86_SSE2);
+#else
+	job.sse2 = false;
+#endif
+
+	// Two bands per thread evens out the load
+	// if one of the threads is preempted.
+	const int threads = d->pool->threadCount();
+	const int bands = (threads > 1 ? threads * 2 : 1);
+
+	if (ScalerPrivate::usesYuv(d->mode)) {
+		// Convert the whole image to YUV first, since
+		// each band also reads the lines around it.
+		const int yuvPitch = (src->pxPerLine() + 3) & ~3;
+		const size_t yuv_sz = (size_t)yuvPitch * src->numLines() * sizeof(uint32_t);
+		if (yuv_sz > d->yuv_sz) {
+			aligned_free(d->yuv);
+			d->yuv = (uint32_t*)aligned_malloc(16, yuv_sz);
+			if (!d->yuv) {
+				d->yuv_sz = 0;
+				d->width = d->height = d->pxPitch = 0;
+				return -ENOMEM;
+			}
+			d->yuv_sz = yuv_sz;
+		}
+		d->yuvPitch = yuvPitch;
+		d->pool->run(ScalerPrivate::yuvBand, &job, bands);
+	}
+
+	d->pool->run(ScalerPrivate::scaleBand, &job, bands);
+	return 0;
+}
+
+/**
+ * Get the output color depth.
+ * @return Output color depth.
+ */
+MdFb::ColorDepth Scaler::bpp(void) const
+{
+	return d->bpp;
+}
+
+/**
+ * Get the output width.
+ * @return Output width, in pixels.
+ */
+int Scaler::width(void) const
+{
+	return d->width;
+}
+
+/**
+ * Get the output height.
+ * @return Output height, in lines.
+ */
+int Scaler::height(void) const
+{
+	return d->height;
+}
+
+/**
+ * Get the output pitch.
+ * @return Output pitch, in pixels.
+ */
+int Scaler::pxPitch(void) const
+{
+	return d->pxPitch;
+}
+
+/**
+ * Get the output buffer.
+ * @return Output buffer, or nullptr if nothing has been scaled.
+ */
+const void *Scaler::fb(void) const
+{
+	return (d->width > 0 ? d->fb : nullptr);
+}
+
+}
@@ -0,0 +1,161 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Scaler.hpp: Software scalers.                                           *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_EFFECTS_SCALER_HPP__
+#define __LIBGENS_EFFECTS_SCALER_HPP__
+
+#include "Util/MdFb.hpp"
+
+// C includes.
+#include <stdint.h>
+
+namespace LibGens {
+
+class ScalerPrivate;
+
+/**
+ * Software scaler.
+ *
+ * Scales the entire MdFb (pxPerLine() x numLines()) into an
+ * internal output buffer with the same color depth.
+ * The image is split into row bands, which are scaled
+ * in parallel on a small thread pool.
+ *
+ * hq2x/hq3x and xBR compare pixels in YUV. The YUV values
+ * are converted in a separate pass over the same bands.
+ */
+class Scaler
+{
+	public:
+		Scaler();
+		~Scaler();
+
+	private:
+		friend class ScalerPrivate;
+		ScalerPrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		Scaler(const Scaler &);
+		Scaler &operator=(const Scaler &);
+
+	public:
+		enum Mode {
+			SCALER_NONE = 0,	// No scaling. (1x)
+			SCALER_NEAREST_2X,	// Nearest-neighbor, 2x.
+			SCALER_NEAREST_3X,	// Nearest-neighbor, 3x.
+			SCALER_NEAREST_4X,	// Nearest-neighbor, 4x.
+			SCALER_SCALE2X,		// AdvanceMAME Scale2x.
+			SCALER_SCALE3X,		// AdvanceMAME Scale3x.
+			SCALER_HQ2X,		// hq2x.
+			SCALER_HQ3X,		// hq3x.
+			SCALER_XBR2X,		// xBR, 2x.
+			SCALER_XBR3X,		// xBR, 3x.
+
+			SCALER_MAX
+		};
+
+		/**
+		 * Get the scaling factor for a scaler mode.
+		 * @param mode Scaler mode.
+		 * @return Scaling factor, or 0 if the mode is invalid.
+		 */
+		static int ScaleFactor(Mode mode);
+
+		/**
+		 * Get the name of a scaler mode.
+		 * @param mode Scaler mode.
+		 * @return Name, or nullptr if the mode is invalid.
+		 */
+		static const char *ModeName(Mode mode);
+
+		/**
+		 * Get the scaler mode.
+		 * @return Scaler mode.
+		 */
+		Mode mode(void) const;
+
+		/**
+		 * Set the scaler mode.
+		 * @param mode Scaler mode.
+		 */
+		void setMode(Mode mode);
+
+		/**
+		 * Get the number of threads used for scaling.
+		 * @return Number of threads, or 0 for the default.
+		 */
+		int threadCount(void) const;
+
+		/**
+		 * Set the number of threads used for scaling.
+		 * @param threads Number of threads, or 0 for the default.
+		 */
+		void setThreadCount(int threads);
+
+		/**
+		 * Scale a framebuffer.
+		 * @param src Source framebuffer.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int scale(const MdFb *src);
+
+		/** Output buffer. **/
+
+		/**
+		 * Get the output color depth.
+		 * @return Output color depth.
+		 */
+		MdFb::ColorDepth bpp(void) const;
+
+		/**
+		 * Get the output width.
+		 * @return Output width, in pixels.
+		 */
+		int width(void) const;
+
+		/**
+		 * Get the output height.
+		 * @return Output height, in lines.
+		 */
+		int height(void) const;
+
+		/**
+		 * Get the output pitch.
+		 * @return Output pitch, in pixels.
+		 */
+		int pxPitch(void) const;
+
+		/**
+		 * Get the output buffer.
+		 * @return Output buffer, or nullptr if nothing has been scaled.
+		 */
+		const void *fb(void) const;
+
+		inline const uint16_t *fb16(void) const
+			{ return (const uint16_t*)fb(); }
+		inline const uint32_t *fb32(void) const
+			{ return (const uint32_t*)fb(); }
+};
+
+}
+
+#endif /* __LIBGENS_EFFECTS_SCALER_HPP__ */
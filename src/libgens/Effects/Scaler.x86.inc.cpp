@@ -0,0 +1,447 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Scaler.x86.inc.cpp: Software scalers. (SSE2-optimized)                  *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __IN_LIBGENS_SCALER_CPP__
+#error Scaler.x86.inc.cpp should only be included by Scaler.cpp.
+#endif
+
+#ifndef HAVE_SSE2
+#error Scaler.x86.inc.cpp should only be compiled if SSE2 intrinsics are available.
+#endif
+
+// SSE2 intrinsics.
+#include <emmintrin.h>
+
+namespace LibGens {
+
+/**
+ * Select pixels from two vectors.
+ * @param mask Mask. (all ones to select a)
+ * @param a Pixels to use where mask is set.
+ * @param b Pixels to use where mask is clear.
+ * @return Selected pixels.
+ */
+static inline __m128i sse2_select(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/**
+ * Nearest-neighbor 2x: Scale one line horizontally. (15/16-bit)
+ * @param dest Destination line.
+ * @param src Source line.
+ * @param w Source width.
+ */
+void ScalerPrivate::nearest2xLine_16_SSE2(uint16_t* RESTRICT dest, const uint16_t* RESTRICT src, int w)
+{
+	int x = 0;
+	for (; x + 8 <= w; x += 8, dest += 16) {
+		const __m128i v = _mm_loadu_si128((const __m128i*)&src[x]);
+		_mm_storeu_si128((__m128i*)&dest[0], _mm_unpacklo_epi16(v, v));
+		_mm_storeu_si128((__m128i*)&dest[8], _mm_unpackhi_epi16(v, v));
+	}
+	T_nearestLine(dest, &src[x], w - x, 2);
+}
+
+/**
+ * Nearest-neighbor 2x: Scale one line horizontally. (32-bit)
+ * @param dest Destination line.
+ * @param src Source line.
+ * @param w Source width.
+ */
+void ScalerPrivate::nearest2xLine_32_SSE2(uint32_t* RESTRICT dest, const uint32_t* RESTRICT src, int w)
+{
+	int x = 0;
+	for (; x + 4 <= w; x += 4, dest += 8) {
+		const __m128i v = _mm_loadu_si128((const __m128i*)&src[x]);
+		_mm_storeu_si128((__m128i*)&dest[0], _mm_unpacklo_epi32(v, v));
+		_mm_storeu_si128((__m128i*)&dest[4], _mm_unpackhi_epi32(v, v));
+	}
+	T_nearestLine(dest, &src[x], w - x, 2);
+}
+
+/**
+ * Nearest-neighbor 4x: Scale one line horizontally. (15/16-bit)
+ * @param dest Destination line.
+ * @param src Source line.
+ * @param w Source width.
+ */
+void ScalerPrivate::nearest4xLine_16_SSE2(uint16_t* RESTRICT dest, const uint16_t* RESTRICT src, int w)
+{
+	int x = 0;
+	for (; x + 8 <= w; x += 8, dest += 32) {
+		const __m128i v = _mm_loadu_si128((const __m128i*)&src[x]);
+		const __m128i lo = _mm_unpacklo_epi16(v, v);
+		const __m128i hi = _mm_unpackhi_epi16(v, v);
+		_mm_storeu_si128((__m128i*)&dest[0],  _mm_unpacklo_epi32(lo, lo));
+		_mm_storeu_si128((__m128i*)&dest[8],  _mm_unpackhi_epi32(lo, lo));
+		_mm_storeu_si128((__m128i*)&dest[16], _mm_unpacklo_epi32(hi, hi));
+		_mm_storeu_si128((__m128i*)&dest[24], _mm_unpackhi_epi32(hi, hi));
+	}
+	T_nearestLine(dest, &src[x], w - x, 4);
+}
+
+/**
+ * Nearest-neighbor 4x: Scale one line horizontally. (32-bit)
+ * @param dest Destination line.
+ * @param src Source line.
+ * @param w Source width.
+ */
+void ScalerPrivate::nearest4xLine_32_SSE2(uint32_t* RESTRICT dest, const uint32_t* RESTRICT src, int w)
+{
+	int x = 0;
+	for (; x + 4 <= w; x += 4, dest += 16) {
+		const __m128i v = _mm_loadu_si128((const __m128i*)&src[x]);
+		const __m128i lo = _mm_unpacklo_epi32(v, v);
+		const __m128i hi = _mm_unpackhi_epi32(v, v);
+		_mm_storeu_si128((__m128i*)&dest[0],  _mm_unpacklo_epi64(lo, lo));
+		_mm_storeu_si128((__m128i*)&dest[4],  _mm_unpackhi_epi64(lo, lo));
+		_mm_storeu_si128((__m128i*)&dest[8],  _mm_unpacklo_epi64(hi, hi));
+		_mm_storeu_si128((__m128i*)&dest[12], _mm_unpackhi_epi64(hi, hi));
+	}
+	T_nearestLine(dest, &src[x], w - x, 4);
+}
+
+/**
+ * Nearest-neighbor: Scale one line horizontally. (SSE2)
+ * Falls back to the generic version for 3x.
+ */
+inline void ScalerPrivate::nearestLine_SSE2(uint16_t* RESTRICT dest,
+	const uint16_t* RESTRICT src, int w, int factor)
+{
+	switch (factor) {
+		case 2:	nearest2xLine_16_SSE2(dest, src, w); break;
+		case 4:	nearest4xLine_16_SSE2(dest, src, w); break;
+		default: T_nearestLine(dest, src, w, factor); break;
+	}
+}
+
+inline void ScalerPrivate::nearestLine_SSE2(uint32_t* RESTRICT dest,
+	const uint32_t* RESTRICT src, int w, int factor)
+{
+	switch (factor) {
+		case 2:	nearest2xLine_32_SSE2(dest, src, w); break;
+		case 4:	nearest4xLine_32_SSE2(dest, src, w); break;
+		default: T_nearestLine(dest, src, w, factor); break;
+	}
+}
+
+/**
+ * Scale2x: Scale one line. (15/16-bit)
+ * The first and last pixels are handled by the generic version,
+ * since their neighbors are clamped.
+ * @param d0, d1 Destination lines.
+ * @param B Source line above E.
+ * @param E Source line.
+ * @param H Source line below E.
+ * @param w Source width.
+ */
+void ScalerPrivate::scale2xLine_16_SSE2(uint16_t* RESTRICT d0, uint16_t* RESTRICT d1,
+	const uint16_t *B, const uint16_t *E, const uint16_t *H, int w)
+{
+	T_scale2xLine(d0, d1, B, E, H, 0, (w < 1 ? w : 1), w);
+
+	int x = 1;
+	for (; x + 8 < w; x += 8) {
+		const __m128i b = _mm_loadu_si128((const __m128i*)&B[x]);
+		const __m128i d = _mm_loadu_si128((const __m128i*)&E[x-1]);
+		const __m128i e = _mm_loadu_si128((const __m128i*)&E[x]);
+		const __m128i f = _mm_loadu_si128((const __m128i*)&E[x+1]);
+		const __m128i h = _mm_loadu_si128((const __m128i*)&H[x]);
+
+		// Pixels where B == H or D == F are copied as-is.
+		const __m128i keep = _mm_or_si128(_mm_cmpeq_epi16(b, h), _mm_cmpeq_epi16(d, f));
+		const __m128i e0 = sse2_select(_mm_andnot_si128(keep, _mm_cmpeq_epi16(d, b)), d, e);
+		const __m128i e1 = sse2_select(_mm_andnot_si128(keep, _mm_cmpeq_epi16(b, f)), f, e);
+		const __m128i e2 = sse2_select(_mm_andnot_si128(keep, _mm_cmpeq_epi16(d, h)), d, e);
+		const __m128i e3 = sse2_select(_mm_andnot_si128(keep, _mm_cmpeq_epi16(h, f)), f, e);
+
+		_mm_storeu_si128((__m128i*)&d0[x*2],   _mm_unpacklo_epi16(e0, e1));
+		_mm_storeu_si128((__m128i*)&d0[x*2+8], _mm_unpackhi_epi16(e0, e1));
+		_mm_storeu_si128((__m128i*)&d1[x*2],   _mm_unpacklo_epi16(e2, e3));
+		_mm_storeu_si128((__m128i*)&d1[x*2+8], _mm_unpackhi_epi16(e2, e3));
+	}
+
+	T_scale2xLine(d0, d1, B, E, H, x, w, w);
+}
+
+/**
+ * Scale2x: Scale one line. (32-bit)
+ * The first and last pixels are handled by the generic version,
+ * since their neighbors are clamped.
+ * @param d0, d1 Destination lines.
+ * @param B Source line above E.
+ * @param E Source line.
+ * @param H Source line below E.
+ * @param w Source width.
+ */
+void ScalerPrivate::scale2xLine_32_SSE2(uint32_t* RESTRICT d0, uint32_t* RESTRICT d1,
+	const uint32_t *B, const uint32_t *E, const uint32_t *H, int w)
+{
+	T_scale2xLine(d0, d1, B, E, H, 0, (w < 1 ? w : 1), w);
+
+	int x = 1;
+	for (; x + 4 < w; x += 4) {
+		const __m128i b = _mm_loadu_si128((const __m128i*)&B[x]);
+		const __m128i d = _mm_loadu_si128((const __m128i*)&E[x-1]);
+		const __m128i e = _mm_loadu_si128((const __m128i*)&E[x]);
+		const __m128i f = _mm_loadu_si128((const __m128i*)&E[x+1]);
+		const __m128i h = _mm_loadu_si128((const __m128i*)&H[x]);
+
+		// Pixels where B == H or D == F are copied as-is.
+		const __m128i keep = _mm_or_si128(_mm_cmpeq_epi32(b, h), _mm_cmpeq_epi32(d, f));
+		const __m128i e0 = sse2_select(_mm_andnot_si128(keep, _mm_cmpeq_epi32(d, b)), d, e);
+		const __m128i e1 = sse2_select(_mm_andnot_si128(keep, _mm_cmpeq_epi32(b, f)), f, e);
+		const __m128i e2 = sse2_select(_mm_andnot_si128(keep, _mm_cmpeq_epi32(d, h)), d, e);
+		const __m128i e3 = sse2_select(_mm_andnot_si128(keep, _mm_cmpeq_epi32(h, f)), f, e);
+
+		_mm_storeu_si128((__m128i*)&d0[x*2],   _mm_unpacklo_epi32(e0, e1));
+		_mm_storeu_si128((__m128i*)&d0[x*2+4], _mm_unpackhi_epi32(e0, e1));
+		_mm_storeu_si128((__m128i*)&d1[x*2],   _mm_unpacklo_epi32(e2, e3));
+		_mm_storeu_si128((__m128i*)&d1[x*2+4], _mm_unpackhi_epi32(e2, e3));
+	}
+
+	T_scale2xLine(d0, d1, B, E, H, x, w, w);
+}
+
+
+/**
+ * Load four pixels into 32-bit lanes.
+ * @param p Pixels.
+ * @return Pixels, zero-extended to 32 bits.
+ */
+static inline __m128i sse2_load4px(const uint16_t *p)
+{
+	return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)p), _mm_setzero_si128());
+}
+
+static inline __m128i sse2_load4px(const uint32_t *p)
+{
+	return _mm_loadu_si128((const __m128i*)p);
+}
+
+/**
+ * Get the per-component absolute difference of two YUV vectors.
+ * @param a, b YUV values. (0x00YYUUVV)
+ * @return |a-b| for each byte.
+ */
+static inline __m128i sse2_yuvAbsDiff(__m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+}
+
+/**
+ * xBR: Distance between two YUV vectors.
+ * @param a, b YUV values. (0x00YYUUVV)
+ * @return |Y1-Y2| + |U1-U2| + |V1-V2| for each lane.
+ */
+static inline __m128i sse2_yuvDist(__m128i a, __m128i b)
+{
+	const __m128i ad = sse2_yuvAbsDiff(a, b);
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	return _mm_add_epi32(_mm_add_epi32(_mm_and_si128(ad, mask),
+		_mm_and_si128(_mm_srli_epi32(ad, 8), mask)), _mm_srli_epi32(ad, 16));
+}
+
+/**
+ * hq2x/hq3x: Scale one line. (SSE2)
+ * The difference patterns are calculated four pixels at a time.
+ * Pixels whose neighbors all match exactly are filled in directly.
+ * The first and last pixels are handled by the generic version,
+ * since their neighbors are clamped.
+ * @param dest Destination lines.
+ * @param src Source lines. (above, current, below)
+ * @param yuv YUV lines. (above, current, below)
+ * @param w Source width.
+ */
+template<typename Fmt, int factor>
+void ScalerPrivate::T_hqxLine_SSE2(typename Fmt::pixel *const *dest,
+	const typename Fmt::pixel *const *src, const uint32_t *const *yuv, int w)
+{
+	typedef typename Fmt::pixel pixel;
+	T_hqxLine<Fmt, factor>(dest, src, yuv, 0, (w < 1 ? w : 1), w);
+
+	// Thresholds: Y == 48, U == 7, V == 6
+	const __m128i thresh = _mm_set1_epi32(0x00300706);
+	const __m128i zero = _mm_setzero_si128();
+	const pixel mask = (pixel)(Fmt::MASK_RB | Fmt::MASK_G);
+	ALIGN(16) int32_t k[4];
+	pixel nw[9];
+	uint32_t ny[9];
+
+	int x = 1;
+	for (; x + 4 < w; x += 4) {
+		__m128i vy[9];
+		__m128i flat = _mm_set1_epi32(-1);
+		const __m128i e = sse2_load4px(&src[1][x]);
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				vy[i*3+j] = _mm_loadu_si128((const __m128i*)&yuv[i][x+j-1]);
+				if (i != 1 || j != 1) {
+					flat = _mm_and_si128(flat,
+						_mm_cmpeq_epi32(e, sse2_load4px(&src[i][x+j-1])));
+				}
+			}
+		}
+
+		const int flatBits = _mm_movemask_ps(_mm_castsi128_ps(flat));
+		if (flatBits != 0xF) {
+			// Difference pattern.
+			__m128i vk = zero;
+			for (int n = 0; n < 9; n++) {
+				if (n == 4)
+					continue;
+				const __m128i over = _mm_subs_epu8(sse2_yuvAbsDiff(vy[4], vy[n]), thresh);
+				const __m128i similar = _mm_cmpeq_epi32(over, zero);
+				vk = _mm_or_si128(vk, _mm_andnot_si128(similar,
+					_mm_set1_epi32(1 << hqxPatternBit[n])));
+			}
+			_mm_store_si128((__m128i*)k, vk);
+		}
+
+		for (int l = 0; l < 4; l++) {
+			const int xl = x + l;
+			if (flatBits & (1 << l)) {
+				// Interpolating identical pixels only drops the alpha channel.
+				const pixel px = src[1][xl];
+				T_fillBlock<pixel, factor>(dest, xl, (pixel)(px & mask));
+				if (factor == 3) {
+					dest[1][xl*3+1] = px;
+				}
+				continue;
+			}
+
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
+					nw[i*3+j] = src[i][xl+j-1];
+					ny[i*3+j] = yuv[i][xl+j-1];
+				}
+			}
+			T_hqxPixel<Fmt, factor>(dest, xl, nw, ny, k[l]);
+		}
+	}
+
+	T_hqxLine<Fmt, factor>(dest, src, yuv, x, w, w);
+}
+
+/**
+ * xBR: Scale one line. (SSE2)
+ * The edge distances for all four corners are calculated
+ * four pixels at a time. Pixels where no corner is blended
+ * are filled in directly.
+ * The first and last two pixels are handled by the generic version,
+ * since their neighbors are clamped.
+ * @param dest Destination lines.
+ * @param src Source lines. (y-2 to y+2)
+ * @param yuv YUV lines. (y-2 to y+2)
+ * @param w Source width.
+ */
+template<typename Fmt, int factor>
+void ScalerPrivate::T_xbrLine_SSE2(typename Fmt::pixel *const *dest,
+	const typename Fmt::pixel *const *src, const uint32_t *const *yuv, int w)
+{
+	typedef typename Fmt::pixel pixel;
+	int x = (w < 2 ? w : 2);
+	T_xbrLine<Fmt, factor>(dest, src, yuv, 0, x, w);
+
+	ALIGN(16) uint32_t ev[4][4], iv[4][4];
+	unsigned int ei[8];
+	pixel nw[25];
+	uint32_t ny[25];
+
+	for (; x + 6 <= w; x += 4) {
+		// Corners can only be blended if E != F && E != H.
+		// (rotated for each corner)
+		const __m128i e = sse2_load4px(&src[2][x]);
+		const __m128i eqB = _mm_cmpeq_epi32(e, sse2_load4px(&src[1][x]));
+		const __m128i eqD = _mm_cmpeq_epi32(e, sse2_load4px(&src[2][x-1]));
+		const __m128i eqF = _mm_cmpeq_epi32(e, sse2_load4px(&src[2][x+1]));
+		const __m128i eqH = _mm_cmpeq_epi32(e, sse2_load4px(&src[3][x]));
+		const __m128i skip[4] = {
+			_mm_or_si128(eqH, eqF),	// bottom-right
+			_mm_or_si128(eqB, eqF),	// top-right
+			_mm_or_si128(eqB, eqD),	// top-left
+			_mm_or_si128(eqD, eqH),	// bottom-left
+		};
+		if (_mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(
+		    _mm_and_si128(skip[0], skip[1]), _mm_and_si128(skip[2], skip[3])))) == 0xF)
+		{
+			// No corners can be blended.
+			for (int l = 0; l < 4; l++) {
+				T_fillBlock<pixel, factor>(dest, x + l, src[2][x + l]);
+			}
+			continue;
+		}
+
+		// Edge distances for each corner.
+		__m128i vy[25];
+		for (int i = 0; i < 5; i++) {
+			for (int j = 0; j < 5; j++) {
+				vy[i*5+j] = _mm_loadu_si128((const __m128i*)&yuv[i][x+j-2]);
+			}
+		}
+
+		__m128i blend = _mm_setzero_si128();
+		for (int r = 0; r < 4; r++) {
+			const uint8_t *const p = xbrRot[r];
+			const __m128i ve = _mm_add_epi32(
+				_mm_add_epi32(
+					_mm_add_epi32(sse2_yuvDist(vy[p[XBR_E]], vy[p[XBR_C]]),
+						      sse2_yuvDist(vy[p[XBR_E]], vy[p[XBR_G]])),
+					_mm_add_epi32(sse2_yuvDist(vy[p[XBR_I]], vy[p[XBR_H5]]),
+						      sse2_yuvDist(vy[p[XBR_I]], vy[p[XBR_F4]]))),
+				_mm_slli_epi32(sse2_yuvDist(vy[p[XBR_H]], vy[p[XBR_F]]), 2));
+			const __m128i vi = _mm_add_epi32(
+				_mm_add_epi32(
+					_mm_add_epi32(sse2_yuvDist(vy[p[XBR_H]], vy[p[XBR_D]]),
+						      sse2_yuvDist(vy[p[XBR_H]], vy[p[XBR_I5]])),
+					_mm_add_epi32(sse2_yuvDist(vy[p[XBR_F]], vy[p[XBR_I4]]),
+						      sse2_yuvDist(vy[p[XBR_F]], vy[p[XBR_B]]))),
+				_mm_slli_epi32(sse2_yuvDist(vy[p[XBR_E]], vy[p[XBR_I]]), 2));
+			_mm_store_si128((__m128i*)ev[r], ve);
+			_mm_store_si128((__m128i*)iv[r], vi);
+
+			// Corners are blended if e <= i.
+			blend = _mm_or_si128(blend, _mm_andnot_si128(
+				_mm_or_si128(skip[r], _mm_cmpgt_epi32(ve, vi)), _mm_set1_epi32(-1)));
+		}
+
+		const int blendBits = _mm_movemask_ps(_mm_castsi128_ps(blend));
+		for (int l = 0; l < 4; l++) {
+			const int xl = x + l;
+			if (!(blendBits & (1 << l))) {
+				T_fillBlock<pixel, factor>(dest, xl, src[2][xl]);
+				continue;
+			}
+
+			for (int r = 0; r < 4; r++) {
+				ei[r*2] = ev[r][l];
+				ei[r*2+1] = iv[r][l];
+			}
+			T_xbrNeighborhood(nw, ny, src, yuv, xl, w);
+			T_xbrPixel<Fmt, factor>(dest, xl, nw, ny, ei);
+		}
+	}
+
+	T_xbrLine<Fmt, factor>(dest, src, yuv, x, w, w);
+}
+
+}
@@ -40,6 +40,14 @@ using std::string;
 // Maybe fixChecksum() / restoreChecksum() should be moved to EmuMD.
 #include "cpu/M68K_Mem.hpp"
 
+// Idle loop detection.
+#include "cpu/M68K.hpp"
+#include "cpu/Z80.hpp"
+
+// ROM profile database.
+#include "Cartridge/RomCartridgeMD.hpp"
+#include "Cartridge/RomProfileDB.hpp"
+
 namespace LibGens
 {
 
@@ -61,6 +69,8 @@ bool EmuContext::ms_AutoFixChecksum = false;
 string EmuContext::ms_PathSRam;
 string EmuContext::ms_TmssRomFilename;
 bool EmuContext::ms_TmssEnabled = false;
+int EmuContext::ms_ZomgVersion = 1;
+RomProfileDB *EmuContext::ms_RomProfileDB = nullptr;
 
 
 /**
@@ -141,4 +151,96 @@ void EmuContext::SetPathSRam(const std::string &newPathSRam)
 	// TODO: Update SRam/EEPRom classes in active contexts.
 }
 
+/**
+ * Skip idle loops in the Z80?
+ * @return True if idle loops are skipped; false if not.
+ */
+bool EmuContext::IdleLoopSkip(void)
+{
+	return Z80::IdleLoopSkip();
+}
+
+/**
+ * Skip idle loops in the Z80?
+ * @param idleLoopSkip True to skip idle loops; false to interpret them normally.
+ */
+void EmuContext::SetIdleLoopSkip(bool idleLoopSkip)
+{
+	Z80::SetIdleLoopSkip(idleLoopSkip);
+}
+
+/**
+ * Skip idle loops in the M68K?
+ * @return True if idle loops are skipped; false if not.
+ */
+bool EmuContext::M68KIdleLoopSkip(void)
+{
+	return M68K::IdleLoopSkip();
+}
+
+/**
+ * Skip idle loops in the M68K?
+ * @param idleLoopSkip True to skip idle loops; false to interpret them normally.
+ */
+void EmuContext::SetM68KIdleLoopSkip(bool idleLoopSkip)
+{
+	M68K::SetIdleLoopSkip(idleLoopSkip);
+}
+
+/**
+ * Load the ROM profile database. [static]
+ * @param filename ROM profile database filename.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int EmuContext::LoadRomProfileDB(const std::string &filename)
+{
+	RomProfileDB *db = new RomProfileDB();
+	int ret = db->open(filename.c_str());
+	if (ret != 0) {
+		// Keep the previous database, if any.
+		delete db;
+		return ret;
+	}
+
+	delete ms_RomProfileDB;
+	ms_RomProfileDB = db;
+	return 0;
+}
+
+/**
+ * Unload the ROM profile database. [static]
+ */
+void EmuContext::UnloadRomProfileDB(void)
+{
+	delete ms_RomProfileDB;
+	ms_RomProfileDB = nullptr;
+}
+
+/**
+ * Get the ROM profile for the loaded ROM.
+ * @return ROM profile, or nullptr if the ROM doesn't have one.
+ */
+const RomProfile *EmuContext::romProfile(void) const
+{
+	if (!M68K_Mem::ms_RomCartridge)
+		return nullptr;
+	return M68K_Mem::ms_RomCartridge->romProfile();
+}
+
+/**
+ * Apply VDP options from the ROM profile.
+ * This must be called after the ROM is loaded.
+ */
+void EmuContext::applyRomProfile(void)
+{
+	const RomProfile *profile = romProfile();
+	if (!profile)
+		return;
+
+	if (profile->has(RomProfile::FIELD_SPRITE_LIMITS))
+		m_vdp->options.spriteLimits = profile->spriteLimits;
+	if (profile->has(RomProfile::FIELD_ZERO_LENGTH_DMA))
+		m_vdp->options.zeroLengthDMA = profile->zeroLengthDMA;
+}
+
 }
@@ -42,6 +42,9 @@
 
 namespace LibGens {
 
+class RomProfileDB;
+struct RomProfile;
+
 class EmuContext
 {
 	public:
@@ -150,6 +153,35 @@ class EmuContext
 		static inline void SetAutoFixChecksum(bool newAutoFixChecksum)
 			{ ms_AutoFixChecksum = newAutoFixChecksum; }
 
+		/**
+		 * Skip idle loops in the Z80?
+		 * This doesn't change the emulated result; it only
+		 * avoids interpreting polling loops that can't exit
+		 * until the next scheduled event.
+		 */
+		static bool IdleLoopSkip(void);
+		static void SetIdleLoopSkip(bool idleLoopSkip);
+
+		/**
+		 * Skip idle loops in the M68K?
+		 * This is separate from IdleLoopSkip(), since M68K
+		 * idle loop detection hasn't been verified against
+		 * as many games yet. (Default is disabled.)
+		 */
+		static bool M68KIdleLoopSkip(void);
+		static void SetM68KIdleLoopSkip(bool idleLoopSkip);
+
+		/**
+		 * ZOMG format version used for new savestates.
+		 * 1 == ZOMG v1 (one Zip member per block)
+		 * 2 == ZOMG v2 (binary blocks in one LZ4 payload)
+		 * Savestates of either version can always be loaded.
+		 */
+		static inline int ZomgVersion(void)
+			{ return ms_ZomgVersion; }
+		static inline void SetZomgVersion(int zomgVersion)
+			{ ms_ZomgVersion = (zomgVersion == 2 ? 2 : 1); }
+
 		/**
 		 * Pathnames.
 		 */
@@ -166,6 +198,26 @@ class EmuContext
 		static void SetTmssEnabled(bool tmssEnabled)
 			{ ms_TmssEnabled = tmssEnabled; }
 
+		/**
+		 * ROM profile database.
+		 * This should be loaded before creating an emulation context.
+		 * ROMs are looked up in the database when they're loaded.
+		 */
+		static int LoadRomProfileDB(const std::string &filename);
+		static void UnloadRomProfileDB(void);
+		static inline const RomProfileDB *RomProfileDatabase(void)
+			{ return ms_RomProfileDB; }
+
+		/**
+		 * Get the ROM profile for the loaded ROM.
+		 * Cartridge settings and VDP options from the profile
+		 * are applied by the emulation context. Frontend settings,
+		 * e.g. idle loop skipping and the audio resampler, are
+		 * left to the frontend.
+		 * @return ROM profile, or nullptr if the ROM doesn't have one.
+		 */
+		const RomProfile *romProfile(void) const;
+
 		/** VDP (TODO) **/
 		Vdp *m_vdp;
 
@@ -179,6 +231,12 @@ class EmuContext
 		Rom *m_rom;
 		bool m_saveDataEnable;
 
+		/**
+		 * Apply VDP options from the ROM profile.
+		 * This must be called after the ROM is loaded.
+		 */
+		void applyRomProfile(void);
+
 		/**
 		 * System version register.
 		 */
@@ -194,6 +252,8 @@ class EmuContext
 		static std::string ms_PathSRam;
 		static std::string ms_TmssRomFilename;
 		static bool ms_TmssEnabled;
+		static int ms_ZomgVersion;
+		static RomProfileDB *ms_RomProfileDB;
 
 	private:
 		static int ms_RefCount;
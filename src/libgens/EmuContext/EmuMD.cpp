@@ -36,6 +36,9 @@
 // LibGens OSD handler.
 #include "lg_osd.h"
 
+// Profiler.
+#include "Util/Profiler.hpp"
+
 // ROM cartridge.
 #include "Cartridge/RomCartridgeMD.hpp"
 
@@ -56,6 +59,11 @@ namespace LibGens {
  */
 EmuMD::EmuMD(Rom *rom, SysVersion::RegionCode_t region )
 	: EmuContext(rom, region)
+	, m_mclkPerLine(0)
+	, m_frameMclk(0)
+	, m_ymTimerMclk(0)
+	, m_lineEndMclk(0)
+	, m_z80Exec(false)
 {
 	// Load the ROM image.
 	m_rom = rom;	// NOTE: This is already done in EmuContext::EmuContext()...
@@ -89,6 +97,9 @@ EmuMD::EmuMD(Rom *rom, SysVersion::RegionCode_t region )
 	if (AutoFixChecksum())
 		M68K_Mem::ms_RomCartridge->fixChecksum();
 
+	// Apply VDP options from the ROM profile.
+	applyRomProfile();
+
 	// Initialize TMSS.
 	// NOTE: This must be done *before* calling InitSys(), since
 	// Starscream initializes the internal program counter on reset.
@@ -118,12 +129,22 @@ EmuMD::EmuMD(Rom *rom, SysVersion::RegionCode_t region )
 	m_sysVersion.setDisk(false);	// No MCD connected.
 	setRegion_int(region, false);	// Initialize region code.
 
+	// Subsystems that need to schedule events.
+	SoundMgr::ms_Ym2612.setTimerWriteFn(ymTimerWriteFn, this);
+	m_ioManager->setThTimeoutFn(thTimeoutFn, this);
+	m_vdp->setDmaStartFn(dmaStartFn, this);
+
 	// Finished initializing.
 	return;
 }
 
 EmuMD::~EmuMD()
 {
+	// Unregister the scheduler callbacks.
+	SoundMgr::ms_Ym2612.setTimerWriteFn(nullptr, nullptr);
+	m_ioManager->setThTimeoutFn(nullptr, nullptr);
+	m_vdp->setDmaStartFn(nullptr, nullptr);
+
 	// TODO: Other stuff?
 	M68K::EndSys();
 
@@ -264,6 +285,10 @@ int EmuMD::setRegion_int(SysVersion::RegionCode_t region, bool preserveState)
 		M68K_Mem::CPL_Z80 = Round_Double((((double)CLOCK_NTSC / 15.0) / 60.0) / 262.0);
 	}
 
+	// The scheduler uses the M68K clock as its time base,
+	// so every line has exactly CPL_M68K M68K cycles.
+	m_mclkPerLine = (M68K_Mem::CPL_M68K * MCLK_PER_M68K);
+
 	// Initialize audio.
 	// NOTE: Only set the region. Sound rate is set by the UI.
 	SoundMgr::SetRegion(m_sysVersion.isPal(), preserveState);
@@ -321,101 +346,264 @@ void EmuMD::initTmss(void)
 }
 
 /**
- * Run a scanline.
- * @param LineType Line type.
+ * Get the current master clock cycle.
+ * This is based on the odometer of the CPU that's running,
+ * so it can be used while handling a CPU write.
+ * @return Current master clock cycle.
+ */
+inline int32_t EmuMD::currentMclk(void) const
+{
+	if (m_z80Exec) {
+		// The Z80 lags behind the M68K. Convert its
+		// position within the current line.
+		const int z80Left = M68K_Mem::Cycles_Z80 - (int)Z80::ReadOdometer();
+		return m_lineEndMclk - ((z80Left * m_mclkPerLine) / M68K_Mem::CPL_Z80);
+	}
+	return (int32_t)M68K::ReadOdometer() * MCLK_PER_M68K;
+}
+
+/**
+ * Run the M68K until the specified master clock cycle.
+ * @param mclk Master clock cycle.
+ */
+FORCE_INLINE void EmuMD::execM68K(int32_t mclk)
+{
+	M68K::Exec(mclk / MCLK_PER_M68K);
+}
+
+/**
+ * Run the Z80 until the specified number of cycles
+ * before the end of the current line.
+ * The Z80 only runs at the end of each line and before
+ * VINT, the same as the old per-line loop.
+ * @param odo Z80 cycles before the end of the line.
+ */
+FORCE_INLINE void EmuMD::execZ80(int odo)
+{
+	m_z80Exec = true;
+	Z80::Exec(odo);
+	m_z80Exec = false;
+}
+
+/**
+ * Advance the YM2612 timers to the specified master clock cycle.
+ * @param mclk Master clock cycle.
+ */
+void EmuMD::updateYmTimers(int32_t mclk)
+{
+	const int ticks = (mclk - m_ymTimerMclk) / MCLK_PER_YM_TICK;
+	if (ticks > 0) {
+		SoundMgr::ms_Ym2612.updateTimers(ticks);
+		m_ymTimerMclk += (ticks * MCLK_PER_YM_TICK);
+	}
+}
+
+/**
+ * Schedule the next YM2612 timer overflow.
+ * The timer counters are relative to m_ymTimerMclk.
+ */
+void EmuMD::scheduleYmTimer(void)
+{
+	const int ticks = SoundMgr::ms_Ym2612.timerTicksToEvent();
+	if (ticks < 0) {
+		// No timer overflows would change anything.
+		m_scheduler.cancel(SCHED_YM_TIMER);
+	} else {
+		m_scheduler.schedule(SCHED_YM_TIMER, m_ymTimerMclk + (ticks * MCLK_PER_YM_TICK));
+	}
+}
+
+/**
+ * YM2612 timer register is about to be written.
+ * @param param EmuMD.
+ */
+void EmuMD::ymTimerWriteFn(void *param)
+{
+	EmuMD *const emuMD = static_cast<EmuMD*>(param);
+	const int32_t mclk = emuMD->currentMclk();
+
+	// Advance the timers using the old register values,
+	// then check the timers again once the CPU stops.
+	emuMD->updateYmTimers(mclk);
+	emuMD->m_scheduler.schedule(SCHED_YM_TIMER, mclk);
+}
+
+/**
+ * TH timeout was started or stopped.
+ * @param param EmuMD.
+ * @param physPort Physical port number.
+ * @param start True to start the timeout; false to stop it.
+ */
+void EmuMD::thTimeoutFn(void *param, int physPort, bool start)
+{
+	EmuMD *const emuMD = static_cast<EmuMD*>(param);
+	const int id = SCHED_IO_TIMEOUT_1 + physPort;
+	if (start) {
+		emuMD->m_scheduler.schedule(id, emuMD->currentMclk() +
+			(IoManager::TH_TIMEOUT_LINES * emuMD->m_mclkPerLine));
+	} else {
+		emuMD->m_scheduler.cancel(id);
+	}
+}
+
+/**
+ * VDP DMA operation was started.
+ * @param param EmuMD.
+ */
+void EmuMD::dmaStartFn(void *param)
+{
+	// DMA is processed at the start of each line.
+	// NOTE: SCHED_LINE for the next line has already been
+	// scheduled, so it will be processed before SCHED_DMA.
+	EmuMD *const emuMD = static_cast<EmuMD*>(param);
+	const int nextLine = emuMD->m_vdp->VDP_Lines.currentLine + 1;
+	emuMD->m_scheduler.schedule(SCHED_DMA, nextLine * emuMD->m_mclkPerLine);
+}
+
+/**
+ * SCHED_LINE: Start of a line.
  * @param VDP If true, VDP is updated.
+ * @param mclk Master clock cycle.
  */
-template<EmuMD::LineType_t LineType, bool VDP>
-FORCE_INLINE void EmuMD::T_execLine(void)
+template<bool VDP>
+FORCE_INLINE void EmuMD::T_lineStart(int32_t mclk)
 {
-	int writePos = SoundMgr::GetWritePos(m_vdp->VDP_Lines.currentLine);
-	int32_t *bufL = &SoundMgr::ms_SegBufL[writePos];
-	int32_t *bufR = &SoundMgr::ms_SegBufR[writePos];
+	// Finish the previous line on the Z80.
+	execZ80(0);
+
+	const int line = (mclk / m_mclkPerLine);
+	const int32_t lineEnd = mclk + m_mclkPerLine;
+	m_lineEndMclk = lineEnd;
+	m_vdp->VDP_Lines.currentLine = line;
 
 	// Update the sound chips.
-	int writeLen = SoundMgr::GetWriteLen(m_vdp->VDP_Lines.currentLine);
-	SoundMgr::ms_Ym2612.updateDacAndTimers(bufL, bufR, writeLen);
+	// FM and PSG output is rendered on demand, so only
+	// the DAC has to be written here, if it's active.
+	const int writeLen = SoundMgr::GetWriteLen(line);
+	if (SoundMgr::ms_Ym2612.isDacActive()) {
+		const int writePos = SoundMgr::GetWritePos(line);
+		SoundMgr::ms_Ym2612.updateDac(&SoundMgr::ms_SegBufL[writePos],
+					      &SoundMgr::ms_SegBufR[writePos], writeLen);
+	}
 	SoundMgr::ms_Ym2612.addWriteLen(writeLen);
 	SoundMgr::ms_Psg.addWriteLen(writeLen);
 
-	// Notify controllers that a new scanline is being drawn.
-	m_ioManager->doScanline();
-
-	// Increment the cycles counter.
+	// Set the cycle counters to the end of the line.
 	// These values are the "last cycle to execute".
 	// e.g. if Cycles_M68K is 5000, then we'll execute instructions
 	// until the 68000's "odometer" reaches 5000.
-	M68K_Mem::Cycles_M68K += M68K_Mem::CPL_M68K;
-	M68K_Mem::Cycles_Z80 += M68K_Mem::CPL_Z80;
-
-	if (m_vdp->DMAT_Length)
-		M68K::AddCycles(m_vdp->updateDMA());
-
-	switch (LineType) {
-		case LINETYPE_ACTIVEDISPLAY:
-			// In visible area.
-			m_vdp->setStatusBit(VdpStatus::VDP_STATUS_HBLANK, true);	// HBlank = 1
-			M68K::Exec(M68K_Mem::Cycles_M68K - 404);
-			m_vdp->setStatusBit(VdpStatus::VDP_STATUS_HBLANK, false);	// HBlank = 0
-
-			// Decrement the HInt counter.
-			// If it goes below 0, an HBLANK interrupt will occur.
-			// The counter will then be reloaded.
-			m_vdp->decrementHIntCounter(true);
-			break;
-
-		case LINETYPE_VBLANKLINE: {
-			// VBlank line!
-			// Decrement the HInt counter.
-			// If it goes below 0, an HBLANK interrupt will occur.
-			m_vdp->decrementHIntCounter(false);
+	M68K_Mem::LineStart_M68K = mclk / MCLK_PER_M68K;
+	M68K_Mem::Cycles_M68K = lineEnd / MCLK_PER_M68K;
+	M68K_Mem::Cycles_Z80 = (line + 1) * M68K_Mem::CPL_Z80;
+
+	if (line < m_vdp->VDP_Lines.totalVisibleLines) {
+		// In visible area.
+		m_vdp->setStatusBit(VdpStatus::VDP_STATUS_HBLANK, true);	// HBlank = 1
+		m_scheduler.schedule(SCHED_HBLANK_END, lineEnd - (M68K_HBLANK_END * MCLK_PER_M68K));
+	} else if (line == m_vdp->VDP_Lines.totalVisibleLines) {
+		// VBlank line!
+		// Decrement the HInt counter.
+		// If it goes below 0, an HBLANK interrupt will occur.
+		m_vdp->decrementHIntCounter(false);
 
 #if 0
-			// TODO: Congratulations! (LibGens)
-			CONGRATULATIONS_PRECHECK();
+		// TODO: Congratulations! (LibGens)
+		CONGRATULATIONS_PRECHECK();
 #endif
-			// VBlank = 1 et HBlank = 1 (retour de balayage vertical en cours)
-			m_vdp->setStatusBit(VdpStatus::VDP_STATUS_HBLANK, true);
-			m_vdp->setStatusBit(VdpStatus::VDP_STATUS_VBLANK, true);
-
-			// If we're using NTSC V30 and this is an "even" frame,
-			// don't set the VBlank flag.
-			if (m_vdp->VDP_Lines.NTSC_V30.VBlank_Div != 0)
-				m_vdp->setStatusBit(VdpStatus::VDP_STATUS_VBLANK, false);
+		// VBlank = 1 et HBlank = 1 (retour de balayage vertical en cours)
+		m_vdp->setStatusBit(VdpStatus::VDP_STATUS_HBLANK, true);
+		m_vdp->setStatusBit(VdpStatus::VDP_STATUS_VBLANK, true);
 
-			M68K::Exec(M68K_Mem::Cycles_M68K - 360);
-			Z80::Exec(168);
-#if 0
-			// TODO: Congratulations! (LibGens)
-			CONGRATULATIONS_POSTCHECK();
-#endif
+		// If we're using NTSC V30 and this is an "even" frame,
+		// don't set the VBlank flag.
+		if (m_vdp->VDP_Lines.NTSC_V30.VBlank_Div != 0)
+			m_vdp->setStatusBit(VdpStatus::VDP_STATUS_VBLANK, false);
 
-			m_vdp->setStatusBit(VdpStatus::VDP_STATUS_HBLANK, false);	// HBlank = 0
-			if (m_vdp->VDP_Lines.NTSC_V30.VBlank_Div == 0) {
-				m_vdp->setStatusBit(VdpStatus::VDP_STATUS_F, true);	// V Int happened
-				m_vdp->updateIRQLine(0x8);
+		m_scheduler.schedule(SCHED_VINT, lineEnd - (M68K_VINT * MCLK_PER_M68K));
+	} else {
+		// Border line.
+		if (VDP) {
+			// VDP needs to be updated.
+			m_vdp->renderLine();
+		}
+	}
 
-				// Z80 interrupt.
-				// TODO: Does this trigger on all VBlanks,
-				// or only if VINTs are enabled in the VDP?
-				Z80::Interrupt(0xFF);
-			}
+	// Schedule the next line.
+	if (line + 1 < m_vdp->VDP_Lines.totalDisplayLines) {
+		m_scheduler.schedule(SCHED_LINE, lineEnd);
+	} else {
+		m_scheduler.schedule(SCHED_FRAME_END, lineEnd);
+	}
+}
 
-			break;
-		}
+/**
+ * SCHED_DMA: Continue a DMA operation.
+ * @param mclk Master clock cycle.
+ */
+FORCE_INLINE void EmuMD::doDma(int32_t mclk)
+{
+	if (!m_vdp->DMAT_Length) {
+		// DMA was cancelled, e.g. by a VDP reset.
+		return;
+	}
 
-		case LINETYPE_BORDER:
-		default:
-			break;
+	M68K::AddCycles(m_vdp->updateDMA());
+	if (m_vdp->DMAT_Length) {
+		// DMA isn't finished yet.
+		m_scheduler.schedule(SCHED_DMA, mclk + m_mclkPerLine);
 	}
+}
+
+/**
+ * SCHED_HBLANK_END: End of HBlank on an active display line.
+ * @param VDP If true, VDP is updated.
+ */
+template<bool VDP>
+FORCE_INLINE void EmuMD::T_hblankEnd(void)
+{
+	m_vdp->setStatusBit(VdpStatus::VDP_STATUS_HBLANK, false);	// HBlank = 0
+
+	// Decrement the HInt counter.
+	// If it goes below 0, an HBLANK interrupt will occur.
+	// The counter will then be reloaded.
+	m_vdp->decrementHIntCounter(true);
 
 	if (VDP) {
 		// VDP needs to be updated.
 		m_vdp->renderLine();
 	}
+}
 
-	M68K::Exec(M68K_Mem::Cycles_M68K);
-	Z80::Exec(0);
+/**
+ * SCHED_VINT: VINT on the VBlank line.
+ * @param VDP If true, VDP is updated.
+ */
+template<bool VDP>
+FORCE_INLINE void EmuMD::T_vint(void)
+{
+	// The Z80 runs until shortly before VINT.
+	execZ80(Z80_VINT);
+
+#if 0
+	// TODO: Congratulations! (LibGens)
+	CONGRATULATIONS_POSTCHECK();
+#endif
+
+	m_vdp->setStatusBit(VdpStatus::VDP_STATUS_HBLANK, false);	// HBlank = 0
+	if (m_vdp->VDP_Lines.NTSC_V30.VBlank_Div == 0) {
+		m_vdp->setStatusBit(VdpStatus::VDP_STATUS_F, true);	// V Int happened
+		m_vdp->updateIRQLine(0x8);
+
+		// Z80 interrupt.
+		// TODO: Does this trigger on all VBlanks,
+		// or only if VINTs are enabled in the VDP?
+		Z80::Interrupt(0xFF);
+	}
+
+	if (VDP) {
+		// VDP needs to be updated.
+		m_vdp->renderLine();
+	}
 }
 
 /**
@@ -425,6 +613,8 @@ FORCE_INLINE void EmuMD::T_execLine(void)
 template<bool VDP>
 FORCE_INLINE void EmuMD::T_execFrame(void)
 {
+	PROFILE_FRAME_BEGIN();
+
 	// Initialize Vdp::VDP_Lines.
 	// Reset the current VDP line variables for the new frame.
 	m_vdp->updateVdpLines(true);
@@ -439,6 +629,8 @@ FORCE_INLINE void EmuMD::T_execFrame(void)
 	SoundMgr::ResetPtrsAndLens();
 
 	// Clear all of the cycle counters.
+	M68K_Mem::LineStart_M68K = 0;
+	m_lineEndMclk = 0;
 	M68K_Mem::Cycles_M68K = 0;
 	M68K_Mem::Cycles_Z80 = 0;
 	M68K_Mem::Last_BUS_REQ_Cnt = -1000;
@@ -460,42 +652,84 @@ FORCE_INLINE void EmuMD::T_execFrame(void)
 	// the HINT counter, and clears the VBLANK flag.
 	m_vdp->startFrame();
 
-	/** Main execution loops. **/
-
-	/** Visible line 0. **/
-	m_vdp->VDP_Lines.currentLine = 0;
-
-	/** Loop 1: Active display. **/
-	do {
-		T_execLine<LINETYPE_ACTIVEDISPLAY, VDP>();
-
-		// Next line.
-		m_vdp->VDP_Lines.currentLine++;
-	} while (m_vdp->VDP_Lines.currentLine < m_vdp->VDP_Lines.totalVisibleLines);
-
-	/** Loop 2: VBlank line. **/
-	T_execLine<LINETYPE_VBLANKLINE, VDP>();
-	m_vdp->VDP_Lines.currentLine++;
+	/** Main execution loop. **/
+	// The CPUs run until the next scheduled event,
+	// then all events that are due are processed.
+	// Each line schedules the next one, and the
+	// last line schedules the end of the frame.
+
+	// Events that were still pending at the end of the
+	// previous frame (e.g. TH timeouts) are carried over.
+	m_scheduler.rebase(m_frameMclk);
+	m_ymTimerMclk -= m_frameMclk;
+	m_scheduler.schedule(SCHED_LINE, 0);
+
+	// DMA and YM2612 timer events are rescheduled from the
+	// current state, since it may have been changed by a
+	// reset or a savestate. SCHED_DMA must be scheduled
+	// after SCHED_LINE so it's processed after the line starts.
+	if (m_vdp->DMAT_Length) {
+		m_scheduler.schedule(SCHED_DMA, 0);
+	} else {
+		m_scheduler.cancel(SCHED_DMA);
+	}
+	scheduleYmTimer();
 
-	/** Loop 3: Borders. **/
+	bool frameDone = false;
 	do {
-		T_execLine<LINETYPE_BORDER, VDP>();
+		const int32_t mclk = m_scheduler.nextCycle();
+		execM68K(mclk);
+
+		int id;
+		while (!frameDone && (id = m_scheduler.popDue(mclk)) >= 0) {
+			switch (id) {
+				case SCHED_LINE:
+					T_lineStart<VDP>(mclk);
+					break;
+				case SCHED_HBLANK_END:
+					T_hblankEnd<VDP>();
+					break;
+				case SCHED_VINT:
+					T_vint<VDP>();
+					break;
+				case SCHED_DMA:
+					doDma(mclk);
+					break;
+				case SCHED_YM_TIMER:
+					updateYmTimers(mclk);
+					scheduleYmTimer();
+					break;
+				case SCHED_IO_TIMEOUT_1:
+				case SCHED_IO_TIMEOUT_2:
+				case SCHED_IO_TIMEOUT_EXT:
+					m_ioManager->thTimeout(id - SCHED_IO_TIMEOUT_1);
+					break;
+				case SCHED_FRAME_END:
+				default:
+					// Other events on this cycle are
+					// processed in the next frame.
+					execZ80(0);
+					m_frameMclk = mclk;
+					frameDone = true;
+					break;
+			}
+		}
+	} while (!frameDone);
+	m_vdp->VDP_Lines.currentLine = m_vdp->VDP_Lines.totalDisplayLines;
 
-		// Next line.
-		m_vdp->VDP_Lines.currentLine++;
-	} while (m_vdp->VDP_Lines.currentLine < m_vdp->VDP_Lines.totalDisplayLines);
+	// Advance the YM2612 timers to the end of the frame.
+	// If no timer events are scheduled, this is the only
+	// thing that keeps m_ymTimerMclk from falling behind.
+	updateYmTimers(m_frameMclk);
 
 	// Update the PSG and YM2612 output.
 	SoundMgr::SpecialUpdate();
 
-#if 0
-	// If WAV or GYM is being dumped, update the WAV or GYM.
-	// TODO: VGM dumping
-	if (WAV_Dumping)
-		wav_dump_update();
-	if (GYM_Dumping)
-		gym_dump_update(0, 0, 0);
-#endif
+	// Finish profiling the frame.
+	PROFILE_FRAME_END(M68K::ReadOdometer(), M68K_Mem::Cycles_Z80);
+
+	// NOTE: WAV, VGM, and video dumping is handled by
+	// LibGens::Capture, which the UI calls after each frame.
 
 	// TODO: MDP. (LibGens)
 #if 0
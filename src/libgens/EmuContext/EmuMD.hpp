@@ -25,6 +25,8 @@
 #define __LIBGENS_EMUCONTEXT_EMUMD_HPP__
 
 #include "EmuContext.hpp"
+#include "Scheduler.hpp"
+#include "../sound/Ym2612.hpp"
 
 // Needed for FORCE_INLINE.
 #include "../macros/common.h"
@@ -98,16 +100,142 @@ class EmuMD : public EmuContext
 
 	protected:
 		/**
-		 * Line types.
+		 * Master clock timing.
+		 * Lines are CPL_M68K M68K cycles long, so the
+		 * M68K timing is the same as the old per-line loop.
 		 */
-		enum LineType_t {
-			LINETYPE_ACTIVEDISPLAY	= 0,
-			LINETYPE_VBLANKLINE	= 1,
-			LINETYPE_BORDER		= 2,
+		static const int MCLK_PER_M68K = 7;
+
+		// HBlank ends 404 M68K cycles before the end of the line.
+		static const int M68K_HBLANK_END = 404;
+		// VINT occurs 360 M68K cycles before the end of the VBlank line.
+		static const int M68K_VINT = 360;
+		// Before VINT, the Z80 runs until 168 Z80 cycles
+		// before the end of the VBlank line.
+		static const int Z80_VINT = 168;
+		// The YM2612 is clocked by the M68K clock.
+		static const int MCLK_PER_YM_TICK = Ym2612::CLOCKS_PER_TIMER_TICK * MCLK_PER_M68K;
+
+		// Master clock cycles per line. (CPL_M68K * MCLK_PER_M68K)
+		int32_t m_mclkPerLine;
+
+		/**
+		 * Scheduler events.
+		 */
+		enum SchedEvent_t {
+			SCHED_LINE		= 0,	// Start of a line.
+			SCHED_HBLANK_END	= 1,	// End of HBlank. (active display; HINT)
+			SCHED_VINT		= 2,	// VINT. (VBlank line)
+			SCHED_FRAME_END		= 3,	// End of the frame.
+			SCHED_DMA		= 4,	// DMA update. (start of a line)
+			SCHED_YM_TIMER		= 5,	// YM2612 timer overflow.
+			SCHED_IO_TIMEOUT_1	= 6,	// TH timeout: Port 1
+			SCHED_IO_TIMEOUT_2	= 7,	// TH timeout: Port 2
+			SCHED_IO_TIMEOUT_EXT	= 8,	// TH timeout: EXT port
+
+			SCHED_MAX
 		};
 
-		template<LineType_t LineType, bool VDP>
-		FORCE_INLINE void T_execLine(void);
+		Scheduler m_scheduler;
+
+		// Master clock cycle of the end of the previous frame.
+		// Pending events are rebased by this value
+		// at the start of the next frame.
+		int32_t m_frameMclk;
+
+		// Master clock cycle the YM2612 timers were last updated.
+		int32_t m_ymTimerMclk;
+
+		// Master clock cycle of the end of the current line.
+		int32_t m_lineEndMclk;
+
+		// True while the Z80 is running.
+		bool m_z80Exec;
+
+		/**
+		 * Get the current master clock cycle.
+		 * This is based on the odometer of the CPU that's running,
+		 * so it can be used while handling a CPU write.
+		 * @return Current master clock cycle.
+		 */
+		inline int32_t currentMclk(void) const;
+
+		/**
+		 * Run the M68K until the specified master clock cycle.
+		 * @param mclk Master clock cycle.
+		 */
+		FORCE_INLINE void execM68K(int32_t mclk);
+
+		/**
+		 * Run the Z80 until the specified number of cycles
+		 * before the end of the current line.
+		 * The Z80 only runs at the end of each line and before
+		 * VINT, the same as the old per-line loop.
+		 * @param odo Z80 cycles before the end of the line.
+		 */
+		FORCE_INLINE void execZ80(int odo);
+
+		/**
+		 * Advance the YM2612 timers to the specified master clock cycle.
+		 * @param mclk Master clock cycle.
+		 */
+		void updateYmTimers(int32_t mclk);
+
+		/**
+		 * Schedule the next YM2612 timer overflow.
+		 * The timer counters are relative to m_ymTimerMclk.
+		 */
+		void scheduleYmTimer(void);
+
+		/**
+		 * SCHED_DMA: Continue a DMA operation.
+		 * @param mclk Master clock cycle.
+		 */
+		FORCE_INLINE void doDma(int32_t mclk);
+
+		/** Callbacks from subsystems. **/
+
+		/**
+		 * YM2612 timer register is about to be written.
+		 * @param param EmuMD.
+		 */
+		static void ymTimerWriteFn(void *param);
+
+		/**
+		 * TH timeout was started or stopped.
+		 * @param param EmuMD.
+		 * @param physPort Physical port number.
+		 * @param start True to start the timeout; false to stop it.
+		 */
+		static void thTimeoutFn(void *param, int physPort, bool start);
+
+		/**
+		 * VDP DMA operation was started.
+		 * @param param EmuMD.
+		 */
+		static void dmaStartFn(void *param);
+
+		/**
+		 * SCHED_LINE: Start of a line.
+		 * @param VDP If true, VDP is updated.
+		 * @param mclk Master clock cycle.
+		 */
+		template<bool VDP>
+		FORCE_INLINE void T_lineStart(int32_t mclk);
+
+		/**
+		 * SCHED_HBLANK_END: End of HBlank on an active display line.
+		 * @param VDP If true, VDP is updated.
+		 */
+		template<bool VDP>
+		FORCE_INLINE void T_hblankEnd(void);
+
+		/**
+		 * SCHED_VINT: VINT on the VBlank line.
+		 * @param VDP If true, VDP is updated.
+		 */
+		template<bool VDP>
+		FORCE_INLINE void T_vint(void);
 
 		template<bool VDP>
 		FORCE_INLINE void T_execFrame(void);
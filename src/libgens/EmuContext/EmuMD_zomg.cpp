@@ -214,7 +214,9 @@ int EmuMD::zomgLoad(const char *filename)
 int EmuMD::zomgSave(const char *filename) const
 {
 	// TODO: More comprehensive error reporting.
-	LibZomg::Zomg zomg(filename, LibZomg::Zomg::ZOMG_SAVE);
+	LibZomg::Zomg zomg(filename, LibZomg::Zomg::ZOMG_SAVE,
+		(ms_ZomgVersion == 2 ? LibZomg::Zomg::ZOMG_FORMAT_V2
+				     : LibZomg::Zomg::ZOMG_FORMAT_V1));
 	if (!zomg.isOpen())
 		return -ENOENT;
 
@@ -330,9 +332,10 @@ int EmuMD::zomgSave(const char *filename) const
 
 	// Close the savestate.
 	zomg.close();
-	
+
 	// Savestate saved.
-	return 0;
+	// (ZOMG v2 writes the payload on close.)
+	return zomg.lastError();
 }
 
 }
@@ -38,6 +38,9 @@
 // LibGens OSD handler.
 #include "lg_osd.h"
 
+// Profiler.
+#include "Util/Profiler.hpp"
+
 // C includes. (C++ namespace)
 #include <cstdio>
 #include <cmath>
@@ -88,6 +91,9 @@ EmuPico::EmuPico(Rom *rom, SysVersion::RegionCode_t region )
 	if (AutoFixChecksum())
 		M68K_Mem::ms_RomCartridge->fixChecksum();
 
+	// Apply VDP options from the ROM profile.
+	applyRomProfile();
+
 	// Initialize the M68K.
 	M68K::InitSys(M68K::SYSID_PICO);
 
@@ -294,6 +300,7 @@ FORCE_INLINE void EmuPico::T_execLine(void)
 	// These values are the "last cycle to execute".
 	// e.g. if Cycles_M68K is 5000, then we'll execute instructions
 	// until the 68000's "odometer" reaches 5000.
+	M68K_Mem::LineStart_M68K = M68K_Mem::Cycles_M68K;
 	M68K_Mem::Cycles_M68K += M68K_Mem::CPL_M68K;
 
 	if (m_vdp->DMAT_Length)
@@ -366,6 +373,8 @@ FORCE_INLINE void EmuPico::T_execLine(void)
 template<bool VDP>
 FORCE_INLINE void EmuPico::T_execFrame(void)
 {
+	PROFILE_FRAME_BEGIN();
+
 	// Initialize Vdp::VDP_Lines.
 	// Reset the current VDP line variables for the new frame.
 	m_vdp->updateVdpLines(true);
@@ -424,14 +433,11 @@ FORCE_INLINE void EmuPico::T_execFrame(void)
 	// Update the PSG and YM2612 output.
 	SoundMgr::SpecialUpdate();
 
-#if 0
-	// If WAV or GYM is being dumped, update the WAV or GYM.
-	// TODO: VGM dumping
-	if (WAV_Dumping)
-		wav_dump_update();
-	if (GYM_Dumping)
-		gym_dump_update(0, 0, 0);
-#endif
+	// Finish profiling the frame.
+	PROFILE_FRAME_END(M68K::ReadOdometer(), 0);
+
+	// NOTE: WAV, VGM, and video dumping is handled by
+	// LibGens::Capture, which the UI calls after each frame.
 
 	// TODO: MDP . (LibGens)
 #if 0
@@ -149,7 +149,9 @@ int EmuPico::zomgLoad(const char *filename)
 int EmuPico::zomgSave(const char *filename) const
 {
 	// TODO: More comprehensive error reporting.
-	LibZomg::Zomg zomg(filename, LibZomg::Zomg::ZOMG_SAVE);
+	LibZomg::Zomg zomg(filename, LibZomg::Zomg::ZOMG_SAVE,
+		(ms_ZomgVersion == 2 ? LibZomg::Zomg::ZOMG_FORMAT_V2
+				     : LibZomg::Zomg::ZOMG_FORMAT_V1));
 	if (!zomg.isOpen())
 		return -ENOENT;
 
@@ -223,9 +225,10 @@ int EmuPico::zomgSave(const char *filename) const
 
 	// Close the savestate.
 	zomg.close();
-	
+
 	// Savestate saved.
-	return 0;
+	// (ZOMG v2 writes the payload on close.)
+	return zomg.lastError();
 }
 
 }
@@ -1,10 +1,8 @@
 /***************************************************************************
- * mdZ80: Gens Z80 Emulator                                                *
- * mdZ80_DAA.h: Decimal Adjust Accumulator.                                *
+ * libgens: Gens Emulation Library.                                        *
+ * Scheduler.cpp: Master clock event scheduler.                            *
  *                                                                         *
- * Copyright (c) 1999-2002 by Stéphane Dallongeville                       *
- * Copyright (c) 2003-2004 by Stéphane Akhoun                              *
- * Copyright (c) 2008 by David Korth                                       *
+ * Copyright (c) 2016 by David Korth.                                      *
  *                                                                         *
  * This program is free software; you can redistribute it and/or modify it *
  * under the terms of the GNU General Public License as published by the   *
@@ -21,17 +19,44 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
  ***************************************************************************/
 
-#ifndef __MDZ80_DAA_H
-#define __MDZ80_DAA_H
+#include "Scheduler.hpp"
 
-#ifdef __cplusplus
-extern "C" {
-#endif
+namespace LibGens {
 
-extern const unsigned short mdZ80_DAA_Table[256 * 8];
+Scheduler::Scheduler()
+{
+	reset();
+}
+
+/**
+ * Remove all events.
+ */
+void Scheduler::reset(void)
+{
+	m_mask = 0;
+	m_seqNext = 0;
+	m_nextCycle = NEVER;
+	m_nextId = -1;
+}
 
-#ifdef __cplusplus
+/**
+ * Subtract a number of cycles from all scheduled events.
+ * This is used at the end of a frame, when the
+ * master clock cycle counter is reset.
+ * @param cycles Number of cycles.
+ */
+void Scheduler::rebase(int32_t cycles)
+{
+	// Subtracting the same value from every event
+	// doesn't change the order.
+	for (int i = 0; i < MAX_EVENTS; i++) {
+		if (m_mask & (1U << i)) {
+			m_cycle[i] -= cycles;
+		}
+	}
+	if (m_nextId >= 0) {
+		m_nextCycle -= cycles;
+	}
 }
-#endif
 
-#endif /* __MDZ80_DAA_H */
+}
@@ -0,0 +1,245 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Scheduler.hpp: Master clock event scheduler.                            *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_EMUCONTEXT_SCHEDULER_HPP__
+#define __LIBGENS_EMUCONTEXT_SCHEDULER_HPP__
+
+// C includes.
+#include <stdint.h>
+#include <assert.h>
+
+namespace LibGens {
+
+/**
+ * Master clock event scheduler.
+ *
+ * Events are identified by a small integer ID, and each ID
+ * can be scheduled at most once. Events are returned in order
+ * of absolute master clock cycle; events scheduled for the
+ * same cycle are returned in the order they were scheduled.
+ *
+ * The emulation loop runs the CPUs until nextCycle(), then
+ * calls popDue() to get the events that are due. Subsystems
+ * that don't have anything to do don't schedule events, so
+ * they don't cost anything.
+ *
+ * NOTE: There are only a few events, so they're stored in a
+ * table indexed by ID, and the next event is cached. This is
+ * much faster than a heap for the number of events we have.
+ */
+class Scheduler
+{
+	public:
+		Scheduler();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		Scheduler(const Scheduler &);
+		Scheduler &operator=(const Scheduler &);
+
+	public:
+		// Maximum number of event IDs.
+		static const int MAX_EVENTS = 16;
+
+		// Cycle value returned by nextCycle() if no events are scheduled.
+		static const int32_t NEVER = 0x7FFFFFFF;
+
+		/**
+		 * Remove all events.
+		 */
+		void reset(void);
+
+		/**
+		 * Schedule an event.
+		 * If the event is already scheduled, it's moved.
+		 * @param id Event ID. (0 to MAX_EVENTS-1)
+		 * @param cycle Absolute master clock cycle.
+		 */
+		inline void schedule(int id, int32_t cycle);
+
+		/**
+		 * Cancel an event.
+		 * Nothing happens if the event isn't scheduled.
+		 * @param id Event ID.
+		 */
+		inline void cancel(int id);
+
+		/**
+		 * Is an event scheduled?
+		 * @param id Event ID.
+		 * @return True if scheduled; false if not.
+		 */
+		inline bool isScheduled(int id) const;
+
+		/**
+		 * Get the cycle of the next event.
+		 * @return Cycle of the next event, or NEVER if no events are scheduled.
+		 */
+		inline int32_t nextCycle(void) const;
+
+		/**
+		 * Remove the next event if it's due.
+		 * @param cycle Current master clock cycle.
+		 * @return Event ID, or -1 if no events are due.
+		 */
+		inline int popDue(int32_t cycle);
+
+		/**
+		 * Subtract a number of cycles from all scheduled events.
+		 * This is used at the end of a frame, when the
+		 * master clock cycle counter is reset.
+		 * @param cycles Number of cycles.
+		 */
+		void rebase(int32_t cycles);
+
+	private:
+		int32_t m_cycle[MAX_EVENTS];
+		uint32_t m_seq[MAX_EVENTS];	// Tiebreaker for events on the same cycle.
+		uint32_t m_mask;		// Bitfield of scheduled event IDs.
+		uint32_t m_seqNext;
+
+		// Cached next event.
+		int32_t m_nextCycle;
+		int m_nextId;
+
+		inline bool isBefore(int a, int b) const;
+		inline void findNext(void);
+};
+
+/**
+ * Is event a before event b?
+ * @param a Event ID.
+ * @param b Event ID.
+ * @return True if a is before b.
+ */
+inline bool Scheduler::isBefore(int a, int b) const
+{
+	if (m_cycle[a] != m_cycle[b])
+		return (m_cycle[a] < m_cycle[b]);
+	// Sequence numbers may wrap around.
+	return ((int32_t)(m_seq[a] - m_seq[b]) < 0);
+}
+
+/**
+ * Find the next event and cache it.
+ */
+inline void Scheduler::findNext(void)
+{
+	if (m_mask == 0) {
+		m_nextCycle = NEVER;
+		m_nextId = -1;
+		return;
+	}
+
+	uint32_t mask = m_mask;
+	int best = -1;
+	do {
+#if defined(__GNUC__)
+		const int id = __builtin_ctz(mask);
+#else
+		int id = 0;
+		while (!(mask & (1U << id)))
+			id++;
+#endif
+		mask &= (mask - 1);
+		if (best < 0 || isBefore(id, best))
+			best = id;
+	} while (mask != 0);
+
+	m_nextCycle = m_cycle[best];
+	m_nextId = best;
+}
+
+/**
+ * Schedule an event.
+ * If the event is already scheduled, it's moved.
+ * @param id Event ID. (0 to MAX_EVENTS-1)
+ * @param cycle Absolute master clock cycle.
+ */
+inline void Scheduler::schedule(int id, int32_t cycle)
+{
+	assert(id >= 0 && id < MAX_EVENTS);
+	m_cycle[id] = cycle;
+	m_seq[id] = m_seqNext++;
+	m_mask |= (1U << id);
+
+	if (id == m_nextId) {
+		// The next event was moved.
+		findNext();
+	} else if (m_nextId < 0 || isBefore(id, m_nextId)) {
+		m_nextCycle = cycle;
+		m_nextId = id;
+	}
+}
+
+/**
+ * Cancel an event.
+ * Nothing happens if the event isn't scheduled.
+ * @param id Event ID.
+ */
+inline void Scheduler::cancel(int id)
+{
+	assert(id >= 0 && id < MAX_EVENTS);
+	m_mask &= ~(1U << id);
+	if (id == m_nextId) {
+		findNext();
+	}
+}
+
+/**
+ * Is an event scheduled?
+ * @param id Event ID.
+ * @return True if scheduled; false if not.
+ */
+inline bool Scheduler::isScheduled(int id) const
+{
+	return !!(m_mask & (1U << id));
+}
+
+/**
+ * Get the cycle of the next event.
+ * @return Cycle of the next event, or NEVER if no events are scheduled.
+ */
+inline int32_t Scheduler::nextCycle(void) const
+{
+	return m_nextCycle;
+}
+
+/**
+ * Remove the next event if it's due.
+ * @param cycle Current master clock cycle.
+ * @return Event ID, or -1 if no events are due.
+ */
+inline int Scheduler::popDue(int32_t cycle)
+{
+	if (m_nextCycle > cycle)
+		return -1;
+
+	const int id = m_nextId;
+	m_mask &= ~(1U << id);
+	findNext();
+	return id;
+}
+
+}
+
+#endif /* __LIBGENS_EMUCONTEXT_SCHEDULER_HPP__ */
@@ -60,6 +60,7 @@ void Device::reset(void)
  */
 void Device::resetDev(void) {
 	counter = 0;
+	thTimeout = THT_NONE;
 	buttons = ~0;
 	buttons_prev = ~0;
 	deviceData = 0xFF;
@@ -137,13 +138,13 @@ void Device::update(void)
 }
 
 /**
- * One scanline worth of time has passed.
+ * The TH timeout has expired.
  * Needed for some devices that reset after a period of time,
  * e.g. 6BTN controllers.
  */
-void Device::update_onScanline(void)
+void Device::update_onThTimeout(void)
 {
-	// We don't care about the onScanline event
+	// We don't care about the onThTimeout event
 	// in the base class, but the function needs
 	// to exist in the vtable.
 }
@@ -84,6 +84,21 @@ class Device
 		int counter;			// Internal counter.
 		uint8_t deviceData;		// Data written from the device.
 
+		/**
+		 * TH timeout request.
+		 * Some devices, e.g. 6BTN controllers, reset their
+		 * internal counter if TH doesn't change for around
+		 * 25 scanlines. update() sets this field to start
+		 * or stop the timeout; IoManager handles the request
+		 * and resets the field to THT_NONE.
+		 */
+		enum ThTimeout_t {
+			THT_NONE	= 0,	// No change.
+			THT_START	= 1,	// Start (or restart) the timeout.
+			THT_STOP	= 2,	// Stop the timeout.
+		};
+		uint8_t thTimeout;
+
 		// System-side variables.
 		uint8_t ctrl;			// Tristate control.
 		uint8_t mdData;			// Data written from the MD.
@@ -153,6 +168,22 @@ class Device
 			return this->buttons;
 		}
 
+		/**
+		 * Get the absolute X coordinate.
+		 * @return Absolute X coordinate, or -1 if offscreen.
+		 */
+		inline int absX(void) const {
+			return m_abs_x;
+		}
+
+		/**
+		 * Get the absolute Y coordinate.
+		 * @return Absolute Y coordinate, or -1 if offscreen.
+		 */
+		inline int absY(void) const {
+			return m_abs_y;
+		}
+
 		/**
 		 * Check an input line's state.
 		 * @param ioPin I/O pin, or multiple pins.
@@ -214,11 +245,11 @@ class Device
 		virtual void update(void);
 
 		/**
-		 * One scanline worth of time has passed.
+		 * The TH timeout has expired.
 		 * Needed for some devices that reset after a period of time,
 		 * e.g. 6BTN controllers.
 		 */
-		virtual void update_onScanline(void);
+		virtual void update_onThTimeout(void);
 
 		/**
 		 * Device port was read.
@@ -0,0 +1,805 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * InputMovie.cpp: Input movie recording and playback.                     *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "InputMovie.hpp"
+#include "IoManager.hpp"
+#include "EmuContext/EmuContext.hpp"
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+// C++ includes.
+#include <string>
+#include <vector>
+using std::string;
+using std::vector;
+
+// zlib is used for crc32().
+#include <zlib.h>
+
+namespace LibGens {
+
+/**
+ * InputMovie private class.
+ */
+class InputMoviePrivate
+{
+	public:
+		InputMoviePrivate();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		InputMoviePrivate(const InputMoviePrivate &);
+		InputMoviePrivate &operator=(const InputMoviePrivate &);
+
+	public:
+		static const uint8_t MAGIC[8];
+		static const uint32_t VERSION = 1;
+		static const int NUM_PORTS = IoManager::VIRTPORT_MAX;
+		static_assert(NUM_PORTS <= 32, "Port masks must fit in 32 bits.");
+
+		// Offset of frameCount in the header.
+		static const long FRAMECOUNT_OFFSET = 16;
+
+		// Write buffered data once this much has accumulated.
+		static const size_t FLUSH_SIZE = 64 * 1024;
+
+		// Record types.
+		enum RecordType {
+			REC_END		= 0x00,
+			REC_IDLE	= 0x01,
+			REC_FRAME	= 0x02,
+			REC_DEVTYPE	= 0x03,
+		};
+
+		InputMovie::Mode mode;
+		uint32_t curFrame;
+		uint32_t frameCount;
+
+		// I/O manager.
+		// Recording only reads from it.
+		IoManager *ioManager;
+
+		// Input state as of the previous frame.
+		uint32_t btn[NUM_PORTS];
+		int abs_x[NUM_PORTS];
+		int abs_y[NUM_PORTS];
+		uint8_t devType[NUM_PORTS];
+
+		/**
+		 * Reset the input state to the baseline
+		 * that the first frame is encoded against.
+		 */
+		void resetState(void);
+
+		/** Recording. **/
+		FILE *file;
+		vector<uint8_t> buf;
+		uint32_t idleCount;
+		int writeErr;
+
+		void putU8(uint8_t val)
+			{ buf.push_back(val); }
+		void putU16(uint16_t val);
+		void putU32(uint32_t val);
+		void putVarint(uint32_t val);
+		void putZigzag(int32_t val)
+			{ putVarint(((uint32_t)val << 1) ^ (uint32_t)(val >> 31)); }
+
+		/**
+		 * Write a pending REC_IDLE record, if any.
+		 */
+		void flushIdle(void);
+
+		/**
+		 * Write the buffered data to the file.
+		 */
+		void flushBuf(void);
+
+		int recordFrame(void);
+		int finishRecording(void);
+
+		/** Playback. **/
+		vector<uint8_t> data;
+		size_t pos;
+		uint32_t idleRemaining;
+
+		bool getU8(uint8_t *val);
+		bool getVarint(uint32_t *val);
+		bool getZigzag(int32_t *val);
+
+		int playFrame(void);
+
+		/**
+		 * Apply the current input state to the I/O manager.
+		 */
+		void applyState(void);
+
+		/** Start state. **/
+
+		/**
+		 * Get the CRC32 and size of a file.
+		 * @param filename Filename.
+		 * @param crc [out] CRC32.
+		 * @param size [out] Size.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		static int fileCrc32(const char *filename, uint32_t *crc, uint32_t *size);
+
+		/**
+		 * Find a movie's start state.
+		 * @param movieFilename Movie filename.
+		 * @param startState Start state filename, as stored in the movie.
+		 * @return Start state filename to use.
+		 */
+		static string findStartState(const char *movieFilename, const string &startState);
+};
+
+const uint8_t InputMoviePrivate::MAGIC[8] = {'G','E','N','S','M','O','V',0x1A};
+
+InputMoviePrivate::InputMoviePrivate()
+	: mode(InputMovie::MODE_NONE)
+	, curFrame(0)
+	, frameCount(0)
+	, ioManager(nullptr)
+	, file(nullptr)
+	, idleCount(0)
+	, writeErr(0)
+	, pos(0)
+	, idleRemaining(0)
+{
+	resetState();
+	memset(devType, 0, sizeof(devType));
+}
+
+/**
+ * Reset the input state to the baseline
+ * that the first frame is encoded against.
+ */
+void InputMoviePrivate::resetState(void)
+{
+	for (int i = 0; i < NUM_PORTS; i++) {
+		btn[i] = ~0U;
+		abs_x[i] = -1;
+		abs_y[i] = -1;
+	}
+}
+
+void InputMoviePrivate::putU16(uint16_t val)
+{
+	buf.push_back(val & 0xFF);
+	buf.push_back(val >> 8);
+}
+
+void InputMoviePrivate::putU32(uint32_t val)
+{
+	buf.push_back(val & 0xFF);
+	buf.push_back((val >> 8) & 0xFF);
+	buf.push_back((val >> 16) & 0xFF);
+	buf.push_back(val >> 24);
+}
+
+void InputMoviePrivate::putVarint(uint32_t val)
+{
+	while (val >= 0x80) {
+		buf.push_back((val & 0x7F) | 0x80);
+		val >>= 7;
+	}
+	buf.push_back(val);
+}
+
+/**
+ * Write a pending REC_IDLE record, if any.
+ */
+void InputMoviePrivate::flushIdle(void)
+{
+	if (idleCount > 0) {
+		putU8(REC_IDLE);
+		putVarint(idleCount);
+		idleCount = 0;
+	}
+}
+
+/**
+ * Write the buffered data to the file.
+ */
+void InputMoviePrivate::flushBuf(void)
+{
+	if (!buf.empty() && writeErr == 0) {
+		size_t size = fwrite(&buf[0], 1, buf.size(), file);
+		if (size != buf.size()) {
+			writeErr = (errno != 0 ? -errno : -EIO);
+		}
+	}
+	buf.clear();
+}
+
+int InputMoviePrivate::recordFrame(void)
+{
+	// Check for device type changes.
+	for (int i = 0; i < NUM_PORTS; i++) {
+		const uint8_t type = (uint8_t)ioManager->devType((IoManager::VirtPort_t)i);
+		if (type != devType[i]) {
+			flushIdle();
+			putU8(REC_DEVTYPE);
+			putU8((uint8_t)i);
+			putU8(type);
+			devType[i] = type;
+		}
+	}
+
+	// Check for input changes.
+	uint32_t new_btn[NUM_PORTS];
+	int new_x[NUM_PORTS], new_y[NUM_PORTS];
+	uint32_t btnMask = 0, absMask = 0;
+	for (int i = 0; i < NUM_PORTS; i++) {
+		new_btn[i] = ioManager->buttons(i);
+		ioManager->absolutePosition(i, &new_x[i], &new_y[i]);
+		if (new_btn[i] != btn[i])
+			btnMask |= (1U << i);
+		if (new_x[i] != abs_x[i] || new_y[i] != abs_y[i])
+			absMask |= (1U << i);
+	}
+
+	if (btnMask == 0 && absMask == 0) {
+		// No changes.
+		idleCount++;
+		if (idleCount == 0xFFFFFFFFU)
+			flushIdle();
+	} else {
+		flushIdle();
+		putU8(REC_FRAME);
+		putVarint(btnMask);
+		for (int i = 0; i < NUM_PORTS; i++) {
+			if (btnMask & (1U << i)) {
+				putVarint(new_btn[i] ^ btn[i]);
+				btn[i] = new_btn[i];
+			}
+		}
+		putVarint(absMask);
+		for (int i = 0; i < NUM_PORTS; i++) {
+			if (absMask & (1U << i)) {
+				putZigzag(new_x[i] - abs_x[i]);
+				putZigzag(new_y[i] - abs_y[i]);
+				abs_x[i] = new_x[i];
+				abs_y[i] = new_y[i];
+			}
+		}
+	}
+
+	curFrame++;
+	if (buf.size() >= FLUSH_SIZE)
+		flushBuf();
+	return writeErr;
+}
+
+int InputMoviePrivate::finishRecording(void)
+{
+	flushIdle();
+	putU8(REC_END);
+	flushBuf();
+
+	// Update the frame count in the header.
+	if (writeErr == 0) {
+		uint8_t fc[4];
+		fc[0] = curFrame & 0xFF;
+		fc[1] = (curFrame >> 8) & 0xFF;
+		fc[2] = (curFrame >> 16) & 0xFF;
+		fc[3] = curFrame >> 24;
+		if (fseek(file, FRAMECOUNT_OFFSET, SEEK_SET) != 0 ||
+		    fwrite(fc, 1, sizeof(fc), file) != sizeof(fc))
+		{
+			writeErr = (errno != 0 ? -errno : -EIO);
+		}
+	}
+
+	if (fclose(file) != 0 && writeErr == 0) {
+		writeErr = (errno != 0 ? -errno : -EIO);
+	}
+	file = nullptr;
+
+	int ret = writeErr;
+	writeErr = 0;
+	vector<uint8_t>().swap(buf);
+	return ret;
+}
+
+bool InputMoviePrivate::getU8(uint8_t *val)
+{
+	if (pos >= data.size())
+		return false;
+	*val = data[pos++];
+	return true;
+}
+
+bool InputMoviePrivate::getVarint(uint32_t *val)
+{
+	uint32_t ret = 0;
+	for (int shift = 0; shift < 35; shift += 7) {
+		uint8_t b;
+		if (!getU8(&b))
+			return false;
+		ret |= (uint32_t)(b & 0x7F) << shift;
+		if (!(b & 0x80)) {
+			*val = ret;
+			return true;
+		}
+	}
+
+	// Too many bytes.
+	return false;
+}
+
+bool InputMoviePrivate::getZigzag(int32_t *val)
+{
+	uint32_t zz;
+	if (!getVarint(&zz))
+		return false;
+	*val = (int32_t)((zz >> 1) ^ (0U - (zz & 1)));
+	return true;
+}
+
+int InputMoviePrivate::playFrame(void)
+{
+	if (idleRemaining > 0) {
+		// Input hasn't changed.
+		idleRemaining--;
+		applyState();
+		curFrame++;
+		return 0;
+	}
+
+	for (;;) {
+		uint8_t rec;
+		if (!getU8(&rec)) {
+			// End of data.
+			// The movie may have been truncated if the
+			// recording wasn't stopped properly.
+			return 1;
+		}
+
+		switch (rec) {
+			case REC_END:
+				return 1;
+
+			case REC_IDLE: {
+				uint32_t count;
+				if (!getVarint(&count) || count == 0)
+					return -EINVAL;
+				idleRemaining = count - 1;
+				applyState();
+				curFrame++;
+				return 0;
+			}
+
+			case REC_FRAME: {
+				uint32_t btnMask, absMask;
+				if (!getVarint(&btnMask))
+					return -EINVAL;
+				for (int i = 0; i < NUM_PORTS; i++) {
+					if (btnMask & (1U << i)) {
+						uint32_t btnXor;
+						if (!getVarint(&btnXor))
+							return -EINVAL;
+						btn[i] ^= btnXor;
+					}
+				}
+				if (!getVarint(&absMask))
+					return -EINVAL;
+				for (int i = 0; i < NUM_PORTS; i++) {
+					if (absMask & (1U << i)) {
+						int32_t dx, dy;
+						if (!getZigzag(&dx) || !getZigzag(&dy))
+							return -EINVAL;
+						abs_x[i] += dx;
+						abs_y[i] += dy;
+					}
+				}
+				applyState();
+				curFrame++;
+				return 0;
+			}
+
+			case REC_DEVTYPE: {
+				uint8_t port, type;
+				if (!getU8(&port) || !getU8(&type))
+					return -EINVAL;
+				if (port >= NUM_PORTS || type >= IoManager::IOT_MAX)
+					return -EINVAL;
+				devType[port] = type;
+				break;
+			}
+
+			default:
+				// Unknown record type.
+				return -EINVAL;
+		}
+	}
+}
+
+/**
+ * Apply the current input state to the I/O manager.
+ */
+void InputMoviePrivate::applyState(void)
+{
+	// NOTE: Device types are checked every frame in case
+	// the frontend changed them. Frontends shouldn't update
+	// the I/O manager themselves during playback.
+	for (int i = 0; i < NUM_PORTS; i++) {
+		const IoManager::VirtPort_t virtPort = (IoManager::VirtPort_t)i;
+		if (ioManager->devType(virtPort) != (IoManager::IoType_t)devType[i]) {
+			ioManager->setDevType(virtPort, (IoManager::IoType_t)devType[i]);
+		}
+	}
+
+	for (int i = 0; i < NUM_PORTS; i++) {
+		ioManager->updateRaw(i, btn[i]);
+
+		int x, y;
+		ioManager->absolutePosition(i, &x, &y);
+		if (x != abs_x[i] || y != abs_y[i]) {
+			ioManager->updateAbsolutePosition(i, abs_x[i], abs_y[i]);
+		}
+	}
+}
+
+/**
+ * Get the CRC32 and size of a file.
+ * @param filename Filename.
+ * @param crc [out] CRC32.
+ * @param size [out] Size.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int InputMoviePrivate::fileCrc32(const char *filename, uint32_t *crc, uint32_t *size)
+{
+	FILE *f = fopen(filename, "rb");
+	if (!f)
+		return (errno != 0 ? -errno : -EIO);
+
+	uLong c = crc32(0, nullptr, 0);
+	uint32_t total = 0;
+	uint8_t tmp[16384];
+	size_t n;
+	while ((n = fread(tmp, 1, sizeof(tmp), f)) > 0) {
+		c = crc32(c, tmp, (uInt)n);
+		total += (uint32_t)n;
+	}
+
+	const bool err = !!ferror(f);
+	fclose(f);
+	if (err)
+		return -EIO;
+
+	*crc = (uint32_t)c;
+	*size = total;
+	return 0;
+}
+
+/**
+ * Find a movie's start state.
+ * @param movieFilename Movie filename.
+ * @param startState Start state filename, as stored in the movie.
+ * @return Start state filename to use.
+ */
+string InputMoviePrivate::findStartState(const char *movieFilename, const string &startState)
+{
+	FILE *f = fopen(startState.c_str(), "rb");
+	if (f) {
+		fclose(f);
+		return startState;
+	}
+
+	// Not found. Check the movie's directory.
+	const char *const dirSep =
+#ifdef _WIN32
+		"/\\";
+#else
+		"/";
+#endif
+	const string movie(movieFilename);
+	size_t slash = movie.find_last_of(dirSep);
+	const string dir = (slash != string::npos ? movie.substr(0, slash + 1) : string());
+	slash = startState.find_last_of(dirSep);
+	const string base = (slash != string::npos ? startState.substr(slash + 1) : startState);
+	return dir + base;
+}
+
+/** InputMovie **/
+
+InputMovie::InputMovie()
+	: d(new InputMoviePrivate())
+{ }
+
+InputMovie::~InputMovie()
+{
+	stop();
+	delete d;
+}
+
+/**
+ * Get the current mode.
+ * @return Current mode.
+ */
+InputMovie::Mode InputMovie::mode(void) const
+{
+	return d->mode;
+}
+
+/**
+ * Get the number of frames recorded or played back so far.
+ * @return Current frame number.
+ */
+uint32_t InputMovie::curFrame(void) const
+{
+	return d->curFrame;
+}
+
+/**
+ * Get the total number of frames in the movie.
+ * Only valid during playback.
+ * @return Number of frames.
+ */
+uint32_t InputMovie::frameCount(void) const
+{
+	return d->frameCount;
+}
+
+/**
+ * Start recording a movie.
+ * Any movie that is currently active is stopped first.
+ * @param filename Movie filename.
+ * @param startState Start state filename.
+ * @param context Emulation context to save the start state from.
+ * If nullptr, startState must already exist.
+ * @param ioManager I/O manager to record.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int InputMovie::record(const char *filename, const char *startState,
+		       const EmuContext *context, const IoManager *ioManager)
+{
+	stop();
+
+	const size_t nameLen = strlen(startState);
+	if (nameLen > 0xFFFF)
+		return -ENAMETOOLONG;
+
+	int ret;
+	if (context) {
+		ret = context->zomgSave(startState);
+		if (ret != 0)
+			return ret;
+	}
+
+	uint32_t crc, size;
+	ret = InputMoviePrivate::fileCrc32(startState, &crc, &size);
+	if (ret != 0)
+		return ret;
+
+	d->file = fopen(filename, "wb");
+	if (!d->file)
+		return (errno != 0 ? -errno : -EIO);
+	// Data is written in large blocks, so stdio buffering isn't needed.
+	setvbuf(d->file, nullptr, _IONBF, 0);
+
+	// NOTE: Recording never modifies the I/O manager.
+	d->ioManager = const_cast<IoManager*>(ioManager);
+	d->resetState();
+	d->curFrame = 0;
+	d->frameCount = 0;
+	d->idleCount = 0;
+	d->writeErr = 0;
+
+	// Header.
+	d->buf.clear();
+	d->buf.reserve(InputMoviePrivate::FLUSH_SIZE + 1024);
+	d->buf.insert(d->buf.end(), InputMoviePrivate::MAGIC,
+		InputMoviePrivate::MAGIC + sizeof(InputMoviePrivate::MAGIC));
+	d->putU32(InputMoviePrivate::VERSION);
+	d->putU32(InputMoviePrivate::NUM_PORTS);
+	d->putU32(0);	// frameCount; filled in by stop().
+	d->putU32(crc);
+	d->putU32(size);
+	d->putU16((uint16_t)nameLen);
+	d->buf.insert(d->buf.end(), startState, startState + nameLen);
+	for (int i = 0; i < InputMoviePrivate::NUM_PORTS; i++) {
+		d->devType[i] = (uint8_t)ioManager->devType((IoManager::VirtPort_t)i);
+		d->putU8(d->devType[i]);
+	}
+
+	d->mode = MODE_RECORD;
+	return 0;
+}
+
+/**
+ * Start playing back a movie.
+ * Any movie that is currently active is stopped first.
+ * If the start state can't be found at the path stored in the
+ * movie, it will be looked for in the movie's directory.
+ * @param filename Movie filename.
+ * @param context Emulation context to load the start state into.
+ * If nullptr, the start state is verified but not loaded.
+ * @param ioManager I/O manager to play back to.
+ * @return 0 on success; -EBADMSG if the start state doesn't
+ * match the movie; other negative POSIX error code on error.
+ */
+int InputMovie::play(const char *filename, EmuContext *context, IoManager *ioManager)
+{
+	stop();
+
+	// Load the entire movie.
+	// Movies are small, and this avoids syscalls during playback.
+	FILE *f = fopen(filename, "rb");
+	if (!f)
+		return (errno != 0 ? -errno : -EIO);
+	vector<uint8_t> &data = d->data;
+	data.clear();
+	uint8_t tmp[16384];
+	size_t n;
+	while ((n = fread(tmp, 1, sizeof(tmp), f)) > 0) {
+		data.insert(data.end(), tmp, tmp + n);
+	}
+	const bool err = !!ferror(f);
+	fclose(f);
+	if (err) {
+		data.clear();
+		return -EIO;
+	}
+
+	// Parse the header.
+	static const size_t HEADER_SIZE = 8+4+4+4+4+4+2;
+	if (data.size() < HEADER_SIZE ||
+	    memcmp(&data[0], InputMoviePrivate::MAGIC, sizeof(InputMoviePrivate::MAGIC)) != 0)
+	{
+		data.clear();
+		return -EINVAL;
+	}
+
+	#define LE32(p) ((uint32_t)(p)[0] | ((uint32_t)(p)[1] << 8) | \
+			((uint32_t)(p)[2] << 16) | ((uint32_t)(p)[3] << 24))
+	const uint32_t version = LE32(&data[8]);
+	const uint32_t numPorts = LE32(&data[12]);
+	const uint32_t frameCount = LE32(&data[16]);
+	const uint32_t crc = LE32(&data[20]);
+	const uint32_t size = LE32(&data[24]);
+	#undef LE32
+	const size_t nameLen = data[28] | (data[29] << 8);
+	if (version != InputMoviePrivate::VERSION ||
+	    numPorts != (uint32_t)InputMoviePrivate::NUM_PORTS ||
+	    data.size() < HEADER_SIZE + nameLen + numPorts)
+	{
+		data.clear();
+		return -EINVAL;
+	}
+
+	const string startState((const char*)&data[HEADER_SIZE], nameLen);
+	uint8_t devType[InputMoviePrivate::NUM_PORTS];
+	memcpy(devType, &data[HEADER_SIZE + nameLen], sizeof(devType));
+	for (int i = 0; i < InputMoviePrivate::NUM_PORTS; i++) {
+		if (devType[i] >= IoManager::IOT_MAX) {
+			data.clear();
+			return -EINVAL;
+		}
+	}
+
+	// Verify the start state.
+	const string stateFilename = InputMoviePrivate::findStartState(filename, startState);
+	uint32_t stateCrc, stateSize;
+	int ret = InputMoviePrivate::fileCrc32(stateFilename.c_str(), &stateCrc, &stateSize);
+	if (ret != 0) {
+		data.clear();
+		return ret;
+	}
+	if (stateCrc != crc || stateSize != size) {
+		data.clear();
+		return -EBADMSG;
+	}
+
+	// Set the device types before loading the start state,
+	// since changing a device type resets the device.
+	d->ioManager = ioManager;
+	memcpy(d->devType, devType, sizeof(d->devType));
+	for (int i = 0; i < InputMoviePrivate::NUM_PORTS; i++) {
+		const IoManager::VirtPort_t virtPort = (IoManager::VirtPort_t)i;
+		if (ioManager->devType(virtPort) != (IoManager::IoType_t)devType[i]) {
+			ioManager->setDevType(virtPort, (IoManager::IoType_t)devType[i]);
+		}
+	}
+
+	if (context) {
+		ret = context->zomgLoad(stateFilename.c_str());
+		if (ret != 0) {
+			data.clear();
+			return ret;
+		}
+	}
+
+	d->resetState();
+	d->pos = HEADER_SIZE + nameLen + numPorts;
+	d->idleRemaining = 0;
+	d->curFrame = 0;
+	d->frameCount = frameCount;
+	d->mode = MODE_PLAYBACK;
+	return 0;
+}
+
+/**
+ * Process one frame of input.
+ * This must be called once per frame, after the frontend
+ * has updated the I/O manager and before the frame is run.
+ * - Recording: The I/O manager's input state is recorded.
+ * - Playback: The I/O manager's input state is replaced
+ *   with the recorded state.
+ * @return 0 on success; 1 if playback has finished;
+ * negative POSIX error code on error.
+ * If playback finishes or an error occurs, the movie is stopped.
+ */
+int InputMovie::frame(void)
+{
+	int ret;
+	switch (d->mode) {
+		case MODE_RECORD:
+			ret = d->recordFrame();
+			break;
+		case MODE_PLAYBACK:
+			ret = d->playFrame();
+			break;
+		default:
+			return 0;
+	}
+
+	if (ret != 0) {
+		// Playback finished, or an error occurred.
+		const int stopRet = stop();
+		if (ret == 1 && stopRet != 0)
+			ret = stopRet;
+	}
+	return ret;
+}
+
+/**
+ * Stop recording or playing back the movie.
+ * When recording, the movie file is finalized.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int InputMovie::stop(void)
+{
+	int ret = 0;
+	switch (d->mode) {
+		case MODE_RECORD:
+			ret = d->finishRecording();
+			break;
+		case MODE_PLAYBACK:
+			vector<uint8_t>().swap(d->data);
+			d->pos = 0;
+			break;
+		default:
+			break;
+	}
+
+	d->mode = MODE_NONE;
+	d->ioManager = nullptr;
+	return ret;
+}
+
+}
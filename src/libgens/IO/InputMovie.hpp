@@ -0,0 +1,156 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * InputMovie.hpp: Input movie recording and playback.                     *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_IO_INPUTMOVIE_HPP__
+#define __LIBGENS_IO_INPUTMOVIE_HPP__
+
+// C includes.
+#include <stdint.h>
+
+namespace LibGens {
+
+class EmuContext;
+class IoManager;
+
+class InputMoviePrivate;
+
+/**
+ * Input movie.
+ *
+ * Records the input state of every virtual port once per frame,
+ * and plays it back bit-exactly. Each movie is anchored to a
+ * ZOMG savestate that is loaded before the first frame.
+ *
+ * File format: (all multi-byte values are little-endian)
+ * - Header:
+ *   - char magic[8]: "GENSMOV\x1A"
+ *   - uint32_t version: 1
+ *   - uint32_t numPorts: IoManager::VIRTPORT_MAX
+ *   - uint32_t frameCount
+ *   - uint32_t startStateCrc32: CRC32 of the start state file.
+ *   - uint32_t startStateSize: Size of the start state file.
+ *   - uint16_t startStateNameLen, followed by the filename. (not NULL-terminated)
+ *   - uint8_t devType[numPorts]: Initial device types.
+ * - Records: (integers are unsigned LEB128 unless noted otherwise)
+ *   - 0x00: End of movie.
+ *   - 0x01 count: count frames with no input changes.
+ *   - 0x02 btnMask {btnXor}* absMask {dx dy}*: One frame.
+ *     For each port set in btnMask, the new button state
+ *     XOR'd with the previous button state. For each port
+ *     set in absMask, the change in absolute position.
+ *     (zigzag-encoded signed values)
+ *   - 0x03 port devType: Device type change, applied to the next frame.
+ *
+ * Recorded data is buffered in memory and written to disk in
+ * large blocks, so recording doesn't make a syscall every frame.
+ */
+class InputMovie
+{
+	public:
+		InputMovie();
+		~InputMovie();
+
+	private:
+		friend class InputMoviePrivate;
+		InputMoviePrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		InputMovie(const InputMovie &);
+		InputMovie &operator=(const InputMovie &);
+
+	public:
+		enum Mode {
+			MODE_NONE	= 0,	// Not active.
+			MODE_RECORD	= 1,	// Recording.
+			MODE_PLAYBACK	= 2,	// Playing back.
+		};
+
+		/**
+		 * Get the current mode.
+		 * @return Current mode.
+		 */
+		Mode mode(void) const;
+
+		/**
+		 * Get the number of frames recorded or played back so far.
+		 * @return Current frame number.
+		 */
+		uint32_t curFrame(void) const;
+
+		/**
+		 * Get the total number of frames in the movie.
+		 * Only valid during playback.
+		 * @return Number of frames.
+		 */
+		uint32_t frameCount(void) const;
+
+		/**
+		 * Start recording a movie.
+		 * Any movie that is currently active is stopped first.
+		 * @param filename Movie filename.
+		 * @param startState Start state filename.
+		 * @param context Emulation context to save the start state from.
+		 * If nullptr, startState must already exist.
+		 * @param ioManager I/O manager to record.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int record(const char *filename, const char *startState,
+			   const EmuContext *context, const IoManager *ioManager);
+
+		/**
+		 * Start playing back a movie.
+		 * Any movie that is currently active is stopped first.
+		 * If the start state can't be found at the path stored in the
+		 * movie, it will be looked for in the movie's directory.
+		 * @param filename Movie filename.
+		 * @param context Emulation context to load the start state into.
+		 * If nullptr, the start state is verified but not loaded.
+		 * @param ioManager I/O manager to play back to.
+		 * @return 0 on success; -EBADMSG if the start state doesn't
+		 * match the movie; other negative POSIX error code on error.
+		 */
+		int play(const char *filename, EmuContext *context, IoManager *ioManager);
+
+		/**
+		 * Process one frame of input.
+		 * This must be called once per frame, after the frontend
+		 * has updated the I/O manager and before the frame is run.
+		 * - Recording: The I/O manager's input state is recorded.
+		 * - Playback: The I/O manager's input state is replaced
+		 *   with the recorded state.
+		 * @return 0 on success; 1 if playback has finished;
+		 * negative POSIX error code on error.
+		 * If playback finishes or an error occurs, the movie is stopped.
+		 */
+		int frame(void);
+
+		/**
+		 * Stop recording or playing back the movie.
+		 * When recording, the movie file is finalized.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int stop(void);
+};
+
+}
+
+#endif /* __LIBGENS_IO_INPUTMOVIE_HPP__ */
@@ -44,7 +44,6 @@ Io6BTN::Io6BTN()
 void Io6BTN::resetDev(void)
 {
 	Device::resetDev();	// TODO: typedef super?
-	this->scanlines = 0;
 }
 
 /**
@@ -71,8 +70,8 @@ void Io6BTN::update(void)
 		// Increment the counter.
 		this->counter = ((this->counter + 2) & 0x06);
 
-		// Reset the scanline counter.
-		this->scanlines = 0;
+		// Restart the TH timeout.
+		this->thTimeout = THT_START;
 	}
 
 	// Use the TH counter to determine the controller state.
@@ -127,20 +126,18 @@ void Io6BTN::update(void)
 }
 
 /**
- * One scanline worth of time has passed.
+ * The TH timeout has expired.
  * Needed for some devices that reset after a period of time,
  * e.g. 6BTN controllers.
  */
-void Io6BTN::update_onScanline(void)
+void Io6BTN::update_onThTimeout(void)
 {
-	static const int SCANLINE_COUNT_MAX_6BTN = 25;
-	this->scanlines++;
-	if (this->scanlines > SCANLINE_COUNT_MAX_6BTN) {
-		// Scanline counter has reached its maximum value.
-		// Reset both counters.
-		this->counter = 0;
-		this->scanlines = 0;
-	}
+	// No TH rising edges for around 25 scanlines.
+	// Reset the TH counter.
+	this->counter = 0;
+
+	// Update the device data for the new counter value.
+	this->update();
 }
 
 } }
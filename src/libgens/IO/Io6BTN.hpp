@@ -56,15 +56,11 @@ class Io6BTN : public Device
 		virtual void update(void) final;
 
 		/**
-		 * One scanline worth of time has passed.
+		 * The TH timeout has expired.
 		 * Needed for some devices that reset after a period of time,
 		 * e.g. 6BTN controllers.
 		 */
-		virtual void update_onScanline(void) final;
-
-	private:
-		// Scanline counter.
-		int scanlines;
+		virtual void update_onThTimeout(void) final;
 };
 
 } }
@@ -44,6 +44,9 @@ using std::string;
 // ARRAY_SIZE(x)
 #include "macros/common.h"
 
+// Profiler.
+#include "Util/Profiler.hpp"
+
 namespace LibGens
 {
 
@@ -67,20 +70,59 @@ void IoManager::reset(void)
 			dev->reset();
 		}
 	}
+
+	// Devices were reset, so the TH timeouts are no longer needed.
+	d->thTimeoutMask = 0;
+}
+
+/** TH timeouts. **/
+
+/**
+ * Set the TH timeout function.
+ * If set, the caller must call thTimeout() when the
+ * timeout expires, and doScanline() does nothing.
+ * @param fn TH timeout function, or nullptr to use doScanline().
+ * @param param Parameter for fn.
+ */
+void IoManager::setThTimeoutFn(ThTimeoutFn fn, void *param)
+{
+	d->thTimeoutFn = fn;
+	d->thTimeoutParam = param;
+	d->thTimeoutMask = 0;
+}
+
+/**
+ * A TH timeout has expired.
+ * @param physPort Physical port number.
+ */
+void IoManager::thTimeout(int physPort)
+{
+	assert(physPort >= PHYSPORT_1 && physPort < PHYSPORT_MAX);
+
+	IO::Device *const dev = d->ioDevices[physPort];
+	assert(dev != nullptr);	// Physical ports must be allocated.
+
+	dev->update_onThTimeout();
 }
 
 /**
- * Update the scanline counter for all controllers.
- * This is used by the 6-button controller,
- * which resets its internal counter after
- * around 25 scanlines of no TH rising edges.
+ * Count down the TH timeouts by one scanline.
+ * This is used if no TH timeout function is set.
  */
 void IoManager::doScanline(void)
 {
-	for (int i = 0; i < ARRAY_SIZE(d->ioDevices); i++) {
-		IO::Device *const dev = d->ioDevices[i];
-		if (dev != nullptr) {
-			dev->update_onScanline();
+	if (!d->thTimeoutMask) {
+		// No TH timeouts are running.
+		return;
+	}
+
+	PROFILE_SCOPE(IO_DOSCANLINE);
+	for (int i = 0; i < PHYSPORT_MAX; i++) {
+		if (!(d->thTimeoutMask & (1 << i)))
+			continue;
+		if (--d->thTimeoutLines[i] <= 0) {
+			d->thTimeoutMask &= ~(1 << i);
+			thTimeout(i);
 		}
 	}
 }
@@ -432,6 +474,9 @@ void IoManager::writeDataMD(int physPort, uint8_t data)
 
 	dev->mdData = data;
 	dev->update();	// TODO: updateWithData()?
+	if (dev->thTimeout != IO::Device::THT_NONE) {
+		d->handleThTimeout(physPort);
+	}
 }
 
 
@@ -464,6 +509,9 @@ void IoManager::writeCtrlMD(int physPort, uint8_t ctrl)
 
 	dev->ctrl = ctrl;
 	dev->update();	// TODO: updateWithCtrl()?
+	if (dev->thTimeout != IO::Device::THT_NONE) {
+		d->handleThTimeout(physPort);
+	}
 	// TODO: 4WP needs to copy this to the active device.
 }
 
@@ -862,6 +910,62 @@ void IoManager::updateAbsolutePosition(int virtPort, int x, int y)
 	}
 }
 
+/** Properties. **/
+
+bool IoManager::constrainDPad(void) const
+	{ return d->constrainDPad; }
+void IoManager::setConstrainDPad(bool constrainDPad)
+	{ d->constrainDPad = constrainDPad; }
+
+/** Movie recording and playback. **/
+
+/**
+ * Get an I/O device's current button state.
+ * @param virtPort Virtual port.
+ * @return Button state, or ~0 if no device is connected.
+ */
+uint32_t IoManager::buttons(int virtPort) const
+{
+	assert(virtPort >= VIRTPORT_1 && virtPort < VIRTPORT_MAX);
+	const IO::Device *const dev = d->ioDevices[virtPort];
+	return (dev != nullptr ? dev->getButtons() : ~0U);
+}
+
+/**
+ * Get an I/O device's current absolute tablet coordinates.
+ * @param virtPort Virtual port.
+ * @param x [out] X coordinate. (-1 if offscreen or no device)
+ * @param y [out] Y coordinate. (-1 if offscreen or no device)
+ */
+void IoManager::absolutePosition(int virtPort, int *x, int *y) const
+{
+	assert(virtPort >= VIRTPORT_1 && virtPort < VIRTPORT_MAX);
+	const IO::Device *const dev = d->ioDevices[virtPort];
+	if (dev != nullptr) {
+		*x = dev->absX();
+		*y = dev->absY();
+	} else {
+		*x = -1;
+		*y = -1;
+	}
+}
+
+/**
+ * Update an I/O device with an exact button state.
+ * Unlike update(), D-Pad constraints are not applied,
+ * so a recorded state can be replayed bit-exactly.
+ * @param virtPort Virtual port.
+ * @param buttons New button state.
+ */
+void IoManager::updateRaw(int virtPort, uint32_t buttons)
+{
+	assert(virtPort >= VIRTPORT_1 && virtPort < VIRTPORT_MAX);
+	IO::Device *const dev = d->ioDevices[virtPort];
+	if (dev != nullptr) {
+		dev->update(buttons);
+	}
+}
+
 /** ZOMG savestate functions. **/
 
 /**
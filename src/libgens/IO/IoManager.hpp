@@ -134,12 +134,71 @@ class IoManager
 		 */
 		void updateAbsolutePosition(int virtPort, int x, int y);
 
+		/** Movie recording and playback. **/
+
+		/**
+		 * Get an I/O device's current button state.
+		 * @param virtPort Virtual port.
+		 * @return Button state, or ~0 if no device is connected.
+		 */
+		uint32_t buttons(int virtPort) const;
+
+		/**
+		 * Get an I/O device's current absolute tablet coordinates.
+		 * @param virtPort Virtual port.
+		 * @param x [out] X coordinate. (-1 if offscreen or no device)
+		 * @param y [out] Y coordinate. (-1 if offscreen or no device)
+		 */
+		void absolutePosition(int virtPort, int *x, int *y) const;
+
 		/**
-		 * Update the scanline counter for all controllers.
+		 * Update an I/O device with an exact button state.
+		 * Unlike update(), D-Pad constraints are not applied,
+		 * so a recorded state can be replayed bit-exactly.
+		 * @param virtPort Virtual port.
+		 * @param buttons New button state.
+		 */
+		void updateRaw(int virtPort, uint32_t buttons);
+
+		/** TH timeouts. **/
+
+		/**
+		 * TH timeout, in scanlines.
 		 * This is used by the 6-button controller,
 		 * which resets its internal counter after
 		 * around 25 scanlines of no TH rising edges.
 		 */
+		static const int TH_TIMEOUT_LINES = 25;
+
+		/**
+		 * TH timeout function.
+		 * Called when a device on a physical port
+		 * starts or stops its TH timeout.
+		 * @param param Parameter passed to setThTimeoutFn().
+		 * @param physPort Physical port number.
+		 * @param start True to start (or restart) the timeout; false to stop it.
+		 */
+		typedef void (*ThTimeoutFn)(void *param, int physPort, bool start);
+
+		/**
+		 * Set the TH timeout function.
+		 * If set, the caller must call thTimeout() when the
+		 * timeout expires, and doScanline() does nothing.
+		 * @param fn TH timeout function, or nullptr to use doScanline().
+		 * @param param Parameter for fn.
+		 */
+		void setThTimeoutFn(ThTimeoutFn fn, void *param);
+
+		/**
+		 * A TH timeout has expired.
+		 * @param physPort Physical port number.
+		 */
+		void thTimeout(int physPort);
+
+		/**
+		 * Count down the TH timeouts by one scanline.
+		 * This is used if no TH timeout function is set.
+		 */
 		void doScanline(void);
 
 		/**
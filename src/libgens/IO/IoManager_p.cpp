@@ -72,7 +72,11 @@ const IoManagerPrivate::IoDevInfo IoManagerPrivate::ioDevInfo[IoManager::IOT_MAX
 IoManagerPrivate::IoManagerPrivate(IoManager *q)
 	: q(q)
 	, constrainDPad(true)
+	, thTimeoutFn(nullptr)
+	, thTimeoutParam(nullptr)
+	, thTimeoutMask(0)
 {
+	memset(thTimeoutLines, 0, sizeof(thTimeoutLines));
 	// Clear the I/O devices array.
 	memset(ioDevices, 0, sizeof(ioDevices));
 
@@ -90,4 +94,28 @@ IoManagerPrivate::~IoManagerPrivate()
 	}
 }
 
+/**
+ * Handle a device's TH timeout request.
+ * @param physPort Physical port number.
+ */
+void IoManagerPrivate::handleThTimeout(int physPort)
+{
+	IO::Device *const dev = ioDevices[physPort];
+	const bool start = (dev->thTimeout == IO::Device::THT_START);
+	dev->thTimeout = IO::Device::THT_NONE;
+
+	if (thTimeoutFn) {
+		// The caller handles the timeout.
+		thTimeoutFn(thTimeoutParam, physPort, start);
+		return;
+	}
+
+	if (start) {
+		thTimeoutLines[physPort] = IoManager::TH_TIMEOUT_LINES;
+		thTimeoutMask |= (1 << physPort);
+	} else {
+		thTimeoutMask &= ~(1 << physPort);
+	}
+}
+
 }
@@ -141,6 +141,23 @@ class IoManagerPrivate
 		// This only affects devices with a D-Pad
 		// as buttons 0-3.
 		bool constrainDPad;
+
+		/**
+		 * TH timeouts.
+		 * If thTimeoutFn is set, timeouts are handled by the
+		 * caller. Otherwise, doScanline() counts down
+		 * thTimeoutLines[] for each port in thTimeoutMask.
+		 */
+		IoManager::ThTimeoutFn thTimeoutFn;
+		void *thTimeoutParam;
+		int thTimeoutLines[IoManager::PHYSPORT_MAX];
+		uint8_t thTimeoutMask;
+
+		/**
+		 * Handle a device's TH timeout request.
+		 * @param physPort Physical port number.
+		 */
+		void handleThTimeout(int physPort);
 };
 
 }
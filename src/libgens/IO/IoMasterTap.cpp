@@ -61,7 +61,6 @@ IoMasterTap::IoMasterTap()
 void IoMasterTap::resetDev(void)
 {
 	Device::resetDev();	// TODO: typedef super?
-	this->scanlines = 0;
 }
 
 /**
@@ -91,11 +90,16 @@ void IoMasterTap::update(void)
 	// - http://www.smspower.org/Homebrew/BOoM-SMS
 	// - http://www.smspower.org/uploads/Homebrew/BOoM-SMS-sms4p_2.png
 
-	// Check for a TH falling transition.
+	// Check for a TH transition.
 	if ((oldTrisIn & IOPIN_TH) && !checkInputLine(IOPIN_TH)) {
-		// TH falling transition. 
+		// TH falling transition.
+		// The reset circuit is disabled while TH is low.
 		this->counter = (this->counter + 1) & 0x03;
-		this->scanlines = 0; // TODO: Keep at 0 while TH is low.
+		this->thTimeout = THT_STOP;
+	} else if (!(oldTrisIn & IOPIN_TH) && checkInputLine(IOPIN_TH)) {
+		// TH rising transition.
+		// The reset circuit starts charging.
+		this->thTimeout = THT_START;
 	}
 
 	// Update the current virtual gamepad.
@@ -115,28 +119,18 @@ void IoMasterTap::update(void)
 }
 
 /**
- * One scanline worth of time has passed.
+ * The TH timeout has expired.
  * Needed for some devices that reset after a period of time,
  * e.g. 6BTN controllers.
  */
-void IoMasterTap::update_onScanline(void)
+void IoMasterTap::update_onThTimeout(void)
 {
+	// TH has been high for around 25 scanlines.
 	// TODO: Check Master Tap schematic to determine the actual value.
-	static const int SCANLINE_COUNT_MAX_MTAP = 25;
-	if (!checkInputLine(IOPIN_TH)) {
-		// TH is low. Reset circuit is disabled.
-		// TODO: Also do this for 6BTN?
-		this->scanlines = 0;
-	} else {
-		// TH is high. Reset circuit is charging.
-		this->scanlines++;
-		if (this->scanlines > SCANLINE_COUNT_MAX_MTAP) {
-			// Scanline counter has reached its maximum value.
-			// Reset both counters.
-			this->counter = 0;
-			this->scanlines = 0;
-		}
-	}
+	this->counter = 0;
+
+	// Update the device data for the new counter value.
+	this->update();
 }
 
 /**
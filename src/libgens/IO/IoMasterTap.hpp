@@ -63,11 +63,11 @@ class IoMasterTap : public Device
 		virtual void update(void) final;
 
 		/**
-		 * One scanline worth of time has passed.
+		 * The TH timeout has expired.
 		 * Needed for some devices that reset after a period of time,
 		 * e.g. 6BTN controllers.
 		 */
-		virtual void update_onScanline(void) final;
+		virtual void update_onThTimeout(void) final;
 
 		/**
 		 * Set a sub-device.
@@ -84,9 +84,6 @@ class IoMasterTap : public Device
 		 * NOTE: This object does NOT own these IoDevices.
 		 */
 		Device *pads[4];
-
-		// Scanline counter.
-		int scanlines;
 };
 
 } }
@@ -30,6 +30,7 @@
 
 // C includes (C++ namespace).
 #include <cassert>
+#include <cerrno>
 #include <cstring>
 
 #include "EEPRomI2C_p.hpp"
@@ -132,7 +133,7 @@ void EEPRomI2CPrivate::stopWriteData(void)
 		if (page_cache[i] != eeprom[byte_address]) {
 			// Byte has changed.
 			eeprom[byte_address] = page_cache[i];
-			setDirty();
+			setDirty(byte_address);
 		}
 	}
 }
@@ -496,6 +497,37 @@ int EEPRomI2C::setEEPRomType(int type)
 	return 0;
 }
 
+/**
+ * Set the EEPRom type from a specification.
+ * @param spec EEPRom specification.
+ * @return 0 on success; -EINVAL if the specification is invalid.
+ */
+int EEPRomI2C::setEEPRomSpec(const EEPRomSpec_t *spec)
+{
+	if (spec->mode <= EPR_NONE || spec->mode >= EPR_MAX ||
+	    spec->sz_mask == 0 || spec->sz_mask >= MAX_SIZE ||
+	    (spec->sz_mask & (spec->sz_mask + 1)) != 0 ||
+	    spec->pg_mask == 0 || (spec->pg_mask & (spec->pg_mask + 1)) != 0 ||
+	    spec->sda_in_bit > 7 || spec->sda_out_bit > 7 || spec->scl_bit > 7)
+	{
+		// Invalid specification.
+		return -EINVAL;
+	}
+
+	eprMapper.sda_in_adr = spec->sda_in_adr;
+	eprMapper.sda_out_adr = spec->sda_out_adr;
+	eprMapper.scl_adr = spec->scl_adr;
+	eprMapper.sda_in_bit = spec->sda_in_bit;
+	eprMapper.sda_out_bit = spec->sda_out_bit;
+	eprMapper.scl_bit = spec->scl_bit;
+
+	d->eprChip.epr_mode = spec->mode;
+	d->eprChip.dev_addr = spec->dev_addr;
+	d->eprChip.sz_mask = spec->sz_mask;
+	d->eprChip.pg_mask = spec->pg_mask;
+	return 0;
+}
+
 /**
  * Determine if the EEPRom type is set.
  * @return True if the EEPRom type is set; false if not.
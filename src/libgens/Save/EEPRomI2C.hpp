@@ -74,6 +74,34 @@ class EEPRomI2C
 		 */
 		int setEEPRomType(int type);
 
+		// Maximum EEPRom size and page size.
+		static const unsigned int MAX_SIZE = 0x2000;
+		static const unsigned int MAX_PAGE_SIZE = 256;
+
+		/**
+		 * EEPRom specification.
+		 * Used for ROMs that aren't in the EEPRom database.
+		 */
+		struct EEPRomSpec_t {
+			uint8_t mode;		// EEPRomMode_t (EPR_MODE1-EPR_MODE3)
+			uint8_t dev_addr;	// Device address.
+			uint16_t sz_mask;	// Size mask. ((2^n)-1, < MAX_SIZE)
+			uint8_t pg_mask;	// Page mask. ((2^n)-1, < MAX_PAGE_SIZE)
+			uint32_t sda_in_adr;	// 68000 memory address mapped to SDA_IN.
+			uint32_t sda_out_adr;	// 68000 memory address mapped to SDA_OUT.
+			uint32_t scl_adr;	// 68000 memory address mapped to SCL.
+			uint8_t sda_in_bit;	// Bit offset for SDA_IN. (0-7)
+			uint8_t sda_out_bit;	// Bit offset for SDA_OUT. (0-7)
+			uint8_t scl_bit;	// Bit offset for SCL. (0-7)
+		};
+
+		/**
+		 * Set the EEPRom type from a specification.
+		 * @param spec EEPRom specification.
+		 * @return 0 on success; -EINVAL if the specification is invalid.
+		 */
+		int setEEPRomSpec(const EEPRomSpec_t *spec);
+
 		/**
 		 * Determine if the EEPRom type is set.
 		 * @return True if the EEPRom type is set; false if not.
@@ -125,13 +153,17 @@ class EEPRomI2C
 
 		/**
 		 * Save the EEPRom file.
+		 * Only modified pages are written. This waits for
+		 * the writes to reach the disk, including any
+		 * autosaves that are still in progress.
 		 * @return Positive value indicating EEPRom size on success; 0 if no save is needed; negative on error.
 		 */
 		int save(void);
 
 		/**
 		 * Autosave the EEPRom file.
-		 * This saves the EEPRom file if its last modification time is past a certain threshold.
+		 * This saves the EEPRom file if it was first modified more than a certain threshold ago.
+		 * Modified pages are written in the background; this doesn't wait for them.
 		 * @param framesElapsed Number of frames elapsed, or -1 for paused. (force autosave)
 		 * @return Positive value indicating SRam size on success; 0 if no save is needed; negative on error.
 		 */
@@ -215,7 +215,7 @@ int EEPRomI2C::dbg_writeEEPRom(uint32_t address, const uint8_t *data, int length
 
 	// Write the data.
 	memcpy(&d->eeprom[address], data, length);
-	d->setDirty();
+	d->setDirty(address, length);
 	return 0;
 }
 
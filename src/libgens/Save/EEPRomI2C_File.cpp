@@ -66,6 +66,31 @@ int EEPRomI2CPrivate::getUsedSize(void) const
 	return next_pow2u(i);
 }
 
+/**
+ * Queue modified pages for writing.
+ * @return Positive value indicating EEPRom size on success; 0 if no save is needed; negative on error.
+ */
+int EEPRomI2CPrivate::queuePages(void)
+{
+	if (!isDirty())
+		return 0;
+	if (filename.empty()) {
+		// No EEPRom file.
+		// TODO: Error code constants.
+		return -1;
+	}
+
+	int size = getUsedSize();
+	if (size <= 0) {
+		// EEPRom is empty.
+		return 0;
+	}
+
+	int ret = journal.write(fullPathname, eeprom, size, dirtyPages);
+	clearDirty();
+	return (ret < 0 ? ret : size);
+}
+
 /** EEPRomI2C **/
 
 /**
@@ -122,6 +147,9 @@ int EEPRomI2C::load(void)
 	if (!isEEPRomTypeSet())
 		return -2;
 
+	// If the last save was interrupted, finish it first.
+	d->journal.recover(d->fullPathname);
+
 	// Attempt to open the EEPRom file.
 	FILE *f = fopen(d->fullPathname.c_str(), "rb");
 	if (!f) {
@@ -137,6 +165,7 @@ int EEPRomI2C::load(void)
 	// Load the EEPRom data.
 	int ret = fread(d->eeprom, 1, sizeof(d->eeprom), f);
 	fclose(f);
+	d->journal.setFileSize(d->fullPathname, ret);
 
 	// Return the number of bytes read.
 	d->clearDirty();
@@ -145,40 +174,33 @@ int EEPRomI2C::load(void)
 
 /**
  * Save the EEPRom file.
+ * Only modified pages are written. This waits for
+ * the writes to reach the disk, including any
+ * autosaves that are still in progress.
  * @return Positive value indicating EEPRom size on success; 0 if no save is needed; negative on error.
  */
 int EEPRomI2C::save(void)
 {
 	if (!isEEPRomTypeSet())
 		return -2;
-	if (!d->isDirty())
-		return 0;
-
-	int size = d->getUsedSize();
-	if (size <= 0) {
-		// EEPRom is empty.
-		return 0;
-	}
 
-	FILE *f = fopen(d->fullPathname.c_str(), "wb");
-	if (!f) {
-		// Unable to open EEPRom file.
-		// TODO: Error code constants.
-		return -1;
+	// Wait for the pages to be written, as well
+	// as any autosaves that are still pending.
+	int ret = d->queuePages();
+	d->journal.flush();
+	int err = d->requeueFailed();
+	if (err < 0) {
+		// Write failed. The pages will be
+		// written again next time.
+		return err;
 	}
-
-	// Save EEPRom to the file.
-	int ret = fwrite(d->eeprom, 1, size, f);
-	fclose(f);
-
-	// Return the number of bytes saved.
-	d->clearDirty();
 	return ret;
 }
 
 /**
  * Autosave the EEPRom file.
- * This saves the EEPRom file if its last modification time is past a certain threshold.
+ * This saves the EEPRom file if it was first modified more than a certain threshold ago.
+ * Modified pages are written in the background; this doesn't wait for them.
  * @param framesElapsed Number of frames elapsed, or -1 for paused.
  * @return Positive value indicating EEPRom size on success; 0 if no save is needed; negative on error.
  */
@@ -186,12 +208,18 @@ int EEPRomI2C::autoSave(int framesElapsed)
 {
 	if (!isEEPRomTypeSet())
 		return -2;
+
+	// If a background write failed, its pages
+	// are marked as dirty again. Report the error.
+	int err = d->requeueFailed();
+	if (err < 0)
+		return err;
 	if (!d->isDirty())
 		return 0;
 
 	// TODO: Customizable autosave threshold.
 	// TODO: PAL/NTSC detection.
-	if (d->framesElapsed >= 0) {
+	if (framesElapsed >= 0) {
 		// Check if we've passed the autosave threshold.
 		bool isPal = false;
 		d->framesElapsed += framesElapsed;
@@ -200,7 +228,7 @@ int EEPRomI2C::autoSave(int framesElapsed)
 	}
 
 	// Autosave threshold has passed.
-	return save();
+	return d->queuePages();
 }
 
 /**
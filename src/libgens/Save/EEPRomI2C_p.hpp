@@ -29,6 +29,8 @@
 #include <string>
 
 #include "EEPRomI2C.hpp"
+#include "SaveJournal.hpp"
+
 namespace LibGens {
 
 class EEPRomI2C;
@@ -53,9 +55,9 @@ class EEPRomI2CPrivate
 		std::string fullPathname;	// Full pathname. (m_pathname + m_filename)
 
 		// EEPRom. (8 KB max)
-		uint8_t eeprom[0x2000];
+		uint8_t eeprom[EEPRomI2C::MAX_SIZE];
 		// Page cache. Largest known is 256 bytes. (24C1024)
-		uint8_t page_cache[256];
+		uint8_t page_cache[EEPRomI2C::MAX_PAGE_SIZE];
 
 		// /SCL and /SDA are both open-drain.
 		// The line is 1 unless either the EEPROM or the
@@ -118,13 +120,53 @@ class EEPRomI2CPrivate
 		// TODO: Accessor/mutator function?
 		int framesElapsed;
 
+		// Modified pages.
+		SaveJournal::DirtyPages dirtyPages;
+
 	public:
 		inline bool isDirty(void) const
 			{ return dirty; }
-		inline void setDirty(void)
-			{ dirty = true; framesElapsed = 0; }
+
+		/**
+		 * Mark part of the EEPRom as modified.
+		 * NOTE: The autosave timer starts at the first modification,
+		 * so games that write the EEPRom continuously still get saved.
+		 * @param address Start address.
+		 * @param length Length.
+		 */
+		inline void setDirty(unsigned int address, unsigned int length = 1)
+		{
+			dirtyPages.setRange(address, length);
+			if (!dirty) {
+				dirty = true;
+				framesElapsed = 0;
+			}
+		}
 		inline void clearDirty(void)
-			{ dirty = false; framesElapsed = 0; }
+			{ dirtyPages.clear(); dirty = false; framesElapsed = 0; }
+
+		// Writes modified pages to the EEPRom file.
+		SaveJournal journal;
+
+		/**
+		 * Queue modified pages for writing.
+		 * @return Positive value indicating EEPRom size on success; 0 if no save is needed; negative on error.
+		 */
+		int queuePages(void);
+
+		/**
+		 * Mark pages from failed commits as modified.
+		 * @return 0 if no commits failed; negative POSIX error code if a commit failed.
+		 */
+		inline int requeueFailed(void)
+		{
+			const int ret = journal.takeFailedPages(dirtyPages);
+			if (ret < 0 && !dirty) {
+				dirty = true;
+				framesElapsed = 0;
+			}
+			return ret;
+		}
 
 		/**
 		 * AUTOSAVE_THRESHOLD_DEFAULT: Default autosave threshold, in milliseconds.
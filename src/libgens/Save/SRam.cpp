@@ -76,6 +76,21 @@ class SRamPrivate
 		 * Default autosave threshold, in milliseconds.
 		 */
 		static const int AUTOSAVE_THRESHOLD_DEFAULT = 1000;
+
+		// Writes modified pages to the SRam file.
+		SaveJournal journal;
+
+		/**
+		 * Queue modified pages for writing.
+		 * @return Positive value indicating SRam size on success; 0 if no save is needed; negative on error.
+		 */
+		int queuePages(void);
+
+		/**
+		 * Mark pages from failed commits as modified.
+		 * @return 0 if no commits failed; negative POSIX error code if a commit failed.
+		 */
+		int requeueFailed(void);
 		
 		/**
 		 * Determine how many bytes are used in the SRam chip.
@@ -122,6 +137,45 @@ int SRamPrivate::getUsedSize(void) const
 	return next_pow2u(i);
 }
 
+/**
+ * Queue modified pages for writing.
+ * @return Positive value indicating SRam size on success; 0 if no save is needed; negative on error.
+ */
+int SRamPrivate::queuePages(void)
+{
+	if (!q->m_dirty)
+		return 0;
+	if (filename.empty()) {
+		// No SRam file.
+		// TODO: Error code constants.
+		return -1;
+	}
+
+	int size = getUsedSize();
+	if (size <= 0) {
+		// SRam is empty.
+		return 0;
+	}
+
+	int ret = journal.write(fullPathname, q->m_sram, size, q->m_dirtyPages);
+	q->clearDirty();
+	return (ret < 0 ? ret : size);
+}
+
+/**
+ * Mark pages from failed commits as modified.
+ * @return 0 if no commits failed; negative POSIX error code if a commit failed.
+ */
+int SRamPrivate::requeueFailed(void)
+{
+	const int ret = journal.takeFailedPages(q->m_dirtyPages);
+	if (ret < 0 && !q->m_dirty) {
+		q->m_dirty = true;
+		q->m_framesElapsed = 0;
+	}
+	return ret;
+}
+
 /** SRam **/
 
 SRam::SRam()
@@ -200,7 +254,7 @@ void SRam::writeByte(uint32_t address, uint8_t data)
 	if (m_sram[address] != data) {
 		m_sram[address] = data;
 		// Set the dirty flag.
-		setDirty();
+		setDirty(address);
 	}
 }
 
@@ -220,7 +274,8 @@ void SRam::writeWord(uint32_t address, uint16_t data)
 		m_sram[address] = hi;
 		m_sram[address+1] = lo;
 		// Set the dirty flag.
-		setDirty();
+		setDirty(address);
+		setDirty(address+1);
 	}
 }
 
@@ -276,6 +331,9 @@ void SRam::setPathname(const string& pathname)
  */
 int SRam::load(void)
 {
+	// If the last save was interrupted, finish it first.
+	d->journal.recover(d->fullPathname);
+
 	// Attempt to open the SRam file.
 	FILE *f = fopen(d->fullPathname.c_str(), "rb");
 	if (!f) {
@@ -291,6 +349,7 @@ int SRam::load(void)
 	// Load the SRam data.
 	int ret = fread(m_sram, 1, sizeof(m_sram), f);
 	fclose(f);
+	d->journal.setFileSize(d->fullPathname, ret);
 
 	// Return the number of bytes read.
 	clearDirty();
@@ -299,43 +358,40 @@ int SRam::load(void)
 
 /**
  * Save the SRam file.
+ * Only modified pages are written. This waits for
+ * the writes to reach the disk, including any
+ * autosaves that are still in progress.
  * @return Positive value indicating SRam size on success; 0 if no save is needed; negative on error.
  */
 int SRam::save(void)
 {
-	if (!m_dirty)
-		return 0;
-
-	int size = d->getUsedSize();
-	if (size <= 0) {
-		// SRam is empty.
-		return 0;
-	}
-
-	FILE *f = fopen(d->fullPathname.c_str(), "wb");
-	if (!f) {
-		// Unable to open SRam file.
-		// TODO: Error code constants.
-		return -1;
+	// Wait for the pages to be written, as well
+	// as any autosaves that are still pending.
+	int ret = d->queuePages();
+	d->journal.flush();
+	int err = d->requeueFailed();
+	if (err < 0) {
+		// Write failed. The pages will be
+		// written again next time.
+		return err;
 	}
-
-	// Save SRam to the file.
-	int ret = fwrite(m_sram, 1, size, f);
-	fclose(f);
-
-	// Return the number of bytes saved.
-	clearDirty();
 	return ret;
 }
 
 /**
  * Autosave the SRam file.
- * This saves the SRam file if its last modification time is past a certain threshold.
+ * This saves the SRam file if it was first modified more than a certain threshold ago.
+ * Modified pages are written in the background; this doesn't wait for them.
  * @param framesElapsed Number of frames elapsed, or -1 for paused. (force autosave)
  * @return Positive value indicating SRam size on success; 0 if no save is needed; negative on error.
  */
 int SRam::autoSave(int framesElapsed)
 {
+	// If a background write failed, its pages
+	// are marked as dirty again. Report the error.
+	int err = d->requeueFailed();
+	if (err < 0)
+		return err;
 	if (!m_dirty)
 		return 0;
 
@@ -350,7 +406,7 @@ int SRam::autoSave(int framesElapsed)
 	}
 
 	// Autosave threshold has passed.
-	return save();
+	return d->queuePages();
 }
 
 /**
@@ -31,6 +31,8 @@
 // C++ includes.
 #include <string>
 
+#include "SaveJournal.hpp"
+
 // ZOMG
 namespace LibZomg {
 	class Zomg;
@@ -106,13 +108,17 @@ class SRam
 
 		/**
 		 * Save the SRam file.
+		 * Only modified pages are written. This waits for
+		 * the writes to reach the disk, including any
+		 * autosaves that are still in progress.
 		 * @return Positive value indicating SRam size on success; 0 if no save is needed; negative on error.
 		 */
 		int save(void);
 		
 		/**
 		 * Autosave the SRam file.
-		 * This saves the SRam file if its last modification time is past a certain threshold.
+		 * This saves the SRam file if it was first modified more than a certain threshold ago.
+		 * Modified pages are written in the background; this doesn't wait for them.
 		 * @param framesElapsed Number of frames elapsed, or -1 for paused. (force autosave)
 		 * @return Positive value indicating SRam size on success; 0 if no save is needed; negative on error.
 		 */
@@ -125,6 +131,7 @@ class SRam
 	protected:
 		// Dirty flag.
 		void setDirty(void);
+		void setDirty(uint32_t address);
 		void clearDirty(void);
 
 	private:
@@ -140,6 +147,8 @@ class SRam
 		// Dirty flag.
 		bool m_dirty;
 		int m_framesElapsed;
+		// Modified pages.
+		SaveJournal::DirtyPages m_dirtyPages;
 };
 
 /** Settings. **/
@@ -235,14 +244,36 @@ inline bool SRam::isDirty(void) const
 
 /** Inline protected functions. **/
 
+/**
+ * Mark all of SRam as modified.
+ */
 inline void SRam::setDirty(void)
 {
-	m_dirty = true;
-	m_framesElapsed = 0;
+	m_dirtyPages.setAll();
+	if (!m_dirty) {
+		m_dirty = true;
+		m_framesElapsed = 0;
+	}
+}
+
+/**
+ * Mark an SRam page as modified.
+ * NOTE: The autosave timer starts at the first modification,
+ * so games that write SRam continuously still get saved.
+ * @param address Address, relative to the start of SRam.
+ */
+inline void SRam::setDirty(uint32_t address)
+{
+	m_dirtyPages.set(address);
+	if (!m_dirty) {
+		m_dirty = true;
+		m_framesElapsed = 0;
+	}
 }
 
 inline void SRam::clearDirty(void)
 {
+	m_dirtyPages.clear();
 	m_dirty = false;
 	m_framesElapsed = 0;
 }
@@ -0,0 +1,650 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * SaveJournal.cpp: Journaled page writes for save files.                  *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "SaveJournal.hpp"
+
+#include "Util/XXHash64.hpp"
+#include "libcompat/byteswap.h"
+
+#ifdef _WIN32
+// Win32 Unicode Translation Layer.
+// Needed for proper Unicode filename support on Windows.
+#include "libcompat/W32U/W32U_mini.h"
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+// C++ includes.
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using std::condition_variable;
+using std::mutex;
+using std::string;
+using std::thread;
+using std::unique_lock;
+using std::vector;
+
+namespace LibGens {
+
+/** SaveJournalPrivate **/
+
+class SaveJournalPrivate
+{
+	public:
+		SaveJournalPrivate();
+		~SaveJournalPrivate();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		SaveJournalPrivate(const SaveJournalPrivate &);
+		SaveJournalPrivate &operator=(const SaveJournalPrivate &);
+
+	public:
+		/**
+		 * A batch of pages to commit.
+		 * Only the pages marked in dirty are valid in data.
+		 */
+		struct Batch {
+			string filename;
+			unsigned int size;
+			SaveJournal::DirtyPages dirty;
+			vector<uint8_t> data;
+			bool valid;
+		};
+
+		// Double buffer: the emulation thread fills pending
+		// while the writer thread commits active.
+		Batch batch[2];
+		Batch *pending;
+		Batch *active;
+
+		// Size the save file will have once all
+		// queued batches have been committed.
+		string diskFilename;
+		unsigned int diskSize;
+
+		/** Writer thread. **/
+		thread writer;
+		mutex mtx;
+		condition_variable cvWork;	// Writer waits for batches here.
+		condition_variable cvDone;	// flush() waits for the writer here.
+		bool busy;		// Writer is committing active.
+		bool quit;
+		int error;		// Last write error. (negative POSIX error code)
+
+		// Pages from failed commits, and the last commit error.
+		// These are reported by takeFailedPages().
+		SaveJournal::DirtyPages failedPages;
+		int failedError;
+
+		/**
+		 * Writer thread function.
+		 * @param d SaveJournalPrivate.
+		 */
+		static void writerThread(SaveJournalPrivate *d);
+
+		/** Journal format. **/
+
+		// Journal file extension.
+		static const char jnlExt[];
+
+		/**
+		 * Journal header.
+		 * All fields are little-endian.
+		 * Each page record is a 32-bit offset, a 32-bit length,
+		 * and the page data. The journal ends with an XXHash64
+		 * of everything before it.
+		 */
+		static const char JNL_MAGIC[8];
+		static const unsigned int JNL_HEADER_SIZE = 16;	// magic, size, page count
+		static const unsigned int JNL_RECORD_SIZE = 8;	// offset, length
+		static const unsigned int JNL_TRAILER_SIZE = 8;	// XXHash64
+		static const unsigned int JNL_MAX_FILE_SIZE =
+			JNL_HEADER_SIZE + JNL_TRAILER_SIZE +
+			(SaveJournal::MAX_PAGES * (JNL_RECORD_SIZE + SaveJournal::PAGE_SIZE));
+
+		/**
+		 * Build a journal from a batch.
+		 * @param batch Batch.
+		 * @param jnl Journal data.
+		 */
+		static void buildJournal(const Batch *batch, vector<uint8_t> &jnl);
+
+		/**
+		 * Check if journal data is complete.
+		 * @param jnl Journal data.
+		 * @param len Length of jnl.
+		 * @return True if the journal is complete; false if not.
+		 */
+		static bool checkJournal(const uint8_t *jnl, size_t len);
+
+		/**
+		 * Apply a complete journal to a save file.
+		 * @param filename Save file.
+		 * @param jnl Journal data.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		static int applyJournal(const string &filename, const uint8_t *jnl);
+
+		/**
+		 * Commit a batch: write the journal, then the save file.
+		 * @param batch Batch.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		static int commit(const Batch *batch);
+
+		/**
+		 * Flush a file to disk.
+		 * @param f File.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		static int syncFile(FILE *f);
+
+		/**
+		 * Remove a journal file.
+		 * @param jnlFilename Journal filename.
+		 */
+		static void removeJournal(const string &jnlFilename);
+
+		static inline void putLE32(uint8_t *p, uint32_t val)
+		{
+			val = cpu_to_le32(val);
+			memcpy(p, &val, sizeof(val));
+		}
+
+		static inline uint32_t getLE32(const uint8_t *p)
+		{
+			uint32_t val;
+			memcpy(&val, p, sizeof(val));
+			return le32_to_cpu(val);
+		}
+};
+
+const char SaveJournalPrivate::jnlExt[] = ".jnl";
+const char SaveJournalPrivate::JNL_MAGIC[8] = {'G','E','N','S','J','N','L','1'};
+
+SaveJournalPrivate::SaveJournalPrivate()
+	: pending(&batch[0])
+	, active(&batch[1])
+	, diskSize(0)
+	, busy(false)
+	, quit(false)
+	, error(0)
+	, failedError(0)
+{
+	failedPages.clear();
+	for (int i = 0; i < 2; i++) {
+		batch[i].size = 0;
+		batch[i].dirty.clear();
+		batch[i].valid = false;
+	}
+}
+
+SaveJournalPrivate::~SaveJournalPrivate()
+{
+	if (!writer.joinable())
+		return;
+
+	// The writer thread commits any
+	// pending batch before exiting.
+	{
+		unique_lock<mutex> lock(mtx);
+		quit = true;
+	}
+	cvWork.notify_one();
+	writer.join();
+}
+
+/**
+ * Writer thread function.
+ * @param d SaveJournalPrivate.
+ */
+void SaveJournalPrivate::writerThread(SaveJournalPrivate *d)
+{
+	unique_lock<mutex> lock(d->mtx);
+	while (true) {
+		while (!d->quit && !d->pending->valid) {
+			d->cvWork.wait(lock);
+		}
+		if (!d->pending->valid) {
+			// Quitting, and nothing is left to commit.
+			break;
+		}
+
+		// Swap the batches so the emulation thread
+		// can queue more pages while we're writing.
+		Batch *const tmp = d->active;
+		d->active = d->pending;
+		d->pending = tmp;
+		d->pending->valid = false;
+		d->busy = true;
+
+		lock.unlock();
+		int ret = commit(d->active);
+		lock.lock();
+
+		d->active->valid = false;
+		d->busy = false;
+		if (ret != 0) {
+			// The save file's contents are unknown.
+			// Write everything next time, and keep the
+			// pages so the owner can mark them as dirty.
+			d->error = ret;
+			d->diskSize = 0;
+			d->failedPages.merge(d->active->dirty);
+			d->failedError = ret;
+		}
+		d->cvDone.notify_all();
+	}
+}
+
+/**
+ * Build a journal from a batch.
+ * @param batch Batch.
+ * @param jnl Journal data.
+ */
+void SaveJournalPrivate::buildJournal(const Batch *batch, vector<uint8_t> &jnl)
+{
+	const unsigned int pageCount =
+		(batch->size + SaveJournal::PAGE_SIZE - 1) >> SaveJournal::PAGE_SHIFT;
+
+	jnl.resize(JNL_HEADER_SIZE);
+	memcpy(&jnl[0], JNL_MAGIC, sizeof(JNL_MAGIC));
+	putLE32(&jnl[8], batch->size);
+
+	uint32_t records = 0;
+	for (unsigned int page = 0; page < pageCount; page++) {
+		if (!batch->dirty.test(page))
+			continue;
+
+		const unsigned int offset = (page << SaveJournal::PAGE_SHIFT);
+		unsigned int len = SaveJournal::PAGE_SIZE;
+		if (offset + len > batch->size)
+			len = batch->size - offset;
+
+		const size_t pos = jnl.size();
+		jnl.resize(pos + JNL_RECORD_SIZE + len);
+		putLE32(&jnl[pos], offset);
+		putLE32(&jnl[pos + 4], len);
+		memcpy(&jnl[pos + JNL_RECORD_SIZE], &batch->data[offset], len);
+		records++;
+	}
+	putLE32(&jnl[12], records);
+
+	// Checksum.
+	const uint64_t hash = XXHash64::hash(&jnl[0], jnl.size());
+	const size_t pos = jnl.size();
+	jnl.resize(pos + JNL_TRAILER_SIZE);
+	putLE32(&jnl[pos], (uint32_t)hash);
+	putLE32(&jnl[pos + 4], (uint32_t)(hash >> 32));
+}
+
+/**
+ * Check if journal data is complete.
+ * @param jnl Journal data.
+ * @param len Length of jnl.
+ * @return True if the journal is complete; false if not.
+ */
+bool SaveJournalPrivate::checkJournal(const uint8_t *jnl, size_t len)
+{
+	if (len < JNL_HEADER_SIZE + JNL_TRAILER_SIZE)
+		return false;
+	if (memcmp(jnl, JNL_MAGIC, sizeof(JNL_MAGIC)) != 0)
+		return false;
+
+	const size_t dataLen = len - JNL_TRAILER_SIZE;
+	const uint64_t hash = (uint64_t)getLE32(&jnl[dataLen]) |
+			      ((uint64_t)getLE32(&jnl[dataLen + 4]) << 32);
+	if (XXHash64::hash(jnl, dataLen) != hash)
+		return false;
+
+	// Verify the records.
+	const unsigned int size = getLE32(&jnl[8]);
+	const unsigned int records = getLE32(&jnl[12]);
+	if (size > SaveJournal::MAX_SIZE)
+		return false;
+	size_t pos = JNL_HEADER_SIZE;
+	for (unsigned int i = 0; i < records; i++) {
+		if (pos + JNL_RECORD_SIZE > dataLen)
+			return false;
+		const unsigned int offset = getLE32(&jnl[pos]);
+		const unsigned int recLen = getLE32(&jnl[pos + 4]);
+		if (recLen > SaveJournal::PAGE_SIZE || offset > size || recLen > size - offset)
+			return false;
+		pos += JNL_RECORD_SIZE + recLen;
+	}
+	return (pos == dataLen);
+}
+
+/**
+ * Apply a complete journal to a save file.
+ * @param filename Save file.
+ * @param jnl Journal data.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int SaveJournalPrivate::applyJournal(const string &filename, const uint8_t *jnl)
+{
+	FILE *f = fopen(filename.c_str(), "r+b");
+	if (!f) {
+		if (errno != ENOENT)
+			return -errno;
+		f = fopen(filename.c_str(), "wb");
+		if (!f)
+			return (errno != 0 ? -errno : -EIO);
+	}
+
+	const unsigned int size = getLE32(&jnl[8]);
+	const unsigned int records = getLE32(&jnl[12]);
+	size_t pos = JNL_HEADER_SIZE;
+	int ret = 0;
+	for (unsigned int i = 0; i < records; i++) {
+		const unsigned int offset = getLE32(&jnl[pos]);
+		const unsigned int len = getLE32(&jnl[pos + 4]);
+		if (fseek(f, offset, SEEK_SET) != 0 ||
+		    fwrite(&jnl[pos + JNL_RECORD_SIZE], 1, len, f) != len)
+		{
+			ret = -EIO;
+			break;
+		}
+		pos += JNL_RECORD_SIZE + len;
+	}
+
+	if (ret == 0 && fflush(f) != 0) {
+		ret = -EIO;
+	}
+	if (ret == 0) {
+		// Truncate the file to the new size.
+#ifdef _WIN32
+		if (_chsize(_fileno(f), size) != 0)
+#else
+		if (ftruncate(fileno(f), size) != 0)
+#endif
+		{
+			ret = -errno;
+		}
+	}
+	if (ret == 0) {
+		ret = syncFile(f);
+	}
+	fclose(f);
+	return ret;
+}
+
+/**
+ * Commit a batch: write the journal, then the save file.
+ * @param batch Batch.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int SaveJournalPrivate::commit(const Batch *batch)
+{
+	vector<uint8_t> jnl;
+	buildJournal(batch, jnl);
+
+	// Write the journal.
+	const string jnlFilename = batch->filename + jnlExt;
+	FILE *f = fopen(jnlFilename.c_str(), "wb");
+	if (!f)
+		return (errno != 0 ? -errno : -EIO);
+	int ret = 0;
+	if (fwrite(&jnl[0], 1, jnl.size(), f) != jnl.size() || fflush(f) != 0) {
+		ret = -EIO;
+	} else {
+		ret = syncFile(f);
+	}
+	fclose(f);
+	if (ret != 0) {
+		// The journal is incomplete, so recover() will
+		// ignore it. The save file hasn't been touched.
+		return ret;
+	}
+
+	// Journal is on disk. Update the save file.
+	ret = applyJournal(batch->filename, &jnl[0]);
+	if (ret == 0) {
+		removeJournal(jnlFilename);
+	}
+	return ret;
+}
+
+/**
+ * Flush a file to disk.
+ * @param f File.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int SaveJournalPrivate::syncFile(FILE *f)
+{
+#ifdef _WIN32
+	if (_commit(_fileno(f)) != 0)
+#else
+	if (fsync(fileno(f)) != 0)
+#endif
+	{
+		return -errno;
+	}
+	return 0;
+}
+
+/**
+ * Remove a journal file.
+ * @param jnlFilename Journal filename.
+ */
+void SaveJournalPrivate::removeJournal(const string &jnlFilename)
+{
+	if (remove(jnlFilename.c_str()) != 0) {
+		// TODO: Win32 Unicode version of remove().
+		// A leftover journal matches the save file,
+		// so truncating it is enough.
+		FILE *f = fopen(jnlFilename.c_str(), "wb");
+		if (f) {
+			fclose(f);
+		}
+	}
+}
+
+/** SaveJournal **/
+
+SaveJournal::SaveJournal()
+	: d(new SaveJournalPrivate())
+{ }
+
+SaveJournal::~SaveJournal()
+{
+	delete d;
+}
+
+/**
+ * Set the size of a save file that was just loaded.
+ * Pages past the end of the file are written regardless
+ * of the dirty bitmap. Calling write() with a different
+ * filename resets this to 0, forcing a full write.
+ * @param filename Save file.
+ * @param size File size.
+ */
+void SaveJournal::setFileSize(const string &filename, unsigned int size)
+{
+	unique_lock<mutex> lock(d->mtx);
+	d->diskFilename = filename;
+	d->diskSize = size;
+}
+
+/**
+ * Apply an interrupted journal to a save file, if one exists.
+ * This should be called before loading the save file.
+ * @param filename Save file.
+ * @return 1 if a journal was applied; 0 if not; negative POSIX error code on error.
+ */
+int SaveJournal::recover(const string &filename)
+{
+	// Make sure we're not racing the writer thread.
+	flush();
+
+	const string jnlFilename = filename + SaveJournalPrivate::jnlExt;
+	FILE *f = fopen(jnlFilename.c_str(), "rb");
+	if (!f) {
+		// No journal.
+		return 0;
+	}
+
+	// Read one byte more than the maximum journal size
+	// so an oversized file is rejected.
+	vector<uint8_t> jnl(SaveJournalPrivate::JNL_MAX_FILE_SIZE + 1);
+	const size_t len = fread(&jnl[0], 1, jnl.size(), f);
+	fclose(f);
+
+	int ret = 0;
+	if (len > 0 && len < jnl.size() &&
+	    SaveJournalPrivate::checkJournal(&jnl[0], len))
+	{
+		// Journal is complete. Reapply it.
+		ret = SaveJournalPrivate::applyJournal(filename, &jnl[0]);
+		if (ret == 0) {
+			ret = 1;
+		}
+	}
+
+	if (ret >= 0) {
+		// Journal was either applied or incomplete.
+		SaveJournalPrivate::removeJournal(jnlFilename);
+	}
+	return ret;
+}
+
+/**
+ * Queue modified pages for writing.
+ * Pages queued before the writer thread picks them up
+ * are merged into a single journal commit.
+ * @param filename Save file.
+ * @param data Save data.
+ * @param size New file size. (at most MAX_SIZE)
+ * @param dirty Modified pages.
+ * @return 0 on success; negative POSIX error code if a previous write failed.
+ */
+int SaveJournal::write(const string &filename, const uint8_t *data,
+		       unsigned int size, const DirtyPages &dirty)
+{
+	if (size > MAX_SIZE)
+		size = MAX_SIZE;
+
+	unique_lock<mutex> lock(d->mtx);
+	SaveJournalPrivate::Batch *pending = d->pending;
+	if (pending->valid && pending->filename != filename) {
+		// Pages for a different file are still queued.
+		// Wait for them to be committed.
+		while (d->pending->valid) {
+			d->cvDone.wait(lock);
+		}
+		pending = d->pending;
+	}
+
+	if (!pending->valid) {
+		pending->filename = filename;
+		pending->dirty.clear();
+		if (pending->data.empty()) {
+			pending->data.resize(MAX_SIZE);
+		}
+	}
+
+	if (filename != d->diskFilename) {
+		// Unknown file. Write everything.
+		d->diskFilename = filename;
+		d->diskSize = 0;
+	}
+
+	// Copy the dirty pages, plus any pages
+	// that extend past the end of the file.
+	const unsigned int pageCount = (size + PAGE_SIZE - 1) >> PAGE_SHIFT;
+	for (unsigned int page = 0; page < pageCount; page++) {
+		const unsigned int offset = (page << PAGE_SHIFT);
+		if (!dirty.test(page) && offset + PAGE_SIZE <= d->diskSize)
+			continue;
+
+		unsigned int len = PAGE_SIZE;
+		if (offset + len > size)
+			len = size - offset;
+		memcpy(&pending->data[offset], &data[offset], len);
+		pending->dirty.set(offset);
+	}
+	pending->size = size;
+	pending->valid = true;
+	d->diskSize = size;
+
+	if (!d->writer.joinable()) {
+		// Start the writer thread.
+		d->writer = thread(SaveJournalPrivate::writerThread, d);
+	}
+
+	// Report errors from earlier commits.
+	const int ret = d->error;
+	d->error = 0;
+	lock.unlock();
+	d->cvWork.notify_one();
+	return ret;
+}
+
+/**
+ * Wait for all queued writes to finish.
+ * @return 0 on success; negative POSIX error code if a write failed.
+ */
+int SaveJournal::flush(void)
+{
+	unique_lock<mutex> lock(d->mtx);
+	while (d->pending->valid || d->busy) {
+		d->cvDone.wait(lock);
+	}
+	const int ret = d->error;
+	d->error = 0;
+	return ret;
+}
+
+/**
+ * Mark the pages of failed commits as modified.
+ * If a commit fails, the save file's contents are unknown,
+ * so the owner has to queue the pages again. This should
+ * be checked before each autosave.
+ * @param dirty Modified pages. Pages from failed commits are added.
+ * @return 0 if no commits failed; negative POSIX error code if a commit failed.
+ */
+int SaveJournal::takeFailedPages(DirtyPages &dirty)
+{
+	unique_lock<mutex> lock(d->mtx);
+	const int ret = d->failedError;
+	if (ret == 0)
+		return 0;
+
+	dirty.merge(d->failedPages);
+	d->failedPages.clear();
+	d->failedError = 0;
+	// Don't report the same error from write() or flush().
+	d->error = 0;
+	return ret;
+}
+
+}
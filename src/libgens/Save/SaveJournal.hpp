@@ -0,0 +1,169 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * SaveJournal.hpp: Journaled page writes for save files.                  *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_SAVE_SAVEJOURNAL_HPP__
+#define __LIBGENS_SAVE_SAVEJOURNAL_HPP__
+
+// C includes.
+#include <stdint.h>
+// C includes. (C++ namespace)
+#include <cstring>
+// C++ includes.
+#include <string>
+
+namespace LibGens {
+
+class SaveJournalPrivate;
+
+/**
+ * Journaled page writes for SRam and EEPRom save files.
+ *
+ * The save data owner tracks modified pages in a DirtyPages
+ * bitmap. write() copies only those pages and hands them to
+ * a writer thread, so the emulation thread never touches
+ * the file.
+ *
+ * The writer thread commits each batch in two steps:
+ * - The pages are written to "<filename>.jnl", followed by
+ *   a checksum, and the journal is synced to disk.
+ * - The pages are written to the save file, the file is
+ *   truncated to its new size and synced, and the journal
+ *   is removed.
+ *
+ * If a commit fails, its pages are kept until the owner
+ * picks them up with takeFailedPages() and marks them
+ * as modified again.
+ *
+ * If the program is interrupted during the second step,
+ * recover() finds the complete journal and reapplies it.
+ * If it's interrupted during the first step, the journal's
+ * checksum doesn't match, and the save file is untouched.
+ */
+class SaveJournal
+{
+	public:
+		SaveJournal();
+		~SaveJournal();
+
+	private:
+		friend class SaveJournalPrivate;
+		SaveJournalPrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		SaveJournal(const SaveJournal &);
+		SaveJournal &operator=(const SaveJournal &);
+
+	public:
+		// Page size. Dirty bits are tracked per page.
+		static const unsigned int PAGE_SHIFT = 8;
+		static const unsigned int PAGE_SIZE = (1U << PAGE_SHIFT);
+		// Maximum save file size. (SRam is 64 KB.)
+		static const unsigned int MAX_SIZE = 64*1024;
+		static const unsigned int MAX_PAGES = (MAX_SIZE / PAGE_SIZE);
+
+		/**
+		 * Dirty page bitmap.
+		 * Addresses are relative to the start of the save data.
+		 */
+		struct DirtyPages {
+			uint32_t bits[MAX_PAGES / 32];
+
+			inline void clear(void)
+				{ memset(bits, 0, sizeof(bits)); }
+			inline void setAll(void)
+				{ memset(bits, 0xFF, sizeof(bits)); }
+			inline void set(unsigned int address)
+			{
+				const unsigned int page = (address >> PAGE_SHIFT);
+				bits[page >> 5] |= (1U << (page & 31));
+			}
+			inline void setRange(unsigned int address, unsigned int length)
+			{
+				if (length == 0)
+					return;
+				const unsigned int last = (address + length - 1);
+				for (; address <= last; address += PAGE_SIZE) {
+					set(address);
+				}
+				set(last);
+			}
+			inline bool test(unsigned int page) const
+				{ return !!(bits[page >> 5] & (1U << (page & 31))); }
+			inline void merge(const DirtyPages &other)
+			{
+				for (unsigned int i = 0; i < (MAX_PAGES / 32); i++) {
+					bits[i] |= other.bits[i];
+				}
+			}
+		};
+
+		/**
+		 * Set the size of a save file that was just loaded.
+		 * Pages past the end of the file are written regardless
+		 * of the dirty bitmap. Calling write() with a different
+		 * filename resets this to 0, forcing a full write.
+		 * @param filename Save file.
+		 * @param size File size.
+		 */
+		void setFileSize(const std::string &filename, unsigned int size);
+
+		/**
+		 * Apply an interrupted journal to a save file, if one exists.
+		 * This should be called before loading the save file.
+		 * @param filename Save file.
+		 * @return 1 if a journal was applied; 0 if not; negative POSIX error code on error.
+		 */
+		int recover(const std::string &filename);
+
+		/**
+		 * Queue modified pages for writing.
+		 * Pages queued before the writer thread picks them up
+		 * are merged into a single journal commit.
+		 * @param filename Save file.
+		 * @param data Save data.
+		 * @param size New file size. (at most MAX_SIZE)
+		 * @param dirty Modified pages.
+		 * @return 0 on success; negative POSIX error code if a previous write failed.
+		 */
+		int write(const std::string &filename, const uint8_t *data,
+			  unsigned int size, const DirtyPages &dirty);
+
+		/**
+		 * Wait for all queued writes to finish.
+		 * @return 0 on success; negative POSIX error code if a write failed.
+		 */
+		int flush(void);
+
+		/**
+		 * Mark the pages of failed commits as modified.
+		 * If a commit fails, the save file's contents are unknown,
+		 * so the owner has to queue the pages again. This should
+		 * be checked before each autosave.
+		 * @param dirty Modified pages. Pages from failed commits are added.
+		 * @return 0 if no commits failed; negative POSIX error code if a commit failed.
+		 */
+		int takeFailedPages(DirtyPages &dirty);
+};
+
+}
+
+#endif /* __LIBGENS_SAVE_SAVEJOURNAL_HPP__ */
@@ -0,0 +1,1344 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Capture.cpp: WAV/VGM/video capture.                                     *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "Capture.hpp"
+#include "MpscQueue.hpp"
+
+// LibGens
+#include "sound/SoundMgr.hpp"
+#include "EmuContext/EmuContext.hpp"
+#include "Vdp/Vdp.hpp"
+
+// M68K.hpp has CLOCK_NTSC and CLOCK_PAL #defines.
+// TODO: Convert to static const ints and move elsewhere.
+#include "cpu/M68K.hpp"
+
+// Atomic operations.
+#include "libcompat/atomic.h"
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+// C++ includes.
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+using std::condition_variable;
+using std::mutex;
+using std::unique_lock;
+using std::vector;
+
+#ifdef _WIN32
+#define popen(command, mode) _popen((command), (mode))
+#define pclose(stream) _pclose(stream)
+#define POPEN_WRITE_MODE "wb"
+#else
+#define POPEN_WRITE_MODE "w"
+#endif
+
+namespace LibGens {
+
+/**
+ * Capture private class.
+ */
+class CapturePrivate
+{
+	public:
+		CapturePrivate();
+		~CapturePrivate();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		CapturePrivate(const CapturePrivate &);
+		CapturePrivate &operator=(const CapturePrivate &);
+
+	public:
+		// Maximum captured video size.
+		static const int MAX_WIDTH = 320;
+		static const int MAX_HEIGHT = 240;
+
+		// Buffer pool and queue sizes.
+		static const unsigned int AUDIO_BLOCKS = 32;
+		static const unsigned int VIDEO_FRAMES = 8;
+		static const unsigned int REG_EVENTS = 65536;
+
+		// Write buffered data once this much has accumulated.
+		static const size_t FLUSH_SIZE = 64 * 1024;
+
+		// VGM sample rate.
+		static const int VGM_RATE = 44100;
+
+		// VGM header size.
+		// NOTE: Must be at least 0x100 for VGM 1.71.
+		static const uint32_t VGM_HEADER_SIZE = 0x100;
+
+		// One frame of audio, as generated by the audio ICs.
+		struct AudioBlock {
+			int len;
+			int32_t left[SoundMgr::MAX_SEGMENT_SIZE];
+			int32_t right[SoundMgr::MAX_SEGMENT_SIZE];
+		};
+
+		// One frame of video, in the framebuffer's color depth.
+		struct VideoFrame {
+			int width;
+			int height;
+			MdFb::ColorDepth bpp;
+			bool isPal;
+			uint8_t px[MAX_WIDTH * MAX_HEIGHT * 4];
+		};
+
+		// Sound chip register write.
+		enum RegChip {
+			CHIP_YM2612_PORT0 = 0,
+			CHIP_YM2612_PORT1 = 1,
+			CHIP_PSG = 2,
+		};
+		struct RegEvent {
+			uint32_t sample;	// Time, in VGM samples.
+			uint8_t chip;		// RegChip
+			uint8_t reg;		// Register. (YM2612 only)
+			uint8_t data;		// Data.
+		};
+
+		/**
+		 * Buffer pools.
+		 * The emulation thread takes empty buffers from the free queues,
+		 * fills them, and puts them on the full queues. The writer thread
+		 * writes buffers from the full queues and puts them back on the
+		 * free queues. The buffers are only allocated while capturing.
+		 */
+		MpscQueue<AudioBlock*, AUDIO_BLOCKS> audioFree;
+		MpscQueue<AudioBlock*, AUDIO_BLOCKS> audioFull;
+		MpscQueue<VideoFrame*, VIDEO_FRAMES> videoFree;
+		MpscQueue<VideoFrame*, VIDEO_FRAMES> videoFull;
+		vector<AudioBlock*> audioBlocks;
+		vector<VideoFrame*> videoFrames;
+
+		// Sound chip register writes.
+		MpscQueue<RegEvent, REG_EVENTS> regQueue;
+
+		/** Emulation thread. **/
+		bool active;
+		bool waitForWriter;
+		uint32_t frameCount;
+		uint32_t dropped;	// atomic
+		uint32_t vgmSample;	// VGM sample at the start of the current frame.
+		uint32_t vgmFrameLen;	// VGM samples per frame.
+
+		/**
+		 * Wake the writer thread, if it's waiting.
+		 */
+		void wakeWriter(void);
+
+		/**
+		 * Queue a sound chip register write.
+		 * @param sample Time, in VGM samples.
+		 * @param chip RegChip.
+		 * @param reg Register.
+		 * @param data Data.
+		 */
+		void queueReg(uint32_t sample, uint8_t chip, uint8_t reg, uint8_t data);
+
+		/**
+		 * Queue a sound chip register write at the current time.
+		 * @param chip RegChip.
+		 * @param reg Register.
+		 * @param data Data.
+		 */
+		void pushReg(uint8_t chip, uint8_t reg, uint8_t data);
+
+		/**
+		 * Get an empty buffer from a buffer pool.
+		 * If waitForWriter is set, this waits for the writer
+		 * thread to free a buffer if the pool is empty.
+		 * @param pool Buffer pool.
+		 * @param buf [out] Buffer.
+		 * @return True on success; false if the pool is empty.
+		 */
+		template<typename T, unsigned int N>
+		bool popFree(MpscQueue<T*, N> *pool, T **buf);
+
+		/**
+		 * YM2612 write log function.
+		 * @param param CapturePrivate.
+		 * @param port YM2612 port. (0 or 1)
+		 * @param reg Register.
+		 * @param data Data.
+		 */
+		static void ym2612WriteLog(void *param, int port, uint8_t reg, uint8_t data);
+
+		/**
+		 * PSG write log function.
+		 * @param param CapturePrivate.
+		 * @param data Data.
+		 */
+		static void psgWriteLog(void *param, uint8_t data);
+
+		/**
+		 * Queue writes for the current sound chip registers.
+		 * This is used to initialize the VGM.
+		 */
+		void pushRegState(void);
+
+		/** Writer thread. **/
+		std::thread writer;
+		int err;	// First write error.
+
+		// Protected by mtx.
+		mutex mtx;
+		condition_variable cvFull;	// Writer waits for queued data here.
+		condition_variable cvFree;	// Emulation thread waits for free space here.
+		bool workPending;	// Data was queued since the writer last checked.
+		bool quit;
+
+		/**
+		 * Record a write error.
+		 * Only the first error is kept.
+		 */
+		void setErr(void);
+
+		/**
+		 * Writer thread function.
+		 * @param d CapturePrivate.
+		 */
+		static void writerThread(CapturePrivate *d);
+
+		/**
+		 * Write everything that's currently queued.
+		 * @return True if anything was written; false if the queues were empty.
+		 */
+		bool drainQueues(void);
+
+		/** WAV **/
+		FILE *wavFile;
+		uint32_t wavRate;
+		uint32_t wavDataSize;
+		vector<uint8_t> wavBuf;
+
+		static void putLE16(uint8_t *p, uint16_t val);
+		static void putLE32(uint8_t *p, uint32_t val);
+
+		/**
+		 * Write the WAV header.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int writeWavHeader(void);
+
+		/**
+		 * Write an audio block to the WAV file.
+		 * @param block Audio block.
+		 */
+		void writeWav(const AudioBlock *block);
+
+		/** VGM **/
+		FILE *vgmFile;
+		FILE *vgmCmdFile;	// Temporary file for VGM commands.
+		uint32_t vgmCmdSize;	// Bytes written to vgmCmdFile.
+		vector<uint8_t> vgmCmds;
+		vector<uint8_t> vgmPcm;	// YM2612 DAC data block.
+		uint32_t vgmLastSample;	// Time of the last command.
+		bool vgmLastDac;	// Last command is a DAC write that can absorb a wait.
+		bool vgmIsPal;
+
+		/**
+		 * Write buffered VGM commands to the temporary file.
+		 */
+		void flushVgmCmds(void);
+
+		/**
+		 * Add a VGM wait.
+		 * @param samples Number of samples to wait.
+		 */
+		void vgmWait(uint32_t samples);
+
+		/**
+		 * Add a sound chip register write to the VGM.
+		 * @param ev Register write.
+		 */
+		void writeVgm(const RegEvent &ev);
+
+		/**
+		 * Finish the VGM file.
+		 * Writes the header, the DAC data block, and the commands.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int finishVgm(void);
+
+		/** Video **/
+		FILE *videoFile;
+		bool videoIsPipe;
+		Capture::VideoFormat videoFormat;
+		int videoWidth;		// Set by the first frame.
+		int videoHeight;	// Set by the first frame.
+		vector<uint8_t> videoBuf;
+
+		/**
+		 * Convert a captured frame to RGB24.
+		 * The frame is cropped or padded to the video size.
+		 * @param frame Video frame.
+		 * @param rgb Destination. (videoWidth * videoHeight * 3 bytes)
+		 */
+		void frameToRgb24(const VideoFrame *frame, uint8_t *rgb) const;
+
+		/**
+		 * Write a video frame.
+		 * @param frame Video frame.
+		 */
+		void writeVideo(const VideoFrame *frame);
+
+		/**
+		 * Close all files and free the buffers.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int closeAll(void);
+};
+
+/** CapturePrivate **/
+
+CapturePrivate::CapturePrivate()
+	: active(false)
+	, waitForWriter(false)
+	, frameCount(0)
+	, dropped(0)
+	, vgmSample(0)
+	, vgmFrameLen(VGM_RATE / 60)
+	, err(0)
+	, workPending(false)
+	, quit(false)
+	, wavFile(nullptr)
+	, wavRate(0)
+	, wavDataSize(0)
+	, vgmFile(nullptr)
+	, vgmCmdFile(nullptr)
+	, vgmCmdSize(0)
+	, vgmLastSample(0)
+	, vgmLastDac(false)
+	, vgmIsPal(false)
+	, videoFile(nullptr)
+	, videoIsPipe(false)
+	, videoFormat(Capture::VIDEO_RAW_RGB24)
+	, videoWidth(0)
+	, videoHeight(0)
+{ }
+
+CapturePrivate::~CapturePrivate()
+{
+	closeAll();
+}
+
+/**
+ * Wake the writer thread, if it's waiting.
+ */
+void CapturePrivate::wakeWriter(void)
+{
+	unique_lock<mutex> lock(mtx);
+	if (!workPending) {
+		workPending = true;
+		cvFull.notify_one();
+	}
+}
+
+/**
+ * Queue a sound chip register write.
+ * @param sample Time, in VGM samples.
+ * @param chip RegChip.
+ * @param reg Register.
+ * @param data Data.
+ */
+void CapturePrivate::queueReg(uint32_t sample, uint8_t chip, uint8_t reg, uint8_t data)
+{
+	RegEvent ev;
+	ev.sample = sample;
+	ev.chip = chip;
+	ev.reg = reg;
+	ev.data = data;
+
+	if (regQueue.push(ev)) {
+		wakeWriter();
+		return;
+	}
+	if (!waitForWriter || !active) {
+		ATOMIC_ADD_FETCH(&dropped, 1);
+		return;
+	}
+
+	// Queue is full. Wait for the writer to drain it.
+	unique_lock<mutex> lock(mtx);
+	while (!regQueue.push(ev)) {
+		cvFree.wait(lock);
+	}
+	workPending = true;
+	cvFull.notify_one();
+}
+
+/**
+ * Queue a sound chip register write at the current time.
+ * @param chip RegChip.
+ * @param reg Register.
+ * @param data Data.
+ */
+void CapturePrivate::pushReg(uint8_t chip, uint8_t reg, uint8_t data)
+{
+	// Interpolate the time within the frame from the current line.
+	uint32_t sample = vgmSample;
+	const EmuContext *context = EmuContext::Instance();
+	if (context && context->m_vdp) {
+		const VdpTypes::VdpLines_t &lines = context->m_vdp->VDP_Lines;
+		if (lines.currentLine > 0 && lines.totalDisplayLines > 0) {
+			const int line = std::min(lines.currentLine, lines.totalDisplayLines);
+			sample += (vgmFrameLen * line) / lines.totalDisplayLines;
+		}
+	}
+	queueReg(sample, chip, reg, data);
+}
+
+/**
+ * Get an empty buffer from a buffer pool.
+ * If waitForWriter is set, this waits for the writer
+ * thread to free a buffer if the pool is empty.
+ * @param pool Buffer pool.
+ * @param buf [out] Buffer.
+ * @return True on success; false if the pool is empty.
+ */
+template<typename T, unsigned int N>
+bool CapturePrivate::popFree(MpscQueue<T*, N> *pool, T **buf)
+{
+	if (pool->pop(buf))
+		return true;
+	if (!waitForWriter)
+		return false;
+
+	// Pool is empty. Wait for the writer to free a buffer.
+	unique_lock<mutex> lock(mtx);
+	while (!pool->pop(buf)) {
+		cvFree.wait(lock);
+	}
+	return true;
+}
+
+/**
+ * YM2612 write log function.
+ * @param param CapturePrivate.
+ * @param port YM2612 port. (0 or 1)
+ * @param reg Register.
+ * @param data Data.
+ */
+void CapturePrivate::ym2612WriteLog(void *param, int port, uint8_t reg, uint8_t data)
+{
+	static_cast<CapturePrivate*>(param)->pushReg(
+		(port ? CHIP_YM2612_PORT1 : CHIP_YM2612_PORT0), reg, data);
+}
+
+/**
+ * PSG write log function.
+ * @param param CapturePrivate.
+ * @param data Data.
+ */
+void CapturePrivate::psgWriteLog(void *param, uint8_t data)
+{
+	static_cast<CapturePrivate*>(param)->pushReg(CHIP_PSG, 0, data);
+}
+
+/**
+ * Queue writes for the current sound chip registers.
+ * This is used to initialize the VGM, so the writes
+ * are queued at time 0.
+ */
+void CapturePrivate::pushRegState(void)
+{
+	const Ym2612 &ym2612 = SoundMgr::ms_Ym2612;
+
+	// YM2612: Global registers.
+	// Timer bits in 0x27 are masked out; only the Channel 3 mode is kept.
+	queueReg(0, CHIP_YM2612_PORT0, 0x22, (uint8_t)ym2612.getReg(0x22));
+	queueReg(0, CHIP_YM2612_PORT0, 0x27, (uint8_t)(ym2612.getReg(0x27) & 0xC0));
+	queueReg(0, CHIP_YM2612_PORT0, 0x2B, (uint8_t)ym2612.getReg(0x2B));
+
+	// YM2612: Channel registers.
+	for (int port = 0; port < 2; port++) {
+		const uint8_t chip = (port ? CHIP_YM2612_PORT1 : CHIP_YM2612_PORT0);
+		const int base = (port << 8);
+
+		// Operator registers.
+		for (int reg = 0x30; reg < 0xA0; reg++) {
+			if ((reg & 3) == 3)
+				continue;
+			queueReg(0, chip, reg, (uint8_t)ym2612.getReg(base | reg));
+		}
+
+		// Frequency registers.
+		// The high byte (0xA4) is latched until the low byte (0xA0) is written.
+		for (int ch = 0; ch < 3; ch++) {
+			queueReg(0, chip, 0xA4 + ch, (uint8_t)ym2612.getReg(base | (0xA4 + ch)));
+			queueReg(0, chip, 0xA0 + ch, (uint8_t)ym2612.getReg(base | (0xA0 + ch)));
+			if (port == 0) {
+				// Channel 3 special mode frequencies.
+				queueReg(0, chip, 0xAC + ch, (uint8_t)ym2612.getReg(0xAC + ch));
+				queueReg(0, chip, 0xA8 + ch, (uint8_t)ym2612.getReg(0xA8 + ch));
+			}
+			queueReg(0, chip, 0xB0 + ch, (uint8_t)ym2612.getReg(base | (0xB0 + ch)));
+			queueReg(0, chip, 0xB4 + ch, (uint8_t)ym2612.getReg(base | (0xB4 + ch)));
+		}
+	}
+
+	// PSG: Tone and volume registers.
+	const Psg &psg = SoundMgr::ms_Psg;
+	for (int ch = 0; ch < 4; ch++) {
+		uint16_t tone = 0, volume = 0;
+		psg.dbg_getReg(ch * 2, &tone);
+		psg.dbg_getReg((ch * 2) + 1, &volume);
+
+		const uint8_t latch = 0x80 | (ch << 5);
+		if (ch < 3) {
+			// Tone channel: 10-bit frequency.
+			queueReg(0, CHIP_PSG, 0, latch | (tone & 0x0F));
+			queueReg(0, CHIP_PSG, 0, (tone >> 4) & 0x3F);
+		} else {
+			// Noise channel: 3-bit mode.
+			queueReg(0, CHIP_PSG, 0, latch | (tone & 0x07));
+		}
+		queueReg(0, CHIP_PSG, 0, latch | 0x10 | (volume & 0x0F));
+	}
+}
+
+/**
+ * Record a write error.
+ * Only the first error is kept.
+ */
+void CapturePrivate::setErr(void)
+{
+	if (err == 0) {
+		err = (errno != 0 ? -errno : -EIO);
+	}
+}
+
+/**
+ * Writer thread function.
+ * @param d CapturePrivate.
+ */
+void CapturePrivate::writerThread(CapturePrivate *d)
+{
+	for (;;) {
+		// Check for quit *before* draining, so anything
+		// queued before stop() was called gets written.
+		bool quitting;
+		{
+			unique_lock<mutex> lock(d->mtx);
+			while (!d->workPending && !d->quit) {
+				d->cvFull.wait(lock);
+			}
+			d->workPending = false;
+			quitting = d->quit;
+		}
+
+		if (d->drainQueues()) {
+			// Buffers were freed. Wake the emulation
+			// thread if it's waiting for space.
+			unique_lock<mutex> lock(d->mtx);
+			d->cvFree.notify_all();
+		}
+		if (quitting)
+			break;
+	}
+}
+
+/**
+ * Write everything that's currently queued.
+ * @return True if anything was written; false if the queues were empty.
+ */
+bool CapturePrivate::drainQueues(void)
+{
+	bool didWork = false;
+
+	RegEvent ev;
+	while (regQueue.pop(&ev)) {
+		writeVgm(ev);
+		didWork = true;
+	}
+
+	AudioBlock *block;
+	while (audioFull.pop(&block)) {
+		writeWav(block);
+		audioFree.push(block);
+		didWork = true;
+	}
+
+	VideoFrame *frame;
+	while (videoFull.pop(&frame)) {
+		writeVideo(frame);
+		videoFree.push(frame);
+		didWork = true;
+	}
+
+	return didWork;
+}
+
+/** WAV **/
+
+void CapturePrivate::putLE16(uint8_t *p, uint16_t val)
+{
+	p[0] = (val & 0xFF);
+	p[1] = (val >> 8);
+}
+
+void CapturePrivate::putLE32(uint8_t *p, uint32_t val)
+{
+	putLE16(p, (val & 0xFFFF));
+	putLE16(p + 2, (val >> 16));
+}
+
+/**
+ * Write the WAV header.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int CapturePrivate::writeWavHeader(void)
+{
+	uint8_t hdr[44];
+	memcpy(&hdr[0], "RIFF", 4);
+	putLE32(&hdr[4], 36 + wavDataSize);
+	memcpy(&hdr[8], "WAVE", 4);
+	memcpy(&hdr[12], "fmt ", 4);
+	putLE32(&hdr[16], 16);			// fmt chunk size
+	putLE16(&hdr[20], 1);			// PCM
+	putLE16(&hdr[22], 2);			// Channels
+	putLE32(&hdr[24], wavRate);		// Sample rate
+	putLE32(&hdr[28], wavRate * 4);		// Byte rate
+	putLE16(&hdr[32], 4);			// Block align
+	putLE16(&hdr[34], 16);			// Bits per sample
+	memcpy(&hdr[36], "data", 4);
+	putLE32(&hdr[40], wavDataSize);
+
+	errno = 0;
+	if (fwrite(hdr, 1, sizeof(hdr), wavFile) != sizeof(hdr))
+		return (errno != 0 ? -errno : -EIO);
+	return 0;
+}
+
+/**
+ * Write an audio block to the WAV file.
+ * @param block Audio block.
+ */
+void CapturePrivate::writeWav(const AudioBlock *block)
+{
+	if (!wavFile || err != 0)
+		return;
+
+	wavBuf.resize(block->len * 4);
+	uint8_t *p = (wavBuf.empty() ? nullptr : &wavBuf[0]);
+	for (int i = 0; i < block->len; i++, p += 4) {
+		const int32_t l = std::max(-0x8000, std::min(0x7FFF, block->left[i]));
+		const int32_t r = std::max(-0x8000, std::min(0x7FFF, block->right[i]));
+		putLE16(p, (uint16_t)l);
+		putLE16(p + 2, (uint16_t)r);
+	}
+
+	errno = 0;
+	if (!wavBuf.empty()) {
+		if (fwrite(&wavBuf[0], 1, wavBuf.size(), wavFile) != wavBuf.size()) {
+			setErr();
+			return;
+		}
+	}
+	wavDataSize += (uint32_t)wavBuf.size();
+}
+
+/** VGM **/
+
+/**
+ * Write buffered VGM commands to the temporary file.
+ */
+void CapturePrivate::flushVgmCmds(void)
+{
+	if (!vgmCmds.empty() && err == 0) {
+		errno = 0;
+		if (fwrite(&vgmCmds[0], 1, vgmCmds.size(), vgmCmdFile) != vgmCmds.size()) {
+			setErr();
+		}
+		vgmCmdSize += (uint32_t)vgmCmds.size();
+	}
+	vgmCmds.clear();
+}
+
+/**
+ * Add a VGM wait.
+ * @param samples Number of samples to wait.
+ */
+void CapturePrivate::vgmWait(uint32_t samples)
+{
+	if (samples == 0)
+		return;
+
+	if (vgmLastDac) {
+		// Fold up to 15 samples into the DAC write. (0x8n)
+		const uint32_t n = std::min(samples, 15U);
+		vgmCmds.back() |= (uint8_t)n;
+		samples -= n;
+		vgmLastDac = false;
+	}
+
+	while (samples > 0) {
+		if (samples == 735) {
+			// Wait 1/60th of a second.
+			vgmCmds.push_back(0x62);
+			samples = 0;
+		} else if (samples == 882) {
+			// Wait 1/50th of a second.
+			vgmCmds.push_back(0x63);
+			samples = 0;
+		} else if (samples <= 16) {
+			// Short wait.
+			vgmCmds.push_back(0x70 | (samples - 1));
+			samples = 0;
+		} else {
+			const uint32_t n = std::min(samples, 65535U);
+			vgmCmds.push_back(0x61);
+			vgmCmds.push_back(n & 0xFF);
+			vgmCmds.push_back(n >> 8);
+			samples -= n;
+		}
+	}
+
+	if (vgmCmds.size() >= FLUSH_SIZE) {
+		flushVgmCmds();
+	}
+}
+
+/**
+ * Add a sound chip register write to the VGM.
+ * @param ev Register write.
+ */
+void CapturePrivate::writeVgm(const RegEvent &ev)
+{
+	if (!vgmFile)
+		return;
+
+	if (ev.sample > vgmLastSample) {
+		vgmWait(ev.sample - vgmLastSample);
+		vgmLastSample = ev.sample;
+	}
+
+	switch (ev.chip) {
+		case CHIP_YM2612_PORT0:
+			if (ev.reg == 0x2A) {
+				// DAC write. Store the sample in the data block.
+				vgmPcm.push_back(ev.data);
+				vgmCmds.push_back(0x80);
+				vgmLastDac = true;
+				return;
+			}
+			vgmCmds.push_back(0x52);
+			vgmCmds.push_back(ev.reg);
+			vgmCmds.push_back(ev.data);
+			break;
+		case CHIP_YM2612_PORT1:
+			vgmCmds.push_back(0x53);
+			vgmCmds.push_back(ev.reg);
+			vgmCmds.push_back(ev.data);
+			break;
+		case CHIP_PSG:
+			vgmCmds.push_back(0x50);
+			vgmCmds.push_back(ev.data);
+			break;
+		default:
+			return;
+	}
+	vgmLastDac = false;
+
+	if (vgmCmds.size() >= FLUSH_SIZE) {
+		flushVgmCmds();
+	}
+}
+
+/**
+ * Finish the VGM file.
+ * Writes the header, the DAC data block, and the commands.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int CapturePrivate::finishVgm(void)
+{
+	// Wait until the end of the last frame.
+	if (vgmSample > vgmLastSample) {
+		vgmWait(vgmSample - vgmLastSample);
+		vgmLastSample = vgmSample;
+	}
+	vgmCmds.push_back(0x66);	// End of sound data.
+	flushVgmCmds();
+	if (err != 0)
+		return err;
+
+	// DAC data block, followed by a seek to the start of the block.
+	// The PCM data is written in the same order that
+	// the 0x80 commands read it, so one seek is enough.
+	vector<uint8_t> block;
+	if (!vgmPcm.empty()) {
+		const uint32_t pcmSize = (uint32_t)vgmPcm.size();
+		block.resize(7);
+		block[0] = 0x67;	// Data block
+		block[1] = 0x66;
+		block[2] = 0x00;	// Type: YM2612 PCM
+		putLE32(&block[3], pcmSize);
+		block.insert(block.end(), vgmPcm.begin(), vgmPcm.end());
+		const uint8_t seek[5] = {0xE0, 0x00, 0x00, 0x00, 0x00};
+		block.insert(block.end(), seek, seek + sizeof(seek));
+	}
+
+	// VGM header.
+	const uint32_t clock = (vgmIsPal ? CLOCK_PAL : CLOCK_NTSC);
+	const uint32_t eof = VGM_HEADER_SIZE + (uint32_t)block.size() + vgmCmdSize;
+	uint8_t hdr[VGM_HEADER_SIZE];
+	memset(hdr, 0, sizeof(hdr));
+	memcpy(&hdr[0x00], "Vgm ", 4);
+	putLE32(&hdr[0x04], eof - 0x04);		// EOF offset
+	putLE32(&hdr[0x08], 0x00000171);		// Version
+	putLE32(&hdr[0x0C], clock / 15);		// SN76489 clock
+	putLE32(&hdr[0x18], vgmLastSample);		// Total samples
+	putLE32(&hdr[0x24], (vgmIsPal ? 50 : 60));	// Rate
+	putLE16(&hdr[0x28], 0x0009);			// SN76489 feedback
+	hdr[0x2A] = 16;					// SN76489 shift register width
+	putLE32(&hdr[0x2C], clock / 7);			// YM2612 clock
+	putLE32(&hdr[0x34], VGM_HEADER_SIZE - 0x34);	// VGM data offset
+
+	errno = 0;
+	if (fwrite(hdr, 1, sizeof(hdr), vgmFile) != sizeof(hdr))
+		return (errno != 0 ? -errno : -EIO);
+	if (!block.empty()) {
+		if (fwrite(&block[0], 1, block.size(), vgmFile) != block.size())
+			return (errno != 0 ? -errno : -EIO);
+	}
+
+	// Copy the commands from the temporary file.
+	rewind(vgmCmdFile);
+	uint8_t buf[16384];
+	size_t size;
+	while ((size = fread(buf, 1, sizeof(buf), vgmCmdFile)) > 0) {
+		if (fwrite(buf, 1, size, vgmFile) != size)
+			return (errno != 0 ? -errno : -EIO);
+	}
+	if (ferror(vgmCmdFile))
+		return -EIO;
+	return 0;
+}
+
+/** Video **/
+
+/**
+ * Convert a captured frame to RGB24.
+ * The frame is cropped or padded to the video size.
+ * @param frame Video frame.
+ * @param rgb Destination. (videoWidth * videoHeight * 3 bytes)
+ */
+void CapturePrivate::frameToRgb24(const VideoFrame *frame, uint8_t *rgb) const
+{
+	const int w = std::min(frame->width, videoWidth);
+	const int h = std::min(frame->height, videoHeight);
+	const size_t padSize = (size_t)(videoWidth - w) * 3;
+
+	for (int y = 0; y < h; y++) {
+		switch (frame->bpp) {
+			case MdFb::BPP_15: {
+				const uint16_t *src = (const uint16_t*)&frame->px[y * frame->width * 2];
+				for (int x = 0; x < w; x++, rgb += 3) {
+					const unsigned int r = (src[x] >> 10) & 0x1F;
+					const unsigned int g = (src[x] >> 5) & 0x1F;
+					const unsigned int b = src[x] & 0x1F;
+					rgb[0] = (r << 3) | (r >> 2);
+					rgb[1] = (g << 3) | (g >> 2);
+					rgb[2] = (b << 3) | (b >> 2);
+				}
+				break;
+			}
+			case MdFb::BPP_16: {
+				const uint16_t *src = (const uint16_t*)&frame->px[y * frame->width * 2];
+				for (int x = 0; x < w; x++, rgb += 3) {
+					const unsigned int r = (src[x] >> 11) & 0x1F;
+					const unsigned int g = (src[x] >> 5) & 0x3F;
+					const unsigned int b = src[x] & 0x1F;
+					rgb[0] = (r << 3) | (r >> 2);
+					rgb[1] = (g << 2) | (g >> 4);
+					rgb[2] = (b << 3) | (b >> 2);
+				}
+				break;
+			}
+			case MdFb::BPP_32:
+			default: {
+				const uint32_t *src = (const uint32_t*)&frame->px[y * frame->width * 4];
+				for (int x = 0; x < w; x++, rgb += 3) {
+					rgb[0] = (src[x] >> 16) & 0xFF;
+					rgb[1] = (src[x] >> 8) & 0xFF;
+					rgb[2] = src[x] & 0xFF;
+				}
+				break;
+			}
+		}
+
+		// Pad the rest of the line.
+		memset(rgb, 0, padSize);
+		rgb += padSize;
+	}
+
+	// Pad the rest of the frame.
+	memset(rgb, 0, (size_t)(videoHeight - h) * videoWidth * 3);
+}
+
+/**
+ * Write a video frame.
+ * @param frame Video frame.
+ */
+void CapturePrivate::writeVideo(const VideoFrame *frame)
+{
+	if (!videoFile || err != 0)
+		return;
+
+	errno = 0;
+	if (videoWidth == 0) {
+		// First frame. This sets the video size.
+		if (frame->width <= 0 || frame->height <= 0)
+			return;
+		videoWidth = frame->width;
+		videoHeight = frame->height;
+
+		if (videoFormat == Capture::VIDEO_Y4M) {
+			if (fprintf(videoFile, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n",
+				    videoWidth, videoHeight, (frame->isPal ? 50 : 60)) < 0)
+			{
+				setErr();
+				return;
+			}
+		}
+	}
+
+	const size_t pxCount = (size_t)videoWidth * videoHeight;
+	videoBuf.resize(pxCount * 3);
+	frameToRgb24(frame, &videoBuf[0]);
+
+	if (videoFormat == Capture::VIDEO_Y4M) {
+		// Convert to planar YCbCr 4:4:4. (BT.601, limited range)
+		// Each plane is stored after the RGB data.
+		videoBuf.resize(pxCount * 6);
+		const uint8_t *rgb = &videoBuf[0];
+		uint8_t *py = &videoBuf[pxCount * 3];
+		uint8_t *pu = py + pxCount;
+		uint8_t *pv = pu + pxCount;
+		for (size_t i = 0; i < pxCount; i++, rgb += 3) {
+			const int r = rgb[0], g = rgb[1], b = rgb[2];
+			py[i] = (uint8_t)((( 66 * r + 129 * g +  25 * b + 128) >> 8) + 16);
+			pu[i] = (uint8_t)(((-38 * r -  74 * g + 112 * b + 128) >> 8) + 128);
+			pv[i] = (uint8_t)(((112 * r -  94 * g -  18 * b + 128) >> 8) + 128);
+		}
+
+		if (fwrite("FRAME\n", 1, 6, videoFile) != 6 ||
+		    fwrite(&videoBuf[pxCount * 3], 1, pxCount * 3, videoFile) != pxCount * 3)
+		{
+			setErr();
+		}
+	} else {
+		if (fwrite(&videoBuf[0], 1, pxCount * 3, videoFile) != pxCount * 3) {
+			setErr();
+		}
+	}
+}
+
+/**
+ * Close all files and free the buffers.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int CapturePrivate::closeAll(void)
+{
+	int ret = err;
+
+	if (wavFile) {
+		// Update the chunk sizes.
+		int wavRet = -EIO;
+		if (fseek(wavFile, 0, SEEK_SET) == 0) {
+			wavRet = writeWavHeader();
+		}
+		if (fclose(wavFile) != 0 && wavRet == 0) {
+			wavRet = (errno != 0 ? -errno : -EIO);
+		}
+		if (ret == 0)
+			ret = wavRet;
+		wavFile = nullptr;
+	}
+
+	if (vgmFile) {
+		int vgmRet = finishVgm();
+		if (fclose(vgmFile) != 0 && vgmRet == 0) {
+			vgmRet = (errno != 0 ? -errno : -EIO);
+		}
+		if (ret == 0)
+			ret = vgmRet;
+		vgmFile = nullptr;
+	}
+	if (vgmCmdFile) {
+		fclose(vgmCmdFile);
+		vgmCmdFile = nullptr;
+	}
+	vgmCmds.clear();
+	vgmPcm.clear();
+
+	if (videoFile) {
+		int videoRet;
+		if (videoIsPipe) {
+			// Wait for the encoder to exit.
+			const int status = pclose(videoFile);
+			videoRet = (status == 0 ? 0 : (status < 0 ? -errno : -EPIPE));
+		} else {
+			videoRet = (fclose(videoFile) == 0 ? 0 : (errno != 0 ? -errno : -EIO));
+		}
+		if (ret == 0)
+			ret = videoRet;
+		videoFile = nullptr;
+	}
+
+	// Free the buffer pools.
+	AudioBlock *block;
+	while (audioFree.pop(&block)) { }
+	while (audioFull.pop(&block)) { }
+	for (size_t i = 0; i < audioBlocks.size(); i++) {
+		delete audioBlocks[i];
+	}
+	audioBlocks.clear();
+
+	VideoFrame *frame;
+	while (videoFree.pop(&frame)) { }
+	while (videoFull.pop(&frame)) { }
+	for (size_t i = 0; i < videoFrames.size(); i++) {
+		delete videoFrames[i];
+	}
+	videoFrames.clear();
+
+	RegEvent ev;
+	while (regQueue.pop(&ev)) { }
+
+	err = 0;
+	return ret;
+}
+
+/** Capture **/
+
+Capture::Capture()
+	: d(new CapturePrivate())
+{ }
+
+Capture::~Capture()
+{
+	stop();
+	delete d;
+}
+
+/**
+ * Get the name of a video format.
+ * @param format Video format.
+ * @return Name, e.g. "raw", or nullptr if invalid.
+ */
+const char *Capture::VideoFormatName(VideoFormat format)
+{
+	switch (format) {
+		case VIDEO_RAW_RGB24:	return "raw";
+		case VIDEO_Y4M:		return "y4m";
+		default:		break;
+	}
+	return nullptr;
+}
+
+/**
+ * Look up a video format by name.
+ * @param name Name, e.g. "raw".
+ * @return Video format, or VIDEO_MAX if not found.
+ */
+Capture::VideoFormat Capture::VideoFormatFromName(const char *name)
+{
+	if (!name)
+		return VIDEO_MAX;
+	for (int i = 0; i < VIDEO_MAX; i++) {
+		if (!strcmp(name, VideoFormatName((VideoFormat)i)))
+			return (VideoFormat)i;
+	}
+	return VIDEO_MAX;
+}
+
+/**
+ * Start capturing.
+ * Filenames may be nullptr to skip that output,
+ * but at least one filename must be specified.
+ *
+ * This must be called from the emulation thread,
+ * or while emulation isn't running, since the
+ * current sound chip registers are written to
+ * the start of the VGM.
+ *
+ * @param wavFile WAV filename.
+ * @param vgmFile VGM filename.
+ * @param videoFile Video filename, or "|command".
+ * @param videoFormat Video format.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int Capture::start(const char *wavFile, const char *vgmFile,
+		   const char *videoFile, VideoFormat videoFormat)
+{
+	if (d->active)
+		return -EBUSY;
+	if (!wavFile && !vgmFile && !videoFile)
+		return -EINVAL;
+	if (videoFile && (videoFormat < 0 || videoFormat >= VIDEO_MAX))
+		return -EINVAL;
+
+	bool isPal = false;
+	const EmuContext *context = EmuContext::Instance();
+	if (context && context->m_vdp) {
+		isPal = context->m_vdp->isPal();
+	}
+
+	d->frameCount = 0;
+	d->dropped = 0;
+	d->err = 0;
+	int ret = 0;
+
+	// Open the output files.
+	errno = 0;
+	if (wavFile) {
+		d->wavFile = fopen(wavFile, "wb");
+		if (!d->wavFile) {
+			ret = (errno != 0 ? -errno : -EIO);
+			goto fail;
+		}
+		d->wavRate = SoundMgr::GetSegRate();
+		d->wavDataSize = 0;
+		ret = d->writeWavHeader();
+		if (ret != 0)
+			goto fail;
+	}
+
+	if (vgmFile) {
+		d->vgmCmdFile = tmpfile();
+		if (!d->vgmCmdFile) {
+			ret = (errno != 0 ? -errno : -EIO);
+			goto fail;
+		}
+		d->vgmFile = fopen(vgmFile, "wb");
+		if (!d->vgmFile) {
+			ret = (errno != 0 ? -errno : -EIO);
+			goto fail;
+		}
+		d->vgmCmdSize = 0;
+		d->vgmLastSample = 0;
+		d->vgmLastDac = false;
+		d->vgmIsPal = isPal;
+	}
+
+	if (videoFile) {
+		d->videoIsPipe = (videoFile[0] == '|');
+		if (d->videoIsPipe) {
+			d->videoFile = popen(&videoFile[1], POPEN_WRITE_MODE);
+		} else {
+			d->videoFile = fopen(videoFile, "wb");
+		}
+		if (!d->videoFile) {
+			ret = (errno != 0 ? -errno : -EIO);
+			goto fail;
+		}
+		d->videoFormat = videoFormat;
+		d->videoWidth = 0;
+		d->videoHeight = 0;
+	}
+
+	// Allocate the buffer pools.
+	if (d->wavFile) {
+		for (unsigned int i = 0; i < CapturePrivate::AUDIO_BLOCKS; i++) {
+			d->audioBlocks.push_back(new CapturePrivate::AudioBlock);
+			d->audioFree.push(d->audioBlocks.back());
+		}
+	}
+	if (d->videoFile) {
+		for (unsigned int i = 0; i < CapturePrivate::VIDEO_FRAMES; i++) {
+			d->videoFrames.push_back(new CapturePrivate::VideoFrame);
+			d->videoFree.push(d->videoFrames.back());
+		}
+	}
+
+	// Initialize the VGM with the current register state,
+	// then log all register writes.
+	d->vgmSample = 0;
+	d->vgmFrameLen = CapturePrivate::VGM_RATE / (isPal ? 50 : 60);
+	if (d->vgmFile) {
+		d->pushRegState();
+		SoundMgr::ms_Ym2612.setWriteLog(CapturePrivate::ym2612WriteLog, d);
+		SoundMgr::ms_Psg.setWriteLog(CapturePrivate::psgWriteLog, d);
+	}
+
+	// Start the writer thread.
+	d->quit = false;
+	d->writer = std::thread(CapturePrivate::writerThread, d);
+	d->active = true;
+	return 0;
+
+fail:
+	d->closeAll();
+	return ret;
+}
+
+/**
+ * Stop capturing.
+ * Waits for the writer thread to finish writing
+ * all queued data, then closes the files.
+ * @return 0 on success; negative POSIX error code
+ * if any write failed while capturing.
+ */
+int Capture::stop(void)
+{
+	if (!d->active)
+		return 0;
+
+	// Stop logging register writes.
+	if (d->vgmFile) {
+		SoundMgr::ms_Ym2612.setWriteLog(nullptr, nullptr);
+		SoundMgr::ms_Psg.setWriteLog(nullptr, nullptr);
+	}
+
+	// Wait for the writer thread to write everything.
+	{
+		unique_lock<mutex> lock(d->mtx);
+		d->quit = true;
+		d->cvFull.notify_one();
+	}
+	d->writer.join();
+
+	d->active = false;
+	return d->closeAll();
+}
+
+/**
+ * Set whether the emulation thread should wait for the
+ * writer thread instead of dropping data if it falls behind.
+ * This is useful if emulation runs faster than realtime,
+ * e.g. for offline rendering. (Default is false.)
+ * @param waitForWriter True to wait; false to drop data.
+ */
+void Capture::setWaitForWriter(bool waitForWriter)
+{
+	d->waitForWriter = waitForWriter;
+}
+
+/**
+ * Is capture active?
+ * @return True if active; false if not.
+ */
+bool Capture::isActive(void) const
+{
+	return d->active;
+}
+
+/**
+ * Get the number of frames captured so far.
+ * @return Number of frames.
+ */
+uint32_t Capture::frameCount(void) const
+{
+	return d->frameCount;
+}
+
+/**
+ * Get the number of audio blocks, video frames,
+ * and register writes that were dropped because
+ * the writer thread fell behind.
+ * @return Number of dropped items.
+ */
+uint32_t Capture::droppedCount(void) const
+{
+	return ATOMIC_LOAD_ACQUIRE(&d->dropped);
+}
+
+/**
+ * Capture the current frame.
+ * This must be called after the frame is run
+ * and before the audio is written to the output buffer.
+ * @param fb MD framebuffer.
+ */
+void Capture::frame(const MdFb *fb)
+{
+	if (!d->active)
+		return;
+
+	if (d->wavFile) {
+		CapturePrivate::AudioBlock *block;
+		if (d->popFree(&d->audioFree, &block)) {
+			const int len = SoundMgr::GetSegLength();
+			block->len = len;
+			memcpy(block->left, SoundMgr::ms_SegBufL, len * sizeof(block->left[0]));
+			memcpy(block->right, SoundMgr::ms_SegBufR, len * sizeof(block->right[0]));
+			d->audioFull.push(block);
+			d->wakeWriter();
+		} else {
+			ATOMIC_ADD_FETCH(&d->dropped, 1);
+		}
+	}
+
+	bool isPal = false;
+	const EmuContext *context = EmuContext::Instance();
+	if (context && context->m_vdp) {
+		isPal = context->m_vdp->isPal();
+	}
+
+	if (d->videoFile && fb) {
+		CapturePrivate::VideoFrame *frame;
+		if (d->popFree(&d->videoFree, &frame)) {
+			const MdFb::ColorDepth bpp = fb->bpp();
+			const int w = std::min(fb->imgWidth(), (int)CapturePrivate::MAX_WIDTH);
+			const int h = std::min(fb->imgHeight(), (int)CapturePrivate::MAX_HEIGHT);
+			const int xStart = fb->imgXStart();
+			const int yStart = fb->imgYStart();
+			frame->width = w;
+			frame->height = h;
+			frame->bpp = bpp;
+			frame->isPal = isPal;
+
+			if (bpp == MdFb::BPP_32) {
+				const size_t lineSize = (size_t)w * 4;
+				for (int y = 0; y < h; y++) {
+					memcpy(&frame->px[y * lineSize], fb->lineBuf32(yStart + y) + xStart, lineSize);
+				}
+			} else {
+				const size_t lineSize = (size_t)w * 2;
+				for (int y = 0; y < h; y++) {
+					memcpy(&frame->px[y * lineSize], fb->lineBuf16(yStart + y) + xStart, lineSize);
+				}
+			}
+			d->videoFull.push(frame);
+			d->wakeWriter();
+		} else {
+			ATOMIC_ADD_FETCH(&d->dropped, 1);
+		}
+	}
+
+	// Advance the VGM time to the start of the next frame.
+	d->vgmSample += d->vgmFrameLen;
+	d->vgmFrameLen = CapturePrivate::VGM_RATE / (isPal ? 50 : 60);
+
+	d->frameCount++;
+}
+
+}
@@ -0,0 +1,162 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Capture.hpp: WAV/VGM/video capture.                                     *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_UTIL_CAPTURE_HPP__
+#define __LIBGENS_UTIL_CAPTURE_HPP__
+
+#include "MdFb.hpp"
+
+// C includes.
+#include <stdint.h>
+
+namespace LibGens {
+
+class CapturePrivate;
+
+/**
+ * WAV/VGM/video capture.
+ *
+ * The emulation thread only copies each frame's audio segment
+ * and visible framebuffer area into preallocated buffers, and
+ * queues sound chip register writes as they happen. All file
+ * I/O and format conversion is done by a writer thread.
+ * If the writer thread falls behind, data is dropped instead
+ * of stalling emulation; see droppedCount() and setWaitForWriter().
+ *
+ * Output formats:
+ * - WAV: 16-bit stereo PCM at the segment buffer rate.
+ * - VGM: Version 1.71. YM2612 DAC writes are stored in a
+ *   PCM data block and played back with commands 0x80-0x8F.
+ * - Video: Raw RGB24 or YUV4MPEG2 (4:4:4). If the filename
+ *   starts with '|', the rest of it is run as a command, and
+ *   the video is written to its standard input. This can be
+ *   used to pipe the video to an external encoder.
+ *
+ * Only one Capture object may be active at a time, since
+ * the sound chip write hooks are global.
+ */
+class Capture
+{
+	public:
+		Capture();
+		~Capture();
+
+	private:
+		friend class CapturePrivate;
+		CapturePrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		Capture(const Capture &);
+		Capture &operator=(const Capture &);
+
+	public:
+		// Video formats.
+		enum VideoFormat {
+			VIDEO_RAW_RGB24 = 0,	// Raw RGB24, no header.
+			VIDEO_Y4M,		// YUV4MPEG2, 4:4:4, BT.601.
+
+			VIDEO_MAX
+		};
+
+		/**
+		 * Get the name of a video format.
+		 * @param format Video format.
+		 * @return Name, e.g. "raw", or nullptr if invalid.
+		 */
+		static const char *VideoFormatName(VideoFormat format);
+
+		/**
+		 * Look up a video format by name.
+		 * @param name Name, e.g. "raw".
+		 * @return Video format, or VIDEO_MAX if not found.
+		 */
+		static VideoFormat VideoFormatFromName(const char *name);
+
+		/**
+		 * Start capturing.
+		 * Filenames may be nullptr to skip that output,
+		 * but at least one filename must be specified.
+		 *
+		 * This must be called from the emulation thread,
+		 * or while emulation isn't running, since the
+		 * current sound chip registers are written to
+		 * the start of the VGM.
+		 *
+		 * @param wavFile WAV filename.
+		 * @param vgmFile VGM filename.
+		 * @param videoFile Video filename, or "|command".
+		 * @param videoFormat Video format.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int start(const char *wavFile, const char *vgmFile,
+			  const char *videoFile, VideoFormat videoFormat = VIDEO_RAW_RGB24);
+
+		/**
+		 * Stop capturing.
+		 * Waits for the writer thread to finish writing
+		 * all queued data, then closes the files.
+		 * @return 0 on success; negative POSIX error code
+		 * if any write failed while capturing.
+		 */
+		int stop(void);
+
+		/**
+		 * Set whether the emulation thread should wait for the
+		 * writer thread instead of dropping data if it falls behind.
+		 * This is useful if emulation runs faster than realtime,
+		 * e.g. for offline rendering. (Default is false.)
+		 * @param waitForWriter True to wait; false to drop data.
+		 */
+		void setWaitForWriter(bool waitForWriter);
+
+		/**
+		 * Is capture active?
+		 * @return True if active; false if not.
+		 */
+		bool isActive(void) const;
+
+		/**
+		 * Get the number of frames captured so far.
+		 * @return Number of frames.
+		 */
+		uint32_t frameCount(void) const;
+
+		/**
+		 * Get the number of audio blocks, video frames,
+		 * and register writes that were dropped because
+		 * the writer thread fell behind.
+		 * @return Number of dropped items.
+		 */
+		uint32_t droppedCount(void) const;
+
+		/**
+		 * Capture the current frame.
+		 * This must be called after the frame is run
+		 * and before the audio is written to the output buffer.
+		 * @param fb MD framebuffer.
+		 */
+		void frame(const MdFb *fb);
+};
+
+}
+
+#endif /* __LIBGENS_UTIL_CAPTURE_HPP__ */
@@ -0,0 +1,242 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * FrameJitter.cpp: Frame-time jitter statistics.                          *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "FrameJitter.hpp"
+
+// C includes. (C++ namespace)
+#include <cmath>
+#include <cstring>
+
+namespace LibGens {
+
+class FrameJitterPrivate
+{
+	public:
+		FrameJitterPrivate();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		FrameJitterPrivate(const FrameJitterPrivate &);
+		FrameJitterPrivate &operator=(const FrameJitterPrivate &);
+
+	public:
+		void reset(void);
+
+		/**
+		 * Get a percentile from the histogram.
+		 * @param pct Percentile. (0-100)
+		 * @return Interval, in microseconds.
+		 */
+		uint64_t percentile(unsigned int pct) const;
+
+		unsigned int target;	// Target interval. (usec)
+
+		uint64_t last;		// Timestamp of the previous frame.
+		bool hasLast;		// Is last valid?
+
+		// Running statistics. (Welford's algorithm)
+		unsigned int count;
+		double mean;
+		double m2;
+		double sumAbsDev;
+		uint64_t min;
+		uint64_t max;
+		unsigned int late;
+
+		// Interval histogram.
+		uint32_t hist[FrameJitter::BUCKETS];
+};
+
+FrameJitterPrivate::FrameJitterPrivate()
+	: target(1000000 / 60)
+{
+	reset();
+}
+
+void FrameJitterPrivate::reset(void)
+{
+	last = 0;
+	hasLast = false;
+	count = 0;
+	mean = 0.0;
+	m2 = 0.0;
+	sumAbsDev = 0.0;
+	min = 0;
+	max = 0;
+	late = 0;
+	memset(hist, 0, sizeof(hist));
+}
+
+/**
+ * Get a percentile from the histogram.
+ * @param pct Percentile. (0-100)
+ * @return Interval, in microseconds.
+ */
+uint64_t FrameJitterPrivate::percentile(unsigned int pct) const
+{
+	if (count == 0)
+		return 0;
+
+	// Number of intervals at or below the percentile. (rounded up)
+	const uint64_t rank = (((uint64_t)count * pct) + 99) / 100;
+	uint64_t seen = 0;
+	unsigned int i;
+	for (i = 0; i < FrameJitter::BUCKETS - 1; i++) {
+		seen += hist[i];
+		if (seen >= rank)
+			break;
+	}
+
+	// Use the middle of the bucket, but don't go
+	// outside of the actual range of intervals.
+	uint64_t ret = ((uint64_t)i * FrameJitter::BUCKET_USEC) + (FrameJitter::BUCKET_USEC / 2);
+	if (ret < min)
+		ret = min;
+	else if (ret > max)
+		ret = max;
+	return ret;
+}
+
+/** FrameJitter **/
+
+FrameJitter::FrameJitter()
+	: d(new FrameJitterPrivate())
+{ }
+
+FrameJitter::~FrameJitter()
+{
+	delete d;
+}
+
+/**
+ * Clear all recorded frames.
+ * The target interval is not changed.
+ */
+void FrameJitter::reset(void)
+{
+	d->reset();
+}
+
+/**
+ * Set the target frame interval.
+ * This also clears all recorded frames.
+ * @param usec Target frame interval, in microseconds.
+ */
+void FrameJitter::setTargetInterval(unsigned int usec)
+{
+	d->target = usec;
+	d->reset();
+}
+
+/**
+ * Get the target frame interval.
+ * @return Target frame interval, in microseconds.
+ */
+unsigned int FrameJitter::targetInterval(void) const
+{
+	return d->target;
+}
+
+/**
+ * Record a frame.
+ * The first frame after reset() only sets the base time.
+ * @param usec Frame timestamp, in microseconds. (monotonic)
+ */
+void FrameJitter::addFrame(uint64_t usec)
+{
+	if (!d->hasLast || usec < d->last) {
+		// First frame, or the clock went backwards.
+		d->last = usec;
+		d->hasLast = true;
+		return;
+	}
+
+	const uint64_t interval = usec - d->last;
+	d->last = usec;
+
+	d->count++;
+	const double x = (double)interval;
+	const double delta = x - d->mean;
+	d->mean += delta / d->count;
+	d->m2 += delta * (x - d->mean);
+	d->sumAbsDev += fabs(x - (double)d->target);
+
+	if (d->count == 1 || interval < d->min)
+		d->min = interval;
+	if (interval > d->max)
+		d->max = interval;
+	if (interval * 2 > (uint64_t)d->target * 3)
+		d->late++;
+
+	uint64_t bucket = interval / BUCKET_USEC;
+	if (bucket >= BUCKETS)
+		bucket = BUCKETS - 1;
+	d->hist[bucket]++;
+}
+
+/**
+ * Skip the interval to the next frame, e.g. after unpausing.
+ * The next addFrame() only sets the base time.
+ */
+void FrameJitter::skipFrame(void)
+{
+	d->hasLast = false;
+}
+
+/**
+ * Get the jitter statistics.
+ * @param stats [out] Statistics.
+ */
+void FrameJitter::getStats(Stats *stats) const
+{
+	stats->intervals = d->count;
+	stats->target = d->target;
+	stats->mean = d->mean;
+	stats->stddev = (d->count > 1 ? sqrt(d->m2 / (d->count - 1)) : 0.0);
+	stats->min = d->min;
+	stats->max = d->max;
+	stats->p50 = d->percentile(50);
+	stats->p99 = d->percentile(99);
+	stats->meanAbsDev = (d->count > 0 ? (d->sumAbsDev / d->count) : 0.0);
+	stats->late = d->late;
+}
+
+/**
+ * Print a one-line jitter report.
+ * @param f File to print to.
+ * @param label Label for the report, e.g. the active settings.
+ */
+void FrameJitter::printReport(FILE *f, const char *label) const
+{
+	Stats stats;
+	getStats(&stats);
+	fprintf(f, "Frame jitter [%s]: %u frames, target %u us, "
+		"mean %.1f us, stddev %.1f us, |dev| %.1f us, "
+		"min %u us, p50 %u us, p99 %u us, max %u us, %u late\n",
+		label, stats.intervals, stats.target,
+		stats.mean, stats.stddev, stats.meanAbsDev,
+		(unsigned int)stats.min, (unsigned int)stats.p50,
+		(unsigned int)stats.p99, (unsigned int)stats.max,
+		stats.late);
+}
+
+}
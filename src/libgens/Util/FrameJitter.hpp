@@ -0,0 +1,135 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * FrameJitter.hpp: Frame-time jitter statistics.                          *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_UTIL_FRAMEJITTER_HPP__
+#define __LIBGENS_UTIL_FRAMEJITTER_HPP__
+
+// C includes.
+#include <stdint.h>
+
+// C includes. (C++ namespace)
+#include <cstdio>
+
+namespace LibGens {
+
+class FrameJitterPrivate;
+
+/**
+ * Frame-time jitter statistics.
+ *
+ * Records the interval between consecutive frames and
+ * summarizes how far it strays from the target interval.
+ * Used to compare thread placement and scheduling settings.
+ *
+ * NOTE: Not thread-safe. Frames should be added by
+ * the thread that runs the frame loop.
+ */
+class FrameJitter
+{
+	public:
+		FrameJitter();
+		~FrameJitter();
+
+	private:
+		friend class FrameJitterPrivate;
+		FrameJitterPrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		FrameJitter(const FrameJitter &);
+		FrameJitter &operator=(const FrameJitter &);
+
+	public:
+		/**
+		 * Histogram bucket size, in microseconds.
+		 * Percentiles are accurate to within one bucket.
+		 */
+		static const unsigned int BUCKET_USEC = 50;
+
+		/**
+		 * Number of histogram buckets.
+		 * Intervals longer than BUCKET_USEC * BUCKETS
+		 * are counted in the last bucket.
+		 */
+		static const unsigned int BUCKETS = 2000;
+
+		/**
+		 * Clear all recorded frames.
+		 * The target interval is not changed.
+		 */
+		void reset(void);
+
+		/**
+		 * Set the target frame interval.
+		 * This also clears all recorded frames.
+		 * @param usec Target frame interval, in microseconds.
+		 */
+		void setTargetInterval(unsigned int usec);
+
+		/**
+		 * Get the target frame interval.
+		 * @return Target frame interval, in microseconds.
+		 */
+		unsigned int targetInterval(void) const;
+
+		/**
+		 * Record a frame.
+		 * The first frame after reset() only sets the base time.
+		 * @param usec Frame timestamp, in microseconds. (monotonic)
+		 */
+		void addFrame(uint64_t usec);
+
+		/**
+		 * Skip the interval to the next frame, e.g. after unpausing.
+		 * The next addFrame() only sets the base time.
+		 */
+		void skipFrame(void);
+
+		struct Stats {
+			unsigned int intervals;	// Number of frame intervals.
+			unsigned int target;	// Target interval. (usec)
+			double mean;		// Mean interval. (usec)
+			double stddev;		// Standard deviation. (usec)
+			uint64_t min;		// Shortest interval. (usec)
+			uint64_t max;		// Longest interval. (usec)
+			uint64_t p50;		// Median interval. (usec)
+			uint64_t p99;		// 99th percentile. (usec)
+			double meanAbsDev;	// Mean absolute deviation from target. (usec)
+			unsigned int late;	// Intervals longer than 1.5x target.
+		};
+
+		/**
+		 * Get the jitter statistics.
+		 * @param stats [out] Statistics.
+		 */
+		void getStats(Stats *stats) const;
+
+		/**
+		 * Print a one-line jitter report.
+		 * @param f File to print to.
+		 * @param label Label for the report, e.g. the active settings.
+		 */
+		void printReport(FILE *f, const char *label) const;
+};
+
+}
+
+#endif /* __LIBGENS_UTIL_FRAMEJITTER_HPP__ */
@@ -0,0 +1,402 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * HashLog.cpp: Per-frame video/audio hash log.                            *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "HashLog.hpp"
+#include "XXHash64.hpp"
+
+// LibGens
+#include "sound/SoundMgr.hpp"
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+// C++ includes.
+#include <vector>
+using std::vector;
+
+namespace LibGens {
+
+/**
+ * HashLog private class.
+ */
+class HashLogPrivate
+{
+	public:
+		HashLogPrivate();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		HashLogPrivate(const HashLogPrivate &);
+		HashLogPrivate &operator=(const HashLogPrivate &);
+
+	public:
+		static const uint8_t MAGIC[8];
+		static const uint32_t VERSION = 1;
+		static const size_t HEADER_SIZE = 16;
+		static const size_t RECORD_SIZE = 16;
+
+		// Write buffered data once this much has accumulated.
+		static const size_t FLUSH_SIZE = 64 * 1024;
+
+		FILE *file;
+		vector<uint8_t> buf;
+		uint32_t frameCount;
+		int writeErr;
+
+		void putU64(uint64_t val);
+		static uint64_t getU64(const uint8_t *p);
+
+		/**
+		 * Write the buffered data to the file.
+		 */
+		void flushBuf(void);
+
+		/**
+		 * Load a hash log.
+		 * @param filename Log filename.
+		 * @param data [out] Log data.
+		 * @return 0 on success; -EBADMSG if the file isn't a hash log;
+		 * other negative POSIX error code on error.
+		 */
+		static int load(const char *filename, vector<uint8_t> *data);
+};
+
+const uint8_t HashLogPrivate::MAGIC[8] = {'G','E','N','S','H','S','H',0x1A};
+
+HashLogPrivate::HashLogPrivate()
+	: file(nullptr)
+	, frameCount(0)
+	, writeErr(0)
+{ }
+
+void HashLogPrivate::putU64(uint64_t val)
+{
+	for (int i = 0; i < 8; i++) {
+		buf.push_back((uint8_t)val);
+		val >>= 8;
+	}
+}
+
+uint64_t HashLogPrivate::getU64(const uint8_t *p)
+{
+	uint64_t val = 0;
+	for (int i = 7; i >= 0; i--) {
+		val = (val << 8) | p[i];
+	}
+	return val;
+}
+
+/**
+ * Write the buffered data to the file.
+ */
+void HashLogPrivate::flushBuf(void)
+{
+	if (!buf.empty() && writeErr == 0) {
+		size_t size = fwrite(&buf[0], 1, buf.size(), file);
+		if (size != buf.size()) {
+			writeErr = (errno != 0 ? -errno : -EIO);
+		}
+	}
+	buf.clear();
+}
+
+/**
+ * Load a hash log.
+ * @param filename Log filename.
+ * @param data [out] Log data.
+ * @return 0 on success; -EBADMSG if the file isn't a hash log;
+ * other negative POSIX error code on error.
+ */
+int HashLogPrivate::load(const char *filename, vector<uint8_t> *data)
+{
+	FILE *f = fopen(filename, "rb");
+	if (!f)
+		return (errno != 0 ? -errno : -EIO);
+
+	data->clear();
+	uint8_t block[16384];
+	size_t size;
+	while ((size = fread(block, 1, sizeof(block), f)) > 0) {
+		data->insert(data->end(), block, block + size);
+	}
+	int ret = (ferror(f) ? -EIO : 0);
+	fclose(f);
+	if (ret != 0)
+		return ret;
+
+	if (data->size() < HEADER_SIZE ||
+	    memcmp(&(*data)[0], MAGIC, sizeof(MAGIC)) != 0 ||
+	    (*data)[8] != VERSION || (*data)[9] != 0 ||
+	    (*data)[10] != 0 || (*data)[11] != 0)
+	{
+		return -EBADMSG;
+	}
+	return 0;
+}
+
+/** HashLog **/
+
+HashLog::HashLog()
+	: d(new HashLogPrivate())
+{ }
+
+HashLog::~HashLog()
+{
+	close();
+	delete d;
+}
+
+/**
+ * Hash the visible area of a framebuffer.
+ * Only the area specified by imgXStart(), imgYStart(),
+ * imgWidth(), and imgHeight() is hashed.
+ * @param fb MD framebuffer.
+ * @return Hash.
+ */
+uint64_t HashLog::HashFb(const MdFb *fb)
+{
+	const MdFb::ColorDepth bpp = fb->bpp();
+	const int bytesPerPx = (bpp == MdFb::BPP_32 ? 4 : 2);
+	const size_t lineSize = (size_t)fb->imgWidth() * bytesPerPx;
+	const int xStart = fb->imgXStart();
+	const int yStart = fb->imgYStart();
+	const int yEnd = yStart + fb->imgHeight();
+
+	// Seed with the color depth so logs from different
+	// color depths never match by accident.
+	XXHash64 hash((uint64_t)bpp);
+	if (bpp == MdFb::BPP_32) {
+		for (int y = yStart; y < yEnd; y++) {
+			hash.update(fb->lineBuf32(y) + xStart, lineSize);
+		}
+	} else {
+		for (int y = yStart; y < yEnd; y++) {
+			hash.update(fb->lineBuf16(y) + xStart, lineSize);
+		}
+	}
+	return hash.digest();
+}
+
+/**
+ * Hash the current frame's audio segment.
+ * This must be called after the frame is run
+ * and before the audio is written to the output buffer.
+ * @return Hash.
+ */
+uint64_t HashLog::HashAudio(void)
+{
+	const size_t len = SoundMgr::GetSegLength() * sizeof(SoundMgr::ms_SegBufL[0]);
+	XXHash64 hash;
+	hash.update(SoundMgr::ms_SegBufL, len);
+	hash.update(SoundMgr::ms_SegBufR, len);
+	return hash.digest();
+}
+
+/**
+ * Create a hash log.
+ * Any log that is currently open is closed first.
+ * @param filename Log filename.
+ * @param bpp Color depth of the framebuffer that will be hashed.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int HashLog::create(const char *filename, MdFb::ColorDepth bpp)
+{
+	close();
+
+	d->file = fopen(filename, "wb");
+	if (!d->file)
+		return (errno != 0 ? -errno : -EIO);
+	// Data is written in large blocks, so stdio buffering isn't needed.
+	setvbuf(d->file, nullptr, _IONBF, 0);
+
+	d->frameCount = 0;
+	d->writeErr = 0;
+
+	// Header.
+	d->buf.clear();
+	d->buf.reserve(HashLogPrivate::FLUSH_SIZE + HashLogPrivate::RECORD_SIZE);
+	d->buf.insert(d->buf.end(), HashLogPrivate::MAGIC,
+		HashLogPrivate::MAGIC + sizeof(HashLogPrivate::MAGIC));
+	d->buf.push_back(HashLogPrivate::VERSION);
+	d->buf.push_back(0);
+	d->buf.push_back(0);
+	d->buf.push_back(0);
+	d->buf.push_back((uint8_t)MdFb::colorDepthToBpp(bpp));
+	d->buf.push_back(0);
+	d->buf.push_back(0);
+	d->buf.push_back(0);
+	return 0;
+}
+
+/**
+ * Is a hash log open?
+ * @return True if open; false if not.
+ */
+bool HashLog::isOpen(void) const
+{
+	return (d->file != nullptr);
+}
+
+/**
+ * Get the number of frames logged so far.
+ * @return Number of frames.
+ */
+uint32_t HashLog::frameCount(void) const
+{
+	return d->frameCount;
+}
+
+/**
+ * Log the current frame.
+ * This must be called after the frame is run
+ * and before the audio is written to the output buffer.
+ * @param fb MD framebuffer.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int HashLog::frame(const MdFb *fb)
+{
+	return append(HashFb(fb), HashAudio());
+}
+
+/**
+ * Log precomputed hashes for one frame.
+ * @param videoHash Video hash.
+ * @param audioHash Audio hash.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int HashLog::append(uint64_t videoHash, uint64_t audioHash)
+{
+	if (!d->file)
+		return -EBADF;
+
+	d->putU64(videoHash);
+	d->putU64(audioHash);
+	d->frameCount++;
+	if (d->buf.size() >= HashLogPrivate::FLUSH_SIZE)
+		d->flushBuf();
+	return d->writeErr;
+}
+
+/**
+ * Close the hash log.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int HashLog::close(void)
+{
+	if (!d->file)
+		return 0;
+
+	d->flushBuf();
+	if (fclose(d->file) != 0 && d->writeErr == 0) {
+		d->writeErr = (errno != 0 ? -errno : -EIO);
+	}
+	d->file = nullptr;
+
+	int ret = d->writeErr;
+	d->writeErr = 0;
+	vector<uint8_t>().swap(d->buf);
+	return ret;
+}
+
+/**
+ * Compare a hash log to a golden log.
+ * @param filename Log filename.
+ * @param golden Golden log filename.
+ * @param div [out, opt] First divergence. Zeroed if the logs match.
+ * @return 0 if the logs match; 1 if they diverge;
+ * negative POSIX error code on error.
+ */
+int HashLog::Compare(const char *filename, const char *golden, Divergence *div)
+{
+	vector<uint8_t> data[2];
+	int ret = HashLogPrivate::load(filename, &data[0]);
+	if (ret != 0)
+		return ret;
+	ret = HashLogPrivate::load(golden, &data[1]);
+	if (ret != 0)
+		return ret;
+
+	Divergence tmp;
+	if (!div)
+		div = &tmp;
+	memset(div, 0, sizeof(*div));
+
+	if (data[0][12] != data[1][12]) {
+		// Different color depths.
+		div->subsystems = SUB_FORMAT;
+		return 1;
+	}
+
+	// A partial record at the end is ignored.
+	const size_t hsz = HashLogPrivate::HEADER_SIZE;
+	const size_t rsz = HashLogPrivate::RECORD_SIZE;
+	const size_t frames0 = (data[0].size() - hsz) / rsz;
+	const size_t frames1 = (data[1].size() - hsz) / rsz;
+	const size_t frames = (frames0 < frames1 ? frames0 : frames1);
+
+	const uint8_t *p0 = &data[0][hsz];
+	const uint8_t *p1 = &data[1][hsz];
+	for (size_t i = 0; i < frames; i++, p0 += rsz, p1 += rsz) {
+		if (memcmp(p0, p1, rsz) == 0)
+			continue;
+
+		div->frame = (uint32_t)i;
+		div->video[0] = HashLogPrivate::getU64(p0);
+		div->video[1] = HashLogPrivate::getU64(p1);
+		div->audio[0] = HashLogPrivate::getU64(p0 + 8);
+		div->audio[1] = HashLogPrivate::getU64(p1 + 8);
+		if (div->video[0] != div->video[1])
+			div->subsystems |= SUB_VIDEO;
+		if (div->audio[0] != div->audio[1])
+			div->subsystems |= SUB_AUDIO;
+		return 1;
+	}
+
+	if (frames0 != frames1) {
+		div->frame = (uint32_t)frames;
+		div->subsystems = SUB_LENGTH;
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Get a description of a divergence's subsystems.
+ * @param subsystems Subsystem bitfield.
+ * @return Description, e.g. "video+audio".
+ */
+const char *HashLog::SubsystemName(uint32_t subsystems)
+{
+	static const char *const names[16] = {
+		"none", "video", "audio", "video+audio",
+		"length", "video+length", "audio+length", "video+audio+length",
+		"format", "video+format", "audio+format", "video+audio+format",
+		"length+format", "video+length+format", "audio+length+format",
+		"video+audio+length+format",
+	};
+	return names[subsystems & 0xF];
+}
+
+}
@@ -0,0 +1,172 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * HashLog.hpp: Per-frame video/audio hash log.                            *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_UTIL_HASHLOG_HPP__
+#define __LIBGENS_UTIL_HASHLOG_HPP__
+
+#include "MdFb.hpp"
+
+// C includes.
+#include <stdint.h>
+
+namespace LibGens {
+
+class HashLogPrivate;
+
+/**
+ * Per-frame video/audio hash log.
+ *
+ * Records a 64-bit xxHash of each frame's visible framebuffer area
+ * and of each frame's audio segment, for regression testing.
+ * Logs from two runs can be compared to find the first frame
+ * where emulation diverged.
+ *
+ * Hashes are computed over the in-memory pixel and sample data,
+ * so logs are only comparable between runs that use the same
+ * color depth on hosts with the same byte order.
+ *
+ * File format: (all multi-byte values are little-endian)
+ * - Header:
+ *   - char magic[8]: "GENSHSH\x1A"
+ *   - uint32_t version: 1
+ *   - uint8_t bpp: Color depth, in bits per pixel. (15, 16, 32)
+ *   - uint8_t reserved[3]
+ * - Records: One per frame.
+ *   - uint64_t videoHash
+ *   - uint64_t audioHash
+ *
+ * The frame count isn't stored in the header, so a log
+ * is still usable if the emulator exits abnormally.
+ */
+class HashLog
+{
+	public:
+		HashLog();
+		~HashLog();
+
+	private:
+		friend class HashLogPrivate;
+		HashLogPrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		HashLog(const HashLog &);
+		HashLog &operator=(const HashLog &);
+
+	public:
+		/**
+		 * Hash the visible area of a framebuffer.
+		 * Only the area specified by imgXStart(), imgYStart(),
+		 * imgWidth(), and imgHeight() is hashed.
+		 * @param fb MD framebuffer.
+		 * @return Hash.
+		 */
+		static uint64_t HashFb(const MdFb *fb);
+
+		/**
+		 * Hash the current frame's audio segment.
+		 * This must be called after the frame is run
+		 * and before the audio is written to the output buffer.
+		 * @return Hash.
+		 */
+		static uint64_t HashAudio(void);
+
+		/**
+		 * Create a hash log.
+		 * Any log that is currently open is closed first.
+		 * @param filename Log filename.
+		 * @param bpp Color depth of the framebuffer that will be hashed.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int create(const char *filename, MdFb::ColorDepth bpp);
+
+		/**
+		 * Is a hash log open?
+		 * @return True if open; false if not.
+		 */
+		bool isOpen(void) const;
+
+		/**
+		 * Get the number of frames logged so far.
+		 * @return Number of frames.
+		 */
+		uint32_t frameCount(void) const;
+
+		/**
+		 * Log the current frame.
+		 * This must be called after the frame is run
+		 * and before the audio is written to the output buffer.
+		 * @param fb MD framebuffer.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int frame(const MdFb *fb);
+
+		/**
+		 * Log precomputed hashes for one frame.
+		 * @param videoHash Video hash.
+		 * @param audioHash Audio hash.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int append(uint64_t videoHash, uint64_t audioHash);
+
+		/**
+		 * Close the hash log.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int close(void);
+
+	public:
+		// Divergent subsystems.
+		enum Subsystem {
+			SUB_VIDEO	= (1 << 0),	// Video hash differs.
+			SUB_AUDIO	= (1 << 1),	// Audio hash differs.
+			SUB_LENGTH	= (1 << 2),	// One log ended early.
+			SUB_FORMAT	= (1 << 3),	// Color depth differs.
+		};
+
+		struct Divergence {
+			uint32_t frame;		// First divergent frame.
+			uint32_t subsystems;	// Subsystem bitfield.
+			uint64_t video[2];	// Video hashes. (log, golden)
+			uint64_t audio[2];	// Audio hashes. (log, golden)
+		};
+
+		/**
+		 * Compare a hash log to a golden log.
+		 * @param filename Log filename.
+		 * @param golden Golden log filename.
+		 * @param div [out, opt] First divergence. Zeroed if the logs match.
+		 * @return 0 if the logs match; 1 if they diverge;
+		 * negative POSIX error code on error.
+		 */
+		static int Compare(const char *filename, const char *golden, Divergence *div);
+
+		/**
+		 * Get a description of a divergence's subsystems.
+		 * @param subsystems Subsystem bitfield.
+		 * @return Description, e.g. "video+audio".
+		 */
+		static const char *SubsystemName(uint32_t subsystems);
+};
+
+}
+
+#endif /* __LIBGENS_UTIL_HASHLOG_HPP__ */
@@ -86,6 +86,27 @@ void MdFb::reinitFb(void) {
 	}
 }
 
+/**
+ * Copy the image and image parameters from another framebuffer.
+ * Both framebuffers must have the same dimensions.
+ * @param src Source framebuffer.
+ */
+void MdFb::copyFrom(const MdFb *src)
+{
+	assert(src->m_pxPitch == m_pxPitch);
+	assert(src->m_numLines == m_numLines);
+	assert(src->m_fb_sz == m_fb_sz);
+	if (src == this)
+		return;
+
+	memcpy(m_fb, src->m_fb, m_fb_sz);
+	m_bpp = src->m_bpp;
+	m_imgWidth = src->m_imgWidth;
+	m_imgHeight = src->m_imgHeight;
+	m_imgXStart = src->m_imgXStart;
+	m_imgYStart = src->m_imgYStart;
+}
+
 /** Convenience functions. **/
 
 /**
@@ -54,6 +54,13 @@ class MdFb
 		// Clear the screen.
 		void clear(void);
 
+		/**
+		 * Copy the image and image parameters from another framebuffer.
+		 * Both framebuffers must have the same dimensions.
+		 * @param src Source framebuffer.
+		 */
+		void copyFrom(const MdFb *src);
+
 		// Color depth.
 		enum ColorDepth {
 			// RGB color modes.
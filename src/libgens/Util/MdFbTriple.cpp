@@ -0,0 +1,105 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * MdFbTriple.cpp: Lock-free triple-buffered MdFb set.                     *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "MdFbTriple.hpp"
+#include "MdFb.hpp"
+
+// Atomic operations.
+#include "libcompat/atomic.h"
+
+namespace LibGens {
+
+MdFbTriple::MdFbTriple()
+	: m_ready(1)
+	, m_back(0)
+	, m_front(2)
+	, m_dropped(0)
+{
+	for (int i = 0; i < 3; i++) {
+		m_fb[i] = new MdFb();
+	}
+}
+
+MdFbTriple::~MdFbTriple()
+{
+	for (int i = 0; i < 3; i++) {
+		m_fb[i]->unref();
+	}
+}
+
+/**
+ * Publish the back buffer.
+ * If the consumer hasn't picked up the previously
+ * published frame, that frame is dropped.
+ */
+void MdFbTriple::publish(void)
+{
+	// Swap the back buffer with the ready buffer.
+	// The release half of the exchange makes the back buffer's
+	// contents visible to the consumer before the index is.
+	const uint32_t prev = ATOMIC_EXCHANGE(&m_ready, m_back | READY_FRESH);
+	if (prev & READY_FRESH) {
+		// The consumer never saw the previous frame.
+		ATOMIC_ADD_FETCH(&m_dropped, 1);
+	}
+	m_back = (prev & READY_IDX_MASK);
+}
+
+/**
+ * Copy a framebuffer into the back buffer and publish it.
+ * @param src Source framebuffer.
+ */
+void MdFbTriple::publish(const MdFb *src)
+{
+	m_fb[m_back]->copyFrom(src);
+	publish();
+}
+
+/**
+ * Get the number of published frames that were
+ * replaced before the consumer picked them up.
+ * @return Number of dropped frames.
+ */
+unsigned int MdFbTriple::droppedFrames(void) const
+{
+	return ATOMIC_LOAD_ACQUIRE(&m_dropped);
+}
+
+/**
+ * Pick up the most recently published frame, if any.
+ * @return True if a new frame is available in frontFb(); false if not.
+ */
+bool MdFbTriple::acquire(void)
+{
+	if (!(ATOMIC_LOAD_ACQUIRE(&m_ready) & READY_FRESH)) {
+		// No new frame.
+		return false;
+	}
+
+	// Swap the front buffer with the ready buffer.
+	// The producer can only set READY_FRESH, not clear it,
+	// so the frame we just checked for is still there.
+	const uint32_t prev = ATOMIC_EXCHANGE(&m_ready, m_front);
+	m_front = (prev & READY_IDX_MASK);
+	return true;
+}
+
+}
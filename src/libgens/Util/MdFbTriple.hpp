@@ -0,0 +1,143 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * MdFbTriple.hpp: Lock-free triple-buffered MdFb set.                     *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_UTIL_MDFBTRIPLE_HPP__
+#define __LIBGENS_UTIL_MDFBTRIPLE_HPP__
+
+// C includes.
+#include <stdint.h>
+
+namespace LibGens {
+
+class MdFb;
+
+/**
+ * Triple-buffered MdFb set.
+ *
+ * Used to pass completed frames from the emulation thread
+ * (producer) to the UI thread (consumer) without locking.
+ * Neither side ever waits for the other: the producer always
+ * has a back buffer to write to, and the consumer always has
+ * the most recently published frame.
+ *
+ * NOTE: Only one producer thread and one consumer thread
+ * are supported.
+ */
+class MdFbTriple
+{
+	public:
+		MdFbTriple();
+		~MdFbTriple();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		MdFbTriple(const MdFbTriple &);
+		MdFbTriple &operator=(const MdFbTriple &);
+
+	public:
+		/** Producer functions. **/
+
+		/**
+		 * Get the back buffer.
+		 * The producer can write to this buffer
+		 * until the next call to publish().
+		 * @return Back buffer.
+		 */
+		MdFb *backFb(void);
+
+		/**
+		 * Publish the back buffer.
+		 * If the consumer hasn't picked up the previously
+		 * published frame, that frame is dropped.
+		 */
+		void publish(void);
+
+		/**
+		 * Copy a framebuffer into the back buffer and publish it.
+		 * @param src Source framebuffer.
+		 */
+		void publish(const MdFb *src);
+
+		/**
+		 * Get the number of published frames that were
+		 * replaced before the consumer picked them up.
+		 * @return Number of dropped frames.
+		 */
+		unsigned int droppedFrames(void) const;
+
+		/** Consumer functions. **/
+
+		/**
+		 * Pick up the most recently published frame, if any.
+		 * @return True if a new frame is available in frontFb(); false if not.
+		 */
+		bool acquire(void);
+
+		/**
+		 * Get the front buffer.
+		 * This is the frame picked up by the last call to acquire(),
+		 * and it remains valid until the next call to acquire().
+		 * @return Front buffer.
+		 */
+		const MdFb *frontFb(void) const;
+
+	private:
+		MdFb *m_fb[3];
+
+		/**
+		 * Ready buffer index, plus READY_FRESH if it
+		 * hasn't been picked up by the consumer yet.
+		 * Shared between the producer and consumer.
+		 */
+		uint32_t m_ready;
+		static const uint32_t READY_IDX_MASK = 0x3;
+		static const uint32_t READY_FRESH = 0x4;
+
+		// Buffer indexes owned by the producer and consumer.
+		uint32_t m_back;
+		uint32_t m_front;
+
+		// Dropped frame counter.
+		uint32_t m_dropped;
+};
+
+/**
+ * Get the back buffer.
+ * The producer can write to this buffer
+ * until the next call to publish().
+ * @return Back buffer.
+ */
+inline MdFb *MdFbTriple::backFb(void)
+	{ return m_fb[m_back]; }
+
+/**
+ * Get the front buffer.
+ * This is the frame picked up by the last call to acquire(),
+ * and it remains valid until the next call to acquire().
+ * @return Front buffer.
+ */
+inline const MdFb *MdFbTriple::frontFb(void) const
+	{ return m_fb[m_front]; }
+
+}
+
+#endif /* __LIBGENS_UTIL_MDFBTRIPLE_HPP__ */
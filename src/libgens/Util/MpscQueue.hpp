@@ -0,0 +1,170 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * MpscQueue.hpp: Bounded lock-free multi-producer single-consumer queue.  *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_UTIL_MPSCQUEUE_HPP__
+#define __LIBGENS_UTIL_MPSCQUEUE_HPP__
+
+// C includes.
+#include <stdint.h>
+
+// Atomic operations.
+#include "libcompat/atomic.h"
+
+namespace LibGens {
+
+/**
+ * Bounded lock-free multi-producer single-consumer queue.
+ *
+ * Each cell has a sequence number that tells producers
+ * and the consumer whose turn it is to use the cell.
+ * Producers claim a position with a compare-and-swap;
+ * the consumer doesn't need any read-modify-write ops.
+ *
+ * Reference: Dmitry Vyukov's bounded MPMC queue.
+ * - http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ *
+ * @param T Item type. Must be copyable.
+ * @param N Number of cells. Must be a power of two.
+ */
+template<typename T, unsigned int N>
+class MpscQueue
+{
+	static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two.");
+
+	public:
+		MpscQueue();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		MpscQueue(const MpscQueue &);
+		MpscQueue &operator=(const MpscQueue &);
+
+	public:
+		/**
+		 * Push an item onto the queue.
+		 * This can be called from any thread.
+		 * @param item Item.
+		 * @return True on success; false if the queue is full.
+		 */
+		bool push(const T &item);
+
+		/**
+		 * Pop an item from the queue.
+		 * This must only be called from the consumer thread.
+		 * @param item [out] Item.
+		 * @return True on success; false if the queue is empty.
+		 */
+		bool pop(T *item);
+
+		/**
+		 * Get the queue capacity.
+		 * @return Queue capacity.
+		 */
+		static inline unsigned int capacity(void)
+			{ return N; }
+
+	private:
+		struct Cell {
+			uint32_t seq;
+			T data;
+		};
+		Cell m_cells[N];
+
+		// Next position to push to. (Shared by producers.)
+		uint32_t m_pushPos;
+		// Next position to pop from. (Consumer only.)
+		uint32_t m_popPos;
+};
+
+template<typename T, unsigned int N>
+MpscQueue<T, N>::MpscQueue()
+	: m_pushPos(0)
+	, m_popPos(0)
+{
+	for (unsigned int i = 0; i < N; i++) {
+		m_cells[i].seq = i;
+	}
+}
+
+/**
+ * Push an item onto the queue.
+ * This can be called from any thread.
+ * @param item Item.
+ * @return True on success; false if the queue is full.
+ */
+template<typename T, unsigned int N>
+bool MpscQueue<T, N>::push(const T &item)
+{
+	Cell *cell;
+	uint32_t pos = ATOMIC_LOAD_ACQUIRE(&m_pushPos);
+	for (;;) {
+		cell = &m_cells[pos & (N - 1)];
+		const uint32_t seq = ATOMIC_LOAD_ACQUIRE(&cell->seq);
+		const int32_t diff = (int32_t)(seq - pos);
+		if (diff == 0) {
+			// Cell is free. Try to claim it.
+			if (ATOMIC_CMPXCHG(&m_pushPos, pos, pos + 1))
+				break;
+		} else if (diff < 0) {
+			// The consumer hasn't freed this cell yet.
+			// Queue is full.
+			return false;
+		}
+
+		// Another producer got here first.
+		pos = ATOMIC_LOAD_ACQUIRE(&m_pushPos);
+	}
+
+	// Fill in the cell and hand it to the consumer.
+	cell->data = item;
+	ATOMIC_STORE_RELEASE(&cell->seq, pos + 1);
+	return true;
+}
+
+/**
+ * Pop an item from the queue.
+ * This must only be called from the consumer thread.
+ * @param item [out] Item.
+ * @return True on success; false if the queue is empty.
+ */
+template<typename T, unsigned int N>
+bool MpscQueue<T, N>::pop(T *item)
+{
+	const uint32_t pos = m_popPos;
+	Cell *const cell = &m_cells[pos & (N - 1)];
+	const uint32_t seq = ATOMIC_LOAD_ACQUIRE(&cell->seq);
+	if (seq != pos + 1) {
+		// Queue is empty, or the producer that
+		// claimed this cell hasn't filled it in yet.
+		return false;
+	}
+
+	// Take the item and hand the cell back to the producers.
+	*item = cell->data;
+	ATOMIC_STORE_RELEASE(&cell->seq, pos + N);
+	m_popPos = pos + 1;
+	return true;
+}
+
+}
+
+#endif /* __LIBGENS_UTIL_MPSCQUEUE_HPP__ */
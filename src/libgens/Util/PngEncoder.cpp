@@ -0,0 +1,486 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * PngEncoder.cpp: Multi-threaded PNG encoder.                             *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "PngEncoder.hpp"
+#include "TaskPool.hpp"
+
+// LibZomg
+#include "libzomg/Metadata.hpp"
+#include "libzomg/img_data.h"
+using LibZomg::PngWriter;
+using LibZomg::Metadata;
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstring>
+
+// C++ includes.
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using std::condition_variable;
+using std::deque;
+using std::mutex;
+using std::string;
+using std::thread;
+using std::unique_lock;
+using std::vector;
+
+namespace LibGens {
+
+/**
+ * PngEncoder private class.
+ */
+class PngEncoderPrivate
+{
+	public:
+		PngEncoderPrivate(int threads);
+		~PngEncoderPrivate();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		PngEncoderPrivate(const PngEncoderPrivate &);
+		PngEncoderPrivate &operator=(const PngEncoderPrivate &);
+
+	public:
+		const int threads;
+
+		// Encoding options.
+		int level;
+		PngWriter::FilterMode filterMode;
+		PngWriter::Strategy strategy;
+
+		/**
+		 * Queued job.
+		 */
+		struct Job {
+			Zomg_Img_Data_t img_data;
+			vector<uint8_t> pixels;		// Copy of the image.
+			string filename;
+			Metadata *metadata;
+
+			int level;
+			PngWriter::FilterMode filterMode;
+			PngWriter::Strategy strategy;
+		};
+
+		// Synchronous encoding. (created on first use)
+		TaskPool *taskPool;
+		PngWriter *syncWriter;
+
+		/**
+		 * TaskPool adapter for PngWriter::setTaskRunner().
+		 * @param runnerParam TaskPool.
+		 * @param fn Task function.
+		 * @param param Parameter for fn().
+		 * @param count Number of tasks.
+		 */
+		static void taskPoolRunner(void *runnerParam, PngWriter::TaskFn fn,
+					   void *param, int count);
+
+		// Worker threads. (started on first submit())
+		vector<thread> workers;
+
+		// Protects everything below.
+		mutex mtx;
+		condition_variable cvJob;	// Workers wait for jobs here.
+		condition_variable cvDone;	// submit() and wait() wait here.
+		deque<Job*> queue;
+		int maxQueued;		// submit() blocks if the queue is this long.
+		int pending;		// Jobs queued or in progress.
+		int firstError;		// First error since the last wait().
+		unsigned int written;
+		unsigned int failed;
+		bool quit;
+
+		/**
+		 * Worker thread function.
+		 * @param d PngEncoderPrivate.
+		 */
+		static void workerThread(PngEncoderPrivate *d);
+
+		/**
+		 * Copy an image into a job, optionally scaling it down.
+		 * @param job		[out] Job.
+		 * @param img_data	[in] Source image.
+		 * @param thumbWidth	[in] Thumbnail width. (0 for full size)
+		 */
+		static void copyImage(Job *job, const Zomg_Img_Data_t *img_data, int thumbWidth);
+};
+
+PngEncoderPrivate::PngEncoderPrivate(int threads)
+	: threads(threads)
+	, level(5)
+	, filterMode(PngWriter::FILTER_NONE)
+	, strategy(PngWriter::STRATEGY_DEFAULT)
+	, taskPool(nullptr)
+	, syncWriter(nullptr)
+	, maxQueued(threads * 2)
+	, pending(0)
+	, firstError(0)
+	, written(0)
+	, failed(0)
+	, quit(false)
+{ }
+
+PngEncoderPrivate::~PngEncoderPrivate()
+{
+	{
+		// Finish pending jobs before stopping the workers.
+		unique_lock<mutex> lock(mtx);
+		while (pending > 0) {
+			cvDone.wait(lock);
+		}
+		quit = true;
+	}
+	cvJob.notify_all();
+	for (size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+
+	delete syncWriter;
+	delete taskPool;
+}
+
+/**
+ * TaskPool adapter for PngWriter::setTaskRunner().
+ * @param runnerParam TaskPool.
+ * @param fn Task function.
+ * @param param Parameter for fn().
+ * @param count Number of tasks.
+ */
+void PngEncoderPrivate::taskPoolRunner(void *runnerParam, PngWriter::TaskFn fn,
+				       void *param, int count)
+{
+	static_cast<TaskPool*>(runnerParam)->run(fn, param, count);
+}
+
+/**
+ * Worker thread function.
+ * @param d PngEncoderPrivate.
+ */
+void PngEncoderPrivate::workerThread(PngEncoderPrivate *d)
+{
+	// Each worker has its own PngWriter so its
+	// encoding buffers are reused between images.
+	PngWriter pngWriter;
+
+	unique_lock<mutex> lock(d->mtx);
+	while (true) {
+		while (!d->quit && d->queue.empty()) {
+			d->cvJob.wait(lock);
+		}
+		if (d->queue.empty()) {
+			// Quitting.
+			break;
+		}
+		Job *const job = d->queue.front();
+		d->queue.pop_front();
+		lock.unlock();
+
+		pngWriter.setCompressionLevel(job->level);
+		pngWriter.setFilterMode(job->filterMode);
+		pngWriter.setStrategy(job->strategy);
+		const int ret = pngWriter.writeToFile(&job->img_data, job->filename.c_str(),
+						job->metadata, Metadata::MF_Default);
+		delete job->metadata;
+		delete job;
+
+		lock.lock();
+		if (ret == 0) {
+			d->written++;
+		} else {
+			d->failed++;
+			if (d->firstError == 0)
+				d->firstError = ret;
+		}
+		d->pending--;
+		d->cvDone.notify_all();
+	}
+}
+
+/**
+ * Copy an image into a job, optionally scaling it down.
+ * @param job		[out] Job.
+ * @param img_data	[in] Source image.
+ * @param thumbWidth	[in] Thumbnail width. (0 for full size)
+ */
+void PngEncoderPrivate::copyImage(Job *job, const Zomg_Img_Data_t *img_data, int thumbWidth)
+{
+	const unsigned int w = img_data->w;
+	const unsigned int h = img_data->h;
+	job->img_data = *img_data;
+
+	if (thumbWidth <= 0) {
+		// Full size. Copy the image as-is, without padding.
+		const unsigned int rowBytes = w * (img_data->bpp == 32 ? 4 : 2);
+		job->pixels.resize(rowBytes * h);
+		const uint8_t *src = (const uint8_t*)img_data->data;
+		for (unsigned int y = 0; y < h; y++, src += img_data->pitch) {
+			memcpy(&job->pixels[y * rowBytes], src, rowBytes);
+		}
+		job->img_data.data = job->pixels.data();
+		job->img_data.pitch = rowBytes;
+		return;
+	}
+
+	// Thumbnail. Calculate the height from the display aspect ratio.
+	const unsigned int dw = (unsigned int)thumbWidth;
+	unsigned int dh;
+	if (img_data->phys_x > 0 && img_data->phys_y > 0) {
+		dh = (unsigned int)(((uint64_t)h * dw * img_data->phys_y) /
+				    ((uint64_t)w * img_data->phys_x));
+	} else {
+		dh = (unsigned int)(((uint64_t)h * dw) / w);
+	}
+	if (dh == 0)
+		dh = 1;
+
+	// Scale down using area averaging.
+	// Output is always 32-bit xRGB with square pixels.
+	job->pixels.resize(dw * dh * sizeof(uint32_t));
+	uint32_t *dest = (uint32_t*)job->pixels.data();
+	for (unsigned int dy = 0; dy < dh; dy++) {
+		const unsigned int y0 = (dy * h) / dh;
+		unsigned int y1 = ((dy + 1) * h) / dh;
+		if (y1 <= y0)
+			y1 = y0 + 1;
+
+		for (unsigned int dx = 0; dx < dw; dx++, dest++) {
+			const unsigned int x0 = (dx * w) / dw;
+			unsigned int x1 = ((dx + 1) * w) / dw;
+			if (x1 <= x0)
+				x1 = x0 + 1;
+
+			unsigned int r = 0, g = 0, b = 0;
+			for (unsigned int y = y0; y < y1; y++) {
+				const uint8_t *const row = (const uint8_t*)img_data->data + (y * img_data->pitch);
+				for (unsigned int x = x0; x < x1; x++) {
+					switch (img_data->bpp) {
+						case 15: {
+							const uint16_t px = ((const uint16_t*)row)[x];
+							r += ((px >> 10) & 0x1F) * 255 / 31;
+							g += ((px >> 5) & 0x1F) * 255 / 31;
+							b += (px & 0x1F) * 255 / 31;
+							break;
+						}
+						case 16: {
+							const uint16_t px = ((const uint16_t*)row)[x];
+							r += ((px >> 11) & 0x1F) * 255 / 31;
+							g += ((px >> 5) & 0x3F) * 255 / 63;
+							b += (px & 0x1F) * 255 / 31;
+							break;
+						}
+						case 32:
+						default: {
+							const uint32_t px = ((const uint32_t*)row)[x];
+							r += (px >> 16) & 0xFF;
+							g += (px >> 8) & 0xFF;
+							b += px & 0xFF;
+							break;
+						}
+					}
+				}
+			}
+
+			const unsigned int n = (y1 - y0) * (x1 - x0);
+			*dest = ((r / n) << 16) | ((g / n) << 8) | (b / n);
+		}
+	}
+
+	job->img_data.data = job->pixels.data();
+	job->img_data.w = dw;
+	job->img_data.h = dh;
+	job->img_data.pitch = dw * sizeof(uint32_t);
+	job->img_data.bpp = 32;
+	job->img_data.phys_x = 0;
+	job->img_data.phys_y = 0;
+}
+
+/** PngEncoder **/
+
+/**
+ * Create a PNG encoder.
+ * @param threads Number of threads.
+ * If 0, a default based on the number of CPUs is used.
+ */
+PngEncoder::PngEncoder(int threads)
+	: d(new PngEncoderPrivate(threads <= 0 ? TaskPool::DefaultThreadCount()
+				  : (threads > MAX_THREADS ? MAX_THREADS : threads)))
+{ }
+
+/**
+ * Destroy the PNG encoder.
+ * Pending jobs are finished first.
+ */
+PngEncoder::~PngEncoder()
+{
+	delete d;
+}
+
+/**
+ * Get the number of threads.
+ * @return Number of threads.
+ */
+int PngEncoder::threadCount(void) const
+{
+	return d->threads;
+}
+
+/** Encoding options. **/
+
+int PngEncoder::compressionLevel(void) const
+	{ return d->level; }
+void PngEncoder::setCompressionLevel(int level)
+	{ d->level = (level < 0 ? 0 : (level > 9 ? 9 : level)); }
+PngWriter::FilterMode PngEncoder::filterMode(void) const
+	{ return d->filterMode; }
+void PngEncoder::setFilterMode(PngWriter::FilterMode filterMode)
+{
+	if (filterMode >= PngWriter::FILTER_NONE && filterMode < PngWriter::FILTER_MAX)
+		d->filterMode = filterMode;
+}
+PngWriter::Strategy PngEncoder::strategy(void) const
+	{ return d->strategy; }
+void PngEncoder::setStrategy(PngWriter::Strategy strategy)
+{
+	if (strategy >= PngWriter::STRATEGY_DEFAULT && strategy < PngWriter::STRATEGY_MAX)
+		d->strategy = strategy;
+}
+
+/**
+ * Write an image to a PNG file on the calling thread,
+ * using all threads for row-parallel encoding.
+ * @param img_data	[in] Image data.
+ * @param filename	[in] PNG file.
+ * @param metadata	[in, opt] Extra metadata.
+ * @return 0 on success; negative errno on error.
+ */
+int PngEncoder::writeToFile(const Zomg_Img_Data_t *img_data, const char *filename,
+			    const Metadata *metadata)
+{
+	if (!d->syncWriter) {
+		d->syncWriter = new PngWriter();
+		if (d->threads > 1) {
+			d->taskPool = new TaskPool(d->threads);
+			d->syncWriter->setTaskRunner(PngEncoderPrivate::taskPoolRunner,
+				d->taskPool, d->taskPool->threadCount());
+		}
+	}
+
+	d->syncWriter->setCompressionLevel(d->level);
+	d->syncWriter->setFilterMode(d->filterMode);
+	d->syncWriter->setStrategy(d->strategy);
+	return d->syncWriter->writeToFile(img_data, filename, metadata, Metadata::MF_Default);
+}
+
+/**
+ * Queue an image to be written to a PNG file.
+ * @param img_data	[in] Image data.
+ * @param filename	[in] PNG file.
+ * @param metadata	[in, opt] Extra metadata. (Ownership is transferred to the encoder.)
+ * @param thumbWidth	[in, opt] Thumbnail width. (0 for full size)
+ * @return 0 if queued; negative errno on error.
+ */
+int PngEncoder::submit(const Zomg_Img_Data_t *img_data, const char *filename,
+		       Metadata *metadata, int thumbWidth)
+{
+	if (!img_data || !img_data->data || !filename || !filename[0] ||
+	    img_data->w == 0 || img_data->h == 0 ||
+	    (img_data->bpp != 15 && img_data->bpp != 16 && img_data->bpp != 32) ||
+	    thumbWidth > 16384)
+	{
+		// Invalid parameters.
+		delete metadata;
+		return -EINVAL;
+	}
+
+	// Copy the image on the calling thread.
+	PngEncoderPrivate::Job *const job = new PngEncoderPrivate::Job;
+	PngEncoderPrivate::copyImage(job, img_data, thumbWidth);
+	job->filename = filename;
+	job->metadata = metadata;
+	job->level = d->level;
+	job->filterMode = d->filterMode;
+	job->strategy = d->strategy;
+
+	unique_lock<mutex> lock(d->mtx);
+	if (d->workers.empty()) {
+		// Start the worker threads.
+		d->workers.reserve(d->threads);
+		for (int i = 0; i < d->threads; i++) {
+			d->workers.push_back(thread(PngEncoderPrivate::workerThread, d));
+		}
+	}
+
+	// Limit the queue length so memory usage doesn't
+	// grow unbounded if the caller is faster than us.
+	while ((int)d->queue.size() >= d->maxQueued) {
+		d->cvDone.wait(lock);
+	}
+	d->queue.push_back(job);
+	d->pending++;
+	lock.unlock();
+	d->cvJob.notify_one();
+	return 0;
+}
+
+/**
+ * Wait for all queued jobs to finish.
+ * @return 0 if all jobs since the last wait() succeeded;
+ * otherwise, the first negative errno.
+ */
+int PngEncoder::wait(void)
+{
+	unique_lock<mutex> lock(d->mtx);
+	while (d->pending > 0) {
+		d->cvDone.wait(lock);
+	}
+	const int ret = d->firstError;
+	d->firstError = 0;
+	return ret;
+}
+
+/**
+ * Get the number of images written by queued jobs.
+ * @return Number of images written.
+ */
+unsigned int PngEncoder::writtenCount(void) const
+{
+	unique_lock<mutex> lock(d->mtx);
+	return d->written;
+}
+
+/**
+ * Get the number of queued jobs that failed.
+ * @return Number of failed jobs.
+ */
+unsigned int PngEncoder::failedCount(void) const
+{
+	unique_lock<mutex> lock(d->mtx);
+	return d->failed;
+}
+
+}
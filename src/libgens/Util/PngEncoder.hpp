@@ -0,0 +1,152 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * PngEncoder.hpp: Multi-threaded PNG encoder.                             *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_UTIL_PNGENCODER_HPP__
+#define __LIBGENS_UTIL_PNGENCODER_HPP__
+
+#include "libzomg/PngWriter.hpp"
+
+// Image data struct.
+extern "C" struct _Zomg_Img_Data_t;
+
+namespace LibZomg {
+	class Metadata;
+}
+
+namespace LibGens {
+
+class PngEncoderPrivate;
+
+/**
+ * Multi-threaded PNG encoder.
+ *
+ * writeToFile() encodes a single image on the calling thread,
+ * with row bands filtered and compressed in parallel using a
+ * TaskPool. This reduces latency for one-off screenshots.
+ *
+ * submit() copies the image and queues it for one of the worker
+ * threads, each of which encodes whole images. This has better
+ * throughput when writing many images, e.g. batch thumbnails.
+ * If the queue is full, submit() blocks until a job finishes.
+ *
+ * Encoding options are recorded when an image is submitted,
+ * so they can be changed while jobs are pending.
+ */
+class PngEncoder
+{
+	public:
+		/**
+		 * Create a PNG encoder.
+		 * @param threads Number of threads.
+		 * If 0, a default based on the number of CPUs is used.
+		 */
+		explicit PngEncoder(int threads = 0);
+
+		/**
+		 * Destroy the PNG encoder.
+		 * Pending jobs are finished first.
+		 */
+		~PngEncoder();
+
+	private:
+		friend class PngEncoderPrivate;
+		PngEncoderPrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		PngEncoder(const PngEncoder &);
+		PngEncoder &operator=(const PngEncoder &);
+
+	public:
+		// Maximum number of threads.
+		static const int MAX_THREADS = 16;
+
+		/**
+		 * Get the number of threads.
+		 * @return Number of threads.
+		 */
+		int threadCount(void) const;
+
+		/**
+		 * Encoding options.
+		 * See LibZomg::PngWriter for details.
+		 */
+
+		int compressionLevel(void) const;
+		void setCompressionLevel(int level);
+		LibZomg::PngWriter::FilterMode filterMode(void) const;
+		void setFilterMode(LibZomg::PngWriter::FilterMode filterMode);
+		LibZomg::PngWriter::Strategy strategy(void) const;
+		void setStrategy(LibZomg::PngWriter::Strategy strategy);
+
+		/**
+		 * Write an image to a PNG file on the calling thread,
+		 * using all threads for row-parallel encoding.
+		 * @param img_data	[in] Image data.
+		 * @param filename	[in] PNG file.
+		 * @param metadata	[in, opt] Extra metadata.
+		 * @return 0 on success; negative errno on error.
+		 */
+		int writeToFile(const _Zomg_Img_Data_t *img_data, const char *filename,
+				const LibZomg::Metadata *metadata = nullptr);
+
+		/**
+		 * Queue an image to be written to a PNG file.
+		 * The image data is copied, so it can be reused
+		 * as soon as this function returns.
+		 *
+		 * If thumbWidth is specified, the image is scaled down
+		 * (area averaging) to that width. The height is set to
+		 * keep the display aspect ratio, using the image's
+		 * pixel aspect ratio. (phys_x, phys_y)
+		 *
+		 * @param img_data	[in] Image data.
+		 * @param filename	[in] PNG file.
+		 * @param metadata	[in, opt] Extra metadata. (Ownership is transferred to the encoder.)
+		 * @param thumbWidth	[in, opt] Thumbnail width. (0 for full size)
+		 * @return 0 if queued; negative errno on error.
+		 */
+		int submit(const _Zomg_Img_Data_t *img_data, const char *filename,
+			   LibZomg::Metadata *metadata = nullptr, int thumbWidth = 0);
+
+		/**
+		 * Wait for all queued jobs to finish.
+		 * @return 0 if all jobs since the last wait() succeeded;
+		 * otherwise, the first negative errno.
+		 */
+		int wait(void);
+
+		/**
+		 * Get the number of images written by queued jobs.
+		 * @return Number of images written.
+		 */
+		unsigned int writtenCount(void) const;
+
+		/**
+		 * Get the number of queued jobs that failed.
+		 * @return Number of failed jobs.
+		 */
+		unsigned int failedCount(void) const;
+};
+
+}
+
+#endif /* __LIBGENS_UTIL_PNGENCODER_HPP__ */
@@ -0,0 +1,288 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Profiler.cpp: Hot-path profiler.                                        *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "Profiler.hpp"
+
+// ARRAY_SIZE()
+#include "macros/common.h"
+
+// Atomic operations.
+#include "libcompat/atomic.h"
+
+// C includes.
+#include <stdio.h>
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#endif
+
+namespace LibGens {
+
+// Current frame accumulators.
+uint64_t Profiler::ms_sectTime[PROF_MAX];
+uint32_t Profiler::ms_sectCalls[PROF_MAX];
+
+/**
+ * Profiler state that isn't needed in the header.
+ */
+namespace ProfilerPrivate {
+	// Frame counter.
+	static uint32_t frameNum = 0;
+	// Start time of the current frame.
+	static uint64_t frameStart = 0;
+	// Time base. (set by Reset())
+	static uint64_t timeBase = 0;
+
+	// Ring buffer. (single producer, single consumer)
+	// head is written by the producer; tail is written by the consumer.
+	// Both are free-running counters; the index is (counter % RING_SIZE).
+	static Profiler::FrameRecord ring[Profiler::RING_SIZE];
+	static uint32_t ring_head = 0;
+	static uint32_t ring_tail = 0;
+	static uint32_t dropped = 0;
+
+	// Section names.
+	static const char *const sectionNames[Profiler::PROF_MAX] = {
+		"M68K::Exec",
+		"Z80::Exec",
+		"Vdp::renderLine",
+		"Vdp::updateDMA",
+		"Ym2612::update",
+		"Psg::specialUpdate",
+		"IoManager::doScanline",
+		"VdpPalette::recalc",
+	};
+}
+
+/**
+ * Get the name of a profiler section.
+ * @param section Profiler section.
+ * @return Section name. (ASCII)
+ */
+const char *Profiler::SectionName(Section section)
+{
+	static_assert(ARRAY_SIZE(ProfilerPrivate::sectionNames) == PROF_MAX,
+		"sectionNames[] is out of sync with Profiler::Section.");
+	if ((int)section < 0 || section >= PROF_MAX)
+		return nullptr;
+	return ProfilerPrivate::sectionNames[section];
+}
+
+/**
+ * Get the current time.
+ * @return Current time, in nanoseconds. (monotonic)
+ */
+uint64_t Profiler::Now(void)
+{
+#if defined(_WIN32)
+	static LARGE_INTEGER freq = {{0, 0}};
+	if (freq.QuadPart == 0)
+		QueryPerformanceFrequency(&freq);
+	LARGE_INTEGER count;
+	QueryPerformanceCounter(&count);
+	// Split the calculation to avoid overflow.
+	const uint64_t sec = (count.QuadPart / freq.QuadPart);
+	const uint64_t rem = (count.QuadPart % freq.QuadPart);
+	return (sec * 1000000000ULL) + ((rem * 1000000000ULL) / freq.QuadPart);
+#elif defined(__APPLE__)
+	static mach_timebase_info_data_t timebase = {0, 0};
+	if (timebase.denom == 0)
+		mach_timebase_info(&timebase);
+	return (mach_absolute_time() * timebase.numer / timebase.denom);
+#elif defined(HAVE_CLOCK_GETTIME)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+#else
+	// NOTE: gettimeofday() is not guaranteed to be monotonic.
+	struct timeval tv;
+	gettimeofday(&tv, nullptr);
+	return ((uint64_t)tv.tv_sec * 1000000000ULL) + ((uint64_t)tv.tv_usec * 1000);
+#endif
+}
+
+/**
+ * Reset the profiler.
+ * This clears the ring buffer and the frame counter.
+ * NOTE: Must not be called while a frame is being profiled.
+ */
+void Profiler::Reset(void)
+{
+	memset(ms_sectTime, 0, sizeof(ms_sectTime));
+	memset(ms_sectCalls, 0, sizeof(ms_sectCalls));
+
+	ProfilerPrivate::frameNum = 0;
+	ProfilerPrivate::frameStart = 0;
+	ProfilerPrivate::timeBase = Now();
+
+	ATOMIC_STORE_RELEASE(&ProfilerPrivate::dropped, 0);
+	ATOMIC_STORE_RELEASE(&ProfilerPrivate::ring_tail, 0);
+	ATOMIC_STORE_RELEASE(&ProfilerPrivate::ring_head, 0);
+}
+
+/**
+ * Start profiling a frame.
+ * Called by the emulation thread.
+ */
+void Profiler::BeginFrame(void)
+{
+	if (ProfilerPrivate::timeBase == 0) {
+		// First frame. Initialize the time base.
+		ProfilerPrivate::timeBase = Now();
+	}
+
+	memset(ms_sectTime, 0, sizeof(ms_sectTime));
+	memset(ms_sectCalls, 0, sizeof(ms_sectCalls));
+	ProfilerPrivate::frameStart = Now();
+}
+
+/**
+ * Finish profiling a frame and push it into the ring buffer.
+ * Called by the emulation thread.
+ * @param cycles_M68K 68000 cycles executed this frame.
+ * @param cycles_Z80 Z80 cycles executed this frame.
+ */
+void Profiler::EndFrame(uint32_t cycles_M68K, uint32_t cycles_Z80)
+{
+	const uint64_t frameEnd = Now();
+	const uint32_t frameNum = ProfilerPrivate::frameNum++;
+
+	// Check if there's room in the ring buffer.
+	const uint32_t head = ProfilerPrivate::ring_head;
+	const uint32_t tail = ATOMIC_LOAD_ACQUIRE(&ProfilerPrivate::ring_tail);
+	if ((head - tail) >= RING_SIZE) {
+		// Ring buffer is full. Drop this frame.
+		ATOMIC_ADD_FETCH(&ProfilerPrivate::dropped, 1);
+		return;
+	}
+
+	FrameRecord *const rec = &ProfilerPrivate::ring[head % RING_SIZE];
+	rec->frameNum = frameNum;
+	rec->cycles_M68K = cycles_M68K;
+	rec->cycles_Z80 = cycles_Z80;
+	rec->reserved = 0;
+	rec->start = ProfilerPrivate::frameStart - ProfilerPrivate::timeBase;
+	rec->duration = frameEnd - ProfilerPrivate::frameStart;
+	memcpy(rec->sectTime, ms_sectTime, sizeof(rec->sectTime));
+	memcpy(rec->sectCalls, ms_sectCalls, sizeof(rec->sectCalls));
+
+	// Publish the record.
+	ATOMIC_STORE_RELEASE(&ProfilerPrivate::ring_head, head + 1);
+}
+
+/**
+ * Read frame records from the ring buffer.
+ * This can be called from any *one* thread
+ * while the emulation thread is running.
+ * @param frames	[out] Frame record buffer.
+ * @param maxFrames	[in] Maximum number of records to read.
+ * @return Number of records read.
+ */
+int Profiler::ReadFrames(FrameRecord *frames, int maxFrames)
+{
+	if (!frames || maxFrames <= 0)
+		return 0;
+
+	const uint32_t head = ATOMIC_LOAD_ACQUIRE(&ProfilerPrivate::ring_head);
+	uint32_t tail = ProfilerPrivate::ring_tail;
+	int count = 0;
+	while (tail != head && count < maxFrames) {
+		frames[count++] = ProfilerPrivate::ring[tail % RING_SIZE];
+		tail++;
+	}
+
+	// Release the records to the producer.
+	ATOMIC_STORE_RELEASE(&ProfilerPrivate::ring_tail, tail);
+	return count;
+}
+
+/**
+ * Get the number of frames that were dropped
+ * because the ring buffer was full.
+ * @return Number of dropped frames.
+ */
+unsigned int Profiler::DroppedFrames(void)
+{
+	return ATOMIC_LOAD_ACQUIRE(&ProfilerPrivate::dropped);
+}
+
+/**
+ * Export frame records as Chrome trace JSON.
+ * The file can be loaded in chrome://tracing.
+ *
+ * Each frame is exported as a complete ("X") event.
+ * Section times are exported as counter ("C") events,
+ * since only per-frame totals are recorded.
+ *
+ * @param filename	[in] Output filename.
+ * @param frames	[in] Frame records.
+ * @param count		[in] Number of frame records.
+ * @return 0 on success; negative errno on error.
+ */
+int Profiler::ExportChromeTrace(const char *filename, const FrameRecord *frames, int count)
+{
+	if (!filename || (!frames && count > 0) || count < 0)
+		return -EINVAL;
+
+	FILE *f = fopen(filename, "w");
+	if (!f)
+		return -errno;
+
+	// NOTE: Chrome trace timestamps are in microseconds.
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+	for (int i = 0; i < count; i++) {
+		const FrameRecord *const rec = &frames[i];
+		fprintf(f, "%s{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+			"\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u,"
+			"\"m68k_cycles\":%u,\"z80_cycles\":%u}},\n",
+			(i == 0 ? "" : ","),
+			(double)rec->start / 1000.0, (double)rec->duration / 1000.0,
+			rec->frameNum, rec->cycles_M68K, rec->cycles_Z80);
+
+		// Section times, in milliseconds.
+		fprintf(f, "{\"name\":\"sections\",\"ph\":\"C\",\"pid\":1,\"tid\":1,"
+			"\"ts\":%.3f,\"args\":{", (double)rec->start / 1000.0);
+		for (int j = 0; j < PROF_MAX; j++) {
+			fprintf(f, "%s\"%s\":%.6f", (j == 0 ? "" : ","),
+				ProfilerPrivate::sectionNames[j],
+				(double)rec->sectTime[j] / 1000000.0);
+		}
+		fputs("}}\n", f);
+	}
+	fputs("]}\n", f);
+
+	int ret = 0;
+	if (ferror(f))
+		ret = -EIO;
+	fclose(f);
+	return ret;
+}
+
+}
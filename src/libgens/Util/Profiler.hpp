@@ -0,0 +1,242 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Profiler.hpp: Hot-path profiler.                                        *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_UTIL_PROFILER_HPP__
+#define __LIBGENS_UTIL_PROFILER_HPP__
+
+#include <libgens/config.libgens.h>
+
+// C includes.
+#include <stdint.h>
+
+/**
+ * Profiler sections.
+ * The sections are #define'd to 1 to enable them, or 0 to disable them.
+ * This is similar to the LOG_MSG() channels in log_msg.h.
+ *
+ * NOTE: Sections are only compiled in if GENS_ENABLE_PROFILER
+ * is set. (CMake option: ENABLE_PROFILER)
+ */
+#define PROFILE_SECTION_M68K_EXEC		1
+#define PROFILE_SECTION_Z80_EXEC		1
+#define PROFILE_SECTION_VDP_RENDERLINE		1
+#define PROFILE_SECTION_VDP_UPDATEDMA		1
+#define PROFILE_SECTION_YM2612_UPDATE		1
+#define PROFILE_SECTION_PSG_SPECIALUPDATE	1
+#define PROFILE_SECTION_IO_DOSCANLINE		1
+#define PROFILE_SECTION_PALETTE_RECALC		1
+
+namespace LibGens {
+
+class Profiler
+{
+	private:
+		// Static class.
+		Profiler() { }
+		~Profiler() { }
+		Profiler(const Profiler &);
+		Profiler &operator=(const Profiler &);
+
+	public:
+		/**
+		 * Profiler sections.
+		 * NOTE: Section times are inclusive, so if e.g.
+		 * a YM2612 update is triggered by a 68000 write,
+		 * it will be counted in both sections.
+		 */
+		enum Section {
+			PROF_M68K_EXEC = 0,
+			PROF_Z80_EXEC,
+			PROF_VDP_RENDERLINE,
+			PROF_VDP_UPDATEDMA,
+			PROF_YM2612_UPDATE,
+			PROF_PSG_SPECIALUPDATE,
+			PROF_IO_DOSCANLINE,
+			PROF_PALETTE_RECALC,
+
+			PROF_MAX
+		};
+
+		/**
+		 * Get the name of a profiler section.
+		 * @param section Profiler section.
+		 * @return Section name. (ASCII)
+		 */
+		static const char *SectionName(Section section);
+
+		/**
+		 * Per-frame profiling record.
+		 * Times are in nanoseconds.
+		 */
+		struct FrameRecord {
+			uint32_t frameNum;	// Frame number.
+			uint32_t cycles_M68K;	// 68000 cycles executed.
+			uint32_t cycles_Z80;	// Z80 cycles executed.
+			uint32_t reserved;
+			uint64_t start;		// Frame start time, relative to Reset().
+			uint64_t duration;	// Frame duration.
+			uint64_t sectTime[PROF_MAX];	// Time spent in each section.
+			uint32_t sectCalls[PROF_MAX];	// Number of calls to each section.
+		};
+
+		/**
+		 * Number of frames that can be stored in the ring buffer.
+		 * If the ring buffer is full, new frames are dropped.
+		 */
+		static const unsigned int RING_SIZE = 256;
+
+		/**
+		 * Get the current time.
+		 * @return Current time, in nanoseconds. (monotonic)
+		 */
+		static uint64_t Now(void);
+
+		/**
+		 * Reset the profiler.
+		 * This clears the ring buffer and the frame counter.
+		 * NOTE: Must not be called while a frame is being profiled.
+		 */
+		static void Reset(void);
+
+		/**
+		 * Start profiling a frame.
+		 * Called by the emulation thread.
+		 */
+		static void BeginFrame(void);
+
+		/**
+		 * Finish profiling a frame and push it into the ring buffer.
+		 * Called by the emulation thread.
+		 * @param cycles_M68K 68000 cycles executed this frame.
+		 * @param cycles_Z80 Z80 cycles executed this frame.
+		 */
+		static void EndFrame(uint32_t cycles_M68K, uint32_t cycles_Z80);
+
+		/**
+		 * Add time to a section in the current frame.
+		 * @param section Profiler section.
+		 * @param ns Time, in nanoseconds.
+		 */
+		static inline void AddTime(Section section, uint64_t ns)
+		{
+			ms_sectTime[section] += ns;
+			ms_sectCalls[section]++;
+		}
+
+		/**
+		 * Read frame records from the ring buffer.
+		 * This can be called from any *one* thread
+		 * while the emulation thread is running.
+		 * @param frames	[out] Frame record buffer.
+		 * @param maxFrames	[in] Maximum number of records to read.
+		 * @return Number of records read.
+		 */
+		static int ReadFrames(FrameRecord *frames, int maxFrames);
+
+		/**
+		 * Get the number of frames that were dropped
+		 * because the ring buffer was full.
+		 * @return Number of dropped frames.
+		 */
+		static unsigned int DroppedFrames(void);
+
+		/**
+		 * Export frame records as Chrome trace JSON.
+		 * The file can be loaded in chrome://tracing.
+		 * @param filename	[in] Output filename.
+		 * @param frames	[in] Frame records.
+		 * @param count		[in] Number of frame records.
+		 * @return 0 on success; negative errno on error.
+		 */
+		static int ExportChromeTrace(const char *filename, const FrameRecord *frames, int count);
+
+	private:
+		// Current frame accumulators.
+		// Only accessed by the emulation thread.
+		static uint64_t ms_sectTime[PROF_MAX];
+		static uint32_t ms_sectCalls[PROF_MAX];
+};
+
+/**
+ * Scoped section timer.
+ * The disabled version is empty, so the compiler
+ * optimizes it out completely.
+ */
+template<bool enabled>
+class ProfilerScope
+{
+	public:
+		inline explicit ProfilerScope(Profiler::Section section)
+			{ ((void)section); }
+};
+
+template<>
+class ProfilerScope<true>
+{
+	public:
+		inline explicit ProfilerScope(Profiler::Section section)
+			: m_section(section)
+			, m_start(Profiler::Now()) { }
+		inline ~ProfilerScope()
+			{ Profiler::AddTime(m_section, Profiler::Now() - m_start); }
+
+	private:
+		ProfilerScope(const ProfilerScope &);
+		ProfilerScope &operator=(const ProfilerScope &);
+
+		const Profiler::Section m_section;
+		const uint64_t m_start;
+};
+
+}
+
+#ifdef GENS_ENABLE_PROFILER
+
+/**
+ * PROFILE_SCOPE(): Time the rest of the current scope.
+ * @param section Section name, without the PROF_ prefix. (e.g. M68K_EXEC)
+ */
+#define PROFILE_SCOPE(section) \
+	LibGens::ProfilerScope<(PROFILE_SECTION_ ##section != 0)> \
+		__prof_scope_ ##section(LibGens::Profiler::PROF_ ##section)
+
+/**
+ * PROFILE_FRAME_BEGIN(): Start profiling a frame.
+ */
+#define PROFILE_FRAME_BEGIN() LibGens::Profiler::BeginFrame()
+
+/**
+ * PROFILE_FRAME_END(): Finish profiling a frame.
+ * @param cycles_M68K 68000 cycles executed this frame.
+ * @param cycles_Z80 Z80 cycles executed this frame.
+ */
+#define PROFILE_FRAME_END(cycles_M68K, cycles_Z80) \
+	LibGens::Profiler::EndFrame((cycles_M68K), (cycles_Z80))
+
+#else /* !GENS_ENABLE_PROFILER */
+
+#define PROFILE_SCOPE(section) do { } while (0)
+#define PROFILE_FRAME_BEGIN() do { } while (0)
+#define PROFILE_FRAME_END(cycles_M68K, cycles_Z80) do { } while (0)
+
+#endif /* GENS_ENABLE_PROFILER */
+
+#endif /* __LIBGENS_UTIL_PROFILER_HPP__ */
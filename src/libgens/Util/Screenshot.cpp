@@ -23,6 +23,7 @@
 
 // LibGens
 #include "Util/MdFb.hpp"
+#include "Util/PngEncoder.hpp"
 #include "Rom.hpp"
 
 // LibZomg
@@ -82,6 +83,8 @@ void ScreenshotPrivate::toImgData(Zomg_Img_Data_t *img_data,
 				const MdFb *fb, const Rom *rom)
 {
 	// Take the screenshot.
+	// NOTE: The caller must unref() the framebuffer
+	// once it's done with img_data.
 	fb->ref();
 	const int imgXStart = fb->imgXStart();
 	const int imgYStart = fb->imgYStart();
@@ -189,8 +192,36 @@ int Screenshot::toFile(const char *filename, const MdFb *fb, const Rom *rom)
 	// Write the PNG image.
 	// TODO: Do UTF-8 filenames work with libpng on Windows?
 	PngWriter pngWriter;
-	return pngWriter.writeToFile(&img_data, filename,
+	int ret = pngWriter.writeToFile(&img_data, filename,
 				&metadata, Metadata::MF_Default);
+	fb->unref();
+	return ret;
+}
+
+/**
+ * Queue a screenshot on a PngEncoder.
+ * The framebuffer is copied before this function returns.
+ * @param encoder	[in] PNG encoder.
+ * @param filename	[in] Filename for the screenshot.
+ * @param fb		[in] MD framebuffer.
+ * @param rom		[in, opt] ROM object. (Needed for some metadata.)
+ * @param thumbWidth	[in, opt] Thumbnail width. (0 for full size)
+ * @return 0 on success; negative errno on error.
+ */
+int Screenshot::toEncoder(PngEncoder *encoder, const char *filename,
+			  const MdFb *fb, const Rom *rom, int thumbWidth)
+{
+	if (!encoder || !fb || !filename || !filename[0])
+		return -EINVAL;
+
+	// TODO: metaFlags.
+	// NOTE: The encoder takes ownership of the metadata.
+	Zomg_Img_Data_t img_data;
+	Metadata *const metadata = new Metadata();
+	ScreenshotPrivate::toImgData(&img_data, metadata, fb, rom);
+	int ret = encoder->submit(&img_data, filename, metadata, thumbWidth);
+	fb->unref();
+	return ret;
 }
 
 /**
@@ -212,7 +243,9 @@ int Screenshot::toZomg(LibZomg::ZomgBase *zomg, const MdFb *fb, const Rom *rom)
 	ScreenshotPrivate::toImgData(&img_data, &metadata, fb, rom);
 
 	// Write the image to the ZOMG savestate.
-	return zomg->savePreview(&img_data, &metadata, Metadata::MF_Default);
+	int ret = zomg->savePreview(&img_data, &metadata, Metadata::MF_Default);
+	fb->unref();
+	return ret;
 }
 
 }
\ No newline at end of file
@@ -30,6 +30,7 @@ namespace LibGens {
 
 class MdFb;
 class Rom;
+class PngEncoder;
 
 class Screenshot
 {
@@ -56,6 +57,19 @@ class Screenshot
 		 */
 		static int toFile(const char *filename, const MdFb *fb, const Rom *rom);
 
+		/**
+		 * Queue a screenshot on a PngEncoder.
+		 * The framebuffer is copied before this function returns.
+		 * @param encoder	[in] PNG encoder.
+		 * @param filename	[in] Filename for the screenshot.
+		 * @param fb		[in] MD framebuffer.
+		 * @param rom		[in, opt] ROM object. (Needed for some metadata.)
+		 * @param thumbWidth	[in, opt] Thumbnail width. (0 for full size)
+		 * @return 0 on success; negative errno on error.
+		 */
+		static int toEncoder(PngEncoder *encoder, const char *filename,
+				     const MdFb *fb, const Rom *rom, int thumbWidth = 0);
+
 		/**
 		 * Save a screenshot to a ZOMG savestate.
 		 * TODO: Metadata flags parameter.
@@ -0,0 +1,233 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * TaskPool.cpp: Small worker thread pool for data-parallel tasks.         *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "TaskPool.hpp"
+
+// Atomic operations.
+#include "libcompat/atomic.h"
+
+// C++ includes.
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+using std::condition_variable;
+using std::mutex;
+using std::thread;
+using std::unique_lock;
+using std::vector;
+
+namespace LibGens {
+
+/**
+ * TaskPool private class.
+ */
+class TaskPoolPrivate
+{
+	public:
+		TaskPoolPrivate(int threads);
+		~TaskPoolPrivate();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		TaskPoolPrivate(const TaskPoolPrivate &);
+		TaskPoolPrivate &operator=(const TaskPoolPrivate &);
+
+	public:
+		vector<thread> workers;
+
+		// Protects everything below, except nextTask.
+		mutex mtx;
+		condition_variable cvWork;	// Workers wait for work here.
+		condition_variable cvDone;	// run() waits for workers here.
+
+		// Current job.
+		TaskPool::TaskFn fn;
+		void *param;
+		int count;
+		int nextTask;		// Next task index. (atomic)
+		unsigned int generation;	// Incremented for every job.
+		int active;		// Number of workers still running the job.
+		bool quit;
+
+		/**
+		 * Run tasks from the current job until none are left.
+		 */
+		void runTasks(void);
+
+		/**
+		 * Worker thread function.
+		 * @param d TaskPoolPrivate.
+		 */
+		static void workerThread(TaskPoolPrivate *d);
+};
+
+TaskPoolPrivate::TaskPoolPrivate(int threads)
+	: fn(nullptr)
+	, param(nullptr)
+	, count(0)
+	, nextTask(0)
+	, generation(0)
+	, active(0)
+	, quit(false)
+{
+	// The calling thread counts as one of the threads.
+	workers.reserve(threads - 1);
+	for (int i = 1; i < threads; i++) {
+		workers.push_back(thread(workerThread, this));
+	}
+}
+
+TaskPoolPrivate::~TaskPoolPrivate()
+{
+	{
+		unique_lock<mutex> lock(mtx);
+		quit = true;
+	}
+	cvWork.notify_all();
+	for (size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+}
+
+/**
+ * Run tasks from the current job until none are left.
+ */
+void TaskPoolPrivate::runTasks(void)
+{
+	int index;
+	while ((index = ATOMIC_ADD_FETCH(&nextTask, 1) - 1) < count) {
+		fn(param, index, count);
+	}
+}
+
+/**
+ * Worker thread function.
+ * @param d TaskPoolPrivate.
+ */
+void TaskPoolPrivate::workerThread(TaskPoolPrivate *d)
+{
+	unique_lock<mutex> lock(d->mtx);
+	// NOTE: Don't read d->generation here. If run() is called
+	// before this thread starts, the first job would be missed.
+	unsigned int lastGeneration = 0;
+	while (true) {
+		while (!d->quit && d->generation == lastGeneration) {
+			d->cvWork.wait(lock);
+		}
+		if (d->quit)
+			break;
+		lastGeneration = d->generation;
+
+		lock.unlock();
+		d->runTasks();
+		lock.lock();
+
+		if (--d->active == 0) {
+			d->cvDone.notify_one();
+		}
+	}
+}
+
+/** TaskPool **/
+
+/**
+ * Create a task pool.
+ * @param threads Total number of threads, including the calling thread.
+ * If 0, a default based on the number of CPUs is used.
+ */
+TaskPool::TaskPool(int threads)
+	: d(new TaskPoolPrivate(threads <= 0 ? DefaultThreadCount()
+				: (threads > MAX_THREADS ? MAX_THREADS : threads)))
+{ }
+
+TaskPool::~TaskPool()
+{
+	delete d;
+}
+
+/**
+ * Get the default number of threads.
+ * @return Default number of threads.
+ */
+int TaskPool::DefaultThreadCount(void)
+{
+	// Leave one CPU for the emulation thread.
+	int threads = (int)thread::hardware_concurrency() - 1;
+	if (threads < 1)
+		threads = 1;
+	else if (threads > 4)
+		threads = 4;
+	return threads;
+}
+
+/**
+ * Get the total number of threads, including the calling thread.
+ * @return Number of threads.
+ */
+int TaskPool::threadCount(void) const
+{
+	return (int)d->workers.size() + 1;
+}
+
+/**
+ * Run a set of tasks.
+ * fn() is called once for each index in [0, count).
+ * Tasks may run in any order and on any thread.
+ * @param fn Task function.
+ * @param param Parameter for fn().
+ * @param count Number of tasks.
+ */
+void TaskPool::run(TaskFn fn, void *param, int count)
+{
+	if (count <= 0)
+		return;
+	if (count == 1 || d->workers.empty()) {
+		// Not worth waking up the workers.
+		for (int i = 0; i < count; i++) {
+			fn(param, i, count);
+		}
+		return;
+	}
+
+	{
+		unique_lock<mutex> lock(d->mtx);
+		d->fn = fn;
+		d->param = param;
+		d->count = count;
+		d->nextTask = 0;
+		d->active = (int)d->workers.size();
+		d->generation++;
+	}
+	d->cvWork.notify_all();
+
+	// Help out.
+	d->runTasks();
+
+	// Wait for the workers to finish.
+	unique_lock<mutex> lock(d->mtx);
+	while (d->active > 0) {
+		d->cvDone.wait(lock);
+	}
+}
+
+}
@@ -0,0 +1,99 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * TaskPool.hpp: Small worker thread pool for data-parallel tasks.         *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_UTIL_TASKPOOL_HPP__
+#define __LIBGENS_UTIL_TASKPOOL_HPP__
+
+namespace LibGens {
+
+class TaskPoolPrivate;
+
+/**
+ * Small worker thread pool for data-parallel tasks.
+ *
+ * run() splits a job into a number of independent tasks,
+ * e.g. row bands of an image, and runs them on the worker
+ * threads. The calling thread processes tasks as well, and
+ * run() returns once every task has finished.
+ *
+ * Worker threads are started when the pool is created
+ * and sleep while there's no work.
+ *
+ * NOTE: run() must only be called from one thread at a time.
+ */
+class TaskPool
+{
+	public:
+		/**
+		 * Create a task pool.
+		 * @param threads Total number of threads, including the calling thread.
+		 * If 0, a default based on the number of CPUs is used.
+		 */
+		explicit TaskPool(int threads = 0);
+		~TaskPool();
+
+	private:
+		friend class TaskPoolPrivate;
+		TaskPoolPrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		TaskPool(const TaskPool &);
+		TaskPool &operator=(const TaskPool &);
+
+	public:
+		// Maximum number of threads.
+		static const int MAX_THREADS = 8;
+
+		/**
+		 * Get the default number of threads.
+		 * @return Default number of threads.
+		 */
+		static int DefaultThreadCount(void);
+
+		/**
+		 * Get the total number of threads, including the calling thread.
+		 * @return Number of threads.
+		 */
+		int threadCount(void) const;
+
+		/**
+		 * Task function.
+		 * @param param Parameter passed to run().
+		 * @param index Task index.
+		 * @param count Total number of tasks.
+		 */
+		typedef void (*TaskFn)(void *param, int index, int count);
+
+		/**
+		 * Run a set of tasks.
+		 * fn() is called once for each index in [0, count).
+		 * Tasks may run in any order and on any thread.
+		 * @param fn Task function.
+		 * @param param Parameter for fn().
+		 * @param count Number of tasks.
+		 */
+		void run(TaskFn fn, void *param, int count);
+};
+
+}
+
+#endif /* __LIBGENS_UTIL_TASKPOOL_HPP__ */
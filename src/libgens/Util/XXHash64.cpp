@@ -0,0 +1,211 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * XXHash64.cpp: xxHash64 hash function.                                   *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "XXHash64.hpp"
+
+// Byteswapping macros.
+#include "libcompat/byteswap.h"
+
+// C includes. (C++ namespace)
+#include <cstring>
+
+namespace LibGens {
+
+static const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl64(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint32_t readLE32(const uint8_t *p)
+{
+	uint32_t val;
+	memcpy(&val, p, sizeof(val));
+	return le32_to_cpu(val);
+}
+
+static inline uint64_t readLE64(const uint8_t *p)
+{
+#if SYS_BYTEORDER == SYS_LIL_ENDIAN
+	uint64_t val;
+	memcpy(&val, p, sizeof(val));
+	return val;
+#else
+	return (uint64_t)readLE32(p) | ((uint64_t)readLE32(p + 4) << 32);
+#endif
+}
+
+static inline uint64_t round(uint64_t acc, uint64_t input)
+{
+	acc += input * PRIME64_2;
+	acc = rotl64(acc, 31);
+	return acc * PRIME64_1;
+}
+
+static inline uint64_t mergeRound(uint64_t acc, uint64_t val)
+{
+	acc ^= round(0, val);
+	return acc * PRIME64_1 + PRIME64_4;
+}
+
+XXHash64::XXHash64(uint64_t seed)
+{
+	reset(seed);
+}
+
+/**
+ * Reset the hash state.
+ * @param seed Seed.
+ */
+void XXHash64::reset(uint64_t seed)
+{
+	m_seed = seed;
+	m_acc[0] = seed + PRIME64_1 + PRIME64_2;
+	m_acc[1] = seed + PRIME64_2;
+	m_acc[2] = seed;
+	m_acc[3] = seed - PRIME64_1;
+	m_totalLen = 0;
+	m_bufLen = 0;
+}
+
+/**
+ * Add data to the hash.
+ * @param data Data.
+ * @param len Length of data, in bytes.
+ */
+void XXHash64::update(const void *data, size_t len)
+{
+	const uint8_t *p = (const uint8_t*)data;
+	const uint8_t *const end = p + len;
+	m_totalLen += len;
+
+	if (m_bufLen + len < sizeof(m_buf)) {
+		// Not enough data for a full stripe.
+		memcpy(&m_buf[m_bufLen], p, len);
+		m_bufLen += (unsigned int)len;
+		return;
+	}
+
+	if (m_bufLen > 0) {
+		// Finish the partial stripe.
+		const unsigned int fill = (unsigned int)sizeof(m_buf) - m_bufLen;
+		memcpy(&m_buf[m_bufLen], p, fill);
+		p += fill;
+		m_acc[0] = round(m_acc[0], readLE64(&m_buf[0]));
+		m_acc[1] = round(m_acc[1], readLE64(&m_buf[8]));
+		m_acc[2] = round(m_acc[2], readLE64(&m_buf[16]));
+		m_acc[3] = round(m_acc[3], readLE64(&m_buf[24]));
+		m_bufLen = 0;
+	}
+
+	if (end - p >= 32) {
+		// Full stripes.
+		// Local copies let the compiler keep the
+		// accumulators in registers.
+		uint64_t v1 = m_acc[0], v2 = m_acc[1];
+		uint64_t v3 = m_acc[2], v4 = m_acc[3];
+		const uint8_t *const limit = end - 32;
+		do {
+			v1 = round(v1, readLE64(p));
+			v2 = round(v2, readLE64(p + 8));
+			v3 = round(v3, readLE64(p + 16));
+			v4 = round(v4, readLE64(p + 24));
+			p += 32;
+		} while (p <= limit);
+		m_acc[0] = v1; m_acc[1] = v2;
+		m_acc[2] = v3; m_acc[3] = v4;
+	}
+
+	if (p < end) {
+		// Save the remainder.
+		m_bufLen = (unsigned int)(end - p);
+		memcpy(m_buf, p, m_bufLen);
+	}
+}
+
+/**
+ * Get the hash of all data added so far.
+ * This does not change the hash state.
+ * @return Hash.
+ */
+uint64_t XXHash64::digest(void) const
+{
+	uint64_t h64;
+	if (m_totalLen >= 32) {
+		h64 = rotl64(m_acc[0], 1) + rotl64(m_acc[1], 7) +
+		      rotl64(m_acc[2], 12) + rotl64(m_acc[3], 18);
+		h64 = mergeRound(h64, m_acc[0]);
+		h64 = mergeRound(h64, m_acc[1]);
+		h64 = mergeRound(h64, m_acc[2]);
+		h64 = mergeRound(h64, m_acc[3]);
+	} else {
+		h64 = m_seed + PRIME64_5;
+	}
+	h64 += m_totalLen;
+
+	// Remaining bytes.
+	const uint8_t *p = m_buf;
+	const uint8_t *const end = m_buf + m_bufLen;
+	while (p + 8 <= end) {
+		h64 ^= round(0, readLE64(p));
+		h64 = rotl64(h64, 27) * PRIME64_1 + PRIME64_4;
+		p += 8;
+	}
+	if (p + 4 <= end) {
+		h64 ^= (uint64_t)readLE32(p) * PRIME64_1;
+		h64 = rotl64(h64, 23) * PRIME64_2 + PRIME64_3;
+		p += 4;
+	}
+	while (p < end) {
+		h64 ^= (*p) * PRIME64_5;
+		h64 = rotl64(h64, 11) * PRIME64_1;
+		p++;
+	}
+
+	// Avalanche.
+	h64 ^= h64 >> 33;
+	h64 *= PRIME64_2;
+	h64 ^= h64 >> 29;
+	h64 *= PRIME64_3;
+	h64 ^= h64 >> 32;
+	return h64;
+}
+
+/**
+ * Hash a single block of data.
+ * @param data Data.
+ * @param len Length of data, in bytes.
+ * @param seed Seed.
+ * @return Hash.
+ */
+uint64_t XXHash64::hash(const void *data, size_t len, uint64_t seed)
+{
+	XXHash64 h(seed);
+	h.update(data, len);
+	return h.digest();
+}
+
+}
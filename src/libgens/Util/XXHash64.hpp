@@ -0,0 +1,88 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * XXHash64.hpp: xxHash64 hash function.                                   *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_UTIL_XXHASH64_HPP__
+#define __LIBGENS_UTIL_XXHASH64_HPP__
+
+// C includes.
+#include <stdint.h>
+#include <stddef.h>
+
+namespace LibGens {
+
+/**
+ * xxHash64 hash function.
+ * Streaming implementation of Yann Collet's XXH64.
+ * Results match the reference implementation.
+ *
+ * Input is processed in 32-byte stripes using four independent
+ * accumulators, which keeps the multipliers busy on superscalar CPUs.
+ *
+ * Reference: https://github.com/Cyan4973/xxHash
+ */
+class XXHash64
+{
+	public:
+		XXHash64(uint64_t seed = 0);
+
+	public:
+		/**
+		 * Reset the hash state.
+		 * @param seed Seed.
+		 */
+		void reset(uint64_t seed = 0);
+
+		/**
+		 * Add data to the hash.
+		 * @param data Data.
+		 * @param len Length of data, in bytes.
+		 */
+		void update(const void *data, size_t len);
+
+		/**
+		 * Get the hash of all data added so far.
+		 * This does not change the hash state.
+		 * @return Hash.
+		 */
+		uint64_t digest(void) const;
+
+		/**
+		 * Hash a single block of data.
+		 * @param data Data.
+		 * @param len Length of data, in bytes.
+		 * @param seed Seed.
+		 * @return Hash.
+		 */
+		static uint64_t hash(const void *data, size_t len, uint64_t seed = 0);
+
+	private:
+		uint64_t m_acc[4];
+		uint64_t m_seed;
+		uint64_t m_totalLen;
+
+		// Partial stripe.
+		uint8_t m_buf[32];
+		unsigned int m_bufLen;
+};
+
+}
+
+#endif /* __LIBGENS_UTIL_XXHASH64_HPP__ */
@@ -97,6 +97,8 @@ VdpPrivate::~VdpPrivate()
 Vdp::Vdp(MdFb *fb)
 	: d(new VdpPrivate(this))
 	, options(VdpPrivate::def_vdpEmuOptions)
+	, m_dmaStartFn(nullptr)
+	, m_dmaStartParam(nullptr)
 	, DMAT_Length(0)
 	, MD_Screen(fb ? fb->ref() : new MdFb())
 {
@@ -136,6 +138,7 @@ void Vdp::reset(void)
 	memset(&d->VSRam, 0, sizeof(d->VSRam));
 	// Clear the Sprite Attribute Table cache.
 	memset(&d->SprAttrTbl_m5.b, 0, sizeof(d->SprAttrTbl_m5.b));
+	d->invalidateSprIdx();
 	// Clear the sprite line cache.
 	memset(d->sprLineCache, 0, sizeof(d->sprLineCache));
 	memset(d->sprCountCache, 0, sizeof(d->sprCountCache));
@@ -508,7 +511,7 @@ void Vdp::zomgRestoreMD(LibZomg::Zomg *zomg)
 	} else if (ret >= 640) {
 		// Full 640-byte SAT is stored.
 		// Copy it all over as-is.
-		memcpy(d->SprAttrTbl_m5.w, vdp_sat, sizeof(d->SprAttrTbl_sz));
+		memcpy(d->SprAttrTbl_m5.w, vdp_sat, d->SprAttrTbl_sz);
 	} else {
 		// 320-byte SAT cache is stored.
 		// Expand it in memory.
@@ -524,6 +527,9 @@ void Vdp::zomgRestoreMD(LibZomg::Zomg *zomg)
 		}
 	}
 
+	// The SAT cache was replaced.
+	d->invalidateSprIdx();
+
 	// Clear the sprite dot overflow flag.
 	d->sprDotOverflow = false;
 
@@ -149,11 +149,49 @@ class Vdp
 		 */
 		unsigned int updateDMA(void);
 
+		/**
+		 * DMA start function.
+		 * Called when a DMA operation is started that isn't
+		 * finished on the current line. updateDMA() must then
+		 * be called at the start of each line until
+		 * DMAT_Length is 0.
+		 * @param param Parameter passed to setDmaStartFn().
+		 */
+		typedef void (*DmaStartFn)(void *param);
+
+		/**
+		 * Set the DMA start function.
+		 * This is used by the emulation loop to schedule
+		 * DMA updates instead of polling DMAT_Length.
+		 * @param fn DMA start function, or nullptr to disable.
+		 * @param param Parameter for fn.
+		 */
+		inline void setDmaStartFn(DmaStartFn fn, void *param)
+		{
+			m_dmaStartFn = fn;
+			m_dmaStartParam = param;
+		}
+
 		/**
 		 * Render the current line to the framebuffer.
 		 */
 		void renderLine(void);
 
+		/**
+		 * Get the signature of the current MD_Screen contents.
+		 * If two calls return the same value, MD_Screen has
+		 * not changed in between.
+		 * @return Frame signature.
+		 */
+		uint64_t frameSignature(void) const;
+
+		/**
+		 * Invalidate the frame signature.
+		 * This must be called if MD_Screen is modified
+		 * by anything other than the VDP.
+		 */
+		void invalidateFrameSignature(void);
+
 	public:
 		/** MD-side interface. **/
 		// NOTE: Byte-wide MD ctrl/data functions are
@@ -210,6 +248,11 @@ class Vdp
 		 */
 		void zomgRestoreMD(LibZomg::Zomg *zomg);
 
+	protected:
+		// DMA start function.
+		DmaStartFn m_dmaStartFn;
+		void *m_dmaStartParam;
+
 	public:
 		// TODO: Move to private class.
 		int DMAT_Length;
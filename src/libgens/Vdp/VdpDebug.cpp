@@ -184,6 +184,7 @@ int Vdp::dbg_writeVRam_16(uint32_t address, const uint16_t *vram, int length)
 		if ((address & d->Spr_Tbl_Mask) == d->Spr_Tbl_Addr) {
 			// Sprite Attribute Table.
 			d->SprAttrTbl_m5.w[(address & ~d->Spr_Tbl_Mask) >> 1] = *vram;
+			d->markSprIdxDirty(address & ~d->Spr_Tbl_Mask);
 		}
 	}
 
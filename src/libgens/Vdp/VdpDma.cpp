@@ -29,10 +29,16 @@
 // LOG_MSG() subsystem.
 #include "macros/log_msg.h"
 
+// Profiler.
+#include "Util/Profiler.hpp"
+
 // M68K CPU.
 #include "cpu/M68K_Mem.hpp"
 #include "Cartridge/RomCartridgeMD.hpp"
 
+// C includes. (C++ namespace)
+#include <cstring>
+
 namespace LibGens {
 
 /** VdpPrivate **/
@@ -77,6 +83,7 @@ void VdpPrivate::DMA_Fill(uint16_t data)
 				if ((address & Spr_Tbl_Mask) == Spr_Tbl_Addr) {
 					// Sprite Attribute Table.
 					SprAttrTbl_m5.b[(address & ~Spr_Tbl_Mask) ^ U16DATA_U8_INVERT] = fill_hi;
+					markSprIdxDirty(address & ~Spr_Tbl_Mask);
 				}
 				address += VDP_Reg.m5.Auto_Inc;
 				address &= VRam_Mask;
@@ -117,6 +124,108 @@ void VdpPrivate::DMA_Fill(uint16_t data)
 	// NOTE: DMA FILL updates the DMA source address,
 	// even though it isn't used.
 	inc_DMA_Src_Adr(q->DMAT_Length);
+
+	// The DMA Busy flag is cleared by updateDMA().
+	notifyDmaStart();
+}
+
+/**
+ * Bulk Mem-to-DMA transfer.
+ * Used for the common case: auto-increment 2, even destination address.
+ * Contiguous runs of source words are copied directly instead
+ * of going through vdpDataWrite_int() one word at a time.
+ * @param src_component Source component.
+ * @param dest_component Destination component.
+ * @param src_word_address [in/out] Source word address.
+ * @param src_base_address Source base address. (for 128 KB wrapping)
+ * @param length Number of words to transfer.
+ * @return Number of words that weren't transferred. (Use the per-word loop for these.)
+ */
+template<VdpPrivate::DMA_Src_t src_component, VdpPrivate::DMA_Dest_t dest_component>
+inline int VdpPrivate::T_DMA_Bulk(uint16_t *src_word_address,
+				  unsigned int src_base_address, int length)
+{
+	uint32_t address = VDP_Ctrl.address;
+	while (length > 0) {
+		// Runs can't cross the 128 KB source boundary.
+		unsigned int words = (0x10000 - *src_word_address);
+		if (words > (unsigned int)length)
+			words = length;
+
+		// Get a pointer to the source data.
+		const uint16_t *src;
+		switch (src_component) {
+			case DMA_SRC_ROM: {
+				const uint32_t req_addr = ((*src_word_address | src_base_address) << 1);
+				src = M68K_Mem::ms_RomCartridge->dmaRomPtr(req_addr, &words);
+				break;
+			}
+
+			case DMA_SRC_M68K_RAM: {
+				// M68K RAM is mirrored within the 128 KB source window.
+				const unsigned int idx = (*src_word_address & 0x7FFF);
+				if (words > (0x8000 - idx))
+					words = (0x8000 - idx);
+				src = &Ram_68k.u16[idx];
+				break;
+			}
+
+			default:
+				src = nullptr;
+				break;
+		}
+		if (!src) {
+			// Source can't be accessed directly.
+			break;
+		}
+
+		switch (dest_component) {
+			case DMA_DEST_VRAM: {
+				// Runs can't cross the end of VRam.
+				if (words > ((0x10000 - address) >> 1))
+					words = ((0x10000 - address) >> 1);
+				memcpy(&VRam.u16[address >> 1], src, (words * 2));
+
+				// Update the Sprite Attribute Table cache.
+				const uint32_t end = address + (words * 2);
+				const uint32_t sat_end = Spr_Tbl_Addr + ((~Spr_Tbl_Mask & 0xFFFF) + 1);
+				const uint32_t lo = (address > Spr_Tbl_Addr ? address : Spr_Tbl_Addr);
+				const uint32_t hi = (end < sat_end ? end : sat_end);
+				if (lo < hi) {
+					memcpy(&SprAttrTbl_m5.b[lo - Spr_Tbl_Addr], &VRam.u8[lo], (hi - lo));
+					markSprIdxDirty((lo - Spr_Tbl_Addr), (hi - lo));
+				}
+				break;
+			}
+
+			case DMA_DEST_CRAM:
+				// CRam is 128 bytes. (64 words)
+				// Writes past the end are ignored. (See vdpDataWrite_int().)
+				for (unsigned int i = 0; i < words; i++) {
+					const uint32_t cur = ((address + (i * 2)) & 0xFFFF);
+					if (cur < 0x80) {
+						palette.writeCRam_16(cur, src[i]);
+					}
+				}
+				break;
+
+			case DMA_DEST_VSRAM:
+				for (unsigned int i = 0; i < words; i++) {
+					VSRam.u16[((address + (i * 2)) & 0x7E) >> 1] = src[i];
+				}
+				break;
+
+			default:	// to make gcc shut up
+				break;
+		}
+
+		*src_word_address += words;
+		address = ((address + (words * 2)) & 0xFFFF);
+		length -= words;
+	}
+
+	VDP_Ctrl.address = address;
+	return length;
 }
 
 /**
@@ -210,8 +319,18 @@ inline void VdpPrivate::T_DMA_Loop(void)
 	// src_base_address is used to ensure 128 KB wrapping.
 	unsigned int src_base_address = ((src_address & 0xFE0000) >> 1);
 
+	if ((src_component == DMA_SRC_ROM || src_component == DMA_SRC_M68K_RAM) &&
+	    VDP_Reg.m5.Auto_Inc == 2 && VRam_Mask == 0xFFFF &&
+	    VDP_Ctrl.address <= 0xFFFF && !(VDP_Ctrl.address & 1))
+	{
+		// Bulk transfer. Any remaining words (e.g. ROM areas
+		// with save data) are handled by the per-word loop.
+		length = T_DMA_Bulk<src_component, dest_component>(
+				&src_word_address, src_base_address, length);
+	}
+
 	// TODO: Do DMA MEM-to-VRAM line-by-line instead of all at once.
-	do {
+	for (; length > 0; length--) {
 		// Get the word.
 		uint16_t w;
 		switch (src_component) {
@@ -224,8 +343,9 @@ inline void VdpPrivate::T_DMA_Loop(void)
 			}
 
 			case DMA_SRC_M68K_RAM:
+				// M68K RAM is mirrored within the 128 KB source window.
 				//w = M68K_Mem::Ram_68k.u16[src_word_address];
-				w = Ram_68k.u16[src_word_address];
+				w = Ram_68k.u16[src_word_address & 0x7FFF];
 				break;
 
 			// TODO: Port to LibGens.
@@ -275,7 +395,7 @@ inline void VdpPrivate::T_DMA_Loop(void)
 		// Write the word.
 		// TODO: Might not work if Auto_Inc is odd...
 		vdpDataWrite_int(w);
-	} while (--length != 0);
+	}
 
 	// DMA is done.
 	VDP_Ctrl.code &= ~VdpTypes::CD_DMA_ENABLE;
@@ -300,6 +420,7 @@ inline void VdpPrivate::T_DMA_Loop(void)
 	// Update DMA.
 	int cycles = q->updateDMA();
 	M68K::ReleaseCycles(cycles);
+	notifyDmaStart();
 }
 
 /**
@@ -372,6 +493,7 @@ void VdpPrivate::processDmaCtrlWrite(void)
 			if ((dest_address & Spr_Tbl_Mask) == Spr_Tbl_Addr) {
 				// Sprite Attribute Table.
 				SprAttrTbl_m5.b[(dest_address & ~Spr_Tbl_Mask) ^ U16DATA_U8_INVERT] = src;
+				markSprIdxDirty(dest_address & ~Spr_Tbl_Mask);
 			}
 
 			// Increment the addresses.
@@ -387,6 +509,9 @@ void VdpPrivate::processDmaCtrlWrite(void)
 		// NOTE: DMA COPY uses bytes, not words.
 		inc_DMA_Src_Adr(q->DMAT_Length);	// TODO: Should DMA_Src_Adr_H's DMA flags be cleared?
 		VDP_Ctrl.address = dest_address;
+
+		// The DMA Busy flag is cleared by updateDMA().
+		notifyDmaStart();
 		return;
 	}
 
@@ -581,6 +706,8 @@ void VdpPrivate::processDmaCtrlWrite(void)
  */
 unsigned int Vdp::updateDMA(void)
 {
+	PROFILE_SCOPE(VDP_UPDATEDMA);
+
 	/**
 	 * DMA transfer rate depends on the following:
 	 * - Horizontal resolution. (H32/H40)
@@ -606,8 +733,8 @@ unsigned int Vdp::updateDMA(void)
 		offset |= 1;
 	}
 
-	// Cycles elapsed is based on M68K cycles per line.
-	unsigned int cycles = M68K_Mem::CPL_M68K;
+	// Cycles elapsed is based on the length of the current line.
+	unsigned int cycles = (M68K_Mem::Cycles_M68K - M68K_Mem::LineStart_M68K);
 
 	// DMA timing table.
 	static const uint8_t DMA_Timing_Table[4][4] = {
@@ -122,7 +122,7 @@ void Vdp::updateIRQLine(int interrupt)
 uint8_t Vdp::readHCounter(void)
 {
 	unsigned int odo_68K = M68K::ReadOdometer();
-	odo_68K -= (M68K_Mem::Cycles_M68K - M68K_Mem::CPL_M68K);
+	odo_68K -= M68K_Mem::LineStart_M68K;
 	odo_68K &= 0x1FF;
 
 	// H_Counter_Table[][0] == H32.
@@ -141,7 +141,7 @@ uint8_t Vdp::readHCounter(void)
 uint8_t Vdp::readVCounter(void)
 {
 	unsigned int odo_68K = M68K::ReadOdometer();
-	odo_68K -= (M68K_Mem::Cycles_M68K - M68K_Mem::CPL_M68K);
+	odo_68K -= M68K_Mem::LineStart_M68K;
 	odo_68K &= 0x1FF;
 
 	unsigned int H_Counter;
@@ -386,6 +386,7 @@ void VdpPrivate::vdpDataWrite_int(uint16_t data)
 			if ((address & Spr_Tbl_Mask) == Spr_Tbl_Addr) {
 				// Sprite Attribute Table.
 				SprAttrTbl_m5.w[(address & ~Spr_Tbl_Mask) >> 1] = tmp_data;
+				markSprIdxDirty(address & ~Spr_Tbl_Mask);
 			}
 			break;
 		}
@@ -99,6 +99,7 @@ VdpPalette::VdpPalette()
 	, m_bpp(MdFb::BPP_32)
 {
 	// Set the dirty flags.
+	m_dirty.data = 0;
 	m_dirty.active = true;
 	m_dirty.full = true;
 
@@ -124,6 +125,9 @@ void VdpPalette::reset(void)
 	memset(&m_cram32X, 0, sizeof(m_cram32X));
 
 	// Mark the active palette as dirty.
+	// The per-entry dirty masks are superseded.
+	memset(m_dirtyCRam, 0, sizeof(m_dirtyCRam));
+	memset(m_dirtyCRam32X, 0, sizeof(m_dirtyCRam32X));
 	m_dirty.active = true;
 }
 
@@ -221,7 +225,8 @@ void VdpPalette::setM5M4bits(uint8_t m5m4bits)
 		return;
 	d->m5m4bits = m5m4bits;
 
-	if (d->palMode == PALMODE_SMS || d->palMode == PALMODE_MD) {
+	if (d->palMode == PALMODE_SMS || d->palMode == PALMODE_MD ||
+	    d->palMode == PALMODE_32X) {
 		// Mode bits have changed.
 		// Recalculate the active palette.
 		// NOTE: Game Gear does not have a hard-coded TMS palette.
@@ -230,12 +230,22 @@ class VdpPalette
 		union {
 			uint8_t data;
 			struct {
-				bool active	:1;
-				bool full	:1;
-				// TODO: Add a separate bit for 32X CRAM.
+				bool active	:1;	// Entire active palette.
+				bool full	:1;	// Full palette.
+				bool cram	:1;	// CRam entries. (see m_dirtyCRam)
+				bool cram32X	:1;	// 32X CRam entries. (see m_dirtyCRam32X)
 			};
 		} m_dirty;
 
+		/**
+		 * Per-entry CRam dirty masks.
+		 * CRam: One bit per byte, since SMS uses 8-bit colors.
+		 * 32X CRam: One bit per 16-bit color.
+		 * These are only checked if m_dirty.active is clear.
+		 */
+		uint32_t m_dirtyCRam[(64<<1) / 32];
+		uint32_t m_dirtyCRam32X[256 / 32];
+
 		/** Active palette recalculation functions. **/
 
 		template<typename pixel>
@@ -263,6 +273,30 @@ class VdpPalette
 		template<typename pixel>
 		FORCE_INLINE void T_update_TMS9918A(pixel *palActiveTMS,
 					      const pixel *palFullTMS);
+
+		/** Incremental palette recalculation functions. **/
+
+		template<typename pixel>
+		FORCE_INLINE void T_updateDirty_MD(pixel *palActiveMD,
+					     const pixel *palFullMD);
+
+		template<typename pixel>
+		FORCE_INLINE void T_updateDirty_32X(pixel *palActive32X,
+					      const pixel *palFull32X);
+
+		template<typename pixel>
+		FORCE_INLINE void T_updateDirty_SMS(pixel *palActiveSMS,
+					      const pixel *palFullSMS);
+
+		template<typename pixel>
+		FORCE_INLINE void T_updateDirty_GG(pixel *palActiveGG,
+					     const pixel *palFullGG);
+
+		template<typename pixel>
+		FORCE_INLINE void T_update(pixel *palActive, pixel *palActive32X);
+
+		template<typename pixel>
+		FORCE_INLINE void T_updateDirty(pixel *palActive, pixel *palActive32X);
 };
 
 /**
@@ -312,8 +346,8 @@ inline void VdpPalette::writeCRam_8(uint8_t address, uint8_t data)
 	address &= cram_addr_mask;
 	// FIXME: Use U16DATA_U8_INVERT?
 	m_cram.u8[address] = data;
-	// TODO: Per-color dirty flag?
-	m_dirty.active = true;
+	m_dirtyCRam[address >> 5] |= (1U << (address & 31));
+	m_dirty.cram = true;
 }
 
 /**
@@ -328,8 +362,8 @@ inline void VdpPalette::writeCRam_16(uint8_t address, uint16_t data)
 
 	address &= cram_addr_mask;
 	m_cram.u16[address >> 1] = data;
-	// TODO: Per-color dirty flag?
-	m_dirty.active = true;
+	m_dirtyCRam[address >> 5] |= (3U << (address & 31));
+	m_dirty.cram = true;
 }
 
 /** 32X CRam functions. **/
@@ -372,8 +406,8 @@ inline void VdpPalette::writeCRam32X_8(uint16_t address, uint8_t data)
 
 	address &= 0x1FF;
 	m_cram32X.u8[address ^ U16DATA_U8_INVERT] = data;
-	// TODO: Per-color dirty flag?
-	m_dirty.active = true;
+	m_dirtyCRam32X[address >> 6] |= (1U << ((address >> 1) & 31));
+	m_dirty.cram32X = true;
 }
 
 /**
@@ -388,8 +422,8 @@ inline void VdpPalette::writeCRam32X_16(uint16_t address, uint16_t data)
 
 	address &= 0x1FF;
 	m_cram32X.u16[address >> 1] = data;
-	// TODO: Per-color dirty flag?
-	m_dirty.active = true;
+	m_dirtyCRam32X[address >> 6] |= (1U << ((address >> 1) & 31));
+	m_dirty.cram32X = true;
 }
 
 /** Properties. **/
@@ -80,35 +80,34 @@ template<typename pixel,
 	int RMask, int GMask, int BMask>
 FORCE_INLINE void VdpPalettePrivate::T_recalcFull_32X(pixel *palFull32X)
 {
-	// Calculate the 32X palette. (first half)
-	for (int i = 0x0000; i < 0x8000; i++) {
-		// Sega 32X uses 15-bit color.
-		// Scale each component by using the following algorithm:
-		// - 32X component: abcde
-		// - RGB component: abcdeabc
-		// Example: 32X 0x15 (10101) -> RGB 0xAD (10101101)
-		int r = ((i << 3) & 0x00F8);	r |= (r >> 5);
-		int g = ((i >> 2) & 0x00F8);	g |= (g >> 5);
-		int b = ((i >> 7) & 0x00F8);	b |= (b >> 5);
+	// Sega 32X uses 15-bit color. [-BBB BBGG GGGR RRRR]
+	// Scale each component by using the following algorithm:
+	// - 32X component: abcde
+	// - RGB component: abcdeabc
+	// Example: 32X 0x15 (10101) -> RGB 0xAD (10101101)
+	// The scaled components are precalculated, since
+	// each one only has 32 possible values.
+	pixel palR[32], palG[32], palB[32];
+	for (int i = 0; i < 32; i++) {
+		int c = (i << 3);	c |= (c >> 5);
 
 		// Reduce color components to original color depth.
-		r >>= (8 - RBits);
-		g >>= (8 - GBits);
-		b >>= (8 - BBits);
+		palR[i] = (pixel)((c >> (8 - RBits)) << (BBits + GBits));
+		palG[i] = (pixel)((c >> (8 - GBits)) << (BBits));
+		palB[i] = (pixel)((c >> (8 - BBits)));
+	}
 
-		// TODO: Make this configurable?
-#if 0	
-		if (GMask == 0x3F) {
-			// 16-bit color. (RGB565)
-			// Mask off the LSB of the green component.
-			g &= ~1;
+	// Calculate the 32X palette. (first half)
+	// The inner loop ORs a constant into a 32-entry
+	// table, so the compiler can vectorize it.
+	pixel *dest = palFull32X;
+	for (int b = 0; b < 32; b++) {
+		for (int g = 0; g < 32; g++, dest += 32) {
+			const pixel gb = (palG[g] | palB[b]);
+			for (int r = 0; r < 32; r++) {
+				dest[r] = (palR[r] | gb);
+			}
 		}
-#endif
-
-		// Combine the color components.
-		palFull32X[i] = (r << (BBits + GBits)) |
-				(g << (BBits)) |
-				(b);
 	}
 
 	// Copy the palette from the first half of palFull32X to the second half.
@@ -24,6 +24,9 @@
 #include "VdpPalette.hpp"
 #include "VdpPalette_p.hpp"
 
+// Profiler.
+#include "Util/Profiler.hpp"
+
 // FOR TESTING ONLY: Uncomment this #define to enable support for 4 palette lines in all modes.
 // This should not be enabled in release builds!
 //#define DO_FOUR_PALETTE_LINES_IN_ALL_MODES_FOR_LULZ
@@ -317,72 +320,269 @@ FORCE_INLINE void VdpPalette::T_update_TMS9918A(pixel *palActiveTMS,
 }
 
 /**
- * Update the active palette.
+ * Recalculate dirty entries in the active palette. (Mega Drive, Mode 5)
+ * Each CRam color has up to four derived entries:
+ * normal (0-63), shadow (64-127), highlight (128-191),
+ * and shadow+highlight (192-255).
+ * @param palActiveMD Active MD palette. (Must have 0x100 entries!)
+ * @param palFullMD Full MD palette. (Must have 0x1000 entries!)
  */
-void VdpPalette::update(void)
+template<typename pixel>
+FORCE_INLINE void VdpPalette::T_updateDirty_MD(pixel *palActiveMD,
+					 const pixel *palFullMD)
 {
-	if (m_dirty.full)
-		d->recalcFull();
-	if (!m_dirty.active)
-		return;
-	if (d->isAppOs)
-		return;
-
-	// TODO: Add an AND to each switch() for optimization?
-	if (m_bpp != MdFb::BPP_32) {
-		switch (d->palMode) {
-			case PALMODE_32X:
-				T_update_32X<uint16_t>(m_palActive32X.u16, d->palFull32X.u16);
-				// NOTE: 32X falls through to MD, since both 32X and MD palettes must be updated.
-				// TODO: Add a separate dirty flag for the 32X palette?
-				// FALLTHROUGH
-
-			case PALMODE_MD:
-			default:
-				T_update_MD<uint16_t>(m_palActive.u16, d->palFullMD.u16, d->palFullSMS.u16);
-				break;
+	// M5 is set; see T_update_MD() for the masks.
+	const uint16_t mdColorMask = ((d->m5m4bits & 0x01) ? 0xEEE : 0x222);
+	const bool sh = d->mdShadowHighlight;
+	const int bgIdx = d->maskedBgColorIdx;
+
+	for (int w = 0; w < (int)ARRAY_SIZE(m_dirtyCRam); w++) {
+		uint32_t bits = m_dirtyCRam[w];
+		// Each color is two bytes, so check two bits at a time.
+		for (int i = (w * 16); bits != 0; i++, bits >>= 2) {
+			if (!(bits & 3))
+				continue;
+
+			const uint16_t color_raw = (m_cram.u16[i] & mdColorMask);
+			const pixel color = palFullMD[color_raw];
+			pixel shadow = 0, highlight = 0;
+			if (sh) {
+				shadow = palFullMD[color_raw >> 1];
+				highlight = palFullMD[(0x888 | (color_raw >> 1)) - 0x111];
+			}
+
+			// Entry 0 in each palette line set is the background color.
+			if (i != 0) {
+				palActiveMD[i] = color;
+				if (sh) {
+					palActiveMD[i + 64]  = shadow;
+					palActiveMD[i + 128] = highlight;
+					palActiveMD[i + 192] = color;
+				}
+			}
+			if (i == bgIdx) {
+				palActiveMD[0] = color;
+				if (sh) {
+					palActiveMD[64]  = shadow;
+					palActiveMD[128] = highlight;
+					palActiveMD[192] = color;
+				}
+			}
+		}
+	}
+}
 
-			case PALMODE_SMS:
-				T_update_SMS<uint16_t>(m_palActive.u16, d->palFullSMS.u16);
-				break;
+/**
+ * Recalculate dirty entries in the active palette. (32X)
+ * @param palActive32X Active 32X palette. (Must have 0x100 entries!)
+ * @param palFull32X Full 32X palette. (Must have 0x10000 entries!)
+ */
+template<typename pixel>
+FORCE_INLINE void VdpPalette::T_updateDirty_32X(pixel *palActive32X,
+					  const pixel *palFull32X)
+{
+	for (int w = 0; w < (int)ARRAY_SIZE(m_dirtyCRam32X); w++) {
+		uint32_t bits = m_dirtyCRam32X[w];
+		for (int i = (w * 32); bits != 0; i++, bits >>= 1) {
+			if (bits & 1) {
+				palActive32X[i] = palFull32X[m_cram32X.u16[i]];
+			}
+		}
+	}
+}
 
-			case PALMODE_GG:
-				T_update_GG<uint16_t>(m_palActive.u16, d->palFullMD.u16);
-				break;
+/**
+ * Recalculate dirty entries in the active palette. (Sega Master System, Mode 4)
+ * Only called if M4 is set, since CRam isn't used otherwise.
+ * @param palActiveSMS Active SMS palette. (Must have 0x20 entries!)
+ * @param palFullSMS Full SMS palette. (Must have 0x40 entries!)
+ */
+template<typename pixel>
+FORCE_INLINE void VdpPalette::T_updateDirty_SMS(pixel *palActiveSMS,
+					  const pixel *palFullSMS)
+{
+#if !defined(DO_FOUR_PALETTE_LINES_IN_ALL_MODES_FOR_LULZ)
+	static const int color_count = 32;
+#else
+	static const int color_count = 64;
+#endif
+	const int bgIdx = d->maskedBgColorIdx;
+
+	// SMS colors are one byte each.
+	for (int w = 0; w < (color_count / 32); w++) {
+		uint32_t bits = m_dirtyCRam[w];
+		for (int i = (w * 32); bits != 0; i++, bits >>= 1) {
+			if (!(bits & 1))
+				continue;
+
+			const pixel color = palFullSMS[m_cram.u8[i] & 0x3F];
+			if (i != 0)
+				palActiveSMS[i] = color;
+			if (i == bgIdx)
+				palActiveSMS[0] = color;
+		}
+	}
+}
 
-			case PALMODE_TMS9918A:
-				T_update_TMS9918A<uint16_t>(m_palActive.u16, d->palFullSMS.u16);
-				break;
+/**
+ * Recalculate dirty entries in the active palette. (Sega Game Gear, Mode 4 [12-bit RGB])
+ * @param palActiveGG Active GG palette. (Must have 0x20 entries!)
+ * @param palFullGG Full GG palette. (Must have 0x1000 entries!)
+ */
+template<typename pixel>
+FORCE_INLINE void VdpPalette::T_updateDirty_GG(pixel *palActiveGG,
+					 const pixel *palFullGG)
+{
+#if !defined(DO_FOUR_PALETTE_LINES_IN_ALL_MODES_FOR_LULZ)
+	static const int color_count = 32;
+#else
+	static const int color_count = 64;
+#endif
+	const int bgIdx = d->maskedBgColorIdx;
+
+	// GG colors are two bytes each.
+	for (int w = 0; w < (color_count / 16); w++) {
+		uint32_t bits = m_dirtyCRam[w];
+		for (int i = (w * 16); bits != 0; i++, bits >>= 2) {
+			if (!(bits & 3))
+				continue;
+
+			const pixel color = palFullGG[m_cram.u16[i] & 0xFFF];
+			if (i != 0)
+				palActiveGG[i] = color;
+			if (i == bgIdx)
+				palActiveGG[0] = color;
 		}
-	} else {
-		switch (d->palMode) {
-			case PALMODE_32X:
-				T_update_32X<uint32_t>(m_palActive32X.u32, d->palFull32X.u32);
-				// NOTE: 32X falls through to MD, since both 32X and MD palettes must be updated.
-				// TODO: Add a separate dirty flag for the 32X palette?
-				// FALLTHROUGH
-
-			case PALMODE_MD:
-			default:
-				T_update_MD<uint32_t>(m_palActive.u32, d->palFullMD.u32, d->palFullSMS.u32);
-				break;
+	}
+}
 
-			case PALMODE_SMS:
-				T_update_SMS<uint32_t>(m_palActive.u32, d->palFullSMS.u32);
-				break;
+/**
+ * Recalculate the entire active palette.
+ * @param palActive Active palette.
+ * @param palActive32X Active 32X palette.
+ */
+template<typename pixel>
+FORCE_INLINE void VdpPalette::T_update(pixel *palActive, pixel *palActive32X)
+{
+	// NOTE: The full palettes are in the same union format as the active palettes.
+	const pixel *const palFullMD = reinterpret_cast<const pixel*>(&d->palFullMD);
+	const pixel *const palFullSMS = reinterpret_cast<const pixel*>(&d->palFullSMS);
+
+	switch (d->palMode) {
+		case PALMODE_32X:
+			T_update_32X<pixel>(palActive32X, reinterpret_cast<const pixel*>(&d->palFull32X));
+			// NOTE: 32X falls through to MD, since both 32X and MD palettes must be updated.
+			// FALLTHROUGH
+
+		case PALMODE_MD:
+		default:
+			T_update_MD<pixel>(palActive, palFullMD, palFullSMS);
+			break;
 
-			case PALMODE_GG:
-				T_update_GG<uint32_t>(m_palActive.u32, d->palFullMD.u32);
-				break;
+		case PALMODE_SMS:
+			T_update_SMS<pixel>(palActive, palFullSMS);
+			break;
+
+		case PALMODE_GG:
+			T_update_GG<pixel>(palActive, palFullMD);
+			break;
 
-			case PALMODE_TMS9918A:
-				T_update_TMS9918A<uint32_t>(m_palActive.u32, d->palFullSMS.u32);
+		case PALMODE_TMS9918A:
+			T_update_TMS9918A<pixel>(palActive, palFullSMS);
+			break;
+	}
+}
+
+/**
+ * Recalculate dirty CRam entries in the active palette.
+ * @param palActive Active palette.
+ * @param palActive32X Active 32X palette.
+ */
+template<typename pixel>
+FORCE_INLINE void VdpPalette::T_updateDirty(pixel *palActive, pixel *palActive32X)
+{
+	const pixel *const palFullMD = reinterpret_cast<const pixel*>(&d->palFullMD);
+	const pixel *const palFullSMS = reinterpret_cast<const pixel*>(&d->palFullSMS);
+
+	switch (d->palMode) {
+		case PALMODE_32X:
+			if (m_dirty.cram32X) {
+				T_updateDirty_32X<pixel>(palActive32X,
+					reinterpret_cast<const pixel*>(&d->palFull32X));
+			}
+			// FALLTHROUGH
+
+		case PALMODE_MD:
+		default:
+			if (!m_dirty.cram)
 				break;
+			if (d->m5m4bits & 0x02) {
+				// Mode 5.
+				T_updateDirty_MD<pixel>(palActive, palFullMD);
+			} else {
+				// Mode 4 or blank screen. Rarely used.
+				T_update_MD<pixel>(palActive, palFullMD, palFullSMS);
+			}
+			break;
+
+		case PALMODE_SMS:
+			// If M4 is clear, the TMS9918A palette is used,
+			// so CRam changes don't affect the active palette.
+			if (m_dirty.cram && (d->m5m4bits & 0x01)) {
+				T_updateDirty_SMS<pixel>(palActive, palFullSMS);
+			}
+			break;
+
+		case PALMODE_GG:
+			if (m_dirty.cram) {
+				T_updateDirty_GG<pixel>(palActive, palFullMD);
+			}
+			break;
+
+		case PALMODE_TMS9918A:
+			// TMS9918A doesn't use CRam.
+			break;
+	}
+}
+
+/**
+ * Update the active palette.
+ * If only a few CRam entries have changed, only
+ * those entries (and their derived entries) are updated.
+ */
+void VdpPalette::update(void)
+{
+	if (!isDirty())
+		return;
+	PROFILE_SCOPE(PALETTE_RECALC);
+
+	if (m_dirty.full)
+		d->recalcFull();
+	// NOTE: App-based OS palettes don't use CRam.
+	if (!d->isAppOs) {
+		if (m_dirty.active) {
+			// Recalculate the entire active palette.
+			if (m_bpp != MdFb::BPP_32) {
+				T_update<uint16_t>(m_palActive.u16, m_palActive32X.u16);
+			} else {
+				T_update<uint32_t>(m_palActive.u32, m_palActive32X.u32);
+			}
+		} else {
+			// Only recalculate the dirty CRam entries.
+			if (m_bpp != MdFb::BPP_32) {
+				T_updateDirty<uint16_t>(m_palActive.u16, m_palActive32X.u16);
+			} else {
+				T_updateDirty<uint32_t>(m_palActive.u32, m_palActive32X.u32);
+			}
 		}
 	}
 
-	// Clear the active palette dirty bit.
+	// Clear the active palette dirty bits.
+	memset(m_dirtyCRam, 0, sizeof(m_dirtyCRam));
+	memset(m_dirtyCRam32X, 0, sizeof(m_dirtyCRam32X));
 	m_dirty.active = false;
+	m_dirty.cram = false;
+	m_dirty.cram32X = false;
 }
 
 // TODO: Port to LibGens: T_update_32X()
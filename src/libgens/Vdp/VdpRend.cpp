@@ -29,6 +29,12 @@
 // Vdp private class.
 #include "Vdp_p.hpp"
 
+// Profiler.
+#include "Util/Profiler.hpp"
+
+// Frame signatures.
+#include "Util/XXHash64.hpp"
+
 namespace LibGens {
 
 /**
@@ -39,6 +45,10 @@ void VdpPrivate::rend_init(void)
 {
 	// Initialize the VDP rendering variables.
 	VDP_Layers = VdpTypes::VDP_LAYERS_DEFAULT;
+
+	// Frame signatures.
+	lineSigFb = nullptr;
+	invalidateLineSigs();
 }
 
 /**
@@ -58,6 +68,7 @@ void VdpPrivate::rend_reset(void)
 {
 	// Clear MD_Screen.
 	q->MD_Screen->clear();
+	invalidateLineSigs();
 
 	// Reset the active palettes.
 	// TODO: Handle VDP_LAYER_PALETTE_LOCK in VdpPalette.
@@ -73,15 +84,59 @@ void VdpPrivate::rend_reset(void)
 	memset(sprLineCache, 0, sizeof(sprLineCache));
 	memset(sprCountCache, 0, sizeof(sprCountCache));
 
+	// Sprite index. (Mode 5)
+	// This will be rebuilt on the next line.
+	memset(sprIdx_dirty, 0, sizeof(sprIdx_dirty));
+	sprIdx_count = 0;
+	sprIdx_maxSprFrame = 0;
+	sprIdx_interlaced = false;
+	sprIdx_valid = false;
+
 	// Sprite dot overflow flag.
 	sprDotOverflow = false;
 }
 
+/**
+ * Invalidate all line signatures.
+ * The next rendered frame will be written in full.
+ */
+void VdpPrivate::invalidateLineSigs(void)
+{
+	memset(lineSig, 0, sizeof(lineSig));
+	palSigValid = false;
+}
+
+/**
+ * Get the rendering state seed for line signatures.
+ * This includes the palette signature, so the
+ * active palette must be up to date.
+ * @return Line signature seed.
+ */
+uint64_t VdpPrivate::lineSigSeed(void)
+{
+	if (!palSigValid) {
+		// Active palette has changed.
+		palSig = XXHash64::hash(&palette.m_palActive, sizeof(palette.m_palActive));
+		palSigValid = true;
+	}
+
+	// Everything other than LineBuf that affects
+	// the pixels written to MD_Screen.
+	const uint32_t state = (uint32_t)H_Pix |
+			       ((uint32_t)H_Pix_Begin << 10) |
+			       ((uint32_t)!!(VDP_Reg.m5.Set1 & VDP_REG_M5_SET1_LCB) << 20) |
+			       (q->options.borderColorEmulation ? (1U << 21) : 0) |
+			       ((uint32_t)q->MD_Screen->bpp() << 22);
+	return XXHash64::hash(&state, sizeof(state), palSig);
+}
+
 /**
  * Render a line.
  */
 void Vdp::renderLine(void)
 {
+	PROFILE_SCOPE(VDP_RENDERLINE);
+
 	// TODO: 32X-specific function.
 	if (d->VDP_Mode & VdpTypes::VDP_MODE_M5) {
 		// Mode 5.
@@ -102,4 +157,34 @@ void Vdp::renderLine(void)
 	d->updateErr();
 }
 
+/**
+ * Get the signature of the current MD_Screen contents.
+ *
+ * The signature is built from the per-line signatures computed
+ * during renderLine(), so it's cheap to calculate. If two
+ * calls return the same value, MD_Screen has not changed in
+ * between, and the frontend can skip uploading it.
+ *
+ * NOTE: Writes to MD_Screen from outside of the VDP are not
+ * tracked. Call invalidateFrameSignature() after doing that.
+ *
+ * @return Frame signature.
+ */
+uint64_t Vdp::frameSignature(void) const
+{
+	int lines = MD_Screen->numLines();
+	if (lines > VdpPrivate::LINE_SIG_MAX)
+		lines = VdpPrivate::LINE_SIG_MAX;
+	return XXHash64::hash(d->lineSig, lines * sizeof(d->lineSig[0]));
+}
+
+/**
+ * Invalidate the frame signature.
+ * The next frame will be written to MD_Screen in full.
+ */
+void Vdp::invalidateFrameSignature(void)
+{
+	d->invalidateLineSigs();
+}
+
 }
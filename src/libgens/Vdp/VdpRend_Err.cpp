@@ -30,6 +30,9 @@
 #include "VdpPalette.hpp"
 #include "VGA_charset.h"
 
+// Frame signatures.
+#include "Util/XXHash64.hpp"
+
 // Private classes.
 #include "Vdp_p.hpp"
 #include "VdpRend_Err_p.hpp"
@@ -452,6 +455,18 @@ void VdpPrivate::renderLine_Err(void)
 		// Save the new border color.
 		d_err->lastBorderColor = newBorderColor;
 	}
+
+	// Line signatures don't apply to the error screen.
+	// Store a single signature for the whole screen so
+	// frameSignature() changes whenever it's redrawn.
+	const uint32_t errState[4] = {
+		(uint32_t)VDP_Mode,
+		(uint32_t)((q->getHPix() << 16) | q->getVPix()),
+		(uint32_t)palette.bpp(),
+		newBorderColor
+	};
+	invalidateLineSigs();
+	lineSig[0] = XXHash64::hash(errState, sizeof(errState));
 }
 
 /**
@@ -27,6 +27,9 @@
 // M68K_Mem::ms_Region is needed for region detection.
 #include "cpu/M68K_Mem.hpp"
 
+// Frame signatures.
+#include "Util/XXHash64.hpp"
+
 // C includes. (C++ namespace)
 #include <cstring>
 
@@ -900,6 +903,192 @@ FORCE_INLINE void VdpPrivate::T_Render_Line_ScrollA_Window(void)
 	}
 }
 
+/**
+ * Count trailing zeroes in a 32-bit value.
+ * @param x Value. (must not be 0)
+ * @return Number of trailing zeroes.
+ */
+static FORCE_INLINE int sprIdx_ctz(uint32_t x)
+{
+#if defined(__GNUC__)
+	return __builtin_ctz(x);
+#else
+	int n = 0;
+	while (!(x & 1)) {
+		x >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+/**
+ * Decode a sprite index entry from the SAT cache.
+ * @param interlaced If true, using Interlaced Mode 2. (2x res)
+ * @param entry	[out] Sprite index entry.
+ * @param spr_SAT	[in] SAT cache entry.
+ */
+template<bool interlaced>
+FORCE_INLINE void VdpPrivate::T_Decode_Sprite_Index_Entry(SprIdxEntry_t *entry,
+				const VdpStructs::SprEntry_m5 *spr_SAT)
+{
+	int y = spr_SAT->y;
+	int height = (spr_SAT->sz & 3);
+	if (interlaced) {
+		y = (y & 0x3FF) - 256;
+		height = (height * 16) + 15;
+	} else {
+		y = (y & 0x1FF) - 128;
+		height = (height * 8) + 7;
+	}
+
+	entry->y = y;
+	entry->y_max = y + height;	// height is already -1
+	entry->sz = spr_SAT->sz;
+}
+
+/**
+ * Set or clear a chain position's bit in the sprite index lines.
+ * @param interlaced If true, using Interlaced Mode 2. (2x res)
+ * @param pos Chain position.
+ * @param set If true, set the bit; otherwise, clear it.
+ */
+template<bool interlaced>
+inline void VdpPrivate::T_Set_Sprite_Index_Lines(int pos, bool set)
+{
+	const SprIdxEntry_t *const entry = &sprIdx_chain[pos];
+	int y = entry->y;
+	int y_max = entry->y_max;
+	if (y < 0)
+		y = 0;
+	if (y_max >= SPR_IDX_LINES)
+		y_max = SPR_IDX_LINES - 1;
+
+	const int word = (pos >> 5);
+	const uint32_t bit = (1U << (pos & 31));
+	if (set) {
+		for (; y <= y_max; y++) {
+			sprIdx_lines[y][word] |= bit;
+		}
+	} else {
+		for (; y <= y_max; y++) {
+			sprIdx_lines[y][word] &= ~bit;
+		}
+	}
+}
+
+/**
+ * Rebuild the sprite index from the SAT cache.
+ * @param interlaced If true, using Interlaced Mode 2. (2x res)
+ * @param max_spr_frame Maximum number of sprites per frame.
+ */
+template<bool interlaced>
+void VdpPrivate::T_Rebuild_Sprite_Index_m5(uint8_t max_spr_frame)
+{
+	memset(sprIdx_lines, 0, sizeof(sprIdx_lines));
+
+	// Walk the link chain.
+	// NOTE: The chain may loop, in which case a sprite
+	// can appear more than once, same as on hardware.
+	uint8_t link = 0;
+	int pos = 0;
+	do {
+		const VdpStructs::SprEntry_m5 *spr_SAT = &SprAttrTbl_m5.spr[link];
+		SprIdxEntry_t *const entry = &sprIdx_chain[pos];
+		T_Decode_Sprite_Index_Entry<interlaced>(entry, spr_SAT);
+		entry->num = link;
+		T_Set_Sprite_Index_Lines<interlaced>(pos, true);
+		pos++;
+
+		// Link field.
+		// NOTE: Link field is 7-bit. Usually this won't cause a problem,
+		// since most games won't set the high bit.
+		// Dino Land incorrectly sets the high bit on some sprites,
+		// so we have to mask it off.
+		link = spr_SAT->link & 0x7F;
+		entry->link = link;
+		if (link == 0 || link >= max_spr_frame)
+			break;
+	} while (pos < max_spr_frame);
+
+	sprIdx_count = pos;
+	sprIdx_maxSprFrame = max_spr_frame;
+	sprIdx_interlaced = interlaced;
+	sprIdx_valid = true;
+	memset(sprIdx_dirty, 0, sizeof(sprIdx_dirty));
+}
+
+/**
+ * Update the sprite index for dirty SAT cache entries.
+ * @param interlaced If true, using Interlaced Mode 2. (2x res)
+ * @param max_spr_frame Maximum number of sprites per frame.
+ */
+template<bool interlaced>
+inline void VdpPrivate::T_Update_Sprite_Index_m5(uint8_t max_spr_frame)
+{
+	if (!sprIdx_valid || sprIdx_interlaced != interlaced ||
+	    sprIdx_maxSprFrame != max_spr_frame)
+	{
+		// Index parameters have changed.
+		T_Rebuild_Sprite_Index_m5<interlaced>(max_spr_frame);
+		return;
+	}
+
+	if (!(sprIdx_dirty[0] | sprIdx_dirty[1] | sprIdx_dirty[2] | sprIdx_dirty[3])) {
+		// Nothing has changed.
+		return;
+	}
+
+	for (int pos = 0; pos < sprIdx_count; pos++) {
+		SprIdxEntry_t *const entry = &sprIdx_chain[pos];
+		const unsigned int num = entry->num;
+		if (!(sprIdx_dirty[num >> 5] & (1U << (num & 31))))
+			continue;
+
+		const VdpStructs::SprEntry_m5 *spr_SAT = &SprAttrTbl_m5.spr[num];
+		if ((spr_SAT->link & 0x7F) != entry->link) {
+			// The link chain has changed.
+			T_Rebuild_Sprite_Index_m5<interlaced>(max_spr_frame);
+			return;
+		}
+
+		// Y position and/or size may have changed.
+		SprIdxEntry_t tmp;
+		T_Decode_Sprite_Index_Entry<interlaced>(&tmp, spr_SAT);
+		if (tmp.y != entry->y || tmp.y_max != entry->y_max) {
+			T_Set_Sprite_Index_Lines<interlaced>(pos, false);
+			entry->y = tmp.y;
+			entry->y_max = tmp.y_max;
+			T_Set_Sprite_Index_Lines<interlaced>(pos, true);
+		}
+		entry->sz = tmp.sz;
+	}
+
+	memset(sprIdx_dirty, 0, sizeof(sprIdx_dirty));
+}
+
+/**
+ * Add a sprite to the Sprite Line Cache.
+ * @param cache Sprite Line Cache entry.
+ * @param spr Sprite index entry.
+ */
+FORCE_INLINE void VdpPrivate::T_Add_Sprite_Line_Cache_m5(SprLineCache_t *cache, const SprIdxEntry_t *spr)
+{
+	// Get the remaining sprite information from VRAM.
+	const VdpStructs::SprEntry_m5 *spr_VRam = Spr_Tbl_Addr_PtrM5(spr->num);
+
+	// Save the sprite information in the line cache.
+	cache->Pos_X = (spr_VRam->x & 0x1FF) - 128;
+	cache->Pos_Y = spr->y;
+	// NOTE: Size_? is in units of cells, not pixels.
+	cache->Size_X = ((spr->sz >> 2) & 3) + 1;	// 1 more than the original value.
+	cache->Size_Y = (spr->sz & 3);			// Exactly the original value.
+	// Pos_Y_Max is in units of pixels.
+	cache->Pos_Y_Max = spr->y_max;
+	// Tile number. (Also includes palette, priority, and flip bits.)
+	cache->Num_Tile = spr_VRam->attr;
+}
+
 /**
  * Update the Sprite Line Cache for the next line.
  * Wrapper function to handle interlacing.
@@ -933,7 +1122,6 @@ unsigned int VdpPrivate::T_Update_Sprite_Line_Cache_m5(int line)
 	// is used in Vdp.cpp. gcc-5.1 fails in release builds due to
 	// the function definition not being available there.
 	unsigned int ret = 0;
-	uint8_t link = 0;
 
 	// Determine the maximum number of sprites.
 	// NOTE: Max sprites per frame is always limited
@@ -981,79 +1169,55 @@ unsigned int VdpPrivate::T_Update_Sprite_Line_Cache_m5(int line)
 	uint8_t count = 0;
 
 	/**
-	 * The following values are read from the cached
-	 * Sprite Attribute Table instead of VRAM:
+	 * The following values are read from the sprite index,
+	 * which is built from the cached Sprite Attribute Table:
 	 * - Y position
 	 * - Sprite size
 	 * - Link number
 	 */
-	const VdpStructs::SprEntry_m5 *spr_SAT = &SprAttrTbl_m5.spr[0];
+	T_Update_Sprite_Index_m5<interlaced>(max_spr_frame);
 
 	// Process up to max_spr_line sprites.
 	// (16 in H32, 20 in H40.)
-	int total_spr_count = max_spr_frame;
-	do {
-		// Check the Y position.
-		int y = spr_SAT->y;
-		if (interlaced) {
-			y = (y & 0x3FF) - 256;
-		} else {
-			y = (y & 0x1FF) - 128;
-		}
+	if (line >= 0 && line < SPR_IDX_LINES) {
+		// Only check sprites that are visible on this line.
+		// Bits are in link chain order.
+		const uint32_t *lineBits = sprIdx_lines[line];
+		for (int i = 0; i < 3; i++) {
+			uint32_t bits = lineBits[i];
+			while (bits != 0) {
+				const int pos = (i << 5) + sprIdx_ctz(bits);
+				bits &= (bits - 1);
 
-		if (line >= y) {
-			// Calculate the sprite's height.
-			const uint8_t sz = spr_SAT->sz;
-			int height = (sz & 3);
-			if (interlaced) {
-				height = (height * 16) + 15;
-			} else {
-				height = (height * 8) + 7;
+				if (count == max_spr_line) {
+					// Sprite overflow!
+					ret = VdpStatus::VDP_STATUS_SOVR;
+					goto done;
+				}
+				T_Add_Sprite_Line_Cache_m5(cache, &sprIdx_chain[pos]);
+				count++;
+				cache++;
 			}
-
-			// Check if the bottom of the sprite is in range.
-			const int y_max = y + height;	// height is already -1
-			if (line <= y_max) {
-				// Sprite is in range.
+		}
+	} else {
+		// Line is outside of the index.
+		// Check the link chain directly.
+		for (int pos = 0; pos < sprIdx_count; pos++) {
+			const SprIdxEntry_t *const spr = &sprIdx_chain[pos];
+			if (line >= spr->y && line <= spr->y_max) {
 				if (count == max_spr_line) {
 					// Sprite overflow!
 					ret = VdpStatus::VDP_STATUS_SOVR;
 					break;
 				}
-
-				// Get the remaining sprite information from VRAM.
-				const VdpStructs::SprEntry_m5 *spr_VRam = Spr_Tbl_Addr_PtrM5(link);
-
-				// Save the sprite information in the line cache.
-				cache->Pos_X = (spr_VRam->x & 0x1FF) - 128;
-				cache->Pos_Y = y;
-				// NOTE: Size_? is in units of cells, not pixels.
-				cache->Size_X = ((sz >> 2) & 3) + 1;	// 1 more than the original value.
-				cache->Size_Y = (sz & 3);		// Exactly the original value.
-				// Pos_Y_Max is in units of pixels.
-				cache->Pos_Y_Max = y_max;
-				// Tile number. (Also includes palette, priority, and flip bits.)
-				cache->Num_Tile = spr_VRam->attr;
-
-				// Added a sprite.
+				T_Add_Sprite_Line_Cache_m5(cache, spr);
 				count++;
 				cache++;
 			}
 		}
+	}
 
-		// Link field.
-		// NOTE: Link field is 7-bit. Usually this won't cause a problem,
-		// since most games won't set the high bit.
-		// Dino Land incorrectly sets the high bit on some sprites,
-		// so we have to mask it off.
-		link = spr_SAT->link & 0x7F;
-		if (link == 0 || link >= max_spr_frame)
-			break;
-
-		// Get the next sprite address in the SAT.
-		spr_SAT = &SprAttrTbl_m5.spr[link];
-	} while (--total_spr_count);
-
+done:
 	// Save the sprite count for the next line.
 	sprCountCache[cacheId] = count;
 
@@ -1366,6 +1530,28 @@ FORCE_INLINE void VdpPrivate::T_Apply_SMS_LCB(pixel *dest, pixel border_color)
 	*(dest+7) = border_color;
 }
 
+/**
+ * Check and update a line signature.
+ * @param lineNum MD_Screen line number.
+ * @param sig New line signature.
+ * @return True if the line is unchanged and can be skipped.
+ */
+FORCE_INLINE bool VdpPrivate::checkLineSig(int lineNum, uint64_t sig)
+{
+	if (lineSigFb != q->MD_Screen) {
+		// MD_Screen was replaced.
+		invalidateLineSigs();
+		lineSigFb = q->MD_Screen;
+	}
+
+	if (lineNum < 0 || lineNum >= LINE_SIG_MAX)
+		return false;
+	if (lineSig[lineNum] == sig)
+		return true;
+	lineSig[lineNum] = sig;
+	return false;
+}
+
 /**
  * Render a line. (Mode 5)
  */
@@ -1426,7 +1612,10 @@ void VdpPrivate::renderLine_m5(void)
 	if (in_border && !q->options.borderColorEmulation) {
 		// We're in the border area, but border color emulation is disabled.
 		// Clear the border area.
-		// TODO: Only clear this if the option changes or V/H mode changes.
+		// The signature only depends on the framebuffer format here.
+		if (checkLineSig(lineNum, ~(uint64_t)q->MD_Screen->bpp()))
+			return;
+
 		if (palette.bpp() != MdFb::BPP_32) {
 			memset(q->MD_Screen->lineBuf16(lineNum), 0x00,
 				(q->MD_Screen->pxPerLine() * sizeof(uint16_t)));
@@ -1493,13 +1682,27 @@ void VdpPrivate::renderLine_m5(void)
 	// FIXME: If palette is locked and bpp is changed, convert it.
 	if (!(VDP_Layers & VdpTypes::VDP_LAYER_PALETTE_LOCK)) {
 		if (!q->options.updatePaletteInVBlankOnly || in_border) {
+			// NOTE: setBpp() only marks the palette as dirty,
+			// so update() is needed afterwards to avoid rendering
+			// this line with the old color depth's palette.
 			if (palette.bpp() != q->MD_Screen->bpp())
 				palette.setBpp(q->MD_Screen->bpp());
-			else
+			if (palette.isDirty()) {
 				palette.update();
+				palSigValid = false;
+			}
 		}
 	}
 
+	// If the line buffer, palette, and rendering state are the
+	// same as the last time this line was rendered, MD_Screen
+	// already has the correct pixels.
+	// NOTE: Only the visible part of LineBuf is hashed.
+	const uint64_t sig = XXHash64::hash(&LineBuf.px[8],
+			H_Pix * sizeof(LineBuf.px[0]), lineSigSeed());
+	if (checkLineSig(lineNum, sig))
+		return;
+
 	// Render the image.
 	// TODO: Optimize SMS LCB handling. (maybe use Linux's unlikely() macro?)
 	if (q->MD_Screen->bpp() != MdFb::BPP_32) {
@@ -406,11 +406,26 @@ class VdpPrivate
 		// NOTE: This needs to be a macro, since it's used in case statements.
 		#define DMA_TYPE(src, dest) (((int)src << 2) | ((int)dest))
 
+		template<DMA_Src_t src_component, DMA_Dest_t dest_component>
+		inline int T_DMA_Bulk(uint16_t *src_word_address,
+				      unsigned int src_base_address, int length);
+
 		template<DMA_Src_t src_component, DMA_Dest_t dest_component>
 		inline void T_DMA_Loop(void);
 
 		void processDmaCtrlWrite(void);
 
+		/**
+		 * Notify the emulation loop that a DMA operation
+		 * needs to be continued on the next line.
+		 */
+		inline void notifyDmaStart(void)
+		{
+			if (q->DMAT_Length > 0 && q->m_dmaStartFn) {
+				q->m_dmaStartFn(q->m_dmaStartParam);
+			}
+		}
+
 	/*!**************************************************************
 	 * VdpRend: Rendering functions and variables.                  *
 	 ****************************************************************/
@@ -447,6 +462,42 @@ class VdpPrivate
 		};
 		LineBuf_t LineBuf;
 
+		/**
+		 * Frame signatures.
+		 * Each MD_Screen line has a 64-bit signature computed from
+		 * the line buffer, the active palette, and the rendering state.
+		 * If a line's signature matches the one stored for that line,
+		 * MD_Screen already has the correct pixels, so the
+		 * LineBuf-to-MD_Screen conversion can be skipped.
+		 */
+		static const int LINE_SIG_MAX = 256;
+		uint64_t lineSig[LINE_SIG_MAX];
+		const MdFb *lineSigFb;	// MD_Screen that lineSig[] describes.
+		uint64_t palSig;	// Signature of palette.m_palActive.
+		bool palSigValid;
+
+		/**
+		 * Invalidate all line signatures.
+		 * The next rendered frame will be written in full.
+		 */
+		void invalidateLineSigs(void);
+
+		/**
+		 * Check and update a line signature.
+		 * @param lineNum MD_Screen line number.
+		 * @param sig New line signature.
+		 * @return True if the line is unchanged and can be skipped.
+		 */
+		FORCE_INLINE bool checkLineSig(int lineNum, uint64_t sig);
+
+		/**
+		 * Get the rendering state seed for line signatures.
+		 * This includes the palette signature, so the
+		 * active palette must be up to date.
+		 * @return Line signature seed.
+		 */
+		uint64_t lineSigSeed(void);
+
 		template<bool hs, typename pixel>
 		inline void T_Update_Palette(pixel *MD_palette, const pixel *palette);
 
@@ -513,6 +564,69 @@ class VdpPrivate
 		// Includes both the current line and the next line.
 		uint8_t sprCountCache[2];
 
+		/**
+		 * Sprite index. (Mode 5)
+		 * The SAT cache's link chain is flattened into sprIdx_chain[],
+		 * and sprIdx_lines[] has one bit per chain position for each
+		 * line the sprite covers. This lets the sprite line cache be
+		 * filled without walking the link chain on every line.
+		 *
+		 * The index is updated lazily. Writes to the SAT cache mark
+		 * the sprite as dirty; link changes require a full rebuild.
+		 */
+		struct SprIdxEntry_t {
+			int16_t y;		// Top line. (adjusted)
+			int16_t y_max;		// Bottom line. (adjusted)
+			uint8_t num;		// Sprite number in the SAT.
+			uint8_t sz;		// Sprite size. (----hhvv)
+			uint8_t link;		// Link field. (masked)
+			uint8_t reserved;
+		};
+		SprIdxEntry_t sprIdx_chain[80];
+
+		// Lines covered by the index. (2x for Interlaced Mode 2)
+		// Lines outside of this range use sprIdx_chain[] directly.
+		static const int SPR_IDX_LINES = 1024;
+		uint32_t sprIdx_lines[SPR_IDX_LINES][3];	// 80 bits per line
+
+		uint32_t sprIdx_dirty[4];	// Dirty SAT cache entries. (1 bit per sprite)
+		uint8_t sprIdx_count;		// Number of sprites in the chain.
+		uint8_t sprIdx_maxSprFrame;	// Maximum sprites per frame when the index was built.
+		bool sprIdx_interlaced;		// Interlaced Mode 2 when the index was built.
+		bool sprIdx_valid;		// If false, the index must be rebuilt.
+
+		/**
+		 * Mark a sprite in the SAT cache as dirty.
+		 * @param sat_offset Byte offset in the SAT cache.
+		 */
+		inline void markSprIdxDirty(unsigned int sat_offset)
+		{
+			const unsigned int num = (sat_offset >> 3) & 0x7F;
+			sprIdx_dirty[num >> 5] |= (1U << (num & 31));
+		}
+
+		/**
+		 * Mark a range of sprites in the SAT cache as dirty.
+		 * @param sat_offset Byte offset in the SAT cache.
+		 * @param length Length, in bytes.
+		 */
+		inline void markSprIdxDirty(unsigned int sat_offset, unsigned int length)
+		{
+			if (length == 0)
+				return;
+			const unsigned int last = (sat_offset + length - 1) >> 3;
+			for (unsigned int num = (sat_offset >> 3); num <= last; num++) {
+				sprIdx_dirty[(num >> 5) & 3] |= (1U << (num & 31));
+			}
+		}
+
+		/**
+		 * Invalidate the sprite index.
+		 * This must be called if the SAT cache is replaced.
+		 */
+		inline void invalidateSprIdx(void)
+			{ sprIdx_valid = false; }
+
 	/*!*****************************************
 	 * VdpRend_m5: Mode 5 rendering functions. *
 	 *******************************************/
@@ -567,6 +681,21 @@ class VdpPrivate
 		template<bool interlaced, bool vscroll, bool h_s>
 		FORCE_INLINE void T_Render_Line_ScrollA_Window(void);
 
+		template<bool interlaced>
+		static FORCE_INLINE void T_Decode_Sprite_Index_Entry(SprIdxEntry_t *entry,
+					const VdpStructs::SprEntry_m5 *spr_SAT);
+
+		template<bool interlaced>
+		inline void T_Set_Sprite_Index_Lines(int pos, bool set);
+
+		template<bool interlaced>
+		void T_Rebuild_Sprite_Index_m5(uint8_t max_spr_frame);
+
+		template<bool interlaced>
+		inline void T_Update_Sprite_Index_m5(uint8_t max_spr_frame);
+
+		FORCE_INLINE void T_Add_Sprite_Line_Cache_m5(SprLineCache_t *cache, const SprIdxEntry_t *spr);
+
 		FORCE_INLINE void Update_Sprite_Line_Cache_m5(int line);
 
 		// FIXME: FORCE_INLINE cannot be used here because this function
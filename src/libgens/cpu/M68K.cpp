@@ -120,6 +120,12 @@ STARSCREAM_DATAREGION M68K::M68K_Write_Word[3] =
 // Last system ID.
 M68K::SysID M68K::ms_LastSysID = SYSID_NONE;
 
+// Idle loop detection.
+// Disabled by default until it's been verified
+// against more games. (Z80 skipping is enabled.)
+bool M68K::ms_IdleLoopSkip = false;
+unsigned int M68K::ms_IdleCycles = 0;
+
 /**
  * Reset handler.
  * TODO: What does this function do?
@@ -220,6 +226,7 @@ void M68K::EndSys(void)
  */
 void M68K::UpdateSysBanking(void)
 {
+#ifdef GENS_ENABLE_EMULATION
 	// Start at M68K_Fetch[0x20].
 	int cur_fetch = 0x20;
 	switch (ms_LastSysID) {
@@ -275,8 +282,309 @@ void M68K::UpdateSysBanking(void)
 
 	// FIXME: Make sure Starscream's internal program counter
 	// is updated to reflect the updated M68K_Fetch[].
+#endif /* GENS_ENABLE_EMULATION */
+}
+
+/** Idle loop detection. **/
+
+#ifdef GENS_ENABLE_EMULATION
+/**
+ * Maximum number of instructions in an idle loop.
+ */
+static const int IDLE_LOOP_MAX_INSNS = 8;
+
+/**
+ * Can the M68K read from an address in an idle loop?
+ * The value must not change while the M68K is running,
+ * and reading it must not have side effects that change
+ * from one read to the next.
+ * @param address Address.
+ * @param size Access size, in bytes.
+ * @return True if the address is OK; false if not.
+ */
+static inline bool IdleLoopReadOK(uint32_t address, int size)
+{
+	address &= 0xFFFFFF;
+	if (size > 1 && (address & 1)) {
+		// Address error.
+		return false;
+	}
+
+	// 0xE00000-0xFFFFFF: M68K RAM.
+	// 0xC00004-0xC00007: VDP status register.
+	// NOTE: Reading the VDP status register toggles the
+	// FIFO flags, so the loop might only repeat every
+	// two iterations. SkipIdleLoop() handles this.
+	return (address >= 0xE00000 ||
+		(address >= 0xC00004 && address + size <= 0xC00008));
+}
+
+/**
+ * Decode an effective address for an idle loop.
+ * Only Dn, (An), d16(An), abs.w, abs.l, and #imm are allowed.
+ * @param ea Mode and register bits from the opcode.
+ * @param size Access size, in bytes.
+ * @param allowImm If true, allow immediate data.
+ * @param pc [in/out] Address of the extension words.
+ * @return True if allowed; false if not.
+ */
+static bool IdleLoopEA(unsigned int ea, int size, bool allowImm, uint32_t &pc)
+{
+	const unsigned int mode = (ea >> 3) & 7;
+	const unsigned int reg = (ea & 7);
+	uint32_t address;
+
+	switch (mode) {
+		case 0:
+			// Dn
+			return true;
+		case 2:
+			// (An)
+			address = main68k_context.areg[reg];
+			break;
+		case 5:
+			// d16(An)
+			address = main68k_context.areg[reg] + (int16_t)M68K_Mem::M68K_RW(pc);
+			pc += 2;
+			break;
+		case 7:
+			switch (reg) {
+				case 0:
+					// abs.w
+					address = (int16_t)M68K_Mem::M68K_RW(pc);
+					pc += 2;
+					break;
+				case 1:
+					// abs.l
+					address = (M68K_Mem::M68K_RW(pc) << 16) | M68K_Mem::M68K_RW(pc + 2);
+					pc += 4;
+					break;
+				case 4:
+					// #imm
+					if (!allowImm)
+						return false;
+					pc += (size == 4 ? 4 : 2);
+					return true;
+				default:
+					return false;
+			}
+			break;
+		default:
+			return false;
+	}
+
+	return IdleLoopReadOK(address, size);
 }
 
+/**
+ * Get the length of the idle loop at the current PC.
+ *
+ * An idle loop is a short loop of TST, BTST, CMP, CMPI,
+ * MOVE <ea>,Dn, AND, and Bcc instructions that only reads
+ * from M68K RAM or the VDP status register. Conditional
+ * branches are assumed to be taken if they go backwards;
+ * the loop must lead back to PC.
+ *
+ * @return Number of instructions in the loop, or 0 if not an idle loop.
+ */
+int M68K::IdleLoopLength(void)
+{
+	const uint32_t start = (main68k_context.pc & 0xFFFFFF);
+	uint32_t pc = start;
+
+	for (int n = 1; n <= IDLE_LOOP_MAX_INSNS; n++) {
+		// Loop code must be in ROM or RAM.
+		if (pc >= 0x400000 && pc < 0xE00000)
+			return 0;
+
+		const uint32_t insn = pc;
+		const uint16_t op = M68K_Mem::M68K_RW(pc);
+		pc += 2;
+
+		// Size field for most instructions. (0 == byte, 1 == word, 2 == long)
+		static const uint8_t sizes[4] = {1, 2, 4, 0};
+		const int size = sizes[(op >> 6) & 3];
+
+		if (op == 0x4E71) {
+			// NOP
+		} else if ((op & 0xFF00) == 0x4A00 && size != 0) {
+			// TST.s <ea>
+			if (!IdleLoopEA(op & 0x3F, size, false, pc))
+				return 0;
+		} else if ((op & 0xF1C0) == 0x0100) {
+			// BTST Dn,<ea>
+			if (!IdleLoopEA(op & 0x3F, 1, false, pc))
+				return 0;
+		} else if ((op & 0xFFC0) == 0x0800) {
+			// BTST #n,<ea>
+			pc += 2;
+			if (!IdleLoopEA(op & 0x3F, 1, false, pc))
+				return 0;
+		} else if ((op & 0xF100) == 0xB000 && size != 0) {
+			// CMP.s <ea>,Dn
+			if (!IdleLoopEA(op & 0x3F, size, true, pc))
+				return 0;
+		} else if ((op & 0xFF00) == 0x0C00 && size != 0) {
+			// CMPI.s #imm,<ea>
+			pc += (size == 4 ? 4 : 2);
+			if (!IdleLoopEA(op & 0x3F, size, false, pc))
+				return 0;
+		} else if ((op & 0xC1C0) == 0x0000 && (op & 0x3000) != 0) {
+			// MOVE.s <ea>,Dn
+			static const uint8_t move_sizes[4] = {0, 1, 4, 2};
+			if (!IdleLoopEA(op & 0x3F, move_sizes[(op >> 12) & 3], true, pc))
+				return 0;
+		} else if ((op & 0xF100) == 0xC000 && size != 0) {
+			// AND.s <ea>,Dn
+			if (!IdleLoopEA(op & 0x3F, size, true, pc))
+				return 0;
+		} else if ((op & 0xFF38) == 0x0200 && size != 0) {
+			// ANDI.s #imm,Dn
+			pc += (size == 4 ? 4 : 2);
+		} else if ((op & 0xF000) == 0x6000) {
+			// Bcc / BRA
+			const unsigned int cond = (op >> 8) & 0xF;
+			if (cond == 1) {
+				// BSR
+				return 0;
+			}
+
+			uint32_t target;
+			const uint8_t disp8 = (op & 0xFF);
+			if (disp8 == 0) {
+				target = pc + (int16_t)M68K_Mem::M68K_RW(pc);
+				pc += 2;
+			} else if (disp8 == 0xFF) {
+				// 32-bit displacement. (68020+)
+				return 0;
+			} else {
+				target = pc + (int8_t)disp8;
+			}
+			target &= 0xFFFFFF;
+
+			if (cond == 0 || target <= insn)
+				pc = target;
+		} else {
+			// Not allowed in an idle loop.
+			return 0;
+		}
+
+		pc &= 0xFFFFFF;
+		if (pc == start)
+			return n;
+	}
+
+	// Loop is too long.
+	return 0;
+}
+
+/**
+ * M68K registers that must not change in an idle loop.
+ */
+struct M68K_IdleRegs {
+	unsigned int dreg[8];
+	unsigned int areg[8];
+	unsigned int asp;
+	unsigned int pc;
+	unsigned short sr;
+
+	void save(void)
+	{
+		memcpy(dreg, main68k_context.dreg, sizeof(dreg));
+		memcpy(areg, main68k_context.areg, sizeof(areg));
+		asp = main68k_context.asp;
+		pc = main68k_context.pc;
+		sr = main68k_context.sr;
+	}
+
+	bool operator==(const M68K_IdleRegs &o) const
+	{
+		return (!memcmp(dreg, o.dreg, sizeof(dreg)) &&
+			!memcmp(areg, o.areg, sizeof(areg)) &&
+			asp == o.asp && pc == o.pc && sr == o.sr);
+	}
+};
+
+/**
+ * Run iterations of an idle loop.
+ * This is exactly what the interpreter would do.
+ * @param insns Number of instructions in the loop.
+ * @param iterations Number of iterations.
+ * @param n Odometer value the M68K is about to run to.
+ * @return True if the loop went back to the start; false if not.
+ */
+static bool RunIdleLoopIterations(int insns, int iterations, int n)
+{
+	const unsigned int start = main68k_context.pc;
+	for (int i = 0; i < iterations; i++) {
+		for (int j = 0; j < insns; j++) {
+			const int odo = (int)main68k_readOdometer();
+			if (odo >= n)
+				return false;
+			if (main68k_exec(odo + 1) != 0x80000000)
+				return false;
+		}
+		if (main68k_context.pc != start)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Skip iterations of an idle loop at the current PC.
+ *
+ * This works the same way as Z80::SkipIdleLoop(), except
+ * iterations are checked and skipped in pairs. Reading the
+ * VDP status register toggles the FIFO flags, so a loop
+ * that polls it only repeats every two iterations.
+ *
+ * @param n Odometer value the M68K is about to run to.
+ */
+void M68K::SkipIdleLoop(int n)
+{
+	// Don't skip anything if the CPU is stopped
+	// or if an interrupt would be accepted.
+	unsigned int irq = main68k_context.interrupts[0];
+	if (irq & 0x10)
+		return;
+	irq &= 7;
+	if (irq == 7 || irq > ((main68k_context.sr >> 8) & 7u))
+		return;
+
+	const int insns = IdleLoopLength();
+	if (insns == 0)
+		return;
+
+	M68K_IdleRegs regs0, regs1;
+	regs0.save();
+	int odo0 = (int)main68k_readOdometer();
+	if (!RunIdleLoopIterations(insns, 2, n))
+		return;
+	regs1.save();
+	if (!(regs1 == regs0)) {
+		// Try one more pair of iterations.
+		regs0 = regs1;
+		odo0 = (int)main68k_readOdometer();
+		if (!RunIdleLoopIterations(insns, 2, n))
+			return;
+		regs1.save();
+		if (!(regs1 == regs0))
+			return;
+	}
+
+	// Skip whole pairs of iterations.
+	const int odo = (int)main68k_readOdometer();
+	const int unit = odo - odo0;
+	const int remaining = n - odo;
+	if (unit <= 0 || remaining <= unit)
+		return;
+	const int count = (remaining - 1) / unit;
+
+	main68k_addCycles(count * unit);
+	ms_IdleCycles += (count * unit);
+}
+#endif /* GENS_ENABLE_EMULATION */
+
 /** ZOMG savestate functions. **/
 
 /**
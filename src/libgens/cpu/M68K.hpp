@@ -28,6 +28,9 @@
 
 #include "star_68k.h"
 
+// Profiler.
+#include "../Util/Profiler.hpp"
+
 // ZOMG M68K structs.
 #include "libzomg/zomg_m68k.h"
 
@@ -78,6 +81,34 @@ class M68K
 		static inline unsigned int Exec(int n);
 		static inline unsigned int TripOdometer(void);
 		/** END: Starscream wrapper functions. **/
+
+		/** Idle loop detection. **/
+
+		/**
+		 * Is idle loop skipping enabled?
+		 * @return True if enabled; false if not.
+		 */
+		static inline bool IdleLoopSkip(void);
+
+		/**
+		 * Enable or disable idle loop skipping.
+		 * If enabled, side-effect-free polling loops are
+		 * skipped until the end of the current timeslice.
+		 * (Default is disabled.)
+		 * @param idleLoopSkip True to enable; false to disable.
+		 */
+		static inline void SetIdleLoopSkip(bool idleLoopSkip);
+
+		/**
+		 * Get the total number of cycles skipped in idle loops.
+		 * @return Cycles skipped.
+		 */
+		static inline unsigned int IdleCycles(void);
+
+		/**
+		 * Clear the idle loop cycle counter.
+		 */
+		static inline void ClearIdleCycles(void);
 	
 	protected:
 		static S68000CONTEXT ms_Context;
@@ -96,6 +127,22 @@ class M68K
 		~M68K() { }
 
 		static SysID ms_LastSysID;
+
+		// Idle loop detection.
+		static bool ms_IdleLoopSkip;
+		static unsigned int ms_IdleCycles;
+
+		/**
+		 * Get the length of the idle loop at the current PC.
+		 * @return Number of instructions in the loop, or 0 if not an idle loop.
+		 */
+		static int IdleLoopLength(void);
+
+		/**
+		 * Skip iterations of an idle loop at the current PC.
+		 * @param n Odometer value the M68K is about to run to.
+		 */
+		static void SkipIdleLoop(int n);
 };
 
 /** BEGIN: Starscream wrapper functions. **/
@@ -154,6 +201,9 @@ inline void M68K::AddCycles(int cycles)
  */
 inline unsigned int M68K::Exec(int n)
 {
+	PROFILE_SCOPE(M68K_EXEC);
+	if (ms_IdleLoopSkip)
+		SkipIdleLoop(n);
 	return main68k_exec(n);
 }
 
@@ -180,6 +230,35 @@ inline unsigned int M68K::TripOdometer(void) { return 0; }
 
 /** END: Starscream wrapper functions. **/
 
+/** Idle loop detection. **/
+
+/**
+ * Is idle loop skipping enabled?
+ * @return True if enabled; false if not.
+ */
+inline bool M68K::IdleLoopSkip(void)
+	{ return ms_IdleLoopSkip; }
+
+/**
+ * Enable or disable idle loop skipping.
+ * @param idleLoopSkip True to enable; false to disable.
+ */
+inline void M68K::SetIdleLoopSkip(bool idleLoopSkip)
+	{ ms_IdleLoopSkip = idleLoopSkip; }
+
+/**
+ * Get the total number of cycles skipped in idle loops.
+ * @return Cycles skipped.
+ */
+inline unsigned int M68K::IdleCycles(void)
+	{ return ms_IdleCycles; }
+
+/**
+ * Clear the idle loop cycle counter.
+ */
+inline void M68K::ClearIdleCycles(void)
+	{ ms_IdleCycles = 0; }
+
 }
 
 #endif /* __LIBGENS_CPU_M68K_HPP__ */
@@ -113,6 +113,7 @@ int M68K_Mem::CPL_M68K;
 int M68K_Mem::CPL_Z80;
 int M68K_Mem::Cycles_M68K;
 int M68K_Mem::Cycles_Z80;
+int M68K_Mem::LineStart_M68K;
 
 /**
  * M68K bank type identifiers.
@@ -96,6 +96,10 @@ class M68K_Mem
 		static int Cycles_M68K;
 		static int Cycles_Z80;
 
+		// M68K cycle at the start of the current line.
+		// Used by the H counter and DMA.
+		static int LineStart_M68K;
+
 		/** System initialization functions. **/
 	public:
 		static void UpdateTmssMapping(void);	// FIXME: Needs to be private?
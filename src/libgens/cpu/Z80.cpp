@@ -28,6 +28,10 @@
 #include "M68K_Mem.hpp"
 
 #include "mdZ80/mdZ80_flags.h"
+#include "mdZ80/mdZ80_core.hpp"
+
+// Profiler.
+#include "Util/Profiler.hpp"
 
 // C includes.
 #include <string.h>
@@ -36,13 +40,52 @@ namespace LibGens {
 
 // Static class variables.
 mdZ80_context *Z80::ms_Z80 = NULL;
+bool Z80::ms_IdleLoopSkip = true;
+unsigned int Z80::ms_IdleCycles = 0;
+
+/**
+ * MD memory bus for the mdZ80 interpreter.
+ * Z80 RAM accesses are inlined; everything else
+ * is handled by Z80_MD_Mem's device functions.
+ */
+struct Z80_MD_Bus
+{
+	static inline uint8_t Fetch(mdZ80_context *z80, uint16_t address)
+	{
+		((void)z80);
+		return Z80_MD_Mem::Z80_ReadB(address);
+	}
+
+	static inline uint8_t ReadB(mdZ80_context *z80, uint16_t address)
+	{
+		((void)z80);
+		return Z80_MD_Mem::Z80_ReadB(address);
+	}
+
+	static inline void WriteB(mdZ80_context *z80, uint16_t address, uint8_t data)
+	{
+		((void)z80);
+		Z80_MD_Mem::Z80_WriteB(address, data);
+	}
+
+	// The MD doesn't have any Z80 I/O ports.
+	static inline uint8_t In(mdZ80_context *z80, uint16_t port)
+	{
+		((void)z80); ((void)port);
+		return 0xFF;
+	}
+
+	static inline void Out(mdZ80_context *z80, uint16_t port, uint8_t data)
+	{
+		((void)z80); ((void)port); ((void)data);
+	}
+};
 
 /**
  * Initialize the Z80 CPU emulator.
  */
 void Z80::Init(void)
 {
-#ifdef GENS_ENABLE_EMULATION
 	// Allocate the Z80 context.
 	// TODO: Error handling.
 	ms_Z80 = mdZ80_new();
@@ -54,7 +97,6 @@ void Z80::Init(void)
 	// Set memory read/write handlers.
 	mdZ80_Set_ReadB(ms_Z80, Z80_MD_Mem::Z80_ReadB);
 	mdZ80_Set_WriteB(ms_Z80, Z80_MD_Mem::Z80_WriteB);
-#endif
 
 	// Reinitialize the Z80.
 	ReInit();
@@ -66,9 +108,7 @@ void Z80::Init(void)
 void Z80::End(void)
 {
 	// Free the Z80 context.
-#ifdef GENS_ENABLE_EMULATION
 	mdZ80_free(ms_Z80);
-#endif
 	ms_Z80 = NULL;
 
 	// TODO: Other shutdown stuff.
@@ -99,6 +139,301 @@ void Z80::ReInit(void)
 	HardReset();
 }
 
+/**
+ * Run the Z80.
+ * @param cyclesSubtract Cycles to subtract from the Z80 cycles counter.
+ */
+void Z80::Exec(int cyclesSubtract)
+{
+	PROFILE_SCOPE(Z80_EXEC);
+	int cyclesToRun = (M68K_Mem::Cycles_Z80 - cyclesSubtract);
+
+	// Only run the Z80 if it's enabled and it has the bus.
+	if (M68K_Mem::Z80_State == (Z80_STATE_ENABLED | Z80_STATE_BUSREQ)) {
+		if (ms_IdleLoopSkip)
+			SkipIdleLoop(cyclesToRun);
+		mdZ80_exec<Z80_MD_Bus>(ms_Z80, cyclesToRun);
+	} else {
+		mdZ80_set_odo(ms_Z80, cyclesToRun);
+	}
+}
+
+/** Idle loop detection. **/
+
+/**
+ * Maximum number of instructions in an idle loop.
+ */
+static const int IDLE_LOOP_MAX_INSNS = 8;
+
+/**
+ * Can the Z80 read from an address in an idle loop?
+ * The value must not change while the Z80 is running,
+ * and reading it must not have side effects.
+ * @param address Address.
+ * @return True if the address is OK; false if not.
+ */
+static inline bool IdleLoopReadOK(uint16_t address)
+{
+	// 0x0000-0x3FFF: Z80 RAM.
+	// 0x4000-0x5FFF: YM2612. (Timers are only updated between lines.)
+	// The 68K bank and the VDP are not allowed, since
+	// bank accesses take extra cycles and the VDP
+	// has the H/V counter.
+	return (address < 0x6000);
+}
+
+/**
+ * Get the length of the idle loop at the current PC.
+ *
+ * An idle loop is a short loop that only reads from
+ * Z80 RAM or the YM2612 and only modifies A and F.
+ * Conditional branches are assumed to be taken if
+ * they go backwards; the loop must lead back to PC.
+ *
+ * @return Number of instructions in the loop, or 0 if not an idle loop.
+ */
+int Z80::IdleLoopLength(void)
+{
+	const mdZ80_context *const z80 = ms_Z80;
+	const uint16_t start = (uint16_t)z80->PC;
+	uint16_t pc = start;
+
+	// Loop code must be in Z80 RAM.
+#define FETCH() Ram_Z80[(pc++) & 0x1FFF]
+	for (int n = 1; n <= IDLE_LOOP_MAX_INSNS; n++) {
+		if (pc >= 0x4000)
+			return 0;
+
+		const uint16_t insn = pc;
+		const uint8_t op = FETCH();
+		switch (op) {
+			case 0x00:	// NOP
+			case 0x07: case 0x0F: case 0x17: case 0x1F:	// RLCA, RRCA, RLA, RRA
+			case 0x2F: case 0x37: case 0x3F:		// CPL, SCF, CCF
+			case 0x78: case 0x79: case 0x7A: case 0x7B:	// LD A,r
+			case 0x7C: case 0x7D: case 0x7F:
+				break;
+
+			case 0x0A:	// LD A,(BC)
+				if (!IdleLoopReadOK(z80->BC.w))
+					return 0;
+				break;
+			case 0x1A:	// LD A,(DE)
+				if (!IdleLoopReadOK(z80->DE.w))
+					return 0;
+				break;
+			case 0x7E:	// LD A,(HL)
+				if (!IdleLoopReadOK(z80->HL.w))
+					return 0;
+				break;
+
+			case 0x3A: {	// LD A,(nn)
+				uint16_t addr = FETCH();
+				addr |= (FETCH() << 8);
+				if (!IdleLoopReadOK(addr))
+					return 0;
+				break;
+			}
+
+			case 0x3E:	// LD A,n
+			case 0xC6: case 0xCE: case 0xD6: case 0xDE:	// ALU A,n
+			case 0xE6: case 0xEE: case 0xF6: case 0xFE:
+				pc++;
+				break;
+
+			case 0xCB: {
+				const uint8_t op2 = FETCH();
+				if (op2 >= 0x40 && op2 < 0x80) {
+					// BIT b,r / BIT b,(HL)
+					if ((op2 & 7) == 6 && !IdleLoopReadOK(z80->HL.w))
+						return 0;
+				} else if (op2 < 0x40 && (op2 & 7) == 7) {
+					// Rotate/shift A.
+				} else {
+					return 0;
+				}
+				break;
+			}
+
+			case 0xDD: case 0xFD: {
+				// LD A,(IX+d); ALU A,(IX+d); BIT b,(IX+d)
+				const uint16_t xy = (op == 0xDD ? z80->IX.w : z80->IY.w);
+				uint8_t op2 = FETCH();
+				const uint16_t addr = (uint16_t)(xy + (int8_t)FETCH());
+				if (op2 == 0xCB) {
+					op2 = FETCH();
+					if (op2 < 0x40 || op2 >= 0x80 || (op2 & 7) != 6)
+						return 0;
+				} else if (op2 != 0x7E && (op2 < 0x80 || op2 >= 0xC0 || (op2 & 7) != 6)) {
+					return 0;
+				}
+				if (!IdleLoopReadOK(addr))
+					return 0;
+				break;
+			}
+
+			case 0x18: {	// JR d
+				const int8_t d = (int8_t)FETCH();
+				pc = (uint16_t)(pc + d);
+				break;
+			}
+
+			case 0x20: case 0x28: case 0x30: case 0x38: {
+				// JR cc,d
+				const int8_t d = (int8_t)FETCH();
+				const uint16_t target = (uint16_t)(pc + d);
+				if (target <= insn)
+					pc = target;
+				break;
+			}
+
+			case 0xC3: {	// JP nn
+				uint16_t target = FETCH();
+				target |= (FETCH() << 8);
+				pc = target;
+				break;
+			}
+
+			case 0xC2: case 0xCA: case 0xD2: case 0xDA:
+			case 0xE2: case 0xEA: case 0xF2: case 0xFA: {
+				// JP cc,nn
+				uint16_t target = FETCH();
+				target |= (FETCH() << 8);
+				if (target <= insn)
+					pc = target;
+				break;
+			}
+
+			default:
+				if (op >= 0x80 && op < 0xC0) {
+					// ALU A,r / ALU A,(HL)
+					if ((op & 7) == 6 && !IdleLoopReadOK(z80->HL.w))
+						return 0;
+					break;
+				}
+				// Not allowed in an idle loop.
+				return 0;
+		}
+
+		if (pc == start)
+			return n;
+	}
+#undef FETCH
+
+	// Loop is too long.
+	return 0;
+}
+
+/**
+ * Z80 registers that must not change in an idle loop.
+ */
+struct Z80_IdleRegs {
+	uint32_t AF;
+	uint32_t PC;
+	uint16_t BC, DE, HL, IX, IY, SP, WZ;
+	uint8_t IFF;
+
+	void save(const mdZ80_context *z80)
+	{
+		AF = z80->AF.d; PC = z80->PC;
+		BC = z80->BC.w; DE = z80->DE.w; HL = z80->HL.w;
+		IX = z80->IX.w; IY = z80->IY.w; SP = z80->SP.w;
+		WZ = z80->WZ; IFF = z80->IFF;
+	}
+
+	bool operator==(const Z80_IdleRegs &o) const
+	{
+		return (AF == o.AF && PC == o.PC && BC == o.BC &&
+			DE == o.DE && HL == o.HL && IX == o.IX &&
+			IY == o.IY && SP == o.SP && WZ == o.WZ &&
+			IFF == o.IFF);
+	}
+};
+
+/**
+ * Run one iteration of an idle loop.
+ * This is exactly what the interpreter would do.
+ * @param z80 Z80 context.
+ * @param insns Number of instructions in the loop.
+ * @param odo Odometer value the Z80 is about to run to.
+ * @return True if the loop went back to the start; false if not.
+ */
+static bool RunIdleLoopIteration(mdZ80_context *z80, int insns, int odo)
+{
+	const uint32_t start = z80->PC;
+	for (int i = 0; i < insns; i++) {
+		if ((int)z80->CycleCnt >= odo)
+			return false;
+		mdZ80_exec<Z80_MD_Bus>(z80, z80->CycleCnt + 1);
+	}
+	return (z80->PC == start);
+}
+
+/**
+ * Skip iterations of an idle loop at the current PC.
+ *
+ * The loop is run normally for one iteration. If the
+ * registers are the same afterwards, and the loop can't
+ * write anything, every following iteration will behave
+ * exactly the same until something outside of the Z80
+ * changes, which can't happen until the end of the current
+ * timeslice. (If the registers changed, e.g. WZ on the
+ * first iteration, one more iteration is checked.)
+ * Whole iterations are then skipped by advancing the
+ * odometer and R.
+ *
+ * At least one cycle is always left for the interpreter,
+ * so the Z80 ends up in exactly the same state as if the
+ * loop had been run normally.
+ *
+ * @param odo Odometer value the Z80 is about to run to.
+ */
+void Z80::SkipIdleLoop(int odo)
+{
+	mdZ80_context *const z80 = ms_Z80;
+	if (z80->Status & (Z80_STATE_HALTED | Z80_STATE_FAULTED))
+		return;
+
+	// Don't skip anything if an interrupt would be accepted.
+	if ((z80->IntLine & 0x80) || ((z80->IntLine & 0x01) && (z80->IFF & 1)))
+		return;
+
+	const int insns = IdleLoopLength();
+	if (insns == 0)
+		return;
+
+	Z80_IdleRegs regs0, regs1;
+	regs0.save(z80);
+	uint32_t odo0 = z80->CycleCnt;
+	uint8_t r0 = z80->R;
+	if (!RunIdleLoopIteration(z80, insns, odo))
+		return;
+	regs1.save(z80);
+	if (!(regs1 == regs0)) {
+		// Try one more iteration.
+		regs0 = regs1;
+		odo0 = z80->CycleCnt;
+		r0 = z80->R;
+		if (!RunIdleLoopIteration(z80, insns, odo))
+			return;
+		regs1.save(z80);
+		if (!(regs1 == regs0))
+			return;
+	}
+
+	// Skip whole iterations.
+	const int unit = (int)(z80->CycleCnt - odo0);
+	const int remaining = odo - (int)z80->CycleCnt;
+	if (unit <= 0 || remaining <= unit)
+		return;
+	const int count = (remaining - 1) / unit;
+
+	const unsigned int dR = (uint8_t)(z80->R - r0);
+	z80->CycleCnt += (count * unit);
+	z80->R = (z80->R & 0x80) | ((z80->R + (count * dR)) & 0x7F);
+	ms_IdleCycles += (count * unit);
+}
+
 /** ZOMG savestate functions. **/
 
 /**
@@ -109,7 +444,6 @@ void Z80::ZomgSaveReg(Zomg_Z80RegSave_t *state)
 {
 	// NOTE: Byteswapping is done in libzomg.
 
-#ifdef GENS_ENABLE_EMULATION
 	// Main register set.
 	state->AF = mdZ80_get_AF(ms_Z80);
 	state->BC = mdZ80_get_BC(ms_Z80);
@@ -132,9 +466,7 @@ void Z80::ZomgSaveReg(Zomg_Z80RegSave_t *state)
 	state->I = mdZ80_get_I(ms_Z80);
 	state->IM = mdZ80_get_IM(ms_Z80);
 
-	// TODO: Remove this once we switch to CZ80,
-	// since CZ80 supports WZ.
-	state->WZ = 0;
+	state->WZ = mdZ80_get_WZ(ms_Z80);
 
 	// Status.
 	uint8_t mdZ80_status = mdZ80_get_Status(ms_Z80);
@@ -157,9 +489,6 @@ void Z80::ZomgSaveReg(Zomg_Z80RegSave_t *state)
 
 	// Interrupt Vector. (IM 2)
 	state->IntVect = mdZ80_get_IntVect(ms_Z80);
-#else
-	memset(state, 0x00, sizeof(*state));
-#endif /* GENS_ENABLE_EMULATION */
 }
 
 /**
@@ -170,7 +499,6 @@ void Z80::ZomgRestoreReg(const Zomg_Z80RegSave_t *state)
 {
 	// NOTE: Byteswapping is done in libzomg.
 
-#ifdef GENS_ENABLE_EMULATION
 	// Main register set.
 	mdZ80_set_AF(ms_Z80, state->AF);
 	mdZ80_set_BC(ms_Z80, state->BC);
@@ -193,13 +521,13 @@ void Z80::ZomgRestoreReg(const Zomg_Z80RegSave_t *state)
 	mdZ80_set_I(ms_Z80, state->I);
 	mdZ80_set_IM(ms_Z80, state->IM);
 
-	// TODO: Load WZ.
+	mdZ80_set_WZ(ms_Z80, state->WZ);
 
 	// Status.
 	uint8_t mdZ80_status = 0;
 	uint8_t IntLine = 0;
 	if (state->Status & ZOMG_Z80_STATUS_HALTED) {
-		mdZ80_status |= ZOMG_Z80_STATUS_HALTED;
+		mdZ80_status |= Z80_STATE_HALTED;
 	}
 	if (state->Status & ZOMG_Z80_STATUS_FAULTED) {
 		mdZ80_status |= Z80_STATE_FAULTED;
@@ -216,7 +544,6 @@ void Z80::ZomgRestoreReg(const Zomg_Z80RegSave_t *state)
 
 	// Interrupt Vector. (IM 2)
 	mdZ80_set_IntVect(ms_Z80, state->IntVect);
-#endif /* GENS_ENABLE_EMULATION */
 }
 
 }
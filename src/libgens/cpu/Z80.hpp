@@ -61,15 +61,59 @@ class Z80
 		/** BEGIN: mdZ80 wrapper functions. **/
 		static inline void HardReset(void);
 		static inline void SoftReset(void);
-		static inline void Exec(int cyclesSubtract);
+		static void Exec(int cyclesSubtract);
 		static inline void Interrupt(uint8_t irq);
 		static inline void ClearOdometer(void);
 		static inline void SetOdometer(unsigned int odo);
+		static inline unsigned int ReadOdometer(void);
 		/** END: mdZ80 wrapper functions. **/
-	
+
+		/** Idle loop detection. **/
+
+		/**
+		 * Is idle loop skipping enabled?
+		 * @return True if enabled; false if not.
+		 */
+		static inline bool IdleLoopSkip(void);
+
+		/**
+		 * Enable or disable idle loop skipping.
+		 * If enabled, side-effect-free polling loops are
+		 * skipped until the end of the current timeslice.
+		 * @param idleLoopSkip True to enable; false to disable.
+		 */
+		static inline void SetIdleLoopSkip(bool idleLoopSkip);
+
+		/**
+		 * Get the total number of cycles skipped in idle loops.
+		 * @return Cycles skipped.
+		 */
+		static inline unsigned int IdleCycles(void);
+
+		/**
+		 * Clear the idle loop cycle counter.
+		 */
+		static inline void ClearIdleCycles(void);
+
 	protected:
 		static mdZ80_context *ms_Z80;
-	
+
+		// Idle loop detection.
+		static bool ms_IdleLoopSkip;
+		static unsigned int ms_IdleCycles;
+
+		/**
+		 * Get the length of the idle loop at the current PC.
+		 * @return Number of instructions in the loop, or 0 if not an idle loop.
+		 */
+		static int IdleLoopLength(void);
+
+		/**
+		 * Skip iterations of an idle loop at the current PC.
+		 * @param odo Odometer value the Z80 is about to run to.
+		 */
+		static void SkipIdleLoop(int odo);
+
 	private:
 		Z80() { }
 		~Z80() { }
@@ -77,7 +121,6 @@ class Z80
 
 /** BEGIN: mdZ80 wrapper functions. **/
 
-#ifdef GENS_ENABLE_EMULATION
 /**
  * Reset the Z80. (Hard Reset)
  * This function should be called when resetting emulation.
@@ -96,22 +139,6 @@ inline void Z80::SoftReset(void)
 	mdZ80_soft_reset(ms_Z80);
 }
 
-/**
- * Run the Z80.
- * @param cyclesSubtract Cycles to subtract from the Z80 cycles counter.
- */
-inline void Z80::Exec(int cyclesSubtract)
-{
-	int cyclesToRun = (M68K_Mem::Cycles_Z80 - cyclesSubtract);
-
-	// Only run the Z80 if it's enabled and it has the bus.
-	if (M68K_Mem::Z80_State == (Z80_STATE_ENABLED | Z80_STATE_BUSREQ)) {
-		z80_Exec(ms_Z80, cyclesToRun);
-	} else {
-		mdZ80_set_odo(ms_Z80, cyclesToRun);
-	}
-}
-
 /**
  * Assert an interrupt. (IRQ)
  * @param irq Interrupt request.
@@ -138,16 +165,45 @@ inline void Z80::SetOdometer(unsigned int odo)
 	mdZ80_set_odo(ms_Z80, odo);
 }
 
-#else /* !GENS_ENABLE_EMULATION */
+/**
+ * Read the odometer.
+ * @return Odometer value.
+ */
+inline unsigned int Z80::ReadOdometer(void)
+{
+	return mdZ80_read_odo(ms_Z80);
+}
 
-inline void Z80::HardReset(void) { }
-inline void Z80::SoftReset(void) { }
-inline void Z80::Exec(int cyclesSubtract) { ((void)cyclesSubtract); }
-inline void Z80::Interrupt(uint8_t irq) { ((void)irq); }
-inline void Z80::ClearOdometer(void) { }
-inline void Z80::SetOdometer(unsigned int odo) { ((void)odo); }
+/** END: mdZ80 wrapper functions. **/
 
-#endif /* GENS_ENABLE_EMULATION */
+/** Idle loop detection. **/
+
+/**
+ * Is idle loop skipping enabled?
+ * @return True if enabled; false if not.
+ */
+inline bool Z80::IdleLoopSkip(void)
+	{ return ms_IdleLoopSkip; }
+
+/**
+ * Enable or disable idle loop skipping.
+ * @param idleLoopSkip True to enable; false to disable.
+ */
+inline void Z80::SetIdleLoopSkip(bool idleLoopSkip)
+	{ ms_IdleLoopSkip = idleLoopSkip; }
+
+/**
+ * Get the total number of cycles skipped in idle loops.
+ * @return Cycles skipped.
+ */
+inline unsigned int Z80::IdleCycles(void)
+	{ return ms_IdleCycles; }
+
+/**
+ * Clear the idle loop cycle counter.
+ */
+inline void Z80::ClearIdleCycles(void)
+	{ ms_IdleCycles = 0; }
 
 }
 
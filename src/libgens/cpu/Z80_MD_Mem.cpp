@@ -75,7 +75,7 @@ void Z80_MD_Mem::End(void)
  * @param address Address to read from.
  * @return YM2612 register.
  */
-inline uint8_t Z80_MD_Mem::Z80_ReadB_YM2612(uint32_t address)
+uint8_t Z80_MD_Mem::Z80_ReadB_YM2612(uint32_t address)
 {
 	// According to the Genesis Software Manual, all four addresses return
 	// the same value for YM2612_Read().
@@ -95,7 +95,7 @@ inline uint8_t Z80_MD_Mem::Z80_ReadB_YM2612(uint32_t address)
  * @param address Address to read from.
  * @return VDP register.
  */
-inline uint8_t Z80_MD_Mem::Z80_ReadB_VDP(uint32_t address)
+uint8_t Z80_MD_Mem::Z80_ReadB_VDP(uint32_t address)
 {
 	if (address < 0x7F00) {
 		// Not in VDP range.
@@ -166,7 +166,7 @@ inline uint8_t Z80_MD_Mem::Z80_ReadB_VDP(uint32_t address)
  * @param address Address to read from.
  * @return Byte from MC68000 ROM.
  */
-inline uint8_t Z80_MD_Mem::Z80_ReadB_68K_Rom(uint32_t address)
+uint8_t Z80_MD_Mem::Z80_ReadB_68K_Rom(uint32_t address)
 {
 	// Z80 cannot read from M68K RAM.
 	// If this is attempted, 0xFF will be returned.
@@ -186,7 +186,7 @@ inline uint8_t Z80_MD_Mem::Z80_ReadB_68K_Rom(uint32_t address)
  * @param address Address to write to.
  * @param data Byte to write.
  */
-inline void Z80_MD_Mem::Z80_WriteB_Bank(uint32_t address, uint8_t data)
+void Z80_MD_Mem::Z80_WriteB_Bank(uint32_t address, uint8_t data)
 {
 	if (address > 0x60FF) {
 		// TODO: Invalid address. This should do something.
@@ -203,7 +203,7 @@ inline void Z80_MD_Mem::Z80_WriteB_Bank(uint32_t address, uint8_t data)
  * @param address Address to write to.
  * @param data Byte to write.
  */
-inline void Z80_MD_Mem::Z80_WriteB_YM2612(uint32_t address, uint8_t data)
+void Z80_MD_Mem::Z80_WriteB_YM2612(uint32_t address, uint8_t data)
 {
 	// The YM2612's RESET line is tied to the Z80's RESET line.
 	if (M68K_Mem::Z80_State & Z80_STATE_RESET)
@@ -218,7 +218,7 @@ inline void Z80_MD_Mem::Z80_WriteB_YM2612(uint32_t address, uint8_t data)
  * @param address Address to write to.
  * @param data Byte to write.
  */
-inline void Z80_MD_Mem::Z80_WriteB_VDP(uint32_t address, uint8_t data)
+void Z80_MD_Mem::Z80_WriteB_VDP(uint32_t address, uint8_t data)
 {
 	if (address < 0x7F00) {
 		// Not in VDP range.
@@ -268,7 +268,7 @@ inline void Z80_MD_Mem::Z80_WriteB_VDP(uint32_t address, uint8_t data)
  * @param address Address to write to.
  * @param data Byte to write.
  */
-inline void Z80_MD_Mem::Z80_WriteB_68K_Rom(uint32_t address, uint8_t data)
+void Z80_MD_Mem::Z80_WriteB_68K_Rom(uint32_t address, uint8_t data)
 {
 	// NOTE: Z80 writes to M68K RAM are allowed.
 	// Reference: http://gendev.spritesmind.net/forum/viewtopic.php?t=985
@@ -278,83 +278,4 @@ inline void Z80_MD_Mem::Z80_WriteB_68K_Rom(uint32_t address, uint8_t data)
 	M68K_Mem::M68K_WB(address, data);
 }
 
-/** Z80 General Read/Write functions. **/
-
-/**
- * Read a byte from the Z80 address space.
- * @param address Address to read from.
- * @return Byte from the Z80 address space.
- */
-uint8_t Z80_MD_Mem::Z80_ReadB(uint32_t address)
-{
-	const uint8_t page = ((address >> 12) & 0x0F);
-	switch (page & 0x0F) {
-		case 0x00: case 0x01:
-		case 0x02: case 0x03:
-			// 0x0000-0x1FFF: Z80 RAM.
-			// 0x2000-0x3FFF: Z80 RAM. (mirror)
-			return Ram_Z80[address & 0x1FFF];
-
-		case 0x04: case 0x05:
-			// 0x4000-0x5FFF: YM2612.
-			return Z80_ReadB_YM2612(address);
-
-		case 0x06:
-			// 0x6000-0x6FFF: Bank.
-			// NOTE: Reading from the bank register is undefined...
-			return 0xFF;
-
-		case 0x07:
-			// 0x7000-0x7FFF: VDP.
-			return Z80_ReadB_VDP(address);
-
-		case 0x08: case 0x09: case 0x0A: case 0x0B:
-		case 0x0C: case 0x0D: case 0x0E: case 0x0F:
-			// 0x8000-0xFFFF: 68K ROM bank.
-			return Z80_ReadB_68K_Rom(address);
-	}
-
-	// Should not get here...
-	return 0xFF;
-}
-
-/**
- * Write a byte to the Z80 address space.
- * @param address Address to write to.
- * @param data Byte to write to the Z80 address space.
- */
-void Z80_MD_Mem::Z80_WriteB(uint32_t address, uint8_t data)
-{
-	const uint8_t page = ((address >> 12) & 0x0F);
-	switch (page & 0x0F) {
-		case 0x00: case 0x01:
-		case 0x02: case 0x03:
-			// 0x0000-0x1FFF: Z80 RAM.
-			// 0x2000-0x3FFF: Z80 RAM. (mirror)
-			Ram_Z80[address & 0x1FFF] = data;
-			break;
-
-		case 0x04: case 0x05:
-			// 0x4000-0x5FFF: YM2612.
-			Z80_WriteB_YM2612(address, data);
-			break;
-
-		case 0x06:
-			// 0x6000-0x6FFF: Bank.
-			Z80_WriteB_Bank(address, data);
-			break;
-
-		case 0x07:
-			// 0x7000-0x7FFF: VDP.
-			Z80_WriteB_VDP(address, data);
-			break;
-
-		case 0x08: case 0x09: case 0x0A: case 0x0B:
-		case 0x0C: case 0x0D: case 0x0E: case 0x0F:
-			// 0x8000-0xFFFF: 68K ROM bank.
-			Z80_WriteB_68K_Rom(address, data);
-			break;
-	}
-}
-
 }
@@ -60,9 +60,8 @@ class Z80_MD_Mem
 		static int Bank_Z80;
 
 		/** Public read/write functions. **/
-		// TODO: Make these inline!
-		static uint8_t FASTCALL Z80_ReadB(uint32_t address);
-		static void FASTCALL Z80_WriteB(uint32_t address, uint8_t data);
+		static inline uint8_t FASTCALL Z80_ReadB(uint32_t address);
+		static inline void FASTCALL Z80_WriteB(uint32_t address, uint8_t data);
 
 	private:
 		/** Z80 read/write functions. **/
@@ -81,6 +80,85 @@ class Z80_MD_Mem
 		static void Z80_WriteB_68K_Rom(uint32_t address, uint8_t data);
 };
 
+/** Z80 General Read/Write functions. **/
+
+/**
+ * Read a byte from the Z80 address space.
+ * @param address Address to read from.
+ * @return Byte from the Z80 address space.
+ */
+inline uint8_t Z80_MD_Mem::Z80_ReadB(uint32_t address)
+{
+	const uint8_t page = ((address >> 12) & 0x0F);
+	switch (page & 0x0F) {
+		case 0x00: case 0x01:
+		case 0x02: case 0x03:
+			// 0x0000-0x1FFF: Z80 RAM.
+			// 0x2000-0x3FFF: Z80 RAM. (mirror)
+			return Ram_Z80[address & 0x1FFF];
+
+		case 0x04: case 0x05:
+			// 0x4000-0x5FFF: YM2612.
+			return Z80_ReadB_YM2612(address);
+
+		case 0x06:
+			// 0x6000-0x6FFF: Bank.
+			// NOTE: Reading from the bank register is undefined...
+			return 0xFF;
+
+		case 0x07:
+			// 0x7000-0x7FFF: VDP.
+			return Z80_ReadB_VDP(address);
+
+		case 0x08: case 0x09: case 0x0A: case 0x0B:
+		case 0x0C: case 0x0D: case 0x0E: case 0x0F:
+			// 0x8000-0xFFFF: 68K ROM bank.
+			return Z80_ReadB_68K_Rom(address);
+	}
+
+	// Should not get here...
+	return 0xFF;
+}
+
+/**
+ * Write a byte to the Z80 address space.
+ * @param address Address to write to.
+ * @param data Byte to write to the Z80 address space.
+ */
+inline void Z80_MD_Mem::Z80_WriteB(uint32_t address, uint8_t data)
+{
+	const uint8_t page = ((address >> 12) & 0x0F);
+	switch (page & 0x0F) {
+		case 0x00: case 0x01:
+		case 0x02: case 0x03:
+			// 0x0000-0x1FFF: Z80 RAM.
+			// 0x2000-0x3FFF: Z80 RAM. (mirror)
+			Ram_Z80[address & 0x1FFF] = data;
+			break;
+
+		case 0x04: case 0x05:
+			// 0x4000-0x5FFF: YM2612.
+			Z80_WriteB_YM2612(address, data);
+			break;
+
+		case 0x06:
+			// 0x6000-0x6FFF: Bank.
+			Z80_WriteB_Bank(address, data);
+			break;
+
+		case 0x07:
+			// 0x7000-0x7FFF: VDP.
+			Z80_WriteB_VDP(address, data);
+			break;
+
+		case 0x08: case 0x09: case 0x0A: case 0x0B:
+		case 0x0C: case 0x0D: case 0x0E: case 0x0F:
+			// 0x8000-0xFFFF: 68K ROM bank.
+			Z80_WriteB_68K_Rom(address, data);
+			break;
+	}
+}
+
 }
 
 #endif /* __LIBGENS_CPU_Z80_MEM_HPP__ */
@@ -0,0 +1,67 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * simd.h: SIMD intrinsics macros.                                         *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_MACROS_SIMD_H__
+#define __LIBGENS_MACROS_SIMD_H__
+
+/**
+ * x86: SSE2 and AVX2 functions are compiled using per-function
+ * target attributes, so they're available even if the compiler's
+ * baseline instruction set is lower. They must only be called if
+ * CPU_Flags indicates that the CPU supports them.
+ *
+ * ARM: NEON functions are only available if the compiler is
+ * targeting NEON. There's no runtime detection.
+ *
+ * Defined macros:
+ * - FUNC_TARGET(x): Function attribute for target instruction set x.
+ * - HAVE_SSE2_INTRIN: SSE2 intrinsics are available. (emmintrin.h)
+ * - HAVE_AVX2_INTRIN: AVX2 intrinsics are available. (immintrin.h)
+ * - HAVE_NEON_INTRIN: NEON intrinsics are available. (arm_neon.h)
+ */
+
+#if defined(__i386__) || defined(__amd64__) || defined(__x86_64__) || \
+    defined(_M_IX86) || defined(_M_X64)
+# if defined(__clang__) || \
+     (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+// gcc-4.9 and later allow intrinsics in functions with
+// target attributes, even if the instruction set isn't
+// enabled on the command line.
+#  define FUNC_TARGET(x) __attribute__ ((target(x)))
+#  define HAVE_SSE2_INTRIN 1
+#  define HAVE_AVX2_INTRIN 1
+# elif defined(_MSC_VER)
+// MSVC always allows intrinsics.
+#  define FUNC_TARGET(x)
+#  define HAVE_SSE2_INTRIN 1
+#  if _MSC_VER >= 1800
+#   define HAVE_AVX2_INTRIN 1
+#  endif
+# endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# define HAVE_NEON_INTRIN 1
+#endif
+
+#ifndef FUNC_TARGET
+# define FUNC_TARGET(x)
+#endif
+
+#endif /* __LIBGENS_MACROS_SIMD_H__ */
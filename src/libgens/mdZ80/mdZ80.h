@@ -90,6 +90,7 @@ uint16_t mdZ80_get_AF2(mdZ80_context *z80);
 uint16_t mdZ80_get_BC2(mdZ80_context *z80);
 uint16_t mdZ80_get_DE2(mdZ80_context *z80);
 uint16_t mdZ80_get_HL2(mdZ80_context *z80);
+uint16_t mdZ80_get_WZ(mdZ80_context *z80);
 uint8_t  mdZ80_get_IFF(mdZ80_context *z80);
 uint8_t  mdZ80_get_R(mdZ80_context *z80);
 uint8_t  mdZ80_get_I(mdZ80_context *z80);
@@ -110,6 +111,7 @@ void mdZ80_set_AF2(mdZ80_context *z80, uint16_t data);
 void mdZ80_set_BC2(mdZ80_context *z80, uint16_t data);
 void mdZ80_set_DE2(mdZ80_context *z80, uint16_t data);
 void mdZ80_set_HL2(mdZ80_context *z80, uint16_t data);
+void mdZ80_set_WZ(mdZ80_context *z80, uint16_t data);
 void mdZ80_set_IFF(mdZ80_context *z80, uint8_t data);
 void mdZ80_set_R(mdZ80_context *z80, uint8_t data);
 void mdZ80_set_I(mdZ80_context *z80, uint8_t data);
@@ -120,7 +122,7 @@ void mdZ80_set_Status(mdZ80_context *z80, uint8_t data);
 
 /*! Z80 main execution loop. **/
 
-uint32_t z80_Exec(mdZ80_context *z80, int odo);
+int z80_Exec(mdZ80_context *z80, int odo);
 
 #ifdef __cplusplus
 }
@@ -21,7 +21,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
  ***************************************************************************/
 
-/*! NOTE: This file should NOT be included outside of mdZ80.c! **/
+/*! NOTE: This file should only be included by mdZ80 and by code that
+ *  instantiates the interpreter core. (mdZ80_core.hpp) **/
 
 #ifndef __MDZ80_CONTEXT_H__
 #define __MDZ80_CONTEXT_H__
@@ -93,9 +94,9 @@ struct _mdZ80_context
 		} b;
 		uint16_t w;
 	} IY;
-	uint16_t reserved_reg;	// Reserved for struct alignment.
+	uint16_t WZ;	// Internal memory pointer. (MEMPTR)
 	
-	uint32_t PC;	// PC == BasePC + Z80 PC [x86 pointer!]
+	uint32_t PC;	// Program counter. (Only the low 16 bits are used.)
 	
 	union
 	{
@@ -143,8 +144,6 @@ struct _mdZ80_context
 	uint8_t Status;
 	uint8_t reserved_stat;	// Reserved for struct alignment.
 	
-	uint32_t BasePC;	// Pointer to x86 memory location where Z80 RAM starts.
-	
 	uint32_t CycleCnt;
 	uint32_t CycleTD;
 	uint32_t CycleIO;
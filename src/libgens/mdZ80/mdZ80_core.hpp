@@ -0,0 +1,1354 @@
+/***************************************************************************
+ * mdZ80: Gens Z80 Emulator                                                *
+ * mdZ80_core.hpp: Z80 interpreter core.                                   *
+ *                                                                         *
+ * Copyright (c) 1999-2002 by Stéphane Dallongeville                       *
+ * Copyright (c) 2003-2004 by Stéphane Akhoun                              *
+ * Copyright (c) 2008-2016 by David Korth                                  *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __MDZ80_CORE_HPP__
+#define __MDZ80_CORE_HPP__
+
+/**
+ * Portable Z80 interpreter.
+ *
+ * The interpreter is a template that's specialized for a memory bus,
+ * which allows the bus functions to be inlined into the opcode handlers.
+ * The bus class must have the following static functions:
+ *
+ * - uint8_t Fetch(mdZ80_context *z80, uint16_t address)
+ *   Read an opcode or immediate operand.
+ * - uint8_t ReadB(mdZ80_context *z80, uint16_t address)
+ * - void WriteB(mdZ80_context *z80, uint16_t address, uint8_t data)
+ * - uint8_t In(mdZ80_context *z80, uint16_t port)
+ * - void Out(mdZ80_context *z80, uint16_t port, uint8_t data)
+ *
+ * Flags are calculated directly instead of using lookup tables.
+ * All undocumented flags and opcodes are emulated; this is
+ * verified by ZEXALL. (tests/Z80)
+ *
+ * Opcode dispatch uses computed goto on compilers that support it,
+ * with a switch() fallback for everything else.
+ */
+
+#include "mdZ80.h"
+#include "mdZ80_context.h"
+#include "mdZ80_flags.h"
+
+#if defined(__GNUC__)
+#define MDZ80_USE_COMPUTED_GOTO 1
+#endif
+
+/** Flag calculation. **/
+
+/**
+ * Calculate S, Z, Y, and X for an 8-bit result.
+ * @param v Result.
+ * @return Flags.
+ */
+static inline uint8_t mdZ80_szxy(uint8_t v)
+{
+	return (v & (Z80_FLAG_S | Z80_FLAG_Y | Z80_FLAG_X)) | (v ? 0 : Z80_FLAG_Z);
+}
+
+/**
+ * Calculate the parity flag for an 8-bit value.
+ * @param v Value.
+ * @return Z80_FLAG_P if v has even parity; 0 otherwise.
+ */
+static inline uint8_t mdZ80_parity(uint8_t v)
+{
+	v ^= (v >> 4);
+	v ^= (v >> 2);
+	v ^= (v >> 1);
+	return (~v & 1) << 2;
+}
+
+/**
+ * Calculate S, Z, Y, X, and P for an 8-bit result.
+ * @param v Result.
+ * @return Flags.
+ */
+static inline uint8_t mdZ80_szxyp(uint8_t v)
+{
+	return mdZ80_szxy(v) | mdZ80_parity(v);
+}
+
+/** 8-bit arithmetic. **/
+
+static inline void mdZ80_add8(uint8_t &A, uint8_t &F, uint8_t v, unsigned int c)
+{
+	const unsigned int r = A + v + c;
+	F = mdZ80_szxy((uint8_t)r) | ((A ^ v ^ r) & Z80_FLAG_H) |
+	    (((A ^ r) & (v ^ r) & 0x80) >> 5) | (r >> 8);
+	A = (uint8_t)r;
+}
+
+static inline void mdZ80_sub8(uint8_t &A, uint8_t &F, uint8_t v, unsigned int c)
+{
+	const unsigned int r = A - v - c;
+	F = mdZ80_szxy((uint8_t)r) | Z80_FLAG_N | ((A ^ v ^ r) & Z80_FLAG_H) |
+	    (((A ^ v) & (A ^ r) & 0x80) >> 5) | ((r >> 8) & Z80_FLAG_C);
+	A = (uint8_t)r;
+}
+
+static inline void mdZ80_cp8(uint8_t A, uint8_t &F, uint8_t v)
+{
+	// NOTE: X and Y are taken from the operand, not the result.
+	const unsigned int r = A - v;
+	F = (mdZ80_szxy((uint8_t)r) & ~(Z80_FLAG_Y | Z80_FLAG_X)) |
+	    (v & (Z80_FLAG_Y | Z80_FLAG_X)) | Z80_FLAG_N |
+	    ((A ^ v ^ r) & Z80_FLAG_H) |
+	    (((A ^ v) & (A ^ r) & 0x80) >> 5) | ((r >> 8) & Z80_FLAG_C);
+}
+
+static inline uint8_t mdZ80_inc8(uint8_t &F, uint8_t v)
+{
+	const uint8_t r = v + 1;
+	F = (F & Z80_FLAG_C) | mdZ80_szxy(r) |
+	    ((r & 0x0F) ? 0 : Z80_FLAG_H) |
+	    (r == 0x80 ? Z80_FLAG_P : 0);
+	return r;
+}
+
+static inline uint8_t mdZ80_dec8(uint8_t &F, uint8_t v)
+{
+	const uint8_t r = v - 1;
+	F = (F & Z80_FLAG_C) | Z80_FLAG_N | mdZ80_szxy(r) |
+	    ((v & 0x0F) ? 0 : Z80_FLAG_H) |
+	    (r == 0x7F ? Z80_FLAG_P : 0);
+	return r;
+}
+
+/** 16-bit arithmetic. **/
+
+static inline uint16_t mdZ80_add16(uint8_t &F, uint16_t a, uint16_t b)
+{
+	const unsigned int r = a + b;
+	F = (F & (Z80_FLAG_S | Z80_FLAG_Z | Z80_FLAG_P)) |
+	    ((r >> 8) & (Z80_FLAG_Y | Z80_FLAG_X)) |
+	    (((a ^ b ^ r) >> 8) & Z80_FLAG_H) | (r >> 16);
+	return (uint16_t)r;
+}
+
+static inline uint16_t mdZ80_adc16(uint8_t &F, uint16_t a, uint16_t b)
+{
+	const unsigned int r = a + b + (F & Z80_FLAG_C);
+	F = ((r >> 8) & (Z80_FLAG_S | Z80_FLAG_Y | Z80_FLAG_X)) |
+	    ((r & 0xFFFF) ? 0 : Z80_FLAG_Z) |
+	    (((a ^ b ^ r) >> 8) & Z80_FLAG_H) |
+	    (((a ^ r) & (b ^ r) & 0x8000) >> 13) | (r >> 16);
+	return (uint16_t)r;
+}
+
+static inline uint16_t mdZ80_sbc16(uint8_t &F, uint16_t a, uint16_t b)
+{
+	const unsigned int r = a - b - (F & Z80_FLAG_C);
+	F = ((r >> 8) & (Z80_FLAG_S | Z80_FLAG_Y | Z80_FLAG_X)) |
+	    ((r & 0xFFFF) ? 0 : Z80_FLAG_Z) | Z80_FLAG_N |
+	    (((a ^ b ^ r) >> 8) & Z80_FLAG_H) |
+	    (((a ^ b) & (a ^ r) & 0x8000) >> 13) | ((r >> 16) & Z80_FLAG_C);
+	return (uint16_t)r;
+}
+
+/**
+ * CB-prefixed rotate and shift instructions.
+ * @param F Flags register.
+ * @param op Operation. (bits 3-5 of the opcode)
+ * @param v Value.
+ * @return Result.
+ */
+static inline uint8_t mdZ80_rot8(uint8_t &F, unsigned int op, uint8_t v)
+{
+	uint8_t r, c;
+	switch (op & 7) {
+		case 0:	// RLC
+			c = v >> 7;
+			r = (v << 1) | c;
+			break;
+		case 1:	// RRC
+			c = v & 1;
+			r = (v >> 1) | (c << 7);
+			break;
+		case 2:	// RL
+			c = v >> 7;
+			r = (v << 1) | (F & Z80_FLAG_C);
+			break;
+		case 3:	// RR
+			c = v & 1;
+			r = (v >> 1) | ((F & Z80_FLAG_C) << 7);
+			break;
+		case 4:	// SLA
+			c = v >> 7;
+			r = (v << 1);
+			break;
+		case 5:	// SRA
+			c = v & 1;
+			r = (v >> 1) | (v & 0x80);
+			break;
+		case 6:	// SLL (undocumented)
+			c = v >> 7;
+			r = (v << 1) | 1;
+			break;
+		case 7: default:	// SRL
+			c = v & 1;
+			r = (v >> 1);
+			break;
+	}
+
+	F = mdZ80_szxyp(r) | c;
+	return r;
+}
+
+/**
+ * BIT instruction.
+ * @param F Flags register.
+ * @param bit Bit number.
+ * @param v Value.
+ * @param xy Source for the undocumented X and Y flags.
+ */
+static inline void mdZ80_bit(uint8_t &F, unsigned int bit, uint8_t v, uint8_t xy)
+{
+	const uint8_t r = v & (1 << bit);
+	F = (F & Z80_FLAG_C) | Z80_FLAG_H | (xy & (Z80_FLAG_Y | Z80_FLAG_X)) |
+	    (r ? (r & Z80_FLAG_S) : (Z80_FLAG_Z | Z80_FLAG_P));
+}
+
+/** Interpreter. **/
+
+/**
+ * Check for pending interrupts.
+ * @param z80 Z80 context.
+ * @param PC Program counter.
+ * @param SP Stack pointer.
+ * @param WZ Internal memory pointer.
+ * @param IFF Interrupt flip-flops.
+ * @param R Refresh register counter.
+ * @return Number of cycles used to accept the interrupt, or 0 if none.
+ */
+template<class Bus>
+static inline int mdZ80_check_int(mdZ80_context *z80, uint16_t &PC,
+	uint16_t &SP, uint16_t &WZ, uint8_t &IFF, unsigned int &R)
+{
+	const uint8_t line = z80->IntLine;
+	const uint16_t ret = PC;
+	int cycles;
+
+	if (line & 0x80) {
+		// NMI. IFF1 is cleared; IFF2 remains as-is.
+		IFF &= ~1;
+		z80->IntLine = (line & ~0x80);
+		PC = 0x66;
+		cycles = 11;
+	} else if ((line & 0x01) && (IFF & 1)) {
+		// INT. Both IFF1 and IFF2 are cleared.
+		IFF = 0;
+		z80->IntLine = (line & 0x80);
+		switch (z80->IM) {
+			case 0:
+				// Assume the data bus has an RST instruction.
+				PC = (uint8_t)(z80->IntVect - 0xC7);
+				cycles = 13;
+				break;
+			case 1:
+				PC = 0x38;
+				cycles = 13;
+				break;
+			default: {
+				const uint16_t vec = (z80->I << 8) | z80->IntVect;
+				PC = Bus::ReadB(z80, vec) |
+				     (Bus::ReadB(z80, (uint16_t)(vec + 1)) << 8);
+				cycles = 19;
+				break;
+			}
+		}
+	} else {
+		// No interrupt.
+		return 0;
+	}
+
+	// Push the return address.
+	SP -= 2;
+	Bus::WriteB(z80, (uint16_t)(SP + 1), (ret >> 8));
+	Bus::WriteB(z80, SP, (ret & 0xFF));
+	WZ = PC;
+	R++;
+	z80->Status &= ~Z80_STATE_HALTED;
+	return cycles;
+}
+
+/**
+ * Run the Z80.
+ * @param z80 Z80 context.
+ * @param odo Odometer value to run to.
+ * @return 0 on success; -1 if the odometer was already reached.
+ */
+template<class Bus>
+static inline int mdZ80_exec(mdZ80_context *z80, int odo)
+{
+	const int todo = odo - (int)z80->CycleCnt;
+	if (todo <= 0)
+		return -1;
+
+	// Load the registers.
+	uint8_t A = z80->AF.b.A;
+	uint8_t F = (z80->AF.b.F & ~(Z80_FLAG_X | Z80_FLAG_Y)) |
+		    (z80->AF.b.FXY & (Z80_FLAG_X | Z80_FLAG_Y));
+	uint16_t BC = z80->BC.w;
+	uint16_t DE = z80->DE.w;
+	uint16_t HL = z80->HL.w;
+	uint16_t IX = z80->IX.w;
+	uint16_t IY = z80->IY.w;
+	uint16_t SP = z80->SP.w;
+	uint16_t PC = (uint16_t)z80->PC;
+	uint16_t WZ = z80->WZ;
+	uint8_t IFF = z80->IFF;
+	// R is incremented on every M1 cycle. Bit 7 is never changed.
+	unsigned int R = z80->R;
+	uint8_t R7 = (R & 0x80);
+
+	uint16_t *pXY;		// Current index register. (DD/FD)
+	uint8_t opcode;
+	int cycles = 0;		// Cycles run.
+	int limit = todo;	// Cycle limit.
+	int limit_ei = 0;	// Saved cycle limit while EI is pending.
+
+	// Check for interrupts.
+	if (z80->IntLine)
+		cycles = mdZ80_check_int<Bus>(z80, PC, SP, WZ, IFF, R);
+
+	if (z80->Status & (Z80_STATE_HALTED | Z80_STATE_FAULTED)) {
+		// The Z80 can't run right now.
+		if (z80->Status & Z80_STATE_HALTED) {
+			// A halted Z80 uses up all of its cycles.
+			z80->CycleCnt = odo;
+		}
+		return 0;
+	}
+
+	z80->Status |= Z80_STATE_RUNNING;
+	z80->CycleTD = todo;
+	z80->CycleIO = 0;
+
+	/** Memory access macros. **/
+#define RB(addr)	Bus::ReadB(z80, (uint16_t)(addr))
+#define WB(addr, data)	Bus::WriteB(z80, (uint16_t)(addr), (uint8_t)(data))
+#define FETCH()		Bus::Fetch(z80, PC++)
+#define FETCH16(dest) do { \
+	const uint8_t lo = FETCH(); \
+	dest = lo | (FETCH() << 8); \
+} while (0)
+#define RW(dest, addr) do { \
+	const uint16_t a = (uint16_t)(addr); \
+	dest = RB(a) | (RB(a + 1) << 8); \
+} while (0)
+#define WW(addr, data) do { \
+	const uint16_t a = (uint16_t)(addr); \
+	const uint16_t d = (data); \
+	WB(a, d & 0xFF); \
+	WB(a + 1, d >> 8); \
+} while (0)
+#define PUSH(data) do { \
+	const uint16_t d = (data); \
+	WB(--SP, d >> 8); \
+	WB(--SP, d & 0xFF); \
+} while (0)
+#define POP(dest) do { \
+	const uint8_t lo = RB(SP++); \
+	dest = lo | (RB(SP++) << 8); \
+} while (0)
+
+	/** 8-bit register access. **/
+#define GET_A		A
+#define SET_A(v)	A = (v)
+#define GET_B		((uint8_t)(BC >> 8))
+#define SET_B(v)	BC = (uint16_t)((BC & 0x00FF) | ((v) << 8))
+#define GET_C		((uint8_t)BC)
+#define SET_C(v)	BC = (uint16_t)((BC & 0xFF00) | (v))
+#define GET_D		((uint8_t)(DE >> 8))
+#define SET_D(v)	DE = (uint16_t)((DE & 0x00FF) | ((v) << 8))
+#define GET_E		((uint8_t)DE)
+#define SET_E(v)	DE = (uint16_t)((DE & 0xFF00) | (v))
+#define GET_H		((uint8_t)(HL >> 8))
+#define SET_H(v)	HL = (uint16_t)((HL & 0x00FF) | ((v) << 8))
+#define GET_L		((uint8_t)HL)
+#define SET_L(v)	HL = (uint16_t)((HL & 0xFF00) | (v))
+#define XY		(*pXY)
+#define GET_XH		((uint8_t)(XY >> 8))
+#define SET_XH(v)	XY = (uint16_t)((XY & 0x00FF) | ((v) << 8))
+#define GET_XL		((uint8_t)XY)
+#define SET_XL(v)	XY = (uint16_t)((XY & 0xFF00) | (v))
+
+	/** ALU operations. **/
+#define ALU_ADD(v)	mdZ80_add8(A, F, (v), 0)
+#define ALU_ADC(v)	mdZ80_add8(A, F, (v), (F & Z80_FLAG_C))
+#define ALU_SUB(v)	mdZ80_sub8(A, F, (v), 0)
+#define ALU_SBC(v)	mdZ80_sub8(A, F, (v), (F & Z80_FLAG_C))
+#define ALU_AND(v)	do { A &= (v); F = mdZ80_szxyp(A) | Z80_FLAG_H; } while (0)
+#define ALU_XOR(v)	do { A ^= (v); F = mdZ80_szxyp(A); } while (0)
+#define ALU_OR(v)	do { A |= (v); F = mdZ80_szxyp(A); } while (0)
+#define ALU_CP(v)	mdZ80_cp8(A, F, (v))
+
+	/** Conditions. **/
+#define COND_NZ		(!(F & Z80_FLAG_Z))
+#define COND_Z		(F & Z80_FLAG_Z)
+#define COND_NC		(!(F & Z80_FLAG_C))
+#define COND_C		(F & Z80_FLAG_C)
+#define COND_PO		(!(F & Z80_FLAG_P))
+#define COND_PE		(F & Z80_FLAG_P)
+#define COND_P		(!(F & Z80_FLAG_S))
+#define COND_M		(F & Z80_FLAG_S)
+
+	/** Opcode dispatch. **/
+#ifdef MDZ80_USE_COMPUTED_GOTO
+#define OP(op)		op_##op
+#define NEXT(n) do { \
+	cycles += (n); \
+	if (cycles >= limit) \
+		goto quit; \
+	opcode = FETCH(); \
+	R++; \
+	goto *op_table[opcode]; \
+} while (0)
+#define L16(h) \
+	&&op_##h##0, &&op_##h##1, &&op_##h##2, &&op_##h##3, \
+	&&op_##h##4, &&op_##h##5, &&op_##h##6, &&op_##h##7, \
+	&&op_##h##8, &&op_##h##9, &&op_##h##A, &&op_##h##B, \
+	&&op_##h##C, &&op_##h##D, &&op_##h##E, &&op_##h##F
+	static const void *const op_table[256] = {
+		L16(0), L16(1), L16(2), L16(3), L16(4), L16(5), L16(6), L16(7),
+		L16(8), L16(9), L16(A), L16(B), L16(C), L16(D), L16(E), L16(F)
+	};
+#undef L16
+#else /* !MDZ80_USE_COMPUTED_GOTO */
+#define OP(op)		case 0x##op
+#define NEXT(n) do { \
+	cycles += (n); \
+	goto next; \
+} while (0)
+#endif /* MDZ80_USE_COMPUTED_GOTO */
+
+	/** Instruction macros. **/
+#define LD_R_R(op, dst, src) \
+	OP(op): SET_##dst(GET_##src); NEXT(4);
+#define LD_R_N(op, dst) \
+	OP(op): SET_##dst(FETCH()); NEXT(7);
+#define LD_R_mHL(op, dst) \
+	OP(op): SET_##dst(RB(HL)); NEXT(7);
+#define LD_mHL_R(op, src) \
+	OP(op): WB(HL, GET_##src); NEXT(7);
+#define INC_R(op, reg) \
+	OP(op): SET_##reg(mdZ80_inc8(F, GET_##reg)); NEXT(4);
+#define DEC_R(op, reg) \
+	OP(op): SET_##reg(mdZ80_dec8(F, GET_##reg)); NEXT(4);
+#define ALU_R(op, alu, src) \
+	OP(op): ALU_##alu(GET_##src); NEXT(4);
+#define ALU_mHL(op, alu) \
+	OP(op): ALU_##alu(RB(HL)); NEXT(7);
+#define ALU_N(op, alu) \
+	OP(op): ALU_##alu(FETCH()); NEXT(7);
+#define JR_CC(op, cc) \
+	OP(op): { \
+		const int8_t d = (int8_t)FETCH(); \
+		if (cc) { \
+			PC += d; \
+			WZ = PC; \
+			NEXT(12); \
+		} \
+		NEXT(7); \
+	}
+#define JP_CC(op, cc) \
+	OP(op): \
+		FETCH16(WZ); \
+		if (cc) \
+			PC = WZ; \
+		NEXT(10);
+#define CALL_CC(op, cc) \
+	OP(op): \
+		FETCH16(WZ); \
+		if (cc) { \
+			PUSH(PC); \
+			PC = WZ; \
+			NEXT(17); \
+		} \
+		NEXT(10);
+#define RET_CC(op, cc) \
+	OP(op): \
+		if (cc) { \
+			POP(PC); \
+			WZ = PC; \
+			NEXT(11); \
+		} \
+		NEXT(5);
+#define RST(op, addr) \
+	OP(op): \
+		PUSH(PC); \
+		PC = (addr); \
+		WZ = PC; \
+		NEXT(11);
+
+	// Start running.
+#ifdef MDZ80_USE_COMPUTED_GOTO
+	NEXT(0);
+#else
+next:
+	if (cycles >= limit)
+		goto quit;
+	opcode = FETCH();
+	R++;
+dispatch:
+	switch (opcode) {
+#endif
+
+	/** 0x00-0x3F **/
+	OP(00): NEXT(4);	// NOP
+	OP(01): FETCH16(BC); NEXT(10);
+	OP(02): WB(BC, A); WZ = ((A << 8) | ((BC + 1) & 0xFF)); NEXT(7);
+	OP(03): BC++; NEXT(6);
+	INC_R(04, B)
+	DEC_R(05, B)
+	LD_R_N(06, B)
+	OP(07):	// RLCA
+		A = (A << 1) | (A >> 7);
+		F = (F & (Z80_FLAG_S | Z80_FLAG_Z | Z80_FLAG_P)) |
+		    (A & (Z80_FLAG_Y | Z80_FLAG_X | Z80_FLAG_C));
+		NEXT(4);
+	OP(08): {	// EX AF,AF'
+		const uint8_t A2 = z80->AF2.b.A2;
+		const uint8_t F2 = (z80->AF2.b.F2 & ~(Z80_FLAG_X | Z80_FLAG_Y)) |
+				   (z80->AF2.b.FXY2 & (Z80_FLAG_X | Z80_FLAG_Y));
+		z80->AF2.b.A2 = A;
+		z80->AF2.b.F2 = F;
+		z80->AF2.b.FXY2 = F;
+		A = A2;
+		F = F2;
+		NEXT(4);
+	}
+	OP(09): WZ = HL + 1; HL = mdZ80_add16(F, HL, BC); NEXT(11);
+	OP(0A): A = RB(BC); WZ = BC + 1; NEXT(7);
+	OP(0B): BC--; NEXT(6);
+	INC_R(0C, C)
+	DEC_R(0D, C)
+	LD_R_N(0E, C)
+	OP(0F): {	// RRCA
+		const uint8_t c = (A & 1);
+		A = (A >> 1) | (c << 7);
+		F = (F & (Z80_FLAG_S | Z80_FLAG_Z | Z80_FLAG_P)) |
+		    (A & (Z80_FLAG_Y | Z80_FLAG_X)) | c;
+		NEXT(4);
+	}
+
+	OP(10): {	// DJNZ
+		const int8_t d = (int8_t)FETCH();
+		BC -= 0x100;
+		if (BC & 0xFF00) {
+			PC += d;
+			WZ = PC;
+			NEXT(13);
+		}
+		NEXT(8);
+	}
+	OP(11): FETCH16(DE); NEXT(10);
+	OP(12): WB(DE, A); WZ = ((A << 8) | ((DE + 1) & 0xFF)); NEXT(7);
+	OP(13): DE++; NEXT(6);
+	INC_R(14, D)
+	DEC_R(15, D)
+	LD_R_N(16, D)
+	OP(17): {	// RLA
+		const uint8_t c = (A >> 7);
+		A = (A << 1) | (F & Z80_FLAG_C);
+		F = (F & (Z80_FLAG_S | Z80_FLAG_Z | Z80_FLAG_P)) |
+		    (A & (Z80_FLAG_Y | Z80_FLAG_X)) | c;
+		NEXT(4);
+	}
+	OP(18): {	// JR
+		const int8_t d = (int8_t)FETCH();
+		PC += d;
+		WZ = PC;
+		NEXT(12);
+	}
+	OP(19): WZ = HL + 1; HL = mdZ80_add16(F, HL, DE); NEXT(11);
+	OP(1A): A = RB(DE); WZ = DE + 1; NEXT(7);
+	OP(1B): DE--; NEXT(6);
+	INC_R(1C, E)
+	DEC_R(1D, E)
+	LD_R_N(1E, E)
+	OP(1F): {	// RRA
+		const uint8_t c = (A & 1);
+		A = (A >> 1) | ((F & Z80_FLAG_C) << 7);
+		F = (F & (Z80_FLAG_S | Z80_FLAG_Z | Z80_FLAG_P)) |
+		    (A & (Z80_FLAG_Y | Z80_FLAG_X)) | c;
+		NEXT(4);
+	}
+
+	JR_CC(20, COND_NZ)
+	OP(21): FETCH16(HL); NEXT(10);
+	OP(22): FETCH16(WZ); WW(WZ, HL); WZ++; NEXT(16);
+	OP(23): HL++; NEXT(6);
+	INC_R(24, H)
+	DEC_R(25, H)
+	LD_R_N(26, H)
+	OP(27): {	// DAA
+		uint8_t diff = 0;
+		uint8_t c = (F & Z80_FLAG_C);
+		uint8_t h;
+		if ((F & Z80_FLAG_H) || (A & 0x0F) > 9)
+			diff = 0x06;
+		if (c || A > 0x99) {
+			diff |= 0x60;
+			c = Z80_FLAG_C;
+		}
+		if (F & Z80_FLAG_N) {
+			h = ((F & Z80_FLAG_H) && (A & 0x0F) < 6) ? Z80_FLAG_H : 0;
+			A -= diff;
+		} else {
+			h = ((A & 0x0F) > 9) ? Z80_FLAG_H : 0;
+			A += diff;
+		}
+		F = mdZ80_szxyp(A) | h | (F & Z80_FLAG_N) | c;
+		NEXT(4);
+	}
+	JR_CC(28, COND_Z)
+	OP(29): WZ = HL + 1; HL = mdZ80_add16(F, HL, HL); NEXT(11);
+	OP(2A): FETCH16(WZ); RW(HL, WZ); WZ++; NEXT(16);
+	OP(2B): HL--; NEXT(6);
+	INC_R(2C, L)
+	DEC_R(2D, L)
+	LD_R_N(2E, L)
+	OP(2F):	// CPL
+		A = ~A;
+		F = (F & (Z80_FLAG_S | Z80_FLAG_Z | Z80_FLAG_P | Z80_FLAG_C)) |
+		    Z80_FLAG_H | Z80_FLAG_N | (A & (Z80_FLAG_Y | Z80_FLAG_X));
+		NEXT(4);
+
+	JR_CC(30, COND_NC)
+	OP(31): FETCH16(SP); NEXT(10);
+	OP(32): FETCH16(WZ); WB(WZ, A); WZ = ((A << 8) | ((WZ + 1) & 0xFF)); NEXT(13);
+	OP(33): SP++; NEXT(6);
+	OP(34): WB(HL, mdZ80_inc8(F, RB(HL))); NEXT(11);
+	OP(35): WB(HL, mdZ80_dec8(F, RB(HL))); NEXT(11);
+	OP(36): WB(HL, FETCH()); NEXT(10);
+	OP(37):	// SCF
+		F = (F & (Z80_FLAG_S | Z80_FLAG_Z | Z80_FLAG_P)) |
+		    (A & (Z80_FLAG_Y | Z80_FLAG_X)) | Z80_FLAG_C;
+		NEXT(4);
+	JR_CC(38, COND_C)
+	OP(39): WZ = HL + 1; HL = mdZ80_add16(F, HL, SP); NEXT(11);
+	OP(3A): FETCH16(WZ); A = RB(WZ); WZ++; NEXT(13);
+	OP(3B): SP--; NEXT(6);
+	INC_R(3C, A)
+	DEC_R(3D, A)
+	LD_R_N(3E, A)
+	OP(3F):	// CCF
+		F = ((F & (Z80_FLAG_S | Z80_FLAG_Z | Z80_FLAG_P | Z80_FLAG_C)) |
+		     ((F & Z80_FLAG_C) << 4) | (A & (Z80_FLAG_Y | Z80_FLAG_X))) ^ Z80_FLAG_C;
+		NEXT(4);
+
+	/** 0x40-0x7F: LD r,r' **/
+	LD_R_R(40, B, B) LD_R_R(41, B, C) LD_R_R(42, B, D) LD_R_R(43, B, E)
+	LD_R_R(44, B, H) LD_R_R(45, B, L) LD_R_mHL(46, B) LD_R_R(47, B, A)
+	LD_R_R(48, C, B) LD_R_R(49, C, C) LD_R_R(4A, C, D) LD_R_R(4B, C, E)
+	LD_R_R(4C, C, H) LD_R_R(4D, C, L) LD_R_mHL(4E, C) LD_R_R(4F, C, A)
+	LD_R_R(50, D, B) LD_R_R(51, D, C) LD_R_R(52, D, D) LD_R_R(53, D, E)
+	LD_R_R(54, D, H) LD_R_R(55, D, L) LD_R_mHL(56, D) LD_R_R(57, D, A)
+	LD_R_R(58, E, B) LD_R_R(59, E, C) LD_R_R(5A, E, D) LD_R_R(5B, E, E)
+	LD_R_R(5C, E, H) LD_R_R(5D, E, L) LD_R_mHL(5E, E) LD_R_R(5F, E, A)
+	LD_R_R(60, H, B) LD_R_R(61, H, C) LD_R_R(62, H, D) LD_R_R(63, H, E)
+	LD_R_R(64, H, H) LD_R_R(65, H, L) LD_R_mHL(66, H) LD_R_R(67, H, A)
+	LD_R_R(68, L, B) LD_R_R(69, L, C) LD_R_R(6A, L, D) LD_R_R(6B, L, E)
+	LD_R_R(6C, L, H) LD_R_R(6D, L, L) LD_R_mHL(6E, L) LD_R_R(6F, L, A)
+	LD_mHL_R(70, B) LD_mHL_R(71, C) LD_mHL_R(72, D) LD_mHL_R(73, E)
+	LD_mHL_R(74, H) LD_mHL_R(75, L)
+	OP(76):	// HALT
+		// The Z80 uses up the rest of its cycles
+		// until an interrupt is received.
+		z80->Status |= Z80_STATE_HALTED;
+		cycles = (limit_ei ? limit_ei : limit);
+		goto really_quit;
+	LD_mHL_R(77, A)
+	LD_R_R(78, A, B) LD_R_R(79, A, C) LD_R_R(7A, A, D) LD_R_R(7B, A, E)
+	LD_R_R(7C, A, H) LD_R_R(7D, A, L) LD_R_mHL(7E, A) LD_R_R(7F, A, A)
+
+	/** 0x80-0xBF: ALU A,r **/
+	ALU_R(80, ADD, B) ALU_R(81, ADD, C) ALU_R(82, ADD, D) ALU_R(83, ADD, E)
+	ALU_R(84, ADD, H) ALU_R(85, ADD, L) ALU_mHL(86, ADD) ALU_R(87, ADD, A)
+	ALU_R(88, ADC, B) ALU_R(89, ADC, C) ALU_R(8A, ADC, D) ALU_R(8B, ADC, E)
+	ALU_R(8C, ADC, H) ALU_R(8D, ADC, L) ALU_mHL(8E, ADC) ALU_R(8F, ADC, A)
+	ALU_R(90, SUB, B) ALU_R(91, SUB, C) ALU_R(92, SUB, D) ALU_R(93, SUB, E)
+	ALU_R(94, SUB, H) ALU_R(95, SUB, L) ALU_mHL(96, SUB) ALU_R(97, SUB, A)
+	ALU_R(98, SBC, B) ALU_R(99, SBC, C) ALU_R(9A, SBC, D) ALU_R(9B, SBC, E)
+	ALU_R(9C, SBC, H) ALU_R(9D, SBC, L) ALU_mHL(9E, SBC) ALU_R(9F, SBC, A)
+	ALU_R(A0, AND, B) ALU_R(A1, AND, C) ALU_R(A2, AND, D) ALU_R(A3, AND, E)
+	ALU_R(A4, AND, H) ALU_R(A5, AND, L) ALU_mHL(A6, AND) ALU_R(A7, AND, A)
+	ALU_R(A8, XOR, B) ALU_R(A9, XOR, C) ALU_R(AA, XOR, D) ALU_R(AB, XOR, E)
+	ALU_R(AC, XOR, H) ALU_R(AD, XOR, L) ALU_mHL(AE, XOR) ALU_R(AF, XOR, A)
+	ALU_R(B0, OR, B) ALU_R(B1, OR, C) ALU_R(B2, OR, D) ALU_R(B3, OR, E)
+	ALU_R(B4, OR, H) ALU_R(B5, OR, L) ALU_mHL(B6, OR) ALU_R(B7, OR, A)
+	ALU_R(B8, CP, B) ALU_R(B9, CP, C) ALU_R(BA, CP, D) ALU_R(BB, CP, E)
+	ALU_R(BC, CP, H) ALU_R(BD, CP, L) ALU_mHL(BE, CP) ALU_R(BF, CP, A)
+
+	/** 0xC0-0xFF **/
+	RET_CC(C0, COND_NZ)
+	OP(C1): POP(BC); NEXT(10);
+	JP_CC(C2, COND_NZ)
+	OP(C3): FETCH16(WZ); PC = WZ; NEXT(10);
+	CALL_CC(C4, COND_NZ)
+	OP(C5): PUSH(BC); NEXT(11);
+	ALU_N(C6, ADD)
+	RST(C7, 0x00)
+	RET_CC(C8, COND_Z)
+	OP(C9): POP(PC); WZ = PC; NEXT(10);
+	JP_CC(CA, COND_Z)
+	OP(CB): {
+		// CB prefix: Rotate, shift, and bit instructions.
+		opcode = FETCH();
+		R++;
+		const unsigned int reg = (opcode & 7);
+		const unsigned int op = ((opcode >> 3) & 7);
+		uint8_t v;
+		switch (reg) {
+			case 0: v = GET_B; break;
+			case 1: v = GET_C; break;
+			case 2: v = GET_D; break;
+			case 3: v = GET_E; break;
+			case 4: v = GET_H; break;
+			case 5: v = GET_L; break;
+			case 6: v = RB(HL); break;
+			default: v = A; break;
+		}
+
+		switch (opcode >> 6) {
+			case 0:	// Rotate/shift
+				v = mdZ80_rot8(F, op, v);
+				break;
+			case 1:	// BIT
+				// BIT n,(HL) takes X and Y from WZ.
+				mdZ80_bit(F, op, v, (reg == 6 ? (WZ >> 8) : v));
+				NEXT(reg == 6 ? 12 : 8);
+			case 2:	// RES
+				v &= ~(1 << op);
+				break;
+			default:	// SET
+				v |= (1 << op);
+				break;
+		}
+
+		switch (reg) {
+			case 0: SET_B(v); break;
+			case 1: SET_C(v); break;
+			case 2: SET_D(v); break;
+			case 3: SET_E(v); break;
+			case 4: SET_H(v); break;
+			case 5: SET_L(v); break;
+			case 6: WB(HL, v); NEXT(15);
+			default: A = v; break;
+		}
+		NEXT(8);
+	}
+	CALL_CC(CC, COND_Z)
+	OP(CD): FETCH16(WZ); PUSH(PC); PC = WZ; NEXT(17);
+	ALU_N(CE, ADC)
+	RST(CF, 0x08)
+
+	RET_CC(D0, COND_NC)
+	OP(D1): POP(DE); NEXT(10);
+	JP_CC(D2, COND_NC)
+	OP(D3): {	// OUT (n),A
+		const uint8_t n = FETCH();
+		Bus::Out(z80, (A << 8) | n, A);
+		WZ = ((A << 8) | ((n + 1) & 0xFF));
+		NEXT(11);
+	}
+	CALL_CC(D4, COND_NC)
+	OP(D5): PUSH(DE); NEXT(11);
+	ALU_N(D6, SUB)
+	RST(D7, 0x10)
+	RET_CC(D8, COND_C)
+	OP(D9): {	// EXX
+		uint16_t tmp;
+		tmp = z80->BC2; z80->BC2 = BC; BC = tmp;
+		tmp = z80->DE2; z80->DE2 = DE; DE = tmp;
+		tmp = z80->HL2; z80->HL2 = HL; HL = tmp;
+		NEXT(4);
+	}
+	JP_CC(DA, COND_C)
+	OP(DB): {	// IN A,(n)
+		const uint16_t port = ((A << 8) | FETCH());
+		A = Bus::In(z80, port);
+		WZ = port + 1;
+		NEXT(11);
+	}
+	CALL_CC(DC, COND_C)
+	OP(DD):
+		pXY = &IX;
+		goto index_prefix;
+	ALU_N(DE, SBC)
+	RST(DF, 0x18)
+
+	RET_CC(E0, COND_PO)
+	OP(E1): POP(HL); NEXT(10);
+	JP_CC(E2, COND_PO)
+	OP(E3): {	// EX (SP),HL
+		RW(WZ, SP);
+		WW(SP, HL);
+		HL = WZ;
+		NEXT(19);
+	}
+	CALL_CC(E4, COND_PO)
+	OP(E5): PUSH(HL); NEXT(11);
+	ALU_N(E6, AND)
+	RST(E7, 0x20)
+	RET_CC(E8, COND_PE)
+	OP(E9): PC = HL; NEXT(4);
+	JP_CC(EA, COND_PE)
+	OP(EB): { const uint16_t tmp = DE; DE = HL; HL = tmp; NEXT(4); }
+	CALL_CC(EC, COND_PE)
+	OP(ED):
+		goto ed_prefix;
+	ALU_N(EE, XOR)
+	RST(EF, 0x28)
+
+	RET_CC(F0, COND_P)
+	OP(F1): {	// POP AF
+		uint16_t AF;
+		POP(AF);
+		A = (AF >> 8);
+		F = (AF & 0xFF);
+		NEXT(10);
+	}
+	JP_CC(F2, COND_P)
+	OP(F3): IFF = 0; NEXT(4);	// DI
+	CALL_CC(F4, COND_P)
+	OP(F5): PUSH((A << 8) | F); NEXT(11);
+	ALU_N(F6, OR)
+	RST(F7, 0x30)
+	RET_CC(F8, COND_M)
+	OP(F9): SP = HL; NEXT(6);
+	JP_CC(FA, COND_M)
+	OP(FB):	// EI
+		// Interrupts are checked after the next instruction.
+		IFF = 3;
+		cycles += 4;
+		if (!limit_ei)
+			limit_ei = limit;
+		limit = cycles;
+		opcode = FETCH();
+		R++;
+#ifdef MDZ80_USE_COMPUTED_GOTO
+		goto *op_table[opcode];
+#else
+		goto dispatch;
+#endif
+	CALL_CC(FC, COND_M)
+	OP(FD):
+		pXY = &IY;
+		goto index_prefix;
+	ALU_N(FE, CP)
+	RST(FF, 0x38)
+
+#ifndef MDZ80_USE_COMPUTED_GOTO
+	}
+#endif
+
+ed_prefix:
+	// ED prefix: Extended instructions.
+	opcode = FETCH();
+	R++;
+	switch (opcode) {
+		/** I/O **/
+		case 0x40: case 0x48: case 0x50: case 0x58:
+		case 0x60: case 0x68: case 0x70: case 0x78: {
+			// IN r,(C)
+			const uint8_t v = Bus::In(z80, BC);
+			WZ = BC + 1;
+			F = (F & Z80_FLAG_C) | mdZ80_szxyp(v);
+			switch ((opcode >> 3) & 7) {
+				case 0: SET_B(v); break;
+				case 1: SET_C(v); break;
+				case 2: SET_D(v); break;
+				case 3: SET_E(v); break;
+				case 4: SET_H(v); break;
+				case 5: SET_L(v); break;
+				case 6: break;	// IN F,(C): Only flags are affected.
+				default: A = v; break;
+			}
+			NEXT(12);
+		}
+		case 0x41: case 0x49: case 0x51: case 0x59:
+		case 0x61: case 0x69: case 0x71: case 0x79: {
+			// OUT (C),r
+			uint8_t v;
+			switch ((opcode >> 3) & 7) {
+				case 0: v = GET_B; break;
+				case 1: v = GET_C; break;
+				case 2: v = GET_D; break;
+				case 3: v = GET_E; break;
+				case 4: v = GET_H; break;
+				case 5: v = GET_L; break;
+				case 6: v = 0; break;	// OUT (C),0
+				default: v = A; break;
+			}
+			Bus::Out(z80, BC, v);
+			WZ = BC + 1;
+			NEXT(12);
+		}
+
+		/** 16-bit arithmetic **/
+		case 0x42: WZ = HL + 1; HL = mdZ80_sbc16(F, HL, BC); NEXT(15);
+		case 0x52: WZ = HL + 1; HL = mdZ80_sbc16(F, HL, DE); NEXT(15);
+		case 0x62: WZ = HL + 1; HL = mdZ80_sbc16(F, HL, HL); NEXT(15);
+		case 0x72: WZ = HL + 1; HL = mdZ80_sbc16(F, HL, SP); NEXT(15);
+		case 0x4A: WZ = HL + 1; HL = mdZ80_adc16(F, HL, BC); NEXT(15);
+		case 0x5A: WZ = HL + 1; HL = mdZ80_adc16(F, HL, DE); NEXT(15);
+		case 0x6A: WZ = HL + 1; HL = mdZ80_adc16(F, HL, HL); NEXT(15);
+		case 0x7A: WZ = HL + 1; HL = mdZ80_adc16(F, HL, SP); NEXT(15);
+
+		/** 16-bit loads **/
+		case 0x43: FETCH16(WZ); WW(WZ, BC); WZ++; NEXT(20);
+		case 0x53: FETCH16(WZ); WW(WZ, DE); WZ++; NEXT(20);
+		case 0x63: FETCH16(WZ); WW(WZ, HL); WZ++; NEXT(20);
+		case 0x73: FETCH16(WZ); WW(WZ, SP); WZ++; NEXT(20);
+		case 0x4B: FETCH16(WZ); RW(BC, WZ); WZ++; NEXT(20);
+		case 0x5B: FETCH16(WZ); RW(DE, WZ); WZ++; NEXT(20);
+		case 0x6B: FETCH16(WZ); RW(HL, WZ); WZ++; NEXT(20);
+		case 0x7B: FETCH16(WZ); RW(SP, WZ); WZ++; NEXT(20);
+
+		case 0x44: case 0x4C: case 0x54: case 0x5C:
+		case 0x64: case 0x6C: case 0x74: case 0x7C: {
+			// NEG
+			const uint8_t v = A;
+			A = 0;
+			mdZ80_sub8(A, F, v, 0);
+			NEXT(8);
+		}
+
+		case 0x45: case 0x4D: case 0x55: case 0x5D:
+		case 0x65: case 0x6D: case 0x75: case 0x7D:
+			// RETN, RETI
+			// Both instructions copy IFF2 into IFF1.
+			IFF = (IFF & 2) | ((IFF >> 1) & 1);
+			POP(PC);
+			WZ = PC;
+			NEXT(14);
+
+		case 0x46: case 0x4E: case 0x66: case 0x6E:
+			z80->IM = 0;
+			NEXT(8);
+		case 0x56: case 0x76:
+			z80->IM = 1;
+			NEXT(8);
+		case 0x5E: case 0x7E:
+			z80->IM = 2;
+			NEXT(8);
+
+		case 0x47: z80->I = A; NEXT(9);		// LD I,A
+		case 0x4F: R = A; R7 = (A & 0x80); NEXT(9);	// LD R,A
+		case 0x57:	// LD A,I
+			A = z80->I;
+			F = (F & Z80_FLAG_C) | mdZ80_szxy(A) | ((IFF & 2) << 1);
+			NEXT(9);
+		case 0x5F:	// LD A,R
+			A = (R & 0x7F) | R7;
+			F = (F & Z80_FLAG_C) | mdZ80_szxy(A) | ((IFF & 2) << 1);
+			NEXT(9);
+
+		case 0x67: {	// RRD
+			const uint8_t v = RB(HL);
+			WB(HL, (A << 4) | (v >> 4));
+			A = (A & 0xF0) | (v & 0x0F);
+			F = (F & Z80_FLAG_C) | mdZ80_szxyp(A);
+			WZ = HL + 1;
+			NEXT(18);
+		}
+		case 0x6F: {	// RLD
+			const uint8_t v = RB(HL);
+			WB(HL, (v << 4) | (A & 0x0F));
+			A = (A & 0xF0) | (v >> 4);
+			F = (F & Z80_FLAG_C) | mdZ80_szxyp(A);
+			WZ = HL + 1;
+			NEXT(18);
+		}
+
+		/** Block transfer **/
+		case 0xA0: case 0xA8: case 0xB0: case 0xB8: {
+			// LDI, LDD, LDIR, LDDR
+			const uint8_t v = RB(HL);
+			WB(DE, v);
+			if (opcode & 0x08) {
+				HL--; DE--;
+			} else {
+				HL++; DE++;
+			}
+			BC--;
+			const uint8_t n = v + A;
+			F = (F & (Z80_FLAG_S | Z80_FLAG_Z | Z80_FLAG_C)) |
+			    (n & Z80_FLAG_X) | ((n << 4) & Z80_FLAG_Y) |
+			    (BC ? Z80_FLAG_P : 0);
+			if ((opcode & 0x10) && BC != 0) {
+				PC -= 2;
+				WZ = PC + 1;
+				NEXT(21);
+			}
+			NEXT(16);
+		}
+
+		case 0xA1: case 0xA9: case 0xB1: case 0xB9: {
+			// CPI, CPD, CPIR, CPDR
+			const uint8_t v = RB(HL);
+			const uint8_t r = A - v;
+			const uint8_t h = ((A ^ v ^ r) & Z80_FLAG_H);
+			if (opcode & 0x08) {
+				HL--; WZ--;
+			} else {
+				HL++; WZ++;
+			}
+			BC--;
+			const uint8_t n = r - (h >> 4);
+			F = (F & Z80_FLAG_C) | Z80_FLAG_N | (r & Z80_FLAG_S) |
+			    (r ? 0 : Z80_FLAG_Z) | h |
+			    (n & Z80_FLAG_X) | ((n << 4) & Z80_FLAG_Y) |
+			    (BC ? Z80_FLAG_P : 0);
+			if ((opcode & 0x10) && BC != 0 && r != 0) {
+				PC -= 2;
+				WZ = PC + 1;
+				NEXT(21);
+			}
+			NEXT(16);
+		}
+
+		case 0xA2: case 0xAA: case 0xB2: case 0xBA: {
+			// INI, IND, INIR, INDR
+			const uint8_t v = Bus::In(z80, BC);
+			WB(HL, v);
+			uint8_t c;
+			if (opcode & 0x08) {
+				WZ = BC - 1;
+				HL--;
+				c = GET_C - 1;
+			} else {
+				WZ = BC + 1;
+				HL++;
+				c = GET_C + 1;
+			}
+			BC -= 0x100;
+			const unsigned int k = v + c;
+			F = mdZ80_szxy(GET_B) | ((v >> 6) & Z80_FLAG_N) |
+			    (k > 0xFF ? (Z80_FLAG_H | Z80_FLAG_C) : 0) |
+			    mdZ80_parity((k & 7) ^ GET_B);
+			if ((opcode & 0x10) && GET_B != 0) {
+				PC -= 2;
+				NEXT(21);
+			}
+			NEXT(16);
+		}
+
+		case 0xA3: case 0xAB: case 0xB3: case 0xBB: {
+			// OUTI, OUTD, OTIR, OTDR
+			const uint8_t v = RB(HL);
+			BC -= 0x100;
+			Bus::Out(z80, BC, v);
+			if (opcode & 0x08) {
+				WZ = BC - 1;
+				HL--;
+			} else {
+				WZ = BC + 1;
+				HL++;
+			}
+			const unsigned int k = v + GET_L;
+			F = mdZ80_szxy(GET_B) | ((v >> 6) & Z80_FLAG_N) |
+			    (k > 0xFF ? (Z80_FLAG_H | Z80_FLAG_C) : 0) |
+			    mdZ80_parity((k & 7) ^ GET_B);
+			if ((opcode & 0x10) && GET_B != 0) {
+				PC -= 2;
+				NEXT(21);
+			}
+			NEXT(16);
+		}
+
+		default:
+			// Invalid opcode. Acts as two NOPs.
+			NEXT(8);
+	}
+
+index_prefix:
+	// DD/FD prefix: IX/IY instructions.
+	// Instructions that don't use HL, H, or L
+	// are executed normally with 4 extra cycles.
+	opcode = FETCH();
+	R++;
+	switch (opcode) {
+		case 0x09: WZ = XY + 1; XY = mdZ80_add16(F, XY, BC); NEXT(15);
+		case 0x19: WZ = XY + 1; XY = mdZ80_add16(F, XY, DE); NEXT(15);
+		case 0x29: WZ = XY + 1; XY = mdZ80_add16(F, XY, XY); NEXT(15);
+		case 0x39: WZ = XY + 1; XY = mdZ80_add16(F, XY, SP); NEXT(15);
+
+		case 0x21: FETCH16(XY); NEXT(14);
+		case 0x22: FETCH16(WZ); WW(WZ, XY); WZ++; NEXT(20);
+		case 0x2A: FETCH16(WZ); RW(XY, WZ); WZ++; NEXT(20);
+		case 0x23: XY++; NEXT(10);
+		case 0x2B: XY--; NEXT(10);
+
+		case 0x24: SET_XH(mdZ80_inc8(F, GET_XH)); NEXT(8);
+		case 0x25: SET_XH(mdZ80_dec8(F, GET_XH)); NEXT(8);
+		case 0x26: SET_XH(FETCH()); NEXT(11);
+		case 0x2C: SET_XL(mdZ80_inc8(F, GET_XL)); NEXT(8);
+		case 0x2D: SET_XL(mdZ80_dec8(F, GET_XL)); NEXT(8);
+		case 0x2E: SET_XL(FETCH()); NEXT(11);
+
+		case 0x34:
+			WZ = XY + (int8_t)FETCH();
+			WB(WZ, mdZ80_inc8(F, RB(WZ)));
+			NEXT(23);
+		case 0x35:
+			WZ = XY + (int8_t)FETCH();
+			WB(WZ, mdZ80_dec8(F, RB(WZ)));
+			NEXT(23);
+		case 0x36:
+			WZ = XY + (int8_t)FETCH();
+			WB(WZ, FETCH());
+			NEXT(19);
+
+		/** LD r,IXh/IXl **/
+		case 0x44: SET_B(GET_XH); NEXT(8);
+		case 0x45: SET_B(GET_XL); NEXT(8);
+		case 0x4C: SET_C(GET_XH); NEXT(8);
+		case 0x4D: SET_C(GET_XL); NEXT(8);
+		case 0x54: SET_D(GET_XH); NEXT(8);
+		case 0x55: SET_D(GET_XL); NEXT(8);
+		case 0x5C: SET_E(GET_XH); NEXT(8);
+		case 0x5D: SET_E(GET_XL); NEXT(8);
+		case 0x7C: A = GET_XH; NEXT(8);
+		case 0x7D: A = GET_XL; NEXT(8);
+
+		/** LD IXh/IXl,r **/
+		case 0x60: SET_XH(GET_B); NEXT(8);
+		case 0x61: SET_XH(GET_C); NEXT(8);
+		case 0x62: SET_XH(GET_D); NEXT(8);
+		case 0x63: SET_XH(GET_E); NEXT(8);
+		case 0x64: NEXT(8);
+		case 0x65: SET_XH(GET_XL); NEXT(8);
+		case 0x67: SET_XH(A); NEXT(8);
+		case 0x68: SET_XL(GET_B); NEXT(8);
+		case 0x69: SET_XL(GET_C); NEXT(8);
+		case 0x6A: SET_XL(GET_D); NEXT(8);
+		case 0x6B: SET_XL(GET_E); NEXT(8);
+		case 0x6C: SET_XL(GET_XH); NEXT(8);
+		case 0x6D: NEXT(8);
+		case 0x6F: SET_XL(A); NEXT(8);
+
+		/** LD r,(IX+d) **/
+		case 0x46: WZ = XY + (int8_t)FETCH(); SET_B(RB(WZ)); NEXT(19);
+		case 0x4E: WZ = XY + (int8_t)FETCH(); SET_C(RB(WZ)); NEXT(19);
+		case 0x56: WZ = XY + (int8_t)FETCH(); SET_D(RB(WZ)); NEXT(19);
+		case 0x5E: WZ = XY + (int8_t)FETCH(); SET_E(RB(WZ)); NEXT(19);
+		case 0x66: WZ = XY + (int8_t)FETCH(); SET_H(RB(WZ)); NEXT(19);
+		case 0x6E: WZ = XY + (int8_t)FETCH(); SET_L(RB(WZ)); NEXT(19);
+		case 0x7E: WZ = XY + (int8_t)FETCH(); A = RB(WZ); NEXT(19);
+
+		/** LD (IX+d),r **/
+		case 0x70: WZ = XY + (int8_t)FETCH(); WB(WZ, GET_B); NEXT(19);
+		case 0x71: WZ = XY + (int8_t)FETCH(); WB(WZ, GET_C); NEXT(19);
+		case 0x72: WZ = XY + (int8_t)FETCH(); WB(WZ, GET_D); NEXT(19);
+		case 0x73: WZ = XY + (int8_t)FETCH(); WB(WZ, GET_E); NEXT(19);
+		case 0x74: WZ = XY + (int8_t)FETCH(); WB(WZ, GET_H); NEXT(19);
+		case 0x75: WZ = XY + (int8_t)FETCH(); WB(WZ, GET_L); NEXT(19);
+		case 0x77: WZ = XY + (int8_t)FETCH(); WB(WZ, A); NEXT(19);
+
+		/** ALU A,IXh/IXl/(IX+d) **/
+		case 0x84: ALU_ADD(GET_XH); NEXT(8);
+		case 0x85: ALU_ADD(GET_XL); NEXT(8);
+		case 0x86: WZ = XY + (int8_t)FETCH(); ALU_ADD(RB(WZ)); NEXT(19);
+		case 0x8C: ALU_ADC(GET_XH); NEXT(8);
+		case 0x8D: ALU_ADC(GET_XL); NEXT(8);
+		case 0x8E: WZ = XY + (int8_t)FETCH(); ALU_ADC(RB(WZ)); NEXT(19);
+		case 0x94: ALU_SUB(GET_XH); NEXT(8);
+		case 0x95: ALU_SUB(GET_XL); NEXT(8);
+		case 0x96: WZ = XY + (int8_t)FETCH(); ALU_SUB(RB(WZ)); NEXT(19);
+		case 0x9C: ALU_SBC(GET_XH); NEXT(8);
+		case 0x9D: ALU_SBC(GET_XL); NEXT(8);
+		case 0x9E: WZ = XY + (int8_t)FETCH(); ALU_SBC(RB(WZ)); NEXT(19);
+		case 0xA4: ALU_AND(GET_XH); NEXT(8);
+		case 0xA5: ALU_AND(GET_XL); NEXT(8);
+		case 0xA6: WZ = XY + (int8_t)FETCH(); ALU_AND(RB(WZ)); NEXT(19);
+		case 0xAC: ALU_XOR(GET_XH); NEXT(8);
+		case 0xAD: ALU_XOR(GET_XL); NEXT(8);
+		case 0xAE: WZ = XY + (int8_t)FETCH(); ALU_XOR(RB(WZ)); NEXT(19);
+		case 0xB4: ALU_OR(GET_XH); NEXT(8);
+		case 0xB5: ALU_OR(GET_XL); NEXT(8);
+		case 0xB6: WZ = XY + (int8_t)FETCH(); ALU_OR(RB(WZ)); NEXT(19);
+		case 0xBC: ALU_CP(GET_XH); NEXT(8);
+		case 0xBD: ALU_CP(GET_XL); NEXT(8);
+		case 0xBE: WZ = XY + (int8_t)FETCH(); ALU_CP(RB(WZ)); NEXT(19);
+
+		case 0xCB: {
+			// DD CB d op: Indexed rotate, shift, and bit instructions.
+			// The result of rotate/shift/RES/SET is also copied
+			// to a register if the register field isn't (HL).
+			WZ = XY + (int8_t)FETCH();
+			opcode = FETCH();
+			const unsigned int op = ((opcode >> 3) & 7);
+			uint8_t v = RB(WZ);
+			switch (opcode >> 6) {
+				case 0:	// Rotate/shift
+					v = mdZ80_rot8(F, op, v);
+					break;
+				case 1:	// BIT
+					mdZ80_bit(F, op, v, (WZ >> 8));
+					NEXT(20);
+				case 2:	// RES
+					v &= ~(1 << op);
+					break;
+				default:	// SET
+					v |= (1 << op);
+					break;
+			}
+			WB(WZ, v);
+			switch (opcode & 7) {
+				case 0: SET_B(v); break;
+				case 1: SET_C(v); break;
+				case 2: SET_D(v); break;
+				case 3: SET_E(v); break;
+				case 4: SET_H(v); break;
+				case 5: SET_L(v); break;
+				case 6: break;
+				default: A = v; break;
+			}
+			NEXT(23);
+		}
+
+		case 0xE1: POP(XY); NEXT(14);
+		case 0xE3:	// EX (SP),IX
+			RW(WZ, SP);
+			WW(SP, XY);
+			XY = WZ;
+			NEXT(23);
+		case 0xE5: PUSH(XY); NEXT(15);
+		case 0xE9: PC = XY; NEXT(8);
+		case 0xF9: SP = XY; NEXT(10);
+
+		default:
+			// Not an index instruction.
+			cycles += 4;
+#ifdef MDZ80_USE_COMPUTED_GOTO
+			goto *op_table[opcode];
+#else
+			goto dispatch;
+#endif
+	}
+
+quit:
+	if (limit_ei) {
+		// EI was executed. Check for interrupts
+		// now that the next instruction has run.
+		limit = limit_ei;
+		limit_ei = 0;
+		if (z80->IntLine)
+			cycles += mdZ80_check_int<Bus>(z80, PC, SP, WZ, IFF, R);
+#ifdef MDZ80_USE_COMPUTED_GOTO
+		NEXT(0);
+#else
+		goto next;
+#endif
+	}
+
+really_quit:
+	// Save the registers.
+	z80->AF.b.A = A;
+	z80->AF.b.F = F;
+	z80->AF.b.FXY = F;
+	z80->BC.w = BC;
+	z80->DE.w = DE;
+	z80->HL.w = HL;
+	z80->IX.w = IX;
+	z80->IY.w = IY;
+	z80->SP.w = SP;
+	z80->PC = PC;
+	z80->WZ = WZ;
+	z80->IFF = IFF;
+	z80->R = (R & 0x7F) | R7;
+
+	// Cycles added by mdZ80_add_cycles() are subtracted from CycleIO.
+	cycles -= (int)z80->CycleIO;
+	z80->CycleCnt += cycles;
+	z80->CycleTD = 0;
+	z80->CycleIO = 0;
+	z80->Status &= ~Z80_STATE_RUNNING;
+	return 0;
+
+#undef RB
+#undef WB
+#undef FETCH
+#undef FETCH16
+#undef RW
+#undef WW
+#undef PUSH
+#undef POP
+#undef GET_A
+#undef SET_A
+#undef GET_B
+#undef SET_B
+#undef GET_C
+#undef SET_C
+#undef GET_D
+#undef SET_D
+#undef GET_E
+#undef SET_E
+#undef GET_H
+#undef SET_H
+#undef GET_L
+#undef SET_L
+#undef XY
+#undef GET_XH
+#undef SET_XH
+#undef GET_XL
+#undef SET_XL
+#undef ALU_ADD
+#undef ALU_ADC
+#undef ALU_SUB
+#undef ALU_SBC
+#undef ALU_AND
+#undef ALU_XOR
+#undef ALU_OR
+#undef ALU_CP
+#undef COND_NZ
+#undef COND_Z
+#undef COND_NC
+#undef COND_C
+#undef COND_PO
+#undef COND_PE
+#undef COND_P
+#undef COND_M
+#undef OP
+#undef NEXT
+#undef LD_R_R
+#undef LD_R_N
+#undef LD_R_mHL
+#undef LD_mHL_R
+#undef INC_R
+#undef DEC_R
+#undef ALU_R
+#undef ALU_mHL
+#undef ALU_N
+#undef JR_CC
+#undef JP_CC
+#undef CALL_CC
+#undef RET_CC
+#undef RST
+}
+
+#endif /* __MDZ80_CORE_HPP__ */
@@ -1,10 +1,10 @@
 /***************************************************************************
  * mdZ80: Gens Z80 Emulator                                                *
- * mdZ80_INC_DEC.c: Increment / Decrement.                                 *
+ * mdZ80_exec.cpp: Z80 execution using the context's memory handlers.      *
  *                                                                         *
  * Copyright (c) 1999-2002 by Stéphane Dallongeville                       *
  * Copyright (c) 2003-2004 by Stéphane Akhoun                              *
- * Copyright (c) 2008 by David Korth                                       *
+ * Copyright (c) 2008-2016 by David Korth                                  *
  *                                                                         *
  * This program is free software; you can redistribute it and/or modify it *
  * under the terms of the GNU General Public License as published by the   *
@@ -21,18 +21,49 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
  ***************************************************************************/
 
-#ifndef __MDZ80_INC_DEC_H
-#define __MDZ80_INC_DEC_H
+#include "mdZ80_core.hpp"
 
-#ifdef __cplusplus
-extern "C" {
-#endif
+/**
+ * Generic memory bus.
+ * Opcodes are fetched using the Fetch[] table;
+ * everything else goes through the context's
+ * memory and I/O handlers.
+ */
+struct mdZ80_Bus_Generic
+{
+	static inline uint8_t Fetch(mdZ80_context *z80, uint16_t address)
+	{
+		return z80->Fetch[address >> 8][address];
+	}
 
-extern const unsigned char mdZ80_INC_Flags_Table[256];
-extern const unsigned char mdZ80_DEC_Flags_Table[256];
+	static inline uint8_t ReadB(mdZ80_context *z80, uint16_t address)
+	{
+		return z80->ReadB(address);
+	}
 
-#ifdef __cplusplus
-}
-#endif
+	static inline void WriteB(mdZ80_context *z80, uint16_t address, uint8_t data)
+	{
+		z80->WriteB(address, data);
+	}
+
+	static inline uint8_t In(mdZ80_context *z80, uint16_t port)
+	{
+		return z80->IN_C(port);
+	}
 
-#endif /* __MDZ80_INC_DEC_H */
+	static inline void Out(mdZ80_context *z80, uint16_t port, uint8_t data)
+	{
+		z80->OUT_C(port, data);
+	}
+};
+
+/**
+ * Run the Z80.
+ * @param z80 Z80 context.
+ * @param odo Odometer value to run to.
+ * @return 0 on success; -1 if the odometer was already reached.
+ */
+int z80_Exec(mdZ80_context *z80, int odo)
+{
+	return mdZ80_exec<mdZ80_Bus_Generic>(z80, odo);
+}
@@ -70,9 +70,7 @@ uint16_t mdZ80_get_PC(mdZ80_context *z80)
 {
 	if (z80->Status & Z80_STATE_RUNNING)
 		return -1;
-	
-	// Subtract the BasePC from PC to get the actual Z80 program counter.
-	return (uint16_t)(z80->PC - z80->BasePC);
+	return (uint16_t)z80->PC;
 }
 
 Z80_GET_REGISTER_FUNC(uint16_t, SP, SP.w)
@@ -96,6 +94,7 @@ uint16_t mdZ80_get_AF2(mdZ80_context *z80)
 Z80_GET_REGISTER_FUNC(uint16_t, BC2, BC2)
 Z80_GET_REGISTER_FUNC(uint16_t, DE2, DE2)
 Z80_GET_REGISTER_FUNC(uint16_t, HL2, HL2)
+Z80_GET_REGISTER_FUNC(uint16_t, WZ, WZ)
 
 uint8_t mdZ80_get_IFF(mdZ80_context *z80)
 {
@@ -150,15 +149,9 @@ Z80_SET_REGISTER_FUNC(uint16_t, IY, IY.w)
  */
 void mdZ80_set_PC(mdZ80_context *z80, uint16_t data)
 {
-	unsigned int newPC;
 	if (z80->Status & Z80_STATE_RUNNING)
 		return;
-
-	// TODO: 32-bit specific code will break on 64-bit!
-	data &= 0xFFFF;
-	newPC = (unsigned int)(z80->Fetch[data >> 8]);
-	z80->BasePC = newPC;
-	z80->PC = newPC + data;
+	z80->PC = data;
 }
 
 Z80_SET_REGISTER_FUNC(uint16_t, SP, SP.w)
@@ -187,6 +180,7 @@ void mdZ80_set_AF2(mdZ80_context *z80, uint16_t data)
 Z80_SET_REGISTER_FUNC(uint16_t, BC2, BC2)
 Z80_SET_REGISTER_FUNC(uint16_t, DE2, DE2)
 Z80_SET_REGISTER_FUNC(uint16_t, HL2, HL2)
+Z80_SET_REGISTER_FUNC(uint16_t, WZ, WZ)
 
 /**
  * Set the IFF flip-flops
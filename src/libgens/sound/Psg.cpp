@@ -51,6 +51,9 @@
 /* Message logging. */
 #include "macros/log_msg.h"
 
+// Profiler.
+#include "Util/Profiler.hpp"
+
 #if 0
 /* GSX v7 savestate functionality. */
 #include "util/file/gsx_v7.h"
@@ -80,6 +83,8 @@ const Zomg_PsgSave_t PsgPrivate::psgStateInit =
 
 PsgPrivate::PsgPrivate(Psg *q)
 	: q(q)
+	, writeLogFn(nullptr)
+	, writeLogParam(nullptr)
 	, writeLen(0)
 	, enabled(true)	// TODO: Make this customizable.
 {
@@ -263,16 +268,27 @@ void Psg::reInit(int clock, int rate)
 	reset();
 }
 
+/**
+ * Set the register write log function.
+ * This is used for VGM capture.
+ * @param fn Write log function, or nullptr to disable logging.
+ * @param param Parameter for fn.
+ */
+void Psg::setWriteLog(WriteLogFn fn, void *param)
+{
+	d->writeLogFn = fn;
+	d->writeLogParam = param;
+}
+
 /**
  * Write to the PSG's data port.
  * @param data Data value.
  */
 void Psg::write(uint8_t data)
 {
-#if 0 // TODO: GYM
-	if (GYM_Dumping)
-		gym_dump_update(3, (uint8_t)data, 0);
-#endif
+	if (d->writeLogFn) {
+		d->writeLogFn(d->writeLogParam, data);
+	}
 
 	// TODO: Combine the masking used in both cases.
 	if (data & 0x80) {
@@ -415,6 +431,8 @@ void Psg::zomgRestore(const Zomg_PsgSave_t *state)
  */
 void Psg::specialUpdate(void)
 {
+	PROFILE_SCOPE(PSG_SPECIALUPDATE);
+
 	if (d->writeLen <= 0 || !d->enabled)
 		return;
 
@@ -81,6 +81,22 @@ class Psg
 		// Reset buffer pointers.
 		void resetBufferPtrs(void);
 
+		/**
+		 * Register write log function.
+		 * Called for every write to the PSG's data port.
+		 * @param param Parameter passed to setWriteLog().
+		 * @param data Data value.
+		 */
+		typedef void (*WriteLogFn)(void *param, uint8_t data);
+
+		/**
+		 * Set the register write log function.
+		 * This is used for VGM capture.
+		 * @param fn Write log function, or nullptr to disable logging.
+		 * @param param Parameter for fn.
+		 */
+		void setWriteLog(WriteLogFn fn, void *param);
+
 	public:
 		// Super secret debug stuff!
 		// For use by MDP plugins and test suites.
@@ -53,6 +53,10 @@ class PsgPrivate
 		// Initial PSG state.
 		static const Zomg_PsgSave_t psgStateInit;
 
+		// Register write log.
+		Psg::WriteLogFn writeLogFn;
+		void *writeLogParam;
+
 		// Internal state.
 		int curChan;	// Current channel.
 		int curReg;	// Current register.
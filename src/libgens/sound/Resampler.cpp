@@ -0,0 +1,465 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Resampler.cpp: Polyphase windowed-sinc audio resampler.                 *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "Resampler.hpp"
+#include "libcompat/cpuflags.h"
+#include "macros/simd.h"
+
+// C includes.
+#include <stdlib.h>
+
+// C includes. (C++ namespace)
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+
+// C++ includes.
+#include <algorithm>
+
+// aligned_malloc()
+#include "libcompat/aligned_malloc.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace LibGens {
+
+class ResamplerPrivate
+{
+	public:
+		ResamplerPrivate();
+		~ResamplerPrivate();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		ResamplerPrivate(const ResamplerPrivate &);
+		ResamplerPrivate &operator=(const ResamplerPrivate &);
+
+	public:
+		// Input buffer size, in samples per channel.
+		static const int BUF_SIZE = 4096;
+
+		// Fraction bits used to select a filter phase.
+		// PHASES == (1 << PHASE_BITS)
+		static const int PHASE_BITS = 8;
+
+		// Kaiser window beta. (~90 dB stopband attenuation)
+		static const double KAISER_BETA;
+		// Cutoff frequency, relative to the lower Nyquist frequency.
+		static const double CUTOFF;
+
+		int inRate;
+		int outRate;
+		double adjust;
+
+		// Filter coefficients: [PHASES+1][TAPS]
+		// The extra phase is used for interpolation.
+		float *coeffs;
+
+		// Input buffers.
+		// The first TAPS samples are history.
+		float *bufL;
+		float *bufR;
+		int len;		// Number of samples in the input buffers.
+
+		// Position of the next output sample, relative to
+		// the start of the input buffers. (32.32 fixed-point)
+		uint64_t pos;
+		// Input samples per output sample. (32.32 fixed-point)
+		uint64_t step;
+
+		/**
+		 * Zeroth-order modified Bessel function of the first kind.
+		 * @param x Value.
+		 * @return I0(x)
+		 */
+		static double besselI0(double x);
+
+		/**
+		 * Calculate the filter coefficients.
+		 */
+		void calcFilter(void);
+
+		/**
+		 * Calculate the step value from the current rates.
+		 */
+		void calcStep(void);
+
+		/**
+		 * Discard input samples that are no longer needed.
+		 */
+		void compact(void);
+
+		/**
+		 * Generate output samples from the input buffers.
+		 * @param dest Destination buffer. (interleaved if stereo)
+		 * @param maxOut Maximum number of samples to write to dest.
+		 * @param mono If true, downmix to monaural.
+		 * @return Number of samples written.
+		 */
+		int run(int16_t *dest, int maxOut, bool mono);
+
+		int run_generic(int16_t *dest, int maxOut, bool mono);
+#ifdef HAVE_SSE2_INTRIN
+		int run_SSE2(int16_t *dest, int maxOut, bool mono);
+#endif /* HAVE_SSE2_INTRIN */
+#ifdef HAVE_NEON_INTRIN
+		int run_NEON(int16_t *dest, int maxOut, bool mono);
+#endif /* HAVE_NEON_INTRIN */
+};
+
+/** ResamplerPrivate **/
+
+const double ResamplerPrivate::KAISER_BETA = 9.0;
+const double ResamplerPrivate::CUTOFF = 0.94;
+
+ResamplerPrivate::ResamplerPrivate()
+	: inRate(0)
+	, outRate(0)
+	, adjust(1.0)
+	, len(0)
+	, pos(0)
+	, step(0)
+{
+	static_assert(Resampler::PHASES == (1 << PHASE_BITS), "PHASES != (1 << PHASE_BITS)");
+	static_assert((Resampler::TAPS % 4) == 0, "TAPS must be a multiple of 4.");
+
+	coeffs = (float*)aligned_malloc(16, (Resampler::PHASES + 1) * Resampler::TAPS * sizeof(float));
+	bufL = (float*)aligned_malloc(16, BUF_SIZE * sizeof(float));
+	bufR = (float*)aligned_malloc(16, BUF_SIZE * sizeof(float));
+	memset(coeffs, 0, (Resampler::PHASES + 1) * Resampler::TAPS * sizeof(float));
+}
+
+ResamplerPrivate::~ResamplerPrivate()
+{
+	aligned_free(coeffs);
+	aligned_free(bufL);
+	aligned_free(bufR);
+}
+
+/**
+ * Zeroth-order modified Bessel function of the first kind.
+ * @param x Value.
+ * @return I0(x)
+ */
+double ResamplerPrivate::besselI0(double x)
+{
+	// Power series. Converges quickly for the
+	// range of values used by the Kaiser window.
+	double sum = 1.0, term = 1.0;
+	const double x2 = (x * x) / 4.0;
+	for (int k = 1; k < 64; k++) {
+		term *= x2 / ((double)k * (double)k);
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+/**
+ * Calculate the filter coefficients.
+ */
+void ResamplerPrivate::calcFilter(void)
+{
+	// Cutoff frequency, in cycles per input sample.
+	// When downsampling, the cutoff is lowered to
+	// the output rate's Nyquist frequency.
+	const double fc = 0.5 * CUTOFF * std::min(1.0, (double)outRate / (double)inRate);
+	const double half = Resampler::TAPS / 2;
+	const double i0beta = besselI0(KAISER_BETA);
+
+	float *coef = coeffs;
+	for (int p = 0; p <= Resampler::PHASES; p++) {
+		double sum = 0.0;
+		double tmp[Resampler::TAPS];
+		for (int j = 0; j < Resampler::TAPS; j++) {
+			// Distance from the output position to this tap.
+			const double t = (half - 1 - j) + ((double)p / Resampler::PHASES);
+
+			// Windowed sinc.
+			const double x = 2.0 * fc * t;
+			const double sinc = (x == 0.0 ? 1.0 : sin(M_PI * x) / (M_PI * x));
+			const double w = t / half;
+			const double win = (std::abs(w) >= 1.0 ? 0.0
+				: besselI0(KAISER_BETA * sqrt(1.0 - (w * w))) / i0beta);
+			tmp[j] = 2.0 * fc * sinc * win;
+			sum += tmp[j];
+		}
+
+		// Normalize each phase to unity gain at DC.
+		for (int j = 0; j < Resampler::TAPS; j++) {
+			*coef++ = (float)(tmp[j] / sum);
+		}
+	}
+}
+
+/**
+ * Calculate the step value from the current rates.
+ */
+void ResamplerPrivate::calcStep(void)
+{
+	const double ratio = (double)inRate / ((double)outRate * adjust);
+	step = (uint64_t)llround(ratio * 4294967296.0);
+}
+
+/**
+ * Discard input samples that are no longer needed.
+ */
+void ResamplerPrivate::compact(void)
+{
+	int consumed = (int)(pos >> 32);
+	if (consumed > len)
+		consumed = len;
+	if (consumed <= 0)
+		return;
+
+	len -= consumed;
+	memmove(bufL, &bufL[consumed], len * sizeof(float));
+	memmove(bufR, &bufR[consumed], len * sizeof(float));
+	pos -= ((uint64_t)consumed << 32);
+}
+
+}
+
+// Generic version.
+#define __IN_LIBGENS_RESAMPLER_CPP__
+#include "Resampler.generic.inc.cpp"
+
+// Intrinsics versions.
+#ifdef HAVE_SSE2_INTRIN
+#include "Resampler.sse2.inc.cpp"
+#endif
+#ifdef HAVE_NEON_INTRIN
+#include "Resampler.neon.inc.cpp"
+#endif
+
+namespace LibGens {
+
+/**
+ * Generate output samples from the input buffers.
+ * Selects the best implementation for the current CPU.
+ * @param dest Destination buffer. (interleaved if stereo)
+ * @param maxOut Maximum number of samples to write to dest.
+ * @param mono If true, downmix to monaural.
+ * @return Number of samples written.
+ */
+int ResamplerPrivate::run(int16_t *dest, int maxOut, bool mono)
+{
+#ifdef HAVE_SSE2_INTRIN
+	if (CPU_Flags & MDP_CPUFLAG_X86_SSE2) {
+		return run_SSE2(dest, maxOut, mono);
+	}
+#endif /* HAVE_SSE2_INTRIN */
+#ifdef HAVE_NEON_INTRIN
+	return run_NEON(dest, maxOut, mono);
+#endif /* HAVE_NEON_INTRIN */
+
+	return run_generic(dest, maxOut, mono);
+}
+
+/** Resampler **/
+
+Resampler::Resampler()
+	: d(new ResamplerPrivate())
+{
+	reset();
+}
+
+Resampler::~Resampler()
+{
+	delete d;
+}
+
+/**
+ * Set the input and output rates.
+ * This recalculates the filter and resets the resampler.
+ * @param inRate Input rate, in Hz.
+ * @param outRate Output rate, in Hz.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int Resampler::setRates(int inRate, int outRate)
+{
+	if (inRate <= 0 || outRate <= 0 ||
+	    inRate > outRate * MAX_RATE_RATIO ||
+	    outRate > inRate * MAX_RATE_RATIO)
+	{
+		return -EINVAL;
+	}
+
+	if (inRate != d->inRate || outRate != d->outRate) {
+		d->inRate = inRate;
+		d->outRate = outRate;
+		d->calcFilter();
+	}
+	d->calcStep();
+	reset();
+	return 0;
+}
+
+/**
+ * Get the input rate.
+ * @return Input rate, in Hz.
+ */
+int Resampler::inRate(void) const
+{
+	return d->inRate;
+}
+
+/**
+ * Get the output rate.
+ * @return Output rate, in Hz.
+ */
+int Resampler::outRate(void) const
+{
+	return d->outRate;
+}
+
+/**
+ * Get the ratio adjustment.
+ * @return Ratio adjustment. (1.0 == nominal)
+ */
+double Resampler::ratioAdjust(void) const
+{
+	return d->adjust;
+}
+
+/**
+ * Set the ratio adjustment.
+ * The effective output rate is outRate() * adjust.
+ * This can be changed at any time without resetting
+ * the resampler. The filter is not recalculated.
+ * @param adjust Ratio adjustment. (1.0 == nominal; clamped to +/- MAX_RATIO_ADJUST_PPM)
+ */
+void Resampler::setRatioAdjust(double adjust)
+{
+	const double maxAdjust = MAX_RATIO_ADJUST_PPM / 1000000.0;
+	adjust = std::max(1.0 - maxAdjust, std::min(1.0 + maxAdjust, adjust));
+	if (adjust == d->adjust)
+		return;
+
+	d->adjust = adjust;
+	if (d->inRate > 0) {
+		d->calcStep();
+	}
+}
+
+/**
+ * Get the effective conversion ratio. (output / input)
+ * @return Conversion ratio.
+ */
+double Resampler::ratio(void) const
+{
+	if (d->step == 0)
+		return 0.0;
+	return 4294967296.0 / (double)d->step;
+}
+
+/**
+ * Get the maximum number of samples process() can
+ * produce from the specified number of input samples.
+ * @param inSamples Number of input samples.
+ * @return Maximum number of output samples.
+ */
+int Resampler::maxOutput(int inSamples) const
+{
+	if (d->step == 0 || inSamples <= 0)
+		return 0;
+	return (int)(((uint64_t)inSamples << 32) / d->step) + 2;
+}
+
+/**
+ * Reset the resampler state.
+ * Buffered input is discarded.
+ */
+void Resampler::reset(void)
+{
+	// Start with half a window of silence so the
+	// first output sample is centered on the first
+	// input sample.
+	d->len = TAPS / 2;
+	memset(d->bufL, 0, d->len * sizeof(float));
+	memset(d->bufR, 0, d->len * sizeof(float));
+	d->pos = 0;
+}
+
+/**
+ * Resample audio.
+ * All input samples are consumed. Output that doesn't
+ * fit in dest is kept and returned by the next call,
+ * unless the internal buffer overflows.
+ * @param inL Left channel input.
+ * @param inR Right channel input.
+ * @param inSamples Number of input samples.
+ * @param dest Destination buffer. (interleaved if stereo)
+ * @param maxOut Maximum number of samples to write to dest.
+ * @param mono If true, downmix to monaural.
+ * @return Number of samples written.
+ */
+int Resampler::process(const int32_t *inL, const int32_t *inR, int inSamples,
+		       int16_t *dest, int maxOut, bool mono)
+{
+	assert(d->step != 0);
+	if (d->step == 0)
+		return 0;
+
+	const int channels = (mono ? 1 : 2);
+	int out = 0;
+	while (inSamples > 0) {
+		if (d->len == ResamplerPrivate::BUF_SIZE) {
+			// Input buffer is full. This only happens if
+			// dest is too small; drop the oldest half.
+			const int drop = ResamplerPrivate::BUF_SIZE / 2;
+			d->len -= drop;
+			memmove(d->bufL, &d->bufL[drop], d->len * sizeof(float));
+			memmove(d->bufR, &d->bufR[drop], d->len * sizeof(float));
+
+			// Adjust the output position for the dropped samples.
+			// If it was within the dropped samples, restart
+			// at the oldest sample that was kept.
+			const uint64_t dropPos = ((uint64_t)drop << 32);
+			d->pos = (d->pos > dropPos ? d->pos - dropPos : 0);
+		}
+
+		// Convert the input samples to float.
+		const int n = std::min(inSamples, ResamplerPrivate::BUF_SIZE - d->len);
+		float *bufL = &d->bufL[d->len];
+		float *bufR = &d->bufR[d->len];
+		for (int i = 0; i < n; i++) {
+			bufL[i] = (float)inL[i];
+			bufR[i] = (float)inR[i];
+		}
+		d->len += n;
+		inL += n;
+		inR += n;
+		inSamples -= n;
+
+		out += d->run(&dest[out * channels], maxOut - out, mono);
+		d->compact();
+	}
+
+	return out;
+}
+
+}
@@ -0,0 +1,85 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Resampler.generic.inc.cpp: Audio resampler. (Generic version.)          *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __IN_LIBGENS_RESAMPLER_CPP__
+#error Resampler.generic.inc.cpp should only be included by Resampler.cpp.
+#endif
+
+namespace LibGens {
+
+/**
+ * Convert a float sample to 16-bit with saturation.
+ * @param x Sample.
+ * @return 16-bit sample.
+ */
+static inline int16_t Resampler_toS16(float x)
+{
+	if (x >= 32767.0f)
+		return 32767;
+	else if (x <= -32768.0f)
+		return -32768;
+	return (int16_t)lrintf(x);
+}
+
+/**
+ * Generate output samples from the input buffers. (Generic version.)
+ * @param dest Destination buffer. (interleaved if stereo)
+ * @param maxOut Maximum number of samples to write to dest.
+ * @param mono If true, downmix to monaural.
+ * @return Number of samples written.
+ */
+int ResamplerPrivate::run_generic(int16_t *dest, int maxOut, bool mono)
+{
+	if (len < Resampler::TAPS)
+		return 0;
+	const uint64_t lastPos = ((uint64_t)(len - Resampler::TAPS) << 32) | 0xFFFFFFFFU;
+
+	int out = 0;
+	for (; out < maxOut && pos <= lastPos; out++, pos += step) {
+		const float *const srcL = &bufL[pos >> 32];
+		const float *const srcR = &bufR[pos >> 32];
+
+		// Select the filter phases.
+		const uint32_t frac = (uint32_t)pos;
+		const float *h0 = &coeffs[(frac >> (32 - PHASE_BITS)) * Resampler::TAPS];
+		const float *h1 = h0 + Resampler::TAPS;
+		const float t = (float)(frac & ((1U << (32 - PHASE_BITS)) - 1)) *
+				(1.0f / (float)(1U << (32 - PHASE_BITS)));
+
+		float l = 0.0f, r = 0.0f;
+		for (int j = 0; j < Resampler::TAPS; j++) {
+			const float c = h0[j] + t * (h1[j] - h0[j]);
+			l += srcL[j] * c;
+			r += srcR[j] * c;
+		}
+
+		if (mono) {
+			*dest++ = Resampler_toS16((l + r) * 0.5f);
+		} else {
+			*dest++ = Resampler_toS16(l);
+			*dest++ = Resampler_toS16(r);
+		}
+	}
+
+	return out;
+}
+
+}
@@ -0,0 +1,142 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Resampler.hpp: Polyphase windowed-sinc audio resampler.                 *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_SOUND_RESAMPLER_HPP__
+#define __LIBGENS_SOUND_RESAMPLER_HPP__
+
+// C includes.
+#include <stdint.h>
+
+namespace LibGens {
+
+class ResamplerPrivate;
+
+/**
+ * Polyphase windowed-sinc audio resampler.
+ *
+ * Converts 32-bit stereo input (as generated by the audio ICs)
+ * to 16-bit output at an arbitrary rate. The conversion ratio
+ * can be fine-tuned while running, e.g. for dynamic rate control
+ * to compensate for drift between the emulated and host clocks.
+ */
+class Resampler
+{
+	public:
+		Resampler();
+		~Resampler();
+
+	private:
+		friend class ResamplerPrivate;
+		ResamplerPrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGens-specific version of Q_DISABLE_COPY().
+		Resampler(const Resampler &);
+		Resampler &operator=(const Resampler &);
+
+	public:
+		// Number of filter taps per output sample.
+		static const int TAPS = 64;
+		// Number of filter phases. (Coefficients are
+		// linearly interpolated between phases.)
+		static const int PHASES = 256;
+
+		// Maximum ratio between the input and output rates.
+		static const int MAX_RATE_RATIO = 8;
+		// Maximum ratio adjustment, in parts per million.
+		static const int MAX_RATIO_ADJUST_PPM = 20000;
+
+		/**
+		 * Set the input and output rates.
+		 * This recalculates the filter and resets the resampler.
+		 * @param inRate Input rate, in Hz.
+		 * @param outRate Output rate, in Hz.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int setRates(int inRate, int outRate);
+
+		/**
+		 * Get the input rate.
+		 * @return Input rate, in Hz.
+		 */
+		int inRate(void) const;
+
+		/**
+		 * Get the output rate.
+		 * @return Output rate, in Hz.
+		 */
+		int outRate(void) const;
+
+		/**
+		 * Get the ratio adjustment.
+		 * @return Ratio adjustment. (1.0 == nominal)
+		 */
+		double ratioAdjust(void) const;
+
+		/**
+		 * Set the ratio adjustment.
+		 * The effective output rate is outRate() * adjust.
+		 * This can be changed at any time without resetting
+		 * the resampler. The filter is not recalculated.
+		 * @param adjust Ratio adjustment. (1.0 == nominal; clamped to +/- MAX_RATIO_ADJUST_PPM)
+		 */
+		void setRatioAdjust(double adjust);
+
+		/**
+		 * Get the effective conversion ratio. (output / input)
+		 * @return Conversion ratio.
+		 */
+		double ratio(void) const;
+
+		/**
+		 * Get the maximum number of samples process() can
+		 * produce from the specified number of input samples.
+		 * @param inSamples Number of input samples.
+		 * @return Maximum number of output samples.
+		 */
+		int maxOutput(int inSamples) const;
+
+		/**
+		 * Reset the resampler state.
+		 * Buffered input is discarded.
+		 */
+		void reset(void);
+
+		/**
+		 * Resample audio.
+		 * All input samples are consumed. Output that doesn't
+		 * fit in dest is kept and returned by the next call,
+		 * unless the internal buffer overflows.
+		 * @param inL Left channel input.
+		 * @param inR Right channel input.
+		 * @param inSamples Number of input samples.
+		 * @param dest Destination buffer. (interleaved if stereo)
+		 * @param maxOut Maximum number of samples to write to dest.
+		 * @param mono If true, downmix to monaural.
+		 * @return Number of samples written.
+		 */
+		int process(const int32_t *inL, const int32_t *inR, int inSamples,
+			    int16_t *dest, int maxOut, bool mono);
+};
+
+}
+
+#endif /* __LIBGENS_SOUND_RESAMPLER_HPP__ */
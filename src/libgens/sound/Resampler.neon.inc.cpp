@@ -0,0 +1,96 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Resampler.neon.inc.cpp: Audio resampler. (NEON-optimized.)              *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __IN_LIBGENS_RESAMPLER_CPP__
+#error Resampler.neon.inc.cpp should only be included by Resampler.cpp.
+#endif
+
+#ifndef HAVE_NEON_INTRIN
+#error Resampler.neon.inc.cpp should only be compiled if NEON intrinsics are available.
+#endif
+
+// NEON intrinsics.
+#include <arm_neon.h>
+
+namespace LibGens {
+
+/**
+ * Generate output samples from the input buffers. (NEON-optimized.)
+ * @param dest Destination buffer. (interleaved if stereo)
+ * @param maxOut Maximum number of samples to write to dest.
+ * @param mono If true, downmix to monaural.
+ * @return Number of samples written.
+ */
+int ResamplerPrivate::run_NEON(int16_t *dest, int maxOut, bool mono)
+{
+	if (len < Resampler::TAPS)
+		return 0;
+	const uint64_t lastPos = ((uint64_t)(len - Resampler::TAPS) << 32) | 0xFFFFFFFFU;
+
+	int out = 0;
+	for (; out < maxOut && pos <= lastPos; out++, pos += step) {
+		const float *const srcL = &bufL[pos >> 32];
+		const float *const srcR = &bufR[pos >> 32];
+
+		// Select the filter phases.
+		const uint32_t frac = (uint32_t)pos;
+		const float *h0 = &coeffs[(frac >> (32 - PHASE_BITS)) * Resampler::TAPS];
+		const float *h1 = h0 + Resampler::TAPS;
+		const float t = (float)(frac & ((1U << (32 - PHASE_BITS)) - 1)) *
+				(1.0f / (float)(1U << (32 - PHASE_BITS)));
+
+		// Process 4 taps at a time.
+		float32x4_t accL = vdupq_n_f32(0.0f);
+		float32x4_t accR = vdupq_n_f32(0.0f);
+		for (int j = 0; j < Resampler::TAPS; j += 4) {
+			const float32x4_t c0 = vld1q_f32(&h0[j]);
+			const float32x4_t c1 = vld1q_f32(&h1[j]);
+			const float32x4_t c = vmlaq_n_f32(c0, vsubq_f32(c1, c0), t);
+			accL = vmlaq_f32(accL, vld1q_f32(&srcL[j]), c);
+			accR = vmlaq_f32(accR, vld1q_f32(&srcR[j]), c);
+		}
+
+		// Horizontal sums: [L, R]
+		const float32x2_t sumL = vadd_f32(vget_low_f32(accL), vget_high_f32(accL));
+		const float32x2_t sumR = vadd_f32(vget_low_f32(accR), vget_high_f32(accR));
+		float32x2_t sum = vpadd_f32(sumL, sumR);
+
+		if (mono) {
+			// Downmix: (L + R) / 2
+			sum = vmul_n_f32(vpadd_f32(sum, sum), 0.5f);
+		}
+
+		// Convert to 16-bit with saturation. (round to nearest)
+		const int32x2_t s32 = vcvt_s32_f32(vadd_f32(sum,
+			vbsl_f32(vclt_f32(sum, vdup_n_f32(0.0f)), vdup_n_f32(-0.5f), vdup_n_f32(0.5f))));
+		const int16x4_t s16 = vqmovn_s32(vcombine_s32(s32, s32));
+		if (mono) {
+			*dest++ = vget_lane_s16(s16, 0);
+		} else {
+			*dest++ = vget_lane_s16(s16, 0);
+			*dest++ = vget_lane_s16(s16, 1);
+		}
+	}
+
+	return out;
+}
+
+}
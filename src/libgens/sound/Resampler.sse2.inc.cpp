@@ -0,0 +1,96 @@
+/***************************************************************************
+ * libgens: Gens Emulation Library.                                        *
+ * Resampler.sse2.inc.cpp: Audio resampler. (SSE2-optimized.)              *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __IN_LIBGENS_RESAMPLER_CPP__
+#error Resampler.sse2.inc.cpp should only be included by Resampler.cpp.
+#endif
+
+#ifndef HAVE_SSE2_INTRIN
+#error Resampler.sse2.inc.cpp should only be compiled if SSE2 intrinsics are available.
+#endif
+
+// SSE2 intrinsics.
+#include <emmintrin.h>
+
+namespace LibGens {
+
+/**
+ * Generate output samples from the input buffers. (SSE2-optimized.)
+ * @param dest Destination buffer. (interleaved if stereo)
+ * @param maxOut Maximum number of samples to write to dest.
+ * @param mono If true, downmix to monaural.
+ * @return Number of samples written.
+ */
+FUNC_TARGET("sse2")
+int ResamplerPrivate::run_SSE2(int16_t *dest, int maxOut, bool mono)
+{
+	if (len < Resampler::TAPS)
+		return 0;
+	const uint64_t lastPos = ((uint64_t)(len - Resampler::TAPS) << 32) | 0xFFFFFFFFU;
+
+	int out = 0;
+	for (; out < maxOut && pos <= lastPos; out++, pos += step) {
+		// NOTE: The input buffers are only 4-byte aligned here.
+		const float *const srcL = &bufL[pos >> 32];
+		const float *const srcR = &bufR[pos >> 32];
+
+		// Select the filter phases.
+		const uint32_t frac = (uint32_t)pos;
+		const float *h0 = &coeffs[(frac >> (32 - PHASE_BITS)) * Resampler::TAPS];
+		const float *h1 = h0 + Resampler::TAPS;
+		const __m128 t = _mm_set1_ps((float)(frac & ((1U << (32 - PHASE_BITS)) - 1)) *
+				(1.0f / (float)(1U << (32 - PHASE_BITS))));
+
+		// Process 4 taps at a time.
+		__m128 accL = _mm_setzero_ps();
+		__m128 accR = _mm_setzero_ps();
+		for (int j = 0; j < Resampler::TAPS; j += 4) {
+			const __m128 c0 = _mm_load_ps(&h0[j]);
+			const __m128 c1 = _mm_load_ps(&h1[j]);
+			const __m128 c = _mm_add_ps(c0, _mm_mul_ps(t, _mm_sub_ps(c1, c0)));
+			accL = _mm_add_ps(accL, _mm_mul_ps(_mm_loadu_ps(&srcL[j]), c));
+			accR = _mm_add_ps(accR, _mm_mul_ps(_mm_loadu_ps(&srcR[j]), c));
+		}
+
+		// Horizontal sums: [L, R, x, x]
+		__m128 sum = _mm_add_ps(_mm_unpacklo_ps(accL, accR), _mm_unpackhi_ps(accL, accR));
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+
+		if (mono) {
+			// Downmix: (L + R) / 2
+			sum = _mm_mul_ps(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x01)), _mm_set_ss(0.5f));
+		}
+
+		// Convert to 16-bit with saturation.
+		const __m128i s16 = _mm_packs_epi32(_mm_cvtps_epi32(sum), _mm_setzero_si128());
+		const uint32_t px = (uint32_t)_mm_cvtsi128_si32(s16);
+		if (mono) {
+			*dest++ = (int16_t)(px & 0xFFFF);
+		} else {
+			memcpy(dest, &px, sizeof(px));
+			dest += 2;
+		}
+	}
+
+	return out;
+}
+
+}
@@ -43,6 +43,7 @@
 #include "libcompat/aligned_malloc.h"
 
 #include "SoundMgr_p.hpp"
+#include "Resampler.hpp"
 namespace LibGens {
 
 /** SoundManagerPrivate **/
@@ -50,6 +51,12 @@ namespace LibGens {
 // Audio settings.
 int SoundMgrPrivate::rate = 44100;
 bool SoundMgrPrivate::isPal = false;
+int SoundMgrPrivate::segRate = 44100;
+
+// Resampler.
+Resampler *SoundMgrPrivate::resampler = nullptr;
+bool SoundMgrPrivate::useResampler = false;
+double SoundMgrPrivate::rateAdjust = 1.0;
 
 /**
  * Calculate the segment length.
@@ -77,6 +84,18 @@ int SoundMgrPrivate::CalcSegLength(int rate, bool isPal)
 	}
 }
 
+/**
+ * Calculate the YM2612's native rate.
+ * @param isPal If true, system is PAL.
+ * @return YM2612 native rate, in Hz.
+ */
+int SoundMgrPrivate::CalcNativeRate(bool isPal)
+{
+	// The YM2612 generates one sample every 144 YM clocks.
+	const double clock = (isPal ? CLOCK_PAL : CLOCK_NTSC) / 7.0;
+	return (int)lrint(clock / 144.0);
+}
+
 /** SoundMgr **/
 
 // Segment buffer.
@@ -106,6 +125,8 @@ void SoundMgr::Init(void)
 void SoundMgr::End(void)
 {
 	// TODO
+	delete SoundMgrPrivate::resampler;
+	SoundMgrPrivate::resampler = nullptr;
 }
 
 /**
@@ -119,8 +140,40 @@ void SoundMgr::ReInit(int rate, bool isPal, bool preserveState)
 	SoundMgrPrivate::rate = rate;
 	SoundMgrPrivate::isPal = isPal;
 
-	// Calculate the segment length.
-	ms_SegLength = SoundMgrPrivate::CalcSegLength(rate, isPal);
+	// If the resampler is enabled, the audio ICs
+	// run at the YM2612's native rate.
+	int icRate = rate;
+	if (SoundMgrPrivate::useResampler) {
+		icRate = SoundMgrPrivate::CalcNativeRate(isPal);
+		if (rate > MAX_OUTPUT_RATE) {
+			rate = MAX_OUTPUT_RATE;
+		}
+
+		if (!SoundMgrPrivate::resampler) {
+			SoundMgrPrivate::resampler = new Resampler();
+		}
+		if (SoundMgrPrivate::resampler->setRates(icRate, rate) != 0) {
+			// Unsupported conversion ratio.
+			// Synthesize directly at the sound rate.
+			delete SoundMgrPrivate::resampler;
+			SoundMgrPrivate::resampler = nullptr;
+			icRate = rate;
+		}
+	}
+
+	if (SoundMgrPrivate::useResampler && SoundMgrPrivate::resampler) {
+		SoundMgrPrivate::resampler->setRatioAdjust(SoundMgrPrivate::rateAdjust);
+
+		// Segment size is ceil(icRate / framesPerSecond).
+		ms_SegLength = (int)ceil((double)icRate / (isPal ? 50.0 : 60.0));
+	} else {
+		delete SoundMgrPrivate::resampler;
+		SoundMgrPrivate::resampler = nullptr;
+
+		// Calculate the segment length.
+		ms_SegLength = SoundMgrPrivate::CalcSegLength(rate, isPal);
+	}
+	SoundMgrPrivate::segRate = icRate;
 
 	// Build the sound extrapolation table.
 	const int lines = (isPal ? 312 : 262);
@@ -149,11 +202,11 @@ void SoundMgr::ReInit(int rate, bool isPal, bool preserveState)
 
 	// Initialize the PSG and YM2612.
 	if (isPal) {
-		ms_Psg.reInit((int)((double)CLOCK_PAL / 15.0), rate);
-		ms_Ym2612.reInit((int)((double)CLOCK_PAL / 7.0), rate);
+		ms_Psg.reInit((int)((double)CLOCK_PAL / 15.0), icRate);
+		ms_Ym2612.reInit((int)((double)CLOCK_PAL / 7.0), icRate);
 	} else {
-		ms_Psg.reInit((int)((double)CLOCK_NTSC / 15.0), rate);
-		ms_Ym2612.reInit((int)((double)CLOCK_NTSC / 7.0), rate);
+		ms_Psg.reInit((int)((double)CLOCK_NTSC / 15.0), icRate);
+		ms_Ym2612.reInit((int)((double)CLOCK_NTSC / 7.0), icRate);
 	}
 
 	// If requested, restore the PSG/YM state.
@@ -175,4 +228,81 @@ void SoundMgr::SetRegion(bool isPal, bool preserveState)
 	ReInit(SoundMgrPrivate::rate, isPal, preserveState);
 }
 
+/**
+ * Enable or disable the resampler.
+ * If enabled, the audio ICs run at the YM2612's native
+ * rate, and the output is resampled to the sound rate.
+ * This allows sound rates up to MAX_OUTPUT_RATE.
+ * @param enable If true, enable the resampler.
+ * @param preserveState If true, save the PSG/YM state before reinitializing them.
+ */
+void SoundMgr::SetResampler(bool enable, bool preserveState)
+{
+	SoundMgrPrivate::useResampler = enable;
+	ReInit(SoundMgrPrivate::rate, SoundMgrPrivate::isPal, preserveState);
+}
+
+/** Resampler. **/
+
+/**
+ * Is the resampler enabled?
+ * @return True if enabled; false if not.
+ */
+bool SoundMgr::IsResamplerEnabled(void)
+{
+	return SoundMgrPrivate::useResampler;
+}
+
+/**
+ * Set the resampler's ratio adjustment.
+ * This can be used to compensate for drift between
+ * the emulated and host clocks, e.g. by keeping the
+ * host audio buffer at a constant level.
+ * The adjustment is retained across ReInit().
+ * @param adjust Ratio adjustment. (1.0 == nominal)
+ */
+void SoundMgr::SetRateAdjust(double adjust)
+{
+	SoundMgrPrivate::rateAdjust = adjust;
+	if (SoundMgrPrivate::resampler) {
+		SoundMgrPrivate::resampler->setRatioAdjust(adjust);
+		// Save the clamped value.
+		SoundMgrPrivate::rateAdjust = SoundMgrPrivate::resampler->ratioAdjust();
+	}
+}
+
+/**
+ * Get the resampler's ratio adjustment.
+ * @return Ratio adjustment. (1.0 == nominal)
+ */
+double SoundMgr::GetRateAdjust(void)
+{
+	return SoundMgrPrivate::rateAdjust;
+}
+
+/**
+ * Get the segment rate.
+ * This is the rate at which the audio ICs
+ * generate samples into the segment buffers.
+ * @return Segment rate, in Hz.
+ */
+int SoundMgr::GetSegRate(void)
+{
+	return SoundMgrPrivate::segRate;
+}
+
+/**
+ * Get the output length.
+ * This is the maximum number of samples returned by
+ * writeStereo() and writeMono() per frame.
+ * @return Output length.
+ */
+int SoundMgr::GetOutputLength(void)
+{
+	if (SoundMgrPrivate::resampler) {
+		return SoundMgrPrivate::resampler->maxOutput(ms_SegLength);
+	}
+	return ms_SegLength;
+}
+
 }
@@ -47,15 +47,75 @@ class SoundMgr
 		static void SetRate(int rate, bool preserveState = true);
 		static void SetRegion(bool isPal, bool preserveState = true);
 
+		/**
+		 * Enable or disable the resampler.
+		 * If enabled, the audio ICs run at the YM2612's native
+		 * rate, and the output is resampled to the sound rate.
+		 * This allows sound rates up to MAX_OUTPUT_RATE.
+		 * @param enable If true, enable the resampler.
+		 * @param preserveState If true, save the PSG/YM state before reinitializing them.
+		 */
+		static void SetResampler(bool enable, bool preserveState = true);
+
+		/**
+		 * Is the resampler enabled?
+		 * @return True if enabled; false if not.
+		 */
+		static bool IsResamplerEnabled(void);
+
+		/**
+		 * Set the resampler's ratio adjustment.
+		 * This can be used to compensate for drift between
+		 * the emulated and host clocks, e.g. by keeping the
+		 * host audio buffer at a constant level.
+		 * The adjustment is retained across ReInit().
+		 * @param adjust Ratio adjustment. (1.0 == nominal)
+		 */
+		static void SetRateAdjust(double adjust);
+
+		/**
+		 * Get the resampler's ratio adjustment.
+		 * @return Ratio adjustment. (1.0 == nominal)
+		 */
+		static double GetRateAdjust(void);
+
+		/**
+		 * Get the segment length.
+		 * This is the number of samples generated by
+		 * the audio ICs per frame.
+		 * @return Segment length.
+		 */
 		static inline int GetSegLength(void);
 
+		/**
+		 * Get the segment rate.
+		 * This is the rate at which the audio ICs
+		 * generate samples into the segment buffers.
+		 * @return Segment rate, in Hz.
+		 */
+		static int GetSegRate(void);
+
+		/**
+		 * Get the output length.
+		 * This is the maximum number of samples returned by
+		 * writeStereo() and writeMono() per frame.
+		 * @return Output length.
+		 */
+		static int GetOutputLength(void);
+
 		// TODO: Bounds checking.
 		static inline int GetWritePos(int line);
 		static inline int GetWriteLen(int line);
 
 		// Maximum sampling rate and segment size.
+		// NOTE: With the resampler enabled, the audio ICs run at
+		// the YM2612's native rate, which is slightly higher.
 		static const int MAX_SAMPLING_RATE = 48000;
-		static const int MAX_SEGMENT_SIZE = 960;	// ceil(MAX_SAMPLING_RATE / 50)
+		static const int MAX_SEGMENT_SIZE = 1066;	// ceil((CLOCK_NTSC / 7 / 144) / 50)
+
+		// Maximum output rate and output length. (resampler only)
+		static const int MAX_OUTPUT_RATE = 192000;
+		static const int MAX_OUTPUT_SIZE = 3936;	// ceil(MAX_OUTPUT_RATE / 50) + 2.5%
 
 		// Segment buffer.
 		// Stores up to MAX_SEGMENT_SIZE 16-bit stereo samples.
@@ -93,6 +153,9 @@ class SoundMgr
 		/**
 		 * Write stereo audio to a buffer.
 		 * This clears the internal audio buffer.
+		 * NOTE: If the resampler is enabled, the number of
+		 * samples written may vary from frame to frame.
+		 * Use GetOutputLength() to size the buffer.
 		 * @param dest Destination buffer.
 		 * @param samples Number of samples in the buffer. (1 sample == 4 bytes)
 		 * @return Number of samples written.
@@ -102,6 +165,9 @@ class SoundMgr
 		/**
 		 * Write monaural audio to a buffer.
 		 * This clears the internal audio buffer.
+		 * NOTE: If the resampler is enabled, the number of
+		 * samples written may vary from frame to frame.
+		 * Use GetOutputLength() to size the buffer.
 		 * @param dest Destination buffer.
 		 * @param samples Number of samples in the buffer. (1 sample == 2 bytes)
 		 * @return Number of samples written.
@@ -33,6 +33,8 @@
 
 namespace LibGens {
 
+class Resampler;
+
 // SoundMgrPrivate
 class SoundMgrPrivate
 {
@@ -53,6 +55,21 @@ class SoundMgrPrivate
 		static int rate;
 		static bool isPal;
 
+		// Rate used by the audio ICs.
+		static int segRate;
+
+		/**
+		 * Calculate the YM2612's native rate.
+		 * @param isPal If true, system is PAL.
+		 * @return YM2612 native rate, in Hz.
+		 */
+		static int CalcNativeRate(bool isPal);
+
+		// Resampler. (nullptr if disabled)
+		static Resampler *resampler;
+		static bool useResampler;
+		static double rateAdjust;
+
 	public:
 #ifdef SOUNDMGR_HAS_MMX
 		/**
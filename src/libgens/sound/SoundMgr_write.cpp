@@ -33,6 +33,7 @@
 #include <algorithm>
 
 #include "SoundMgr_p.hpp"
+#include "Resampler.hpp"
 namespace LibGens {
 
 /**
@@ -354,22 +355,32 @@ void SoundMgrPrivate::writeMono_noasm(int16_t *dest, int samples)
 /**
  * Write stereo audio to a buffer.
  * This clears the internal audio buffer.
+ * NOTE: If the resampler is enabled, the number of
+ * samples written may vary from frame to frame.
+ * Use GetOutputLength() to size the buffer.
  * @param dest Destination buffer.
  * @param samples Number of samples in the buffer. (1 sample == 4 bytes)
  * @return Number of samples written.
  */
 int SoundMgr::writeStereo(int16_t *dest, int samples)
 {
-	samples = std::min(samples, ms_SegLength);
+	if (SoundMgrPrivate::resampler) {
+		// Resample the segment buffers.
+		samples = SoundMgrPrivate::resampler->process(
+			ms_SegBufL, ms_SegBufR, ms_SegLength,
+			dest, samples, false);
+	} else {
+		samples = std::min(samples, ms_SegLength);
 #ifdef SOUNDMGR_HAS_MMX
-	if (CPU_Flags & MDP_CPUFLAG_X86_SSE2) {
-		SoundMgrPrivate::writeStereo_SSE2(dest, samples);
-	} else if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
-		SoundMgrPrivate::writeStereo_MMX(dest, samples);
-	} else
+		if (CPU_Flags & MDP_CPUFLAG_X86_SSE2) {
+			SoundMgrPrivate::writeStereo_SSE2(dest, samples);
+		} else if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
+			SoundMgrPrivate::writeStereo_MMX(dest, samples);
+		} else
 #endif /* SOUNDMGR_HAS_MMX */
-	{
-		SoundMgrPrivate::writeStereo_noasm(dest, samples);
+		{
+			SoundMgrPrivate::writeStereo_noasm(dest, samples);
+		}
 	}
 
 	// Clear the segment buffers.
@@ -384,22 +395,32 @@ int SoundMgr::writeStereo(int16_t *dest, int samples)
 /**
  * Write monaural audio to a buffer.
  * This clears the internal audio buffer.
+ * NOTE: If the resampler is enabled, the number of
+ * samples written may vary from frame to frame.
+ * Use GetOutputLength() to size the buffer.
  * @param dest Destination buffer.
  * @param samples Number of samples in the buffer. (1 sample == 2 bytes)
  * @return Number of samples written.
  */
 int SoundMgr::writeMono(int16_t *dest, int samples)
 {
-	samples = std::min(samples, ms_SegLength);
+	if (SoundMgrPrivate::resampler) {
+		// Resample the segment buffers.
+		samples = SoundMgrPrivate::resampler->process(
+			ms_SegBufL, ms_SegBufR, ms_SegLength,
+			dest, samples, true);
+	} else {
+		samples = std::min(samples, ms_SegLength);
 #ifdef SOUNDMGR_HAS_MMX
-	if (CPU_Flags & MDP_CPUFLAG_X86_SSE2) {
-		SoundMgrPrivate::writeMono_SSE2(dest, samples);
-	} else if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
-		SoundMgrPrivate::writeMono_MMX(dest, samples);
-	} else
+		if (CPU_Flags & MDP_CPUFLAG_X86_SSE2) {
+			SoundMgrPrivate::writeMono_SSE2(dest, samples);
+		} else if (CPU_Flags & MDP_CPUFLAG_X86_MMX) {
+			SoundMgrPrivate::writeMono_MMX(dest, samples);
+		} else
 #endif /* SOUNDMGR_HAS_MMX */
-	{
-		SoundMgrPrivate::writeMono_noasm(dest, samples);
+		{
+			SoundMgrPrivate::writeMono_noasm(dest, samples);
+		}
 	}
 
 	// Clear the segment buffers.
@@ -48,6 +48,9 @@
 /* Message logging. */
 #include "macros/log_msg.h"
 
+// Profiler.
+#include "Util/Profiler.hpp"
+
 // Sound Manager.
 #include "SoundMgr.hpp"
 #include "Vdp/Vdp.hpp"
@@ -681,6 +684,12 @@ int Ym2612Private::CHANNEL_SET(int address, uint8_t data)
  */
 int Ym2612Private::YM_SET(int address, uint8_t data)
 {
+	if (address >= 0x24 && address <= 0x27 && q->m_timerWriteFn) {
+		// Timer register. The timers have to be
+		// advanced to the current cycle first.
+		q->m_timerWriteFn(q->m_timerWriteParam);
+	}
+
 	switch (address) {
 		case 0x22:
 			// LFO enable
@@ -803,6 +812,7 @@ int Ym2612Private::YM_SET(int address, uint8_t data)
 
 			// Enable/disable the DAC.
 			state.DAC = data & 0x80;	// Activate / Deactivate the DAC.
+			q->m_dacActive = (state.DAC && q->m_dacEnabled);
 			break;
 	}
 
@@ -1481,20 +1491,30 @@ Ym2612::Ym2612()
 	: d(new Ym2612Private(this))
 {
 	// TODO: Some initialization should go here!
+	m_writeLogFn = nullptr;
+	m_writeLogParam = nullptr;
+	m_timerWriteFn = nullptr;
+	m_timerWriteParam = nullptr;
 	m_writeLen = 0;
 	m_enabled = true;	// TODO: Make this customizable.
 	m_dacEnabled = true;	// TODO: Make this customizable.
 	m_improved = true;	// TODO: Make this customizable.
+	m_dacActive = false;
 }
 
 Ym2612::Ym2612(int clock, int rate)
 	: d(new Ym2612Private(this))
 {
 	// TODO: Some initialization should go here!
+	m_writeLogFn = nullptr;
+	m_writeLogParam = nullptr;
+	m_timerWriteFn = nullptr;
+	m_timerWriteParam = nullptr;
 	m_writeLen = 0;
 	m_enabled = true;	// TODO: Make this customizable.
 	m_dacEnabled = true;	// TODO: Make this customizable.
 	m_improved = true;	// TODO: Make this customizable.
+	m_dacActive = false;
 	
 	reInit(clock, rate);
 }
@@ -1520,6 +1540,7 @@ int Ym2612::reInit(int clock, int rate)
 
 	// Clear the state struct.
 	memset(&d->state, 0, sizeof(d->state));
+	m_dacActive = false;
 	d->state.Clock = clock;
 	d->state.Rate = rate;
 
@@ -1635,6 +1656,7 @@ void Ym2612::reset(void)
 	d->state.TimerBcnt = 0;
 	d->state.DAC = 0;
 	d->state.DACdata = 0;
+	m_dacActive = false;
 
 	d->state.status = 0;
 
@@ -1746,6 +1768,10 @@ int Ym2612::write(unsigned int address, uint8_t data)
 			break;
 
 		case 1:
+			if (m_writeLogFn) {
+				m_writeLogFn(m_writeLogParam, 0, (uint8_t)d->state.OPNAadr, data);
+			}
+
 			// Trivial optimization for DAC.
 			if (d->state.OPNAadr == 0x2A) {
 				d->state.DACdata = ((int)data - 0x80) << 7;
@@ -1795,6 +1821,10 @@ int Ym2612::write(unsigned int address, uint8_t data)
 			break;
 
 		case 3:
+			if (m_writeLogFn) {
+				m_writeLogFn(m_writeLogParam, 1, (uint8_t)d->state.OPNBadr, data);
+			}
+
 			reg_num = d->state.OPNBadr & 0xF0;
 
 			if (reg_num >= 0x30) {
@@ -1835,6 +1865,8 @@ int Ym2612::write(unsigned int address, uint8_t data)
  */
 void Ym2612::update(int32_t *bufL, int32_t *bufR, int length)
 {
+	PROFILE_SCOPE(YM2612_UPDATE);
+
 	LOG_MSG(ym2612, LOG_MSG_LEVEL_DEBUG4,
 		"Starting generating sound...");
 
@@ -2240,30 +2272,40 @@ int YM2612_Restore_Full(gsx_v7_ym2612 *save)
 /* Gens */
 
 /**
- * Update the YM2612 DAC output and timers.
+ * Update the YM2612 DAC output.
  * @param bufL Left audio buffer. (16-bit; int32_t is used for saturation.)
  * @param bufR Right audio buffer. (16-bit; int32_t is used for saturation.)
  * @param length Length of the output buffer.
  */
-void Ym2612::updateDacAndTimers(int32_t *bufL, int32_t *bufR, int length)
+void Ym2612::updateDac(int32_t *bufL, int32_t *bufR, int length)
 {
-	// Update DAC.
-	if (d->state.DAC && d->state.DACdata && m_dacEnabled) {
-		for (int i = 0; i < length; i++) {
-			bufL[i] += (d->state.DACdata & d->state.CHANNEL[5].LEFT);
-			bufR[i] += (d->state.DACdata & d->state.CHANNEL[5].RIGHT);
-		}
+	if (!m_dacActive || !d->state.DACdata)
+		return;
+
+	for (int i = 0; i < length; i++) {
+		bufL[i] += (d->state.DACdata & d->state.CHANNEL[5].LEFT);
+		bufR[i] += (d->state.DACdata & d->state.CHANNEL[5].RIGHT);
 	}
+}
+
+/**
+ * Advance the timers.
+ * @param ticks Number of timer ticks elapsed.
+ */
+void Ym2612::updateTimers(int ticks)
+{
+	// Timer counters are stored as 20.12 fixed-point.
+	const int i = (ticks << 12);
 
-	// Update timers.
-	int i = d->state.TimerBase * length;
-	
 	if (d->state.Mode & 1) {
 		// Timer A is ON.
-		//if ((YM2612.TimerAcnt -= 14073) <= 0)           // 13879=NTSC (old: 14475=NTSC  14586=PAL)
 		if ((d->state.TimerAcnt -= i) <= 0) {
 			d->state.status |= (d->state.Mode & 0x04) >> 2;
-			d->state.TimerAcnt += d->state.TimerAL;
+			if (d->state.TimerAL > 0) {
+				// If more than one period elapsed,
+				// only one overflow is reported.
+				d->state.TimerAcnt = (d->state.TimerAcnt % d->state.TimerAL) + d->state.TimerAL;
+			}
 
 			LOG_MSG(ym2612, LOG_MSG_LEVEL_DEBUG1,
 				"Counter A overflow");
@@ -2276,10 +2318,11 @@ void Ym2612::updateDacAndTimers(int32_t *bufL, int32_t *bufR, int length)
 
 	if (d->state.Mode & 2) {
 		// Timer B is ON.
-		//if ((d->state.TimerBcnt -= 14073) <= 0)           // 13879=NTSC (old: 14475=NTSC  14586=PAL)
 		if ((d->state.TimerBcnt -= i) <= 0) {
 			d->state.status |= (d->state.Mode & 0x08) >> 2;
-			d->state.TimerBcnt += d->state.TimerBL;
+			if (d->state.TimerBL > 0) {
+				d->state.TimerBcnt = (d->state.TimerBcnt % d->state.TimerBL) + d->state.TimerBL;
+			}
 
 			LOG_MSG(ym2612, LOG_MSG_LEVEL_DEBUG1,
 				"Counter B overflow");
@@ -2287,6 +2330,35 @@ void Ym2612::updateDacAndTimers(int32_t *bufL, int32_t *bufR, int length)
 	}
 }
 
+/**
+ * Get the number of timer ticks until the next timer
+ * overflow that changes the YM2612 state.
+ * Overflows that wouldn't set a status flag that isn't
+ * already set, or trigger CSM, aren't counted.
+ * @return Number of timer ticks, or -1 if nothing is pending.
+ */
+int Ym2612::timerTicksToEvent(void) const
+{
+	int ticks = -1;
+
+	// Timer A: Sets status bit 0 if enabled, and triggers CSM.
+	if ((d->state.Mode & 1) &&
+	    ((d->state.Mode & 0x80) ||
+	     ((d->state.Mode & 0x04) && !(d->state.status & 1))))
+	{
+		ticks = (d->state.TimerAcnt > 0 ? ((d->state.TimerAcnt + 0xFFF) >> 12) : 1);
+	}
+
+	// Timer B: Sets status bit 1 if enabled.
+	if ((d->state.Mode & 2) && (d->state.Mode & 0x08) && !(d->state.status & 2)) {
+		const int ticksB = (d->state.TimerBcnt > 0 ? ((d->state.TimerBcnt + 0xFFF) >> 12) : 1);
+		if (ticks < 0 || ticksB < ticks)
+			ticks = ticksB;
+	}
+
+	return ticks;
+}
+
 /**
  * Update the YM2612 buffer.
  */
@@ -66,7 +66,7 @@ class Ym2612
 		void zomgRestore(const _Zomg_Ym2612Save_t *state);
 
 		/** Gens-specific code. **/
-		void updateDacAndTimers(int32_t *bufL, int32_t *bufR, int length);
+		void updateDac(int32_t *bufL, int32_t *bufR, int length);
 		void specialUpdate(void);
 		int getReg(int regID) const;
 
@@ -79,12 +79,97 @@ class Ym2612
 		// Reset buffer pointers.
 		void resetBufferPtrs(void);
 
+		/**
+		 * Is the DAC active?
+		 * If it isn't, updateDac() doesn't need to be called.
+		 * @return True if the DAC is active; false if not.
+		 */
+		inline bool isDacActive(void) const
+			{ return m_dacActive; }
+
+		/** Timers. **/
+
+		/**
+		 * Number of YM2612 clock cycles per timer tick.
+		 * Timer A is decremented once per tick;
+		 * Timer B is decremented once every 16 ticks.
+		 */
+		static const int CLOCKS_PER_TIMER_TICK = 144;
+
+		/**
+		 * Advance the timers.
+		 * @param ticks Number of timer ticks elapsed.
+		 */
+		void updateTimers(int ticks);
+
+		/**
+		 * Get the number of timer ticks until the next timer
+		 * overflow that changes the YM2612 state.
+		 * Overflows that wouldn't set a status flag that isn't
+		 * already set, or trigger CSM, aren't counted.
+		 * @return Number of timer ticks, or -1 if nothing is pending.
+		 */
+		int timerTicksToEvent(void) const;
+
+		/**
+		 * Timer write function.
+		 * Called *before* a timer register (0x24-0x27) is written,
+		 * so the caller can advance the timers to the current cycle.
+		 * timerTicksToEvent() should be checked after the write.
+		 * @param param Parameter passed to setTimerWriteFn().
+		 */
+		typedef void (*TimerWriteFn)(void *param);
+
+		/**
+		 * Set the timer write function.
+		 * This is used by the emulation loop to schedule
+		 * timer overflows instead of polling the timers.
+		 * @param fn Timer write function, or nullptr to disable.
+		 * @param param Parameter for fn.
+		 */
+		inline void setTimerWriteFn(TimerWriteFn fn, void *param)
+		{
+			m_timerWriteFn = fn;
+			m_timerWriteParam = param;
+		}
+
+		/**
+		 * Register write log function.
+		 * Called for every write to a YM2612 data port.
+		 * @param param Parameter passed to setWriteLog().
+		 * @param port Register bank. (0 or 1)
+		 * @param reg Register number.
+		 * @param data Data value.
+		 */
+		typedef void (*WriteLogFn)(void *param, int port, uint8_t reg, uint8_t data);
+
+		/**
+		 * Set the register write log function.
+		 * This is used for VGM capture.
+		 * @param fn Write log function, or nullptr to disable logging.
+		 * @param param Parameter for fn.
+		 */
+		inline void setWriteLog(WriteLogFn fn, void *param)
+		{
+			m_writeLogFn = fn;
+			m_writeLogParam = param;
+		}
+
 	protected:
+		// Register write log.
+		WriteLogFn m_writeLogFn;
+		void *m_writeLogParam;
+
+		// Timer write function.
+		TimerWriteFn m_timerWriteFn;
+		void *m_timerWriteParam;
+
 		// PSG write length. (for audio output)
 		int m_writeLen;
 		bool m_enabled;		// YM2612 Enabled
 		bool m_dacEnabled;	// DAC Enabled
 		bool m_improved;	// YM2612 Improved
+		bool m_dacActive;	// DAC is enabled in both the YM2612 and Gens.
 		
 		// YM buffer pointers.
 		// TODO: Figure out how to get rid of these!
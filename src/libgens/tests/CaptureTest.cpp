@@ -0,0 +1,480 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * CaptureTest.cpp: WAV/VGM/video capture test.                            *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "lg_main.hpp"
+#include "Util/MdFb.hpp"
+#include "Util/Capture.hpp"
+#include "sound/SoundMgr.hpp"
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+// C++ includes.
+#include <algorithm>
+#include <string>
+#include <vector>
+using std::vector;
+
+namespace LibGens { namespace Tests {
+
+class CaptureTest : public ::testing::Test
+{
+	protected:
+		CaptureTest()
+			: ::testing::Test() { }
+		virtual ~CaptureTest() { }
+
+		virtual void SetUp(void);
+		virtual void TearDown(void);
+
+	public:
+		static const char WAV_FILENAME[];
+		static const char VGM_FILENAME[];
+		static const char VIDEO_FILENAME[];
+
+		/**
+		 * Load a file.
+		 * @param filename Filename.
+		 * @param data [out] File data.
+		 */
+		static void loadFile(const char *filename, vector<uint8_t> *data);
+
+		static inline uint16_t getLE16(const uint8_t *p)
+			{ return p[0] | (p[1] << 8); }
+		static inline uint32_t getLE32(const uint8_t *p)
+			{ return getLE16(p) | ((uint32_t)getLE16(p + 2) << 16); }
+
+		// Decoded VGM register write.
+		struct VgmWrite {
+			uint32_t sample;
+			uint8_t cmd;	// 0x50, 0x52, 0x53, or 0x80 for DAC.
+			uint8_t reg;
+			uint8_t data;
+		};
+
+		/**
+		 * Decode VGM commands.
+		 * @param data VGM file.
+		 * @param pcm [out] DAC data block.
+		 * @param writes [out] Register writes.
+		 * @return Total samples.
+		 */
+		static uint32_t decodeVgm(const vector<uint8_t> &data,
+			vector<uint8_t> *pcm, vector<VgmWrite> *writes);
+};
+
+const char CaptureTest::WAV_FILENAME[] = "CaptureTest.wav";
+const char CaptureTest::VGM_FILENAME[] = "CaptureTest.vgm";
+const char CaptureTest::VIDEO_FILENAME[] = "CaptureTest.y4m";
+
+void CaptureTest::SetUp(void)
+{
+	SoundMgr::ReInit(44100, false);
+}
+
+void CaptureTest::TearDown(void)
+{
+	remove(WAV_FILENAME);
+	remove(VGM_FILENAME);
+	remove(VIDEO_FILENAME);
+}
+
+/**
+ * Load a file.
+ * @param filename Filename.
+ * @param data [out] File data.
+ */
+void CaptureTest::loadFile(const char *filename, vector<uint8_t> *data)
+{
+	FILE *f = fopen(filename, "rb");
+	ASSERT_TRUE(f != nullptr) << "Unable to open " << filename;
+	data->clear();
+	uint8_t block[16384];
+	size_t size;
+	while ((size = fread(block, 1, sizeof(block), f)) > 0) {
+		data->insert(data->end(), block, block + size);
+	}
+	fclose(f);
+}
+
+/**
+ * Decode VGM commands.
+ * @param data VGM file.
+ * @param pcm [out] DAC data block.
+ * @param writes [out] Register writes.
+ * @return Total samples.
+ */
+uint32_t CaptureTest::decodeVgm(const vector<uint8_t> &data,
+	vector<uint8_t> *pcm, vector<VgmWrite> *writes)
+{
+	pcm->clear();
+	writes->clear();
+	uint32_t sample = 0;
+	size_t pcmPos = 0;
+
+	size_t pos = 0x34 + getLE32(&data[0x34]);
+	while (pos < data.size()) {
+		const uint8_t cmd = data[pos];
+		VgmWrite w;
+		w.sample = sample;
+		w.cmd = cmd;
+		w.reg = 0;
+		w.data = 0;
+
+		if (cmd == 0x66) {
+			// End of sound data.
+			EXPECT_EQ(data.size(), pos + 1);
+			break;
+		} else if (cmd == 0x50) {
+			w.data = data[pos + 1];
+			writes->push_back(w);
+			pos += 2;
+		} else if (cmd == 0x52 || cmd == 0x53) {
+			w.reg = data[pos + 1];
+			w.data = data[pos + 2];
+			writes->push_back(w);
+			pos += 3;
+		} else if (cmd == 0x61) {
+			sample += getLE16(&data[pos + 1]);
+			pos += 3;
+		} else if (cmd == 0x62) {
+			sample += 735;
+			pos++;
+		} else if (cmd == 0x63) {
+			sample += 882;
+			pos++;
+		} else if ((cmd & 0xF0) == 0x70) {
+			sample += (cmd & 0x0F) + 1;
+			pos++;
+		} else if ((cmd & 0xF0) == 0x80) {
+			w.cmd = 0x80;
+			w.reg = 0x2A;
+			EXPECT_LT(pcmPos, pcm->size());
+			if (pcmPos < pcm->size()) {
+				w.data = (*pcm)[pcmPos++];
+			}
+			writes->push_back(w);
+			sample += (cmd & 0x0F);
+			pos++;
+		} else if (cmd == 0x67) {
+			// Data block.
+			EXPECT_EQ(0x66, data[pos + 1]);
+			EXPECT_EQ(0x00, data[pos + 2]);
+			const uint32_t size = getLE32(&data[pos + 3]);
+			pcm->insert(pcm->end(), data.begin() + pos + 7, data.begin() + pos + 7 + size);
+			pos += 7 + size;
+		} else if (cmd == 0xE0) {
+			pcmPos = getLE32(&data[pos + 1]);
+			pos += 5;
+		} else {
+			ADD_FAILURE() << "Unexpected VGM command 0x" << std::hex << (int)cmd;
+			break;
+		}
+	}
+
+	return sample;
+}
+
+/**
+ * Video format names.
+ */
+TEST_F(CaptureTest, videoFormatNames)
+{
+	for (int i = 0; i < Capture::VIDEO_MAX; i++) {
+		const Capture::VideoFormat format = (Capture::VideoFormat)i;
+		const char *name = Capture::VideoFormatName(format);
+		ASSERT_TRUE(name != nullptr);
+		EXPECT_EQ(format, Capture::VideoFormatFromName(name));
+	}
+	EXPECT_EQ(Capture::VIDEO_MAX, Capture::VideoFormatFromName("mkv"));
+	EXPECT_EQ(Capture::VIDEO_MAX, Capture::VideoFormatFromName(nullptr));
+}
+
+/**
+ * Invalid parameters must be rejected.
+ */
+TEST_F(CaptureTest, invalidParams)
+{
+	Capture capture;
+	EXPECT_EQ(-EINVAL, capture.start(nullptr, nullptr, nullptr));
+	EXPECT_EQ(-EINVAL, capture.start(nullptr, nullptr, VIDEO_FILENAME, Capture::VIDEO_MAX));
+	EXPECT_EQ(-ENOENT, capture.start("nonexistent/CaptureTest.wav", nullptr, nullptr));
+	EXPECT_FALSE(capture.isActive());
+
+	ASSERT_EQ(0, capture.start(WAV_FILENAME, nullptr, nullptr));
+	EXPECT_TRUE(capture.isActive());
+	EXPECT_EQ(-EBUSY, capture.start(WAV_FILENAME, nullptr, nullptr));
+	EXPECT_EQ(0, capture.stop());
+	EXPECT_FALSE(capture.isActive());
+	EXPECT_EQ(0, capture.stop());
+}
+
+/**
+ * WAV capture: Header and clamped 16-bit samples.
+ */
+TEST_F(CaptureTest, wav)
+{
+	const int len = SoundMgr::GetSegLength();
+	ASSERT_GT(len, 2);
+	for (int i = 0; i < len; i++) {
+		SoundMgr::ms_SegBufL[i] = i;
+		SoundMgr::ms_SegBufR[i] = -i;
+	}
+	SoundMgr::ms_SegBufL[0] = 40000;
+	SoundMgr::ms_SegBufR[0] = -40000;
+
+	static const int frames = 100;
+	Capture capture;
+	capture.setWaitForWriter(true);
+	ASSERT_EQ(0, capture.start(WAV_FILENAME, nullptr, nullptr));
+	for (int i = 0; i < frames; i++) {
+		capture.frame(nullptr);
+	}
+	EXPECT_EQ((uint32_t)frames, capture.frameCount());
+	EXPECT_EQ(0, capture.stop());
+	EXPECT_EQ(0U, capture.droppedCount());
+
+	vector<uint8_t> data;
+	ASSERT_NO_FATAL_FAILURE(loadFile(WAV_FILENAME, &data));
+	const uint32_t dataSize = frames * len * 4;
+	ASSERT_EQ(44 + dataSize, data.size());
+	EXPECT_EQ(0, memcmp(&data[0], "RIFF", 4));
+	EXPECT_EQ(36 + dataSize, getLE32(&data[4]));
+	EXPECT_EQ(0, memcmp(&data[8], "WAVEfmt ", 8));
+	EXPECT_EQ(1, getLE16(&data[20]));	// PCM
+	EXPECT_EQ(2, getLE16(&data[22]));	// Stereo
+	EXPECT_EQ((uint32_t)SoundMgr::GetSegRate(), getLE32(&data[24]));
+	EXPECT_EQ(16, getLE16(&data[34]));
+	EXPECT_EQ(0, memcmp(&data[36], "data", 4));
+	EXPECT_EQ(dataSize, getLE32(&data[40]));
+
+	// Check the last frame.
+	const uint8_t *p = &data[44 + (frames - 1) * len * 4];
+	EXPECT_EQ(0x7FFF, (int16_t)getLE16(&p[0]));
+	EXPECT_EQ(-0x8000, (int16_t)getLE16(&p[2]));
+	for (int i = 1; i < len; i++) {
+		EXPECT_EQ(i, (int16_t)getLE16(&p[i * 4]));
+		EXPECT_EQ(-i, (int16_t)getLE16(&p[i * 4 + 2]));
+	}
+}
+
+/**
+ * VGM capture: Header, register writes, and DAC data block.
+ */
+TEST_F(CaptureTest, vgm)
+{
+	Ym2612 &ym2612 = SoundMgr::ms_Ym2612;
+	Psg &psg = SoundMgr::ms_Psg;
+
+	Capture capture;
+	ASSERT_EQ(0, capture.start(nullptr, VGM_FILENAME, nullptr));
+
+	// Frame 0: Two DAC writes.
+	ym2612.write(0, 0x2A);
+	ym2612.write(1, 0x10);
+	ym2612.write(1, 0x20);
+	capture.frame(nullptr);
+
+	// Frame 1: DAC, FM, and PSG writes.
+	ym2612.write(1, 0x30);
+	ym2612.write(2, 0xB4);
+	ym2612.write(3, 0xC0);
+	psg.write(0x9F);
+	capture.frame(nullptr);
+	capture.frame(nullptr);
+	EXPECT_EQ(0, capture.stop());
+
+	// Writes after capture stops must not be logged.
+	ym2612.write(1, 0x40);
+
+	vector<uint8_t> data;
+	ASSERT_NO_FATAL_FAILURE(loadFile(VGM_FILENAME, &data));
+	ASSERT_GE(data.size(), 0x100U);
+	EXPECT_EQ(0, memcmp(&data[0], "Vgm ", 4));
+	EXPECT_EQ(data.size() - 4, getLE32(&data[0x04]));
+	EXPECT_EQ(0x171U, getLE32(&data[0x08]));
+	EXPECT_EQ(53693175U / 15, getLE32(&data[0x0C]));
+	EXPECT_EQ(735U * 3, getLE32(&data[0x18]));
+	EXPECT_EQ(60U, getLE32(&data[0x24]));
+	EXPECT_EQ(0x0009, getLE16(&data[0x28]));
+	EXPECT_EQ(16, data[0x2A]);
+	EXPECT_EQ(53693175U / 7, getLE32(&data[0x2C]));
+	EXPECT_EQ(0x100U - 0x34, getLE32(&data[0x34]));
+
+	vector<uint8_t> pcm;
+	vector<VgmWrite> writes;
+	EXPECT_EQ(735U * 3, decodeVgm(data, &pcm, &writes));
+	ASSERT_EQ(3U, pcm.size());
+	EXPECT_EQ(0x10, pcm[0]);
+	EXPECT_EQ(0x20, pcm[1]);
+	EXPECT_EQ(0x30, pcm[2]);
+
+	// The VGM starts with the register state at time 0.
+	// The last five writes were made during capture.
+	ASSERT_GT(writes.size(), 5U);
+	for (size_t i = 0; i < writes.size() - 5; i++) {
+		EXPECT_EQ(0U, writes[i].sample);
+		EXPECT_NE(0x80, writes[i].cmd);
+	}
+	const VgmWrite *w = &writes[writes.size() - 5];
+	EXPECT_EQ(0U, w[0].sample);
+	EXPECT_EQ(0x80, w[0].cmd);
+	EXPECT_EQ(0x10, w[0].data);
+	EXPECT_EQ(0U, w[1].sample);
+	EXPECT_EQ(0x80, w[1].cmd);
+	EXPECT_EQ(0x20, w[1].data);
+	EXPECT_EQ(735U, w[2].sample);
+	EXPECT_EQ(0x80, w[2].cmd);
+	EXPECT_EQ(0x30, w[2].data);
+	EXPECT_EQ(735U, w[3].sample);
+	EXPECT_EQ(0x53, w[3].cmd);
+	EXPECT_EQ(0xB4, w[3].reg);
+	EXPECT_EQ(0xC0, w[3].data);
+	EXPECT_EQ(735U, w[4].sample);
+	EXPECT_EQ(0x50, w[4].cmd);
+	EXPECT_EQ(0x9F, w[4].data);
+
+	// The wait after the second DAC write is folded into it. (0x8F)
+	static const uint8_t dacCmds[2] = {0x80, 0x8F};
+	EXPECT_NE(data.end(), std::search(data.begin() + 0x100, data.end(),
+		dacCmds, dacCmds + sizeof(dacCmds)));
+}
+
+/**
+ * Y4M capture: Header, cropping, and padding.
+ */
+TEST_F(CaptureTest, y4m)
+{
+	MdFb *fb = new MdFb();
+	fb->setBpp(MdFb::BPP_32);
+	fb->setImgWidth(320);
+	fb->setImgHeight(224);
+	fb->setImgXStart(0);
+	fb->setImgYStart(8);
+	for (int y = 0; y < 240; y++) {
+		uint32_t *line = fb->lineBuf32(y);
+		for (int x = 0; x < fb->pxPerLine(); x++) {
+			line[x] = 0xFFFFFF;	// White
+		}
+	}
+
+	Capture capture;
+	ASSERT_EQ(0, capture.start(nullptr, nullptr, VIDEO_FILENAME, Capture::VIDEO_Y4M));
+	capture.frame(fb);
+
+	// Second frame is narrower and uses 16-bit color.
+	// It must be padded with black.
+	fb->setBpp(MdFb::BPP_16);
+	fb->setImgWidth(256);
+	for (int y = 0; y < 240; y++) {
+		uint16_t *line = fb->lineBuf16(y);
+		for (int x = 0; x < fb->pxPerLine(); x++) {
+			line[x] = 0xFFFF;	// White
+		}
+	}
+	capture.frame(fb);
+	EXPECT_EQ(0, capture.stop());
+	fb->unref();
+
+	vector<uint8_t> data;
+	ASSERT_NO_FATAL_FAILURE(loadFile(VIDEO_FILENAME, &data));
+	static const char hdr[] = "YUV4MPEG2 W320 H224 F60:1 Ip A1:1 C444\n";
+	const size_t hdrLen = sizeof(hdr) - 1;
+	const size_t frameSize = 6 + (320 * 224 * 3);
+	ASSERT_EQ(hdrLen + (frameSize * 2), data.size());
+	EXPECT_EQ(0, memcmp(&data[0], hdr, hdrLen));
+
+	// First frame: All white. (Y=235, U=V=128)
+	const uint8_t *frame = &data[hdrLen];
+	EXPECT_EQ(0, memcmp(frame, "FRAME\n", 6));
+	EXPECT_EQ(235, frame[6]);
+	EXPECT_EQ(235, frame[6 + (320 * 224) - 1]);
+	EXPECT_EQ(128, frame[6 + (320 * 224)]);
+	EXPECT_EQ(128, frame[6 + (320 * 224 * 2)]);
+
+	// Second frame: White on the left; black on the right. (Y=16)
+	frame += frameSize;
+	EXPECT_EQ(0, memcmp(frame, "FRAME\n", 6));
+	EXPECT_EQ(235, frame[6 + 255]);
+	EXPECT_EQ(16, frame[6 + 256]);
+	EXPECT_EQ(16, frame[6 + 319]);
+	EXPECT_EQ(128, frame[6 + (320 * 224) + 300]);
+}
+
+#ifndef _WIN32
+/**
+ * Raw video piped to an external command.
+ */
+TEST_F(CaptureTest, rawPipe)
+{
+	MdFb *fb = new MdFb();
+	fb->setBpp(MdFb::BPP_15);
+	fb->setImgWidth(256);
+	fb->setImgHeight(224);
+	fb->setImgXStart(0);
+	fb->setImgYStart(0);
+	fb->lineBuf16(0)[0] = 0x7C00;	// Red
+	fb->lineBuf16(0)[1] = 0x03E0;	// Green
+	fb->lineBuf16(0)[2] = 0x001F;	// Blue
+
+	std::string cmd = "|cat > ";
+	cmd += VIDEO_FILENAME;
+	Capture capture;
+	capture.setWaitForWriter(true);
+	ASSERT_EQ(0, capture.start(nullptr, nullptr, cmd.c_str(), Capture::VIDEO_RAW_RGB24));
+	for (int i = 0; i < 10; i++) {
+		capture.frame(fb);
+	}
+	EXPECT_EQ(0, capture.stop());
+	EXPECT_EQ(0U, capture.droppedCount());
+	fb->unref();
+
+	vector<uint8_t> data;
+	ASSERT_NO_FATAL_FAILURE(loadFile(VIDEO_FILENAME, &data));
+	ASSERT_EQ(10U * 256 * 224 * 3, data.size());
+	static const uint8_t rgb[9] = {0xFF,0,0, 0,0xFF,0, 0,0,0xFF};
+	EXPECT_EQ(0, memcmp(&data[0], rgb, sizeof(rgb)));
+}
+#endif /* !_WIN32 */
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: Capture test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
@@ -39,6 +39,26 @@ using LibZomg::PngReader;
 
 namespace LibGens { namespace Tests {
 
+/**
+ * Get test parameters for CPU flags that the CPU
+ * might not support, e.g. AVX2. Use with ::testing::ValuesIn().
+ * @param cpuFlags CPU flags.
+ * @param cpuFlags_slow "Slow" CPU flags.
+ * @return Test parameters if the CPU supports cpuFlags; otherwise, nothing.
+ */
+std::vector<EffectTest_flags> EffectTest_flagsIfSupported(uint32_t cpuFlags, uint32_t cpuFlags_slow)
+{
+	// NOTE: This is called before LibGens::Init(),
+	// so the CPU flags have to be detected here.
+	std::vector<EffectTest_flags> ret;
+	if ((LibCompat_GetCPUFlags() & cpuFlags) == cpuFlags) {
+		ret.push_back(EffectTest_flags(cpuFlags, cpuFlags_slow));
+	} else {
+		fprintf(stderr, "CPU does not support flags 0x%08X; skipping those tests.\n", cpuFlags);
+	}
+	return ret;
+}
+
 /**
  * Set up the test.
  */
@@ -314,4 +334,27 @@ void EffectTest::compareFb(const MdFb *fb_expected, const MdFb *fb_actual)
 	}
 }
 
+/**
+ * Report benchmark throughput.
+ * This is printed and recorded as a test property,
+ * so each instruction set can be compared.
+ * @param pxCount	[in] Pixels processed per iteration.
+ * @param iterations	[in] Number of iterations.
+ * @param usec		[in] Elapsed time, in microseconds.
+ */
+void EffectTest::reportThroughput(unsigned int pxCount, int iterations, uint64_t usec)
+{
+	if (usec == 0) {
+		// Too fast to measure.
+		usec = 1;
+	}
+
+	// Megapixels per second.
+	const double mpx = ((double)pxCount * (double)iterations) / (double)usec;
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%.1f", mpx);
+	printf("Throughput: %s Mpx/s (flags 0x%08X)\n", buf, GetParam().cpuFlags);
+	RecordProperty("throughput_mpx_per_sec", buf);
+}
+
 } }
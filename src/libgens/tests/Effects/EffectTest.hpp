@@ -28,6 +28,9 @@
 // C includes.
 #include <stdint.h>
 
+// C++ includes.
+#include <vector>
+
 // LibGens, LibZomg
 #include "Util/MdFb.hpp"
 #include "libzomg/img_data.h"
@@ -45,6 +48,15 @@ struct EffectTest_flags {
 	}
 };
 
+/**
+ * Get test parameters for CPU flags that the CPU
+ * might not support, e.g. AVX2. Use with ::testing::ValuesIn().
+ * @param cpuFlags CPU flags.
+ * @param cpuFlags_slow "Slow" CPU flags.
+ * @return Test parameters if the CPU supports cpuFlags; otherwise, nothing.
+ */
+std::vector<EffectTest_flags> EffectTest_flagsIfSupported(uint32_t cpuFlags, uint32_t cpuFlags_slow);
+
 class EffectTest : public ::testing::TestWithParam<EffectTest_flags>
 {
 	protected:
@@ -109,6 +121,16 @@ class EffectTest : public ::testing::TestWithParam<EffectTest_flags>
 		 */
 		void compareFb(const MdFb *fb_expected, const MdFb *fb_actual);
 
+		/**
+		 * Report benchmark throughput.
+		 * This is printed and recorded as a test property,
+		 * so each instruction set can be compared.
+		 * @param pxCount	[in] Pixels processed per iteration.
+		 * @param iterations	[in] Number of iterations.
+		 * @param usec		[in] Elapsed time, in microseconds.
+		 */
+		void reportThroughput(unsigned int pxCount, int iterations, uint64_t usec);
+
 	protected:
 		Zomg_Img_Data_t img_normal;
 		Zomg_Img_Data_t img_paused;
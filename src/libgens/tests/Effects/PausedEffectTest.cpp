@@ -148,19 +148,60 @@ TEST_P(PausedEffectTest, do32bit_2FB)
 	compareFb(fb_paused, fb_test2);
 }
 
+/**
+ * Test the Paused Effect in 16-bit color. (raw buffer)
+ */
+TEST_P(PausedEffectTest, do16bit_raw)
+{
+	// Initialize the images.
+	ASSERT_NO_FATAL_FAILURE(init(MdFb::BPP_16));
+	// Initialize the test framebuffer with the "normal" image.
+	ASSERT_NO_FATAL_FAILURE(copyToFb16(fb_test1, &img_normal));
+	// Apply the effect to fb_test2's buffer as a raw buffer.
+	const unsigned int pxCount = fb_test1->pxPitch() * fb_test1->numLines();
+	PausedEffect::DoPausedEffect(fb_test2->fb16(), fb_test1->fb16(), MdFb::BPP_16, pxCount);
+	// Compare it to the known good image.
+	compareFb(fb_paused, fb_test2);
+}
+
+/**
+ * Test the Paused Effect in 32-bit color. (raw buffer, in place)
+ */
+TEST_P(PausedEffectTest, do32bit_raw)
+{
+	// Initialize the images.
+	ASSERT_NO_FATAL_FAILURE(init(MdFb::BPP_32));
+	// Initialize the test framebuffer with the "normal" image.
+	ASSERT_NO_FATAL_FAILURE(copyToFb32(fb_test1, &img_normal));
+	// Apply the effect to fb_test1's buffer in place.
+	const unsigned int pxCount = fb_test1->pxPitch() * fb_test1->numLines();
+	PausedEffect::DoPausedEffect(fb_test1->fb32(), fb_test1->fb32(), MdFb::BPP_32, pxCount);
+	// Compare it to the known good image.
+	compareFb(fb_paused, fb_test1);
+}
+
 INSTANTIATE_TEST_CASE_P(PausedEffectTest_NoFlags, PausedEffectTest,
 	::testing::Values(EffectTest_flags(0, 0)
 ));
 
-// NOTE: PausedEffect.cpp only implements MMX/SSE2 using GNU assembler.
+// NOTE: MMX is only implemented using GNU assembler.
 #if defined(__GNUC__) && \
     (defined(__i386__) || defined(__amd64__) || defined(__x86_64__))
 INSTANTIATE_TEST_CASE_P(PausedEffectTest_MMX, PausedEffectTest,
 	::testing::Values(EffectTest_flags(MDP_CPUFLAG_X86_MMX, 0)
 ));
+#endif
+
+// SSE2 and AVX2 are implemented using intrinsics.
+#if defined(__i386__) || defined(__amd64__) || defined(__x86_64__) || \
+    defined(_M_IX86) || defined(_M_X64)
 INSTANTIATE_TEST_CASE_P(PausedEffectTest_SSE2, PausedEffectTest,
 	::testing::Values(EffectTest_flags(MDP_CPUFLAG_X86_SSE2, MDP_CPUFLAG_X86_SSE2SLOW)
 ));
+// AVX2 is skipped if the CPU doesn't support it.
+INSTANTIATE_TEST_CASE_P(PausedEffectTest_AVX2, PausedEffectTest,
+	::testing::ValuesIn(EffectTest_flagsIfSupported(MDP_CPUFLAG_X86_AVX2, 0)
+));
 #endif
 
 } }
@@ -25,6 +25,9 @@
 #include "Effects/PausedEffect.hpp"
 #include "libcompat/cpuflags.h"
 
+// Timing.
+#include "Util/Timing.hpp"
+
 namespace LibGens { namespace Tests {
 
 class PausedEffectTest_benchmark : public PausedEffectTest
@@ -51,12 +54,16 @@ TEST_P(PausedEffectTest_benchmark, do15bit_1FB)
 
 	// Run this test BENCHMARK_ITERATIONS times.
 	const uint32_t fb_sz = fb_test1->pxPitch() * fb_test1->numLines() * 2;
+	Timing timing;
+	const uint64_t start = timing.getTime();
 	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
 		// Copy the initialized framebuffer to fb_test2.
 		memcpy(fb_test2->fb16(), fb_test1->fb16(), fb_sz);
 		// Apply the "paused" effect. (1-FB version)
 		PausedEffect::DoPausedEffect(fb_test2);
 	}
+	reportThroughput(fb_test1->pxPitch() * fb_test1->numLines(),
+		BENCHMARK_ITERATIONS, timing.getTime() - start);
 }
 
 /**
@@ -70,10 +77,14 @@ TEST_P(PausedEffectTest_benchmark, do15bit_2FB)
 	ASSERT_NO_FATAL_FAILURE(copyToFb15(fb_test1, &img_normal));
 
 	// Run this test BENCHMARK_ITERATIONS times.
+	Timing timing;
+	const uint64_t start = timing.getTime();
 	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
 		// Apply the "paused" effect. (2-FB version)
 		PausedEffect::DoPausedEffect(fb_test2, fb_test1);
 	}
+	reportThroughput(fb_test1->pxPitch() * fb_test1->numLines(),
+		BENCHMARK_ITERATIONS, timing.getTime() - start);
 }
 
 /**
@@ -88,12 +99,16 @@ TEST_P(PausedEffectTest_benchmark, do16bit_1FB)
 
 	// Run this test BENCHMARK_ITERATIONS times.
 	const uint32_t fb_sz = fb_test1->pxPitch() * fb_test1->numLines() * 2;
+	Timing timing;
+	const uint64_t start = timing.getTime();
 	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
 		// Copy the initialized framebuffer to fb_test2.
 		memcpy(fb_test2->fb16(), fb_test1->fb16(), fb_sz);
 		// Apply the "paused" effect. (1-FB version)
 		PausedEffect::DoPausedEffect(fb_test2);
 	}
+	reportThroughput(fb_test1->pxPitch() * fb_test1->numLines(),
+		BENCHMARK_ITERATIONS, timing.getTime() - start);
 }
 
 /**
@@ -107,10 +122,14 @@ TEST_P(PausedEffectTest_benchmark, do16bit_2FB)
 	ASSERT_NO_FATAL_FAILURE(copyToFb16(fb_test1, &img_normal));
 
 	// Run this test BENCHMARK_ITERATIONS times.
+	Timing timing;
+	const uint64_t start = timing.getTime();
 	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
 		// Apply the "paused" effect. (2-FB version)
 		PausedEffect::DoPausedEffect(fb_test2, fb_test1);
 	}
+	reportThroughput(fb_test1->pxPitch() * fb_test1->numLines(),
+		BENCHMARK_ITERATIONS, timing.getTime() - start);
 }
 
 /**
@@ -125,12 +144,16 @@ TEST_P(PausedEffectTest_benchmark, do32bit_1FB)
 
 	// Run this test BENCHMARK_ITERATIONS times.
 	const uint32_t fb_sz = fb_test1->pxPitch() * fb_test1->numLines() * 4;
+	Timing timing;
+	const uint64_t start = timing.getTime();
 	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
 		// Copy the initialized framebuffer to fb_test2.
 		memcpy(fb_test2->fb32(), fb_test1->fb32(), fb_sz);
 		// Apply the "paused" effect. (1-FB version)
 		PausedEffect::DoPausedEffect(fb_test2);
 	}
+	reportThroughput(fb_test1->pxPitch() * fb_test1->numLines(),
+		BENCHMARK_ITERATIONS, timing.getTime() - start);
 }
 
 /**
@@ -144,25 +167,38 @@ TEST_P(PausedEffectTest_benchmark, do32bit_2FB)
 	ASSERT_NO_FATAL_FAILURE(copyToFb32(fb_test1, &img_normal));
 
 	// Run this test BENCHMARK_ITERATIONS times.
+	Timing timing;
+	const uint64_t start = timing.getTime();
 	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
 		// Apply the "paused" effect. (2-FB version)
 		PausedEffect::DoPausedEffect(fb_test2, fb_test1);
 	}
+	reportThroughput(fb_test1->pxPitch() * fb_test1->numLines(),
+		BENCHMARK_ITERATIONS, timing.getTime() - start);
 }
 
 INSTANTIATE_TEST_CASE_P(PausedEffectTest_benchmark_NoFlags, PausedEffectTest_benchmark,
 	::testing::Values(EffectTest_flags(0, 0)
 ));
 
-// NOTE: PausedEffect.cpp only implements MMX/SSE2 using GNU assembler.
+// NOTE: MMX is only implemented using GNU assembler.
 #if defined(__GNUC__) && \
     (defined(__i386__) || defined(__amd64__) || defined(__x86_64__))
 INSTANTIATE_TEST_CASE_P(PausedEffectTest_benchmark_MMX, PausedEffectTest_benchmark,
 	::testing::Values(EffectTest_flags(MDP_CPUFLAG_X86_MMX, 0)
 ));
+#endif
+
+// SSE2 and AVX2 are implemented using intrinsics.
+#if defined(__i386__) || defined(__amd64__) || defined(__x86_64__) || \
+    defined(_M_IX86) || defined(_M_X64)
 INSTANTIATE_TEST_CASE_P(PausedEffectTest_benchmark_SSE2, PausedEffectTest_benchmark,
 	::testing::Values(EffectTest_flags(MDP_CPUFLAG_X86_SSE2, MDP_CPUFLAG_X86_SSE2SLOW)
 ));
+// AVX2 is skipped if the CPU doesn't support it.
+INSTANTIATE_TEST_CASE_P(PausedEffectTest_benchmark_AVX2, PausedEffectTest_benchmark,
+	::testing::ValuesIn(EffectTest_flagsIfSupported(MDP_CPUFLAG_X86_AVX2, 0)
+));
 #endif
 
 } }
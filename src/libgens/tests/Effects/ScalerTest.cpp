@@ -0,0 +1,489 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * ScalerTest.cpp: Software scaler tests.                                  *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "ScalerTest.hpp"
+
+// LibGens
+#include "lg_main.hpp"
+
+// LibZomg
+#include "libzomg/PngReader.hpp"
+using LibZomg::PngReader;
+
+// LibCompat
+#include "libcompat/cpuflags.h"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ includes.
+#include <vector>
+using std::vector;
+
+namespace LibGens { namespace Tests {
+
+/**
+ * Get the base filename for the output reference images.
+ * @return Base filename, e.g. "Scaler".
+ */
+const char *ScalerTest::baseFilename(void)
+{
+	return "Scaler";
+}
+
+/**
+ * Get the render type for the output reference images.
+ * @return Render type, e.g. "SW" or "SW-int".
+ */
+const char *ScalerTest::renderType(void)
+{
+	// Reference images are named after the scaler mode.
+	return "SW";
+}
+
+/**
+ * Load the "normal" image into fb_normal.
+ * Scaled reference images have different dimensions
+ * than the MdFb, so EffectTest::init() can't be used.
+ * @param bpp Color depth.
+ */
+void ScalerTest::initNormal(MdFb::ColorDepth bpp)
+{
+	const int bppNum = MdFb::colorDepthToBpp(bpp);
+	char filename[64];
+	snprintf(filename, sizeof(filename), "Effects.Normal.%d.png", bppNum);
+
+	PngReader reader;
+	int ret = reader.readFromFile(&img_normal, filename,
+			PngReader::RF_INVERTED_ALPHA);
+	ASSERT_EQ(0, ret) << "Error loading \"" << filename << "\": " << strerror(-ret);
+
+	fb_normal = new MdFb();
+	switch (bpp) {
+		case MdFb::BPP_15:
+			copyToFb15(fb_normal, &img_normal);
+			break;
+		case MdFb::BPP_16:
+			copyToFb16(fb_normal, &img_normal);
+			break;
+		case MdFb::BPP_32:
+		default:
+			copyToFb32(fb_normal, &img_normal);
+			break;
+	}
+}
+
+/**
+ * Compare the scaler output to a reference image.
+ * @param scaler Scaler.
+ * @param mode Scaler mode, e.g. "Scale2x".
+ */
+void ScalerTest::compareToImage(const Scaler *scaler, const char *mode)
+{
+	const MdFb::ColorDepth bpp = scaler->bpp();
+	char filename[64];
+	snprintf(filename, sizeof(filename), "%s.%s.%d.png",
+		 baseFilename(), mode, MdFb::colorDepthToBpp(bpp));
+
+	PngReader reader;
+	Zomg_Img_Data_t img;
+	memset(&img, 0, sizeof(img));
+	int ret = reader.readFromFile(&img, filename, PngReader::RF_INVERTED_ALPHA);
+	ASSERT_EQ(0, ret) << "Error loading \"" << filename << "\": " << strerror(-ret);
+	ASSERT_EQ(32, img.bpp);
+	EXPECT_EQ(scaler->width(), (int)img.w);
+	EXPECT_EQ(scaler->height(), (int)img.h);
+	if (scaler->width() != (int)img.w || scaler->height() != (int)img.h) {
+		free(img.data);
+		return;
+	}
+
+	// Convert each line of the reference image to the
+	// scaler's color depth, then compare it.
+	const int w = (int)img.w;
+	vector<uint16_t> line16(w);
+	for (int y = 0; y < (int)img.h; y++) {
+		const uint32_t *pSrc = (const uint32_t*)((const uint8_t*)img.data + y * img.pitch);
+		int cmp;
+		if (bpp == MdFb::BPP_32) {
+			cmp = memcmp(scaler->fb32() + y * scaler->pxPitch(), pSrc, w * sizeof(uint32_t));
+		} else {
+			for (int x = 0; x < w; x++) {
+				const uint8_t r = (pSrc[x] >> 16) & 0xFF;
+				const uint8_t g = (pSrc[x] >> 8) & 0xFF;
+				const uint8_t b = pSrc[x] & 0xFF;
+				if (bpp == MdFb::BPP_15) {
+					line16[x] = ((r & 0xF8) << 7) | ((g & 0xF8) << 2) | ((b & 0xF8) >> 3);
+				} else {
+					line16[x] = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | ((b & 0xF8) >> 3);
+				}
+			}
+			cmp = memcmp(scaler->fb16() + y * scaler->pxPitch(), &line16[0], w * sizeof(uint16_t));
+		}
+		EXPECT_EQ(0, cmp) << "Line " << y << " did not match the reference image.";
+	}
+
+	free(img.data);
+}
+
+/**
+ * Compare the scaler output to fb_normal, scaled with
+ * nearest-neighbor scaling.
+ * @param scaler Scaler.
+ * @param factor Scaling factor.
+ */
+void ScalerTest::compareToNearest(const Scaler *scaler, int factor)
+{
+	ASSERT_EQ(fb_normal->pxPerLine() * factor, scaler->width());
+	ASSERT_EQ(fb_normal->numLines() * factor, scaler->height());
+	ASSERT_EQ(fb_normal->bpp(), scaler->bpp());
+
+	for (int y = 0; y < scaler->height(); y++) {
+		int mismatch = -1;
+		if (scaler->bpp() == MdFb::BPP_32) {
+			const uint32_t *src = fb_normal->lineBuf32(y / factor);
+			const uint32_t *dest = scaler->fb32() + y * scaler->pxPitch();
+			for (int x = 0; x < scaler->width(); x++) {
+				if (dest[x] != src[x / factor]) {
+					mismatch = x;
+					break;
+				}
+			}
+		} else {
+			const uint16_t *src = fb_normal->lineBuf16(y / factor);
+			const uint16_t *dest = scaler->fb16() + y * scaler->pxPitch();
+			for (int x = 0; x < scaler->width(); x++) {
+				if (dest[x] != src[x / factor]) {
+					mismatch = x;
+					break;
+				}
+			}
+		}
+		ASSERT_EQ(-1, mismatch) << "Line " << y << " did not match.";
+	}
+}
+
+/**
+ * Test nearest-neighbor scaling in all color depths.
+ */
+TEST_P(ScalerTest, nearest)
+{
+	static const MdFb::ColorDepth depths[] = {MdFb::BPP_15, MdFb::BPP_16, MdFb::BPP_32};
+	for (int i = 0; i < 3; i++) {
+		SCOPED_TRACE(MdFb::colorDepthToBpp(depths[i]));
+		if (fb_normal) {
+			fb_normal->unref();
+			fb_normal = nullptr;
+		}
+		free(img_normal.data);
+		img_normal.data = nullptr;
+		ASSERT_NO_FATAL_FAILURE(initNormal(depths[i]));
+
+		Scaler scaler;
+		for (int mode = Scaler::SCALER_NONE; mode <= Scaler::SCALER_NEAREST_4X; mode++) {
+			SCOPED_TRACE(Scaler::ModeName((Scaler::Mode)mode));
+			scaler.setMode((Scaler::Mode)mode);
+			ASSERT_EQ(0, scaler.scale(fb_normal));
+			ASSERT_NO_FATAL_FAILURE(compareToNearest(&scaler,
+				Scaler::ScaleFactor((Scaler::Mode)mode)));
+		}
+	}
+}
+
+/**
+ * Test Scale2x in 15-bit color.
+ */
+TEST_P(ScalerTest, scale2x_15bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_15));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_SCALE2X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "Scale2x");
+}
+
+/**
+ * Test Scale2x in 16-bit color.
+ */
+TEST_P(ScalerTest, scale2x_16bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_16));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_SCALE2X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "Scale2x");
+}
+
+/**
+ * Test Scale2x in 32-bit color.
+ */
+TEST_P(ScalerTest, scale2x_32bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_32));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_SCALE2X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "Scale2x");
+}
+
+/**
+ * Test Scale3x in 15-bit color.
+ */
+TEST_P(ScalerTest, scale3x_15bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_15));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_SCALE3X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "Scale3x");
+}
+
+/**
+ * Test Scale3x in 16-bit color.
+ */
+TEST_P(ScalerTest, scale3x_16bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_16));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_SCALE3X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "Scale3x");
+}
+
+/**
+ * Test Scale3x in 32-bit color.
+ */
+TEST_P(ScalerTest, scale3x_32bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_32));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_SCALE3X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "Scale3x");
+}
+
+/**
+ * Test hq2x in 15-bit color.
+ */
+TEST_P(ScalerTest, hq2x_15bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_15));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_HQ2X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "HQ2x");
+}
+
+/**
+ * Test hq2x in 16-bit color.
+ */
+TEST_P(ScalerTest, hq2x_16bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_16));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_HQ2X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "HQ2x");
+}
+
+/**
+ * Test hq2x in 32-bit color.
+ */
+TEST_P(ScalerTest, hq2x_32bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_32));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_HQ2X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "HQ2x");
+}
+
+/**
+ * Test hq3x in 15-bit color.
+ */
+TEST_P(ScalerTest, hq3x_15bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_15));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_HQ3X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "HQ3x");
+}
+
+/**
+ * Test hq3x in 16-bit color.
+ */
+TEST_P(ScalerTest, hq3x_16bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_16));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_HQ3X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "HQ3x");
+}
+
+/**
+ * Test hq3x in 32-bit color.
+ */
+TEST_P(ScalerTest, hq3x_32bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_32));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_HQ3X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "HQ3x");
+}
+
+/**
+ * Test xBR 2x in 15-bit color.
+ */
+TEST_P(ScalerTest, xbr2x_15bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_15));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_XBR2X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "xBR2x");
+}
+
+/**
+ * Test xBR 2x in 16-bit color.
+ */
+TEST_P(ScalerTest, xbr2x_16bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_16));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_XBR2X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "xBR2x");
+}
+
+/**
+ * Test xBR 2x in 32-bit color.
+ */
+TEST_P(ScalerTest, xbr2x_32bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_32));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_XBR2X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "xBR2x");
+}
+
+/**
+ * Test xBR 3x in 15-bit color.
+ */
+TEST_P(ScalerTest, xbr3x_15bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_15));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_XBR3X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "xBR3x");
+}
+
+/**
+ * Test xBR 3x in 16-bit color.
+ */
+TEST_P(ScalerTest, xbr3x_16bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_16));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_XBR3X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "xBR3x");
+}
+
+/**
+ * Test xBR 3x in 32-bit color.
+ */
+TEST_P(ScalerTest, xbr3x_32bit)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_32));
+	Scaler scaler;
+	scaler.setMode(Scaler::SCALER_XBR3X);
+	ASSERT_EQ(0, scaler.scale(fb_normal));
+	compareToImage(&scaler, "xBR3x");
+}
+
+/**
+ * The output must not depend on the number of threads.
+ */
+TEST_P(ScalerTest, threadCount)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(MdFb::BPP_32));
+
+	static const int threads[] = {1, 2, 3, 8};
+	for (int i = 0; i < 4; i++) {
+		SCOPED_TRACE(threads[i]);
+		Scaler scaler;
+		scaler.setThreadCount(threads[i]);
+		scaler.setMode(Scaler::SCALER_SCALE2X);
+		ASSERT_EQ(0, scaler.scale(fb_normal));
+		compareToImage(&scaler, "Scale2x");
+
+		// Switch modes without recreating the scaler.
+		scaler.setMode(Scaler::SCALER_SCALE3X);
+		ASSERT_EQ(0, scaler.scale(fb_normal));
+		compareToImage(&scaler, "Scale3x");
+
+		// hq2x and xBR read the lines around each band.
+		scaler.setMode(Scaler::SCALER_HQ2X);
+		ASSERT_EQ(0, scaler.scale(fb_normal));
+		compareToImage(&scaler, "HQ2x");
+
+		scaler.setMode(Scaler::SCALER_XBR3X);
+		ASSERT_EQ(0, scaler.scale(fb_normal));
+		compareToImage(&scaler, "xBR3x");
+	}
+}
+
+INSTANTIATE_TEST_CASE_P(ScalerTest_NoFlags, ScalerTest,
+	::testing::Values(EffectTest_flags(0, 0)
+));
+
+// NOTE: Scaler.cpp only implements SSE2 if the compiler supports it.
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+INSTANTIATE_TEST_CASE_P(ScalerTest_SSE2, ScalerTest,
+	::testing::Values(EffectTest_flags(MDP_CPUFLAG_X86_SSE2, 0)
+));
+#endif
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: Scaler test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
@@ -0,0 +1,75 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * ScalerTest.hpp: Software scaler tests.                                  *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_TESTS_EFFECTS_SCALERTEST_HPP
+#define __LIBGENS_TESTS_EFFECTS_SCALERTEST_HPP
+
+#include "EffectTest.hpp"
+#include "Effects/Scaler.hpp"
+
+namespace LibGens { namespace Tests {
+
+class ScalerTest : public EffectTest
+{
+	protected:
+		ScalerTest()
+			: EffectTest() { }
+		virtual ~ScalerTest() { }
+
+		/**
+		 * Get the base filename for the output reference images.
+		 * @return Base filename, e.g. "PausedEffect".
+		 */
+		virtual const char *baseFilename(void) override;
+
+		/**
+		 * Get the render type for the output reference images.
+		 * @return Render type, e.g. "SW" or "SW-int".
+		 */
+		virtual const char *renderType(void) override;
+
+		/**
+		 * Load the "normal" image into fb_normal.
+		 * Scaled reference images have different dimensions
+		 * than the MdFb, so EffectTest::init() can't be used.
+		 * @param bpp Color depth.
+		 */
+		void initNormal(MdFb::ColorDepth bpp);
+
+		/**
+		 * Compare the scaler output to a reference image.
+		 * @param scaler Scaler.
+		 * @param mode Scaler mode, e.g. "Scale2x".
+		 */
+		void compareToImage(const Scaler *scaler, const char *mode);
+
+		/**
+		 * Compare the scaler output to fb_normal, scaled with
+		 * nearest-neighbor scaling.
+		 * @param scaler Scaler.
+		 * @param factor Scaling factor.
+		 */
+		void compareToNearest(const Scaler *scaler, int factor);
+};
+
+} }
+
+#endif /* __LIBGENS_TESTS_EFFECTS_SCALERTEST_HPP */
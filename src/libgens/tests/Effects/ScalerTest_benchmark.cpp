@@ -0,0 +1,149 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * ScalerTest_benchmark.cpp: Software scaler benchmarks.                   *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "ScalerTest.hpp"
+
+// LibCompat
+#include "libcompat/cpuflags.h"
+
+namespace LibGens { namespace Tests {
+
+class ScalerTest_benchmark : public ScalerTest
+{
+	protected:
+		ScalerTest_benchmark()
+			: ScalerTest() { }
+		virtual ~ScalerTest_benchmark() { }
+
+	protected:
+		// Run benchmark loops 500 times.
+		static const int BENCHMARK_ITERATIONS = 500;
+
+		/**
+		 * Benchmark a scaler mode.
+		 * @param bpp Color depth.
+		 * @param mode Scaler mode.
+		 */
+		void benchmark(MdFb::ColorDepth bpp, Scaler::Mode mode);
+};
+
+/**
+ * Benchmark a scaler mode.
+ * @param bpp Color depth.
+ * @param mode Scaler mode.
+ */
+void ScalerTest_benchmark::benchmark(MdFb::ColorDepth bpp, Scaler::Mode mode)
+{
+	ASSERT_NO_FATAL_FAILURE(initNormal(bpp));
+	Scaler scaler;
+	scaler.setMode(mode);
+
+	// Run this test BENCHMARK_ITERATIONS times.
+	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		scaler.scale(fb_normal);
+	}
+}
+
+/**
+ * Benchmark nearest-neighbor 4x in 16-bit color.
+ */
+TEST_P(ScalerTest_benchmark, nearest4x_16bit)
+{
+	benchmark(MdFb::BPP_16, Scaler::SCALER_NEAREST_4X);
+}
+
+/**
+ * Benchmark nearest-neighbor 4x in 32-bit color.
+ */
+TEST_P(ScalerTest_benchmark, nearest4x_32bit)
+{
+	benchmark(MdFb::BPP_32, Scaler::SCALER_NEAREST_4X);
+}
+
+/**
+ * Benchmark Scale2x in 16-bit color.
+ */
+TEST_P(ScalerTest_benchmark, scale2x_16bit)
+{
+	benchmark(MdFb::BPP_16, Scaler::SCALER_SCALE2X);
+}
+
+/**
+ * Benchmark Scale2x in 32-bit color.
+ */
+TEST_P(ScalerTest_benchmark, scale2x_32bit)
+{
+	benchmark(MdFb::BPP_32, Scaler::SCALER_SCALE2X);
+}
+
+/**
+ * Benchmark Scale3x in 32-bit color.
+ */
+TEST_P(ScalerTest_benchmark, scale3x_32bit)
+{
+	benchmark(MdFb::BPP_32, Scaler::SCALER_SCALE3X);
+}
+
+/**
+ * Benchmark hq2x in 16-bit color.
+ */
+TEST_P(ScalerTest_benchmark, hq2x_16bit)
+{
+	benchmark(MdFb::BPP_16, Scaler::SCALER_HQ2X);
+}
+
+/**
+ * Benchmark hq2x in 32-bit color.
+ */
+TEST_P(ScalerTest_benchmark, hq2x_32bit)
+{
+	benchmark(MdFb::BPP_32, Scaler::SCALER_HQ2X);
+}
+
+/**
+ * Benchmark xBR 2x in 16-bit color.
+ */
+TEST_P(ScalerTest_benchmark, xbr2x_16bit)
+{
+	benchmark(MdFb::BPP_16, Scaler::SCALER_XBR2X);
+}
+
+/**
+ * Benchmark xBR 2x in 32-bit color.
+ */
+TEST_P(ScalerTest_benchmark, xbr2x_32bit)
+{
+	benchmark(MdFb::BPP_32, Scaler::SCALER_XBR2X);
+}
+
+INSTANTIATE_TEST_CASE_P(ScalerTest_benchmark_NoFlags, ScalerTest_benchmark,
+	::testing::Values(EffectTest_flags(0, 0)
+));
+
+// NOTE: Scaler.cpp only implements SSE2 if the compiler supports it.
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+INSTANTIATE_TEST_CASE_P(ScalerTest_benchmark_SSE2, ScalerTest_benchmark,
+	::testing::Values(EffectTest_flags(MDP_CPUFLAG_X86_SSE2, 0)
+));
+#endif
+
+} }
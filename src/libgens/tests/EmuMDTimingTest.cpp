@@ -0,0 +1,222 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * EmuMDTimingTest.cpp: EmuMD frame timing test.                           *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens
+#include "lg_main.hpp"
+#include "Rom.hpp"
+#include "EmuContext/EmuMD.hpp"
+#include "cpu/M68K_Mem.hpp"
+#include "cpu/Z80.hpp"
+#include "cpu/Z80_MD_Mem.hpp"
+#include "Vdp/Vdp.hpp"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstring>
+
+namespace LibGens { namespace Tests {
+
+/**
+ * Expected timing for a region.
+ * These are the values used by the old per-line loop.
+ */
+struct TimingParams {
+	SysVersion::RegionCode_t region;
+	int cpl_M68K;		// M68K cycles per line.
+	int cpl_Z80;		// Z80 cycles per line.
+	int lines;		// Lines per frame.
+	int visibleLines;	// Visible lines. (V28)
+};
+
+/**
+ * EmuMD with access to the scheduler timing.
+ */
+class EmuMD_Timing : public EmuMD
+{
+	public:
+		EmuMD_Timing(Rom *rom, SysVersion::RegionCode_t region)
+			: EmuMD(rom, region) { }
+
+		int mclkPerLine(void) const
+			{ return m_mclkPerLine; }
+		static int mclkPerM68K(void)
+			{ return MCLK_PER_M68K; }
+};
+
+class EmuMDTimingTest : public ::testing::TestWithParam<TimingParams>
+{
+	protected:
+		EmuMDTimingTest()
+			: ::testing::TestWithParam<TimingParams>()
+			, m_rom(nullptr)
+			, m_context(nullptr) { }
+		virtual ~EmuMDTimingTest() { }
+
+		virtual void SetUp(void) override;
+		virtual void TearDown(void) override;
+
+		// ROM size. (128 KB)
+		static const unsigned int ROM_SIZE = 128*1024;
+
+		uint8_t m_rom_data[ROM_SIZE];
+		Rom *m_rom;
+		EmuMD_Timing *m_context;
+};
+
+/**
+ * Create the test ROM and the emulation context.
+ * The M68K disables interrupts and loops forever.
+ */
+void EmuMDTimingTest::SetUp(void)
+{
+	memset(m_rom_data, 0xFF, sizeof(m_rom_data));
+
+	// Minimal ROM header.
+	memset(&m_rom_data[0x100], ' ', 0x100);
+	memcpy(&m_rom_data[0x100], "SEGA MEGA DRIVE ", 16);
+
+	// Vectors: SP == 0xFFFE00, PC == 0x200
+	static const uint8_t vectors[8] = {0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0x02, 0x00};
+	memcpy(m_rom_data, vectors, sizeof(vectors));
+
+	static const uint8_t code[] = {
+		0x46, 0xFC, 0x27, 0x00,	// move.w #$2700, sr
+		0x60, 0xFE,		// bra.s *
+	};
+	memcpy(&m_rom_data[0x200], code, sizeof(code));
+
+	m_rom = new Rom(m_rom_data, ROM_SIZE);
+	m_context = new EmuMD_Timing(m_rom, GetParam().region);
+	ASSERT_TRUE(m_context->isRomOpened());
+}
+
+void EmuMDTimingTest::TearDown(void)
+{
+	delete m_context;
+	delete m_rom;
+}
+
+/**
+ * Z80 program that counts until VINT.
+ * Each loop iteration is 18 cycles.
+ */
+static const uint8_t z80_count_to_vint[] = {
+	0xF3,			// 0000: di
+	0x31, 0x00, 0x20,	// 0001: ld sp,2000h
+	0xED, 0x56,		// 0004: im 1
+	0x21, 0x00, 0x00,	// 0006: ld hl,0
+	0xFB,			// 0009: ei
+	0x23,			// 000A: inc hl		; 6 cycles
+	0x18, 0xFD,		// 000B: jr 000Ah	; 12 cycles
+
+	// 000D: padding
+	0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+	0x22, 0x00, 0x10,	// 0038: ld (1000h),hl	; VINT handler
+	0x76,			// 003B: halt
+};
+
+/**
+ * Cycles per line must be the same as the old per-line loop.
+ */
+TEST_P(EmuMDTimingTest, cyclesPerLine)
+{
+	const TimingParams &params = GetParam();
+	EXPECT_EQ(params.cpl_M68K, M68K_Mem::CPL_M68K);
+	EXPECT_EQ(params.cpl_Z80, M68K_Mem::CPL_Z80);
+
+	// Lines must be a whole number of M68K cycles,
+	// so every line has exactly CPL_M68K cycles.
+	EXPECT_EQ(params.cpl_M68K * EmuMD_Timing::mclkPerM68K(), m_context->mclkPerLine());
+}
+
+/**
+ * Each frame must run the same number of cycles
+ * as the old per-line loop.
+ */
+TEST_P(EmuMDTimingTest, cyclesPerFrame)
+{
+	const TimingParams &params = GetParam();
+	for (int frame = 0; frame < 3; frame++) {
+		m_context->execFrame();
+		EXPECT_EQ(params.lines, m_context->m_vdp->VDP_Lines.totalDisplayLines);
+		EXPECT_EQ(params.lines * params.cpl_M68K, M68K_Mem::Cycles_M68K);
+		EXPECT_EQ((params.lines - 1) * params.cpl_M68K, M68K_Mem::LineStart_M68K);
+		EXPECT_EQ(params.lines * params.cpl_Z80, M68K_Mem::Cycles_Z80);
+		EXPECT_EQ((unsigned int)(params.lines * params.cpl_Z80), Z80::ReadOdometer());
+	}
+}
+
+/**
+ * The Z80 must get VINT at the same cycle as in the old
+ * per-line loop: 168 cycles before the end of the VBlank line.
+ */
+TEST_P(EmuMDTimingTest, z80Vint)
+{
+	const TimingParams &params = GetParam();
+
+	// Load the Z80 program and give the Z80 the bus.
+	memcpy(Ram_Z80, z80_count_to_vint, sizeof(z80_count_to_vint));
+	M68K_Mem::Z80_State = (Z80_STATE_ENABLED | Z80_STATE_BUSREQ);
+	Z80::HardReset();
+
+	m_context->execFrame();
+	ASSERT_EQ(params.visibleLines, m_context->m_vdp->VDP_Lines.totalVisibleLines);
+	const int count = Ram_Z80[0x1000] | (Ram_Z80[0x1001] << 8);
+
+	// VINT is raised once the Z80 reaches this cycle.
+	// It's accepted at the next instruction boundary.
+	const int vint = ((params.visibleLines + 1) * params.cpl_Z80) - 168;
+	const int setup = 4 + 10 + 8 + 10 + 4;
+	EXPECT_GE(count, (vint - setup) / 18);
+	EXPECT_LE(count, ((vint - setup) / 18) + 1);
+}
+
+INSTANTIATE_TEST_CASE_P(EmuMDTimingTest_NTSC, EmuMDTimingTest,
+	::testing::Values(TimingParams{SysVersion::REGION_US_NTSC, 488, 228, 262, 224}));
+INSTANTIATE_TEST_CASE_P(EmuMDTimingTest_PAL, EmuMDTimingTest,
+	::testing::Values(TimingParams{SysVersion::REGION_EU_PAL, 487, 227, 312, 224}));
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: EmuMD timing test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
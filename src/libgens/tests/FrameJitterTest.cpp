@@ -0,0 +1,154 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * FrameJitterTest.cpp: Frame-time jitter statistics tests.                *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "Util/FrameJitter.hpp"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+
+namespace LibGens { namespace Tests {
+
+class FrameJitterTest : public ::testing::Test
+{
+	protected:
+		FrameJitterTest()
+			: ::testing::Test() { }
+		virtual ~FrameJitterTest() { }
+
+		virtual void SetUp(void)
+		{
+			jitter.setTargetInterval(TARGET);
+		}
+
+	public:
+		static const unsigned int TARGET = 16667;
+		FrameJitter jitter;
+		FrameJitter::Stats stats;
+};
+
+const unsigned int FrameJitterTest::TARGET;
+
+/**
+ * No frames, or only the base frame.
+ */
+TEST_F(FrameJitterTest, empty)
+{
+	jitter.getStats(&stats);
+	EXPECT_EQ(0u, stats.intervals);
+	EXPECT_EQ(TARGET, stats.target);
+	EXPECT_EQ(0u, stats.p99);
+
+	jitter.addFrame(1000);
+	jitter.getStats(&stats);
+	EXPECT_EQ(0u, stats.intervals);
+}
+
+/**
+ * Perfectly-paced frames have no jitter.
+ */
+TEST_F(FrameJitterTest, steady)
+{
+	for (unsigned int i = 0; i <= 600; i++) {
+		jitter.addFrame(5000 + ((uint64_t)i * TARGET));
+	}
+
+	jitter.getStats(&stats);
+	EXPECT_EQ(600u, stats.intervals);
+	EXPECT_DOUBLE_EQ((double)TARGET, stats.mean);
+	EXPECT_DOUBLE_EQ(0.0, stats.stddev);
+	EXPECT_DOUBLE_EQ(0.0, stats.meanAbsDev);
+	EXPECT_EQ(TARGET, stats.min);
+	EXPECT_EQ(TARGET, stats.max);
+	EXPECT_EQ(TARGET, stats.p50);
+	EXPECT_EQ(TARGET, stats.p99);
+	EXPECT_EQ(0u, stats.late);
+}
+
+/**
+ * Occasional long frames show up in p99, max, and late.
+ */
+TEST_F(FrameJitterTest, hiccups)
+{
+	uint64_t t = 0;
+	jitter.addFrame(t);
+	for (unsigned int i = 0; i < 1000; i++) {
+		// Every 50th frame takes 3x as long.
+		t += ((i % 50) == 49 ? (TARGET * 3) : TARGET);
+		jitter.addFrame(t);
+	}
+
+	jitter.getStats(&stats);
+	EXPECT_EQ(1000u, stats.intervals);
+	EXPECT_EQ(20u, stats.late);
+	EXPECT_EQ(TARGET, stats.min);
+	EXPECT_EQ((uint64_t)TARGET * 3, stats.max);
+	EXPECT_NEAR((double)TARGET, (double)stats.p50, FrameJitter::BUCKET_USEC);
+	EXPECT_NEAR((double)(TARGET * 3), (double)stats.p99, FrameJitter::BUCKET_USEC);
+	EXPECT_NEAR(TARGET * 1.04, stats.mean, 1.0);
+	EXPECT_GT(stats.stddev, 0.0);
+	EXPECT_NEAR(TARGET * 2 * 0.02, stats.meanAbsDev, 1.0);
+}
+
+/**
+ * skipFrame() and reset() drop the interval to the next frame.
+ */
+TEST_F(FrameJitterTest, skipAndReset)
+{
+	jitter.addFrame(0);
+	jitter.addFrame(TARGET);
+	jitter.skipFrame();
+	jitter.addFrame(10000000);
+	jitter.addFrame(10000000 + TARGET);
+
+	jitter.getStats(&stats);
+	EXPECT_EQ(2u, stats.intervals);
+	EXPECT_EQ(TARGET, stats.max);
+
+	// A clock going backwards is treated like skipFrame().
+	jitter.addFrame(0);
+	jitter.getStats(&stats);
+	EXPECT_EQ(2u, stats.intervals);
+
+	jitter.reset();
+	jitter.getStats(&stats);
+	EXPECT_EQ(0u, stats.intervals);
+	EXPECT_EQ(TARGET, stats.target);
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: FrameJitter tests.\n\n");
+	fflush(nullptr);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
@@ -0,0 +1,264 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * HashLogTest.cpp: Video/audio hash log test.                             *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "lg_main.hpp"
+#include "Util/MdFb.hpp"
+#include "Util/XXHash64.hpp"
+#include "Util/HashLog.hpp"
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+
+namespace LibGens { namespace Tests {
+
+class HashLogTest : public ::testing::Test
+{
+	protected:
+		HashLogTest()
+			: ::testing::Test() { }
+		virtual ~HashLogTest() { }
+
+		virtual void TearDown(void);
+
+	public:
+		static const char LOG_FILENAME[];
+		static const char GOLDEN_FILENAME[];
+
+		/**
+		 * Write a hash log with synthetic hashes.
+		 * @param filename Log filename.
+		 * @param frames Number of frames.
+		 * @param bpp Color depth.
+		 * @param badFrame Frame to corrupt, or -1 for none.
+		 * @param badMask Subsystems to corrupt. (HashLog::Subsystem)
+		 */
+		static void writeLog(const char *filename, int frames, MdFb::ColorDepth bpp,
+				     int badFrame = -1, uint32_t badMask = 0);
+};
+
+const char HashLogTest::LOG_FILENAME[] = "HashLogTest.log";
+const char HashLogTest::GOLDEN_FILENAME[] = "HashLogTest.golden";
+
+void HashLogTest::TearDown(void)
+{
+	remove(LOG_FILENAME);
+	remove(GOLDEN_FILENAME);
+}
+
+/**
+ * Write a hash log with synthetic hashes.
+ * @param filename Log filename.
+ * @param frames Number of frames.
+ * @param bpp Color depth.
+ * @param badFrame Frame to corrupt, or -1 for none.
+ * @param badMask Subsystems to corrupt. (HashLog::Subsystem)
+ */
+void HashLogTest::writeLog(const char *filename, int frames, MdFb::ColorDepth bpp,
+			   int badFrame, uint32_t badMask)
+{
+	HashLog log;
+	ASSERT_EQ(0, log.create(filename, bpp));
+	for (int i = 0; i < frames; i++) {
+		uint64_t video = XXHash64::hash(&i, sizeof(i), 1);
+		uint64_t audio = XXHash64::hash(&i, sizeof(i), 2);
+		if (i == badFrame) {
+			if (badMask & HashLog::SUB_VIDEO)
+				video ^= 1;
+			if (badMask & HashLog::SUB_AUDIO)
+				audio ^= 1;
+		}
+		ASSERT_EQ(0, log.append(video, audio));
+	}
+	EXPECT_EQ((uint32_t)frames, log.frameCount());
+	EXPECT_EQ(0, log.close());
+	EXPECT_FALSE(log.isOpen());
+}
+
+/**
+ * xxHash64 must match the reference implementation,
+ * regardless of how the input is split up.
+ */
+TEST_F(HashLogTest, xxHash64)
+{
+	EXPECT_EQ(0xEF46DB3751D8E999ULL, XXHash64::hash("", 0));
+	EXPECT_EQ(0xD24EC4F1A98C6E5BULL, XXHash64::hash("a", 1));
+	EXPECT_EQ(0x44BC2CF5AD770999ULL, XXHash64::hash("abc", 3));
+
+	uint8_t data[1000];
+	for (int i = 0; i < (int)sizeof(data); i++) {
+		data[i] = (uint8_t)(i * 7 + 3);
+	}
+	EXPECT_EQ(0x5F235FA033F1A3FBULL, XXHash64::hash(data, sizeof(data)));
+	EXPECT_EQ(0x442ACD0A822E86F6ULL, XXHash64::hash(data, sizeof(data), 0x9E3779B97F4A7C15ULL));
+
+	// Streaming, with chunk sizes that straddle stripe boundaries.
+	static const size_t chunks[] = {1, 3, 7, 31, 32, 33, 64, 100};
+	for (size_t c = 0; c < sizeof(chunks)/sizeof(chunks[0]); c++) {
+		XXHash64 hash;
+		for (size_t pos = 0; pos < sizeof(data); pos += chunks[c]) {
+			size_t len = sizeof(data) - pos;
+			if (len > chunks[c])
+				len = chunks[c];
+			hash.update(&data[pos], len);
+		}
+		EXPECT_EQ(0x5F235FA033F1A3FBULL, hash.digest()) << "chunk size " << chunks[c];
+	}
+}
+
+/**
+ * Only the visible area of the framebuffer is hashed.
+ */
+TEST_F(HashLogTest, hashFbVisibleArea)
+{
+	MdFb *fb = new MdFb();
+	fb->setBpp(MdFb::BPP_32);
+	fb->setImgWidth(256);
+	fb->setImgHeight(224);
+	fb->setImgXStart(32);
+	fb->setImgYStart(8);
+	const uint64_t orig = HashLog::HashFb(fb);
+
+	// Outside of the visible area.
+	fb->lineBuf32(0)[100] = 0x123456;
+	fb->lineBuf32(100)[0] = 0x123456;
+	fb->lineBuf32(100)[300] = 0x123456;
+	fb->lineBuf32(239)[100] = 0x123456;
+	EXPECT_EQ(orig, HashLog::HashFb(fb));
+
+	// Inside of the visible area.
+	fb->lineBuf32(100)[100] = 0x123456;
+	EXPECT_NE(orig, HashLog::HashFb(fb));
+	fb->lineBuf32(100)[100] = 0;
+	EXPECT_EQ(orig, HashLog::HashFb(fb));
+
+	// Color depth is part of the hash.
+	fb->setBpp(MdFb::BPP_16);
+	const uint64_t orig16 = HashLog::HashFb(fb);
+	EXPECT_NE(orig, orig16);
+	fb->setBpp(MdFb::BPP_15);
+	EXPECT_NE(orig16, HashLog::HashFb(fb));
+
+	// 16-bit visible area.
+	fb->setBpp(MdFb::BPP_16);
+	fb->lineBuf16(100)[300] = 0x1234;
+	EXPECT_EQ(orig16, HashLog::HashFb(fb));
+	fb->lineBuf16(100)[100] = 0x1234;
+	EXPECT_NE(orig16, HashLog::HashFb(fb));
+
+	fb->unref();
+}
+
+/**
+ * Identical logs must compare equal.
+ */
+TEST_F(HashLogTest, compareIdentical)
+{
+	ASSERT_NO_FATAL_FAILURE(writeLog(LOG_FILENAME, 10000, MdFb::BPP_32));
+	ASSERT_NO_FATAL_FAILURE(writeLog(GOLDEN_FILENAME, 10000, MdFb::BPP_32));
+
+	HashLog::Divergence div;
+	EXPECT_EQ(0, HashLog::Compare(LOG_FILENAME, GOLDEN_FILENAME, &div));
+	EXPECT_EQ(0U, div.frame);
+	EXPECT_EQ(0U, div.subsystems);
+	EXPECT_EQ(0, HashLog::Compare(LOG_FILENAME, GOLDEN_FILENAME, nullptr));
+}
+
+/**
+ * The first divergent frame and subsystem must be reported.
+ */
+TEST_F(HashLogTest, compareDivergence)
+{
+	ASSERT_NO_FATAL_FAILURE(writeLog(GOLDEN_FILENAME, 10000, MdFb::BPP_32));
+	HashLog::Divergence div;
+
+	ASSERT_NO_FATAL_FAILURE(writeLog(LOG_FILENAME, 10000, MdFb::BPP_32, 4321, HashLog::SUB_VIDEO));
+	EXPECT_EQ(1, HashLog::Compare(LOG_FILENAME, GOLDEN_FILENAME, &div));
+	EXPECT_EQ(4321U, div.frame);
+	EXPECT_EQ((uint32_t)HashLog::SUB_VIDEO, div.subsystems);
+	EXPECT_EQ(div.video[0] ^ 1, div.video[1]);
+	EXPECT_EQ(div.audio[0], div.audio[1]);
+	EXPECT_STREQ("video", HashLog::SubsystemName(div.subsystems));
+
+	ASSERT_NO_FATAL_FAILURE(writeLog(LOG_FILENAME, 10000, MdFb::BPP_32, 0,
+		HashLog::SUB_VIDEO | HashLog::SUB_AUDIO));
+	EXPECT_EQ(1, HashLog::Compare(LOG_FILENAME, GOLDEN_FILENAME, &div));
+	EXPECT_EQ(0U, div.frame);
+	EXPECT_STREQ("video+audio", HashLog::SubsystemName(div.subsystems));
+
+	ASSERT_NO_FATAL_FAILURE(writeLog(LOG_FILENAME, 9999, MdFb::BPP_32, 9998, HashLog::SUB_AUDIO));
+	EXPECT_EQ(1, HashLog::Compare(LOG_FILENAME, GOLDEN_FILENAME, &div));
+	EXPECT_EQ(9998U, div.frame);
+	EXPECT_EQ((uint32_t)HashLog::SUB_AUDIO, div.subsystems);
+
+	// Shorter log with no other differences.
+	ASSERT_NO_FATAL_FAILURE(writeLog(LOG_FILENAME, 5000, MdFb::BPP_32));
+	EXPECT_EQ(1, HashLog::Compare(LOG_FILENAME, GOLDEN_FILENAME, &div));
+	EXPECT_EQ(5000U, div.frame);
+	EXPECT_EQ((uint32_t)HashLog::SUB_LENGTH, div.subsystems);
+
+	// Different color depth.
+	ASSERT_NO_FATAL_FAILURE(writeLog(LOG_FILENAME, 10000, MdFb::BPP_16));
+	EXPECT_EQ(1, HashLog::Compare(LOG_FILENAME, GOLDEN_FILENAME, &div));
+	EXPECT_EQ((uint32_t)HashLog::SUB_FORMAT, div.subsystems);
+}
+
+/**
+ * Invalid logs must be rejected.
+ */
+TEST_F(HashLogTest, invalidLog)
+{
+	ASSERT_NO_FATAL_FAILURE(writeLog(GOLDEN_FILENAME, 10, MdFb::BPP_32));
+
+	remove(LOG_FILENAME);
+	EXPECT_EQ(-ENOENT, HashLog::Compare(LOG_FILENAME, GOLDEN_FILENAME, nullptr));
+
+	FILE *f = fopen(LOG_FILENAME, "wb");
+	ASSERT_TRUE(f != nullptr);
+	fputs("This is not a hash log.", f);
+	fclose(f);
+	EXPECT_EQ(-EBADMSG, HashLog::Compare(LOG_FILENAME, GOLDEN_FILENAME, nullptr));
+
+	HashLog log;
+	EXPECT_EQ(-EBADF, log.append(0, 0));
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: HashLog test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
@@ -0,0 +1,364 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * IdleLoopTest.cpp: CPU idle loop detection test.                         *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "lg_main.hpp"
+#include "Rom.hpp"
+#include "EmuContext/EmuMD.hpp"
+#include "cpu/M68K.hpp"
+#include "cpu/M68K_Mem.hpp"
+#include "cpu/Z80.hpp"
+#include "cpu/Z80_MD_Mem.hpp"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstring>
+
+// C++ includes.
+#include <vector>
+using std::vector;
+
+namespace LibGens { namespace Tests {
+
+class IdleLoopTest : public ::testing::Test
+{
+	protected:
+		IdleLoopTest()
+			: ::testing::Test() { }
+		virtual ~IdleLoopTest() { }
+
+		virtual void SetUp(void) override;
+		virtual void TearDown(void) override;
+
+		// ROM size. (128 KB)
+		static const unsigned int ROM_SIZE = 128*1024;
+
+		// Number of frames to run.
+		static const int FRAMES = 120;
+
+		/**
+		 * CPU state after a frame.
+		 */
+		struct State {
+			Zomg_M68KRegSave_t m68k;
+			unsigned int m68k_odo;
+			uint16_t m68k_ram[8];
+			Zomg_Z80RegSave_t z80;
+			unsigned int z80_odo;
+			uint8_t z80_ram[8192];
+
+			bool operator==(const State &o) const
+			{
+				return (!memcmp(&m68k, &o.m68k, sizeof(m68k)) &&
+					m68k_odo == o.m68k_odo &&
+					!memcmp(m68k_ram, o.m68k_ram, sizeof(m68k_ram)) &&
+					!memcmp(&z80, &o.z80, sizeof(z80)) &&
+					z80_odo == o.z80_odo &&
+					!memcmp(z80_ram, o.z80_ram, sizeof(z80_ram)));
+			}
+		};
+
+		/**
+		 * Run a Z80 program.
+		 * @param idleLoopSkip If true, enable idle loop skipping.
+		 * @param program Z80 program.
+		 * @param size Size of the Z80 program.
+		 * @param states [out] CPU state after each frame.
+		 */
+		void run(bool idleLoopSkip, const uint8_t *program, size_t size, vector<State> *states);
+
+		/**
+		 * Load an M68K program into the test ROM.
+		 * The program starts at 0x200. The VINT handler,
+		 * if any, starts at 0x300.
+		 * @param program M68K program.
+		 * @param size Size of the M68K program.
+		 * @param vint VINT handler, or nullptr for none.
+		 * @param vint_size Size of the VINT handler.
+		 */
+		void loadM68K(const uint8_t *program, size_t size,
+			      const uint8_t *vint, size_t vint_size);
+
+		uint8_t m_rom_data[ROM_SIZE];
+};
+
+/**
+ * Create the test ROM.
+ * The M68K disables interrupts and loops forever.
+ */
+void IdleLoopTest::SetUp(void)
+{
+	memset(m_rom_data, 0xFF, sizeof(m_rom_data));
+
+	// Minimal ROM header.
+	memset(&m_rom_data[0x100], ' ', 0x100);
+	memcpy(&m_rom_data[0x100], "SEGA MEGA DRIVE ", 16);
+
+	// Vectors: SP == 0xFFFE00, PC == 0x200
+	static const uint8_t vectors[8] = {0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0x02, 0x00};
+	memcpy(m_rom_data, vectors, sizeof(vectors));
+
+	static const uint8_t code[] = {
+		0x46, 0xFC, 0x27, 0x00,	// move.w #$2700, sr
+		0x60, 0xFE,		// bra.s *
+	};
+	memcpy(&m_rom_data[0x200], code, sizeof(code));
+}
+
+/**
+ * Restore the default idle loop skipping settings.
+ */
+void IdleLoopTest::TearDown(void)
+{
+	EmuContext::SetIdleLoopSkip(true);
+	EmuContext::SetM68KIdleLoopSkip(false);
+}
+
+/**
+ * Load an M68K program into the test ROM.
+ * The program starts at 0x200. The VINT handler,
+ * if any, starts at 0x300.
+ * @param program M68K program.
+ * @param size Size of the M68K program.
+ * @param vint VINT handler, or nullptr for none.
+ * @param vint_size Size of the VINT handler.
+ */
+void IdleLoopTest::loadM68K(const uint8_t *program, size_t size,
+			    const uint8_t *vint, size_t vint_size)
+{
+	ASSERT_LE(size, 0x100U);
+	memcpy(&m_rom_data[0x200], program, size);
+	if (vint) {
+		// Level 6 autovector. (VINT)
+		static const uint8_t vint_vector[4] = {0x00, 0x00, 0x03, 0x00};
+		memcpy(&m_rom_data[0x78], vint_vector, sizeof(vint_vector));
+		memcpy(&m_rom_data[0x300], vint, vint_size);
+	}
+}
+
+/**
+ * Run a Z80 program.
+ * @param idleLoopSkip If true, enable idle loop skipping.
+ * @param program Z80 program.
+ * @param size Size of the Z80 program.
+ * @param states [out] CPU state after each frame.
+ */
+void IdleLoopTest::run(bool idleLoopSkip, const uint8_t *program, size_t size, vector<State> *states)
+{
+	EmuContext::SetIdleLoopSkip(idleLoopSkip);
+	EmuContext::SetM68KIdleLoopSkip(idleLoopSkip);
+	M68K::ClearIdleCycles();
+	Z80::ClearIdleCycles();
+
+	Rom *rom = new Rom(m_rom_data, ROM_SIZE);
+	EmuMD *context = new EmuMD(rom);
+	ASSERT_TRUE(context->isRomOpened());
+
+	// Load the Z80 program and give the Z80 the bus.
+	memcpy(Ram_Z80, program, size);
+	M68K_Mem::Z80_State = (Z80_STATE_ENABLED | Z80_STATE_BUSREQ);
+	Z80::HardReset();
+
+	states->resize(FRAMES);
+	for (int i = 0; i < FRAMES; i++) {
+		context->execFrameFast();
+
+		State &state = (*states)[i];
+		memset(&state, 0, sizeof(state));
+		M68K::ZomgSaveReg(&state.m68k);
+		state.m68k_odo = M68K::ReadOdometer();
+		memcpy(state.m68k_ram, Ram_68k.u16, sizeof(state.m68k_ram));
+		Z80::ZomgSaveReg(&state.z80);
+		state.z80_odo = Z80::ReadOdometer();
+		memcpy(state.z80_ram, Ram_Z80, sizeof(state.z80_ram));
+	}
+
+	delete context;
+	delete rom;
+}
+
+/**
+ * Z80 program that waits for a flag set by the VINT handler,
+ * then polls the YM2612 status register.
+ */
+static const uint8_t z80_vint_wait[] = {
+	0xF3,			// 0000: di
+	0x31, 0x00, 0x20,	// 0001: ld sp,2000h
+	0xED, 0x56,		// 0004: im 1
+	0xFB,			// 0006: ei
+	0x3A, 0x00, 0x10,	// 0007: ld a,(1000h)	; wait for VINT
+	0xB7,			// 000A: or a
+	0x28, 0xFA,		// 000B: jr z,0007h
+	0xAF,			// 000D: xor a
+	0x32, 0x00, 0x10,	// 000E: ld (1000h),a
+	0x2A, 0x02, 0x10,	// 0011: ld hl,(1002h)	; count frames
+	0x23,			// 0014: inc hl
+	0x22, 0x02, 0x10,	// 0015: ld (1002h),hl
+	0x3A, 0x00, 0x40,	// 0018: ld a,(4000h)	; wait for the YM2612
+	0x07,			// 001B: rlca
+	0x38, 0xFA,		// 001C: jr c,0018h
+	0x18, 0xE7,		// 001E: jr 0007h
+
+	// 0020: padding
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+	0xF5,			// 0038: push af	; VINT handler
+	0x3E, 0x01,		// 0039: ld a,1
+	0x32, 0x00, 0x10,	// 003B: ld (1000h),a
+	0xF1,			// 003E: pop af
+	0xFB,			// 003F: ei
+	0xED, 0x4D,		// 0040: reti
+};
+
+/**
+ * Z80 program with a loop that writes to memory.
+ * This must not be detected as an idle loop.
+ */
+static const uint8_t z80_busy_loop[] = {
+	0xF3,			// 0000: di
+	0x32, 0x00, 0x10,	// 0001: ld (1000h),a
+	0x3C,			// 0004: inc a
+	0x18, 0xFA,		// 0005: jr 0001h
+};
+
+/**
+ * Z80 program that halts.
+ */
+static const uint8_t z80_halt[] = {
+	0xF3,			// 0000: di
+	0x76,			// 0001: halt
+};
+
+/**
+ * M68K program that waits for a flag set by the VINT handler.
+ */
+static const uint8_t m68k_vint_wait[] = {
+	0x46, 0xFC, 0x27, 0x00,			// 0200: move.w #$2700, sr
+	0x33, 0xFC, 0x81, 0x64, 0x00, 0xC0,	// 0204: move.w #$8164, ($C00004).l
+	0x00, 0x04,				//       ; enable display and VINT
+	0x46, 0xFC, 0x20, 0x00,			// 020C: move.w #$2000, sr
+	0x4A, 0x39, 0x00, 0xFF, 0x00, 0x00,	// 0210: tst.b ($FF0000).l	; wait for VINT
+	0x67, 0xF8,				// 0216: beq.s $0210
+	0x42, 0x39, 0x00, 0xFF, 0x00, 0x00,	// 0218: clr.b ($FF0000).l
+	0x52, 0x79, 0x00, 0xFF, 0x00, 0x02,	// 021E: addq.w #1, ($FF0002).l	; count frames
+	0x60, 0xEA,				// 0224: bra.s $0210
+};
+
+/**
+ * M68K VINT handler for m68k_vint_wait.
+ */
+static const uint8_t m68k_vint_handler[] = {
+	0x13, 0xFC, 0x00, 0x01, 0x00, 0xFF,	// 0300: move.b #1, ($FF0000).l
+	0x00, 0x00,
+	0x4E, 0x73,				// 0308: rte
+};
+
+/**
+ * Idle loop skipping must not change the emulated result.
+ */
+TEST_F(IdleLoopTest, determinism)
+{
+	vector<State> plain, skip;
+	ASSERT_NO_FATAL_FAILURE(run(false, z80_vint_wait, sizeof(z80_vint_wait), &plain));
+	EXPECT_EQ(0U, Z80::IdleCycles());
+	EXPECT_EQ(0U, M68K::IdleCycles());
+
+	ASSERT_NO_FATAL_FAILURE(run(true, z80_vint_wait, sizeof(z80_vint_wait), &skip));
+	// The Z80 spends most of each frame waiting for VINT.
+	EXPECT_GT(Z80::IdleCycles(), (unsigned int)(FRAMES * 30000));
+
+	// The VINT handler must have run on every frame.
+	const unsigned int count = plain[FRAMES-1].z80_ram[0x1002] |
+				  (plain[FRAMES-1].z80_ram[0x1003] << 8);
+	EXPECT_GE(count, (unsigned int)(FRAMES - 1));
+
+	ASSERT_EQ(plain.size(), skip.size());
+	for (int i = 0; i < FRAMES; i++) {
+		EXPECT_TRUE(plain[i] == skip[i]) << "CPU state differs after frame " << i;
+	}
+}
+
+/**
+ * M68K idle loop skipping must not change the emulated result.
+ */
+TEST_F(IdleLoopTest, m68kDeterminism)
+{
+	ASSERT_NO_FATAL_FAILURE(loadM68K(m68k_vint_wait, sizeof(m68k_vint_wait),
+		m68k_vint_handler, sizeof(m68k_vint_handler)));
+
+	vector<State> plain, skip;
+	ASSERT_NO_FATAL_FAILURE(run(false, z80_halt, sizeof(z80_halt), &plain));
+	EXPECT_EQ(0U, M68K::IdleCycles());
+
+	ASSERT_NO_FATAL_FAILURE(run(true, z80_halt, sizeof(z80_halt), &skip));
+#ifdef GENS_ENABLE_EMULATION
+	// The M68K spends most of each frame waiting for VINT.
+	EXPECT_GT(M68K::IdleCycles(), (unsigned int)(FRAMES * 50000));
+
+	// The VINT handler must have run on every frame.
+	// NOTE: M68K RAM is stored as host-endian words.
+	EXPECT_GE((unsigned int)plain[FRAMES-1].m68k_ram[1], (unsigned int)(FRAMES - 1));
+#endif /* GENS_ENABLE_EMULATION */
+
+	ASSERT_EQ(plain.size(), skip.size());
+	for (int i = 0; i < FRAMES; i++) {
+		EXPECT_TRUE(plain[i] == skip[i]) << "CPU state differs after frame " << i;
+	}
+}
+
+/**
+ * Loops that write to memory must not be skipped.
+ */
+TEST_F(IdleLoopTest, busyLoop)
+{
+	vector<State> plain, skip;
+	ASSERT_NO_FATAL_FAILURE(run(false, z80_busy_loop, sizeof(z80_busy_loop), &plain));
+	ASSERT_NO_FATAL_FAILURE(run(true, z80_busy_loop, sizeof(z80_busy_loop), &skip));
+	EXPECT_EQ(0U, Z80::IdleCycles());
+
+	ASSERT_EQ(plain.size(), skip.size());
+	for (int i = 0; i < FRAMES; i++) {
+		EXPECT_TRUE(plain[i] == skip[i]) << "CPU state differs after frame " << i;
+	}
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: Idle loop test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
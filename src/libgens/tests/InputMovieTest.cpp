@@ -0,0 +1,302 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * InputMovieTest.cpp: Input movie recording and playback test.            *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "lg_main.hpp"
+#include "IO/IoManager.hpp"
+#include "IO/InputMovie.hpp"
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+
+// C++ includes.
+#include <vector>
+using std::vector;
+
+namespace LibGens { namespace Tests {
+
+class InputMovieTest : public ::testing::Test
+{
+	protected:
+		InputMovieTest()
+			: ::testing::Test() { }
+		virtual ~InputMovieTest() { }
+
+		virtual void SetUp(void);
+		virtual void TearDown(void);
+
+	public:
+		static const char MOVIE_FILENAME[];
+		static const char STATE_FILENAME[];
+
+		// Input state for one frame.
+		struct FrameState {
+			IoManager::IoType_t devType[IoManager::VIRTPORT_MAX];
+			uint32_t buttons[IoManager::VIRTPORT_MAX];
+			int x[IoManager::VIRTPORT_MAX];
+			int y[IoManager::VIRTPORT_MAX];
+		};
+
+		/**
+		 * Get the current input state of an I/O manager.
+		 * @param io I/O manager.
+		 * @param state [out] Input state.
+		 */
+		static void getState(const IoManager *io, FrameState *state);
+
+		/**
+		 * Write a fake start state.
+		 * @param val Byte to fill the file with.
+		 */
+		static void writeStartState(uint8_t val);
+
+		/**
+		 * Record a movie with varied input.
+		 * @param frames [out] Recorded input states.
+		 */
+		void recordMovie(vector<FrameState> *frames);
+};
+
+const char InputMovieTest::MOVIE_FILENAME[] = "InputMovieTest.gmv";
+const char InputMovieTest::STATE_FILENAME[] = "InputMovieTest.zomg";
+
+void InputMovieTest::SetUp(void)
+{
+	writeStartState(0x55);
+}
+
+void InputMovieTest::TearDown(void)
+{
+	remove(MOVIE_FILENAME);
+	remove(STATE_FILENAME);
+}
+
+/**
+ * Get the current input state of an I/O manager.
+ * @param io I/O manager.
+ * @param state [out] Input state.
+ */
+void InputMovieTest::getState(const IoManager *io, FrameState *state)
+{
+	for (int i = 0; i < IoManager::VIRTPORT_MAX; i++) {
+		state->devType[i] = io->devType((IoManager::VirtPort_t)i);
+		state->buttons[i] = io->buttons(i);
+		io->absolutePosition(i, &state->x[i], &state->y[i]);
+	}
+}
+
+/**
+ * Write a fake start state.
+ * @param val Byte to fill the file with.
+ */
+void InputMovieTest::writeStartState(uint8_t val)
+{
+	FILE *f = fopen(STATE_FILENAME, "wb");
+	ASSERT_TRUE(f != nullptr);
+	for (int i = 0; i < 1024; i++) {
+		fputc(val, f);
+	}
+	fclose(f);
+}
+
+/**
+ * Record a movie with varied input.
+ * @param frames [out] Recorded input states.
+ */
+void InputMovieTest::recordMovie(vector<FrameState> *frames)
+{
+	IoManager io;
+	io.setConstrainDPad(true);
+	io.setDevType(IoManager::VIRTPORT_1, IoManager::IOT_TEAMPLAYER);
+	io.setDevType(IoManager::VIRTPORT_TP1A, IoManager::IOT_6BTN);
+	io.setDevType(IoManager::VIRTPORT_TP1B, IoManager::IOT_3BTN);
+	io.setDevType(IoManager::VIRTPORT_TP1C, IoManager::IOT_MEGA_MOUSE);
+	io.setDevType(IoManager::VIRTPORT_2, IoManager::IOT_6BTN);
+
+	InputMovie movie;
+	ASSERT_EQ(0, movie.record(MOVIE_FILENAME, STATE_FILENAME, nullptr, &io));
+	EXPECT_EQ(InputMovie::MODE_RECORD, movie.mode());
+
+	// Simple LCG so the input is reproducible.
+	uint32_t seed = 12345;
+	uint32_t held[IoManager::VIRTPORT_MAX];
+	for (int i = 0; i < IoManager::VIRTPORT_MAX; i++) {
+		held[i] = ~0U;
+	}
+
+	for (int frame = 0; frame < 2000; frame++) {
+		if (frame == 500) {
+			// Connect another controller mid-movie.
+			io.setDevType(IoManager::VIRTPORT_TP1D, IoManager::IOT_3BTN);
+		}
+
+		// Change input every so often, and hold it in between.
+		// Frames 1000-1999 have no input changes at all.
+		seed = seed * 1103515245 + 12345;
+		if (frame < 1000 && (seed >> 28) < 3) {
+			const int port = (seed >> 8) % IoManager::VIRTPORT_MAX;
+			held[port] = ~((seed >> 12) & 0xFFF);
+		}
+
+		for (int i = 0; i < IoManager::VIRTPORT_MAX; i++) {
+			io.update(i, held[i]);
+		}
+		if (frame < 1000 && (frame % 16) == 0) {
+			io.updateAbsolutePosition(IoManager::VIRTPORT_2,
+				(seed >> 4) % 1280, (seed >> 16) % 240);
+		}
+
+		ASSERT_EQ(0, movie.frame());
+
+		FrameState state;
+		getState(&io, &state);
+		frames->push_back(state);
+	}
+
+	EXPECT_EQ(2000U, movie.curFrame());
+	EXPECT_EQ(0, movie.stop());
+	EXPECT_EQ(InputMovie::MODE_NONE, movie.mode());
+}
+
+/**
+ * Record a movie and play it back.
+ * Every frame must match exactly, including device types.
+ */
+TEST_F(InputMovieTest, recordPlayback)
+{
+	vector<FrameState> frames;
+	ASSERT_NO_FATAL_FAILURE(recordMovie(&frames));
+
+	// Idle frames must be run-length encoded.
+	FILE *f = fopen(MOVIE_FILENAME, "rb");
+	ASSERT_TRUE(f != nullptr);
+	fseek(f, 0, SEEK_END);
+	const long size = ftell(f);
+	fclose(f);
+	EXPECT_LT(size, 4096);
+
+	// Play it back into an I/O manager with different settings.
+	// D-Pad constraints must not affect playback.
+	IoManager io;
+	io.setConstrainDPad(false);
+	InputMovie movie;
+	ASSERT_EQ(0, movie.play(MOVIE_FILENAME, nullptr, &io));
+	EXPECT_EQ(InputMovie::MODE_PLAYBACK, movie.mode());
+	EXPECT_EQ(2000U, movie.frameCount());
+
+	for (size_t frame = 0; frame < frames.size(); frame++) {
+		// Simulate the frontend's own input, which must be overridden.
+		io.update(IoManager::VIRTPORT_2, 0);
+
+		ASSERT_EQ(0, movie.frame()) << "frame " << frame;
+		FrameState state;
+		getState(&io, &state);
+		const FrameState &expected = frames[frame];
+		for (int i = 0; i < IoManager::VIRTPORT_MAX; i++) {
+			ASSERT_EQ(expected.devType[i], state.devType[i]) << "frame " << frame << ", port " << i;
+			ASSERT_EQ(expected.buttons[i], state.buttons[i]) << "frame " << frame << ", port " << i;
+			ASSERT_EQ(expected.x[i], state.x[i]) << "frame " << frame << ", port " << i;
+			ASSERT_EQ(expected.y[i], state.y[i]) << "frame " << frame << ", port " << i;
+		}
+	}
+
+	// End of movie.
+	EXPECT_EQ(1, movie.frame());
+	EXPECT_EQ(InputMovie::MODE_NONE, movie.mode());
+}
+
+/**
+ * Playback must be refused if the start state doesn't match.
+ */
+TEST_F(InputMovieTest, startStateMismatch)
+{
+	vector<FrameState> frames;
+	ASSERT_NO_FATAL_FAILURE(recordMovie(&frames));
+
+	writeStartState(0xAA);
+	IoManager io;
+	InputMovie movie;
+	EXPECT_EQ(-EBADMSG, movie.play(MOVIE_FILENAME, nullptr, &io));
+	EXPECT_EQ(InputMovie::MODE_NONE, movie.mode());
+
+	remove(STATE_FILENAME);
+	EXPECT_EQ(-ENOENT, movie.play(MOVIE_FILENAME, nullptr, &io));
+}
+
+/**
+ * Truncated movies play back up to the truncation point.
+ */
+TEST_F(InputMovieTest, truncated)
+{
+	vector<FrameState> frames;
+	ASSERT_NO_FATAL_FAILURE(recordMovie(&frames));
+
+	// Remove the trailing idle run and end record.
+	FILE *f = fopen(MOVIE_FILENAME, "rb");
+	ASSERT_TRUE(f != nullptr);
+	vector<uint8_t> data;
+	int c;
+	while ((c = fgetc(f)) != EOF) {
+		data.push_back((uint8_t)c);
+	}
+	fclose(f);
+	ASSERT_GT(data.size(), 8U);
+	data.resize(data.size() - 4);
+	f = fopen(MOVIE_FILENAME, "wb");
+	ASSERT_TRUE(f != nullptr);
+	fwrite(&data[0], 1, data.size(), f);
+	fclose(f);
+
+	IoManager io;
+	InputMovie movie;
+	ASSERT_EQ(0, movie.play(MOVIE_FILENAME, nullptr, &io));
+	unsigned int played = 0;
+	int ret;
+	while ((ret = movie.frame()) == 0) {
+		played++;
+		ASSERT_LE(played, frames.size());
+	}
+	EXPECT_EQ(1, ret);
+	EXPECT_GE(played, 900U);
+	EXPECT_LT(played, frames.size());
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: InputMovie test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
@@ -0,0 +1,207 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * IoThTimeoutTest.cpp: I/O TH timeout test.                               *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "lg_main.hpp"
+#include "IO/IoManager.hpp"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+
+namespace LibGens { namespace Tests {
+
+class IoThTimeoutTest : public ::testing::Test
+{
+	protected:
+		IoThTimeoutTest()
+			: ::testing::Test()
+			, m_io(nullptr)
+			, m_starts(0)
+			, m_stops(0)
+			, m_lastPort(-1) { }
+		virtual ~IoThTimeoutTest() { }
+
+		virtual void SetUp(void) override;
+		virtual void TearDown(void) override;
+
+	protected:
+		IoManager *m_io;
+
+		/**
+		 * Select the fourth 6BTN cycle on port 1.
+		 * Three TH rising edges are sent, leaving TH=1.
+		 */
+		void selectFourthCycle(void);
+
+		/**
+		 * Read the D-pad/button bits from port 1 with TH=1.
+		 * @return Port 1 data. (bits 0-5)
+		 */
+		uint8_t readPort1(void) const
+		{
+			return (m_io->readDataMD(IoManager::PHYSPORT_1) & 0x3F);
+		}
+
+		// TH timeout function.
+		int m_starts;
+		int m_stops;
+		int m_lastPort;
+		static void thTimeoutFn(void *param, int physPort, bool start);
+};
+
+/**
+ * Set up the I/O manager for testing.
+ * Port 1 has a 6BTN controller with UP pressed.
+ */
+void IoThTimeoutTest::SetUp(void)
+{
+	m_io = new IoManager();
+	m_io->setDevType(IoManager::VIRTPORT_1, IoManager::IOT_6BTN);
+	m_io->writeCtrlMD(IoManager::PHYSPORT_1, 0x40);
+	m_io->writeDataMD(IoManager::PHYSPORT_1, 0x40);
+	// Buttons are active-low. Bit 0 is UP.
+	m_io->update(IoManager::VIRTPORT_1, ~1U);
+}
+
+void IoThTimeoutTest::TearDown(void)
+{
+	delete m_io;
+	m_io = nullptr;
+}
+
+void IoThTimeoutTest::selectFourthCycle(void)
+{
+	for (int i = 0; i < 3; i++) {
+		m_io->writeDataMD(IoManager::PHYSPORT_1, 0x00);
+		m_io->writeDataMD(IoManager::PHYSPORT_1, 0x40);
+	}
+}
+
+/**
+ * TH timeout function.
+ * @param param IoThTimeoutTest.
+ * @param physPort Physical port number.
+ * @param start True to start the timeout; false to stop it.
+ */
+void IoThTimeoutTest::thTimeoutFn(void *param, int physPort, bool start)
+{
+	IoThTimeoutTest *const test = static_cast<IoThTimeoutTest*>(param);
+	if (start) {
+		test->m_starts++;
+	} else {
+		test->m_stops++;
+	}
+	test->m_lastPort = physPort;
+}
+
+/**
+ * Without a TH timeout function, the 6BTN counter
+ * should be reset 25 scanlines after the last TH edge.
+ */
+TEST_F(IoThTimeoutTest, doScanline)
+{
+	selectFourthCycle();
+	// Fourth cycle: D1CBMXYZ. UP isn't visible.
+	EXPECT_EQ(0x3F, readPort1());
+
+	for (int i = 0; i < IoManager::TH_TIMEOUT_LINES - 1; i++) {
+		m_io->doScanline();
+	}
+	EXPECT_EQ(0x3F, readPort1());
+
+	// Timeout expired. First cycle: D1CBRLDU.
+	m_io->doScanline();
+	EXPECT_EQ(0x3E, readPort1());
+
+	// The timeout should only fire once.
+	selectFourthCycle();
+	m_io->writeDataMD(IoManager::PHYSPORT_1, 0x00);
+	m_io->writeDataMD(IoManager::PHYSPORT_1, 0x40);
+	EXPECT_EQ(0x3E, readPort1());
+}
+
+/**
+ * A TH rising edge should restart the timeout.
+ */
+TEST_F(IoThTimeoutTest, restart)
+{
+	m_io->writeDataMD(IoManager::PHYSPORT_1, 0x00);
+	m_io->writeDataMD(IoManager::PHYSPORT_1, 0x40);
+	for (int i = 0; i < IoManager::TH_TIMEOUT_LINES - 1; i++) {
+		m_io->doScanline();
+	}
+
+	// Two more edges, just before the timeout.
+	m_io->writeDataMD(IoManager::PHYSPORT_1, 0x00);
+	m_io->writeDataMD(IoManager::PHYSPORT_1, 0x40);
+	m_io->writeDataMD(IoManager::PHYSPORT_1, 0x00);
+	m_io->writeDataMD(IoManager::PHYSPORT_1, 0x40);
+	m_io->doScanline();
+	EXPECT_EQ(0x3F, readPort1());
+}
+
+/**
+ * With a TH timeout function, doScanline() does nothing
+ * and the caller reports the expired timeout.
+ */
+TEST_F(IoThTimeoutTest, thTimeoutFn)
+{
+	m_io->setThTimeoutFn(thTimeoutFn, this);
+	selectFourthCycle();
+	EXPECT_EQ(3, m_starts);
+	EXPECT_EQ(0, m_stops);
+	EXPECT_EQ(IoManager::PHYSPORT_1, m_lastPort);
+
+	// Writes without a TH edge don't touch the timeout.
+	m_io->writeDataMD(IoManager::PHYSPORT_1, 0x40);
+	m_io->writeCtrlMD(IoManager::PHYSPORT_1, 0x40);
+	EXPECT_EQ(3, m_starts);
+
+	for (int i = 0; i < IoManager::TH_TIMEOUT_LINES * 2; i++) {
+		m_io->doScanline();
+	}
+	EXPECT_EQ(0x3F, readPort1());
+
+	m_io->thTimeout(IoManager::PHYSPORT_1);
+	EXPECT_EQ(0x3E, readPort1());
+	m_io->setThTimeoutFn(nullptr, nullptr);
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: I/O TH timeout test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
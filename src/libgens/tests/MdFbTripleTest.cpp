@@ -0,0 +1,233 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * MdFbTripleTest.cpp: Triple-buffered MdFb set test.                      *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "lg_main.hpp"
+#include "Util/MdFb.hpp"
+#include "Util/MdFbTriple.hpp"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+
+// C++ includes.
+#include <thread>
+
+namespace LibGens { namespace Tests {
+
+class MdFbTripleTest : public ::testing::Test
+{
+	protected:
+		MdFbTripleTest()
+			: ::testing::Test() { }
+		virtual ~MdFbTripleTest() { }
+
+	public:
+		/**
+		 * Fill a framebuffer with a single value.
+		 * @param fb Framebuffer.
+		 * @param val Value.
+		 */
+		static void fill(MdFb *fb, uint32_t val);
+
+		/**
+		 * Check if a framebuffer is filled with a single value.
+		 * @param fb Framebuffer.
+		 * @param val [out] Value.
+		 * @return True if all pixels have the same value; false if not.
+		 */
+		static bool isUniform(const MdFb *fb, uint32_t *val);
+
+		/**
+		 * Producer thread function.
+		 * Publishes frames 1 through count.
+		 * @param triple MdFbTriple.
+		 * @param count Number of frames.
+		 */
+		static void producer(MdFbTriple *triple, unsigned int count);
+};
+
+/**
+ * Fill a framebuffer with a single value.
+ * @param fb Framebuffer.
+ * @param val Value.
+ */
+void MdFbTripleTest::fill(MdFb *fb, uint32_t val)
+{
+	for (int y = 0; y < fb->numLines(); y++) {
+		uint32_t *line = fb->lineBuf32(y);
+		for (int x = 0; x < fb->pxPerLine(); x++) {
+			line[x] = val;
+		}
+	}
+}
+
+/**
+ * Check if a framebuffer is filled with a single value.
+ * @param fb Framebuffer.
+ * @param val [out] Value.
+ * @return True if all pixels have the same value; false if not.
+ */
+bool MdFbTripleTest::isUniform(const MdFb *fb, uint32_t *val)
+{
+	*val = fb->lineBuf32(0)[0];
+	for (int y = 0; y < fb->numLines(); y++) {
+		const uint32_t *line = fb->lineBuf32(y);
+		for (int x = 0; x < fb->pxPerLine(); x++) {
+			if (line[x] != *val)
+				return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Producer thread function.
+ * Publishes frames 1 through count.
+ * @param triple MdFbTriple.
+ * @param count Number of frames.
+ */
+void MdFbTripleTest::producer(MdFbTriple *triple, unsigned int count)
+{
+	for (unsigned int i = 1; i <= count; i++) {
+		fill(triple->backFb(), i);
+		triple->publish();
+	}
+}
+
+/**
+ * Single-threaded publish/acquire ordering.
+ */
+TEST_F(MdFbTripleTest, publishAcquire)
+{
+	MdFbTriple triple;
+	uint32_t val;
+
+	// Nothing has been published yet.
+	EXPECT_FALSE(triple.acquire());
+
+	fill(triple.backFb(), 1);
+	triple.publish();
+	ASSERT_TRUE(triple.acquire());
+	ASSERT_TRUE(isUniform(triple.frontFb(), &val));
+	EXPECT_EQ(1U, val);
+
+	// The same frame can't be acquired twice.
+	EXPECT_FALSE(triple.acquire());
+	EXPECT_EQ(0U, triple.droppedFrames());
+
+	// Publish two frames before acquiring.
+	// Only the most recent one should be seen.
+	fill(triple.backFb(), 2);
+	triple.publish();
+	fill(triple.backFb(), 3);
+	triple.publish();
+	EXPECT_EQ(1U, triple.droppedFrames());
+	ASSERT_TRUE(triple.acquire());
+	ASSERT_TRUE(isUniform(triple.frontFb(), &val));
+	EXPECT_EQ(3U, val);
+
+	// The front buffer must not be handed back to the producer.
+	fill(triple.backFb(), 4);
+	ASSERT_TRUE(isUniform(triple.frontFb(), &val));
+	EXPECT_EQ(3U, val);
+}
+
+/**
+ * publish(src) copies the image parameters along with the image.
+ */
+TEST_F(MdFbTripleTest, publishCopy)
+{
+	MdFbTriple triple;
+	MdFb *src = new MdFb();
+	fill(src, 0x12345678);
+	src->setBpp(MdFb::BPP_16);
+	src->setImgWidth(256);
+	src->setImgXStart(32);
+
+	triple.publish(src);
+	ASSERT_TRUE(triple.acquire());
+	const MdFb *front = triple.frontFb();
+	EXPECT_EQ(MdFb::BPP_16, front->bpp());
+	EXPECT_EQ(256, front->imgWidth());
+	EXPECT_EQ(32, front->imgXStart());
+	uint32_t val;
+	ASSERT_TRUE(isUniform(front, &val));
+	EXPECT_EQ(0x12345678U, val);
+	src->unref();
+}
+
+/**
+ * Producer and consumer on separate threads.
+ * The consumer must never see a torn frame, and
+ * frame numbers must never go backwards.
+ */
+TEST_F(MdFbTripleTest, threaded)
+{
+	static const unsigned int FRAME_COUNT = 2000;
+	MdFbTriple triple;
+	std::thread thr(producer, &triple, FRAME_COUNT);
+
+	uint32_t last = 0;
+	unsigned int seen = 0;
+	while (last < FRAME_COUNT) {
+		if (!triple.acquire()) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		uint32_t val;
+		if (!isUniform(triple.frontFb(), &val)) {
+			ADD_FAILURE() << "Torn frame after frame " << last;
+			break;
+		}
+		if (val <= last) {
+			ADD_FAILURE() << "Frame " << val << " acquired after frame " << last;
+			break;
+		}
+		last = val;
+		seen++;
+	}
+	thr.join();
+
+	EXPECT_EQ(FRAME_COUNT, last);
+	EXPECT_EQ(FRAME_COUNT, seen + triple.droppedFrames());
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: MdFbTriple test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
@@ -0,0 +1,177 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * MpscQueueTest.cpp: Lock-free MPSC queue test.                           *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "Util/MpscQueue.hpp"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+
+// C++ includes.
+#include <thread>
+#include <vector>
+using std::vector;
+
+namespace LibGens { namespace Tests {
+
+class MpscQueueTest : public ::testing::Test
+{
+	protected:
+		MpscQueueTest()
+			: ::testing::Test() { }
+		virtual ~MpscQueueTest() { }
+
+	public:
+		// Item: producer ID in the high 8 bits, sequence number in the rest.
+		typedef MpscQueue<uint32_t, 64> Queue;
+
+		/**
+		 * Producer thread function.
+		 * @param q Queue.
+		 * @param id Producer ID.
+		 * @param count Number of items to push.
+		 */
+		static void producer(Queue *q, uint32_t id, uint32_t count);
+};
+
+/**
+ * Producer thread function.
+ * @param q Queue.
+ * @param id Producer ID.
+ * @param count Number of items to push.
+ */
+void MpscQueueTest::producer(Queue *q, uint32_t id, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		const uint32_t item = (id << 24) | i;
+		while (!q->push(item)) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+/**
+ * Single-threaded FIFO order and full/empty detection.
+ */
+TEST_F(MpscQueueTest, fifo)
+{
+	Queue q;
+	uint32_t item;
+
+	EXPECT_FALSE(q.pop(&item));
+
+	// Fill the queue.
+	for (uint32_t i = 0; i < Queue::capacity(); i++) {
+		ASSERT_TRUE(q.push(i));
+	}
+	EXPECT_FALSE(q.push(12345));
+
+	// Drain half, then wrap around.
+	for (uint32_t i = 0; i < Queue::capacity() / 2; i++) {
+		ASSERT_TRUE(q.pop(&item));
+		EXPECT_EQ(i, item);
+	}
+	for (uint32_t i = 0; i < Queue::capacity() / 2; i++) {
+		ASSERT_TRUE(q.push(1000 + i));
+	}
+	EXPECT_FALSE(q.push(12345));
+
+	for (uint32_t i = Queue::capacity() / 2; i < Queue::capacity(); i++) {
+		ASSERT_TRUE(q.pop(&item));
+		EXPECT_EQ(i, item);
+	}
+	for (uint32_t i = 0; i < Queue::capacity() / 2; i++) {
+		ASSERT_TRUE(q.pop(&item));
+		EXPECT_EQ(1000 + i, item);
+	}
+	EXPECT_FALSE(q.pop(&item));
+}
+
+/**
+ * Multiple producers, one consumer.
+ * Every item must arrive exactly once, and items from
+ * any one producer must arrive in the order they were pushed.
+ */
+TEST_F(MpscQueueTest, multiProducer)
+{
+	static const uint32_t PRODUCERS = 4;
+	static const uint32_t COUNT = 20000;
+	Queue q;
+
+	vector<std::thread> threads;
+	for (uint32_t id = 0; id < PRODUCERS; id++) {
+		threads.push_back(std::thread(producer, &q, id, COUNT));
+	}
+
+	// NOTE: Don't stop early on errors, since the
+	// producers can't finish until the queue is drained.
+	vector<uint32_t> next(PRODUCERS, 0);
+	uint32_t received = 0;
+	unsigned int errors = 0;
+	while (received < PRODUCERS * COUNT) {
+		uint32_t item;
+		if (!q.pop(&item)) {
+			std::this_thread::yield();
+			continue;
+		}
+		received++;
+
+		const uint32_t id = (item >> 24);
+		const uint32_t seq = (item & 0xFFFFFF);
+		if (id >= PRODUCERS || next[id] != seq) {
+			errors++;
+			continue;
+		}
+		next[id]++;
+	}
+
+	for (size_t i = 0; i < threads.size(); i++) {
+		threads[i].join();
+	}
+
+	EXPECT_EQ(0U, errors);
+	for (uint32_t id = 0; id < PRODUCERS; id++) {
+		EXPECT_EQ(COUNT, next[id]);
+	}
+
+	uint32_t item;
+	EXPECT_FALSE(q.pop(&item));
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: MpscQueue test.\n\n");
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
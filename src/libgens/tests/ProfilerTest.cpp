@@ -0,0 +1,194 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * ProfilerTest.cpp: Hot-path profiler test.                               *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "lg_main.hpp"
+#include "Util/Profiler.hpp"
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ includes.
+#include <string>
+using std::string;
+
+namespace LibGens { namespace Tests {
+
+class ProfilerTest : public ::testing::Test
+{
+	protected:
+		ProfilerTest()
+			: ::testing::Test() { }
+		virtual ~ProfilerTest() { }
+
+		virtual void SetUp(void) override;
+
+	protected:
+		static Profiler::FrameRecord ms_frames[Profiler::RING_SIZE];
+};
+
+Profiler::FrameRecord ProfilerTest::ms_frames[Profiler::RING_SIZE];
+
+/**
+ * Reset the profiler before each test.
+ */
+void ProfilerTest::SetUp(void)
+{
+	Profiler::Reset();
+}
+
+/**
+ * Verify that Now() is monotonic.
+ */
+TEST_F(ProfilerTest, nowIsMonotonic)
+{
+	uint64_t last = Profiler::Now();
+	for (int i = 0; i < 1000; i++) {
+		uint64_t cur = Profiler::Now();
+		EXPECT_GE(cur, last);
+		last = cur;
+	}
+}
+
+/**
+ * Verify that section times and cycle counts are recorded per frame.
+ */
+TEST_F(ProfilerTest, frameRecord)
+{
+	Profiler::BeginFrame();
+	Profiler::AddTime(Profiler::PROF_M68K_EXEC, 1000);
+	Profiler::AddTime(Profiler::PROF_M68K_EXEC, 500);
+	Profiler::AddTime(Profiler::PROF_VDP_RENDERLINE, 250);
+	Profiler::EndFrame(127856, 59659);
+
+	// Second frame should not include the first frame's times.
+	Profiler::BeginFrame();
+	Profiler::AddTime(Profiler::PROF_Z80_EXEC, 42);
+	Profiler::EndFrame(1, 2);
+
+	ASSERT_EQ(2, Profiler::ReadFrames(ms_frames, Profiler::RING_SIZE));
+
+	EXPECT_EQ(0U, ms_frames[0].frameNum);
+	EXPECT_EQ(127856U, ms_frames[0].cycles_M68K);
+	EXPECT_EQ(59659U, ms_frames[0].cycles_Z80);
+	EXPECT_EQ(1500U, ms_frames[0].sectTime[Profiler::PROF_M68K_EXEC]);
+	EXPECT_EQ(2U, ms_frames[0].sectCalls[Profiler::PROF_M68K_EXEC]);
+	EXPECT_EQ(250U, ms_frames[0].sectTime[Profiler::PROF_VDP_RENDERLINE]);
+	EXPECT_EQ(1U, ms_frames[0].sectCalls[Profiler::PROF_VDP_RENDERLINE]);
+	EXPECT_EQ(0U, ms_frames[0].sectTime[Profiler::PROF_Z80_EXEC]);
+
+	EXPECT_EQ(1U, ms_frames[1].frameNum);
+	EXPECT_EQ(0U, ms_frames[1].sectTime[Profiler::PROF_M68K_EXEC]);
+	EXPECT_EQ(42U, ms_frames[1].sectTime[Profiler::PROF_Z80_EXEC]);
+	EXPECT_GE(ms_frames[1].start, ms_frames[0].start);
+
+	// Ring buffer should now be empty.
+	EXPECT_EQ(0, Profiler::ReadFrames(ms_frames, Profiler::RING_SIZE));
+}
+
+/**
+ * Verify that frames are dropped if the ring buffer is full.
+ */
+TEST_F(ProfilerTest, ringOverflow)
+{
+	const unsigned int extra = 10;
+	for (unsigned int i = 0; i < Profiler::RING_SIZE + extra; i++) {
+		Profiler::BeginFrame();
+		Profiler::EndFrame(i, 0);
+	}
+	EXPECT_EQ(extra, Profiler::DroppedFrames());
+
+	// Read the frames in two parts to test partial reads.
+	const int half = Profiler::RING_SIZE / 2;
+	ASSERT_EQ(half, Profiler::ReadFrames(ms_frames, half));
+	EXPECT_EQ(0U, ms_frames[0].cycles_M68K);
+	EXPECT_EQ((uint32_t)(half - 1), ms_frames[half - 1].cycles_M68K);
+	ASSERT_EQ(half, Profiler::ReadFrames(ms_frames, Profiler::RING_SIZE));
+	EXPECT_EQ((uint32_t)half, ms_frames[0].cycles_M68K);
+	EXPECT_EQ(Profiler::RING_SIZE - 1, ms_frames[half - 1].cycles_M68K);
+
+	// There's room again.
+	Profiler::BeginFrame();
+	Profiler::EndFrame(12345, 0);
+	ASSERT_EQ(1, Profiler::ReadFrames(ms_frames, Profiler::RING_SIZE));
+	EXPECT_EQ(12345U, ms_frames[0].cycles_M68K);
+	EXPECT_EQ(Profiler::RING_SIZE + extra, ms_frames[0].frameNum);
+}
+
+/**
+ * Verify the Chrome trace JSON export.
+ */
+TEST_F(ProfilerTest, exportChromeTrace)
+{
+	Profiler::BeginFrame();
+	Profiler::AddTime(Profiler::PROF_YM2612_UPDATE, 2000000);
+	Profiler::EndFrame(100, 200);
+	ASSERT_EQ(1, Profiler::ReadFrames(ms_frames, Profiler::RING_SIZE));
+
+	const char *const filename = "ProfilerTest.json";
+	ASSERT_EQ(0, Profiler::ExportChromeTrace(filename, ms_frames, 1));
+
+	FILE *f = fopen(filename, "r");
+	ASSERT_TRUE(f != nullptr);
+	string json;
+	char buf[512];
+	size_t sz;
+	while ((sz = fread(buf, 1, sizeof(buf), f)) > 0) {
+		json.append(buf, sz);
+	}
+	fclose(f);
+	remove(filename);
+
+	EXPECT_EQ(0U, json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+	EXPECT_NE(string::npos, json.find("\"ph\":\"X\""));
+	EXPECT_NE(string::npos, json.find("\"m68k_cycles\":100"));
+	EXPECT_NE(string::npos, json.find("\"z80_cycles\":200"));
+	EXPECT_NE(string::npos, json.find("\"Ym2612::update\":2.000000"));
+	EXPECT_EQ(json.size() - 3, json.rfind("]}\n"));
+
+	// Invalid parameters.
+	EXPECT_EQ(-EINVAL, Profiler::ExportChromeTrace(nullptr, ms_frames, 1));
+	EXPECT_EQ(-EINVAL, Profiler::ExportChromeTrace(filename, nullptr, 1));
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: Profiler test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
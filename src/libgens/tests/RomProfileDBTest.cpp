@@ -0,0 +1,347 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * RomProfileDBTest.cpp: ROM profile database tests.                       *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "Cartridge/RomProfileDB.hpp"
+#include "Cartridge/rom_profile_db.h"
+#include "Save/EEPRomI2C.hpp"
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+// C++ includes.
+#include <string>
+#include <vector>
+using std::string;
+using std::vector;
+
+namespace LibGens { namespace Tests {
+
+class RomProfileDBTest : public ::testing::Test
+{
+	protected:
+		RomProfileDBTest()
+			: ::testing::Test() { }
+		virtual ~RomProfileDBTest() { }
+
+		virtual void TearDown(void);
+
+	public:
+		static const char DB_FILENAME[];
+
+		/**
+		 * Compile text sources into DB_FILENAME and open it.
+		 * @param src Text sources.
+		 * @param db [out] Database.
+		 * @return 0 on success; non-zero on error.
+		 */
+		static int compileAndOpen(const char *src, RomProfileDB *db);
+
+		/**
+		 * Write raw data to DB_FILENAME.
+		 * @param data Data.
+		 */
+		static void writeRaw(const vector<uint8_t> &data);
+};
+
+const char RomProfileDBTest::DB_FILENAME[] = "RomProfileDBTest.db";
+
+void RomProfileDBTest::TearDown(void)
+{
+	remove(DB_FILENAME);
+}
+
+int RomProfileDBTest::compileAndOpen(const char *src, RomProfileDB *db)
+{
+	RomProfileDBCompiler compiler;
+	int ret = compiler.parse(src, strlen(src), "test.txt");
+	EXPECT_EQ(0, ret) << compiler.lastError();
+	if (ret != 0)
+		return ret;
+	ret = compiler.write(DB_FILENAME);
+	EXPECT_EQ(0, ret);
+	if (ret != 0)
+		return ret;
+	ret = db->open(DB_FILENAME);
+	EXPECT_EQ(0, ret);
+	return ret;
+}
+
+void RomProfileDBTest::writeRaw(const vector<uint8_t> &data)
+{
+	FILE *f = fopen(DB_FILENAME, "wb");
+	ASSERT_TRUE(f != nullptr);
+	ASSERT_EQ(data.size(), fwrite(data.data(), 1, data.size(), f));
+	fclose(f);
+}
+
+/**
+ * Compile a database and look up each type of entry.
+ */
+TEST_F(RomProfileDBTest, roundTrip)
+{
+	static const char src[] =
+		"# Test database.\n"
+		"revision = 1A\n"
+		"\n"
+		"[serial \"GM T-12056\"]\n"
+		"title = Serial profile\n"
+		"mapper = ssf2\n"
+		"checksum = none\n"
+		"sprite_limits = off\n"
+		"\n"
+		"[crc32 0x1A2B3C4D]\n"
+		"title = CRC32 profile\n"
+		"mapper = registers_ro\n"
+		"ro_reg1 = FFFFFF A13000 1234\n"
+		"sram = 200001-20FFFF\n"
+		"eeprom = mode2\n"
+		"eeprom_dev_addr = 3\n"
+		"eeprom_size_mask = 3FF\n"
+		"eeprom_page_mask = $0F\n"
+		"eeprom_sda_in = 200001:0\n"
+		"eeprom_sda_out = 200001:1\n"
+		"eeprom_scl = 200000:7\n"
+		"zero_length_dma = yes\n"
+		"idle_skip = false\n"
+		"resampler = 1\n";
+
+	RomProfileDB db;
+	ASSERT_EQ(0, compileAndOpen(src, &db));
+	EXPECT_TRUE(db.isOpen());
+	EXPECT_EQ(0x1Au, db.revision());
+	EXPECT_EQ(2u, db.count());
+
+	// Serial number profile.
+	// The serial number is padded with spaces.
+	RomProfile profile;
+	ASSERT_TRUE(db.find(0, "GM T-12056 ", &profile));
+	EXPECT_STREQ("Serial profile", profile.title);
+	EXPECT_TRUE(profile.has(RomProfile::FIELD_MAPPER));
+	EXPECT_EQ(RomProfile::MAPPER_SSF2, profile.mapper);
+	EXPECT_TRUE(profile.has(RomProfile::FIELD_CHECKSUM));
+	EXPECT_EQ(RomProfile::CHECKSUM_NONE, profile.checksum);
+	EXPECT_TRUE(profile.has(RomProfile::FIELD_SPRITE_LIMITS));
+	EXPECT_FALSE(profile.spriteLimits);
+	EXPECT_FALSE(profile.has(RomProfile::FIELD_SRAM));
+	EXPECT_FALSE(profile.has(RomProfile::FIELD_EEPROM));
+	EXPECT_FALSE(profile.has(RomProfile::FIELD_IDLE_SKIP));
+
+	// CRC32 profile.
+	ASSERT_TRUE(db.find(0x1A2B3C4D, "XXXXXXXXXXX", &profile));
+	EXPECT_STREQ("CRC32 profile", profile.title);
+	EXPECT_EQ(RomProfile::MAPPER_REGISTERS_RO, profile.mapper);
+	EXPECT_TRUE(profile.has(RomProfile::FIELD_REGISTERS_RO));
+	EXPECT_EQ(0xFFFFFFu, profile.registers_ro.addr_mask[0]);
+	EXPECT_EQ(0xFFFFFFu, profile.registers_ro.addr_mask[1]);
+	EXPECT_EQ(0xA13000u, profile.registers_ro.addr[1]);
+	EXPECT_EQ(0x1234, profile.registers_ro.reg[1]);
+	EXPECT_TRUE(profile.has(RomProfile::FIELD_SRAM));
+	EXPECT_EQ(0x200001u, profile.sram.start);
+	EXPECT_EQ(0x20FFFFu, profile.sram.end);
+	EXPECT_TRUE(profile.has(RomProfile::FIELD_EEPROM));
+	EXPECT_EQ((uint8_t)EEPRomI2C::EPR_MODE2, profile.eeprom.mode);
+	EXPECT_EQ(3, profile.eeprom.dev_addr);
+	EXPECT_EQ(0x3FF, profile.eeprom.sz_mask);
+	EXPECT_EQ(0x0F, profile.eeprom.pg_mask);
+	EXPECT_EQ(0x200001u, profile.eeprom.sda_in_adr);
+	EXPECT_EQ(0, profile.eeprom.sda_in_bit);
+	EXPECT_EQ(0x200001u, profile.eeprom.sda_out_adr);
+	EXPECT_EQ(1, profile.eeprom.sda_out_bit);
+	EXPECT_EQ(0x200000u, profile.eeprom.scl_adr);
+	EXPECT_EQ(7, profile.eeprom.scl_bit);
+	EXPECT_FALSE(profile.has(RomProfile::FIELD_SPRITE_LIMITS));
+	EXPECT_TRUE(profile.zeroLengthDMA);
+	EXPECT_TRUE(profile.has(RomProfile::FIELD_IDLE_SKIP));
+	EXPECT_FALSE(profile.idleSkip);
+	EXPECT_TRUE(profile.resampler);
+
+	// Nonexistent entries.
+	EXPECT_FALSE(db.find(0x1A2B3C4E, "GM T-12057 ", &profile));
+	EXPECT_FALSE(db.find(0, nullptr, &profile));
+}
+
+/**
+ * CRC32 profiles take precedence over serial number profiles.
+ */
+TEST_F(RomProfileDBTest, crc32Precedence)
+{
+	static const char src[] =
+		"[serial \"GM 00001009-00\"]\n"
+		"title = Serial\n"
+		"[crc32 DEADBEEF]\n"
+		"title = CRC32\n";
+
+	// The serial number is truncated to 11 characters.
+	RomProfileDBCompiler compiler;
+	EXPECT_EQ(-EINVAL, compiler.parse(src, strlen(src), "test.txt"));
+
+	static const char src2[] =
+		"[serial \"GM 00001009\"]\n"
+		"title = Serial\n"
+		"[crc32 DEADBEEF]\n"
+		"title = CRC32\n";
+
+	RomProfileDB db;
+	ASSERT_EQ(0, compileAndOpen(src2, &db));
+
+	RomProfile profile;
+	ASSERT_TRUE(db.find(0xDEADBEEF, "GM 00001009", &profile));
+	EXPECT_STREQ("CRC32", profile.title);
+	ASSERT_TRUE(db.find(0xDEADBEEE, "GM 00001009", &profile));
+	EXPECT_STREQ("Serial", profile.title);
+}
+
+/**
+ * Lookups with many colliding keys.
+ * All keys have the same low bits, so they all
+ * start probing at the same bucket.
+ */
+TEST_F(RomProfileDBTest, collisions)
+{
+	static const unsigned int COUNT = 1000;
+	string src;
+	char buf[64];
+	for (unsigned int i = 0; i < COUNT; i++) {
+		snprintf(buf, sizeof(buf), "[crc32 %08X]\ntitle = %u\n", (i + 1) << 16, i);
+		src += buf;
+	}
+
+	RomProfileDB db;
+	ASSERT_EQ(0, compileAndOpen(src.c_str(), &db));
+	EXPECT_EQ(COUNT, db.count());
+
+	RomProfile profile;
+	for (unsigned int i = 0; i < COUNT; i++) {
+		ASSERT_TRUE(db.find((i + 1) << 16, nullptr, &profile)) << "entry " << i;
+		snprintf(buf, sizeof(buf), "%u", i);
+		EXPECT_STREQ(buf, profile.title);
+	}
+
+	EXPECT_FALSE(db.find((COUNT + 1) << 16, nullptr, &profile));
+	EXPECT_FALSE(db.find(1, nullptr, &profile));
+}
+
+/**
+ * Syntax errors are reported with the line number.
+ */
+TEST_F(RomProfileDBTest, parseErrors)
+{
+	static const struct {
+		const char *src;
+		const char *error;
+	} tests[] = {
+		{"title = outside\n", "test.txt:1:"},
+		{"[crc32 1234]\n\nmapper = bogus\n", "test.txt:3:"},
+		{"[crc32 1234]\n[crc32 1234]\n", "test.txt:2:"},
+		{"[serial GM]\n", "test.txt:1:"},
+		{"[crc32 1234]\nsram = 200001\n", "test.txt:2:"},
+		{"[crc32 1234]\nsram = 200000-220000\n", "test.txt:"},
+		{"[crc32 1234]\nmapper = registers_ro\n", "test.txt:"},
+		{"[crc32 1234]\neeprom = mode1\neeprom_scl = 200001:1\n", "test.txt:"},
+		{"[crc32 1234]\neeprom_size_mask = 3FE\n", "test.txt:2:"},
+		{"[crc32 1234]\neeprom_sda_in = 200001:8\n", "test.txt:2:"},
+		{"[crc32 1234]\nsprite_limits = maybe\n", "test.txt:2:"},
+		{"[crc32 1234\n", "test.txt:1:"},
+	};
+
+	for (size_t i = 0; i < sizeof(tests)/sizeof(tests[0]); i++) {
+		RomProfileDBCompiler compiler;
+		EXPECT_EQ(-EINVAL, compiler.parse(tests[i].src, strlen(tests[i].src), "test.txt"))
+			<< "source: " << tests[i].src;
+		EXPECT_EQ(0u, compiler.lastError().find(tests[i].error))
+			<< "source: " << tests[i].src << "error: " << compiler.lastError();
+	}
+}
+
+/**
+ * Invalid databases are rejected.
+ */
+TEST_F(RomProfileDBTest, invalidFiles)
+{
+	RomProfileDB db;
+	remove(DB_FILENAME);
+	EXPECT_EQ(-ENOENT, db.open(DB_FILENAME));
+	EXPECT_FALSE(db.isOpen());
+
+	static const char src[] =
+		"[crc32 12345678]\n"
+		"title = Valid\n";
+	RomProfileDBCompiler compiler;
+	ASSERT_EQ(0, compiler.parse(src, strlen(src), "test.txt"));
+	vector<uint8_t> data;
+	compiler.build(data);
+	ASSERT_GT(data.size(), sizeof(RomProfileDB_Header_t));
+
+	// Bad magic number.
+	vector<uint8_t> bad = data;
+	bad[0] ^= 0xFF;
+	writeRaw(bad);
+	EXPECT_EQ(-EBADMSG, db.open(DB_FILENAME));
+
+	// Truncated file.
+	bad = data;
+	bad.resize(bad.size() - 4);
+	writeRaw(bad);
+	EXPECT_EQ(-EBADMSG, db.open(DB_FILENAME));
+
+	// Truncated header.
+	bad.resize(sizeof(RomProfileDB_Header_t) - 1);
+	writeRaw(bad);
+	EXPECT_EQ(-EBADMSG, db.open(DB_FILENAME));
+
+	// Entry count larger than the bucket table.
+	bad = data;
+	bad[offsetof(RomProfileDB_Header_t, entry_count) + 3] = 0xFF;
+	writeRaw(bad);
+	EXPECT_EQ(-EBADMSG, db.open(DB_FILENAME));
+
+	// None of the above should have left a database open.
+	EXPECT_FALSE(db.isOpen());
+
+	// The original data should work.
+	writeRaw(data);
+	EXPECT_EQ(0, db.open(DB_FILENAME));
+	RomProfile profile;
+	EXPECT_TRUE(db.find(0x12345678, nullptr, &profile));
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: RomProfileDB tests.\n\n");
+	fflush(nullptr);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
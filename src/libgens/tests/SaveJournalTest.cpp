@@ -0,0 +1,354 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * SaveJournalTest.cpp: Save file journal tests.                           *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "Save/SaveJournal.hpp"
+#include "Save/SRam.hpp"
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstring>
+
+// C++ includes.
+#include <string>
+#include <vector>
+using std::string;
+using std::vector;
+
+namespace LibGens { namespace Tests {
+
+class SaveJournalTest : public ::testing::Test
+{
+	protected:
+		SaveJournalTest()
+			: ::testing::Test() { }
+		virtual ~SaveJournalTest() { }
+
+		virtual void TearDown(void);
+
+	public:
+		static const char SAVE_FILENAME[];
+		static const char JNL_FILENAME[];
+
+		/**
+		 * Load a file.
+		 * @param filename Filename.
+		 * @param data [out] File data.
+		 */
+		static void loadFile(const char *filename, vector<uint8_t> *data);
+
+		/**
+		 * Check if a file exists.
+		 * @param filename Filename.
+		 * @return True if the file exists; false if not.
+		 */
+		static bool fileExists(const char *filename);
+};
+
+const char SaveJournalTest::SAVE_FILENAME[] = "SaveJournalTest.srm";
+const char SaveJournalTest::JNL_FILENAME[] = "SaveJournalTest.srm.jnl";
+
+void SaveJournalTest::TearDown(void)
+{
+	remove(SAVE_FILENAME);
+	remove(JNL_FILENAME);
+}
+
+/**
+ * Load a file.
+ * @param filename Filename.
+ * @param data [out] File data.
+ */
+void SaveJournalTest::loadFile(const char *filename, vector<uint8_t> *data)
+{
+	FILE *f = fopen(filename, "rb");
+	ASSERT_TRUE(f != nullptr) << "Unable to open " << filename;
+	data->clear();
+	uint8_t block[4096];
+	size_t size;
+	while ((size = fread(block, 1, sizeof(block), f)) > 0) {
+		data->insert(data->end(), block, block + size);
+	}
+	fclose(f);
+}
+
+/**
+ * Check if a file exists.
+ * @param filename Filename.
+ * @return True if the file exists; false if not.
+ */
+bool SaveJournalTest::fileExists(const char *filename)
+{
+	FILE *f = fopen(filename, "rb");
+	if (!f)
+		return false;
+	fclose(f);
+	return true;
+}
+
+/**
+ * Only dirty pages should be written to an existing file.
+ */
+TEST_F(SaveJournalTest, dirtyPagesOnly)
+{
+	static const unsigned int SIZE = 4 * SaveJournal::PAGE_SIZE;
+	vector<uint8_t> data(SIZE, 0x11);
+
+	SaveJournal journal;
+	SaveJournal::DirtyPages dirty;
+	dirty.clear();
+
+	// New file: everything is written.
+	EXPECT_EQ(0, journal.write(SAVE_FILENAME, &data[0], SIZE, dirty));
+	EXPECT_EQ(0, journal.flush());
+	EXPECT_FALSE(fileExists(JNL_FILENAME));
+
+	// Modify pages 1 and 2, but only mark page 2 as dirty.
+	memset(&data[1 * SaveJournal::PAGE_SIZE], 0x22, SaveJournal::PAGE_SIZE);
+	memset(&data[2 * SaveJournal::PAGE_SIZE], 0x33, SaveJournal::PAGE_SIZE);
+	dirty.set(2 * SaveJournal::PAGE_SIZE + 5);
+	EXPECT_EQ(0, journal.write(SAVE_FILENAME, &data[0], SIZE, dirty));
+	EXPECT_EQ(0, journal.flush());
+
+	vector<uint8_t> file;
+	ASSERT_NO_FATAL_FAILURE(loadFile(SAVE_FILENAME, &file));
+	ASSERT_EQ(SIZE, file.size());
+	EXPECT_EQ(0x11, file[0]);
+	EXPECT_EQ(0x11, file[1 * SaveJournal::PAGE_SIZE]);
+	EXPECT_EQ(0x33, file[2 * SaveJournal::PAGE_SIZE]);
+	EXPECT_EQ(0x33, file[3 * SaveJournal::PAGE_SIZE - 1]);
+	EXPECT_EQ(0x11, file[3 * SaveJournal::PAGE_SIZE]);
+}
+
+/**
+ * The file should follow the save size, and pages past the
+ * old end of the file should be written even if they're clean.
+ */
+TEST_F(SaveJournalTest, resize)
+{
+	static const unsigned int SIZE = 8 * SaveJournal::PAGE_SIZE;
+	vector<uint8_t> data(SIZE, 0xFF);
+	data[0] = 0x42;
+
+	SaveJournal journal;
+	SaveJournal::DirtyPages dirty;
+	dirty.clear();
+	EXPECT_EQ(0, journal.write(SAVE_FILENAME, &data[0], 2, dirty));
+	EXPECT_EQ(0, journal.flush());
+
+	vector<uint8_t> file;
+	ASSERT_NO_FATAL_FAILURE(loadFile(SAVE_FILENAME, &file));
+	ASSERT_EQ(2U, file.size());
+	EXPECT_EQ(0x42, file[0]);
+	EXPECT_EQ(0xFF, file[1]);
+
+	// Grow the file. Only the last page is dirty.
+	data[SIZE - 1] = 0x24;
+	dirty.set(SIZE - 1);
+	EXPECT_EQ(0, journal.write(SAVE_FILENAME, &data[0], SIZE, dirty));
+	EXPECT_EQ(0, journal.flush());
+	ASSERT_NO_FATAL_FAILURE(loadFile(SAVE_FILENAME, &file));
+	ASSERT_EQ(SIZE, file.size());
+	EXPECT_EQ(0x42, file[0]);
+	EXPECT_EQ(0xFF, file[SaveJournal::PAGE_SIZE]);
+	EXPECT_EQ(0x24, file[SIZE - 1]);
+
+	// Shrink the file.
+	dirty.clear();
+	EXPECT_EQ(0, journal.write(SAVE_FILENAME, &data[0], SaveJournal::PAGE_SIZE, dirty));
+	EXPECT_EQ(0, journal.flush());
+	ASSERT_NO_FATAL_FAILURE(loadFile(SAVE_FILENAME, &file));
+	EXPECT_EQ((size_t)SaveJournal::PAGE_SIZE, file.size());
+}
+
+#ifndef _WIN32
+/**
+ * A complete journal left behind by an interrupted
+ * save should be applied by recover().
+ */
+TEST_F(SaveJournalTest, recover)
+{
+	static const unsigned int SIZE = 2 * SaveJournal::PAGE_SIZE;
+	vector<uint8_t> data(SIZE, 0x5A);
+
+	// Make the save file a directory so the journal
+	// is written, but the save file can't be updated.
+	ASSERT_EQ(0, mkdir(SAVE_FILENAME, 0755));
+	{
+		SaveJournal journal;
+		SaveJournal::DirtyPages dirty;
+		dirty.clear();
+		EXPECT_EQ(0, journal.write(SAVE_FILENAME, &data[0], SIZE, dirty));
+		EXPECT_NE(0, journal.flush());
+	}
+	ASSERT_EQ(0, rmdir(SAVE_FILENAME));
+	ASSERT_TRUE(fileExists(JNL_FILENAME));
+
+	SaveJournal journal;
+	EXPECT_EQ(1, journal.recover(SAVE_FILENAME));
+	EXPECT_FALSE(fileExists(JNL_FILENAME));
+
+	vector<uint8_t> file;
+	ASSERT_NO_FATAL_FAILURE(loadFile(SAVE_FILENAME, &file));
+	EXPECT_TRUE(file == data);
+}
+
+/**
+ * A torn journal should be discarded without
+ * touching the save file.
+ */
+TEST_F(SaveJournalTest, tornJournal)
+{
+	static const unsigned int SIZE = 2 * SaveJournal::PAGE_SIZE;
+	vector<uint8_t> data(SIZE, 0x5A);
+
+	ASSERT_EQ(0, mkdir(SAVE_FILENAME, 0755));
+	{
+		SaveJournal journal;
+		SaveJournal::DirtyPages dirty;
+		dirty.clear();
+		EXPECT_EQ(0, journal.write(SAVE_FILENAME, &data[0], SIZE, dirty));
+		EXPECT_NE(0, journal.flush());
+	}
+	ASSERT_EQ(0, rmdir(SAVE_FILENAME));
+
+	// Cut off the end of the journal.
+	vector<uint8_t> jnl;
+	ASSERT_NO_FATAL_FAILURE(loadFile(JNL_FILENAME, &jnl));
+	ASSERT_EQ(0, truncate(JNL_FILENAME, jnl.size() - 1));
+
+	SaveJournal journal;
+	EXPECT_EQ(0, journal.recover(SAVE_FILENAME));
+	EXPECT_FALSE(fileExists(JNL_FILENAME));
+	EXPECT_FALSE(fileExists(SAVE_FILENAME));
+}
+#endif /* !_WIN32 */
+
+/**
+ * SRam should save and reload through the journal.
+ */
+TEST_F(SaveJournalTest, sram)
+{
+	SRam sram;
+	sram.setStart(0x200000);
+	sram.setEnd(0x20FFFF);
+	sram.setFilename("SaveJournalTest.bin");
+	sram.writeByte(0x200000, 0x12);
+	sram.writeWord(0x200800, 0x3456);
+	EXPECT_TRUE(sram.isDirty());
+
+	// Paused autosave always saves.
+	EXPECT_EQ(0x1000, sram.autoSave(-1));
+	EXPECT_FALSE(sram.isDirty());
+	EXPECT_EQ(0, sram.save());
+
+	vector<uint8_t> file;
+	ASSERT_NO_FATAL_FAILURE(loadFile(SAVE_FILENAME, &file));
+	ASSERT_EQ(0x1000U, file.size());
+	EXPECT_EQ(0x12, file[0]);
+	EXPECT_EQ(0x34, file[0x800]);
+	EXPECT_EQ(0x56, file[0x801]);
+	EXPECT_EQ(0xFF, file[0x802]);
+
+	// Modify one byte, then reload.
+	sram.writeByte(0x200801, 0x78);
+	EXPECT_EQ(0x1000, sram.save());
+	sram.reset();
+	EXPECT_EQ(0x1000, sram.load());
+	EXPECT_EQ(0x12, sram.readByte(0x200000));
+	EXPECT_EQ(0x3478, sram.readWord(0x200800));
+}
+
+/**
+ * Pages from a failed commit should be marked as dirty again.
+ */
+TEST_F(SaveJournalTest, failedCommit)
+{
+	// The directory doesn't exist, so the journal can't be created.
+	static const char filename[] = "SaveJournalTest.missing/SaveJournalTest.srm";
+	uint8_t data[2 * SaveJournal::PAGE_SIZE];
+	memset(data, 0x5A, sizeof(data));
+
+	SaveJournal journal;
+	SaveJournal::DirtyPages dirty;
+	dirty.clear();
+	dirty.set(SaveJournal::PAGE_SIZE);
+	EXPECT_EQ(0, journal.write(filename, data, sizeof(data), dirty));
+	journal.flush();
+
+	dirty.clear();
+	EXPECT_GT(0, journal.takeFailedPages(dirty));
+	EXPECT_TRUE(dirty.test(0));
+	EXPECT_TRUE(dirty.test(1));
+
+	// The failure is only reported once.
+	dirty.clear();
+	EXPECT_EQ(0, journal.takeFailedPages(dirty));
+	EXPECT_FALSE(dirty.test(0));
+	EXPECT_FALSE(dirty.test(1));
+}
+
+/**
+ * SRam should be dirty again if an autosave failed.
+ */
+TEST_F(SaveJournalTest, sramFailedAutosave)
+{
+	SRam sram;
+	sram.setStart(0x200000);
+	sram.setEnd(0x20FFFF);
+	sram.setPathname("SaveJournalTest.missing");
+	sram.setFilename("SaveJournalTest.bin");
+	sram.writeWord(0x200800, 0x3456);
+
+	// The autosave is queued; the commit fails in the background.
+	EXPECT_EQ(0x1000, sram.autoSave(-1));
+	EXPECT_FALSE(sram.isDirty());
+
+	// save() waits for the writer, so the error is reported
+	// here, and SRam is marked as dirty again.
+	EXPECT_GT(0, sram.save());
+	EXPECT_TRUE(sram.isDirty());
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: SaveJournal test.\n\n");
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
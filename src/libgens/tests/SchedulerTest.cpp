@@ -0,0 +1,237 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * SchedulerTest.cpp: Master clock event scheduler test.                   *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "EmuContext/Scheduler.hpp"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstdlib>
+
+// C++ includes.
+#include <algorithm>
+
+namespace LibGens { namespace Tests {
+
+class SchedulerTest : public ::testing::Test
+{
+	protected:
+		SchedulerTest()
+			: ::testing::Test() { }
+		virtual ~SchedulerTest() { }
+
+	protected:
+		Scheduler sched;
+};
+
+/**
+ * Events should be returned in cycle order.
+ */
+TEST_F(SchedulerTest, ordering)
+{
+	EXPECT_EQ((int)Scheduler::NEVER, sched.nextCycle());
+
+	sched.schedule(3, 900);
+	sched.schedule(1, 3420);
+	sched.schedule(2, 592);
+	sched.schedule(0, 0);
+	EXPECT_EQ(0, sched.nextCycle());
+
+	EXPECT_EQ(0, sched.popDue(3420));
+	EXPECT_EQ(2, sched.popDue(3420));
+	EXPECT_EQ(3, sched.popDue(3420));
+	EXPECT_EQ(1, sched.popDue(3420));
+	EXPECT_EQ(-1, sched.popDue(3420));
+	EXPECT_EQ((int)Scheduler::NEVER, sched.nextCycle());
+}
+
+/**
+ * Events on the same cycle should be returned in the order
+ * they were scheduled.
+ */
+TEST_F(SchedulerTest, sameCycleFifo)
+{
+	sched.schedule(5, 100);
+	sched.schedule(2, 100);
+	sched.schedule(9, 100);
+	sched.schedule(0, 100);
+
+	EXPECT_EQ(5, sched.popDue(100));
+	EXPECT_EQ(2, sched.popDue(100));
+	EXPECT_EQ(9, sched.popDue(100));
+	EXPECT_EQ(0, sched.popDue(100));
+	EXPECT_EQ(-1, sched.popDue(100));
+}
+
+/**
+ * Events that aren't due yet shouldn't be returned.
+ */
+TEST_F(SchedulerTest, popDue)
+{
+	sched.schedule(0, 1000);
+	sched.schedule(1, 2000);
+
+	EXPECT_EQ(-1, sched.popDue(999));
+	EXPECT_EQ(0, sched.popDue(1000));
+	EXPECT_EQ(-1, sched.popDue(1999));
+	EXPECT_TRUE(sched.isScheduled(1));
+	EXPECT_EQ(1, sched.popDue(2500));
+	EXPECT_FALSE(sched.isScheduled(1));
+}
+
+/**
+ * Rescheduling an event should move it.
+ */
+TEST_F(SchedulerTest, reschedule)
+{
+	sched.schedule(0, 100);
+	sched.schedule(1, 200);
+	sched.schedule(2, 300);
+
+	// Move event 2 before event 0.
+	sched.schedule(2, 50);
+	EXPECT_EQ(50, sched.nextCycle());
+
+	// Move event 2 after event 1.
+	sched.schedule(2, 250);
+	EXPECT_EQ(100, sched.nextCycle());
+
+	EXPECT_EQ(0, sched.popDue(1000));
+	EXPECT_EQ(1, sched.popDue(1000));
+	EXPECT_EQ(2, sched.popDue(1000));
+	EXPECT_EQ(-1, sched.popDue(1000));
+}
+
+/**
+ * Cancelled events should not be returned.
+ */
+TEST_F(SchedulerTest, cancel)
+{
+	sched.schedule(0, 100);
+	sched.schedule(1, 200);
+	sched.schedule(2, 300);
+
+	sched.cancel(0);
+	sched.cancel(0);	// no-op
+	EXPECT_FALSE(sched.isScheduled(0));
+	EXPECT_EQ(200, sched.nextCycle());
+
+	sched.cancel(2);
+	EXPECT_EQ(1, sched.popDue(1000));
+	EXPECT_EQ(-1, sched.popDue(1000));
+
+	// reset() should remove everything.
+	sched.schedule(3, 10);
+	sched.schedule(4, 20);
+	sched.reset();
+	EXPECT_FALSE(sched.isScheduled(3));
+	EXPECT_FALSE(sched.isScheduled(4));
+	EXPECT_EQ((int)Scheduler::NEVER, sched.nextCycle());
+}
+
+/**
+ * rebase() should subtract cycles from all events.
+ */
+TEST_F(SchedulerTest, rebase)
+{
+	sched.schedule(0, 896040);
+	sched.schedule(1, 896100);
+
+	sched.rebase(896040);
+	EXPECT_EQ(0, sched.nextCycle());
+	EXPECT_EQ(0, sched.popDue(0));
+	EXPECT_EQ(-1, sched.popDue(59));
+	EXPECT_EQ(1, sched.popDue(60));
+}
+
+/**
+ * Compare against a sorted reference with random operations.
+ */
+TEST_F(SchedulerTest, randomized)
+{
+	// Reference: cycle for each ID, or -1 if not scheduled.
+	int32_t ref[Scheduler::MAX_EVENTS];
+	for (int i = 0; i < Scheduler::MAX_EVENTS; i++) {
+		ref[i] = -1;
+	}
+
+	srand(0x4D434C4B);
+	int32_t now = 0;
+	for (int iter = 0; iter < 20000; iter++) {
+		const int id = rand() % Scheduler::MAX_EVENTS;
+		switch (rand() % 4) {
+			case 0:
+			case 1:
+				// Schedule an event in the future.
+				ref[id] = now + (rand() % 4096);
+				sched.schedule(id, ref[id]);
+				break;
+			case 2:
+				ref[id] = -1;
+				sched.cancel(id);
+				break;
+			case 3: {
+				// Advance time and pop all due events.
+				now += (rand() % 1024);
+				int32_t last = -1;
+				int ev;
+				while ((ev = sched.popDue(now)) >= 0) {
+					ASSERT_GE(ref[ev], 0);
+					ASSERT_LE(ref[ev], now);
+					ASSERT_GE(ref[ev], last);
+					last = ref[ev];
+					ref[ev] = -1;
+				}
+				break;
+			}
+		}
+
+		// Check the next cycle against the reference.
+		int32_t expected = Scheduler::NEVER;
+		for (int i = 0; i < Scheduler::MAX_EVENTS; i++) {
+			if (ref[i] >= 0) {
+				expected = std::min(expected, ref[i]);
+			}
+			ASSERT_EQ(ref[i] >= 0, sched.isScheduled(i));
+		}
+		ASSERT_EQ(expected, sched.nextCycle());
+	}
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: Scheduler test.\n\n");
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
@@ -0,0 +1,342 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * VdpDmaTest.cpp: VDP DMA transfer test.                                  *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "lg_main.hpp"
+#include "Rom.hpp"
+#include "EmuContext/EmuMD.hpp"
+#include "Vdp/Vdp.hpp"
+#include "cpu/M68K_Mem.hpp"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstring>
+
+namespace LibGens { namespace Tests {
+
+class VdpDmaTest : public ::testing::Test
+{
+	protected:
+		VdpDmaTest()
+			: ::testing::Test()
+			, m_rom(nullptr)
+			, m_context(nullptr)
+			, m_vdp(nullptr) { }
+		virtual ~VdpDmaTest() { }
+
+		virtual void SetUp(void) override;
+		virtual void TearDown(void) override;
+
+		// ROM size. (128 KB)
+		static const unsigned int ROM_SIZE = 128*1024;
+
+		/**
+		 * Set a VDP register using the control port.
+		 * @param reg Register number.
+		 * @param val Register value.
+		 */
+		void writeReg(uint8_t reg, uint8_t val);
+
+		/**
+		 * Run a 68000-to-VDP DMA transfer.
+		 * @param src Source address.
+		 * @param cd Destination code. (CD3-CD0)
+		 * @param dest Destination address.
+		 * @param length Length, in words.
+		 */
+		void dma(uint32_t src, uint8_t cd, uint16_t dest, uint16_t length);
+
+		/**
+		 * Read words using the data port.
+		 * @param cd Source code. (CD3-CD0)
+		 * @param address Address.
+		 * @param buf Output buffer.
+		 * @param length Length, in words.
+		 */
+		void readData(uint8_t cd, uint16_t address, uint16_t *buf, int length);
+
+		/**
+		 * Get a word from the test ROM.
+		 * @param address ROM address.
+		 * @return ROM word.
+		 */
+		uint16_t romWord(uint32_t address) const;
+
+		// DMA destination codes.
+		static const uint8_t CD_VRAM = 0x01;
+		static const uint8_t CD_CRAM = 0x03;
+		static const uint8_t CD_VSRAM = 0x05;
+
+		// Data port read codes.
+		static const uint8_t CD_VRAM_READ = 0x00;
+		static const uint8_t CD_CRAM_READ = 0x08;
+		static const uint8_t CD_VSRAM_READ = 0x04;
+
+	protected:
+		uint8_t m_rom_data[ROM_SIZE];
+		Rom *m_rom;
+		EmuMD *m_context;
+		Vdp *m_vdp;
+};
+
+/**
+ * Create an emulation context with a test ROM.
+ * The ROM and M68K RAM are filled with unique words.
+ */
+void VdpDmaTest::SetUp(void)
+{
+	for (unsigned int i = 0; i < ROM_SIZE; i += 2) {
+		const uint16_t w = (uint16_t)((i >> 1) ^ 0xA55A);
+		m_rom_data[i] = (w >> 8);
+		m_rom_data[i + 1] = (w & 0xFF);
+	}
+	// Minimal ROM header.
+	memset(&m_rom_data[0x100], ' ', 0x100);
+	memcpy(&m_rom_data[0x100], "SEGA MEGA DRIVE ", 16);
+
+	m_rom = new Rom(m_rom_data, ROM_SIZE);
+	m_context = new EmuMD(m_rom);
+	ASSERT_TRUE(m_context->isRomOpened());
+	m_vdp = m_context->m_vdp;
+
+	for (unsigned int i = 0; i < ARRAY_SIZE(Ram_68k.u16); i++) {
+		Ram_68k.u16[i] = (uint16_t)(i * 0x3579 + 1);
+	}
+
+	writeReg(0x01, 0x54);	// Enable the display and DMA, set Mode 5.
+	writeReg(0x05, 0x7C);	// Sprite Attribute Table: 0xF800
+	writeReg(0x0C, 0x81);	// H40
+	writeReg(0x0F, 0x02);	// Auto-increment: 2
+}
+
+/**
+ * Delete the emulation context.
+ */
+void VdpDmaTest::TearDown(void)
+{
+	delete m_context;
+	delete m_rom;
+}
+
+/**
+ * Set a VDP register using the control port.
+ * @param reg Register number.
+ * @param val Register value.
+ */
+void VdpDmaTest::writeReg(uint8_t reg, uint8_t val)
+{
+	m_vdp->writeCtrlMD(0x8000 | (reg << 8) | val);
+}
+
+/**
+ * Run a 68000-to-VDP DMA transfer.
+ * @param src Source address.
+ * @param cd Destination code. (CD3-CD0)
+ * @param dest Destination address.
+ * @param length Length, in words.
+ */
+void VdpDmaTest::dma(uint32_t src, uint8_t cd, uint16_t dest, uint16_t length)
+{
+	writeReg(0x13, (length & 0xFF));
+	writeReg(0x14, (length >> 8));
+	writeReg(0x15, ((src >> 1) & 0xFF));
+	writeReg(0x16, ((src >> 9) & 0xFF));
+	writeReg(0x17, ((src >> 17) & 0x7F));
+	m_vdp->writeCtrlMD(((cd & 0x03) << 14) | (dest & 0x3FFF));
+	m_vdp->writeCtrlMD(0x80 | ((cd & 0x3C) << 2) | (dest >> 14));
+}
+
+/**
+ * Read words using the data port.
+ * @param cd Source code. (CD3-CD0)
+ * @param address Address.
+ * @param buf Output buffer.
+ * @param length Length, in words.
+ */
+void VdpDmaTest::readData(uint8_t cd, uint16_t address, uint16_t *buf, int length)
+{
+	m_vdp->writeCtrlMD(((cd & 0x03) << 14) | (address & 0x3FFF));
+	m_vdp->writeCtrlMD(((cd & 0x3C) << 2) | (address >> 14));
+	for (int i = 0; i < length; i++) {
+		buf[i] = m_vdp->readDataMD();
+	}
+}
+
+/**
+ * Get a word from the test ROM.
+ * @param address ROM address.
+ * @return ROM word.
+ */
+uint16_t VdpDmaTest::romWord(uint32_t address) const
+{
+	return (m_rom_data[address] << 8) | m_rom_data[address + 1];
+}
+
+/**
+ * M68K RAM to VRAM, all 64 KB.
+ */
+TEST_F(VdpDmaTest, ramToVRam)
+{
+	dma(0xFF0000, CD_VRAM, 0x0000, 0x8000);
+
+	uint16_t *vram = new uint16_t[0x8000];
+	readData(CD_VRAM_READ, 0x0000, vram, 0x8000);
+	for (int i = 0; i < 0x8000; i++) {
+		ASSERT_EQ(Ram_68k.u16[i], vram[i]) << "VRAM word " << i << " is incorrect.";
+	}
+	delete[] vram;
+}
+
+/**
+ * M68K RAM to VRAM, wrapping at the end of VRAM.
+ */
+TEST_F(VdpDmaTest, ramToVRamDestWrap)
+{
+	dma(0xFF1000, CD_VRAM, 0xFF00, 0x100);
+
+	uint16_t vram[0x80];
+	readData(CD_VRAM_READ, 0xFF00, vram, 0x80);
+	for (int i = 0; i < 0x80; i++) {
+		EXPECT_EQ(Ram_68k.u16[0x800 + i], vram[i]) << "VRAM word " << i << " is incorrect.";
+	}
+	readData(CD_VRAM_READ, 0x0000, vram, 0x80);
+	for (int i = 0; i < 0x80; i++) {
+		EXPECT_EQ(Ram_68k.u16[0x880 + i], vram[i]) << "VRAM word " << i << " is incorrect.";
+	}
+}
+
+/**
+ * M68K RAM to VRAM, wrapping at the end of the 128 KB source window.
+ * M68K RAM is mirrored, so this wraps around to the start of RAM.
+ */
+TEST_F(VdpDmaTest, ramToVRamSourceWrap)
+{
+	dma(0xFFFF00, CD_VRAM, 0x1000, 0x100);
+
+	uint16_t vram[0x100];
+	readData(CD_VRAM_READ, 0x1000, vram, 0x100);
+	for (int i = 0; i < 0x80; i++) {
+		EXPECT_EQ(Ram_68k.u16[0x7F80 + i], vram[i]) << "VRAM word " << i << " is incorrect.";
+	}
+	for (int i = 0x80; i < 0x100; i++) {
+		EXPECT_EQ(Ram_68k.u16[i - 0x80], vram[i]) << "VRAM word " << i << " is incorrect.";
+	}
+}
+
+/**
+ * M68K RAM to VRAM with auto-increment 4.
+ * This uses the per-word path.
+ */
+TEST_F(VdpDmaTest, ramToVRamAutoInc4)
+{
+	uint16_t vram[0x200];
+	writeReg(0x0F, 0x02);
+	readData(CD_VRAM_READ, 0x2000, vram, 0x200);
+
+	writeReg(0x0F, 0x04);
+	dma(0xFF0000, CD_VRAM, 0x2000, 0x100);
+
+	// Only every other word should be written.
+	for (int i = 0; i < 0x200; i++) {
+		if (!(i & 1)) {
+			vram[i] = Ram_68k.u16[i >> 1];
+		}
+	}
+
+	uint16_t result[0x200];
+	writeReg(0x0F, 0x02);
+	readData(CD_VRAM_READ, 0x2000, result, 0x200);
+	for (int i = 0; i < 0x200; i++) {
+		EXPECT_EQ(vram[i], result[i]) << "VRAM word " << i << " is incorrect.";
+	}
+}
+
+/**
+ * ROM to VRAM, wrapping at the end of the 128 KB source window.
+ */
+TEST_F(VdpDmaTest, romToVRamSourceWrap)
+{
+	dma(0x01FF00, CD_VRAM, 0x4000, 0x100);
+
+	uint16_t vram[0x100];
+	readData(CD_VRAM_READ, 0x4000, vram, 0x100);
+	for (int i = 0; i < 0x80; i++) {
+		EXPECT_EQ(romWord(0x1FF00 + (i * 2)), vram[i]) << "VRAM word " << i << " is incorrect.";
+	}
+	for (int i = 0x80; i < 0x100; i++) {
+		EXPECT_EQ(romWord((i - 0x80) * 2), vram[i]) << "VRAM word " << i << " is incorrect.";
+	}
+}
+
+/**
+ * M68K RAM to CRAM. Writes past the end of CRAM are ignored.
+ */
+TEST_F(VdpDmaTest, ramToCRam)
+{
+	uint16_t cram[0x40];
+	readData(CD_CRAM_READ, 0x00, cram, 0x20);
+
+	dma(0xFF2000, CD_CRAM, 0x40, 0x40);
+	for (int i = 0x20; i < 0x40; i++) {
+		cram[i] = Ram_68k.u16[0x1000 + i - 0x20];
+	}
+
+	uint16_t result[0x40];
+	readData(CD_CRAM_READ, 0x00, result, 0x40);
+	for (int i = 0; i < 0x40; i++) {
+		EXPECT_EQ(cram[i], result[i]) << "CRAM word " << i << " is incorrect.";
+	}
+}
+
+/**
+ * M68K RAM to VSRAM.
+ */
+TEST_F(VdpDmaTest, ramToVSRam)
+{
+	dma(0xFF3000, CD_VSRAM, 0x00, 0x28);
+
+	uint16_t vsram[0x28];
+	readData(CD_VSRAM_READ, 0x00, vsram, 0x28);
+	for (int i = 0; i < 0x28; i++) {
+		EXPECT_EQ(Ram_68k.u16[0x1800 + i], vsram[i]) << "VSRAM word " << i << " is incorrect.";
+	}
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: VDP DMA test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
@@ -0,0 +1,272 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * VdpFrameSignatureTest.cpp: VDP frame signature test.                    *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "lg_main.hpp"
+#include "Vdp/Vdp.hpp"
+#include "Util/MdFb.hpp"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstring>
+
+// C++ includes.
+#include <vector>
+using std::vector;
+
+namespace LibGens { namespace Tests {
+
+class VdpFrameSignatureTest : public ::testing::Test
+{
+	protected:
+		VdpFrameSignatureTest()
+			: ::testing::Test()
+			, m_vdp(nullptr) { }
+		virtual ~VdpFrameSignatureTest() { }
+
+		virtual void SetUp(void) override;
+		virtual void TearDown(void) override;
+
+		/**
+		 * Render a full frame.
+		 * @return Frame signature.
+		 */
+		uint64_t renderFrame(void);
+
+		/**
+		 * Copy MD_Screen.
+		 * @return Copy of the 32-bit framebuffer.
+		 */
+		vector<uint32_t> copyScreen(void) const;
+
+		/**
+		 * Set a CRam entry.
+		 * @param idx Color index.
+		 * @param color MD color value.
+		 */
+		void setColor(uint8_t idx, uint16_t color);
+
+		Vdp *m_vdp;
+};
+
+/**
+ * Set up the Vdp for testing.
+ * The screen has a block of solid tiles on a
+ * plain background, using Scroll A only.
+ */
+void VdpFrameSignatureTest::SetUp(void)
+{
+	m_vdp = new Vdp();
+	m_vdp->setNtsc();
+	m_vdp->MD_Screen->setBpp(MdFb::BPP_32);
+
+	m_vdp->dbg_setReg(0x00, 0x04);	// Enable the palette. (?)
+	m_vdp->dbg_setReg(0x01, 0x44);	// Enable the display, set Mode 5.
+	m_vdp->dbg_setReg(0x02, 0x30);	// Set scroll A name table base to 0xC000.
+	m_vdp->dbg_setReg(0x04, 0x05);	// Set scroll B name table base to 0xA000.
+	m_vdp->dbg_setReg(0x05, 0x70);	// Set the sprite table base to 0xE000.
+	m_vdp->dbg_setReg(0x0C, 0x81);	// H40.
+	m_vdp->dbg_setReg(0x0D, 0x3F);	// Set the HScroll table base to 0xFC00.
+	m_vdp->dbg_setReg(0x10, 0x01);	// Set the scroll size to V32 H64.
+
+	// Tile 1: Solid color 1.
+	uint16_t tile[16];
+	for (int i = 0; i < 16; i++) {
+		tile[i] = 0x1111;
+	}
+	ASSERT_EQ(0, m_vdp->dbg_writeVRam_16(0x0020, tile, sizeof(tile)));
+
+	// Scroll A: 8x4 block of tile 1 at (4,4).
+	uint16_t names[8];
+	for (int i = 0; i < 8; i++) {
+		names[i] = 0x0001;
+	}
+	for (int row = 4; row < 8; row++) {
+		ASSERT_EQ(0, m_vdp->dbg_writeVRam_16(0xC000 + ((row * 64) + 4) * 2,
+			names, sizeof(names)));
+	}
+
+	setColor(0, 0x0000);	// Black background.
+	setColor(1, 0x000E);	// Red tiles.
+}
+
+/**
+ * Tear down the Vdp.
+ */
+void VdpFrameSignatureTest::TearDown(void)
+{
+	delete m_vdp;
+	m_vdp = nullptr;
+}
+
+/**
+ * Render a full frame.
+ * @return Frame signature.
+ */
+uint64_t VdpFrameSignatureTest::renderFrame(void)
+{
+	m_vdp->startFrame();
+	m_vdp->updateVdpLines(true);
+	for (; m_vdp->VDP_Lines.currentLine < m_vdp->VDP_Lines.totalDisplayLines;
+	     m_vdp->VDP_Lines.currentLine++)
+	{
+		m_vdp->renderLine();
+	}
+	return m_vdp->frameSignature();
+}
+
+/**
+ * Copy MD_Screen.
+ * @return Copy of the 32-bit framebuffer.
+ */
+vector<uint32_t> VdpFrameSignatureTest::copyScreen(void) const
+{
+	const MdFb *fb = m_vdp->MD_Screen;
+	const uint32_t *px = fb->fb32();
+	return vector<uint32_t>(px, px + (fb->pxPitch() * fb->numLines()));
+}
+
+/**
+ * Set a CRam entry.
+ * @param idx Color index.
+ * @param color MD color value.
+ */
+void VdpFrameSignatureTest::setColor(uint8_t idx, uint16_t color)
+{
+	ASSERT_EQ(0, m_vdp->dbg_writeCRam_16(idx * 2, &color, sizeof(color)));
+}
+
+/**
+ * Rendering the same frame twice should produce the same signature.
+ */
+TEST_F(VdpFrameSignatureTest, identicalFrames)
+{
+	const uint64_t sig1 = renderFrame();
+	const vector<uint32_t> screen1 = copyScreen();
+	const uint64_t sig2 = renderFrame();
+	EXPECT_EQ(sig1, sig2);
+	EXPECT_TRUE(screen1 == copyScreen());
+}
+
+/**
+ * A CRam change should change the signature, and
+ * reverting it should restore the original frame.
+ */
+TEST_F(VdpFrameSignatureTest, cramChange)
+{
+	const uint64_t sig1 = renderFrame();
+	const vector<uint32_t> screen1 = copyScreen();
+
+	// Tile pixel: (40, 40) plus the top border.
+	const int y = 40 + m_vdp->MD_Screen->imgYStart();
+	const uint32_t red = m_vdp->MD_Screen->lineBuf32(y)[40];
+
+	setColor(1, 0x00E0);	// Green tiles.
+	const uint64_t sig2 = renderFrame();
+	EXPECT_NE(sig1, sig2);
+	EXPECT_NE(red, m_vdp->MD_Screen->lineBuf32(y)[40]);
+
+	setColor(1, 0x000E);	// Red tiles.
+	const uint64_t sig3 = renderFrame();
+	EXPECT_EQ(sig1, sig3);
+	EXPECT_TRUE(screen1 == copyScreen());
+}
+
+/**
+ * A VRam change should change the signature, and
+ * reverting it should restore the original frame.
+ */
+TEST_F(VdpFrameSignatureTest, vramChange)
+{
+	const uint64_t sig1 = renderFrame();
+	const vector<uint32_t> screen1 = copyScreen();
+
+	// Change one row of tile 1.
+	const uint16_t row[2] = {0x2222, 0x2222};
+	ASSERT_EQ(0, m_vdp->dbg_writeVRam_16(0x0020, row, sizeof(row)));
+	const uint64_t sig2 = renderFrame();
+	EXPECT_NE(sig1, sig2);
+
+	const uint16_t orig[2] = {0x1111, 0x1111};
+	ASSERT_EQ(0, m_vdp->dbg_writeVRam_16(0x0020, orig, sizeof(orig)));
+	const uint64_t sig3 = renderFrame();
+	EXPECT_EQ(sig1, sig3);
+	EXPECT_TRUE(screen1 == copyScreen());
+}
+
+/**
+ * Unchanged lines are not rewritten to MD_Screen
+ * unless the frame signature is invalidated.
+ */
+TEST_F(VdpFrameSignatureTest, unchangedLinesSkipped)
+{
+	const uint64_t sig1 = renderFrame();
+	const int y = 40 + m_vdp->MD_Screen->imgYStart();
+	const uint32_t orig = m_vdp->MD_Screen->lineBuf32(y)[40];
+
+	// Modify MD_Screen behind the VDP's back.
+	m_vdp->MD_Screen->lineBuf32(y)[40] = 0x123456;
+	EXPECT_EQ(sig1, renderFrame());
+	EXPECT_EQ(0x123456U, m_vdp->MD_Screen->lineBuf32(y)[40]);
+
+	// Invalidate the signature. The line should be redrawn.
+	m_vdp->invalidateFrameSignature();
+	EXPECT_EQ(sig1, renderFrame());
+	EXPECT_EQ(orig, m_vdp->MD_Screen->lineBuf32(y)[40]);
+}
+
+/**
+ * Changing the color depth should change the signature.
+ */
+TEST_F(VdpFrameSignatureTest, bppChange)
+{
+	const uint64_t sig1 = renderFrame();
+	m_vdp->MD_Screen->setBpp(MdFb::BPP_16);
+	const uint64_t sig2 = renderFrame();
+	EXPECT_NE(sig1, sig2);
+	m_vdp->MD_Screen->setBpp(MdFb::BPP_32);
+	EXPECT_EQ(sig1, renderFrame());
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: VDP frame signature tests.\n\n");
+
+	::testing::InitGoogleTest(&argc, argv);
+	LibGens::Init();
+	fprintf(stderr, "\n");
+	fflush(nullptr);
+
+	int ret = RUN_ALL_TESTS();
+	LibGens::End();
+	return ret;
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
@@ -0,0 +1,277 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * VdpPaletteTest.cpp: VdpPalette incremental update test.                 *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "lg_main.hpp"
+#include "Vdp/VdpPalette.hpp"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace LibGens { namespace Tests {
+
+/**
+ * Palette configuration for a test.
+ */
+struct PaletteConfig {
+	VdpPalette::PalMode_t palMode;
+	uint8_t m5m4bits;
+	bool mdShadowHighlight;
+	MdFb::ColorDepth bpp;
+};
+
+class VdpPaletteTest : public ::testing::Test
+{
+	protected:
+		VdpPaletteTest()
+			: ::testing::Test() { }
+		virtual ~VdpPaletteTest() { }
+
+		/**
+		 * Apply a palette configuration.
+		 * @param palette VdpPalette.
+		 * @param cfg Palette configuration.
+		 */
+		static void applyConfig(VdpPalette *palette, const PaletteConfig &cfg);
+
+		/**
+		 * Write random CRam data, updating the palette between writes.
+		 * This exercises the incremental update path.
+		 * @param palette VdpPalette.
+		 * @param seed Random seed.
+		 */
+		static void writeRandom(VdpPalette *palette, unsigned int seed);
+
+		/**
+		 * Compare the active palette to a fully-recalculated palette.
+		 * @param palette VdpPalette. (incrementally updated)
+		 * @param cfg Palette configuration.
+		 */
+		static void checkAgainstFull(const VdpPalette *palette, const PaletteConfig &cfg);
+};
+
+/**
+ * Apply a palette configuration.
+ * @param palette VdpPalette.
+ * @param cfg Palette configuration.
+ */
+void VdpPaletteTest::applyConfig(VdpPalette *palette, const PaletteConfig &cfg)
+{
+	palette->setPalMode(cfg.palMode);
+	palette->setM5M4bits(cfg.m5m4bits);
+	palette->setMdShadowHighlight(cfg.mdShadowHighlight);
+	palette->setBpp(cfg.bpp);
+}
+
+/**
+ * Write random CRam data, updating the palette between writes.
+ * This exercises the incremental update path.
+ * @param palette VdpPalette.
+ * @param seed Random seed.
+ */
+void VdpPaletteTest::writeRandom(VdpPalette *palette, unsigned int seed)
+{
+	srand(seed);
+	for (int i = 0; i < 2000; i++) {
+		switch (rand() % 8) {
+			case 0:
+				// 8-bit CRam write.
+				palette->writeCRam_8(rand() & 0x7F, rand() & 0xFF);
+				break;
+			case 1:
+				// 32X CRam write.
+				palette->writeCRam32X_16((rand() & 0xFF) << 1, rand() & 0xFFFF);
+				break;
+			case 2:
+				// Background color change.
+				// This marks the whole active palette as dirty.
+				if ((rand() % 16) == 0) {
+					palette->setBgColorIdx(rand() & 0x3F);
+				}
+				break;
+			default:
+				// 16-bit CRam write.
+				palette->writeCRam_16((rand() & 0x3F) << 1, rand() & 0xFFFF);
+				break;
+		}
+
+		// Raster effects usually change a few colors per line.
+		if ((rand() % 3) == 0) {
+			palette->update();
+		}
+	}
+	palette->update();
+}
+
+/**
+ * Compare the active palette to a fully-recalculated palette.
+ * @param palette VdpPalette. (incrementally updated)
+ * @param cfg Palette configuration.
+ */
+void VdpPaletteTest::checkAgainstFull(const VdpPalette *palette, const PaletteConfig &cfg)
+{
+	VdpPalette *full = new VdpPalette();
+	applyConfig(full, cfg);
+	full->setBgColorIdx(palette->bgColorIdx());
+	for (int i = 0; i < 0x80; i += 2) {
+		full->writeCRam_16(i, palette->readCRam_16(i));
+	}
+	for (int i = 0; i < 0x200; i += 2) {
+		full->writeCRam32X_16(i, palette->readCRam32X_16(i));
+	}
+	full->update();
+
+	// Number of active palette entries to check.
+	int count;
+	switch (cfg.palMode) {
+		case VdpPalette::PALMODE_MD:
+		case VdpPalette::PALMODE_32X:
+			if (!(cfg.m5m4bits & 0x02)) {
+				// Mode 4: Only 32 colors are used.
+				count = 32;
+			} else {
+				count = (cfg.mdShadowHighlight ? 256 : 64);
+			}
+			break;
+		default:
+			count = 32;
+			break;
+	}
+
+	if (cfg.bpp == MdFb::BPP_32) {
+		for (int i = 0; i < count; i++) {
+			EXPECT_EQ(full->m_palActive.u32[i], palette->m_palActive.u32[i]) <<
+				"Active palette entry " << i << " is incorrect.";
+		}
+	} else {
+		for (int i = 0; i < count; i++) {
+			EXPECT_EQ(full->m_palActive.u16[i], palette->m_palActive.u16[i]) <<
+				"Active palette entry " << i << " is incorrect.";
+		}
+	}
+
+	if (cfg.palMode == VdpPalette::PALMODE_32X) {
+		for (int i = 0; i < 256; i++) {
+			if (cfg.bpp == MdFb::BPP_32) {
+				EXPECT_EQ(full->m_palActive32X.u32[i], palette->m_palActive32X.u32[i]) <<
+					"Active 32X palette entry " << i << " is incorrect.";
+			} else {
+				EXPECT_EQ(full->m_palActive32X.u16[i], palette->m_palActive32X.u16[i]) <<
+					"Active 32X palette entry " << i << " is incorrect.";
+			}
+		}
+	}
+
+	delete full;
+}
+
+/**
+ * Incremental updates must match a full recalculation in all modes.
+ */
+TEST_F(VdpPaletteTest, incrementalMatchesFull)
+{
+	static const PaletteConfig configs[] = {
+		{VdpPalette::PALMODE_MD,  0x03, false, MdFb::BPP_32},
+		{VdpPalette::PALMODE_MD,  0x03, true,  MdFb::BPP_32},
+		{VdpPalette::PALMODE_MD,  0x03, true,  MdFb::BPP_16},
+		{VdpPalette::PALMODE_MD,  0x03, true,  MdFb::BPP_15},
+		{VdpPalette::PALMODE_MD,  0x02, true,  MdFb::BPP_32},
+		{VdpPalette::PALMODE_MD,  0x01, false, MdFb::BPP_32},
+		{VdpPalette::PALMODE_32X, 0x03, true,  MdFb::BPP_32},
+		{VdpPalette::PALMODE_32X, 0x03, false, MdFb::BPP_16},
+		{VdpPalette::PALMODE_SMS, 0x01, false, MdFb::BPP_32},
+		{VdpPalette::PALMODE_SMS, 0x01, false, MdFb::BPP_16},
+		{VdpPalette::PALMODE_GG,  0x01, false, MdFb::BPP_32},
+		{VdpPalette::PALMODE_GG,  0x01, false, MdFb::BPP_15},
+	};
+
+	for (int i = 0; i < (int)(sizeof(configs)/sizeof(configs[0])); i++) {
+		SCOPED_TRACE(i);
+		VdpPalette *palette = new VdpPalette();
+		applyConfig(palette, configs[i]);
+		palette->update();
+
+		writeRandom(palette, 0x1234 + i);
+		checkAgainstFull(palette, configs[i]);
+		delete palette;
+	}
+}
+
+/**
+ * A CRam write must not mark the entire active palette as dirty.
+ * Only the written entry (and its derived entries) should change.
+ */
+TEST_F(VdpPaletteTest, singleWriteOnlyUpdatesEntry)
+{
+	VdpPalette *palette = new VdpPalette();
+	const PaletteConfig cfg = {VdpPalette::PALMODE_MD, 0x03, true, MdFb::BPP_32};
+	applyConfig(palette, cfg);
+	for (int i = 0; i < 0x80; i += 2) {
+		palette->writeCRam_16(i, 0x0EEE);
+	}
+	palette->update();
+	EXPECT_FALSE(palette->isDirty());
+
+	// Change color 0x25.
+	uint32_t before[256];
+	memcpy(before, palette->m_palActive.u32, sizeof(before));
+	palette->writeCRam_16(0x25 << 1, 0x0000);
+	EXPECT_TRUE(palette->isDirty());
+	palette->update();
+	EXPECT_FALSE(palette->isDirty());
+
+	for (int i = 0; i < 256; i++) {
+		if ((i & 0x3F) == 0x25) {
+			// Normal, shadow, highlight, and shadow+highlight.
+			EXPECT_NE(before[i], palette->m_palActive.u32[i]) <<
+				"Active palette entry " << i << " was not updated.";
+		} else {
+			EXPECT_EQ(before[i], palette->m_palActive.u32[i]) <<
+				"Active palette entry " << i << " was changed.";
+		}
+	}
+
+	checkAgainstFull(palette, cfg);
+	delete palette;
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: VdpPalette test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
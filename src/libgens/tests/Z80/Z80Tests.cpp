@@ -30,17 +30,16 @@
 // C includes. (C++ namespace)
 #include <cstdio>
 #include <cstring>
-using namespace std;
+
+// C++ includes.
+#include <string>
+using std::string;
 
 // NOTE: This test suite uses mdZ80 directly.
 // The Z80 class is currently hard-coded for MD only.
 
-// NOTE: Due to limitations in mdZ80 right now,
-// the first 8 KB must be RAM, and must be
-// accessible as Ram_Z80.
-extern "C" {
-	uint8_t Ram_Z80[65536];
-}
+// CP/M system memory.
+static uint8_t Ram_Z80[65536];
 
 namespace LibGens { namespace Tests {
 
@@ -63,6 +62,15 @@ class Z80Tests : public ::testing::Test
 		// System state.
 		bool halt;
 
+		// Program output.
+		string output;
+
+		/**
+		 * Run a ZEX program until it halts.
+		 * @param filename ZEX program filename.
+		 */
+		void runZex(const char *filename);
+
 		// FIXME: Pass the context in these functions.
 		static uint8_t FASTCALL Z80_ReadB_static(uint32_t adr) {
 			return curZ80Tests->Z80_ReadB(adr);
@@ -93,6 +101,7 @@ void Z80Tests::SetUp()
 	// Set the current Z80Tests.
 	curZ80Tests = this;
 	halt = false;
+	output.clear();
 
 	// Initialize Z80 memory.
 	memset(Ram_Z80, 0, sizeof(Ram_Z80));
@@ -160,14 +169,15 @@ void Z80Tests::Z80_OutB(uint32_t adr, uint8_t data)
 	switch (adr & 0xFF) {
 		case 0x01:
 			// stdout
-			// TODO: Lines beginning with '*' should be in red and trigger an error.
 			fputc(data, stdout);
+			output += (char)data;
 			break;
 
 		case 0x02:
 			// stderr
 			// TODO: Make this red?
 			fputc(data, stdout);
+			output += (char)data;
 			break;
 
 		case 0xFF:
@@ -177,58 +187,52 @@ void Z80Tests::Z80_OutB(uint32_t adr, uint8_t data)
 	}
 }
 
-/** Test cases. **/
-
 /**
- * Run ZEXDOC.
+ * Run a ZEX program until it halts.
+ * @param filename ZEX program filename.
  */
-TEST_F(Z80Tests, zexdoc)
+void Z80Tests::runZex(const char *filename)
 {
-	// Load ZEXDOC.
-	FILE *f = fopen("zexdoc.com", "rb");
+	// Load the ZEX program.
+	FILE *f = fopen(filename, "rb");
 	ASSERT_TRUE(f != nullptr);
 	fread(&Ram_Z80[0x0100], 1, 8585, f);
 	fclose(f);
 
 	// Run the Z80 until it's halted.
-	// TODO: Add function to mdZ80 to see if HALT instruction was used?
-	// For now, rely on port FFh.
+	// The BDOS writes to port FFh before halting.
 	mdZ80_set_PC(m_Z80, 0);
-
-	// TODO: Just check for HALTED status instead of using port 0xFF?
 	while (!halt && !(mdZ80_get_Status(m_Z80) & Z80_STATE_HALTED)) {
-		z80_Exec(m_Z80, 100);
+		z80_Exec(m_Z80, 1000000);
 		mdZ80_clear_odo(m_Z80);
 	}
 	printf("\n");
+	fflush(stdout);
+
+	// ZEX prints "ERROR" for each test with a CRC mismatch.
+	EXPECT_TRUE(halt);
+	EXPECT_NE(string::npos, output.find("Tests complete"));
+	EXPECT_EQ(string::npos, output.find("ERROR"));
+}
 
-	// TODO: If any errors occurred, fail the test.
+/** Test cases. **/
+
+/**
+ * Run ZEXDOC.
+ * This tests documented flags only.
+ */
+TEST_F(Z80Tests, zexdoc)
+{
+	ASSERT_NO_FATAL_FAILURE(runZex("zexdoc.com"));
 }
 
 /**
  * Run ZEXALL.
+ * This tests both documented and undocumented flags.
  */
 TEST_F(Z80Tests, zexall)
 {
-	// Load ZEXALL.
-	FILE *f = fopen("zexall.com", "rb");
-	ASSERT_TRUE(f != nullptr);
-	fread(&Ram_Z80[0x0100], 1, 8585, f);
-	fclose(f);
-
-	// Run the Z80 until it's halted.
-	// TODO: Add function to mdZ80 to see if HALT instruction was used?
-	// For now, rely on port FFh.
-	mdZ80_set_PC(m_Z80, 0);
-
-	// TODO: Just check for HALTED status instead of using port 0xFF?
-	while (!halt && !(mdZ80_get_Status(m_Z80) & Z80_STATE_HALTED)) {
-		z80_Exec(m_Z80, 100);
-		mdZ80_clear_odo(m_Z80);
-	}
-	printf("\n");
-
-	// TODO: If any errors occurred, fail the test.
+	ASSERT_NO_FATAL_FAILURE(runZex("zexall.com"));
 }
 
 } }
@@ -0,0 +1,195 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * BenchEmu.cpp: Whole-frame emulation benchmarks.                         *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "BenchSuite.hpp"
+
+// LibGens.
+#include "Rom.hpp"
+#include "EmuContext/EmuMD.hpp"
+#include "Vdp/Vdp.hpp"
+#include "Util/Capture.hpp"
+
+// C includes. (C++ namespace)
+#include <cstring>
+
+namespace LibGens { namespace Bench {
+
+/**
+ * Write a big-endian 16-bit value.
+ * @param p Destination.
+ * @param val Value.
+ */
+static inline void put_be16(uint8_t *p, uint16_t val)
+{
+	p[0] = (val >> 8);
+	p[1] = (val & 0xFF);
+}
+
+/**
+ * Write a big-endian 32-bit value.
+ * @param p Destination.
+ * @param val Value.
+ */
+static inline void put_be32(uint8_t *p, uint32_t val)
+{
+	put_be16(p, (val >> 16));
+	put_be16(p + 2, (val & 0xFFFF));
+}
+
+/**
+ * Generate the test ROM.
+ * This is a minimal MD program that enables the display
+ * and VBlank interrupts, then loops forever.
+ * @param buf Buffer. (Must be at least TEST_ROM_SIZE bytes.)
+ */
+void MakeTestRom(uint8_t *buf)
+{
+	memset(buf, 0xFF, TEST_ROM_SIZE);
+
+	// Vector table.
+	// All exceptions and interrupts go to an RTE.
+	static const uint32_t entry = 0x200;
+	static const uint32_t handler = 0x240;
+	put_be32(&buf[0x000], 0x00FFFE00);	// Initial SP
+	put_be32(&buf[0x004], entry);		// Initial PC
+	for (unsigned int i = 0x008; i < 0x100; i += 4) {
+		put_be32(&buf[i], handler);
+	}
+
+	// ROM header.
+	memset(&buf[0x100], ' ', 0x100);
+	memcpy(&buf[0x100], "SEGA MEGA DRIVE ", 16);
+	memcpy(&buf[0x110], "(C)GENS 2016.JAN", 16);
+	memcpy(&buf[0x120], "LIBGENS BENCHMARK TEST ROM", 26);
+	memcpy(&buf[0x150], "LIBGENS BENCHMARK TEST ROM", 26);
+	memcpy(&buf[0x180], "GM 00000000-00", 14);
+	memcpy(&buf[0x190], "J", 1);
+	put_be32(&buf[0x1A0], 0x000000);		// ROM start
+	put_be32(&buf[0x1A4], TEST_ROM_SIZE - 1);	// ROM end
+	put_be32(&buf[0x1A8], 0xFF0000);		// RAM start
+	put_be32(&buf[0x1AC], 0xFFFFFF);		// RAM end
+	memcpy(&buf[0x1F0], "JUE", 3);
+
+	// Program code.
+	static const uint16_t code[] = {
+		0x46FC, 0x2700,		// move.w #$2700, sr
+		0x41F9, 0x00C0, 0x0004,	// lea $C00004, a0
+		0x30BC, 0x8004,		// move.w #$8004, (a0)
+		0x30BC, 0x8174,		// move.w #$8174, (a0)	; Display, VINT, DMA, Mode 5
+		0x30BC, 0x8C81,		// move.w #$8C81, (a0)	; H40
+		0x46FC, 0x2000,		// move.w #$2000, sr
+		0x60FE,			// bra.s *
+	};
+	for (unsigned int i = 0; i < sizeof(code)/sizeof(code[0]); i++) {
+		put_be16(&buf[entry + (i * 2)], code[i]);
+	}
+	put_be16(&buf[handler], 0x4E73);	// rte
+
+	// Checksum.
+	uint16_t checksum = 0;
+	for (unsigned int i = 0x200; i < TEST_ROM_SIZE; i += 2) {
+		checksum += (buf[i] << 8) | buf[i + 1];
+	}
+	put_be16(&buf[0x18E], checksum);
+}
+
+/**
+ * Execute one frame.
+ * @param param EmuContext.
+ */
+static void benchExecFrame(void *param)
+{
+	static_cast<EmuContext*>(param)->execFrame();
+}
+
+/**
+ * Execute one frame without rendering.
+ * @param param EmuContext.
+ */
+static void benchExecFrameFast(void *param)
+{
+	static_cast<EmuContext*>(param)->execFrameFast();
+}
+
+struct CaptureBenchParam {
+	EmuContext *context;
+	Capture *capture;
+};
+
+/**
+ * Execute one frame and capture it.
+ * @param param CaptureBenchParam.
+ */
+static void benchExecFrameCapture(void *param)
+{
+	CaptureBenchParam *p = static_cast<CaptureBenchParam*>(param);
+	p->context->execFrame();
+	p->capture->frame(p->context->m_vdp->MD_Screen);
+}
+
+/**
+ * Emulation benchmarks: Whole-frame execution.
+ * @param suite Benchmark suite.
+ */
+void BenchEmu(BenchSuite *suite)
+{
+	static const char group[] = "emu";
+	if (!suite->isEnabled(group, "execFrame"))
+		return;
+
+	uint8_t *rom_data = new uint8_t[TEST_ROM_SIZE];
+	MakeTestRom(rom_data);
+	Rom *rom = new Rom(rom_data, TEST_ROM_SIZE);
+	EmuMD *context = new EmuMD(rom);
+	if (!context->isRomOpened()) {
+		suite->skip(group, "execFrame_md", "Unable to load the test ROM.");
+		suite->skip(group, "execFrameFast_md", "Unable to load the test ROM.");
+		suite->skip(group, "execFrame_md_capture", "Unable to load the test ROM.");
+	} else {
+		context->m_vdp->MD_Screen->setBpp(MdFb::BPP_32);
+		suite->run(group, "execFrame_md", 3000, benchExecFrame, context);
+		suite->run(group, "execFrameFast_md", 3000, benchExecFrameFast, context);
+
+		// Same as execFrame_md, with WAV, VGM, and video capture enabled.
+		// The output is discarded, so this only measures the cost of
+		// queueing the data on the emulation thread.
+#ifdef _WIN32
+		static const char nullDev[] = "NUL";
+#else
+		static const char nullDev[] = "/dev/null";
+#endif
+		Capture capture;
+		int ret = capture.start(nullDev, nullDev, nullDev, Capture::VIDEO_RAW_RGB24);
+		if (ret != 0) {
+			suite->skip(group, "execFrame_md_capture", "Unable to start capturing.");
+		} else {
+			CaptureBenchParam param = {context, &capture};
+			suite->run(group, "execFrame_md_capture", 3000, benchExecFrameCapture, &param);
+			capture.stop();
+		}
+	}
+
+	delete context;
+	delete rom;
+	delete[] rom_data;
+}
+
+} }
@@ -0,0 +1,241 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * BenchFile.cpp: ZOMG savestate and ROM loading benchmarks.               *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "BenchSuite.hpp"
+
+// LibGens.
+#include "Rom.hpp"
+#include "EmuContext/EmuMD.hpp"
+#include <libgensfile/config.libgensfile.h>
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstring>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#ifdef HAVE_MINIZIP
+#include "minizip/zip.h"
+#endif /* HAVE_MINIZIP */
+#endif /* HAVE_ZLIB */
+
+namespace LibGens { namespace Bench {
+
+/**
+ * Size of the ROM image used for ROM loading benchmarks.
+ * This is the test ROM padded with pseudo-random data
+ * so the archive benchmarks have something to decompress.
+ */
+static const unsigned int LOAD_ROM_SIZE = 1024*1024;
+
+/**
+ * ROM loading benchmark state.
+ */
+struct RomLoadBench {
+	const char *filename;
+	uint8_t *buf;
+};
+
+/**
+ * Load a ROM image.
+ * @param param RomLoadBench.
+ */
+static void benchRomLoad(void *param)
+{
+	RomLoadBench *const bench = static_cast<RomLoadBench*>(param);
+	Rom rom(bench->filename);
+	if (rom.isOpen()) {
+		rom.loadRom(bench->buf, LOAD_ROM_SIZE);
+	}
+}
+
+/**
+ * Save a ZOMG savestate.
+ * @param param EmuContext.
+ */
+static void benchZomgSave(void *param)
+{
+	static_cast<EmuContext*>(param)->zomgSave("libgens-bench.zomg");
+}
+
+/**
+ * Load a ZOMG savestate.
+ * @param param EmuContext.
+ */
+static void benchZomgLoad(void *param)
+{
+	static_cast<EmuContext*>(param)->zomgLoad("libgens-bench.zomg");
+}
+
+/**
+ * Write a ROM image as a plain binary file.
+ * @param filename Filename.
+ * @param data ROM data.
+ * @param size ROM size.
+ * @return 0 on success; non-zero on error.
+ */
+static int writeRomBin(const char *filename, const uint8_t *data, unsigned int size)
+{
+	FILE *f = fopen(filename, "wb");
+	if (!f)
+		return -1;
+	size_t ret = fwrite(data, 1, size, f);
+	fclose(f);
+	return (ret == size ? 0 : -1);
+}
+
+#ifdef HAVE_ZLIB
+/**
+ * Write a ROM image as a GZip file.
+ * @param filename Filename.
+ * @param data ROM data.
+ * @param size ROM size.
+ * @return 0 on success; non-zero on error.
+ */
+static int writeRomGz(const char *filename, const uint8_t *data, unsigned int size)
+{
+	gzFile gz = gzopen(filename, "wb");
+	if (!gz)
+		return -1;
+	int ret = gzwrite(gz, data, size);
+	gzclose(gz);
+	return (ret == (int)size ? 0 : -1);
+}
+
+#ifdef HAVE_MINIZIP
+/**
+ * Write a ROM image as a Zip file.
+ * @param filename Filename.
+ * @param data ROM data.
+ * @param size ROM size.
+ * @return 0 on success; non-zero on error.
+ */
+static int writeRomZip(const char *filename, const uint8_t *data, unsigned int size)
+{
+	zipFile zip = zipOpen(filename, APPEND_STATUS_CREATE);
+	if (!zip)
+		return -1;
+
+	zip_fileinfo zfi;
+	memset(&zfi, 0, sizeof(zfi));
+	int ret = zipOpenNewFileInZip(zip, "libgens-bench.bin", &zfi,
+			nullptr, 0, nullptr, 0, nullptr,
+			Z_DEFLATED, Z_DEFAULT_COMPRESSION);
+	if (ret == ZIP_OK) {
+		ret = zipWriteInFileInZip(zip, data, size);
+		zipCloseFileInZip(zip);
+	}
+	zipClose(zip, nullptr);
+	return (ret == ZIP_OK ? 0 : -1);
+}
+#endif /* HAVE_MINIZIP */
+#endif /* HAVE_ZLIB */
+
+/**
+ * File benchmarks: ZOMG save/load and ROM loading.
+ * @param suite Benchmark suite.
+ */
+void BenchFile(BenchSuite *suite)
+{
+	// Generate the ROM image.
+	uint8_t *rom_data = new uint8_t[LOAD_ROM_SIZE];
+	MakeTestRom(rom_data);
+	uint32_t lfsr = 0x12345678;
+	for (unsigned int i = TEST_ROM_SIZE; i < LOAD_ROM_SIZE; i++) {
+		// xorshift32; masked so the data is somewhat compressible.
+		lfsr ^= (lfsr << 13);
+		lfsr ^= (lfsr >> 17);
+		lfsr ^= (lfsr << 5);
+		rom_data[i] = (lfsr & 0x1F);
+	}
+
+	// ZOMG savestates.
+	static const char zomg_group[] = "zomg";
+	if (suite->isEnabled(zomg_group, "save") || suite->isEnabled(zomg_group, "load") ||
+	    suite->isEnabled(zomg_group, "save_v2") || suite->isEnabled(zomg_group, "load_v2")) {
+		Rom *rom = new Rom(rom_data, TEST_ROM_SIZE);
+		EmuMD *context = new EmuMD(rom);
+		if (!context->isRomOpened()) {
+			suite->skip(zomg_group, "save", "Unable to load the test ROM.");
+			suite->skip(zomg_group, "load", "Unable to load the test ROM.");
+			suite->skip(zomg_group, "save_v2", "Unable to load the test ROM.");
+			suite->skip(zomg_group, "load_v2", "Unable to load the test ROM.");
+		} else {
+			// Run a few frames so the state isn't all zeroes.
+			for (int i = 0; i < 10; i++) {
+				context->execFrame();
+			}
+			const int zomgVersion = EmuContext::ZomgVersion();
+			EmuContext::SetZomgVersion(1);
+			suite->run(zomg_group, "save", 500, benchZomgSave, context);
+			suite->run(zomg_group, "load", 500, benchZomgLoad, context);
+			EmuContext::SetZomgVersion(2);
+			suite->run(zomg_group, "save_v2", 500, benchZomgSave, context);
+			suite->run(zomg_group, "load_v2", 500, benchZomgLoad, context);
+			EmuContext::SetZomgVersion(zomgVersion);
+		}
+		delete context;
+		delete rom;
+		remove("libgens-bench.zomg");
+	}
+
+	// ROM loading.
+	static const char rom_group[] = "rom";
+	static const struct {
+		const char *name;
+		const char *filename;
+		int (*write)(const char *filename, const uint8_t *data, unsigned int size);
+	} formats[] = {
+		{"load_bin", "libgens-bench.bin", writeRomBin},
+#ifdef HAVE_ZLIB
+		{"load_gz", "libgens-bench.bin.gz", writeRomGz},
+#ifdef HAVE_MINIZIP
+		{"load_zip", "libgens-bench.zip", writeRomZip},
+#endif /* HAVE_MINIZIP */
+#endif /* HAVE_ZLIB */
+	};
+
+	uint8_t *buf = new uint8_t[LOAD_ROM_SIZE];
+	for (int i = 0; i < (int)(sizeof(formats)/sizeof(formats[0])); i++) {
+		if (!suite->isEnabled(rom_group, formats[i].name))
+			continue;
+		if (formats[i].write(formats[i].filename, rom_data, LOAD_ROM_SIZE) != 0) {
+			suite->skip(rom_group, formats[i].name, "Unable to write the test file.");
+			continue;
+		}
+
+		RomLoadBench bench;
+		bench.filename = formats[i].filename;
+		bench.buf = buf;
+		suite->run(rom_group, formats[i].name, 200, benchRomLoad, &bench);
+		remove(formats[i].filename);
+	}
+	delete[] buf;
+
+	// No encoders are available for these formats.
+	suite->skip(rom_group, "load_7z", "No 7-Zip encoder available.");
+	suite->skip(rom_group, "load_xz", "No XZ encoder available.");
+	suite->skip(rom_group, "load_rar", "No RAR encoder available.");
+
+	delete[] rom_data;
+}
+
+} }
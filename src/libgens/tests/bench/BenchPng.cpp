@@ -0,0 +1,192 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * BenchPng.cpp: PNG encoding benchmarks.                                  *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "BenchSuite.hpp"
+
+// LibGens.
+#include "Util/PngEncoder.hpp"
+
+// LibZomg.
+#include "libzomg/PngWriter.hpp"
+#include "libzomg/img_data.h"
+using LibZomg::PngWriter;
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstring>
+
+namespace LibGens { namespace Bench {
+
+static const char png_filename[] = "libgens-bench.png";
+
+// Number of images per queue benchmark iteration.
+static const int QUEUE_IMAGES = 8;
+
+/**
+ * Generate a test image.
+ * This is made of 8x8 tiles chosen from a small set,
+ * similar to MD graphics, so compression ratios are
+ * somewhat realistic.
+ * @param img 320x224 32-bit image.
+ */
+static void makeTestImage(uint32_t *img)
+{
+	static const int W = 320, H = 224;
+	static const uint32_t palette[16] = {
+		0x000000, 0x242424, 0x484848, 0x6C6C6C,
+		0xB40000, 0xFF2424, 0x00B400, 0x24FF24,
+		0x0000B4, 0x2424FF, 0xB4B400, 0xFFFF24,
+		0x00B4B4, 0x24FFFF, 0xB4B4B4, 0xFFFFFF,
+	};
+
+	// 64 tiles of random 4bpp pixels.
+	uint8_t tiles[64][64];
+	uint32_t lfsr = 0x12345678;
+	for (int t = 0; t < 64; t++) {
+		for (int i = 0; i < 64; i++) {
+			lfsr ^= (lfsr << 13);
+			lfsr ^= (lfsr >> 17);
+			lfsr ^= (lfsr << 5);
+			// Mostly low colors, like shaded graphics.
+			tiles[t][i] = ((lfsr & 3) == 0 ? (lfsr >> 8) & 15 : (lfsr >> 8) & 3);
+		}
+	}
+
+	for (int ty = 0; ty < H / 8; ty++) {
+		for (int tx = 0; tx < W / 8; tx++) {
+			// Upper half is a repeating "sky"; lower half uses all tiles.
+			const int t = (ty < H / 16 ? (tx & 1) : ((tx * 7 + ty * 13) & 63));
+			for (int y = 0; y < 8; y++) {
+				for (int x = 0; x < 8; x++) {
+					img[(ty * 8 + y) * W + (tx * 8 + x)] = palette[tiles[t][y * 8 + x]];
+				}
+			}
+		}
+	}
+}
+
+/**
+ * PNG benchmark state.
+ */
+struct PngBench {
+	Zomg_Img_Data_t img_data;
+	PngWriter *pngWriter;
+	PngEncoder *encoder;
+};
+
+/**
+ * Write a PNG image with PngWriter.
+ * @param param PngBench.
+ */
+static void benchPngWriter(void *param)
+{
+	PngBench *const bench = static_cast<PngBench*>(param);
+	bench->pngWriter->writeToFile(&bench->img_data, png_filename);
+}
+
+/**
+ * Write a PNG image with PngEncoder. (row-parallel)
+ * @param param PngBench.
+ */
+static void benchPngEncoderRows(void *param)
+{
+	PngBench *const bench = static_cast<PngBench*>(param);
+	bench->encoder->writeToFile(&bench->img_data, png_filename);
+}
+
+/**
+ * Queue several PNG images with PngEncoder and wait for them.
+ * @param param PngBench.
+ */
+static void benchPngEncoderQueue(void *param)
+{
+	PngBench *const bench = static_cast<PngBench*>(param);
+	char filename[32];
+	for (int i = 0; i < QUEUE_IMAGES; i++) {
+		snprintf(filename, sizeof(filename), "libgens-bench-%d.png", i);
+		bench->encoder->submit(&bench->img_data, filename);
+	}
+	bench->encoder->wait();
+}
+
+/**
+ * PNG benchmarks: PngWriter options and PngEncoder threading.
+ * @param suite Benchmark suite.
+ */
+void BenchPng(BenchSuite *suite)
+{
+	static const char group[] = "png";
+	uint32_t *img = new uint32_t[320*224];
+	makeTestImage(img);
+
+	PngBench bench;
+	memset(&bench.img_data, 0, sizeof(bench.img_data));
+	bench.img_data.data = img;
+	bench.img_data.w = 320;
+	bench.img_data.h = 224;
+	bench.img_data.pitch = 320 * sizeof(uint32_t);
+	bench.img_data.bpp = 32;
+	bench.img_data.phys_x = 4;
+	bench.img_data.phys_y = 4;
+
+	// Single-threaded PngWriter.
+	bench.pngWriter = new PngWriter();
+	bench.encoder = nullptr;
+	suite->run(group, "write_none_l5", 300, benchPngWriter, &bench);
+	bench.pngWriter->setCompressionLevel(1);
+	bench.pngWriter->setStrategy(PngWriter::STRATEGY_RLE);
+	suite->run(group, "write_none_l1_rle", 300, benchPngWriter, &bench);
+	bench.pngWriter->setCompressionLevel(6);
+	bench.pngWriter->setStrategy(PngWriter::STRATEGY_DEFAULT);
+	bench.pngWriter->setFilterMode(PngWriter::FILTER_SUB);
+	suite->run(group, "write_sub_l6", 300, benchPngWriter, &bench);
+	bench.pngWriter->setFilterMode(PngWriter::FILTER_ADAPTIVE);
+	suite->run(group, "write_adaptive_l6", 300, benchPngWriter, &bench);
+	delete bench.pngWriter;
+	bench.pngWriter = nullptr;
+
+	// PngEncoder with 1, 2, and 4 threads.
+	static const int thread_tbl[] = {1, 2, 4};
+	for (unsigned int i = 0; i < sizeof(thread_tbl)/sizeof(thread_tbl[0]); i++) {
+		const int threads = thread_tbl[i];
+		bench.encoder = new PngEncoder(threads);
+		bench.encoder->setCompressionLevel(6);
+		bench.encoder->setFilterMode(PngWriter::FILTER_SUB);
+
+		char name[32];
+		snprintf(name, sizeof(name), "rows_sub_l6_t%d", threads);
+		suite->run(group, name, 300, benchPngEncoderRows, &bench);
+		snprintf(name, sizeof(name), "queue%d_sub_l6_t%d", QUEUE_IMAGES, threads);
+		suite->run(group, name, 40, benchPngEncoderQueue, &bench);
+
+		delete bench.encoder;
+	}
+
+	remove(png_filename);
+	for (int i = 0; i < QUEUE_IMAGES; i++) {
+		char filename[32];
+		snprintf(filename, sizeof(filename), "libgens-bench-%d.png", i);
+		remove(filename);
+	}
+	delete[] img;
+}
+
+} }
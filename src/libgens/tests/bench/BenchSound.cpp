@@ -0,0 +1,244 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * BenchSound.cpp: YM2612 and PSG benchmarks.                              *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "BenchSuite.hpp"
+
+// LibGens sound.
+#include "sound/SoundMgr.hpp"
+
+// ARRAY_SIZE(x)
+#include "macros/common.h"
+// ALIGN()
+#include "libcompat/aligned_malloc.h"
+
+namespace LibGens { namespace Bench {
+
+/**
+ * Canned YM2612 register write.
+ * port: 0 == bank 0, 1 == bank 1
+ */
+struct YmWrite {
+	uint8_t port;
+	uint8_t reg;
+	uint8_t data;
+};
+
+/**
+ * YM2612 patch: Electric piano on all six channels.
+ * Operator registers are written for channels 0-2;
+ * the same patch is used for both banks.
+ */
+static const YmWrite ym_patch[] = {
+	{0, 0x22, 0x00},	// LFO off
+	{0, 0x27, 0x00},	// Channel 3 mode: normal
+	{0, 0x2B, 0x00},	// DAC off
+
+	// DT/MUL
+	{0, 0x30, 0x71}, {0, 0x34, 0x0D}, {0, 0x38, 0x33}, {0, 0x3C, 0x01},
+	{0, 0x31, 0x71}, {0, 0x35, 0x0D}, {0, 0x39, 0x33}, {0, 0x3D, 0x01},
+	{0, 0x32, 0x71}, {0, 0x36, 0x0D}, {0, 0x3A, 0x33}, {0, 0x3E, 0x01},
+	// TL
+	{0, 0x40, 0x23}, {0, 0x44, 0x2D}, {0, 0x48, 0x26}, {0, 0x4C, 0x00},
+	{0, 0x41, 0x23}, {0, 0x45, 0x2D}, {0, 0x49, 0x26}, {0, 0x4D, 0x00},
+	{0, 0x42, 0x23}, {0, 0x46, 0x2D}, {0, 0x4A, 0x26}, {0, 0x4E, 0x00},
+	// RS/AR
+	{0, 0x50, 0x5F}, {0, 0x54, 0x99}, {0, 0x58, 0x5F}, {0, 0x5C, 0x94},
+	{0, 0x51, 0x5F}, {0, 0x55, 0x99}, {0, 0x59, 0x5F}, {0, 0x5D, 0x94},
+	{0, 0x52, 0x5F}, {0, 0x56, 0x99}, {0, 0x5A, 0x5F}, {0, 0x5E, 0x94},
+	// AM/D1R
+	{0, 0x60, 0x05}, {0, 0x64, 0x05}, {0, 0x68, 0x05}, {0, 0x6C, 0x07},
+	{0, 0x61, 0x05}, {0, 0x65, 0x05}, {0, 0x69, 0x05}, {0, 0x6D, 0x07},
+	{0, 0x62, 0x05}, {0, 0x66, 0x05}, {0, 0x6A, 0x05}, {0, 0x6E, 0x07},
+	// D2R
+	{0, 0x70, 0x02}, {0, 0x74, 0x02}, {0, 0x78, 0x02}, {0, 0x7C, 0x02},
+	{0, 0x71, 0x02}, {0, 0x75, 0x02}, {0, 0x79, 0x02}, {0, 0x7D, 0x02},
+	{0, 0x72, 0x02}, {0, 0x76, 0x02}, {0, 0x7A, 0x02}, {0, 0x7E, 0x02},
+	// D1L/RR
+	{0, 0x80, 0x11}, {0, 0x84, 0x11}, {0, 0x88, 0x11}, {0, 0x8C, 0xA6},
+	{0, 0x81, 0x11}, {0, 0x85, 0x11}, {0, 0x89, 0x11}, {0, 0x8D, 0xA6},
+	{0, 0x82, 0x11}, {0, 0x86, 0x11}, {0, 0x8A, 0x11}, {0, 0x8E, 0xA6},
+	// Algorithm/Feedback, L/R/AMS/FMS
+	{0, 0xB0, 0x32}, {0, 0xB1, 0x32}, {0, 0xB2, 0x32},
+	{0, 0xB4, 0xC0}, {0, 0xB5, 0xC0}, {0, 0xB6, 0xC0},
+};
+
+/**
+ * YM2612 frequencies for the canned note sequence.
+ * Format: [block/fnum high, fnum low]
+ */
+static const uint8_t ym_notes[][2] = {
+	{0x22, 0x69},	// C4
+	{0x22, 0xB5},	// D4
+	{0x23, 0x0F},	// E4
+	{0x23, 0x44},	// F4
+	{0x23, 0xA8},	// G4
+	{0x24, 0x1A},	// A4
+	{0x24, 0x95},	// B4
+	{0x2A, 0x69},	// C5
+};
+
+/**
+ * PSG tone periods for the canned tone sequence. (10-bit)
+ */
+static const uint16_t psg_tones[] = {
+	0x1AE, 0x155, 0x11B, 0x0F2, 0x0DD, 0x0AA,
+};
+
+/**
+ * Sound benchmark state.
+ */
+struct SoundBench {
+	unsigned int frame;
+	int16_t ALIGN(16) out[SoundMgr::MAX_SEGMENT_SIZE * 2];
+};
+
+/**
+ * Write a register to the YM2612.
+ * @param port Port. (0 or 1)
+ * @param reg Register number.
+ * @param data Data.
+ */
+static inline void ymWrite(uint8_t port, uint8_t reg, uint8_t data)
+{
+	SoundMgr::ms_Ym2612.write(port * 2, reg);
+	SoundMgr::ms_Ym2612.write(port * 2 + 1, data);
+}
+
+/**
+ * Finish a frame by mixing the audio buffers into the output buffer.
+ * @param bench Sound benchmark state.
+ */
+static inline void finishFrame(SoundBench *bench)
+{
+	SoundMgr::SpecialUpdate();
+	SoundMgr::writeStereo(bench->out, SoundMgr::GetSegLength());
+	bench->frame++;
+}
+
+/**
+ * Run one NTSC frame of YM2612 synthesis.
+ * Notes are keyed on every 8 frames on all six channels.
+ * @param param SoundBench.
+ */
+static void benchYm2612Frame(void *param)
+{
+	SoundBench *const bench = static_cast<SoundBench*>(param);
+	SoundMgr::ResetPtrsAndLens();
+
+	for (int line = 0; line < 262; line++) {
+		if (line == 0 && (bench->frame & 7) == 0) {
+			// Key off all channels, then set new frequencies.
+			const uint8_t *note = ym_notes[(bench->frame >> 3) % ARRAY_SIZE(ym_notes)];
+			for (int ch = 0; ch < 3; ch++) {
+				ymWrite(0, 0x28, ch);
+				ymWrite(0, 0x28, ch | 4);
+				ymWrite(0, 0xA4 + ch, note[0]);
+				ymWrite(0, 0xA0 + ch, note[1]);
+				ymWrite(1, 0xA4 + ch, note[0] - 0x08);	// one octave lower
+				ymWrite(1, 0xA0 + ch, note[1]);
+			}
+		} else if (line == 16 && (bench->frame & 7) == 0) {
+			// Key on all channels.
+			for (int ch = 0; ch < 3; ch++) {
+				ymWrite(0, 0x28, 0xF0 | ch);
+				ymWrite(0, 0x28, 0xF0 | ch | 4);
+			}
+		}
+
+		const int writePos = SoundMgr::GetWritePos(line);
+		const int writeLen = SoundMgr::GetWriteLen(line);
+		SoundMgr::ms_Ym2612.updateDac(&SoundMgr::ms_SegBufL[writePos],
+					      &SoundMgr::ms_SegBufR[writePos], writeLen);
+		SoundMgr::ms_Ym2612.addWriteLen(writeLen);
+	}
+
+	finishFrame(bench);
+}
+
+/**
+ * Run one NTSC frame of PSG synthesis.
+ * Tones change every 4 frames, and volume is swept every 32 lines.
+ * @param param SoundBench.
+ */
+static void benchPsgFrame(void *param)
+{
+	SoundBench *const bench = static_cast<SoundBench*>(param);
+	SoundMgr::ResetPtrsAndLens();
+
+	for (int line = 0; line < 262; line++) {
+		if (line == 0 && (bench->frame & 3) == 0) {
+			const unsigned int idx = ((bench->frame >> 2) * 3);
+			for (int ch = 0; ch < 3; ch++) {
+				const uint16_t tone = psg_tones[(idx + ch) % ARRAY_SIZE(psg_tones)];
+				SoundMgr::ms_Psg.write(0x80 | (ch << 5) | (tone & 0x0F));
+				SoundMgr::ms_Psg.write((tone >> 4) & 0x3F);
+			}
+			// Periodic noise using channel 2's tone.
+			SoundMgr::ms_Psg.write(0xE3);
+		}
+		if ((line & 31) == 0) {
+			// Volume sweep.
+			const uint8_t vol = ((line >> 5) + bench->frame) & 0x0F;
+			SoundMgr::ms_Psg.write(0x90 | vol);
+			SoundMgr::ms_Psg.write(0xB0 | (vol ^ 0x0F));
+			SoundMgr::ms_Psg.write(0xD0 | (vol >> 1));
+			SoundMgr::ms_Psg.write(0xF0 | (vol >> 2));
+		}
+
+		SoundMgr::ms_Psg.addWriteLen(SoundMgr::GetWriteLen(line));
+	}
+
+	finishFrame(bench);
+}
+
+/**
+ * Sound benchmarks: YM2612 and PSG synthesis.
+ * @param suite Benchmark suite.
+ */
+void BenchSound(BenchSuite *suite)
+{
+	static const char group[] = "sound";
+	static const int rates[] = {44100, 48000};
+
+	SoundBench *bench = (SoundBench*)aligned_malloc(16, sizeof(SoundBench));
+	for (int i = 0; i < (int)ARRAY_SIZE(rates); i++) {
+		SoundMgr::ReInit(rates[i], false);
+		for (int j = 0; j < (int)ARRAY_SIZE(ym_patch); j++) {
+			ymWrite(0, ym_patch[j].reg, ym_patch[j].data);
+			if (ym_patch[j].reg >= 0x30) {
+				ymWrite(1, ym_patch[j].reg, ym_patch[j].data);
+			}
+		}
+
+		// One iteration == one frame.
+		char name[64];
+		bench->frame = 0;
+		snprintf(name, sizeof(name), "ym2612_frame_%d", rates[i]);
+		suite->run(group, name, 5000, benchYm2612Frame, bench);
+
+		bench->frame = 0;
+		snprintf(name, sizeof(name), "psg_frame_%d", rates[i]);
+		suite->run(group, name, 5000, benchPsgFrame, bench);
+	}
+	aligned_free(bench);
+}
+
+} }
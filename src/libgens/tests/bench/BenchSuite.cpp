@@ -0,0 +1,235 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * BenchSuite.cpp: Benchmark suite.                                        *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "BenchSuite.hpp"
+
+// LibGens.
+#include <libgens/config.libgens.h>
+#include "lg_main.hpp"
+#include "Util/Profiler.hpp"
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstring>
+
+// C++ includes.
+#include <algorithm>
+using std::string;
+using std::vector;
+
+namespace LibGens { namespace Bench {
+
+BenchSuite::BenchSuite()
+	: m_quick(false)
+	, m_snapshotFile("test-zomg/test.zomg")
+{ }
+
+/**
+ * Benchmark filter.
+ * If set, only benchmarks whose "group.name"
+ * contains this string will be run.
+ */
+void BenchSuite::setFilter(const char *filter)
+{
+	if (filter) {
+		m_filter = filter;
+	} else {
+		m_filter.clear();
+	}
+}
+
+/**
+ * Check if a benchmark should be run.
+ * @param group Benchmark group.
+ * @param name Benchmark name.
+ * @return True if the benchmark should be run.
+ */
+bool BenchSuite::isEnabled(const char *group, const char *name) const
+{
+	if (m_filter.empty())
+		return true;
+
+	string fullName(group);
+	fullName += '.';
+	fullName += name;
+	return (fullName.find(m_filter) != string::npos);
+}
+
+/**
+ * Record a benchmark as skipped.
+ * @param group Benchmark group.
+ * @param name Benchmark name.
+ * @param reason Reason for skipping the benchmark.
+ */
+void BenchSuite::skip(const char *group, const char *name, const char *reason)
+{
+	if (!isEnabled(group, name))
+		return;
+
+	Result result;
+	result.group = group;
+	result.name = name;
+	result.skipped = reason;
+	result.iterations = 0;
+	result.total = 0;
+	result.min = 0;
+	result.max = 0;
+	result.median = 0;
+	m_results.push_back(result);
+
+	fprintf(stderr, "%-10s %-28s skipped: %s\n", group, name, reason);
+}
+
+/**
+ * Run a benchmark.
+ * Each iteration is timed separately.
+ * @param group Benchmark group.
+ * @param name Benchmark name.
+ * @param iterations Number of iterations. (reduced in quick mode)
+ * @param func Function to run once per iteration.
+ * @param param Parameter for func.
+ */
+void BenchSuite::run(const char *group, const char *name, unsigned int iterations,
+		     BenchFn func, void *param)
+{
+	if (!isEnabled(group, name))
+		return;
+	if (m_quick) {
+		iterations /= 100;
+	}
+	if (iterations == 0) {
+		iterations = 1;
+	}
+
+	// Warm up the caches.
+	func(param);
+
+	vector<uint64_t> times;
+	times.reserve(iterations);
+	for (unsigned int i = 0; i < iterations; i++) {
+		const uint64_t start = Profiler::Now();
+		func(param);
+		times.push_back(Profiler::Now() - start);
+	}
+
+	Result result;
+	result.group = group;
+	result.name = name;
+	result.iterations = iterations;
+	result.total = 0;
+	for (vector<uint64_t>::const_iterator iter = times.begin();
+	     iter != times.end(); ++iter)
+	{
+		result.total += *iter;
+	}
+
+	std::sort(times.begin(), times.end());
+	result.min = times.front();
+	result.max = times.back();
+	result.median = times[times.size() / 2];
+	m_results.push_back(result);
+
+	fprintf(stderr, "%-10s %-28s %8u iter, median %10.3f us, min %10.3f us\n",
+		group, name, result.iterations,
+		(double)result.median / 1000.0, (double)result.min / 1000.0);
+}
+
+/**
+ * Write a JSON string, escaping special characters.
+ * @param f File.
+ * @param str String.
+ */
+static void fputs_json(FILE *f, const string &str)
+{
+	fputc('"', f);
+	for (string::const_iterator iter = str.begin(); iter != str.end(); ++iter) {
+		const char chr = *iter;
+		switch (chr) {
+			case '"':	fputs("\\\"", f); break;
+			case '\\':	fputs("\\\\", f); break;
+			case '\n':	fputs("\\n", f); break;
+			case '\t':	fputs("\\t", f); break;
+			default:
+				if ((unsigned char)chr < 0x20) {
+					fprintf(f, "\\u%04X", (unsigned char)chr);
+				} else {
+					fputc(chr, f);
+				}
+				break;
+		}
+	}
+	fputc('"', f);
+}
+
+/**
+ * Write the benchmark results as JSON.
+ * @param f File to write to.
+ * @return 0 on success; negative errno on error.
+ */
+int BenchSuite::writeJson(FILE *f) const
+{
+	if (!f)
+		return -EINVAL;
+
+	fputs("{\n\t\"suite\": \"libgens-bench\",\n\t\"version\": ", f);
+	fputs_json(f, string(LibGens::version));
+	fputs(",\n\t\"vcs\": ", f);
+	if (LibGens::version_vcs) {
+		fputs_json(f, string(LibGens::version_vcs));
+	} else {
+		fputs("null", f);
+	}
+#ifdef GENS_ENABLE_EMULATION
+	fputs(",\n\t\"emulation\": true", f);
+#else
+	fputs(",\n\t\"emulation\": false", f);
+#endif
+	fprintf(f, ",\n\t\"quick\": %s", (m_quick ? "true" : "false"));
+	fputs(",\n\t\"benchmarks\": [", f);
+
+	for (size_t i = 0; i < m_results.size(); i++) {
+		const Result &result = m_results[i];
+		fputs(i == 0 ? "\n\t\t{" : ",\n\t\t{", f);
+		fputs("\"group\": ", f);
+		fputs_json(f, result.group);
+		fputs(", \"name\": ", f);
+		fputs_json(f, result.name);
+		if (!result.skipped.empty()) {
+			fputs(", \"skipped\": ", f);
+			fputs_json(f, result.skipped);
+		} else {
+			// NOTE: Using %llu for compatibility with older MSVC.
+			fprintf(f, ", \"iterations\": %u, \"total_ns\": %llu"
+				", \"median_ns\": %llu, \"min_ns\": %llu, \"max_ns\": %llu",
+				result.iterations,
+				(unsigned long long)result.total,
+				(unsigned long long)result.median,
+				(unsigned long long)result.min,
+				(unsigned long long)result.max);
+		}
+		fputc('}', f);
+	}
+
+	fputs("\n\t]\n}\n", f);
+	return (ferror(f) ? -EIO : 0);
+}
+
+} }
@@ -0,0 +1,200 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * BenchSuite.hpp: Benchmark suite.                                        *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_TESTS_BENCH_BENCHSUITE_HPP__
+#define __LIBGENS_TESTS_BENCH_BENCHSUITE_HPP__
+
+// C includes.
+#include <stdint.h>
+// C includes. (C++ namespace)
+#include <cstdio>
+
+// C++ includes.
+#include <string>
+#include <vector>
+
+namespace LibGens { namespace Bench {
+
+class BenchSuite
+{
+	public:
+		BenchSuite();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		BenchSuite(const BenchSuite &);
+		BenchSuite &operator=(const BenchSuite &);
+
+	public:
+		/**
+		 * Benchmark result.
+		 * Times are in nanoseconds.
+		 */
+		struct Result {
+			std::string group;	// Benchmark group, e.g. "vdp".
+			std::string name;	// Benchmark name, e.g. "m5_H40_32bpp".
+			std::string skipped;	// If not empty, reason for skipping.
+			unsigned int iterations;
+			uint64_t total;
+			uint64_t min;
+			uint64_t max;
+			uint64_t median;
+		};
+
+		/**
+		 * Quick mode: Run each benchmark for a fraction of
+		 * the requested iterations. Used by the test suite
+		 * to verify that all benchmarks still work.
+		 */
+		bool quick(void) const { return m_quick; }
+		void setQuick(bool quick) { m_quick = quick; }
+
+		/**
+		 * VDP snapshot for the rendering benchmarks.
+		 * This is a ZOMG savestate, e.g. test-zomg/test.zomg.
+		 */
+		const char *snapshotFile(void) const { return m_snapshotFile.c_str(); }
+		void setSnapshotFile(const char *snapshotFile) { m_snapshotFile = snapshotFile; }
+
+		/**
+		 * Benchmark filter.
+		 * If set, only benchmarks whose "group.name"
+		 * contains this string will be run.
+		 */
+		void setFilter(const char *filter);
+
+		/**
+		 * Check if a benchmark should be run.
+		 * @param group Benchmark group.
+		 * @param name Benchmark name.
+		 * @return True if the benchmark should be run.
+		 */
+		bool isEnabled(const char *group, const char *name) const;
+
+		/**
+		 * Benchmark function.
+		 * Called once per iteration.
+		 * @param param User-specified parameter.
+		 */
+		typedef void (*BenchFn)(void *param);
+
+		/**
+		 * Run a benchmark.
+		 * Each iteration is timed separately.
+		 * @param group Benchmark group.
+		 * @param name Benchmark name.
+		 * @param iterations Number of iterations. (reduced in quick mode)
+		 * @param func Function to run once per iteration.
+		 * @param param Parameter for func.
+		 */
+		void run(const char *group, const char *name, unsigned int iterations,
+			 BenchFn func, void *param);
+
+		/**
+		 * Record a benchmark as skipped.
+		 * @param group Benchmark group.
+		 * @param name Benchmark name.
+		 * @param reason Reason for skipping the benchmark.
+		 */
+		void skip(const char *group, const char *name, const char *reason);
+
+		/**
+		 * Get the benchmark results.
+		 * @return Benchmark results.
+		 */
+		const std::vector<Result> &results(void) const { return m_results; }
+
+		/**
+		 * Write the benchmark results as JSON.
+		 * @param f File to write to.
+		 * @return 0 on success; negative errno on error.
+		 */
+		int writeJson(FILE *f) const;
+
+	private:
+		bool m_quick;
+		std::string m_snapshotFile;
+		std::string m_filter;
+		std::vector<Result> m_results;
+};
+
+/** Test data. **/
+
+/**
+ * Size of the generated test ROM.
+ */
+static const unsigned int TEST_ROM_SIZE = 128*1024;
+
+/**
+ * Generate the test ROM.
+ * This is a minimal MD program that enables the display
+ * and VBlank interrupts, then loops forever.
+ * @param buf Buffer. (Must be at least TEST_ROM_SIZE bytes.)
+ */
+void MakeTestRom(uint8_t *buf);
+
+/** Benchmark groups. **/
+
+/**
+ * VDP benchmarks: Line rendering and DMA.
+ * @param suite Benchmark suite.
+ */
+void BenchVdp(BenchSuite *suite);
+
+/**
+ * Palette benchmarks: Full palette recalculation.
+ * @param suite Benchmark suite.
+ */
+void BenchPalette(BenchSuite *suite);
+
+/**
+ * Sound benchmarks: YM2612 and PSG synthesis.
+ * @param suite Benchmark suite.
+ */
+void BenchSound(BenchSuite *suite);
+
+/**
+ * Z80 benchmarks: Interpreter throughput on the MD bus.
+ * @param suite Benchmark suite.
+ */
+void BenchZ80(BenchSuite *suite);
+
+/**
+ * File benchmarks: ZOMG save/load and ROM loading.
+ * @param suite Benchmark suite.
+ */
+void BenchFile(BenchSuite *suite);
+
+/**
+ * PNG benchmarks: PngWriter options and PngEncoder threading.
+ * @param suite Benchmark suite.
+ */
+void BenchPng(BenchSuite *suite);
+
+/**
+ * Emulation benchmarks: Whole-frame execution.
+ * @param suite Benchmark suite.
+ */
+void BenchEmu(BenchSuite *suite);
+
+} }
+
+#endif /* __LIBGENS_TESTS_BENCH_BENCHSUITE_HPP__ */
@@ -0,0 +1,434 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * BenchVdp.cpp: VDP and palette benchmarks.                               *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "BenchSuite.hpp"
+
+// LibGens VDP.
+#include "Vdp/Vdp.hpp"
+#include "Vdp/VdpPalette.hpp"
+
+// M68K RAM. (DMA source)
+#include "cpu/M68K_Mem.hpp"
+
+// ARRAY_SIZE(x)
+#include "macros/common.h"
+
+// VDP snapshots are loaded from ZOMG savestates.
+#include "libzomg/Zomg.hpp"
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace LibGens { namespace Bench {
+
+/**
+ * Load the Mode 5 VDP snapshot into a VDP.
+ * The snapshot is loaded from a ZOMG savestate, e.g. test-zomg/test.zomg.
+ * Only the VDP registers, VRam, CRam, and VSRam are used.
+ * @param vdp VDP.
+ * @param filename ZOMG savestate.
+ * @param h40 If true, use H40; otherwise, use H32.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+static int loadSnapshotM5(Vdp *vdp, const char *filename, bool h40)
+{
+	LibZomg::Zomg zomg(filename, LibZomg::Zomg::ZOMG_LOAD);
+	if (!zomg.isOpen())
+		return -ENOENT;
+
+	uint8_t vdp_reg[24];
+	int ret = zomg.loadVdpReg(vdp_reg, sizeof(vdp_reg));
+	if (ret != (int)sizeof(vdp_reg))
+		return -EIO;
+	if (!(vdp_reg[0x01] & 0x04)) {
+		// Not Mode 5.
+		return -EINVAL;
+	}
+
+	uint16_t *vram = (uint16_t*)malloc(0x10000);
+	ret = zomg.loadVRam(vram, 0x10000, ZOMG_BYTEORDER_16H);
+	if (ret != 0x10000) {
+		free(vram);
+		return -EIO;
+	}
+
+	// CRam and VSRam are optional.
+	Zomg_CRam_t cram;
+	memset(&cram, 0, sizeof(cram));
+	zomg.loadCRam(&cram, ZOMG_BYTEORDER_16H);
+	uint16_t vsram[40];
+	memset(vsram, 0, sizeof(vsram));
+	zomg.loadMD_VSRam(vsram, sizeof(vsram), ZOMG_BYTEORDER_16H);
+
+	// Override the horizontal resolution.
+	vdp_reg[0x0C] &= ~0x81;
+	if (h40)
+		vdp_reg[0x0C] |= 0x81;
+
+	vdp->setNtsc();
+	for (int i = 0; i < (int)sizeof(vdp_reg); i++) {
+		vdp->dbg_setReg(i, vdp_reg[i]);
+	}
+
+	// NOTE: VRam must be written after the registers
+	// so the sprite attribute table cache is updated.
+	vdp->dbg_writeVRam_16(0, vram, 0x10000);
+	vdp->dbg_writeCRam_16(0, cram.md, sizeof(cram.md));
+	vdp->dbg_writeVSRam_16(0, vsram, sizeof(vsram));
+	free(vram);
+	return 0;
+}
+
+/**
+ * Set up a sprite-heavy Mode 5 screen.
+ * All 80 sprites are linked, and they're spread out vertically,
+ * so only a few sprites are visible on each line.
+ * @param vdp VDP.
+ */
+static void loadSpritesM5(Vdp *vdp)
+{
+	vdp->setNtsc();
+	vdp->dbg_setReg(0x00, 0x04);	// Enable the palette. (?)
+	vdp->dbg_setReg(0x01, 0x44);	// Enable the display, set Mode 5.
+	vdp->dbg_setReg(0x02, 0x30);	// Set scroll A name table base to 0xC000.
+	vdp->dbg_setReg(0x04, 0x05);	// Set scroll B name table base to 0xA000.
+	vdp->dbg_setReg(0x05, 0x70);	// Set the sprite table base to 0xE000.
+	vdp->dbg_setReg(0x0C, 0x81);	// H40
+	vdp->dbg_setReg(0x0D, 0x3F);	// Set the HScroll table base to 0xFC00.
+	vdp->dbg_setReg(0x10, 0x01);	// Set the scroll size to V32 H64.
+	vdp->dbg_setReg(0x0F, 0x02);	// Set the auto-increment value to 2.
+
+	uint16_t cram[64];
+	for (int i = 0; i < (int)ARRAY_SIZE(cram); i++) {
+		cram[i] = (uint16_t)((i * 0x0246) & 0x0EEE);
+	}
+	vdp->dbg_writeCRam_16(0, cram, sizeof(cram));
+
+	// Patterns: 0x0000-0x9FFF
+	// Name tables are left empty.
+	uint16_t *vram = (uint16_t*)calloc(0x10000, 1);
+	for (unsigned int i = 0; i < (0xA000 >> 1); i++) {
+		vram[i] = (uint16_t)(i * 0x9E37);
+	}
+
+	// Sprite Attribute Table: 0xE000
+	uint16_t *sat = &vram[0xE000 >> 1];
+	for (int i = 0; i < 80; i++, sat += 4) {
+		sat[0] = 128 + ((i * 37) % 232);		// Y position
+		sat[1] = (((i & 3) << 10) | ((i & 1) << 8));	// Size
+		sat[1] |= (i < 79 ? (i + 1) : 0);		// Link
+		sat[2] = (uint16_t)(0x0010 + (i * 4));		// Tile number
+		sat[3] = 128 + ((i * 53) % 320);		// X position
+	}
+	vdp->dbg_writeVRam_16(0, vram, 0x10000);
+	free(vram);
+}
+
+/**
+ * Render a full frame.
+ * @param vdp VDP.
+ */
+static void renderFrame(Vdp *vdp)
+{
+	vdp->updateVdpLines(true);
+	for (; vdp->VDP_Lines.currentLine < vdp->VDP_Lines.totalDisplayLines;
+	     vdp->VDP_Lines.currentLine++)
+	{
+		vdp->renderLine();
+	}
+}
+
+/**
+ * Render a full frame.
+ * @param param Vdp.
+ */
+static void benchRenderFrame(void *param)
+{
+	renderFrame(static_cast<Vdp*>(param));
+}
+
+/**
+ * Set a VDP register using the control port.
+ * @param vdp VDP.
+ * @param reg Register number.
+ * @param val Register value.
+ */
+static inline void writeReg(Vdp *vdp, uint8_t reg, uint8_t val)
+{
+	vdp->writeCtrlMD(0x8000 | (reg << 8) | val);
+}
+
+/**
+ * DMA FILL: 64 KB of VRAM.
+ * @param param Vdp.
+ */
+static void benchDmaFill(void *param)
+{
+	Vdp *const vdp = static_cast<Vdp*>(param);
+	writeReg(vdp, 0x0F, 0x01);	// Auto-increment: 1
+	writeReg(vdp, 0x13, 0x00);	// Length: 65536
+	writeReg(vdp, 0x14, 0x00);
+	writeReg(vdp, 0x17, 0x80);	// DMA FILL
+	vdp->writeCtrlMD(0x4000);	// VRAM write, address 0x0000
+	vdp->writeCtrlMD(0x0080);	// CD5: DMA
+	vdp->writeDataMD(0x5A5A);
+}
+
+/**
+ * DMA COPY: 32 KB from 0x0000 to 0x8000.
+ * @param param Vdp.
+ */
+static void benchDmaCopy(void *param)
+{
+	Vdp *const vdp = static_cast<Vdp*>(param);
+	writeReg(vdp, 0x0F, 0x01);	// Auto-increment: 1
+	writeReg(vdp, 0x13, 0x00);	// Length: 32768
+	writeReg(vdp, 0x14, 0x80);
+	writeReg(vdp, 0x15, 0x00);	// Source: 0x0000
+	writeReg(vdp, 0x16, 0x00);
+	writeReg(vdp, 0x17, 0xC0);	// DMA COPY
+	vdp->writeCtrlMD(0x0000);	// VRAM copy, address 0x8000
+	vdp->writeCtrlMD(0x00C2);	// CD5, CD4: DMA COPY
+}
+
+/**
+ * Set up a 68000-to-VDP DMA transfer from M68K RAM.
+ * @param vdp Vdp.
+ * @param length Length, in words.
+ */
+static inline void setupDma68k(Vdp *vdp, uint16_t length)
+{
+	writeReg(vdp, 0x0F, 0x02);	// Auto-increment: 2
+	writeReg(vdp, 0x13, (length & 0xFF));
+	writeReg(vdp, 0x14, (length >> 8));
+	writeReg(vdp, 0x15, 0x00);	// Source: 0xFF0000
+	writeReg(vdp, 0x16, 0x80);
+	writeReg(vdp, 0x17, 0x7F);
+}
+
+/**
+ * 68000-to-VRAM DMA: 64 KB from M68K RAM.
+ * @param param Vdp.
+ */
+static void benchDma68kVRam(void *param)
+{
+	Vdp *const vdp = static_cast<Vdp*>(param);
+	setupDma68k(vdp, 0x8000);
+	vdp->writeCtrlMD(0x4000);	// VRAM write, address 0x0000
+	vdp->writeCtrlMD(0x0080);	// CD5: DMA
+}
+
+/**
+ * 68000-to-CRAM DMA: 128 bytes from M68K RAM.
+ * @param param Vdp.
+ */
+static void benchDma68kCRam(void *param)
+{
+	Vdp *const vdp = static_cast<Vdp*>(param);
+	setupDma68k(vdp, 0x40);
+	vdp->writeCtrlMD(0xC000);	// CRAM write, address 0x00
+	vdp->writeCtrlMD(0x0080);	// CD5: DMA
+}
+
+/**
+ * 68000-to-VSRAM DMA: 80 bytes from M68K RAM.
+ * @param param Vdp.
+ */
+static void benchDma68kVSRam(void *param)
+{
+	Vdp *const vdp = static_cast<Vdp*>(param);
+	setupDma68k(vdp, 0x28);
+	vdp->writeCtrlMD(0x4000);	// VSRAM write, address 0x00
+	vdp->writeCtrlMD(0x0090);	// CD5, CD2: DMA
+}
+
+/**
+ * VDP benchmarks: Line rendering and DMA.
+ * @param suite Benchmark suite.
+ */
+void BenchVdp(BenchSuite *suite)
+{
+	static const char group[] = "vdp";
+	static const struct {
+		MdFb::ColorDepth bpp;
+		const char *name;
+	} depths[] = {
+		{MdFb::BPP_15, "15bpp"},
+		{MdFb::BPP_16, "16bpp"},
+		{MdFb::BPP_32, "32bpp"},
+	};
+
+	// Mode 5 rendering.
+	for (int h40 = 0; h40 <= 1; h40++) {
+		for (int i = 0; i < (int)ARRAY_SIZE(depths); i++) {
+			char name[64];
+			snprintf(name, sizeof(name), "m5_%s_%s",
+				 (h40 ? "H40" : "H32"), depths[i].name);
+			if (!suite->isEnabled(group, name))
+				continue;
+
+			Vdp *vdp = new Vdp();
+			vdp->MD_Screen->setBpp(depths[i].bpp);
+			if (loadSnapshotM5(vdp, suite->snapshotFile(), !!h40) != 0) {
+				suite->skip(group, name, "Unable to load the VDP snapshot.");
+			} else {
+				// One iteration == one frame.
+				suite->run(group, name, 2000, benchRenderFrame, vdp);
+			}
+			delete vdp;
+		}
+	}
+
+	// Mode 5 rendering with 80 sprites.
+	if (suite->isEnabled(group, "m5_sprites_H40_32bpp")) {
+		Vdp *vdp = new Vdp();
+		vdp->MD_Screen->setBpp(MdFb::BPP_32);
+		loadSpritesM5(vdp);
+		suite->run(group, "m5_sprites_H40_32bpp", 2000, benchRenderFrame, vdp);
+		delete vdp;
+	}
+
+	// TODO: Mode 4 and TMS9918 rendering are not wired into
+	// Vdp::renderLine() yet, so there's nothing to measure.
+	suite->skip(group, "m4", "Mode 4 rendering is not implemented.");
+	suite->skip(group, "tms", "TMS9918 rendering is not implemented.");
+
+	// DMA benchmarks.
+	Vdp *vdp = new Vdp();
+	vdp->setNtsc();
+	vdp->dbg_setReg(0x01, 0x54);	// Enable the display and DMA, set Mode 5.
+	vdp->dbg_setReg(0x0C, 0x81);	// H40
+
+	suite->run(group, "dma_fill_vram_64k", 2000, benchDmaFill, vdp);
+	suite->run(group, "dma_copy_vram_32k", 2000, benchDmaCopy, vdp);
+
+	// 68000-to-VDP DMA uses M68K RAM as the source.
+	for (int i = 0; i < (int)ARRAY_SIZE(Ram_68k.u16); i++) {
+		Ram_68k.u16[i] = (uint16_t)(i * 0x3579);
+	}
+	suite->run(group, "dma_68k_vram_64k", 2000, benchDma68kVRam, vdp);
+	suite->run(group, "dma_68k_cram", 100000, benchDma68kCRam, vdp);
+	suite->run(group, "dma_68k_vsram", 100000, benchDma68kVSRam, vdp);
+	delete vdp;
+}
+
+/**
+ * Palette benchmark state.
+ */
+struct PaletteBench {
+	VdpPalette *palette;
+	MdFb::ColorDepth bpp;
+	MdFb::ColorDepth bpp_alt;
+	uint8_t cram_idx;
+};
+
+/**
+ * Recalculate the full palette.
+ * Switching the color depth back and forth marks
+ * the full palette as dirty without changing it.
+ * @param param PaletteBench.
+ */
+static void benchPaletteRecalc(void *param)
+{
+	PaletteBench *const bench = static_cast<PaletteBench*>(param);
+	bench->palette->setBpp(bench->bpp_alt);
+	bench->palette->setBpp(bench->bpp);
+	bench->palette->update();
+}
+
+/**
+ * Write one CRam color and update the active palette.
+ * This is what a mid-frame palette change does.
+ * @param param PaletteBench.
+ */
+static void benchPaletteCRamWrite(void *param)
+{
+	PaletteBench *const bench = static_cast<PaletteBench*>(param);
+	const uint8_t idx = (bench->cram_idx++ & 0x3F);
+	bench->palette->writeCRam_16(idx << 1, (uint16_t)(idx * 0x0421));
+	bench->palette->update();
+}
+
+/**
+ * Palette benchmarks: Full palette recalculation and CRam writes.
+ * @param suite Benchmark suite.
+ */
+void BenchPalette(BenchSuite *suite)
+{
+	static const char group[] = "palette";
+	static const struct {
+		MdFb::ColorDepth bpp;
+		const char *name;
+	} depths[] = {
+		{MdFb::BPP_15, "15bpp"},
+		{MdFb::BPP_16, "16bpp"},
+		{MdFb::BPP_32, "32bpp"},
+	};
+	static const struct {
+		VdpPalette::PalMode_t palMode;
+		const char *name;
+	} palModes[] = {
+		{VdpPalette::PALMODE_MD,	"md"},
+		{VdpPalette::PALMODE_SMS,	"sms"},
+		{VdpPalette::PALMODE_GG,	"gg"},
+		{VdpPalette::PALMODE_32X,	"32x"},
+	};
+
+	PaletteBench bench;
+	VdpPalette *palette = new VdpPalette();
+	for (int i = 0; i < 64; i++) {
+		palette->writeCRam_16(i * 2, (uint16_t)(i * 0x0421));
+	}
+	bench.palette = palette;
+	bench.cram_idx = 0;
+
+	for (int m = 0; m < (int)ARRAY_SIZE(palModes); m++) {
+		for (int i = 0; i < (int)ARRAY_SIZE(depths); i++) {
+			char name[64];
+			snprintf(name, sizeof(name), "recalc_%s_%s",
+				 palModes[m].name, depths[i].name);
+
+			palette->setPalMode(palModes[m].palMode);
+			palette->setM5M4bits(0x03);
+			bench.bpp = depths[i].bpp;
+			bench.bpp_alt = depths[(i + 1) % ARRAY_SIZE(depths)].bpp;
+			suite->run(group, name, 2000, benchPaletteRecalc, &bench);
+		}
+	}
+
+	// Mid-frame CRam writes. (MD, Shadow/Highlight enabled)
+	palette->setPalMode(VdpPalette::PALMODE_MD);
+	palette->setMdShadowHighlight(true);
+	for (int i = 0; i < (int)ARRAY_SIZE(depths); i++) {
+		char name[64];
+		snprintf(name, sizeof(name), "cram_write_md_%s", depths[i].name);
+		palette->setBpp(depths[i].bpp);
+		palette->update();
+		suite->run(group, name, 100000, benchPaletteCRamWrite, &bench);
+	}
+
+	delete palette;
+}
+
+} }
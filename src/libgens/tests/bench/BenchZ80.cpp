@@ -0,0 +1,101 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * BenchZ80.cpp: Z80 benchmarks.                                           *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "BenchSuite.hpp"
+
+// LibGens.
+#include "cpu/Z80.hpp"
+#include "cpu/Z80_MD_Mem.hpp"
+#include "cpu/M68K_Mem.hpp"
+
+// C includes. (C++ namespace)
+#include <cstring>
+
+namespace LibGens { namespace Bench {
+
+/**
+ * Z80 test program.
+ * Similar to a sound driver's main loop: table lookups,
+ * indexed loads, bit shifts, and YM2612 status reads.
+ */
+static const uint8_t z80_test_prg[] = {
+	0x31, 0x00, 0x20,		// 0000: ld sp,$2000
+	0xDD, 0x21, 0x00, 0x18,		// 0003: ld ix,$1800
+	0x21, 0x00, 0x10,		// 0007: ld hl,$1000
+	0x11, 0x00, 0x11,		// 000A: ld de,$1100
+	0x06, 0x00,			// 000D: ld b,0
+	0x7E,				// 000F: ld a,(hl)
+	0x81,				// 0010: add a,c
+	0xDD, 0xAE, 0x01,		// 0011: xor (ix+1)
+	0x12,				// 0014: ld (de),a
+	0x4F,				// 0015: ld c,a
+	0xCB, 0x11,			// 0016: rl c
+	0x23,				// 0018: inc hl
+	0x13,				// 0019: inc de
+	0x10, 0xF3,			// 001A: djnz $000F
+	0x3A, 0x00, 0x40,		// 001C: ld a,($4000)
+	0xE5,				// 001F: push hl
+	0xCD, 0x27, 0x00,		// 0020: call $0027
+	0xE1,				// 0023: pop hl
+	0xC3, 0x07, 0x00,		// 0024: jp $0007
+	0x3C,				// 0027: inc a
+	0xC9,				// 0028: ret
+};
+
+/**
+ * Run the Z80 for one NTSC frame.
+ * @param param Unused.
+ */
+static void benchZ80Frame(void *param)
+{
+	((void)param);
+	Z80::ClearOdometer();
+	Z80::Exec(0);
+}
+
+/**
+ * Z80 benchmarks: Interpreter throughput on the MD bus.
+ * @param suite Benchmark suite.
+ */
+void BenchZ80(BenchSuite *suite)
+{
+	static const char group[] = "z80";
+	if (!suite->isEnabled(group, "exec_frame_md"))
+		return;
+
+	// Load the test program.
+	Z80::ReInit();
+	memcpy(Ram_Z80, z80_test_prg, sizeof(z80_test_prg));
+
+	// Give the Z80 the bus.
+	const unsigned int Z80_State_old = M68K_Mem::Z80_State;
+	const int Cycles_Z80_old = M68K_Mem::Cycles_Z80;
+	M68K_Mem::Z80_State = (Z80_STATE_ENABLED | Z80_STATE_BUSREQ);
+	M68K_Mem::Cycles_Z80 = (228 * 262);	// One NTSC frame.
+
+	suite->run(group, "exec_frame_md", 2000, benchZ80Frame, nullptr);
+
+	M68K_Mem::Z80_State = Z80_State_old;
+	M68K_Mem::Cycles_Z80 = Cycles_Z80_old;
+	Z80::ReInit();
+}
+
+} }
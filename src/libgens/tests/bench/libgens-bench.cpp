@@ -0,0 +1,120 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * libgens-bench.cpp: Benchmark suite main program.                        *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "BenchSuite.hpp"
+
+// LibGens.
+#include "lg_main.hpp"
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using LibGens::Bench::BenchSuite;
+
+/**
+ * Print usage information.
+ * @param argv0 Program name.
+ */
+static void print_usage(const char *argv0)
+{
+	fprintf(stderr,
+		"Usage: %s [options]\n"
+		"\n"
+		"Options:\n"
+		"  -o, --output FILE    Write JSON results to FILE. (default: stdout)\n"
+		"  -f, --filter STRING  Only run benchmarks whose \"group.name\" contains STRING.\n"
+		"  -s, --snapshot FILE  Load the VDP snapshot from FILE. (default: test-zomg/test.zomg)\n"
+		"  -q, --quick          Run 1%% of the usual iterations. (smoke test)\n"
+		"  -h, --help           Show this help.\n",
+		argv0);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *output = nullptr;
+	BenchSuite suite;
+
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		if (!strcmp(arg, "-o") || !strcmp(arg, "--output")) {
+			if (++i >= argc) {
+				print_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			output = argv[i];
+		} else if (!strcmp(arg, "-f") || !strcmp(arg, "--filter")) {
+			if (++i >= argc) {
+				print_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			suite.setFilter(argv[i]);
+		} else if (!strcmp(arg, "-s") || !strcmp(arg, "--snapshot")) {
+			if (++i >= argc) {
+				print_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			suite.setSnapshotFile(argv[i]);
+		} else if (!strcmp(arg, "-q") || !strcmp(arg, "--quick")) {
+			suite.setQuick(true);
+		} else if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
+			print_usage(argv[0]);
+			return EXIT_SUCCESS;
+		} else {
+			fprintf(stderr, "%s: unrecognized option '%s'\n", argv[0], arg);
+			print_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	fprintf(stderr, "LibGens benchmark suite.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	LibGens::Bench::BenchVdp(&suite);
+	LibGens::Bench::BenchPalette(&suite);
+	LibGens::Bench::BenchSound(&suite);
+	LibGens::Bench::BenchZ80(&suite);
+	LibGens::Bench::BenchFile(&suite);
+	LibGens::Bench::BenchPng(&suite);
+	LibGens::Bench::BenchEmu(&suite);
+
+	// Write the results.
+	int ret;
+	if (output) {
+		FILE *f = fopen(output, "w");
+		if (!f) {
+			fprintf(stderr, "%s: unable to open '%s': %s\n",
+				argv[0], output, strerror(errno));
+			LibGens::End();
+			return EXIT_FAILURE;
+		}
+		ret = suite.writeJson(f);
+		fclose(f);
+	} else {
+		ret = suite.writeJson(stdout);
+	}
+
+	LibGens::End();
+	return (ret == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,462 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * ResamplerTest.cpp: Audio resampler tests.                               *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "ResamplerTest.hpp"
+
+// LibGens.
+#include "lg_main.hpp"
+#include "libcompat/cpuflags.h"
+#include "sound/Resampler.hpp"
+#include "sound/SoundMgr.hpp"
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ includes.
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace LibGens { namespace Tests {
+
+/**
+ * Set up the test.
+ */
+void ResamplerTest::SetUp(void)
+{
+	// Verify CPU flags.
+	AudioWriteTest_flags flags = GetParam();
+	uint32_t totalFlags = (flags.cpuFlags | flags.cpuFlags_slow);
+	if (flags.cpuFlags != 0) {
+		ASSERT_NE(0U, CPU_Flags & totalFlags) <<
+			"CPU does not support the required flags for this test.";
+	}
+	// NOTE: We're not going to show a slow CPU warning,
+	// since this isn't a benchmark test.
+	cpuFlags_old = CPU_Flags;
+	CPU_Flags = flags.cpuFlags;
+}
+
+/**
+ * Tear down the test.
+ */
+void ResamplerTest::TearDown(void)
+{
+	CPU_Flags = cpuFlags_old;
+}
+
+/**
+ * Generate a sine wave.
+ * @param buf Output buffer.
+ * @param samples Number of samples.
+ * @param freq Frequency, in Hz.
+ * @param rate Sample rate, in Hz.
+ * @param amplitude Amplitude.
+ */
+void ResamplerTest::genSine(std::vector<int32_t> &buf, int samples,
+	double freq, int rate, double amplitude)
+{
+	buf.resize(samples);
+	const double w = 2.0 * M_PI * freq / (double)rate;
+	for (int i = 0; i < samples; i++) {
+		buf[i] = (int32_t)lrint(amplitude * sin(w * i));
+	}
+}
+
+/**
+ * Measure THD+N of a sine wave.
+ * The fundamental is removed using a least-squares fit.
+ * @param buf Interleaved stereo samples.
+ * @param channel Channel to measure. (0 == left, 1 == right)
+ * @param start First sample to measure.
+ * @param samples Number of samples to measure.
+ * @param freq Frequency of the fundamental, in Hz.
+ * @param rate Sample rate, in Hz.
+ * @param pAmplitude [out] Amplitude of the fundamental.
+ * @return THD+N, in dB.
+ */
+double ResamplerTest::measureThdN(const std::vector<int16_t> &buf, int channel,
+	int start, int samples, double freq, int rate,
+	double *pAmplitude)
+{
+	// NOTE: The measurement window must contain an
+	// integer number of cycles of the fundamental.
+	const double w = 2.0 * M_PI * freq / (double)rate;
+	double a = 0.0, b = 0.0, dc = 0.0;
+	for (int i = 0; i < samples; i++) {
+		const double y = buf[(start + i) * 2 + channel];
+		a += y * cos(w * i);
+		b += y * sin(w * i);
+		dc += y;
+	}
+	a *= 2.0 / samples;
+	b *= 2.0 / samples;
+	dc /= samples;
+
+	double sig = 0.0, res = 0.0;
+	for (int i = 0; i < samples; i++) {
+		const double fit = (a * cos(w * i)) + (b * sin(w * i));
+		const double y = buf[(start + i) * 2 + channel] - dc;
+		sig += fit * fit;
+		res += (y - fit) * (y - fit);
+	}
+
+	if (pAmplitude) {
+		*pAmplitude = sqrt((a * a) + (b * b));
+	}
+	return 10.0 * log10((res + 1e-9) / sig);
+}
+
+/**
+ * Resample an entire buffer in segments.
+ * @param resampler Resampler.
+ * @param inL Left channel input.
+ * @param inR Right channel input.
+ * @param segment Segment size.
+ * @param out Output buffer. (interleaved stereo)
+ */
+static void resampleAll(Resampler &resampler,
+	const std::vector<int32_t> &inL, const std::vector<int32_t> &inR,
+	int segment, std::vector<int16_t> &out)
+{
+	out.clear();
+	std::vector<int16_t> tmp(resampler.maxOutput(segment) * 2);
+	for (int i = 0; i < (int)inL.size(); i += segment) {
+		const int n = std::min(segment, (int)inL.size() - i);
+		const int ret = resampler.process(&inL[i], &inR[i], n,
+			&tmp[0], resampler.maxOutput(segment), false);
+		out.insert(out.end(), tmp.begin(), tmp.begin() + (ret * 2));
+	}
+}
+
+/**
+ * Invalid rates should be rejected.
+ */
+TEST_P(ResamplerTest, invalidRates)
+{
+	Resampler resampler;
+	EXPECT_EQ(-EINVAL, resampler.setRates(0, 48000));
+	EXPECT_EQ(-EINVAL, resampler.setRates(48000, -1));
+	EXPECT_EQ(-EINVAL, resampler.setRates(8000, 192000));
+	EXPECT_EQ(0, resampler.setRates(IN_RATE, 192000));
+	EXPECT_EQ((int)IN_RATE, resampler.inRate());
+	EXPECT_EQ(192000, resampler.outRate());
+}
+
+/**
+ * Test THD+N of a 1 kHz sine wave at various output rates.
+ */
+TEST_P(ResamplerTest, thdN)
+{
+	static const int rates[] = {32000, 44100, 48000, 96000, 192000};
+
+	// -1 dBFS sine wave. The right channel is
+	// phase-inverted to catch channel mixups.
+	std::vector<int32_t> inL, inR;
+	genSine(inL, IN_SEGMENT * 40, 1000.0, IN_RATE, 29204.0);
+	genSine(inR, IN_SEGMENT * 40, 1000.0, IN_RATE, -29204.0);
+
+	Resampler resampler;
+	std::vector<int16_t> out;
+	for (int i = 0; i < (int)(sizeof(rates)/sizeof(rates[0])); i++) {
+		const int rate = rates[i];
+		ASSERT_EQ(0, resampler.setRates(IN_RATE, rate));
+		resampleAll(resampler, inL, inR, IN_SEGMENT, out);
+
+		// Skip the first 50ms; measure 500ms.
+		const int start = rate / 20;
+		const int samples = rate / 2;
+		ASSERT_GE((int)(out.size() / 2), start + samples);
+
+		for (int ch = 0; ch < 2; ch++) {
+			double amplitude;
+			const double thdN = measureThdN(out, ch, start, samples, 1000.0, rate, &amplitude);
+			printf("%d Hz, channel %d: THD+N %.1f dB, gain %.4f dB\n",
+			       rate, ch, thdN, 20.0 * log10(amplitude / 29204.0));
+			EXPECT_LT(thdN, -85.0) << "rate == " << rate << ", channel == " << ch;
+			EXPECT_NEAR(29204.0, amplitude, 29204.0 * 0.002) << "rate == " << rate << ", channel == " << ch;
+		}
+	}
+}
+
+/**
+ * Test that content above the output rate's
+ * Nyquist frequency is attenuated.
+ */
+TEST_P(ResamplerTest, stopband)
+{
+	static const int rates[] = {32000, 44100, 48000};
+
+	std::vector<int32_t> in;
+	genSine(in, IN_SEGMENT * 20, 25500.0, IN_RATE, 29204.0);
+
+	Resampler resampler;
+	std::vector<int16_t> out;
+	for (int i = 0; i < (int)(sizeof(rates)/sizeof(rates[0])); i++) {
+		const int rate = rates[i];
+		ASSERT_EQ(0, resampler.setRates(IN_RATE, rate));
+		resampleAll(resampler, in, in, IN_SEGMENT, out);
+
+		// Skip the first 50ms.
+		const int start = rate / 20;
+		const int samples = (int)(out.size() / 2) - start;
+		double rms = 0.0;
+		for (int j = 0; j < samples; j++) {
+			const double y = out[(start + j) * 2];
+			rms += y * y;
+		}
+		rms = sqrt(rms / samples);
+		const double atten = 20.0 * log10((rms + 1e-9) / (29204.0 / sqrt(2.0)));
+		printf("%d Hz: 25.5 kHz attenuated by %.1f dB\n", rate, -atten);
+		EXPECT_LT(atten, -70.0) << "rate == " << rate;
+	}
+}
+
+/**
+ * Test the ratio adjustment.
+ */
+TEST_P(ResamplerTest, ratioAdjust)
+{
+	static const double adjusts[] = {1.0, 1.005, 0.995, 1.02, 0.98};
+
+	std::vector<int32_t> in;
+	genSine(in, IN_SEGMENT * 120, 1000.0, IN_RATE, 16384.0);
+
+	Resampler resampler;
+	ASSERT_EQ(0, resampler.setRates(IN_RATE, 48000));
+	std::vector<int16_t> out;
+	for (int i = 0; i < (int)(sizeof(adjusts)/sizeof(adjusts[0])); i++) {
+		resampler.reset();
+		resampler.setRatioAdjust(adjusts[i]);
+		EXPECT_DOUBLE_EQ(adjusts[i], resampler.ratioAdjust());
+		resampleAll(resampler, in, in, IN_SEGMENT, out);
+
+		// Output length should match the ratio.
+		// The resampler buffers up to TAPS/2 input samples.
+		const double expected = (double)in.size() * 48000.0 * adjusts[i] / IN_RATE;
+		EXPECT_NEAR(expected, (double)(out.size() / 2),
+			(Resampler::TAPS / 2) * resampler.ratio() + 2.0) << "adjust == " << adjusts[i];
+	}
+
+	// Adjustments outside of the supported range are clamped.
+	resampler.setRatioAdjust(2.0);
+	EXPECT_DOUBLE_EQ(1.0 + (Resampler::MAX_RATIO_ADJUST_PPM / 1000000.0), resampler.ratioAdjust());
+	resampler.setRatioAdjust(0.5);
+	EXPECT_DOUBLE_EQ(1.0 - (Resampler::MAX_RATIO_ADJUST_PPM / 1000000.0), resampler.ratioAdjust());
+}
+
+/**
+ * Changing the ratio adjustment while running
+ * shouldn't cause discontinuities.
+ */
+TEST_P(ResamplerTest, ratioAdjustContinuous)
+{
+	std::vector<int32_t> in;
+	genSine(in, IN_SEGMENT * 60, 1000.0, IN_RATE, 16384.0);
+
+	Resampler resampler;
+	ASSERT_EQ(0, resampler.setRates(IN_RATE, 48000));
+	std::vector<int16_t> out, tmp(resampler.maxOutput(IN_SEGMENT) * 2 * 2);
+	for (int i = 0; i < (int)in.size(); i += IN_SEGMENT) {
+		// Sweep the adjustment every segment.
+		resampler.setRatioAdjust(1.0 + (0.01 * sin(i / 5000.0)));
+		const int ret = resampler.process(&in[i], &in[i], IN_SEGMENT,
+			&tmp[0], (int)(tmp.size() / 2), false);
+		out.insert(out.end(), tmp.begin(), tmp.begin() + (ret * 2));
+	}
+
+	// The largest sample-to-sample difference of a 1 kHz sine
+	// wave at 48 kHz is about 2*pi*16384/48 * 1.01. Anything
+	// significantly larger indicates a discontinuity.
+	const int maxDiff = (int)(2.0 * M_PI * 16384.0 / 48.0 * 1.02) + 2;
+	for (int i = (Resampler::TAPS * 2); i < (int)(out.size() / 2) - 1; i++) {
+		ASSERT_LE(abs(out[(i + 1) * 2] - out[i * 2]), maxDiff) << "i == " << i;
+	}
+}
+
+/**
+ * If the destination buffer is too small, the oldest input
+ * is dropped. Output should resume cleanly afterwards.
+ */
+TEST_P(ResamplerTest, overflow)
+{
+	std::vector<int32_t> in;
+	genSine(in, IN_SEGMENT * 40, 1000.0, IN_RATE, 16384.0);
+
+	Resampler resampler;
+	ASSERT_EQ(0, resampler.setRates(IN_RATE, 48000));
+	std::vector<int16_t> tmp(resampler.maxOutput(IN_SEGMENT * 8) * 2);
+
+	// Don't read any output for the first 20 segments.
+	// This overflows the input buffer several times.
+	int i;
+	for (i = 0; i < IN_SEGMENT * 20; i += IN_SEGMENT) {
+		EXPECT_EQ(0, resampler.process(&in[i], &in[i], IN_SEGMENT,
+			&tmp[0], 0, false));
+	}
+
+	// Drain the buffered input. Everything that was kept
+	// should be returned, and it should be continuous.
+	// (At most one full input buffer, 4096 samples,
+	// plus one segment.)
+	const int ret = resampler.process(&in[i], &in[i], IN_SEGMENT,
+		&tmp[0], (int)(tmp.size() / 2), false);
+	i += IN_SEGMENT;
+	EXPECT_GT(ret, 0);
+	EXPECT_LE(ret, resampler.maxOutput(4096 + IN_SEGMENT));
+
+	std::vector<int16_t> out(tmp.begin(), tmp.begin() + (ret * 2));
+	for (; i < (int)in.size(); i += IN_SEGMENT) {
+		const int n = resampler.process(&in[i], &in[i], IN_SEGMENT,
+			&tmp[0], (int)(tmp.size() / 2), false);
+		out.insert(out.end(), tmp.begin(), tmp.begin() + (n * 2));
+	}
+
+	// Output is continuous from the oldest kept sample onwards.
+	const int maxDiff = (int)(2.0 * M_PI * 16384.0 / 48.0 * 1.02) + 2;
+	for (int j = 0; j < (int)(out.size() / 2) - 1; j++) {
+		ASSERT_LE(abs(out[(j + 1) * 2] - out[j * 2]), maxDiff) << "j == " << j;
+	}
+}
+
+/**
+ * The optimized versions should match the generic version.
+ */
+TEST_P(ResamplerTest, matchesGeneric)
+{
+	// Pseudo-random input, including values outside of
+	// the 16-bit range to test saturation.
+	std::vector<int32_t> inL(IN_SEGMENT * 10), inR(IN_SEGMENT * 10);
+	unsigned int seed = 0x12345678;
+	for (int i = 0; i < (int)inL.size(); i++) {
+		seed = (seed * 1103515245U) + 12345U;
+		inL[i] = (int32_t)((seed >> 8) & 0xFFFF) - 0x8000;
+		seed = (seed * 1103515245U) + 12345U;
+		inR[i] = (int32_t)((seed >> 8) & 0x1FFFF) - 0x10000;
+	}
+
+	Resampler resampler;
+	ASSERT_EQ(0, resampler.setRates(IN_RATE, 44100));
+	std::vector<int16_t> out, outGeneric;
+	resampleAll(resampler, inL, inR, IN_SEGMENT, out);
+
+	const uint32_t cpuFlags = CPU_Flags;
+	CPU_Flags = 0;
+	ASSERT_EQ(0, resampler.setRates(IN_RATE, 44100));
+	resampleAll(resampler, inL, inR, IN_SEGMENT, outGeneric);
+	CPU_Flags = cpuFlags;
+
+	ASSERT_EQ(outGeneric.size(), out.size());
+	for (int i = 0; i < (int)out.size(); i++) {
+		// Allow for rounding differences.
+		ASSERT_LE(abs(out[i] - outGeneric[i]), 1) << "i == " << i;
+	}
+}
+
+/**
+ * Test SoundMgr with the resampler enabled.
+ */
+TEST_P(ResamplerTest, soundMgr)
+{
+	SoundMgr::ReInit(48000, false);
+	ASSERT_FALSE(SoundMgr::IsResamplerEnabled());
+	EXPECT_EQ(800, SoundMgr::GetSegLength());
+	EXPECT_EQ(800, SoundMgr::GetOutputLength());
+
+	static const int rates[] = {44100, 48000, 96000, 192000};
+	std::vector<int16_t> buf(SoundMgr::MAX_OUTPUT_SIZE * 2);
+	SoundMgr::SetResampler(true, false);
+	for (int i = 0; i < (int)(sizeof(rates)/sizeof(rates[0])); i++) {
+		for (int pal = 0; pal < 2; pal++) {
+			const int rate = rates[i];
+			const int fps = (pal ? 50 : 60);
+			SoundMgr::ReInit(rate, !!pal);
+			EXPECT_TRUE(SoundMgr::IsResamplerEnabled());
+
+			// The audio ICs run at the YM2612's native rate.
+			EXPECT_EQ(pal ? 1056 : 888, SoundMgr::GetSegLength());
+			EXPECT_LE(SoundMgr::GetSegLength(), (int)SoundMgr::MAX_SEGMENT_SIZE);
+			EXPECT_LE(SoundMgr::GetOutputLength(), (int)SoundMgr::MAX_OUTPUT_SIZE);
+
+			// Write a few frames.
+			int total = 0;
+			for (int frame = 0; frame < fps; frame++) {
+				const int ret = SoundMgr::writeStereo(&buf[0], SoundMgr::GetOutputLength());
+				EXPECT_LE(ret, SoundMgr::GetOutputLength());
+				total += ret;
+			}
+
+			// One second of emulated audio.
+			const double expected = (double)SoundMgr::GetSegLength() * fps * rate /
+				(pal ? 52781.0 : 53267.0);
+			EXPECT_NEAR(expected, total, rate / 1000) <<
+				"rate == " << rate << ", pal == " << pal;
+		}
+	}
+
+	// Maximum output size, with the maximum ratio adjustment.
+	SoundMgr::SetRateAdjust(2.0);
+	EXPECT_LT(SoundMgr::GetRateAdjust(), 1.05);
+	SoundMgr::ReInit(SoundMgr::MAX_OUTPUT_RATE, true);
+	EXPECT_LE(SoundMgr::GetOutputLength(), (int)SoundMgr::MAX_OUTPUT_SIZE);
+	SoundMgr::SetRateAdjust(1.0);
+
+	SoundMgr::SetResampler(false, false);
+	SoundMgr::ReInit(48000, false);
+	EXPECT_FALSE(SoundMgr::IsResamplerEnabled());
+	EXPECT_EQ(800, SoundMgr::GetOutputLength());
+}
+
+INSTANTIATE_TEST_CASE_P(ResamplerTest_NoFlags, ResamplerTest,
+	::testing::Values(AudioWriteTest_flags(0, 0)
+));
+
+// NOTE: Resampler.cpp only implements SSE2 if intrinsics are available.
+#if defined(__i386__) || defined(__amd64__) || defined(__x86_64__) || \
+    defined(_M_IX86) || defined(_M_X64)
+INSTANTIATE_TEST_CASE_P(ResamplerTest_SSE2, ResamplerTest,
+	::testing::Values(AudioWriteTest_flags(MDP_CPUFLAG_X86_SSE2, 0)
+));
+#endif
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: Audio resampler test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
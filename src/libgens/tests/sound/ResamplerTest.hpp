@@ -0,0 +1,88 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * ResamplerTest.hpp: Audio resampler test. (Common header)                *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENS_TESTS_SOUND_RESAMPLERTEST_HPP__
+#define __LIBGENS_TESTS_SOUND_RESAMPLERTEST_HPP__
+
+// Google Test
+#include "gtest/gtest.h"
+
+// C includes.
+#include <stdint.h>
+
+// C++ includes.
+#include <vector>
+
+// CPU flags parameters.
+#include "AudioWriteTest.hpp"
+
+namespace LibGens { namespace Tests {
+
+class ResamplerTest : public ::testing::TestWithParam<AudioWriteTest_flags>
+{
+	protected:
+		ResamplerTest()
+			: ::testing::TestWithParam<AudioWriteTest_flags>() { }
+		virtual ~ResamplerTest() { }
+
+		virtual void SetUp(void) override;
+		virtual void TearDown(void) override;
+
+	protected:
+		// YM2612 native rate. (NTSC)
+		static const int IN_RATE = 53267;
+		// Input segment size. (one NTSC frame)
+		static const int IN_SEGMENT = 888;
+
+		// Previous CPU flags.
+		uint32_t cpuFlags_old;
+
+		/**
+		 * Generate a sine wave.
+		 * @param buf Output buffer.
+		 * @param samples Number of samples.
+		 * @param freq Frequency, in Hz.
+		 * @param rate Sample rate, in Hz.
+		 * @param amplitude Amplitude.
+		 */
+		static void genSine(std::vector<int32_t> &buf, int samples,
+			double freq, int rate, double amplitude);
+
+		/**
+		 * Measure THD+N of a sine wave.
+		 * The fundamental is removed using a least-squares fit.
+		 * @param buf Interleaved stereo samples.
+		 * @param channel Channel to measure. (0 == left, 1 == right)
+		 * @param start First sample to measure.
+		 * @param samples Number of samples to measure.
+		 * @param freq Frequency of the fundamental, in Hz.
+		 * @param rate Sample rate, in Hz.
+		 * @param pAmplitude [out] Amplitude of the fundamental.
+		 * @return THD+N, in dB.
+		 */
+		static double measureThdN(const std::vector<int16_t> &buf, int channel,
+			int start, int samples, double freq, int rate,
+			double *pAmplitude = nullptr);
+};
+
+} }
+
+#endif /* __LIBGENS_TESTS_SOUND_RESAMPLERTEST_HPP__ */
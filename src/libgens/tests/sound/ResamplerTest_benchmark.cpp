@@ -0,0 +1,147 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * ResamplerTest_benchmark.cpp: Audio resampler benchmarks.                *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "ResamplerTest.hpp"
+
+// LibGens.
+#include "libcompat/cpuflags.h"
+#include "sound/Resampler.hpp"
+
+// Timing.
+#include "Util/Timing.hpp"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+
+namespace LibGens { namespace Tests {
+
+class ResamplerTest_benchmark : public ResamplerTest
+{
+	protected:
+		ResamplerTest_benchmark()
+			: ResamplerTest() { }
+		virtual ~ResamplerTest_benchmark() { }
+
+	protected:
+		// Resample 60 seconds of audio.
+		static const int BENCHMARK_FRAMES = 3600;
+
+		/**
+		 * Benchmark the resampler.
+		 * @param outRate Output rate.
+		 * @param mono If true, downmix to monaural.
+		 */
+		void benchmark(int outRate, bool mono);
+};
+
+/**
+ * Benchmark the resampler.
+ * @param outRate Output rate.
+ * @param mono If true, downmix to monaural.
+ */
+void ResamplerTest_benchmark::benchmark(int outRate, bool mono)
+{
+	std::vector<int32_t> inL, inR;
+	genSine(inL, IN_SEGMENT, 1000.0, IN_RATE, 16384.0);
+	genSine(inR, IN_SEGMENT, 1500.0, IN_RATE, 16384.0);
+
+	Resampler resampler;
+	ASSERT_EQ(0, resampler.setRates(IN_RATE, outRate));
+	const int maxOut = resampler.maxOutput(IN_SEGMENT);
+	std::vector<int16_t> out(maxOut * 2);
+
+	Timing timing;
+	const uint64_t start = timing.getTime();
+	uint64_t total = 0;
+	for (int i = BENCHMARK_FRAMES; i > 0; i--) {
+		total += resampler.process(&inL[0], &inR[0], IN_SEGMENT,
+				&out[0], maxOut, mono);
+	}
+	uint64_t usec = timing.getTime() - start;
+	if (usec == 0) {
+		// Too fast to measure.
+		usec = 1;
+	}
+
+	// Output samples per second, and the cost relative
+	// to real time. (one NTSC frame == IN_SEGMENT samples)
+	const double msps = (double)total / (double)usec;
+	const double realtime = (BENCHMARK_FRAMES * 1000000.0 / 60.0) / (double)usec;
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%.2f", msps);
+	printf("Throughput: %s Msamples/s, %.0fx real time (flags 0x%08X)\n",
+		buf, realtime, GetParam().cpuFlags);
+	RecordProperty("throughput_msamples_per_sec", buf);
+}
+
+/**
+ * Benchmark resampling to 44.1 kHz. (stereo)
+ */
+TEST_P(ResamplerTest_benchmark, stereo_44100)
+{
+	benchmark(44100, false);
+}
+
+/**
+ * Benchmark resampling to 48 kHz. (stereo)
+ */
+TEST_P(ResamplerTest_benchmark, stereo_48000)
+{
+	benchmark(48000, false);
+}
+
+/**
+ * Benchmark resampling to 48 kHz. (mono)
+ */
+TEST_P(ResamplerTest_benchmark, mono_48000)
+{
+	benchmark(48000, true);
+}
+
+/**
+ * Benchmark resampling to 96 kHz. (stereo)
+ */
+TEST_P(ResamplerTest_benchmark, stereo_96000)
+{
+	benchmark(96000, false);
+}
+
+/**
+ * Benchmark resampling to 192 kHz. (stereo)
+ */
+TEST_P(ResamplerTest_benchmark, stereo_192000)
+{
+	benchmark(192000, false);
+}
+
+INSTANTIATE_TEST_CASE_P(ResamplerTest_benchmark_NoFlags, ResamplerTest_benchmark,
+	::testing::Values(AudioWriteTest_flags(0, 0)
+));
+
+// NOTE: Resampler.cpp only implements SSE2 if intrinsics are available.
+#if defined(__i386__) || defined(__amd64__) || defined(__x86_64__) || \
+    defined(_M_IX86) || defined(_M_X64)
+INSTANTIATE_TEST_CASE_P(ResamplerTest_benchmark_SSE2, ResamplerTest_benchmark,
+	::testing::Values(AudioWriteTest_flags(MDP_CPUFLAG_X86_SSE2, 0)
+));
+#endif
+
+} }
@@ -0,0 +1,266 @@
+/***************************************************************************
+ * libgens/tests: Gens Emulation Library. (Test Suite)                     *
+ * Ym2612TimerTest.cpp: YM2612 timer test.                                 *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGens.
+#include "lg_main.hpp"
+
+// LibGens YM2612.
+#include "cpu/M68K.hpp"
+#include "sound/Ym2612.hpp"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstdlib>
+
+namespace LibGens { namespace Tests {
+
+class Ym2612TimerTest : public ::testing::Test
+{
+	protected:
+		Ym2612TimerTest()
+			: ::testing::Test()
+			, m_ym2612(nullptr)
+			, m_writeCount(0)
+			, m_ticksAtWrite(0) { }
+		virtual ~Ym2612TimerTest() { }
+
+		virtual void SetUp(void) override;
+		virtual void TearDown(void) override;
+
+	protected:
+		Ym2612 *m_ym2612;
+
+		/**
+		 * Write a YM2612 register in bank 0.
+		 * @param reg Register number.
+		 * @param data Data.
+		 */
+		void ymWrite(uint8_t reg, uint8_t data)
+		{
+			m_ym2612->write(0, reg);
+			m_ym2612->write(1, data);
+		}
+
+		/**
+		 * Set the timer A period.
+		 * @param ticks Timer A period, in timer ticks. (1-1024)
+		 */
+		void setTimerA(int ticks)
+		{
+			const int val = 1024 - ticks;
+			ymWrite(0x24, (val >> 2) & 0xFF);
+			ymWrite(0x25, val & 3);
+		}
+
+		// Timer write function.
+		int m_writeCount;
+		int m_ticksAtWrite;
+		static void timerWriteFn(void *param);
+};
+
+/**
+ * Set up the YM2612 for testing.
+ */
+void Ym2612TimerTest::SetUp(void)
+{
+	// NTSC clock, 44.1 kHz output.
+	m_ym2612 = new Ym2612((int)((double)CLOCK_NTSC / 7.0), 44100);
+	m_ym2612->reset();
+}
+
+void Ym2612TimerTest::TearDown(void)
+{
+	delete m_ym2612;
+	m_ym2612 = nullptr;
+}
+
+/**
+ * Timer write function.
+ * @param param Ym2612TimerTest.
+ */
+void Ym2612TimerTest::timerWriteFn(void *param)
+{
+	Ym2612TimerTest *const test = static_cast<Ym2612TimerTest*>(param);
+	test->m_writeCount++;
+	test->m_ticksAtWrite = test->m_ym2612->timerTicksToEvent();
+}
+
+/**
+ * No timer events should be pending if the timers are disabled.
+ */
+TEST_F(Ym2612TimerTest, timersDisabled)
+{
+	setTimerA(10);
+	ymWrite(0x26, 0xFF);
+	EXPECT_EQ(-1, m_ym2612->timerTicksToEvent());
+
+	// Timers running, but overflow flags disabled.
+	ymWrite(0x27, 0x03);
+	EXPECT_EQ(-1, m_ym2612->timerTicksToEvent());
+	m_ym2612->updateTimers(1000);
+	EXPECT_EQ(0, m_ym2612->read() & 3);
+}
+
+/**
+ * Timer A should overflow after the programmed number of ticks.
+ */
+TEST_F(Ym2612TimerTest, timerA)
+{
+	setTimerA(10);
+	ymWrite(0x27, 0x05);	// Run timer A; enable the A flag.
+	EXPECT_EQ(10, m_ym2612->timerTicksToEvent());
+
+	m_ym2612->updateTimers(9);
+	EXPECT_EQ(0, m_ym2612->read() & 3);
+	EXPECT_EQ(1, m_ym2612->timerTicksToEvent());
+
+	m_ym2612->updateTimers(1);
+	EXPECT_EQ(1, m_ym2612->read() & 3);
+
+	// The flag is already set, so further
+	// overflows don't change anything.
+	EXPECT_EQ(-1, m_ym2612->timerTicksToEvent());
+
+	// Reset the flag. The timer was reloaded
+	// on overflow, so the next overflow is
+	// one full period later.
+	ymWrite(0x27, 0x15);
+	EXPECT_EQ(0, m_ym2612->read() & 3);
+	EXPECT_EQ(10, m_ym2612->timerTicksToEvent());
+}
+
+/**
+ * Timer B counts in units of 16 timer ticks.
+ */
+TEST_F(Ym2612TimerTest, timerB)
+{
+	ymWrite(0x26, 256 - 6);
+	ymWrite(0x27, 0x0A);	// Run timer B; enable the B flag.
+	EXPECT_EQ(6 * 16, m_ym2612->timerTicksToEvent());
+
+	m_ym2612->updateTimers(6 * 16 - 1);
+	EXPECT_EQ(0, m_ym2612->read() & 3);
+	m_ym2612->updateTimers(1);
+	EXPECT_EQ(2, m_ym2612->read() & 3);
+	EXPECT_EQ(-1, m_ym2612->timerTicksToEvent());
+}
+
+/**
+ * The next event should be the earlier of the two timers.
+ */
+TEST_F(Ym2612TimerTest, bothTimers)
+{
+	setTimerA(100);
+	ymWrite(0x26, 256 - 2);	// 32 ticks
+	ymWrite(0x27, 0x0F);
+	EXPECT_EQ(32, m_ym2612->timerTicksToEvent());
+
+	m_ym2612->updateTimers(32);
+	EXPECT_EQ(2, m_ym2612->read() & 3);
+	EXPECT_EQ(100 - 32, m_ym2612->timerTicksToEvent());
+
+	m_ym2612->updateTimers(100 - 32);
+	EXPECT_EQ(3, m_ym2612->read() & 3);
+	EXPECT_EQ(-1, m_ym2612->timerTicksToEvent());
+}
+
+/**
+ * Advancing by several periods at once should
+ * keep the timer phase.
+ */
+TEST_F(Ym2612TimerTest, multiplePeriods)
+{
+	setTimerA(10);
+	ymWrite(0x27, 0x05);
+	m_ym2612->updateTimers(10 * 3 + 4);
+	EXPECT_EQ(1, m_ym2612->read() & 3);
+
+	ymWrite(0x27, 0x15);
+	EXPECT_EQ(6, m_ym2612->timerTicksToEvent());
+}
+
+/**
+ * CSM mode needs every timer A overflow,
+ * even if the A flag is already set.
+ */
+TEST_F(Ym2612TimerTest, csmMode)
+{
+	setTimerA(10);
+	ymWrite(0x27, 0x85);	// CSM; run timer A; enable the A flag.
+	m_ym2612->updateTimers(10);
+	EXPECT_EQ(1, m_ym2612->read() & 3);
+	EXPECT_EQ(10, m_ym2612->timerTicksToEvent());
+}
+
+/**
+ * The timer write function should be called
+ * before timer registers are written.
+ */
+TEST_F(Ym2612TimerTest, timerWriteFn)
+{
+	setTimerA(10);
+	ymWrite(0x27, 0x05);
+	m_ym2612->setTimerWriteFn(timerWriteFn, this);
+
+	// Non-timer registers.
+	ymWrite(0x22, 0x00);
+	ymWrite(0x28, 0x00);
+	ymWrite(0x2A, 0x80);
+	EXPECT_EQ(0, m_writeCount);
+
+	// Disable timer A.
+	// The write function sees the old value.
+	ymWrite(0x27, 0x00);
+	EXPECT_EQ(1, m_writeCount);
+	EXPECT_EQ(10, m_ticksAtWrite);
+	EXPECT_EQ(-1, m_ym2612->timerTicksToEvent());
+
+	// Timer period registers.
+	ymWrite(0x24, 0x00);
+	ymWrite(0x25, 0x00);
+	ymWrite(0x26, 0x00);
+	EXPECT_EQ(4, m_writeCount);
+
+	m_ym2612->setTimerWriteFn(nullptr, nullptr);
+	ymWrite(0x27, 0x05);
+	EXPECT_EQ(4, m_writeCount);
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGens test suite: YM2612 timer test.\n\n");
+	LibGens::Init();
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
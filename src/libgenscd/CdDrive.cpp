@@ -53,6 +53,7 @@ using std::string;
 
 // TODO: Factory class?
 #include "ScsiBase.hpp"
+#include "ScsiImage.hpp"
 #if defined(_WIN32)
 #include "ScsiSpti.hpp"
 #elif defined(__linux__)
@@ -209,13 +210,18 @@ CdDrivePrivate::CdDrivePrivate(CdDrive *q, string filename)
 {
 	// Initialize the SCSI device handler.
 	// TODO: Factory class?
+	if (ScsiImage::IsImageFile(filename)) {
+		// Disc image.
+		p_scsi = new ScsiImage(filename);
+	} else {
 #if defined(_WIN32)
-	p_scsi = new ScsiSpti(filename);
+		p_scsi = new ScsiSpti(filename);
 #elif defined(__linux__)
-	p_scsi = new ScsiLinux(filename);
+		p_scsi = new ScsiLinux(filename);
 #else
 #error CdDrive: Only Win32 and Linux are supported right now.
 #endif
+	}
 
 	// Run the SCSI INQUIRY command.
 	inquiry();
@@ -1,11 +1,105 @@
 // C includes. (C++ namespace)
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+
+// C++ includes.
+#include <chrono>
+#include <vector>
 
 #include "CdDrive.hpp"
+#include "ScsiImage.hpp"
+
+/**
+ * Benchmark reading from a disc image.
+ * @param filename Disc image filename.
+ * @return EXIT_SUCCESS on success; EXIT_FAILURE on error.
+ */
+static int benchmark(const char *filename)
+{
+	LibGensCD::ScsiImage image(filename);
+	if (!image.isOpen()) {
+		printf("Error opening %s.\n", filename);
+		return EXIT_FAILURE;
+	}
+
+	// Find the first data track.
+	SCSI_CDROM_TOC toc;
+	int numTracks = 0;
+	int err = image.readToc(&toc, &numTracks);
+	if (err != 0) {
+		image.printScsiError(SCSI_OP_READ_TOC, err);
+		return EXIT_FAILURE;
+	}
+	int idx;
+	for (idx = 0; idx < numTracks; idx++) {
+		if ((toc.Tracks[idx].ControlADR & 0x0C) == 0x04)
+			break;
+	}
+	if (idx >= numTracks) {
+		printf("%s has no data tracks.\n", filename);
+		return EXIT_FAILURE;
+	}
+	const uint32_t lba_start = toc.Tracks[idx].StartAddress;
+	const uint32_t lba_end = toc.Tracks[idx+1].StartAddress;
+	if (lba_end <= lba_start) {
+		printf("%s: data track is empty.\n", filename);
+		return EXIT_FAILURE;
+	}
+
+	static const unsigned int BLOCK = 32;
+	std::vector<uint8_t> buf(BLOCK * 2048);
+	typedef std::chrono::steady_clock clock;
+
+	// Sequential reads.
+	clock::time_point start = clock::now();
+	uint64_t bytes = 0;
+	for (uint32_t lba = lba_start; lba + BLOCK <= lba_end; lba += BLOCK) {
+		err = image.read(lba, BLOCK, buf.data(), buf.size());
+		if (err != 0) {
+			image.printScsiError(SCSI_OP_READ_10, err);
+			return EXIT_FAILURE;
+		}
+		bytes += buf.size();
+	}
+	double secs = std::chrono::duration<double>(clock::now() - start).count();
+	LibGensCD::ScsiImage::CacheStats stats = image.cacheStats();
+	printf("Sequential: %.2f MB/s (%u sectors; hits=%llu, misses=%llu, prefetched=%llu)\n",
+		(secs > 0 ? (bytes / 1048576.0) / secs : 0.0),
+		(unsigned int)(bytes / 2048),
+		(unsigned long long)stats.hits,
+		(unsigned long long)stats.misses,
+		(unsigned long long)stats.prefetched);
+
+	// Random single-sector reads.
+	const uint32_t len = lba_end - lba_start;
+	srand(1);
+	start = clock::now();
+	bytes = 0;
+	for (unsigned int i = 0; i < 4096; i++) {
+		const uint32_t lba = lba_start + (uint32_t)(rand() % len);
+		err = image.read(lba, 1, buf.data(), 2048);
+		if (err != 0) {
+			image.printScsiError(SCSI_OP_READ_10, err);
+			return EXIT_FAILURE;
+		}
+		bytes += 2048;
+	}
+	secs = std::chrono::duration<double>(clock::now() - start).count();
+	printf("Random:     %.2f MB/s (%u sectors)\n",
+		(secs > 0 ? (bytes / 1048576.0) / secs : 0.0),
+		(unsigned int)(bytes / 2048));
+
+	return EXIT_SUCCESS;
+}
 
 int main(int argc, char *argv[])
 {
+	if (argc == 3 && !strcmp(argv[1], "--bench")) {
+		// Disc image benchmark.
+		return benchmark(argv[2]);
+	}
+
 	if (argc != 2) {
 #if defined(_WIN32)
 		printf("Syntax: %s D:\n", argv[0]);
@@ -14,6 +108,8 @@ int main(int argc, char *argv[])
 		printf("Syntax: %s /dev/sr0\n", argv[0]);
 		printf("Replace /dev/sr0 with your CD-ROM drive.\n");
 #endif
+		printf("Disc images (.iso, .bin, .cue, .cso) can also be used.\n");
+		printf("Use %s --bench image.iso to benchmark image reads.\n", argv[0]);
 		return EXIT_FAILURE;
 	}
 
@@ -0,0 +1,764 @@
+/***************************************************************************
+ * libgenscd: Gens/GS II CD-ROM Handler Library.                           *
+ * DiscImage.cpp: Disc image reader. (ISO, BIN/CUE, CSO)                   *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "DiscImage.hpp"
+
+#ifdef _WIN32
+// Win32 Unicode Translation Layer.
+// Needed for proper Unicode filename support on Windows.
+#include "libcompat/W32U/W32U_mini.h"
+#endif
+
+// zlib for CSO.
+#include <zlib.h>
+
+// C includes. (C++ namespace)
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ includes.
+#include <mutex>
+#include <string>
+#include <vector>
+using std::mutex;
+using std::string;
+using std::unique_lock;
+using std::vector;
+
+namespace LibGensCD
+{
+
+class DiscImagePrivate
+{
+	public:
+		DiscImagePrivate();
+		~DiscImagePrivate();
+
+	private:
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGensCD-specific version of Q_DISABLE_COPY().
+		DiscImagePrivate(const DiscImagePrivate &);
+		DiscImagePrivate &operator=(const DiscImagePrivate &);
+
+	public:
+		// Image files.
+		struct ImageFile {
+			FILE *f;
+			int64_t size;
+		};
+		vector<ImageFile> files;
+
+		// Tracks.
+		struct TrackInfo {
+			DiscImage::Track track;
+			int file;		// Index into files.
+			int64_t fileOffset;	// Byte offset of the first sector.
+		};
+		vector<TrackInfo> tracks;
+		uint32_t leadOut;
+
+		// Serializes file access and CSO decompression.
+		mutex mtx;
+
+		/** CSO **/
+		bool isCso;
+		struct {
+			uint32_t blockSize;
+			uint8_t align;
+			uint64_t totalBytes;
+			vector<uint32_t> index;
+
+			// Last decompressed block.
+			int64_t cachedBlock;
+			vector<uint8_t> block;
+			vector<uint8_t> compressed;
+
+			z_stream zs;
+			bool zsInit;
+		} cso;
+
+		/**
+		 * Open an image file and add it to the file list.
+		 * @param filename Filename.
+		 * @return File index, or -1 on error.
+		 */
+		int addFile(const string &filename);
+
+		/**
+		 * Add a single track covering an entire file.
+		 * @param file File index.
+		 * @param mode Track mode.
+		 * @param sectorSize Sector size.
+		 * @param size Size of the track data, in bytes.
+		 */
+		void addSingleTrack(int file, DiscImage::TrackMode mode,
+				    unsigned int sectorSize, int64_t size);
+
+		/**
+		 * Open a CUE sheet.
+		 * @param filename CUE filename.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int openCue(const string &filename);
+
+		/**
+		 * Open a CSO image.
+		 * @param filename CSO filename.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int openCso(const string &filename);
+
+		/**
+		 * Read data from a CSO image.
+		 * @param pos Position in the uncompressed image.
+		 * @param len Length.
+		 * @param out Output buffer.
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int readCso(uint64_t pos, unsigned int len, uint8_t *out);
+
+		/**
+		 * Parse an MSF timestamp. ("mm:ss:ff")
+		 * @param str Timestamp.
+		 * @return Number of frames, or -1 on error.
+		 */
+		static int parseMsf(const string &str);
+
+		/**
+		 * Split a CUE sheet line into tokens.
+		 * Quoted tokens may contain spaces.
+		 * @param line Line.
+		 * @return Tokens.
+		 */
+		static vector<string> tokenize(const string &line);
+
+		static inline uint32_t getLE32(const uint8_t *p)
+			{ return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+};
+
+/** DiscImagePrivate **/
+
+DiscImagePrivate::DiscImagePrivate()
+	: leadOut(0)
+	, isCso(false)
+{
+	cso.blockSize = 0;
+	cso.align = 0;
+	cso.totalBytes = 0;
+	cso.cachedBlock = -1;
+	memset(&cso.zs, 0, sizeof(cso.zs));
+	cso.zsInit = false;
+}
+
+DiscImagePrivate::~DiscImagePrivate()
+{
+	for (size_t i = 0; i < files.size(); i++) {
+		fclose(files[i].f);
+	}
+	if (cso.zsInit) {
+		inflateEnd(&cso.zs);
+	}
+}
+
+/**
+ * Open an image file and add it to the file list.
+ * @param filename Filename.
+ * @return File index, or -1 on error.
+ */
+int DiscImagePrivate::addFile(const string &filename)
+{
+	FILE *f = fopen(filename.c_str(), "rb");
+	if (!f)
+		return -1;
+
+	ImageFile file;
+	file.f = f;
+	fseeko(f, 0, SEEK_END);
+	file.size = ftello(f);
+	files.push_back(file);
+	return (int)(files.size() - 1);
+}
+
+/**
+ * Add a single track covering an entire file.
+ * @param file File index.
+ * @param mode Track mode.
+ * @param sectorSize Sector size.
+ * @param size Size of the track data, in bytes.
+ */
+void DiscImagePrivate::addSingleTrack(int file, DiscImage::TrackMode mode,
+				      unsigned int sectorSize, int64_t size)
+{
+	TrackInfo ti;
+	ti.track.number = 1;
+	ti.track.mode = mode;
+	ti.track.sectorSize = sectorSize;
+	ti.track.lba = 0;
+	ti.track.length = (uint32_t)(size / sectorSize);
+	ti.file = file;
+	ti.fileOffset = 0;
+	tracks.push_back(ti);
+	leadOut = ti.track.length;
+}
+
+/**
+ * Parse an MSF timestamp. ("mm:ss:ff")
+ * @param str Timestamp.
+ * @return Number of frames, or -1 on error.
+ */
+int DiscImagePrivate::parseMsf(const string &str)
+{
+	unsigned int m, s, f;
+	char c;
+	if (sscanf(str.c_str(), "%u:%u:%u%c", &m, &s, &f, &c) != 3)
+		return -1;
+	if (s >= 60 || f >= 75)
+		return -1;
+	return (int)((m * 60 + s) * 75 + f);
+}
+
+/**
+ * Split a CUE sheet line into tokens.
+ * Quoted tokens may contain spaces.
+ * @param line Line.
+ * @return Tokens.
+ */
+vector<string> DiscImagePrivate::tokenize(const string &line)
+{
+	vector<string> tokens;
+	size_t i = 0;
+	while (i < line.size()) {
+		if (isspace((unsigned char)line[i])) {
+			i++;
+			continue;
+		}
+
+		string token;
+		if (line[i] == '"') {
+			// Quoted token.
+			i++;
+			while (i < line.size() && line[i] != '"') {
+				token += line[i++];
+			}
+			i++;
+		} else {
+			while (i < line.size() && !isspace((unsigned char)line[i])) {
+				token += line[i++];
+			}
+		}
+		tokens.push_back(token);
+	}
+	return tokens;
+}
+
+/**
+ * Open a CUE sheet.
+ * @param filename CUE filename.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int DiscImagePrivate::openCue(const string &filename)
+{
+	FILE *f = fopen(filename.c_str(), "r");
+	if (!f)
+		return (errno != 0 ? -errno : -EIO);
+
+	// FILE entries are relative to the CUE sheet's directory.
+	string dir;
+	size_t slash = filename.find_last_of("/\\");
+	if (slash != string::npos)
+		dir = filename.substr(0, slash + 1);
+
+	// Track entries as parsed from the CUE sheet.
+	struct CueTrack {
+		int number;
+		DiscImage::TrackMode mode;
+		unsigned int sectorSize;
+		int file;
+		int index1;	// INDEX 01, in frames relative to the file.
+		int pregap;	// PREGAP, in frames. (not stored)
+		int postgap;	// POSTGAP, in frames. (not stored)
+	};
+	vector<CueTrack> cueTracks;
+
+	int ret = 0;
+	int curFile = -1;
+	char buf[1024];
+	while (ret == 0 && fgets(buf, sizeof(buf), f)) {
+		vector<string> tok = tokenize(buf);
+		if (tok.empty())
+			continue;
+		string cmd = tok[0];
+		for (size_t i = 0; i < cmd.size(); i++) {
+			cmd[i] = toupper((unsigned char)cmd[i]);
+		}
+
+		if (cmd == "FILE") {
+			// Only BINARY files are supported.
+			if (tok.size() < 3 || tok[2] != "BINARY") {
+				ret = -ENOTSUP;
+				break;
+			}
+			string binFilename = tok[1];
+			if (binFilename.empty() ||
+			    (binFilename[0] != '/' && binFilename[0] != '\\' &&
+			     !(binFilename.size() > 1 && binFilename[1] == ':')))
+			{
+				// Relative path.
+				binFilename = dir + binFilename;
+			}
+			curFile = addFile(binFilename);
+			if (curFile < 0) {
+				ret = (errno != 0 ? -errno : -EIO);
+			}
+		} else if (cmd == "TRACK") {
+			if (curFile < 0 || tok.size() < 3) {
+				ret = -EINVAL;
+				break;
+			}
+			CueTrack ct;
+			ct.number = atoi(tok[1].c_str());
+			ct.file = curFile;
+			ct.index1 = -1;
+			ct.pregap = 0;
+			ct.postgap = 0;
+			if (tok[2] == "AUDIO") {
+				ct.mode = DiscImage::TRACK_AUDIO;
+				ct.sectorSize = 2352;
+			} else if (tok[2] == "MODE1/2048") {
+				ct.mode = DiscImage::TRACK_MODE1;
+				ct.sectorSize = 2048;
+			} else if (tok[2] == "MODE1/2352") {
+				ct.mode = DiscImage::TRACK_MODE1;
+				ct.sectorSize = 2352;
+			} else if (tok[2] == "MODE2/2336") {
+				ct.mode = DiscImage::TRACK_MODE2;
+				ct.sectorSize = 2336;
+			} else if (tok[2] == "MODE2/2352") {
+				ct.mode = DiscImage::TRACK_MODE2;
+				ct.sectorSize = 2352;
+			} else {
+				// Unsupported track mode.
+				ret = -ENOTSUP;
+				break;
+			}
+			if (ct.number < 1 || ct.number > 99) {
+				ret = -EINVAL;
+				break;
+			}
+			cueTracks.push_back(ct);
+		} else if (cmd == "INDEX" || cmd == "PREGAP" || cmd == "POSTGAP") {
+			if (cueTracks.empty() || tok.size() < 2) {
+				ret = -EINVAL;
+				break;
+			}
+			const int frames = parseMsf(tok[tok.size() - 1]);
+			if (frames < 0) {
+				ret = -EINVAL;
+				break;
+			}
+			CueTrack &ct = cueTracks.back();
+			if (cmd == "PREGAP") {
+				ct.pregap = frames;
+			} else if (cmd == "POSTGAP") {
+				ct.postgap = frames;
+			} else if (tok.size() >= 3 && atoi(tok[1].c_str()) == 1) {
+				// INDEX 00 is part of the previous track's
+				// data; only INDEX 01 matters here.
+				ct.index1 = frames;
+			}
+		}
+		// Other commands (REM, CATALOG, TITLE, FLAGS, etc.) are ignored.
+	}
+	fclose(f);
+
+	if (ret == 0 && cueTracks.empty())
+		ret = -EINVAL;
+	if (ret != 0)
+		return ret;
+
+	// Lay out the tracks on the disc.
+	uint32_t discPos = 0;	// LBA of the current file's first sector.
+	uint32_t gapFrames = 0;	// Unstored gaps in the current file.
+	for (size_t i = 0; i < cueTracks.size(); i++) {
+		const CueTrack &ct = cueTracks[i];
+		if (ct.index1 < 0)
+			return -EINVAL;
+
+		const bool firstInFile = (i == 0 || cueTracks[i-1].file != ct.file);
+		const bool lastInFile = (i + 1 == cueTracks.size() || cueTracks[i+1].file != ct.file);
+
+		TrackInfo ti;
+		ti.track.number = (uint8_t)ct.number;
+		ti.track.mode = ct.mode;
+		ti.track.sectorSize = (uint16_t)ct.sectorSize;
+		ti.file = ct.file;
+		if (firstInFile) {
+			if (i > 0) {
+				// Previous file ended at the previous track's end.
+				const TrackInfo &prev = tracks.back();
+				discPos = prev.track.lba + prev.track.length + cueTracks[i-1].postgap;
+			}
+			gapFrames = 0;
+			ti.fileOffset = (int64_t)ct.index1 * ct.sectorSize;
+		} else {
+			// Sectors between the previous track's INDEX 01
+			// and this one use the previous track's size.
+			const CueTrack &pct = cueTracks[i-1];
+			ti.fileOffset = tracks.back().fileOffset +
+				(int64_t)(ct.index1 - pct.index1) * pct.sectorSize;
+			gapFrames += pct.postgap;
+		}
+		gapFrames += ct.pregap;
+		ti.track.lba = discPos + gapFrames + ct.index1;
+
+		// Track length.
+		const int64_t fileSize = files[ct.file].size;
+		if (ti.fileOffset > fileSize)
+			return -EINVAL;
+		if (lastInFile) {
+			ti.track.length = (uint32_t)((fileSize - ti.fileOffset) / ct.sectorSize);
+		} else {
+			const int next = cueTracks[i+1].index1;
+			if (next < ct.index1)
+				return -EINVAL;
+			ti.track.length = (uint32_t)(next - ct.index1);
+		}
+		tracks.push_back(ti);
+	}
+
+	const TrackInfo &last = tracks.back();
+	leadOut = last.track.lba + last.track.length + cueTracks.back().postgap;
+	return 0;
+}
+
+/**
+ * Open a CSO image.
+ * @param filename CSO filename.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int DiscImagePrivate::openCso(const string &filename)
+{
+	const int file = addFile(filename);
+	if (file < 0)
+		return (errno != 0 ? -errno : -EIO);
+	FILE *f = files[file].f;
+
+	/**
+	 * CSO header: (little-endian)
+	 * - 0x00: "CISO"
+	 * - 0x04: Header size (uint32_t)
+	 * - 0x08: Uncompressed size (uint64_t)
+	 * - 0x10: Block size (uint32_t)
+	 * - 0x14: Version (uint8_t)
+	 * - 0x15: Index alignment shift (uint8_t)
+	 * - 0x16: Reserved (2 bytes)
+	 * Followed by (blocks + 1) uint32_t index entries.
+	 * Bit 31 set means the block is stored uncompressed.
+	 */
+	uint8_t hdr[24];
+	fseeko(f, 0, SEEK_SET);
+	if (fread(hdr, 1, sizeof(hdr), f) != sizeof(hdr) ||
+	    memcmp(hdr, "CISO", 4) != 0)
+	{
+		return -EINVAL;
+	}
+
+	cso.totalBytes = (uint64_t)getLE32(&hdr[8]) | ((uint64_t)getLE32(&hdr[12]) << 32);
+	cso.blockSize = getLE32(&hdr[16]);
+	cso.align = hdr[21];
+	if (cso.blockSize < 2048 || (cso.blockSize % 2048) != 0 ||
+	    cso.blockSize > 1024*1024 || cso.align > 31 ||
+	    (int64_t)cso.totalBytes <= 0 || cso.totalBytes > (1ULL << 40))
+	{
+		return -EINVAL;
+	}
+
+	const uint64_t blocks = (cso.totalBytes + cso.blockSize - 1) / cso.blockSize;
+	if ((blocks + 1) * 4 + sizeof(hdr) > (uint64_t)files[file].size)
+		return -EINVAL;
+	vector<uint8_t> idx((size_t)(blocks + 1) * 4);
+	if (fread(&idx[0], 1, idx.size(), f) != idx.size())
+		return -EIO;
+	cso.index.resize((size_t)(blocks + 1));
+	for (size_t i = 0; i < cso.index.size(); i++) {
+		cso.index[i] = getLE32(&idx[i * 4]);
+	}
+
+	if (inflateInit2(&cso.zs, -MAX_WBITS) != Z_OK)
+		return -ENOMEM;
+	cso.zsInit = true;
+	cso.block.resize(cso.blockSize);
+
+	isCso = true;
+	addSingleTrack(file, DiscImage::TRACK_MODE1, 2048, (int64_t)cso.totalBytes);
+	return 0;
+}
+
+/**
+ * Read data from a CSO image.
+ * @param pos Position in the uncompressed image.
+ * @param len Length.
+ * @param out Output buffer.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int DiscImagePrivate::readCso(uint64_t pos, unsigned int len, uint8_t *out)
+{
+	FILE *f = files[0].f;
+	while (len > 0) {
+		const int64_t blockNum = (int64_t)(pos / cso.blockSize);
+		const unsigned int blockOffset = (unsigned int)(pos % cso.blockSize);
+		if (blockNum + 1 >= (int64_t)cso.index.size())
+			return -EIO;
+
+		if (blockNum != cso.cachedBlock) {
+			// Read the block.
+			const uint32_t idx0 = cso.index[blockNum];
+			const uint32_t idx1 = cso.index[blockNum + 1];
+			const int64_t start = (int64_t)(idx0 & 0x7FFFFFFF) << cso.align;
+			const int64_t end = (int64_t)(idx1 & 0x7FFFFFFF) << cso.align;
+			if (end < start || end - start > (int64_t)cso.blockSize * 2)
+				return -EIO;
+
+			cso.cachedBlock = -1;
+			if (fseeko(f, start, SEEK_SET) != 0)
+				return -EIO;
+			if (idx0 & 0x80000000) {
+				// Uncompressed block.
+				// NOTE: The last block may be short.
+				const size_t sz = (size_t)(end - start < (int64_t)cso.blockSize
+							? end - start : cso.blockSize);
+				if (fread(&cso.block[0], 1, sz, f) != sz)
+					return -EIO;
+			} else {
+				// Compressed block.
+				cso.compressed.resize((size_t)(end - start));
+				if (cso.compressed.empty() ||
+				    fread(&cso.compressed[0], 1, cso.compressed.size(), f) != cso.compressed.size())
+				{
+					return -EIO;
+				}
+
+				inflateReset(&cso.zs);
+				cso.zs.next_in = &cso.compressed[0];
+				cso.zs.avail_in = (uInt)cso.compressed.size();
+				cso.zs.next_out = &cso.block[0];
+				cso.zs.avail_out = cso.blockSize;
+				const int zret = inflate(&cso.zs, Z_FINISH);
+				if (zret != Z_STREAM_END && zret != Z_BUF_ERROR)
+					return -EIO;
+			}
+			cso.cachedBlock = blockNum;
+		}
+
+		unsigned int n = cso.blockSize - blockOffset;
+		if (n > len)
+			n = len;
+		memcpy(out, &cso.block[blockOffset], n);
+		out += n;
+		pos += n;
+		len -= n;
+	}
+	return 0;
+}
+
+/** DiscImage **/
+
+DiscImage::DiscImage(const string &filename)
+	: d(new DiscImagePrivate())
+{
+	string ext = filename;
+	size_t dot = ext.find_last_of('.');
+	ext = (dot != string::npos ? ext.substr(dot + 1) : string());
+	for (size_t i = 0; i < ext.size(); i++) {
+		ext[i] = tolower((unsigned char)ext[i]);
+	}
+
+	int ret;
+	if (ext == "cue") {
+		ret = d->openCue(filename);
+	} else if (ext == "cso") {
+		ret = d->openCso(filename);
+	} else {
+		// ISO or BIN: Single data track.
+		const int file = d->addFile(filename);
+		ret = (file < 0 ? -ENOENT : 0);
+		if (ret == 0) {
+			const unsigned int sectorSize = (ext == "bin" ? 2352 : 2048);
+			d->addSingleTrack(file, TRACK_MODE1, sectorSize, d->files[file].size);
+		}
+	}
+
+	if (ret != 0 || d->leadOut == 0) {
+		// Error opening the image.
+		close();
+	}
+}
+
+DiscImage::~DiscImage()
+{
+	delete d;
+}
+
+/**
+ * Check if a filename has a supported disc image extension.
+ * @param filename Filename.
+ * @return True if this is a disc image; false if not.
+ */
+bool DiscImage::IsImageFile(const string &filename)
+{
+	size_t dot = filename.find_last_of('.');
+	if (dot == string::npos)
+		return false;
+	string ext = filename.substr(dot + 1);
+	for (size_t i = 0; i < ext.size(); i++) {
+		ext[i] = tolower((unsigned char)ext[i]);
+	}
+	return (ext == "iso" || ext == "bin" || ext == "cue" || ext == "cso");
+}
+
+/**
+ * Check if the disc image was opened successfully.
+ * @return True if open; false if not.
+ */
+bool DiscImage::isOpen(void) const
+{
+	return !d->tracks.empty();
+}
+
+/**
+ * Close the disc image.
+ */
+void DiscImage::close(void)
+{
+	unique_lock<mutex> lock(d->mtx);
+	for (size_t i = 0; i < d->files.size(); i++) {
+		fclose(d->files[i].f);
+	}
+	d->files.clear();
+	d->tracks.clear();
+	d->leadOut = 0;
+}
+
+/**
+ * Get the number of tracks.
+ * @return Number of tracks.
+ */
+int DiscImage::trackCount(void) const
+{
+	return (int)d->tracks.size();
+}
+
+/**
+ * Get a track.
+ * @param idx Track index. (0 == first track)
+ * @return Track, or nullptr if idx is out of range.
+ */
+const DiscImage::Track *DiscImage::track(int idx) const
+{
+	if (idx < 0 || idx >= (int)d->tracks.size())
+		return nullptr;
+	return &d->tracks[idx].track;
+}
+
+/**
+ * Find the track containing an LBA.
+ * Unstored gaps belong to the track before them.
+ * @param lba LBA.
+ * @return Track, or nullptr if lba is out of range.
+ */
+const DiscImage::Track *DiscImage::findTrack(uint32_t lba) const
+{
+	if (lba >= d->leadOut || d->tracks.empty())
+		return nullptr;
+
+	// Binary search for the last track starting at or before lba.
+	int lo = 0, hi = (int)d->tracks.size() - 1;
+	while (lo < hi) {
+		const int mid = (lo + hi + 1) / 2;
+		if (d->tracks[mid].track.lba <= lba)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	return &d->tracks[lo].track;
+}
+
+/**
+ * Get the lead-out LBA, i.e. the total number of sectors.
+ * @return Lead-out LBA.
+ */
+uint32_t DiscImage::leadOut(void) const
+{
+	return d->leadOut;
+}
+
+/**
+ * Read sectors from the image.
+ * All sectors must be in the same track.
+ * @param lba	[in] Starting LBA.
+ * @param count	[in] Number of sectors.
+ * @param out	[out] Output buffer. (count * track sector size)
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int DiscImage::readSectors(uint32_t lba, unsigned int count, uint8_t *out)
+{
+	const Track *trk = findTrack(lba);
+	if (!trk || lba + count > d->leadOut)
+		return -EINVAL;
+	const DiscImagePrivate::TrackInfo *ti =
+		reinterpret_cast<const DiscImagePrivate::TrackInfo*>(trk);
+	const unsigned int sectorSize = trk->sectorSize;
+
+	// Split the request into stored sectors and unstored gaps.
+	// Sectors before the first track are also unstored.
+	unsigned int stored = 0;
+	if (lba >= trk->lba && lba < trk->lba + trk->length) {
+		stored = trk->lba + trk->length - lba;
+		if (stored > count)
+			stored = count;
+	}
+
+	unique_lock<mutex> lock(d->mtx);
+	if (stored > 0) {
+		const int64_t pos = ti->fileOffset + (int64_t)(lba - trk->lba) * sectorSize;
+		if (d->isCso) {
+			int ret = d->readCso((uint64_t)pos, stored * sectorSize, out);
+			if (ret != 0)
+				return ret;
+		} else {
+			FILE *f = d->files[ti->file].f;
+			const size_t len = (size_t)stored * sectorSize;
+			if (fseeko(f, pos, SEEK_SET) != 0 || fread(out, 1, len, f) != len)
+				return -EIO;
+		}
+	}
+
+	// Unstored sectors are zero.
+	if (stored < count) {
+		memset(out + (size_t)stored * sectorSize, 0, (size_t)(count - stored) * sectorSize);
+	}
+	return 0;
+}
+
+}
@@ -0,0 +1,147 @@
+/***************************************************************************
+ * libgenscd: Gens/GS II CD-ROM Handler Library.                           *
+ * DiscImage.hpp: Disc image reader. (ISO, BIN/CUE, CSO)                   *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENSCD_DISCIMAGE_HPP__
+#define __LIBGENSCD_DISCIMAGE_HPP__
+
+// C includes.
+#include <stdint.h>
+
+// C++ includes.
+#include <string>
+
+namespace LibGensCD
+{
+
+class DiscImagePrivate;
+
+/**
+ * Disc image reader.
+ *
+ * Supported formats:
+ * - ISO: Single Mode 1 data track with 2048-byte sectors.
+ * - BIN: Single Mode 1 data track with 2352-byte sectors.
+ * - CUE: Cue sheet with one or more BINARY files.
+ *   Track modes: AUDIO, MODE1/2048, MODE1/2352,
+ *   MODE2/2336, MODE2/2352.
+ * - CSO: Compressed ISO. Blocks ("hunks") of one or
+ *   more sectors are compressed individually with
+ *   deflate, so any sector can be read without
+ *   decompressing the rest of the image.
+ *
+ * Sectors are returned as stored in the image, e.g. 2048 bytes
+ * for ISO and MODE1/2048, and 2352 bytes for AUDIO and
+ * MODE1/2352. Sectors that aren't stored in the image,
+ * e.g. PREGAP, are returned as zeroes.
+ *
+ * readSectors() may be called from multiple threads.
+ */
+class DiscImage
+{
+	public:
+		DiscImage(const std::string &filename);
+		~DiscImage();
+
+	private:
+		friend class DiscImagePrivate;
+		DiscImagePrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGensCD-specific version of Q_DISABLE_COPY().
+		DiscImage(const DiscImage &);
+		DiscImage &operator=(const DiscImage &);
+
+	public:
+		/**
+		 * Check if a filename has a supported disc image extension.
+		 * @param filename Filename.
+		 * @return True if this is a disc image; false if not.
+		 */
+		static bool IsImageFile(const std::string &filename);
+
+		/**
+		 * Check if the disc image was opened successfully.
+		 * @return True if open; false if not.
+		 */
+		bool isOpen(void) const;
+
+		/**
+		 * Close the disc image.
+		 */
+		void close(void);
+
+		// Largest stored sector size.
+		static const unsigned int RAW_SECTOR_SIZE = 2352;
+
+		enum TrackMode {
+			TRACK_AUDIO,		// CD-DA. (2352)
+			TRACK_MODE1,		// Mode 1. (2048 or 2352)
+			TRACK_MODE2,		// Mode 2. (2336 or 2352)
+		};
+
+		struct Track {
+			uint8_t number;		// Track number.
+			TrackMode mode;		// Track mode.
+			uint16_t sectorSize;	// Stored sector size.
+			uint32_t lba;		// Starting LBA. (INDEX 01)
+			uint32_t length;	// Length, in sectors.
+		};
+
+		/**
+		 * Get the number of tracks.
+		 * @return Number of tracks.
+		 */
+		int trackCount(void) const;
+
+		/**
+		 * Get a track.
+		 * @param idx Track index. (0 == first track)
+		 * @return Track, or nullptr if idx is out of range.
+		 */
+		const Track *track(int idx) const;
+
+		/**
+		 * Find the track containing an LBA.
+		 * @param lba LBA.
+		 * @return Track, or nullptr if lba is out of range.
+		 */
+		const Track *findTrack(uint32_t lba) const;
+
+		/**
+		 * Get the lead-out LBA, i.e. the total number of sectors.
+		 * @return Lead-out LBA.
+		 */
+		uint32_t leadOut(void) const;
+
+		/**
+		 * Read sectors from the image.
+		 * All sectors must be in the same track.
+		 * @param lba	[in] Starting LBA.
+		 * @param count	[in] Number of sectors.
+		 * @param out	[out] Output buffer. (count * track sector size)
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int readSectors(uint32_t lba, unsigned int count, uint8_t *out);
+};
+
+}
+
+#endif /* __LIBGENSCD_DISCIMAGE_HPP__ */
@@ -179,7 +179,7 @@ int ScsiBase::read(uint32_t lba, uint16_t block_count,
 
 /**
  * READ TOC: Read the CD-ROM Table of Contents.
- * @param toc		[out] Buffer for Table of Contents.
+ * @param toc		[out] Buffer for Table of Contents. (Lead-out follows the last track.)
  * @param numTracks	[out, opt] Number of tracks.
  * @return 0 on success; SCSI SENSE KEY on error.
  */
@@ -233,7 +233,14 @@ int ScsiBase::readToc(SCSI_CDROM_TOC *toc, int *numTracks)
 			count = num_tracks_data;
 
 		// Copy and byteswap the TOC.
-		for (int track = 0; track < count; track++) {
+		// The lead-out entry follows the last track, if present.
+		int entries = count;
+		if (count < (int)(sizeof(resp.toc.Tracks)/sizeof(resp.toc.Tracks[0])) &&
+		    ((resp.DataLen - 2) / (int)sizeof(resp.toc.Tracks[0])) > count)
+		{
+			entries++;
+		}
+		for (int track = 0; track < entries; track++) {
 			toc->Tracks[track].rsvd1 = resp.toc.Tracks[track].rsvd1;
 			toc->Tracks[track].ControlADR = resp.toc.Tracks[track].ControlADR;
 			toc->Tracks[track].TrackNumber = resp.toc.Tracks[track].TrackNumber;
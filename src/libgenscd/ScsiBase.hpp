@@ -125,7 +125,7 @@ class ScsiBase
 
 		/**
 		 * READ TOC: Read the CD-ROM Table of Contents.
-		 * @param toc		[out] Buffer for Table of Contents.
+		 * @param toc		[out] Buffer for Table of Contents. (Lead-out follows the last track.)
 		 * @param numTracks	[out, opt] Number of tracks.
 		 * @return 0 on success; SCSI SENSE KEY on error.
 		 */
@@ -0,0 +1,1110 @@
+/***************************************************************************
+ * libgenscd: Gens/GS II CD-ROM Handler Library.                           *
+ * ScsiImage.cpp: Disc image SCSI handler.                                 *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#include "ScsiImage.hpp"
+#include "DiscImage.hpp"
+
+// C includes. (C++ namespace)
+#include <cstring>
+#include <cstdio>
+
+// C++ includes.
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+using std::condition_variable;
+using std::mutex;
+using std::string;
+using std::thread;
+using std::unique_lock;
+using std::unordered_map;
+using std::vector;
+
+// TODO: Byteorder headers from LibGens.
+// Assuming LE host for now.
+#define __swab16(x) (((x) << 8) | ((x) >> 8))
+
+#define __swab32(x) \
+	(((x) << 24) | ((x) >> 24) | \
+		(((x) & 0x0000FF00UL) << 8) | \
+		(((x) & 0x00FF0000UL) >> 8))
+
+#define be16_to_cpu(x)	__swab16(x)
+#define be32_to_cpu(x)	__swab32(x)
+#define cpu_to_be16(x)	__swab16(x)
+#define cpu_to_be32(x)	__swab32(x)
+
+// SCSI commands.
+#include "scsi_protocol.h"
+
+// SCSI errors returned by the emulated commands.
+#define SCSI_ERR_INVALID_OPCODE		0x52000	/* ILLEGAL REQUEST: Invalid command operation code */
+#define SCSI_ERR_LBA_OUT_OF_RANGE	0x52100	/* ILLEGAL REQUEST: Logical block address out of range */
+#define SCSI_ERR_INVALID_FIELD		0x52400	/* ILLEGAL REQUEST: Invalid field in CDB */
+#define SCSI_ERR_ILLEGAL_MODE		0x56400	/* ILLEGAL REQUEST: Illegal mode for this track */
+#define SCSI_ERR_UNRECOVERED_READ	0x31100	/* MEDIUM ERROR: Unrecovered read error */
+#define SCSI_ERR_NO_MEDIUM		0x23A00	/* NOT READY: Medium not present */
+
+namespace LibGensCD
+{
+
+/**
+ * LRU sector cache.
+ * Entries are kept in a doubly-linked list of slot indexes,
+ * with the most recently used sector at the head.
+ * NOTE: Not thread-safe; the caller must hold a lock.
+ */
+class SectorCache
+{
+	public:
+		SectorCache() : head(-1), tail(-1) { }
+
+		/**
+		 * Resize the cache. This clears all entries.
+		 * @param slots Number of sector slots.
+		 */
+		void resize(unsigned int slots)
+		{
+			data.assign((size_t)slots * DiscImage::RAW_SECTOR_SIZE, 0);
+			entries.assign(slots, Entry());
+			map.clear();
+			map.reserve(slots);
+			freeSlots.clear();
+			for (int i = (int)slots - 1; i >= 0; i--) {
+				freeSlots.push_back(i);
+			}
+			head = tail = -1;
+		}
+
+		inline unsigned int capacity(void) const
+			{ return (unsigned int)entries.size(); }
+
+		inline bool contains(uint32_t lba) const
+			{ return (map.find(lba) != map.end()); }
+
+		/**
+		 * Look up a sector and mark it as most recently used.
+		 * @param lba LBA.
+		 * @return Sector data, or nullptr if not cached.
+		 */
+		const uint8_t *lookup(uint32_t lba)
+		{
+			unordered_map<uint32_t, int>::const_iterator iter = map.find(lba);
+			if (iter == map.end())
+				return nullptr;
+			const int slot = iter->second;
+			unlink(slot);
+			pushFront(slot);
+			return &data[(size_t)slot * DiscImage::RAW_SECTOR_SIZE];
+		}
+
+		/**
+		 * Add a sector, evicting the least recently used sector if necessary.
+		 * @param lba LBA.
+		 * @param sector Sector data.
+		 * @param size Sector size.
+		 * @return True if added; false if already cached or the cache is disabled.
+		 */
+		bool insert(uint32_t lba, const uint8_t *sector, unsigned int size)
+		{
+			if (entries.empty() || contains(lba))
+				return false;
+
+			int slot;
+			if (!freeSlots.empty()) {
+				slot = freeSlots.back();
+				freeSlots.pop_back();
+			} else {
+				// Evict the least recently used sector.
+				slot = tail;
+				unlink(slot);
+				map.erase(entries[slot].lba);
+			}
+
+			entries[slot].lba = lba;
+			memcpy(&data[(size_t)slot * DiscImage::RAW_SECTOR_SIZE], sector, size);
+			map[lba] = slot;
+			pushFront(slot);
+			return true;
+		}
+
+	private:
+		struct Entry {
+			uint32_t lba;
+			int prev, next;
+			Entry() : lba(0), prev(-1), next(-1) { }
+		};
+
+		vector<uint8_t> data;
+		vector<Entry> entries;
+		vector<int> freeSlots;
+		unordered_map<uint32_t, int> map;
+		int head, tail;
+
+		void unlink(int slot)
+		{
+			Entry &e = entries[slot];
+			if (e.prev >= 0)
+				entries[e.prev].next = e.next;
+			else
+				head = e.next;
+			if (e.next >= 0)
+				entries[e.next].prev = e.prev;
+			else
+				tail = e.prev;
+			e.prev = e.next = -1;
+		}
+
+		void pushFront(int slot)
+		{
+			Entry &e = entries[slot];
+			e.prev = -1;
+			e.next = head;
+			if (head >= 0)
+				entries[head].prev = slot;
+			head = slot;
+			if (tail < 0)
+				tail = slot;
+		}
+};
+
+class ScsiImagePrivate
+{
+	public:
+		ScsiImagePrivate(ScsiImage *q, const string &filename);
+		~ScsiImagePrivate();
+
+	private:
+		ScsiImage *const q;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGensCD-specific version of Q_DISABLE_COPY().
+		ScsiImagePrivate(const ScsiImagePrivate &);
+		ScsiImagePrivate &operator=(const ScsiImagePrivate &);
+
+	public:
+		// Disc image.
+		DiscImage *image;
+
+		// Sector cache.
+		// mtx protects everything below.
+		mutable mutex mtx;
+		SectorCache cache;
+		unsigned int cacheSizeMB;
+		ScsiImage::CacheStats stats;
+
+		/** Read-ahead. **/
+
+		// Read-ahead window, in sectors.
+		static const unsigned int PREFETCH_WINDOW_MIN = 32;
+		static const unsigned int PREFETCH_WINDOW_MAX = 512;
+		// Sectors read by the prefetch thread at once.
+		static const unsigned int PREFETCH_CHUNK = 32;
+
+		uint32_t lastEnd;	// End of the last read, for sequential detection.
+		unsigned int window;	// Current read-ahead window.
+		uint32_t pfStart;	// Pending read-ahead range. [pfStart, pfEnd)
+		uint32_t pfEnd;
+		uint32_t pfHigh;	// End of the most recent read-ahead request.
+		uint32_t inflightStart;	// Sectors being read by the prefetch thread.
+		uint32_t inflightEnd;	// [inflightStart, inflightEnd)
+
+		thread pfThread;
+		condition_variable cvPrefetch;	// Signals the prefetch thread.
+		condition_variable cvDone;	// Signaled when a chunk has been read.
+		bool quit;
+
+		/**
+		 * Prefetch thread.
+		 * @param d ScsiImagePrivate.
+		 */
+		static void prefetchThread(ScsiImagePrivate *d);
+
+		/**
+		 * Start the prefetch thread.
+		 */
+		void startThread(void);
+
+		/**
+		 * Stop the prefetch thread.
+		 */
+		void stopThread(void);
+
+		/**
+		 * Maximum read-ahead window for the current cache size.
+		 * @return Maximum read-ahead window, in sectors.
+		 */
+		inline unsigned int maxWindow(void) const
+		{
+			const unsigned int w = cache.capacity() / 4;
+			return (w < PREFETCH_WINDOW_MAX ? w : PREFETCH_WINDOW_MAX);
+		}
+
+		/**
+		 * Update the access pattern and schedule read-ahead.
+		 * Caller must hold mtx.
+		 * @param trk Track.
+		 * @param lba Starting LBA.
+		 * @param count Number of sectors.
+		 */
+		void updatePattern(const DiscImage::Track *trk, uint32_t lba, unsigned int count);
+
+		/**
+		 * Get the number of sectors that can be read at once,
+		 * i.e. up to the start of the next track.
+		 * @param lba Starting LBA.
+		 * @param count Number of sectors requested.
+		 * @return Number of sectors in the same track as lba.
+		 */
+		unsigned int runLength(uint32_t lba, unsigned int count) const;
+
+		/**
+		 * Read sectors through the sector cache.
+		 * All sectors must be in the same track.
+		 * @param trk	[in] Track.
+		 * @param lba	[in] Starting LBA.
+		 * @param count	[in] Number of sectors.
+		 * @param out	[out] Output buffer. (count * trk->sectorSize)
+		 * @return 0 on success; negative POSIX error code on error.
+		 */
+		int readSectors(const DiscImage::Track *trk, uint32_t lba, unsigned int count, uint8_t *out);
+
+		/** SCSI command emulation. **/
+
+		/**
+		 * Copy a response to the data buffer.
+		 * @param data Data buffer.
+		 * @param data_len Length of data.
+		 * @param resp Response.
+		 * @param resp_len Length of resp.
+		 */
+		static inline void copyResp(void *data, size_t data_len, const void *resp, size_t resp_len)
+		{
+			memcpy(data, resp, (data_len < resp_len ? data_len : resp_len));
+		}
+
+		int cmdInquiry(const uint8_t *cdb, void *data, size_t data_len);
+		int cmdRead10(const uint8_t *cdb, void *data, size_t data_len);
+		int cmdReadToc(const uint8_t *cdb, void *data, size_t data_len);
+		int cmdGetConfiguration(const uint8_t *cdb, void *data, size_t data_len);
+		int cmdReadDiscInformation(const uint8_t *cdb, void *data, size_t data_len);
+		int cmdReadCD(const uint8_t *cdb, void *data, size_t data_len);
+
+		/**
+		 * Get the offset of the user data in a stored sector.
+		 * @param trk Data track.
+		 * @return Offset of the 2048-byte user data.
+		 */
+		static unsigned int userDataOffset(const DiscImage::Track *trk);
+
+		/**
+		 * Build a full 2352-byte sector from a stored sector.
+		 * @param trk	[in] Track.
+		 * @param lba	[in] LBA.
+		 * @param src	[in] Stored sector.
+		 * @param out	[out] 2352-byte sector.
+		 */
+		static void makeRawSector(const DiscImage::Track *trk, uint32_t lba,
+					  const uint8_t *src, uint8_t *out);
+
+		/**
+		 * Calculate the EDC and ECC for a Mode 1 sector.
+		 * @param sector 2352-byte sector with sync, header, and user data.
+		 */
+		static void encodeMode1(uint8_t *sector);
+};
+
+/** ScsiImagePrivate **/
+
+ScsiImagePrivate::ScsiImagePrivate(ScsiImage *q, const string &filename)
+	: q(q)
+	, image(new DiscImage(filename))
+	, cacheSizeMB(0)
+	, lastEnd(~0U)
+	, window(PREFETCH_WINDOW_MIN)
+	, pfStart(0)
+	, pfEnd(0)
+	, pfHigh(0)
+	, inflightStart(0)
+	, inflightEnd(0)
+	, quit(false)
+{
+	memset(&stats, 0, sizeof(stats));
+	cacheSizeMB = ScsiImage::DEFAULT_CACHE_SIZE_MB;
+	cache.resize((cacheSizeMB << 20) / DiscImage::RAW_SECTOR_SIZE);
+	if (image->isOpen()) {
+		startThread();
+	}
+}
+
+ScsiImagePrivate::~ScsiImagePrivate()
+{
+	stopThread();
+	delete image;
+}
+
+/**
+ * Start the prefetch thread.
+ */
+void ScsiImagePrivate::startThread(void)
+{
+	quit = false;
+	pfThread = thread(prefetchThread, this);
+}
+
+/**
+ * Stop the prefetch thread.
+ */
+void ScsiImagePrivate::stopThread(void)
+{
+	if (!pfThread.joinable())
+		return;
+
+	{
+		unique_lock<mutex> lock(mtx);
+		quit = true;
+	}
+	cvPrefetch.notify_one();
+	pfThread.join();
+}
+
+/**
+ * Prefetch thread.
+ * @param d ScsiImagePrivate.
+ */
+void ScsiImagePrivate::prefetchThread(ScsiImagePrivate *d)
+{
+	vector<uint8_t> buf(PREFETCH_CHUNK * DiscImage::RAW_SECTOR_SIZE);
+
+	unique_lock<mutex> lock(d->mtx);
+	while (!d->quit) {
+		if (d->pfStart >= d->pfEnd) {
+			// Nothing to read.
+			d->cvPrefetch.wait(lock);
+			continue;
+		}
+
+		// Read the next chunk.
+		// updatePattern() limits requests to a single track.
+		const uint32_t start = d->pfStart;
+		unsigned int n = d->pfEnd - start;
+		if (n > PREFETCH_CHUNK)
+			n = PREFETCH_CHUNK;
+		const DiscImage::Track *trk = d->image->findTrack(start);
+		d->inflightStart = start;
+		d->inflightEnd = start + n;
+		d->pfStart = start + n;
+
+		lock.unlock();
+		int ret = d->image->readSectors(start, n, buf.data());
+		lock.lock();
+
+		if (ret == 0) {
+			for (unsigned int i = 0; i < n; i++) {
+				if (d->cache.insert(start + i, &buf[i * trk->sectorSize], trk->sectorSize)) {
+					d->stats.prefetched++;
+				}
+			}
+		} else {
+			// Read error. Cancel the read-ahead;
+			// the error will be reported by a foreground read.
+			d->pfStart = d->pfEnd;
+		}
+
+		d->inflightStart = d->inflightEnd = 0;
+		d->cvDone.notify_all();
+	}
+}
+
+/**
+ * Update the access pattern and schedule read-ahead.
+ * Caller must hold mtx.
+ * @param trk Track.
+ * @param lba Starting LBA.
+ * @param count Number of sectors.
+ */
+void ScsiImagePrivate::updatePattern(const DiscImage::Track *trk, uint32_t lba, unsigned int count)
+{
+	const uint32_t end = lba + count;
+	const bool sequential = (lba == lastEnd);
+	lastEnd = end;
+
+	const unsigned int wmax = maxWindow();
+	if (!sequential || wmax == 0) {
+		// Random access. Cancel the read-ahead.
+		window = PREFETCH_WINDOW_MIN;
+		pfStart = pfEnd;
+		return;
+	}
+
+	// Sequential access. Grow the read-ahead window.
+	window *= 2;
+	if (window > wmax)
+		window = wmax;
+
+	// Read-ahead stays within the current track.
+	uint32_t pfLimit = end + window;
+	const uint32_t trkEnd = trk->lba + trk->length;
+	if (pfLimit > trkEnd)
+		pfLimit = trkEnd;
+
+	// Don't request sectors that have already been requested.
+	uint32_t start = end;
+	if (pfHigh > start && pfHigh <= pfLimit)
+		start = pfHigh;
+	if (start >= pfLimit)
+		return;
+
+	if (pfStart < pfEnd && pfEnd == start) {
+		// Extend the pending request.
+		pfEnd = pfLimit;
+	} else {
+		pfStart = start;
+		pfEnd = pfLimit;
+	}
+	pfHigh = pfLimit;
+	cvPrefetch.notify_one();
+}
+
+/**
+ * Get the number of sectors that can be read at once,
+ * i.e. up to the start of the next track.
+ * @param lba Starting LBA.
+ * @param count Number of sectors requested.
+ * @return Number of sectors in the same track as lba.
+ */
+unsigned int ScsiImagePrivate::runLength(uint32_t lba, unsigned int count) const
+{
+	uint32_t end = image->leadOut();
+	const int tracks = image->trackCount();
+	for (int i = 0; i < tracks; i++) {
+		const uint32_t start = image->track(i)->lba;
+		if (start > lba) {
+			// Next track. (Sectors before the first
+			// track are part of the first track.)
+			if (i > 0)
+				end = start;
+			break;
+		}
+	}
+	if (lba < image->track(0)->lba)
+		end = image->track(0)->lba;
+
+	return (end - lba < count ? end - lba : count);
+}
+
+/**
+ * Read sectors through the sector cache.
+ * All sectors must be in the same track.
+ * @param trk	[in] Track.
+ * @param lba	[in] Starting LBA.
+ * @param count	[in] Number of sectors.
+ * @param out	[out] Output buffer. (count * trk->sectorSize)
+ * @return 0 on success; negative POSIX error code on error.
+ */
+int ScsiImagePrivate::readSectors(const DiscImage::Track *trk, uint32_t lba, unsigned int count, uint8_t *out)
+{
+	const unsigned int sectorSize = trk->sectorSize;
+
+	unique_lock<mutex> lock(mtx);
+	updatePattern(trk, lba, count);
+
+	unsigned int i = 0;
+	while (i < count) {
+		const uint32_t cur = lba + i;
+		const uint8_t *sector = cache.lookup(cur);
+		if (sector) {
+			// Cache hit.
+			memcpy(out + i * sectorSize, sector, sectorSize);
+			stats.hits++;
+			i++;
+			continue;
+		}
+
+		if (cur >= inflightStart && cur < inflightEnd) {
+			// The prefetch thread is reading this sector.
+			cvDone.wait(lock);
+			continue;
+		}
+
+		// Cache miss. Read up to the next cached or in-flight sector.
+		unsigned int n = 1;
+		while (i + n < count) {
+			const uint32_t next = cur + n;
+			if (cache.contains(next) || (next >= inflightStart && next < inflightEnd))
+				break;
+			n++;
+		}
+
+		lock.unlock();
+		int ret = image->readSectors(cur, n, out + i * sectorSize);
+		lock.lock();
+		if (ret != 0)
+			return ret;
+
+		stats.misses += n;
+		for (unsigned int j = 0; j < n; j++) {
+			cache.insert(cur + j, out + (i + j) * sectorSize, sectorSize);
+		}
+		i += n;
+	}
+
+	return 0;
+}
+
+/**
+ * Get the offset of the user data in a stored sector.
+ * @param trk Data track.
+ * @return Offset of the 2048-byte user data.
+ */
+unsigned int ScsiImagePrivate::userDataOffset(const DiscImage::Track *trk)
+{
+	switch (trk->sectorSize) {
+		case 2352:
+			// Sync (12), header (4), and Mode 2 subheader (8).
+			return (trk->mode == DiscImage::TRACK_MODE2 ? 24 : 16);
+		case 2336:
+			// Mode 2 subheader.
+			return 8;
+		case 2048:
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Calculate the EDC and ECC for a Mode 1 sector.
+ * @param sector 2352-byte sector with sync, header, and user data.
+ */
+void ScsiImagePrivate::encodeMode1(uint8_t *sector)
+{
+	// Lookup tables.
+	// NOTE: Function-local statics are initialized once
+	// in a thread-safe manner in C++11.
+	static const struct EccTables {
+		uint8_t ecc_f[256];
+		uint8_t ecc_b[256];
+		uint32_t edc[256];
+
+		EccTables() {
+			for (unsigned int i = 0; i < 256; i++) {
+				const unsigned int j = (i << 1) ^ ((i & 0x80) ? 0x11D : 0);
+				ecc_f[i] = (uint8_t)j;
+				ecc_b[i ^ j] = (uint8_t)i;
+				uint32_t edc_val = i;
+				for (int k = 0; k < 8; k++) {
+					edc_val = (edc_val >> 1) ^ ((edc_val & 1) ? 0xD8018001 : 0);
+				}
+				edc[i] = edc_val;
+			}
+		}
+	} tbl;
+
+	// EDC: Covers the sync, header, and user data.
+	uint32_t edc = 0;
+	for (unsigned int i = 0; i < 0x810; i++) {
+		edc = (edc >> 8) ^ tbl.edc[(edc ^ sector[i]) & 0xFF];
+	}
+	sector[0x810] = (edc & 0xFF);
+	sector[0x811] = ((edc >> 8) & 0xFF);
+	sector[0x812] = ((edc >> 16) & 0xFF);
+	sector[0x813] = ((edc >> 24) & 0xFF);
+	memset(&sector[0x814], 0, 8);
+
+	// ECC: P parity, then Q parity. Both cover the header.
+	static const struct {
+		unsigned int major_count, minor_count, major_mult, minor_inc, dest;
+	} ecc_blocks[2] = {
+		{86, 24, 2, 86, 0x81C},	// P
+		{52, 43, 86, 88, 0x8C8},	// Q
+	};
+	const uint8_t *const src = &sector[0x0C];
+	for (int b = 0; b < 2; b++) {
+		const unsigned int major_count = ecc_blocks[b].major_count;
+		const unsigned int minor_count = ecc_blocks[b].minor_count;
+		const unsigned int size = major_count * minor_count;
+		uint8_t *const dest = &sector[ecc_blocks[b].dest];
+		for (unsigned int major = 0; major < major_count; major++) {
+			unsigned int index = (major >> 1) * ecc_blocks[b].major_mult + (major & 1);
+			uint8_t ecc_a = 0, ecc_b = 0;
+			for (unsigned int minor = 0; minor < minor_count; minor++) {
+				const uint8_t temp = src[index];
+				index += ecc_blocks[b].minor_inc;
+				if (index >= size)
+					index -= size;
+				ecc_a ^= temp;
+				ecc_b ^= temp;
+				ecc_a = tbl.ecc_f[ecc_a];
+			}
+			ecc_a = tbl.ecc_b[tbl.ecc_f[ecc_a] ^ ecc_b];
+			dest[major] = ecc_a;
+			dest[major + major_count] = ecc_a ^ ecc_b;
+		}
+	}
+}
+
+/**
+ * Build a full 2352-byte sector from a stored sector.
+ * @param trk	[in] Track.
+ * @param lba	[in] LBA.
+ * @param src	[in] Stored sector.
+ * @param out	[out] 2352-byte sector.
+ */
+void ScsiImagePrivate::makeRawSector(const DiscImage::Track *trk, uint32_t lba,
+				     const uint8_t *src, uint8_t *out)
+{
+	if (trk->sectorSize == DiscImage::RAW_SECTOR_SIZE) {
+		// Sector is stored as-is.
+		memcpy(out, src, DiscImage::RAW_SECTOR_SIZE);
+		return;
+	}
+
+	// Sync field.
+	out[0] = 0x00;
+	memset(&out[1], 0xFF, 10);
+	out[11] = 0x00;
+
+	// Header: MSF address (BCD), then the mode.
+	const uint32_t pos = lba + 150;
+	const uint8_t m = (uint8_t)(pos / (60*75));
+	const uint8_t s = (uint8_t)((pos / 75) % 60);
+	const uint8_t f = (uint8_t)(pos % 75);
+	out[12] = ((m / 10) << 4) | (m % 10);
+	out[13] = ((s / 10) << 4) | (s % 10);
+	out[14] = ((f / 10) << 4) | (f % 10);
+
+	if (trk->mode == DiscImage::TRACK_MODE2) {
+		// Mode 2: Subheader and data are stored.
+		out[15] = 2;
+		memcpy(&out[16], src, 2336);
+	} else {
+		// Mode 1: Only the user data is stored.
+		out[15] = 1;
+		memcpy(&out[16], src, 2048);
+		encodeMode1(out);
+	}
+}
+
+/**
+ * INQUIRY
+ */
+int ScsiImagePrivate::cmdInquiry(const uint8_t *cdb, void *data, size_t data_len)
+{
+	((void)cdb);
+
+	SCSI_RESP_INQUIRY_STD resp;
+	memset(&resp, 0x00, sizeof(resp));
+	resp.PeripheralDeviceType = SCSI_DEVICE_TYPE_CDROM;
+	resp.RMB_DeviceTypeModifier = 0x80;	// Removable medium.
+	resp.Version = 0x05;			// SPC-3
+	resp.ResponseDataFormat = 0x02;
+	resp.AdditionalLength = (uint8_t)(sizeof(resp) - 5);
+	memcpy(resp.vendor_id, "GENS    ", sizeof(resp.vendor_id));
+	memcpy(resp.product_id, "Disc Image      ", sizeof(resp.product_id));
+	memcpy(resp.product_revision_level, "1.0 ", sizeof(resp.product_revision_level));
+
+	copyResp(data, data_len, &resp, sizeof(resp));
+	return 0;
+}
+
+/**
+ * READ(10)
+ * Returns 2048-byte user data from data tracks.
+ */
+int ScsiImagePrivate::cmdRead10(const uint8_t *cdb, void *data, size_t data_len)
+{
+	const SCSI_CDB_READ_10 *cdb10 = reinterpret_cast<const SCSI_CDB_READ_10*>(cdb);
+	uint32_t lba = be32_to_cpu(cdb10->LBA);
+	unsigned int count = (uint16_t)be16_to_cpu(cdb10->TransferLen);
+
+	if (lba >= image->leadOut() || count > image->leadOut() - lba)
+		return SCSI_ERR_LBA_OUT_OF_RANGE;
+	if (data_len < (size_t)count * 2048)
+		return SCSI_ERR_INVALID_FIELD;
+
+	uint8_t *out = static_cast<uint8_t*>(data);
+	vector<uint8_t> buf;
+	while (count > 0) {
+		const DiscImage::Track *trk = image->findTrack(lba);
+		if (trk->mode == DiscImage::TRACK_AUDIO)
+			return SCSI_ERR_ILLEGAL_MODE;
+
+		const unsigned int n = runLength(lba, count);
+
+		int ret;
+		if (trk->sectorSize == 2048) {
+			// Read directly into the output buffer.
+			ret = readSectors(trk, lba, n, out);
+		} else {
+			buf.resize((size_t)n * trk->sectorSize);
+			ret = readSectors(trk, lba, n, buf.data());
+			if (ret == 0) {
+				const unsigned int offset = userDataOffset(trk);
+				for (unsigned int i = 0; i < n; i++) {
+					memcpy(out + i * 2048, &buf[i * trk->sectorSize + offset], 2048);
+				}
+			}
+		}
+		if (ret != 0)
+			return SCSI_ERR_UNRECOVERED_READ;
+
+		out += n * 2048;
+		lba += n;
+		count -= n;
+	}
+
+	return 0;
+}
+
+/**
+ * READ TOC
+ * Only the standard TOC format is supported.
+ */
+int ScsiImagePrivate::cmdReadToc(const uint8_t *cdb, void *data, size_t data_len)
+{
+	const SCSI_CDB_READ_TOC *cdbToc = reinterpret_cast<const SCSI_CDB_READ_TOC*>(cdb);
+	if ((cdbToc->Format & 0x0F) != 0)
+		return SCSI_ERR_INVALID_FIELD;
+	const bool msf = !!(cdbToc->MSF & SCSI_BIT_READ_TOC_MSF_MSF);
+
+	SCSI_RESP_READ_TOC resp;
+	memset(&resp, 0x00, sizeof(resp));
+
+	const int count = image->trackCount();
+	resp.toc.FirstTrackNumber = image->track(0)->number;
+	resp.toc.LastTrackNumber = image->track(count - 1)->number;
+
+	// Tracks, followed by the lead-out.
+	for (int i = 0; i <= count; i++) {
+		SCSI_CDROM_TOC_TRACK *entry = &resp.toc.Tracks[i];
+		uint32_t lba;
+		if (i < count) {
+			const DiscImage::Track *trk = image->track(i);
+			entry->ControlADR = (trk->mode == DiscImage::TRACK_AUDIO ? 0x10 : 0x14);
+			entry->TrackNumber = trk->number;
+			lba = trk->lba;
+		} else {
+			entry->ControlADR = 0x14;
+			entry->TrackNumber = 0xAA;
+			lba = image->leadOut();
+		}
+
+		if (msf) {
+			const uint32_t pos = lba + 150;
+			lba = ((pos / (60*75)) << 16) | (((pos / 75) % 60) << 8) | (pos % 75);
+		}
+		entry->StartAddress = cpu_to_be32(lba);
+	}
+
+	resp.DataLen = (uint16_t)cpu_to_be16(2 + (count + 1) * sizeof(resp.toc.Tracks[0]));
+	copyResp(data, data_len, &resp, sizeof(resp));
+	return 0;
+}
+
+/**
+ * GET CONFIGURATION
+ * Reports a CD-ROM drive with a CD-ROM disc.
+ */
+int ScsiImagePrivate::cmdGetConfiguration(const uint8_t *cdb, void *data, size_t data_len)
+{
+	((void)cdb);
+
+	static const uint8_t resp[] = {
+		// Header.
+		0x00, 0x00, 0x00, 0x20,		// Data length. (excluding this field)
+		0x00, 0x00,
+		0x00, 0x08,			// Current profile: CD-ROM
+
+		// Profile List
+		0x00, 0x00, 0x03, 0x04,
+		0x00, 0x08, 0x01, 0x00,		// CD-ROM (current)
+
+		// Core
+		0x00, 0x01, 0x0B, 0x08,
+		0x00, 0x00, 0x00, 0x01,		// Physical interface: SCSI
+		0x00, 0x00, 0x00, 0x00,
+
+		// CD Read
+		0x00, 0x1E, 0x0B, 0x04,
+		0x00, 0x00, 0x00, 0x00,
+	};
+
+	copyResp(data, data_len, resp, sizeof(resp));
+	return 0;
+}
+
+/**
+ * READ DISC INFORMATION
+ * Reports a finalized single-session disc.
+ */
+int ScsiImagePrivate::cmdReadDiscInformation(const uint8_t *cdb, void *data, size_t data_len)
+{
+	((void)cdb);
+
+	SCSI_RESP_READ_DISC_INFORMATION_STANDARD resp;
+	memset(&resp, 0x00, sizeof(resp));
+
+	const int count = image->trackCount();
+	resp.DiscInfoLength = (uint16_t)cpu_to_be16(sizeof(resp) - 2);
+	resp.DiscStatusFlags = 0x0E;	// Complete session, finalized disc.
+	resp.FirstTrackNumber = image->track(0)->number;
+	resp.NumSessionsLSB = 1;
+	resp.FirstTrackNumberInLastSessionLSB = image->track(0)->number;
+	resp.LastTrackNumberInLastSessionLSB = image->track(count - 1)->number;
+	resp.DiscType = 0x00;		// CD-DA or CD-ROM.
+	resp.LastSessionLeadInStartLBA = 0xFFFFFFFF;
+
+	copyResp(data, data_len, &resp, sizeof(resp));
+	return 0;
+}
+
+/**
+ * READ CD
+ * Supports full 2352-byte sectors and user data only.
+ * Subchannels are not stored in the supported image formats.
+ */
+int ScsiImagePrivate::cmdReadCD(const uint8_t *cdb, void *data, size_t data_len)
+{
+	const SCSI_CDB_READ_CD *cdbCD = reinterpret_cast<const SCSI_CDB_READ_CD*>(cdb);
+	if (cdbCD->Subchannels != SCSI_READ_CD_SUBCHANNELS_NONE)
+		return SCSI_ERR_INVALID_FIELD;
+
+	uint32_t lba = be32_to_cpu(cdbCD->StartingLBA);
+	unsigned int count = (cdbCD->TransferLen[0] << 16) |
+			     (cdbCD->TransferLen[1] << 8) |
+			      cdbCD->TransferLen[2];
+	if (count == 0)
+		return 0;
+	if (lba >= image->leadOut() || count > image->leadOut() - lba)
+		return SCSI_ERR_LBA_OUT_OF_RANGE;
+
+	static const uint8_t FLAGS_FULL =
+		SCSI_BIT_READ_CD_FLAGS_EDC_ECC |
+		SCSI_BIT_READ_CD_FLAGS_USER_DATA |
+		SCSI_BIT_READ_CD_FLAGS_HEADER |
+		SCSI_BIT_READ_CD_FLAGS_SUBHEADER |
+		SCSI_BIT_READ_CD_FLAGS_SYNCH_FIELD;
+	bool full;
+	if (cdbCD->Flags == FLAGS_FULL) {
+		full = true;
+	} else if (cdbCD->Flags == SCSI_BIT_READ_CD_FLAGS_USER_DATA) {
+		full = false;
+	} else {
+		// Other field combinations aren't supported.
+		return SCSI_ERR_INVALID_FIELD;
+	}
+
+	// Expected sector type.
+	const uint8_t sectorType = (cdbCD->SectorType & 0x1C);
+
+	uint8_t *out = static_cast<uint8_t*>(data);
+	uint8_t *const out_end = out + data_len;
+	vector<uint8_t> buf;
+	while (count > 0) {
+		const DiscImage::Track *trk = image->findTrack(lba);
+		const bool audio = (trk->mode == DiscImage::TRACK_AUDIO);
+		if (sectorType != SCSI_READ_CD_SECTORTYPE_ANY &&
+		    (sectorType == SCSI_READ_CD_SECTORTYPE_CDDA) != audio)
+		{
+			// Sector type doesn't match the track.
+			return SCSI_ERR_ILLEGAL_MODE;
+		}
+
+		const unsigned int n = runLength(lba, count);
+
+		// Audio sectors are always 2352 bytes.
+		const unsigned int outSize = ((full || audio) ? DiscImage::RAW_SECTOR_SIZE : 2048);
+		if ((size_t)(out_end - out) < (size_t)n * outSize)
+			return SCSI_ERR_INVALID_FIELD;
+
+		buf.resize((size_t)n * trk->sectorSize);
+		if (readSectors(trk, lba, n, buf.data()) != 0)
+			return SCSI_ERR_UNRECOVERED_READ;
+
+		const unsigned int offset = (audio ? 0 : userDataOffset(trk));
+		for (unsigned int i = 0; i < n; i++) {
+			const uint8_t *src = &buf[i * trk->sectorSize];
+			if (audio) {
+				memcpy(out, src, DiscImage::RAW_SECTOR_SIZE);
+			} else if (full) {
+				makeRawSector(trk, lba + i, src, out);
+			} else {
+				memcpy(out, src + offset, 2048);
+			}
+			out += outSize;
+		}
+
+		lba += n;
+		count -= n;
+	}
+
+	return 0;
+}
+
+/** ScsiImage **/
+
+ScsiImage::ScsiImage(const string& filename)
+	: ScsiBase(filename)
+	, d(new ScsiImagePrivate(this, filename))
+{ }
+
+ScsiImage::~ScsiImage()
+{
+	delete d;
+}
+
+/**
+ * Check if a filename has a supported disc image extension.
+ * @param filename Filename.
+ * @return True if this is a disc image; false if not.
+ */
+bool ScsiImage::IsImageFile(const string &filename)
+{
+	return DiscImage::IsImageFile(filename);
+}
+
+bool ScsiImage::isOpen(void) const
+{
+	return d->image->isOpen();
+}
+
+void ScsiImage::close(void)
+{
+	d->stopThread();
+	d->image->close();
+}
+
+/**
+ * Check if a disc is present.
+ * @return True if a disc is present; false if not.
+ */
+bool ScsiImage::isDiscPresent(void)
+{
+	// Images always have a "disc" if they're open.
+	return d->image->isOpen();
+}
+
+/**
+ * Check if the disc has changed since the last access.
+ * @return True if the disc has changed; false if not.
+ */
+bool ScsiImage::hasDiscChanged(void)
+{
+	// Images can't be changed.
+	return false;
+}
+
+/**
+ * Get the sector cache size.
+ * @return Sector cache size, in MB.
+ */
+unsigned int ScsiImage::cacheSize(void) const
+{
+	unique_lock<mutex> lock(d->mtx);
+	return d->cacheSizeMB;
+}
+
+/**
+ * Set the sector cache size.
+ * This clears the sector cache.
+ * @param mb Sector cache size, in MB. (0 to disable caching)
+ */
+void ScsiImage::setCacheSize(unsigned int mb)
+{
+	unique_lock<mutex> lock(d->mtx);
+
+	// Wait for the prefetch thread to finish the current chunk.
+	d->pfStart = d->pfEnd;
+	while (d->inflightStart != d->inflightEnd) {
+		d->cvDone.wait(lock);
+	}
+
+	d->cacheSizeMB = mb;
+	d->cache.resize((unsigned int)(((uint64_t)mb << 20) / DiscImage::RAW_SECTOR_SIZE));
+	d->pfHigh = 0;
+	d->window = ScsiImagePrivate::PREFETCH_WINDOW_MIN;
+}
+
+/**
+ * Get the sector cache statistics.
+ * @return Sector cache statistics.
+ */
+ScsiImage::CacheStats ScsiImage::cacheStats(void) const
+{
+	unique_lock<mutex> lock(d->mtx);
+	return d->stats;
+}
+
+/**
+ * Send a SCSI command descriptor block to the device.
+ * @param cdb		[in] SCSI command descriptor block.
+ * @param cdb_len	[in] Length of cdb.
+ * @param data		[in/out] Data buffer, or nullptr for SCSI_DATA_NONE operations.
+ * @param data_len	[in] Length of data.
+ * @param mode		[in] Data direction mode. (IN == receive from device; OUT == send to device)
+ * @return 0 on success, positive for SCSI sense key, negative for OS error.
+ */
+int ScsiImage::scsi_send_cdb(const void *cdb, uint8_t cdb_len,
+			     void *data, size_t data_len,
+			     scsi_data_mode mode)
+{
+	if (!cdb || cdb_len < 6)
+		return SCSI_ERR_INVALID_FIELD;
+	if (!d->image->isOpen())
+		return SCSI_ERR_NO_MEDIUM;
+	if (mode == SCSI_DATA_OUT)
+		return SCSI_ERR_INVALID_OPCODE;
+	if (!data)
+		data_len = 0;
+
+	// Make sure the CDB is long enough for its command group.
+	const uint8_t *const cdb8 = static_cast<const uint8_t*>(cdb);
+	static const uint8_t cdbGroupLen[8] = {6, 10, 10, 0, 16, 12, 0, 0};
+	if (cdb_len < cdbGroupLen[cdb8[0] >> 5])
+		return SCSI_ERR_INVALID_FIELD;
+
+	switch (cdb8[0]) {
+		case SCSI_OP_TEST_UNIT_READY:
+			return 0;
+		case SCSI_OP_INQUIRY:
+			return d->cmdInquiry(cdb8, data, data_len);
+		case SCSI_OP_READ_10:
+			return d->cmdRead10(cdb8, data, data_len);
+		case SCSI_OP_READ_TOC:
+			return d->cmdReadToc(cdb8, data, data_len);
+		case SCSI_OP_GET_CONFIGURATION:
+			return d->cmdGetConfiguration(cdb8, data, data_len);
+		case SCSI_OP_READ_DISC_INFORMATION:
+			return d->cmdReadDiscInformation(cdb8, data, data_len);
+		case SCSI_OP_READ_CD:
+			return d->cmdReadCD(cdb8, data, data_len);
+		default:
+			break;
+	}
+
+	// Unsupported command.
+	return SCSI_ERR_INVALID_OPCODE;
+}
+
+}
@@ -0,0 +1,129 @@
+/***************************************************************************
+ * libgenscd: Gens/GS II CD-ROM Handler Library.                           *
+ * ScsiImage.hpp: Disc image SCSI handler.                                 *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBGENSCD_SCSIIMAGE_HPP__
+#define __LIBGENSCD_SCSIIMAGE_HPP__
+
+// ScsiBase class.
+#include "ScsiBase.hpp"
+
+namespace LibGensCD
+{
+
+class ScsiImagePrivate;
+
+/**
+ * SCSI handler for disc images.
+ *
+ * MMC commands are emulated on top of DiscImage, so CdDrive
+ * can use an image file in place of a physical drive.
+ *
+ * Sectors are kept in an LRU cache. If sequential reads are
+ * detected, a background thread reads ahead of the current
+ * position, doubling the read-ahead window on each sequential
+ * read up to a quarter of the cache size.
+ */
+class ScsiImage : public ScsiBase
+{
+	public:
+		ScsiImage(const std::string& filename);
+		virtual ~ScsiImage();
+
+	private:
+		friend class ScsiImagePrivate;
+		ScsiImagePrivate *const d;
+
+		// Q_DISABLE_COPY() equivalent.
+		// TODO: Add LibGensCD-specific version of Q_DISABLE_COPY().
+		ScsiImage(const ScsiImage &);
+		ScsiImage &operator=(const ScsiImage &);
+
+	public:
+		/**
+		 * Check if a filename has a supported disc image extension.
+		 * @param filename Filename.
+		 * @return True if this is a disc image; false if not.
+		 */
+		static bool IsImageFile(const std::string &filename);
+
+		bool isOpen(void) const final;
+		void close(void) final;
+
+		/**
+		 * Check if a disc is present.
+		 * @return True if a disc is present; false if not.
+		 */
+		bool isDiscPresent(void) final;
+
+		/**
+		 * Check if the disc has changed since the last access.
+		 * @return True if the disc has changed; false if not.
+		 */
+		bool hasDiscChanged(void) final;
+
+		/** Sector cache. **/
+
+		// Default sector cache size, in MB.
+		static const unsigned int DEFAULT_CACHE_SIZE_MB = 16;
+
+		/**
+		 * Get the sector cache size.
+		 * @return Sector cache size, in MB.
+		 */
+		unsigned int cacheSize(void) const;
+
+		/**
+		 * Set the sector cache size.
+		 * This clears the sector cache.
+		 * @param mb Sector cache size, in MB. (0 to disable caching)
+		 */
+		void setCacheSize(unsigned int mb);
+
+		struct CacheStats {
+			uint64_t hits;		// Sectors read from the cache.
+			uint64_t misses;	// Sectors read from the image.
+			uint64_t prefetched;	// Sectors read ahead by the prefetch thread.
+		};
+
+		/**
+		 * Get the sector cache statistics.
+		 * @return Sector cache statistics.
+		 */
+		CacheStats cacheStats(void) const;
+
+	protected:
+		/**
+		 * Send a SCSI command descriptor block to the device.
+		 * @param cdb		[in] SCSI command descriptor block.
+		 * @param cdb_len	[in] Length of cdb.
+		 * @param data		[in/out] Data buffer, or nullptr for SCSI_DATA_NONE operations.
+		 * @param data_len	[in] Length of data.
+		 * @param mode		[in] Data direction mode. (IN == receive from device; OUT == send to device)
+		 * @return 0 on success, positive for SCSI sense key, negative for OS error.
+		 */
+		int scsi_send_cdb(const void *cdb, uint8_t cdb_len,
+				  void *data, size_t data_len,
+				  scsi_data_mode mode = SCSI_DATA_IN) final;
+};
+
+}
+
+#endif /* __LIBGENSCD_SCSIIMAGE_HPP__ */
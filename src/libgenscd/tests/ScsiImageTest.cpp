@@ -0,0 +1,619 @@
+/***************************************************************************
+ * libgenscd/tests: Gens/GS II CD-ROM Handler Library. (Test Suite)        *
+ * ScsiImageTest.cpp: Disc image SCSI handler tests.                       *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+// LibGensCD.
+#include "CdDrive.hpp"
+#include "ScsiImage.hpp"
+#include "genscd_iso9660.h"
+
+// zlib for CSO images.
+#include <zlib.h>
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ includes.
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+using std::string;
+using std::vector;
+
+namespace LibGensCD { namespace Tests {
+
+class ScsiImageTest : public ::testing::Test
+{
+	protected:
+		ScsiImageTest()
+			: ::testing::Test() { }
+		virtual ~ScsiImageTest() { }
+
+	public:
+		static void SetUpTestCase(void);
+		static void TearDownTestCase(void);
+
+		static const char ISO_FILENAME[];
+		static const char BIN_FILENAME[];
+		static const char CUE_FILENAME[];
+		static const char CSO_FILENAME[];
+		static const char BENCH_FILENAME[];
+
+		// Number of sectors in the ISO image.
+		static const unsigned int ISO_SECTORS = 200;
+
+		// Mixed-mode BIN/CUE layout.
+		static const unsigned int BIN_DATA_SECTORS = 100;	// Track 1: MODE1/2352
+		static const unsigned int BIN_PREGAP = 150;		// Track 2: PREGAP (not stored)
+		static const unsigned int BIN_AUDIO_SECTORS = 300;	// Track 2: AUDIO
+
+		// Volume label.
+		static const char VOLUME_LABEL[];
+
+		/**
+		 * Get the expected user data for a sector.
+		 * @param lba LBA, relative to the start of the data track.
+		 * @param out 2048-byte buffer.
+		 */
+		static void userData(uint32_t lba, uint8_t *out);
+
+		/**
+		 * Get the expected audio data for a sector.
+		 * @param lba LBA, relative to the start of the audio track.
+		 * @param out 2352-byte buffer.
+		 */
+		static void audioData(uint32_t lba, uint8_t *out);
+
+		/**
+		 * Write an ISO image.
+		 * @param filename Filename.
+		 * @param sectors Number of sectors.
+		 * @return True on success; false on error.
+		 */
+		static bool writeIso(const char *filename, unsigned int sectors);
+
+		/**
+		 * Calculate a CD-ROM EDC. (bitwise reference implementation)
+		 * @param data Data.
+		 * @param len Length of data.
+		 * @return EDC.
+		 */
+		static uint32_t edc(const uint8_t *data, size_t len);
+};
+
+const char ScsiImageTest::ISO_FILENAME[] = "ScsiImageTest.iso";
+const char ScsiImageTest::BIN_FILENAME[] = "ScsiImageTest.bin";
+const char ScsiImageTest::CUE_FILENAME[] = "ScsiImageTest.cue";
+const char ScsiImageTest::CSO_FILENAME[] = "ScsiImageTest.cso";
+const char ScsiImageTest::BENCH_FILENAME[] = "ScsiImageTest_bench.iso";
+const char ScsiImageTest::VOLUME_LABEL[] = "GENSCD_TEST";
+
+/**
+ * Get the expected user data for a sector.
+ * @param lba LBA, relative to the start of the data track.
+ * @param out 2048-byte buffer.
+ */
+void ScsiImageTest::userData(uint32_t lba, uint8_t *out)
+{
+	if (lba == 16) {
+		// ISO-9660 Primary Volume Descriptor.
+		memset(out, 0, 2048);
+		ISO9660_VOLUME_DESCRIPTOR *vd = (ISO9660_VOLUME_DESCRIPTOR*)out;
+		vd->vdtype = ISO9660_VDTYPE_PVD;
+		memcpy(vd->magic, "CD001", sizeof(vd->magic));
+		vd->version = 1;
+		memset(vd->pvd.vol_id, ' ', sizeof(vd->pvd.vol_id));
+		memcpy(vd->pvd.vol_id, VOLUME_LABEL, strlen(VOLUME_LABEL));
+		return;
+	}
+
+	for (unsigned int i = 0; i < 2048; i++) {
+		out[i] = (uint8_t)((lba * 7) + i + (i >> 8));
+	}
+}
+
+/**
+ * Get the expected audio data for a sector.
+ * @param lba LBA, relative to the start of the audio track.
+ * @param out 2352-byte buffer.
+ */
+void ScsiImageTest::audioData(uint32_t lba, uint8_t *out)
+{
+	for (unsigned int i = 0; i < 2352; i++) {
+		out[i] = (uint8_t)((lba * 13) ^ i);
+	}
+}
+
+/**
+ * Write an ISO image.
+ * @param filename Filename.
+ * @param sectors Number of sectors.
+ * @return True on success; false on error.
+ */
+bool ScsiImageTest::writeIso(const char *filename, unsigned int sectors)
+{
+	FILE *f = fopen(filename, "wb");
+	if (!f)
+		return false;
+	uint8_t sector[2048];
+	for (unsigned int lba = 0; lba < sectors; lba++) {
+		userData(lba, sector);
+		fwrite(sector, 1, sizeof(sector), f);
+	}
+	fclose(f);
+	return true;
+}
+
+/**
+ * Calculate a CD-ROM EDC. (bitwise reference implementation)
+ * @param data Data.
+ * @param len Length of data.
+ * @return EDC.
+ */
+uint32_t ScsiImageTest::edc(const uint8_t *data, size_t len)
+{
+	uint32_t crc = 0;
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (crc >> 1) ^ ((crc & 1) ? 0xD8018001 : 0);
+		}
+	}
+	return crc;
+}
+
+/**
+ * Create the test images.
+ */
+void ScsiImageTest::SetUpTestCase(void)
+{
+	// ISO image.
+	ASSERT_TRUE(writeIso(ISO_FILENAME, ISO_SECTORS));
+
+	// Mixed-mode BIN image: MODE1/2352 data track, then an audio track.
+	FILE *f = fopen(BIN_FILENAME, "wb");
+	ASSERT_TRUE(f != nullptr);
+	uint8_t sector[2352];
+	for (unsigned int lba = 0; lba < BIN_DATA_SECTORS; lba++) {
+		// NOTE: EDC/ECC aren't checked, so they're left empty.
+		memset(sector, 0, sizeof(sector));
+		memset(&sector[1], 0xFF, 10);
+		sector[15] = 1;
+		userData(lba, &sector[16]);
+		fwrite(sector, 1, sizeof(sector), f);
+	}
+	for (unsigned int lba = 0; lba < BIN_AUDIO_SECTORS; lba++) {
+		audioData(lba, sector);
+		fwrite(sector, 1, sizeof(sector), f);
+	}
+	fclose(f);
+
+	f = fopen(CUE_FILENAME, "w");
+	ASSERT_TRUE(f != nullptr);
+	fprintf(f, "REM Test disc\n"
+		   "FILE \"%s\" BINARY\n"
+		   "  TRACK 01 MODE1/2352\n"
+		   "    INDEX 01 00:00:00\n"
+		   "  TRACK 02 AUDIO\n"
+		   "    PREGAP 00:02:00\n"
+		   "    INDEX 01 00:01:25\n", BIN_FILENAME);
+	fclose(f);
+
+	// CSO image: 8 sectors per block, with one block stored uncompressed.
+	static const unsigned int CSO_BLOCK_SIZE = 8 * 2048;
+	const unsigned int totalBytes = ISO_SECTORS * 2048;
+	const unsigned int blocks = (totalBytes + CSO_BLOCK_SIZE - 1) / CSO_BLOCK_SIZE;
+	vector<uint8_t> iso(totalBytes);
+	for (unsigned int lba = 0; lba < ISO_SECTORS; lba++) {
+		userData(lba, &iso[lba * 2048]);
+	}
+
+	vector<uint32_t> index(blocks + 1);
+	vector<uint8_t> data;
+	uint32_t pos = 24 + (blocks + 1) * 4;
+	for (unsigned int b = 0; b < blocks; b++) {
+		const uint8_t *src = &iso[b * CSO_BLOCK_SIZE];
+		const unsigned int srcLen = (b == blocks - 1 ? totalBytes - b * CSO_BLOCK_SIZE : CSO_BLOCK_SIZE);
+		index[b] = pos;
+		if (b == 2) {
+			// Uncompressed block.
+			index[b] |= 0x80000000;
+			data.insert(data.end(), src, src + srcLen);
+			pos += srcLen;
+			continue;
+		}
+
+		// Raw deflate.
+		z_stream zs;
+		memset(&zs, 0, sizeof(zs));
+		ASSERT_EQ(Z_OK, deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY));
+		vector<uint8_t> out(deflateBound(&zs, srcLen));
+		zs.next_in = const_cast<uint8_t*>(src);
+		zs.avail_in = srcLen;
+		zs.next_out = out.data();
+		zs.avail_out = (uInt)out.size();
+		ASSERT_EQ(Z_STREAM_END, deflate(&zs, Z_FINISH));
+		data.insert(data.end(), out.begin(), out.begin() + zs.total_out);
+		pos += zs.total_out;
+		deflateEnd(&zs);
+	}
+	index[blocks] = pos;
+
+	f = fopen(CSO_FILENAME, "wb");
+	ASSERT_TRUE(f != nullptr);
+	uint8_t hdr[24];
+	memset(hdr, 0, sizeof(hdr));
+	memcpy(hdr, "CISO", 4);
+	hdr[4] = sizeof(hdr);
+	hdr[8] = (totalBytes & 0xFF);
+	hdr[9] = ((totalBytes >> 8) & 0xFF);
+	hdr[10] = ((totalBytes >> 16) & 0xFF);
+	hdr[11] = ((totalBytes >> 24) & 0xFF);
+	hdr[16] = (CSO_BLOCK_SIZE & 0xFF);
+	hdr[17] = ((CSO_BLOCK_SIZE >> 8) & 0xFF);
+	hdr[18] = ((CSO_BLOCK_SIZE >> 16) & 0xFF);
+	hdr[20] = 1;	// Version.
+	fwrite(hdr, 1, sizeof(hdr), f);
+	for (unsigned int i = 0; i <= blocks; i++) {
+		const uint8_t le[4] = {
+			(uint8_t)(index[i] & 0xFF), (uint8_t)((index[i] >> 8) & 0xFF),
+			(uint8_t)((index[i] >> 16) & 0xFF), (uint8_t)(index[i] >> 24)
+		};
+		fwrite(le, 1, sizeof(le), f);
+	}
+	fwrite(data.data(), 1, data.size(), f);
+	fclose(f);
+}
+
+/**
+ * Delete the test images.
+ */
+void ScsiImageTest::TearDownTestCase(void)
+{
+	remove(ISO_FILENAME);
+	remove(BIN_FILENAME);
+	remove(CUE_FILENAME);
+	remove(CSO_FILENAME);
+	remove(BENCH_FILENAME);
+}
+
+/**
+ * CdDrive queries on an ISO image.
+ */
+TEST_F(ScsiImageTest, isoCdDrive)
+{
+	CdDrive cdrom(ISO_FILENAME);
+	ASSERT_TRUE(cdrom.isOpen());
+	EXPECT_EQ("GENS", cdrom.dev_vendor());
+	EXPECT_TRUE(cdrom.isCdromDrive());
+	EXPECT_TRUE(cdrom.isDiscPresent());
+	EXPECT_EQ(DISC_TYPE_CDROM, cdrom.getDiscType());
+	EXPECT_TRUE(cdrom.isDataCD());
+	EXPECT_FALSE(cdrom.isAudioCD());
+	EXPECT_FALSE(cdrom.isMixedCD());
+
+	string label(VOLUME_LABEL);
+	label.resize(32, ' ');
+	EXPECT_EQ(label, cdrom.getDiscLabel());
+}
+
+/**
+ * CdDrive queries on a mixed-mode BIN/CUE image.
+ */
+TEST_F(ScsiImageTest, cueCdDrive)
+{
+	CdDrive cdrom(CUE_FILENAME);
+	ASSERT_TRUE(cdrom.isOpen());
+	EXPECT_TRUE(cdrom.isDataCD());
+	EXPECT_FALSE(cdrom.isAudioCD());
+	EXPECT_TRUE(cdrom.isMixedCD());
+
+	string label(VOLUME_LABEL);
+	label.resize(32, ' ');
+	EXPECT_EQ(label, cdrom.getDiscLabel());
+}
+
+/**
+ * Table of Contents of a mixed-mode BIN/CUE image.
+ */
+TEST_F(ScsiImageTest, cueToc)
+{
+	ScsiImage image(CUE_FILENAME);
+	ASSERT_TRUE(image.isOpen());
+
+	SCSI_CDROM_TOC toc;
+	int numTracks = 0;
+	ASSERT_EQ(0, image.readToc(&toc, &numTracks));
+	ASSERT_EQ(2, numTracks);
+	EXPECT_EQ(1, toc.FirstTrackNumber);
+	EXPECT_EQ(2, toc.LastTrackNumber);
+
+	EXPECT_EQ(0x14, toc.Tracks[0].ControlADR);
+	EXPECT_EQ(0U, toc.Tracks[0].StartAddress);
+	EXPECT_EQ(0x10, toc.Tracks[1].ControlADR);
+	EXPECT_EQ((uint32_t)(BIN_DATA_SECTORS + BIN_PREGAP), toc.Tracks[1].StartAddress);
+
+	// Lead-out.
+	EXPECT_EQ(0xAA, toc.Tracks[2].TrackNumber);
+	EXPECT_EQ((uint32_t)(BIN_DATA_SECTORS + BIN_PREGAP + BIN_AUDIO_SECTORS), toc.Tracks[2].StartAddress);
+}
+
+/**
+ * Sector reads from a mixed-mode BIN/CUE image.
+ */
+TEST_F(ScsiImageTest, cueRead)
+{
+	ScsiImage image(CUE_FILENAME);
+	ASSERT_TRUE(image.isOpen());
+
+	// READ(10) returns the user data from MODE1/2352 sectors.
+	vector<uint8_t> buf(BIN_DATA_SECTORS * 2048);
+	vector<uint8_t> expected(2352);
+	ASSERT_EQ(0, image.read(0, BIN_DATA_SECTORS, buf.data(), buf.size()));
+	for (unsigned int lba = 0; lba < BIN_DATA_SECTORS; lba++) {
+		userData(lba, expected.data());
+		ASSERT_EQ(0, memcmp(expected.data(), &buf[lba * 2048], 2048)) << "LBA " << lba;
+	}
+
+	// READ(10) can't read audio sectors.
+	const uint32_t audioLba = BIN_DATA_SECTORS + BIN_PREGAP;
+	EXPECT_EQ(0x56400, image.read(audioLba, 1, buf.data(), 2048));
+
+	// READ CD returns 2352-byte audio sectors.
+	buf.resize(4 * 2352);
+	ASSERT_EQ(0, image.readCD(audioLba + 10, 4, buf.data(), buf.size(),
+		SCSI_READ_CD_SECTORTYPE_CDDA, ScsiBase::RCDRAW_USER));
+	for (unsigned int i = 0; i < 4; i++) {
+		audioData(10 + i, expected.data());
+		EXPECT_EQ(0, memcmp(expected.data(), &buf[i * 2352], 2352));
+	}
+
+	// Pregap sectors aren't stored, so they're empty.
+	ASSERT_EQ(0, image.readCD(BIN_DATA_SECTORS + 2, 1, buf.data(), 2352,
+		SCSI_READ_CD_SECTORTYPE_ANY, ScsiBase::RCDRAW_FULL));
+	for (unsigned int i = 0; i < 2352; i++) {
+		ASSERT_EQ(0, buf[i]) << "offset " << i;
+	}
+
+	// Reading past the lead-out fails.
+	const uint32_t leadOut = audioLba + BIN_AUDIO_SECTORS;
+	EXPECT_EQ(0x52100, image.readCD(leadOut - 1, 2, buf.data(), buf.size(),
+		SCSI_READ_CD_SECTORTYPE_ANY, ScsiBase::RCDRAW_FULL));
+}
+
+/**
+ * Raw sectors synthesized from an ISO image.
+ */
+TEST_F(ScsiImageTest, isoRawSector)
+{
+	ScsiImage image(ISO_FILENAME);
+	ASSERT_TRUE(image.isOpen());
+
+	// Subchannels aren't available.
+	uint8_t sector[2352 + 96];
+	EXPECT_NE(0, image.readCD(20, 1, sector, sizeof(sector),
+		SCSI_READ_CD_SECTORTYPE_ANY, ScsiBase::RCDRAW_FULL_SUB_PQ_RW));
+
+	ASSERT_EQ(0, image.readCD(20, 1, sector, 2352,
+		SCSI_READ_CD_SECTORTYPE_ANY, ScsiBase::RCDRAW_FULL));
+
+	// Sync field.
+	static const uint8_t sync[12] = {0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+					 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+	EXPECT_EQ(0, memcmp(sync, sector, sizeof(sync)));
+
+	// Header: LBA 20 == 00:02:20, Mode 1.
+	EXPECT_EQ(0x00, sector[12]);
+	EXPECT_EQ(0x02, sector[13]);
+	EXPECT_EQ(0x20, sector[14]);
+	EXPECT_EQ(0x01, sector[15]);
+
+	// User data.
+	uint8_t expected[2048];
+	userData(20, expected);
+	EXPECT_EQ(0, memcmp(expected, &sector[16], sizeof(expected)));
+
+	// EDC.
+	const uint32_t crc = edc(sector, 0x810);
+	EXPECT_EQ(crc, (uint32_t)(sector[0x810] | (sector[0x811] << 8) |
+		(sector[0x812] << 16) | ((uint32_t)sector[0x813] << 24)));
+
+	// ECC parity isn't all zero.
+	bool nonzero = false;
+	for (unsigned int i = 0x81C; i < 2352; i++) {
+		nonzero |= (sector[i] != 0);
+	}
+	EXPECT_TRUE(nonzero);
+}
+
+/**
+ * Sector reads from a CSO image.
+ */
+TEST_F(ScsiImageTest, csoRead)
+{
+	CdDrive cdrom(CSO_FILENAME);
+	ASSERT_TRUE(cdrom.isOpen());
+	EXPECT_TRUE(cdrom.isDataCD());
+	string label(VOLUME_LABEL);
+	label.resize(32, ' ');
+	EXPECT_EQ(label, cdrom.getDiscLabel());
+
+	ScsiImage image(CSO_FILENAME);
+	ASSERT_TRUE(image.isOpen());
+
+	// Read the image out of order to cross block boundaries.
+	uint8_t buf[5 * 2048];
+	uint8_t expected[2048];
+	static const uint32_t starts[] = {190, 0, 13, 62, 3, 100, 195};
+	for (size_t s = 0; s < sizeof(starts)/sizeof(starts[0]); s++) {
+		ASSERT_EQ(0, image.read(starts[s], 5, buf, sizeof(buf)));
+		for (unsigned int i = 0; i < 5; i++) {
+			userData(starts[s] + i, expected);
+			EXPECT_EQ(0, memcmp(expected, &buf[i * 2048], 2048)) << "LBA " << (starts[s] + i);
+		}
+	}
+}
+
+/**
+ * Sequential reads are prefetched.
+ */
+TEST_F(ScsiImageTest, prefetch)
+{
+	ScsiImage image(ISO_FILENAME);
+	ASSERT_TRUE(image.isOpen());
+
+	uint8_t buf[4 * 2048];
+	uint8_t expected[2048];
+	for (uint32_t lba = 0; lba + 4 <= 64; lba += 4) {
+		ASSERT_EQ(0, image.read(lba, 4, buf, sizeof(buf)));
+		for (unsigned int i = 0; i < 4; i++) {
+			userData(lba + i, expected);
+			ASSERT_EQ(0, memcmp(expected, &buf[i * 2048], 2048)) << "LBA " << (lba + i);
+		}
+	}
+
+	// The read-ahead window grows on each sequential read,
+	// so the rest of the track is read ahead.
+	// Wait for the prefetch thread to finish.
+	static const unsigned int remaining = ISO_SECTORS - 64;
+	ScsiImage::CacheStats stats = image.cacheStats();
+	for (int i = 0; i < 400; i++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		const uint64_t prev = stats.prefetched;
+		stats = image.cacheStats();
+		if (stats.prefetched >= remaining && stats.prefetched == prev)
+			break;
+	}
+	EXPECT_GE(stats.prefetched, (uint64_t)remaining);
+
+	// Read-ahead sectors are now cached.
+	const uint64_t misses = stats.misses;
+	const uint64_t hits = stats.hits;
+	vector<uint8_t> rest(remaining * 2048);
+	ASSERT_EQ(0, image.read(64, remaining, rest.data(), rest.size()));
+	stats = image.cacheStats();
+	EXPECT_EQ(misses, stats.misses);
+	EXPECT_EQ(hits + remaining, stats.hits);
+	for (unsigned int i = 0; i < remaining; i++) {
+		userData(64 + i, expected);
+		ASSERT_EQ(0, memcmp(expected, &rest[i * 2048], 2048)) << "LBA " << (64 + i);
+	}
+
+	// Repeated random reads are served from the cache.
+	ASSERT_EQ(0, image.read(10, 1, buf, 2048));
+	stats = image.cacheStats();
+	EXPECT_EQ(misses, stats.misses);
+	EXPECT_EQ(hits + remaining + 1, stats.hits);
+}
+
+/**
+ * Reads still work with the cache disabled.
+ */
+TEST_F(ScsiImageTest, cacheDisabled)
+{
+	ScsiImage image(ISO_FILENAME);
+	ASSERT_TRUE(image.isOpen());
+	EXPECT_EQ((unsigned int)ScsiImage::DEFAULT_CACHE_SIZE_MB, image.cacheSize());
+	image.setCacheSize(0);
+	EXPECT_EQ(0U, image.cacheSize());
+
+	uint8_t buf[8 * 2048];
+	uint8_t expected[2048];
+	for (uint32_t lba = 0; lba + 8 <= ISO_SECTORS; lba += 8) {
+		ASSERT_EQ(0, image.read(lba, 8, buf, sizeof(buf)));
+		userData(lba + 7, expected);
+		ASSERT_EQ(0, memcmp(expected, &buf[7 * 2048], 2048));
+	}
+
+	ScsiImage::CacheStats stats = image.cacheStats();
+	EXPECT_EQ(0U, stats.hits);
+	EXPECT_EQ(0U, stats.prefetched);
+	EXPECT_EQ((uint64_t)ISO_SECTORS, stats.misses);
+}
+
+/**
+ * Read throughput benchmark.
+ */
+TEST_F(ScsiImageTest, benchmark)
+{
+	// 16 MB image.
+	static const unsigned int BENCH_SECTORS = 8192;
+	ASSERT_TRUE(writeIso(BENCH_FILENAME, BENCH_SECTORS));
+
+	typedef std::chrono::steady_clock clock;
+	static const unsigned int BLOCK = 16;
+	uint8_t buf[BLOCK * 2048];
+
+	for (int pass = 0; pass < 2; pass++) {
+		ScsiImage image(BENCH_FILENAME);
+		ASSERT_TRUE(image.isOpen());
+		if (pass == 0)
+			image.setCacheSize(0);
+
+		// Sequential reads.
+		clock::time_point start = clock::now();
+		for (uint32_t lba = 0; lba < BENCH_SECTORS; lba += BLOCK) {
+			ASSERT_EQ(0, image.read(lba, BLOCK, buf, sizeof(buf)));
+		}
+		double secs = std::chrono::duration<double>(clock::now() - start).count();
+		const double seqMBs = (secs > 0 ? (BENCH_SECTORS * 2048 / 1048576.0) / secs : 0);
+
+		// Random reads within a 2 MB working set.
+		srand(1);
+		start = clock::now();
+		for (unsigned int i = 0; i < 4096; i++) {
+			const uint32_t lba = (uint32_t)(rand() % 1024);
+			ASSERT_EQ(0, image.read(lba, 1, buf, 2048));
+		}
+		secs = std::chrono::duration<double>(clock::now() - start).count();
+		const double rndMBs = (secs > 0 ? (4096 * 2048 / 1048576.0) / secs : 0);
+
+		const ScsiImage::CacheStats stats = image.cacheStats();
+		printf("%s: sequential %.1f MB/s, random %.1f MB/s "
+			"(hits=%llu, misses=%llu, prefetched=%llu)\n",
+			(pass == 0 ? "No cache" : "Cache   "), seqMBs, rndMBs,
+			(unsigned long long)stats.hits,
+			(unsigned long long)stats.misses,
+			(unsigned long long)stats.prefetched);
+	}
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibGensCD test suite: ScsiImage test.\n\n");
+	fflush(nullptr);
+
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
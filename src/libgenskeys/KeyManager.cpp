@@ -220,9 +220,23 @@ void KeyManager::copyFrom(const KeyManager &keyManager)
 
 /**
  * Update the I/O Manager with the current key states.
+ * This is equivalent to getIoState() followed by applyIoState().
  * @param ioManager I/O Manager to update.
  */
 void KeyManager::updateIoManager(IoManager *ioManager)
+{
+	IoState_t state;
+	getIoState(&state);
+	applyIoState(&state, ioManager);
+}
+
+/**
+ * Get the current I/O state.
+ * This must be called on the thread that updates
+ * the key states and keymaps.
+ * @param state [out] I/O state.
+ */
+void KeyManager::getIoState(IoState_t *state)
 {
 #ifdef _WIN32
 	// Windows: Update Shift/Control/Alt states.
@@ -242,16 +256,10 @@ void KeyManager::updateIoManager(IoManager *ioManager)
 
 	// Scan the keymap and determine buttons.
 	for (int virtPort = 0; virtPort < IoManager::VIRTPORT_MAX; virtPort++) {
-		IoManager::IoType_t ioType = ioManager->devType((IoManager::VirtPort_t)virtPort);
-		if (d->ioTypes[virtPort] != ioType) {
-			// Update the device type.
-			ioManager->setDevType(
-				(IoManager::VirtPort_t)virtPort, 
-				d->ioTypes[virtPort]);
-			ioType = d->ioTypes[virtPort];
-		}
+		const IoManager::IoType_t ioType = d->ioTypes[virtPort];
+		state->ioTypes[virtPort] = ioType;
 
-		const int numButtons = ioManager->NumDevButtons(ioType);
+		const int numButtons = IoManager::NumDevButtons(ioType);
 		uint32_t buttons = 0;
 		const GensKey_t *port_keyMap = &d->keyMap[virtPort][numButtons - 1];
 		for (int btn = numButtons - 1; btn >= 0; btn--) {
@@ -260,9 +268,26 @@ void KeyManager::updateIoManager(IoManager *ioManager)
 		}
 
 		// Buttons are typically active-low.
-		buttons = ~buttons;
+		state->buttons[virtPort] = ~buttons;
+	}
+}
+
+/**
+ * Apply an I/O state to an I/O Manager.
+ * @param state I/O state.
+ * @param ioManager I/O Manager to update.
+ */
+void KeyManager::applyIoState(const IoState_t *state, IoManager *ioManager)
+{
+	for (int virtPort = 0; virtPort < IoManager::VIRTPORT_MAX; virtPort++) {
+		if (ioManager->devType((IoManager::VirtPort_t)virtPort) != state->ioTypes[virtPort]) {
+			// Update the device type.
+			ioManager->setDevType(
+				(IoManager::VirtPort_t)virtPort,
+				state->ioTypes[virtPort]);
+		}
 
-		ioManager->update(virtPort, buttons);
+		ioManager->update(virtPort, state->buttons[virtPort]);
 	}
 }
 
@@ -57,10 +57,37 @@ class KeyManager
 	public:
 		/**
 		 * Update the I/O Manager with the current key states.
+		 * This is equivalent to getIoState() followed by applyIoState().
 		 * @param ioManager I/O Manager to update.
 		 */
 		void updateIoManager(LibGens::IoManager *ioManager);
 
+		/**
+		 * I/O state: Device types and button states
+		 * for all Virtual Ports.
+		 * This allows the key states to be read on one thread
+		 * and applied to the I/O Manager on another thread.
+		 */
+		struct IoState_t {
+			LibGens::IoManager::IoType_t ioTypes[LibGens::IoManager::VIRTPORT_MAX];
+			uint32_t buttons[LibGens::IoManager::VIRTPORT_MAX];	// active-low
+		};
+
+		/**
+		 * Get the current I/O state.
+		 * This must be called on the thread that updates
+		 * the key states and keymaps.
+		 * @param state [out] I/O state.
+		 */
+		void getIoState(IoState_t *state);
+
+		/**
+		 * Apply an I/O state to an I/O Manager.
+		 * @param state I/O state.
+		 * @param ioManager I/O Manager to update.
+		 */
+		static void applyIoState(const IoState_t *state, LibGens::IoManager *ioManager);
+
 		/**
 		 * Get the keymap for the specified Virtual Port.
 		 * @param virtPort I/O Manager Virtual Port.
@@ -26,6 +26,9 @@
 // MUST be included before Metadata.hpp.
 #include <png.h>
 
+// zlib
+#include <zlib.h>
+
 // ZOMG metadata.
 #include "Metadata.hpp"
 
@@ -90,19 +93,109 @@ class PngWriterPrivate
 		PngWriterPrivate &operator=(const PngWriterPrivate &);
 
 	public:
+		// Encoding options.
+		int level;
+		PngWriter::FilterMode filterMode;
+		PngWriter::Strategy strategy;
+
+		// Task runner for row-parallel encoding.
+		PngWriter::TaskRunner runner;
+		void *runnerParam;
+		int maxTasks;
+
+		// Don't split the image into bands smaller than this.
+		// Each band restarts the filter heuristics and
+		// flushes the deflate stream.
+		static const int MIN_BAND_ROWS = 32;
+
+		/**
+		 * Row band.
+		 * Buffers are kept between images to avoid
+		 * reallocating them for every screenshot.
+		 */
+		struct Band {
+			int y0, y1;		// Rows [y0, y1).
+			vector<uint8_t> out;	// Compressed data.
+			vector<uint8_t> scratch;	// FILTER_ADAPTIVE scratch rows.
+			uLong adler;		// Adler-32 of the filtered rows.
+			int ret;		// 0 on success; negative errno on error.
+		};
+
+		// Current image.
+		const Zomg_Img_Data_t *img_data;
+		int stride;			// RGB24 row size, in bytes.
+		vector<uint8_t> raw;		// RGB24 rows.
+		vector<uint8_t> filtered;	// Filtered rows, with filter type bytes.
+		vector<uint8_t> zeroRow;	// "Previous" row for row 0.
+		vector<Band> bands;
+		vector<uint8_t> idat;		// zlib stream for IDAT.
+
 		/**
-		 * Write 16-bit PNG rows.
+		 * Convert 16-bit rows to RGB24.
 		 * @param pixel Typename.
 		 * @param RBits Red bits.
 		 * @param GBits Green bits.
 		 * @param BBits Blue bits.
 		 * @param img_data Image data.
-		 * @param row_buffer Row buffer. (Must be at least width * 3 bytes.)
-		 * @param png_ptr PNG pointer.
+		 * @param y0 First row.
+		 * @param y1 Last row, plus one.
+		 * @param dest RGB24 buffer for row y0.
 		 */
 		template<typename pixel, uint8_t RBits, uint8_t GBits, uint8_t BBits>
-		static void T_writePNG_rows_16(const Zomg_Img_Data_t *img_data, uint8_t *row_buffer,
-					       png_structp png_ptr);
+		static void T_convertRows_16(const Zomg_Img_Data_t *img_data,
+					     int y0, int y1, uint8_t *dest);
+
+		/**
+		 * Convert 32-bit xRGB rows to RGB24.
+		 * @param img_data Image data.
+		 * @param y0 First row.
+		 * @param y1 Last row, plus one.
+		 * @param dest RGB24 buffer for row y0.
+		 */
+		static void convertRows_32(const Zomg_Img_Data_t *img_data,
+					   int y0, int y1, uint8_t *dest);
+
+		/**
+		 * Apply a PNG filter to a row.
+		 * @param type	[in] Filter type. (0-4)
+		 * @param cur	[in] Current row.
+		 * @param prev	[in] Previous row.
+		 * @param len	[in] Row length, in bytes.
+		 * @param out	[out] Filtered row. (Excluding the filter type byte.)
+		 */
+		static void filterRow(int type, const uint8_t *cur, const uint8_t *prev,
+				      int len, uint8_t *out);
+
+		/**
+		 * Task: Convert and filter a band of rows.
+		 * @param param PngWriterPrivate.
+		 * @param index Band index.
+		 * @param count Number of bands.
+		 */
+		static void filterTask(void *param, int index, int count);
+
+		/**
+		 * Task: Compress a band of rows.
+		 * @param param PngWriterPrivate.
+		 * @param index Band index.
+		 * @param count Number of bands.
+		 */
+		static void deflateTask(void *param, int index, int count);
+
+		/**
+		 * Run a set of tasks using the task runner, if available.
+		 * @param fn Task function.
+		 * @param count Number of tasks.
+		 */
+		void runTasks(PngWriter::TaskFn fn, int count);
+
+		/**
+		 * Encode the image data as a zlib stream.
+		 * The result is stored in idat.
+		 * @param img_data	[in] PNG image data.
+		 * @return 0 on success; negative errno on error.
+		 */
+		int encodeIdat(const Zomg_Img_Data_t *img_data);
 
 	public:
 		/**
@@ -130,41 +223,47 @@ class PngWriterPrivate
 		 * @param metaFlags	[in, opt] Metadata flags.
 		 * @return 0 on success; negative errno on error.
 		 */
-		static int writeToPng(png_structp png_ptr, png_infop info_ptr,
-				      const Zomg_Img_Data_t *img_data,
-				      const Metadata *metadata, int metaFlags);
+		int writeToPng(png_structp png_ptr, png_infop info_ptr,
+			       const Zomg_Img_Data_t *img_data,
+			       const Metadata *metadata, int metaFlags);
 };
 
 PngWriterPrivate::PngWriterPrivate(PngWriter *q)
 	: q(q)
+	, level(5)
+	, filterMode(PngWriter::FILTER_NONE)
+	, strategy(PngWriter::STRATEGY_DEFAULT)
+	, runner(nullptr)
+	, runnerParam(nullptr)
+	, maxTasks(1)
+	, img_data(nullptr)
+	, stride(0)
 { }
 
 PngWriterPrivate::~PngWriterPrivate()
 { }
 
 /**
- * Write 16-bit PNG rows.
+ * Convert 16-bit rows to RGB24.
  * @param pixel Typename.
  * @param RBits Red bits.
  * @param GBits Green bits.
  * @param BBits Blue bits.
  * @param img_data Image data.
- * @param row_buffer Row buffer. (Must be at least width * 3 bytes.)
- * @param png_ptr PNG pointer.
+ * @param y0 First row.
+ * @param y1 Last row, plus one.
+ * @param dest RGB24 buffer for row y0.
  */
 template<typename pixel, uint8_t RBits, uint8_t GBits, uint8_t BBits>
-void PngWriterPrivate::T_writePNG_rows_16(const Zomg_Img_Data_t *img_data, uint8_t *row_buffer,
-					  png_structp png_ptr)
+void PngWriterPrivate::T_convertRows_16(const Zomg_Img_Data_t *img_data,
+					int y0, int y1, uint8_t *dest)
 {
 	#define MMASK(bits) ((1 << (bits)) - 1)
 	uint8_t r, g, b;
 
-	// Write the rows.
-	const uint16_t *screen = (const uint16_t*)img_data->data;
-	const int row_adj = (img_data->pitch / sizeof(pixel)) - img_data->w;
-	for (int y = img_data->h; y > 0; y--) {
-		uint8_t *rowBufPtr = row_buffer;
-		for (int x = img_data->w; x > 0; x--, rowBufPtr += 3, screen++) {
+	for (int y = y0; y < y1; y++) {
+		const pixel *screen = (const pixel*)((const uint8_t*)img_data->data + (y * img_data->pitch));
+		for (int x = img_data->w; x > 0; x--, dest += 3, screen++) {
 			// Get the color components.
 			r = (uint8_t)((*screen >> (GBits + BBits)) & MMASK(RBits)) << (8 - RBits);
 			g = (uint8_t)((*screen >> BBits) & MMASK(GBits)) << (8 - GBits);
@@ -176,19 +275,340 @@ void PngWriterPrivate::T_writePNG_rows_16(const Zomg_Img_Data_t *img_data, uint8
 			b |= (b >> BBits);
 
 			// Save the new color components.
-			*(rowBufPtr + 0) = r;
-			*(rowBufPtr + 1) = g;
-			*(rowBufPtr + 2) = b;
+			*(dest + 0) = r;
+			*(dest + 1) = g;
+			*(dest + 2) = b;
 		}
+	}
+}
 
-		// Write the row.
-		png_write_row(png_ptr, row_buffer);
+/**
+ * Convert 32-bit xRGB rows to RGB24.
+ * @param img_data Image data.
+ * @param y0 First row.
+ * @param y1 Last row, plus one.
+ * @param dest RGB24 buffer for row y0.
+ */
+void PngWriterPrivate::convertRows_32(const Zomg_Img_Data_t *img_data,
+				      int y0, int y1, uint8_t *dest)
+{
+	for (int y = y0; y < y1; y++) {
+		const uint32_t *screen = (const uint32_t*)((const uint8_t*)img_data->data + (y * img_data->pitch));
+		for (int x = img_data->w; x > 0; x--, dest += 3, screen++) {
+			const uint32_t px = *screen;
+			*(dest + 0) = (uint8_t)(px >> 16);
+			*(dest + 1) = (uint8_t)(px >> 8);
+			*(dest + 2) = (uint8_t)px;
+		}
+	}
+}
 
-		// Next row.
-		screen += row_adj;
+/**
+ * Apply a PNG filter to a row.
+ * @param type	[in] Filter type. (0-4)
+ * @param cur	[in] Current row.
+ * @param prev	[in] Previous row.
+ * @param len	[in] Row length, in bytes.
+ * @param out	[out] Filtered row. (Excluding the filter type byte.)
+ */
+void PngWriterPrivate::filterRow(int type, const uint8_t *cur, const uint8_t *prev,
+				 int len, uint8_t *out)
+{
+	// Bytes per pixel. (RGB24)
+	static const int bpp = 3;
+	int i;
+
+	switch (type) {
+		case PngWriter::FILTER_NONE:
+		default:
+			memcpy(out, cur, len);
+			break;
+
+		case PngWriter::FILTER_SUB:
+			memcpy(out, cur, bpp);
+			for (i = bpp; i < len; i++) {
+				out[i] = cur[i] - cur[i - bpp];
+			}
+			break;
+
+		case PngWriter::FILTER_UP:
+			for (i = 0; i < len; i++) {
+				out[i] = cur[i] - prev[i];
+			}
+			break;
+
+		case PngWriter::FILTER_AVERAGE:
+			for (i = 0; i < bpp; i++) {
+				out[i] = cur[i] - (prev[i] >> 1);
+			}
+			for (; i < len; i++) {
+				out[i] = cur[i] - (uint8_t)((cur[i - bpp] + prev[i]) >> 1);
+			}
+			break;
+
+		case PngWriter::FILTER_PAETH:
+			for (i = 0; i < bpp; i++) {
+				// a == c == 0, so the predictor is always b.
+				out[i] = cur[i] - prev[i];
+			}
+			for (; i < len; i++) {
+				const int a = cur[i - bpp];
+				const int b = prev[i];
+				const int c = prev[i - bpp];
+				const int pa = abs(b - c);
+				const int pb = abs(a - c);
+				const int pc = abs(a + b - c - c);
+				const int pred = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+				out[i] = cur[i] - (uint8_t)pred;
+			}
+			break;
+	}
+}
+
+/**
+ * Task: Convert and filter a band of rows.
+ * @param param PngWriterPrivate.
+ * @param index Band index.
+ * @param count Number of bands.
+ */
+void PngWriterPrivate::filterTask(void *param, int index, int count)
+{
+	PngWriterPrivate *const d = static_cast<PngWriterPrivate*>(param);
+	Band *const band = &d->bands[index];
+	((void)count);
+
+	// Convert the band to RGB24.
+	const Zomg_Img_Data_t *const img_data = d->img_data;
+	uint8_t *const raw = &d->raw[band->y0 * d->stride];
+	switch (img_data->bpp) {
+		case 15:
+			// 15-bit color. (555)
+			T_convertRows_16<uint16_t, 5, 5, 5>(img_data, band->y0, band->y1, raw);
+			break;
+		case 16:
+			// 16-bit color. (565)
+			T_convertRows_16<uint16_t, 5, 6, 5>(img_data, band->y0, band->y1, raw);
+			break;
+		case 32:
+		default:
+			convertRows_32(img_data, band->y0, band->y1, raw);
+			break;
+	}
+
+	// Filter the band.
+	// NOTE: The previous band's last row is converted by a
+	// different task, so the first row has to be converted
+	// again here for use as the "previous" row.
+	const int stride = d->stride;
+	const uint8_t *prev;
+	if (band->y0 == 0) {
+		prev = d->zeroRow.data();
+	} else {
+		uint8_t *const prevRow = &band->scratch[PngWriter::FILTER_PAETH * stride];
+		switch (img_data->bpp) {
+			case 15:
+				T_convertRows_16<uint16_t, 5, 5, 5>(img_data, band->y0 - 1, band->y0, prevRow);
+				break;
+			case 16:
+				T_convertRows_16<uint16_t, 5, 6, 5>(img_data, band->y0 - 1, band->y0, prevRow);
+				break;
+			case 32:
+			default:
+				convertRows_32(img_data, band->y0 - 1, band->y0, prevRow);
+				break;
+		}
+		prev = prevRow;
+	}
+
+	const uint8_t *cur = raw;
+	uint8_t *out = &d->filtered[band->y0 * (stride + 1)];
+	for (int y = band->y0; y < band->y1; y++, prev = cur, cur += stride, out += stride + 1) {
+		if (d->filterMode != PngWriter::FILTER_ADAPTIVE) {
+			out[0] = (uint8_t)d->filterMode;
+			filterRow(d->filterMode, cur, prev, stride, &out[1]);
+			continue;
+		}
+
+		// Try each filter, and keep the one with the
+		// lowest sum of absolute values. (signed)
+		// NOTE: Scratch row 4 (Paeth) may be the previous
+		// row for the first row in the band, so Paeth is
+		// written directly to the output.
+		unsigned int bestSum = ~0U;
+		int best = PngWriter::FILTER_NONE;
+		for (int type = PngWriter::FILTER_NONE; type <= PngWriter::FILTER_PAETH; type++) {
+			uint8_t *const tmp = (type == PngWriter::FILTER_PAETH
+						? &out[1] : &band->scratch[type * stride]);
+			filterRow(type, cur, prev, stride, tmp);
+			unsigned int sum = 0;
+			for (int i = 0; i < stride; i++) {
+				sum += (tmp[i] < 128 ? tmp[i] : 256 - tmp[i]);
+			}
+			if (sum < bestSum) {
+				bestSum = sum;
+				best = type;
+			}
+		}
+
+		out[0] = (uint8_t)best;
+		if (best != PngWriter::FILTER_PAETH) {
+			memcpy(&out[1], &band->scratch[best * stride], stride);
+		}
 	}
 }
 
+/**
+ * Task: Compress a band of rows.
+ * @param param PngWriterPrivate.
+ * @param index Band index.
+ * @param count Number of bands.
+ */
+void PngWriterPrivate::deflateTask(void *param, int index, int count)
+{
+	static const int zstrategy_tbl[PngWriter::STRATEGY_MAX] = {
+		Z_DEFAULT_STRATEGY, Z_FILTERED, Z_RLE, Z_HUFFMAN_ONLY
+	};
+
+	PngWriterPrivate *const d = static_cast<PngWriterPrivate*>(param);
+	Band *const band = &d->bands[index];
+	const bool last = (index == count - 1);
+
+	const unsigned int rowBytes = d->stride + 1;
+	uint8_t *const in = &d->filtered[band->y0 * rowBytes];
+	const unsigned int len = (band->y1 - band->y0) * rowBytes;
+	band->adler = adler32(adler32(0L, nullptr, 0), in, len);
+
+	// Raw deflate. The zlib header and Adler-32 checksum
+	// are added when the bands are joined.
+	z_stream strm;
+	memset(&strm, 0, sizeof(strm));
+	if (deflateInit2(&strm, d->level, Z_DEFLATED, -15, 8,
+			 zstrategy_tbl[d->strategy]) != Z_OK)
+	{
+		band->ret = -ENOMEM;
+		return;
+	}
+
+	if (band->y0 > 0) {
+		// Prime the dictionary with the end of the previous band,
+		// so splitting the image doesn't hurt compression much.
+		const unsigned int offset = band->y0 * rowBytes;
+		const unsigned int dictLen = (offset > 32768 ? 32768 : offset);
+		deflateSetDictionary(&strm, in - dictLen, dictLen);
+	}
+
+	// Non-final bands end with a sync flush, which
+	// ends on a byte boundary and adds 5 bytes.
+	band->out.resize(deflateBound(&strm, len) + 16);
+	strm.next_in = in;
+	strm.avail_in = len;
+	strm.next_out = band->out.data();
+	strm.avail_out = (uInt)band->out.size();
+	const int zret = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+	if ((last && zret != Z_STREAM_END) ||
+	    (!last && (zret != Z_OK || strm.avail_in != 0 || strm.avail_out == 0)))
+	{
+		// Output buffer is too small. (Shouldn't happen.)
+		band->ret = -ENOSPC;
+	} else {
+		band->out.resize(strm.total_out);
+		band->ret = 0;
+	}
+	deflateEnd(&strm);
+}
+
+/**
+ * Run a set of tasks using the task runner, if available.
+ * @param fn Task function.
+ * @param count Number of tasks.
+ */
+void PngWriterPrivate::runTasks(PngWriter::TaskFn fn, int count)
+{
+	if (runner && count > 1) {
+		runner(runnerParam, fn, this, count);
+	} else {
+		for (int i = 0; i < count; i++) {
+			fn(this, i, count);
+		}
+	}
+}
+
+/**
+ * Encode the image data as a zlib stream.
+ * The result is stored in idat.
+ * @param img_data	[in] PNG image data.
+ * @return 0 on success; negative errno on error.
+ */
+int PngWriterPrivate::encodeIdat(const Zomg_Img_Data_t *img_data)
+{
+	this->img_data = img_data;
+	const int h = (int)img_data->h;
+	stride = (int)img_data->w * 3;
+	raw.resize(h * stride);
+	filtered.resize(h * (stride + 1));
+	zeroRow.assign(stride, 0);
+
+	// Split the image into bands.
+	int count = 1;
+	if (runner && maxTasks > 1) {
+		count = h / MIN_BAND_ROWS;
+		if (count > maxTasks)
+			count = maxTasks;
+		else if (count < 1)
+			count = 1;
+	}
+	bands.resize(count);
+	for (int i = 0; i < count; i++) {
+		Band *const band = &bands[i];
+		band->y0 = (h * i) / count;
+		band->y1 = (h * (i + 1)) / count;
+		band->ret = 0;
+		if (filterMode == PngWriter::FILTER_ADAPTIVE || band->y0 > 0) {
+			band->scratch.resize((PngWriter::FILTER_PAETH + 1) * stride);
+		}
+	}
+
+	// Filter all bands before compressing any of them,
+	// since each band's dictionary is the previous band.
+	runTasks(filterTask, count);
+	runTasks(deflateTask, count);
+
+	// Join the bands into a zlib stream.
+	size_t total = 2 + 4;
+	for (int i = 0; i < count; i++) {
+		if (bands[i].ret != 0)
+			return bands[i].ret;
+		total += bands[i].out.size();
+	}
+	idat.resize(total);
+
+	// zlib header: Deflate, 32 KB window.
+	// FLEVEL is informational only.
+	const unsigned int flevel = (level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3)));
+	unsigned int header = (0x78 << 8) | (flevel << 6);
+	header += 31 - (header % 31);
+	idat[0] = (uint8_t)(header >> 8);
+	idat[1] = (uint8_t)header;
+
+	size_t pos = 2;
+	uLong adler = bands[0].adler;
+	for (int i = 0; i < count; i++) {
+		memcpy(&idat[pos], bands[i].out.data(), bands[i].out.size());
+		pos += bands[i].out.size();
+		if (i > 0) {
+			adler = adler32_combine(adler, bands[i].adler,
+				(z_off_t)(bands[i].y1 - bands[i].y0) * (stride + 1));
+		}
+	}
+
+	// Adler-32 checksum. (big-endian)
+	idat[pos + 0] = (uint8_t)(adler >> 24);
+	idat[pos + 1] = (uint8_t)(adler >> 16);
+	idat[pos + 2] = (uint8_t)(adler >> 8);
+	idat[pos + 3] = (uint8_t)adler;
+	return 0;
+}
+
 /**
  * PNG MiniZip write function.
  * @param png_ptr PNG pointer.
@@ -231,51 +651,24 @@ int PngWriterPrivate::writeToPng(png_structp png_ptr, png_infop info_ptr,
 				 const Zomg_Img_Data_t *img_data,
 				 const Metadata *metadata, int metaFlags)
 {
-	// Row pointers and/or buffer.
-	// These need to be allocated here so they can be freed
-	// in case an error occurs.
-	// FIXME: gcc-5.2 is showing this warning:
-	// warning: variable ‘row’ might be clobbered by ‘longjmp’ or ‘vfork’ [-Wclobbered]
-	union {
-		void *p;
-
-		// Row pointers. (32-bit color)
-		// Each entry points to the beginning of a row.
-		png_byte **row_pointers;
-
-		// Row buffer. (15-bit or 16-bit color)
-		// libpng doesn't support 15-bit or 16-bit color natively,
-		// so the rows have to be converted.
-		png_byte *row_buffer;
-	} row;
-
-	if (img_data->bpp == 32) {
-		row.row_pointers = (png_byte**)png_malloc(png_ptr, sizeof(png_byte*) * img_data->h);
-	} else {
-		row.row_buffer = (png_byte*)png_malloc(png_ptr, sizeof(png_byte*) * img_data->w * 3);
-	}
-	if (!row.p) {
-		// Not enough memory is available.
-		return -ENOMEM;
-	}
+	// Filter and compress the image data.
+	// libpng filters and compresses rows one at a time on
+	// the calling thread, so we're doing this ourselves,
+	// optionally split into bands that can be encoded in
+	// parallel. The result is written as an IDAT chunk.
+	int ret = encodeIdat(img_data);
+	if (ret != 0)
+		return ret;
 
 	// WARNING: Do NOT initialize any C++ objects past this point!
 #ifdef PNG_SETJMP_SUPPORTED
 	if (setjmp(png_jmpbuf(png_ptr))) {
 		// PNG write failed.
-		png_free(png_ptr, row.p);
 		// TODO: Better error code?
 		return -ENOMEM;
 	}
 #endif /* PNG_SETJMP_SUPPORTED */
 
-	// Disable PNG filters.
-	png_set_filter(png_ptr, 0, PNG_FILTER_NONE);
-
-	// Set the compression level to 5. (Levels range from 1 to 9.)
-	// TODO: Add a parameter for this?
-	png_set_compression_level(png_ptr, 5);
-
 	// Set up the PNG header.
 	png_set_IHDR(png_ptr, info_ptr, img_data->w, img_data->h,
 		     8,				// Color depth (per channel).
@@ -322,50 +715,22 @@ int PngWriterPrivate::writeToPng(png_structp png_ptr, png_infop info_ptr,
 	// Write the PNG header to the file.
 	png_write_info(png_ptr, info_ptr);
 
-	// Write the image.
-	switch (img_data->bpp) {
-		case 15: {
-			// 15-bit color. (555)
-			T_writePNG_rows_16<uint16_t, 5, 5, 5>
-					  (img_data, row.row_buffer, png_ptr);
-			break;
-		}
-
-		case 16: {
-			// 16-bit color. (565)
-			T_writePNG_rows_16<uint16_t, 5, 6, 5>
-					  (img_data, row.row_buffer, png_ptr);
-			// TODO
-			break;
-		}
-
-		case 32:
-		default:
-			// Initialize the row pointers array.
-			// TODO: const uint8_t*.
-			uint8_t *data = (uint8_t*)img_data->data + ((img_data->h - 1) * img_data->pitch);
-			for (int y = img_data->h - 1; y >= 0; y--, data -= img_data->pitch) {
-				row.row_pointers[y] = data;
-			}
-
-			// libpng expects RGB data with no alpha channel, i.e. 24-bit.
-			// However, there is an option to automatically convert 32-bit
-			// without alpha channel to 24-bit, so we'll use that.
-			png_set_filler(png_ptr, 0, PNG_FILLER_AFTER);
-
-			// We're using "BGR" color.
-			png_set_bgr(png_ptr);
-
-			// Write the image.
-			png_write_image(png_ptr, row.row_pointers);
-			break;
+	// Write the image data.
+	// Large images are split into multiple IDAT chunks.
+	static const png_byte png_IDAT[5] = {'I', 'D', 'A', 'T', '\0'};
+	static const png_byte png_IEND[5] = {'I', 'E', 'N', 'D', '\0'};
+	static const size_t IDAT_MAX = 1024*1024;
+	for (size_t pos = 0; pos < idat.size(); pos += IDAT_MAX) {
+		const size_t len = (idat.size() - pos > IDAT_MAX ? IDAT_MAX : idat.size() - pos);
+		png_write_chunk(png_ptr, PNG_CONST_CAST(png_bytep, png_IDAT),
+				PNG_CONST_CAST(png_bytep, &idat[pos]), len);
 	}
 
-	// Free the row pointers.
-	png_free(png_ptr, row.p);
-
 	// Finished writing the PNG image.
-	png_write_end(png_ptr, info_ptr);
+	// NOTE: png_write_end() can't be used, since libpng
+	// didn't write the IDAT chunks. All ancillary chunks
+	// were written by png_write_info(), so only IEND is left.
+	png_write_chunk(png_ptr, PNG_CONST_CAST(png_bytep, png_IEND), nullptr, 0);
 	return 0;
 }
 
@@ -380,6 +745,81 @@ PngWriter::~PngWriter()
 	delete d;
 }
 
+/**
+ * Get the zlib compression level.
+ * @return Compression level. (0-9; default is 5)
+ */
+int PngWriter::compressionLevel(void) const
+{
+	return d->level;
+}
+
+/**
+ * Set the zlib compression level.
+ * @param level Compression level. (0-9)
+ */
+void PngWriter::setCompressionLevel(int level)
+{
+	if (level < 0)
+		level = 0;
+	else if (level > 9)
+		level = 9;
+	d->level = level;
+}
+
+/**
+ * Get the PNG row filter.
+ * @return Row filter. (default is FILTER_NONE)
+ */
+PngWriter::FilterMode PngWriter::filterMode(void) const
+{
+	return d->filterMode;
+}
+
+/**
+ * Set the PNG row filter.
+ * @param filterMode Row filter.
+ */
+void PngWriter::setFilterMode(FilterMode filterMode)
+{
+	if (filterMode < FILTER_NONE || filterMode >= FILTER_MAX)
+		return;
+	d->filterMode = filterMode;
+}
+
+/**
+ * Get the zlib compression strategy.
+ * @return Compression strategy. (default is STRATEGY_DEFAULT)
+ */
+PngWriter::Strategy PngWriter::strategy(void) const
+{
+	return d->strategy;
+}
+
+/**
+ * Set the zlib compression strategy.
+ * @param strategy Compression strategy.
+ */
+void PngWriter::setStrategy(Strategy strategy)
+{
+	if (strategy < STRATEGY_DEFAULT || strategy >= STRATEGY_MAX)
+		return;
+	d->strategy = strategy;
+}
+
+/**
+ * Set a task runner for row-parallel encoding.
+ * @param runner Task runner. (If nullptr, encode on the calling thread.)
+ * @param runnerParam Task runner parameter.
+ * @param maxTasks Maximum number of bands, e.g. the number of threads.
+ */
+void PngWriter::setTaskRunner(TaskRunner runner, void *runnerParam, int maxTasks)
+{
+	d->runner = runner;
+	d->runnerParam = runnerParam;
+	d->maxTasks = (runner && maxTasks > 1 ? maxTasks : 1);
+}
+
 /**
  * Write an image to a PNG file.
  * No metadata other than creation time will be saved.
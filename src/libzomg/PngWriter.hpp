@@ -48,6 +48,105 @@ class PngWriter
 		PngWriter &operator=(const PngWriter &);
 
 	public:
+		/**
+		 * PNG row filter.
+		 * FILTER_ADAPTIVE selects a filter for each row
+		 * using libpng's minimum sum of absolute differences
+		 * heuristic. This usually compresses best for
+		 * screenshots, but it's the slowest option.
+		 */
+		enum FilterMode {
+			FILTER_NONE = 0,
+			FILTER_SUB,
+			FILTER_UP,
+			FILTER_AVERAGE,
+			FILTER_PAETH,
+			FILTER_ADAPTIVE,
+
+			FILTER_MAX
+		};
+
+		/**
+		 * zlib compression strategy.
+		 */
+		enum Strategy {
+			STRATEGY_DEFAULT = 0,
+			STRATEGY_FILTERED,
+			STRATEGY_RLE,
+			STRATEGY_HUFFMAN_ONLY,
+
+			STRATEGY_MAX
+		};
+
+		/**
+		 * Get the zlib compression level.
+		 * @return Compression level. (0-9; default is 5)
+		 */
+		int compressionLevel(void) const;
+
+		/**
+		 * Set the zlib compression level.
+		 * @param level Compression level. (0-9)
+		 */
+		void setCompressionLevel(int level);
+
+		/**
+		 * Get the PNG row filter.
+		 * @return Row filter. (default is FILTER_NONE)
+		 */
+		FilterMode filterMode(void) const;
+
+		/**
+		 * Set the PNG row filter.
+		 * @param filterMode Row filter.
+		 */
+		void setFilterMode(FilterMode filterMode);
+
+		/**
+		 * Get the zlib compression strategy.
+		 * @return Compression strategy. (default is STRATEGY_DEFAULT)
+		 */
+		Strategy strategy(void) const;
+
+		/**
+		 * Set the zlib compression strategy.
+		 * @param strategy Compression strategy.
+		 */
+		void setStrategy(Strategy strategy);
+
+		/**
+		 * Task function.
+		 * @param param Parameter passed to the task runner.
+		 * @param index Task index.
+		 * @param count Total number of tasks.
+		 */
+		typedef void (*TaskFn)(void *param, int index, int count);
+
+		/**
+		 * Task runner.
+		 * Must call fn(param, index, count) once for each index
+		 * in [0, count), and return once all of them have finished.
+		 * This matches LibGens::TaskPool::run().
+		 * @param runnerParam Task runner parameter.
+		 * @param fn Task function.
+		 * @param param Parameter for fn().
+		 * @param count Number of tasks.
+		 */
+		typedef void (*TaskRunner)(void *runnerParam, TaskFn fn, void *param, int count);
+
+		/**
+		 * Set a task runner for row-parallel encoding.
+		 * The image is split into bands of rows, and each band
+		 * is converted, filtered, and compressed as a separate task.
+		 * Compressed bands are joined with zlib sync flushes and
+		 * primed with the previous band's data, so the output is
+		 * a regular PNG image with nearly the same size.
+		 * @param runner Task runner. (If nullptr, encode on the calling thread.)
+		 * @param runnerParam Task runner parameter.
+		 * @param maxTasks Maximum number of bands, e.g. the number of threads.
+		 */
+		void setTaskRunner(TaskRunner runner, void *runnerParam, int maxTasks);
+
 		/**
 		 * Write an image to a PNG file.
 		 * No metadata other than creation time will be saved.
@@ -63,6 +63,9 @@ ZomgPrivate::ZomgPrivate(Zomg *q)
 	: q(q)
 	, unz(nullptr)	// TODO: Combine with zip into a union?
 	, zip(nullptr)	// Need to double-check all users.
+	, format(Zomg::ZOMG_FORMAT_V1)
+	, payloadIndexOffset(0)
+	, payloadCount(0)
 { }
 
 ZomgPrivate::~ZomgPrivate()
@@ -108,7 +111,13 @@ int ZomgPrivate::initZomgLoad(const char *filename)
 		q->m_mtime = buf.st_mtime;
 	}
 
-	return 0;
+	// Check for a ZOMG v2 payload.
+	ret = loadPayload();
+	if (ret != 0) {
+		unzClose(this->unz);
+		this->unz = nullptr;
+	}
+	return ret;
 }
 
 /**
@@ -150,6 +159,14 @@ int ZomgPrivate::initZomgSave(const char *filename)
 		this->zipfi.tmz_date.tm_year = tm_local.tm_year;
 	}
 
+	if (format == Zomg::ZOMG_FORMAT_V2) {
+		// Reserve enough space for a typical MD savestate
+		// so the payload is a single allocation.
+		// (VRam, M68K RAM, Z80 RAM, SRam, and registers.)
+		payload.reserve(256*1024);
+		payloadIndex.reserve(32);
+	}
+
 	return 0;
 }
 
@@ -159,11 +176,16 @@ int ZomgPrivate::initZomgSave(const char *filename)
  * Open a ZOMG savestate file.
  * @param filename ZOMG filename.
  * @param mode File mode.
+ * @param format ZOMG format version for ZOMG_SAVE. (Detected on ZOMG_LOAD.)
  */
-Zomg::Zomg(const char *filename, ZomgFileMode mode)
+Zomg::Zomg(const char *filename, ZomgFileMode mode, ZomgFormat format)
 	: ZomgBase(filename, mode)
 	, d(new ZomgPrivate(this))
 {
+	if (mode == ZOMG_SAVE) {
+		d->format = format;
+	}
+
 	if (!filename || !filename[0]) {
 		// No filename specified.
 		m_lastError = -EINVAL;
@@ -210,21 +232,43 @@ Zomg::~Zomg()
 
 /**
  * Close the ZOMG savestate file.
+ * For ZOMG v2, the payload is written here;
+ * check lastError() afterwards.
  */
 void Zomg::close(void)
 {
+	int ret = 0;
 	if (d->unz) {
 		unzClose(d->unz);
 		d->unz = nullptr;
 	}
 
 	if (d->zip) {
+		if (d->format == ZOMG_FORMAT_V2) {
+			// Write the payload.
+			ret = d->savePayload();
+		}
 		zipClose(d->zip, nullptr);
 		d->zip = nullptr;
 	}
 
+	// Release the payload.
+	std::vector<uint8_t>().swap(d->payload);
+	std::vector<Zomg_Payload_Entry_t>().swap(d->payloadIndex);
+	d->payloadIndexOffset = 0;
+	d->payloadCount = 0;
+
 	m_mode = ZOMG_CLOSED;
-	m_lastError = 0;
+	m_lastError = ret;
+}
+
+/**
+ * Get the ZOMG format version.
+ * @return ZOMG format version.
+ */
+Zomg::ZomgFormat Zomg::format(void) const
+{
+	return d->format;
 }
 
 
@@ -237,6 +281,8 @@ bool Zomg::DetectFormat(const char *filename)
 {
 	// TODO: This only checks if the file is a ZIP file.
 	// Check FORMAT.INI once it's implemented.
+	// NOTE: ZOMG v1 and v2 are both Zip archives.
+	// The version is detected when the file is opened.
 	static const uint8_t zip_magic[] = {'P', 'K', 0x03, 0x04};
 
 	// TODO: Win32 Unicode translation.
@@ -37,7 +37,25 @@ class ZomgPrivate;
 class Zomg : public ZomgBase
 {
 	public:
-		Zomg(const char *filename, ZomgFileMode mode);
+		/**
+		 * ZOMG format version.
+		 * - v1: Each block is a separate deflated Zip member.
+		 * - v2: All binary blocks are packed into a single
+		 *       LZ4-compressed member. (See zomg_payload.h.)
+		 * ZOMG.ini and preview.png are the same in both versions.
+		 */
+		enum ZomgFormat {
+			ZOMG_FORMAT_V1 = 1,
+			ZOMG_FORMAT_V2 = 2,
+		};
+
+		/**
+		 * Open a ZOMG savestate file.
+		 * @param filename ZOMG filename.
+		 * @param mode File mode.
+		 * @param format ZOMG format version for ZOMG_SAVE. (Detected on ZOMG_LOAD.)
+		 */
+		Zomg(const char *filename, ZomgFileMode mode, ZomgFormat format = ZOMG_FORMAT_V1);
 		virtual ~Zomg(void);
 
 	protected:
@@ -50,8 +68,19 @@ class Zomg : public ZomgBase
 		Zomg &operator=(const Zomg &);
 
 	public:
+		/**
+		 * Close the ZOMG savestate file.
+		 * For ZOMG v2, the payload is written here;
+		 * check lastError() afterwards.
+		 */
 		virtual void close(void) final;
 
+		/**
+		 * Get the ZOMG format version.
+		 * @return ZOMG format version.
+		 */
+		ZomgFormat format(void) const;
+
 		/**
 		 * Detect if a savestate is supported by this class.
 		 * @param filename Savestate filename.
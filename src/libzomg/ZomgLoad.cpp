@@ -30,6 +30,9 @@
 // MiniZip
 #include "minizip/unzip.h"
 
+// LZ4
+#include <lz4.h>
+
 // ZOMG save structs.
 #include "zomg_vdp.h"
 #include "zomg_psg.h"
@@ -41,6 +44,7 @@
 #include "zomg_md_time_reg.h"
 #include "zomg_md_tmss_reg.h"
 #include "zomg_eeprom.h"
+#include "zomg_payload.h"
 
 // C includes.
 #include <stdint.h>
@@ -70,6 +74,20 @@ int ZomgPrivate::loadFromZomg(const char *filename, void *buf, int len)
 	if (q->m_mode != ZomgBase::ZOMG_LOAD || !this->unz)
 		return -EBADF;
 
+	if (format == Zomg::ZOMG_FORMAT_V2) {
+		// Check the payload first.
+		unsigned int size;
+		const uint8_t *data = findInPayload(filename, &size);
+		if (data) {
+			if (len < 0)
+				return -EINVAL;
+			if ((unsigned int)len > size)
+				len = (int)size;
+			memcpy(buf, data, len);
+			return len;
+		}
+	}
+
 	// Locate the file in the ZOMG file.
 	int ret = unzLocateFile(this->unz, filename, 2);
 	if (ret != UNZ_OK) {
@@ -92,6 +110,130 @@ int ZomgPrivate::loadFromZomg(const char *filename, void *buf, int len)
 	return ret;
 }
 
+/**
+ * Load and decompress the ZOMG v2 payload, if present.
+ * @return 0 on success or if no payload is present; negative errno on error.
+ */
+int ZomgPrivate::loadPayload(void)
+{
+	int ret = unzLocateFile(this->unz, ZOMG_PAYLOAD_FILENAME, 2);
+	if (ret != UNZ_OK) {
+		// No payload. This is a ZOMG v1 file.
+		format = Zomg::ZOMG_FORMAT_V1;
+		return 0;
+	}
+
+	unz_file_info64 file_info;
+	ret = unzGetCurrentFileInfo64(this->unz, &file_info, nullptr, 0, nullptr, 0, nullptr, 0);
+	if (ret != UNZ_OK)
+		return -EIO;
+	if (file_info.uncompressed_size < sizeof(Zomg_Payload_Header_t) ||
+	    file_info.uncompressed_size > ZOMG_PAYLOAD_MAX_SIZE)
+	{
+		// Payload size is invalid.
+		return -EIO;
+	}
+
+	// Read the compressed payload.
+	const int raw_len = (int)file_info.uncompressed_size;
+	std::vector<uint8_t> raw(raw_len);
+	ret = unzOpenCurrentFile(this->unz);
+	if (ret != UNZ_OK)
+		return -EIO;
+	ret = unzReadCurrentFile(this->unz, raw.data(), raw_len);
+	unzCloseCurrentFile(this->unz);	// TODO: Check the return value!
+	if (ret != raw_len)
+		return -EIO;
+
+	// Check the header.
+	Zomg_Payload_Header_t header;
+	memcpy(&header, raw.data(), sizeof(header));
+	header.header	= be32_to_cpu(header.header);
+	header.codec	= be32_to_cpu(header.codec);
+	header.size	= be32_to_cpu(header.size);
+	header.csize	= be32_to_cpu(header.csize);
+	if (header.header != ZOMG_PAYLOAD_HEADER ||
+	    header.csize != (raw_len - sizeof(header)) ||
+	    header.size < sizeof(Zomg_Payload_Trailer_t) ||
+	    header.size > ZOMG_PAYLOAD_MAX_SIZE)
+	{
+		return -EIO;
+	}
+
+	// Decompress the payload.
+	payload.resize(header.size);
+	const uint8_t *const src = raw.data() + sizeof(header);
+	switch (header.codec) {
+		case ZOMG_PAYLOAD_CODEC_NONE:
+			if (header.csize != header.size)
+				return -EIO;
+			memcpy(payload.data(), src, header.size);
+			break;
+		case ZOMG_PAYLOAD_CODEC_LZ4:
+			ret = LZ4_decompress_safe((const char*)src, (char*)payload.data(),
+				(int)header.csize, (int)header.size);
+			if (ret != (int)header.size)
+				return -EIO;
+			break;
+		default:
+			// Unsupported codec.
+			return -EIO;
+	}
+
+	// Check the block index.
+	Zomg_Payload_Trailer_t trailer;
+	memcpy(&trailer, &payload[header.size - sizeof(trailer)], sizeof(trailer));
+	trailer.index = be32_to_cpu(trailer.index);
+	trailer.count = be32_to_cpu(trailer.count);
+	const uint32_t index_end = header.size - sizeof(trailer);
+	if (trailer.index > index_end ||
+	    trailer.count > (index_end - trailer.index) / sizeof(Zomg_Payload_Entry_t))
+	{
+		return -EIO;
+	}
+
+	for (unsigned int i = 0; i < trailer.count; i++) {
+		Zomg_Payload_Entry_t entry;
+		memcpy(&entry, &payload[trailer.index + (i * sizeof(entry))], sizeof(entry));
+		const uint32_t offset = be32_to_cpu(entry.offset);
+		const uint32_t size = be32_to_cpu(entry.size);
+		if (offset > trailer.index || size > trailer.index - offset ||
+		    entry.name[sizeof(entry.name)-1] != 0)
+		{
+			// Block is out of range, or the name is invalid.
+			return -EIO;
+		}
+	}
+
+	format = Zomg::ZOMG_FORMAT_V2;
+	payloadIndexOffset = trailer.index;
+	payloadCount = trailer.count;
+	return 0;
+}
+
+/**
+ * Find a block in the ZOMG v2 payload.
+ * @param filename	[in] Block filename.
+ * @param size		[out] Block size.
+ * @return Pointer to the block data, or nullptr if not found.
+ */
+const uint8_t *ZomgPrivate::findInPayload(const char *filename, unsigned int *size) const
+{
+	// NOTE: The index was validated by loadPayload().
+	const uint8_t *p = &payload[payloadIndexOffset];
+	for (unsigned int i = 0; i < payloadCount; i++, p += sizeof(Zomg_Payload_Entry_t)) {
+		Zomg_Payload_Entry_t entry;
+		memcpy(&entry, p, sizeof(entry));
+		if (!strcmp(entry.name, filename)) {
+			*size = be32_to_cpu(entry.size);
+			return &payload[be32_to_cpu(entry.offset)];
+		}
+	}
+
+	// Block not found.
+	return nullptr;
+}
+
 /**
  * Load savestate functions.
  * @param siz Number of bytes to read.
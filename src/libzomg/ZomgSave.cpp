@@ -31,6 +31,9 @@
 // MiniZip
 #include "minizip/zip.h"
 
+// LZ4
+#include <lz4.h>
+
 // ZOMG save structs.
 #include "zomg_vdp.h"
 #include "zomg_psg.h"
@@ -42,6 +45,7 @@
 #include "zomg_md_time_reg.h"
 #include "zomg_md_tmss_reg.h"
 #include "zomg_eeprom.h"
+#include "zomg_payload.h"
 
 // C includes.
 #include <stdint.h>
@@ -90,6 +94,7 @@ namespace LibZomg {
 
 /**
  * Save a file to the ZOMG file.
+ * For ZOMG v2, binary files are added to the payload.
  * @param filename     [in] Filename to save in the ZOMG file.
  * @param buf          [in] Buffer containing the file contents.
  * @param len          [in] Length of the buffer.
@@ -102,6 +107,23 @@ int ZomgPrivate::saveToZomg(const char *filename, const void *buf, int len,
 	if (q->m_mode != ZomgBase::ZOMG_SAVE || !this->zip)
 		return -EBADF;
 
+	if (format == Zomg::ZOMG_FORMAT_V2 && fileType == ZOMG_FILE_BINARY)
+		return addToPayload(filename, buf, len);
+	return writeZipFile(filename, buf, len, fileType, Z_DEFLATED);
+}
+
+/**
+ * Write a member to the Zip archive.
+ * @param filename     [in] Filename in the Zip archive.
+ * @param buf          [in] File contents.
+ * @param len          [in] Length of buf.
+ * @param fileType     [in] File type, e.g. binary or text.
+ * @param method       [in] Compression method. (Z_DEFLATED or 0 for stored)
+ * @return 0 on success; negative errno on error.
+ */
+int ZomgPrivate::writeZipFile(const char *filename, const void *buf, int len,
+			      ZomgZipFileType_t fileType, int method)
+{
 	// Open the new file in the ZOMG file.
 	zip_fileinfo zipfi;
 	memcpy(&zipfi.tmz_date, &this->zipfi.tmz_date, sizeof(zipfi.tmz_date));
@@ -119,8 +141,8 @@ int ZomgPrivate::saveToZomg(const char *filename, const void *buf, int len,
 		nullptr,		// extrafield_global,
 		0,			// size_extrafield_global,
 		nullptr,		// comment
-		Z_DEFLATED,		// method
-		Z_DEFAULT_COMPRESSION,  // level
+		method,			// method
+		(method == Z_DEFLATED ? Z_DEFAULT_COMPRESSION : 0),	// level
 		// The following values, except for versionMadeBy,
 		// are all defaults from zipOpenNewFileInZip().
 		0,			// raw
@@ -146,6 +168,92 @@ int ZomgPrivate::saveToZomg(const char *filename, const void *buf, int len,
 	return 0;
 }
 
+/**
+ * Add a block to the ZOMG v2 payload.
+ * @param filename	[in] Block filename.
+ * @param buf		[in] Block data.
+ * @param len		[in] Length of buf.
+ * @return 0 on success; negative errno on error.
+ */
+int ZomgPrivate::addToPayload(const char *filename, const void *buf, int len)
+{
+	Zomg_Payload_Entry_t entry;
+	const size_t name_len = strlen(filename);
+	if (len < 0 || name_len >= sizeof(entry.name))
+		return -EINVAL;
+	if (payload.size() + len + ZOMG_PAYLOAD_ALIGN > ZOMG_PAYLOAD_MAX_SIZE)
+		return -ENOMEM;
+
+	// Blocks start on an aligned offset.
+	const size_t offset = (payload.size() + (ZOMG_PAYLOAD_ALIGN - 1)) & ~(ZOMG_PAYLOAD_ALIGN - 1);
+	payload.resize(offset + len);
+	memcpy(&payload[offset], buf, len);
+
+	memset(entry.name, 0, sizeof(entry.name));
+	memcpy(entry.name, filename, name_len);
+	entry.offset = (uint32_t)offset;
+	entry.size = (uint32_t)len;
+	payloadIndex.push_back(entry);
+	return 0;
+}
+
+/**
+ * Compress the ZOMG v2 payload and write it to the Zip archive.
+ * @return 0 on success; negative errno on error.
+ */
+int ZomgPrivate::savePayload(void)
+{
+	if (payloadIndex.empty()) {
+		// Nothing to save.
+		return 0;
+	}
+
+	// Append the block index and trailer.
+	const size_t index = (payload.size() + (ZOMG_PAYLOAD_ALIGN - 1)) & ~(ZOMG_PAYLOAD_ALIGN - 1);
+	const size_t size = index + (payloadIndex.size() * sizeof(Zomg_Payload_Entry_t)) +
+			    sizeof(Zomg_Payload_Trailer_t);
+	if (size > ZOMG_PAYLOAD_MAX_SIZE)
+		return -ENOMEM;
+	payload.resize(size);
+
+	uint8_t *p = &payload[index];
+	for (std::vector<Zomg_Payload_Entry_t>::const_iterator iter = payloadIndex.begin();
+	     iter != payloadIndex.end(); ++iter, p += sizeof(Zomg_Payload_Entry_t))
+	{
+		Zomg_Payload_Entry_t entry = *iter;
+		entry.offset = cpu_to_be32(entry.offset);
+		entry.size = cpu_to_be32(entry.size);
+		memcpy(p, &entry, sizeof(entry));
+	}
+
+	Zomg_Payload_Trailer_t trailer;
+	trailer.index = cpu_to_be32((uint32_t)index);
+	trailer.count = cpu_to_be32((uint32_t)payloadIndex.size());
+	memcpy(p, &trailer, sizeof(trailer));
+
+	// Compress the payload.
+	std::vector<uint8_t> out(sizeof(Zomg_Payload_Header_t) + LZ4_compressBound((int)size));
+	Zomg_Payload_Header_t header;
+	int csize = LZ4_compress_default((const char*)payload.data(),
+		(char*)&out[sizeof(header)], (int)size, (int)(out.size() - sizeof(header)));
+	if (csize > 0 && (size_t)csize < size) {
+		header.codec = cpu_to_be32(ZOMG_PAYLOAD_CODEC_LZ4);
+	} else {
+		// Compression didn't help. Store the payload as-is.
+		memcpy(&out[sizeof(header)], payload.data(), size);
+		csize = (int)size;
+		header.codec = cpu_to_be32(ZOMG_PAYLOAD_CODEC_NONE);
+	}
+	header.header = cpu_to_be32(ZOMG_PAYLOAD_HEADER);
+	header.size = cpu_to_be32((uint32_t)size);
+	header.csize = cpu_to_be32((uint32_t)csize);
+	memcpy(out.data(), &header, sizeof(header));
+
+	// The payload is already compressed, so store it as-is.
+	return writeZipFile(ZOMG_PAYLOAD_FILENAME, out.data(),
+		(int)(sizeof(header) + csize), ZOMG_FILE_BINARY, 0);
+}
+
 /**
  * Save savestate functions.
  * @param siz Number of bytes to write.
@@ -26,6 +26,15 @@
 #include "minizip/zip.h"
 #include "minizip/unzip.h"
 
+// C includes.
+#include <stdint.h>
+
+// C++ includes.
+#include <vector>
+
+#include "Zomg.hpp"
+#include "zomg_payload.h"
+
 namespace LibZomg {
 
 class Zomg;
@@ -68,6 +77,67 @@ class ZomgPrivate
 		int loadFromZomg(const char *filename, void *buf, int len);
 		int saveToZomg(const char *filename, const void *buf, int len,
 			       ZomgZipFileType_t fileType = ZOMG_FILE_BINARY);
+
+		/**
+		 * Write a member to the Zip archive.
+		 * @param filename     [in] Filename in the Zip archive.
+		 * @param buf          [in] File contents.
+		 * @param len          [in] Length of buf.
+		 * @param fileType     [in] File type, e.g. binary or text.
+		 * @param method       [in] Compression method. (Z_DEFLATED or 0 for stored)
+		 * @return 0 on success; negative errno on error.
+		 */
+		int writeZipFile(const char *filename, const void *buf, int len,
+				 ZomgZipFileType_t fileType, int method);
+
+	public:
+		/** ZOMG v2 **/
+
+		// ZOMG format version.
+		Zomg::ZomgFormat format;
+
+		/**
+		 * Decompressed payload.
+		 * ZOMG_SAVE: Blocks are appended here as they're saved.
+		 * ZOMG_LOAD: The entire payload is decompressed here.
+		 */
+		std::vector<uint8_t> payload;
+
+		// ZOMG_SAVE: Block index. (host-endian)
+		std::vector<Zomg_Payload_Entry_t> payloadIndex;
+
+		// ZOMG_LOAD: Block index location in payload[].
+		unsigned int payloadIndexOffset;
+		unsigned int payloadCount;
+
+		/**
+		 * Load and decompress the ZOMG v2 payload, if present.
+		 * @return 0 on success or if no payload is present; negative errno on error.
+		 */
+		int loadPayload(void);
+
+		/**
+		 * Find a block in the ZOMG v2 payload.
+		 * @param filename	[in] Block filename.
+		 * @param size		[out] Block size.
+		 * @return Pointer to the block data, or nullptr if not found.
+		 */
+		const uint8_t *findInPayload(const char *filename, unsigned int *size) const;
+
+		/**
+		 * Add a block to the ZOMG v2 payload.
+		 * @param filename	[in] Block filename.
+		 * @param buf		[in] Block data.
+		 * @param len		[in] Length of buf.
+		 * @return 0 on success; negative errno on error.
+		 */
+		int addToPayload(const char *filename, const void *buf, int len);
+
+		/**
+		 * Compress the ZOMG v2 payload and write it to the Zip archive.
+		 * @return 0 on success; negative errno on error.
+		 */
+		int savePayload(void);
 };
 
 }
@@ -0,0 +1,276 @@
+/***************************************************************************
+ * libzomg/tests: Zipped Original Memory from Genesis. (Test Suite)        *
+ * PngWriterTest.cpp: PNG writer tests.                                    *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+#include "PngWriter.hpp"
+#include "PngReader.hpp"
+#include "img_data.h"
+
+// C includes. (C++ namespace)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ includes.
+#include <vector>
+using std::vector;
+
+namespace LibZomg { namespace Tests {
+
+/**
+ * Test parameters.
+ * - Color depth.
+ * - Row filter.
+ * - Number of bands.
+ */
+struct PngWriterTest_mode {
+	uint8_t bpp;
+	PngWriter::FilterMode filterMode;
+	int bands;
+
+	PngWriterTest_mode(uint8_t bpp, PngWriter::FilterMode filterMode, int bands)
+		: bpp(bpp)
+		, filterMode(filterMode)
+		, bands(bands)
+	{ }
+};
+
+class PngWriterTest : public ::testing::TestWithParam<PngWriterTest_mode>
+{
+	protected:
+		PngWriterTest()
+			: ::testing::TestWithParam<PngWriterTest_mode>() { }
+
+		virtual void TearDown(void);
+
+		/**
+		 * Task runner that runs tasks in reverse order.
+		 * This makes sure bands don't depend on running in order.
+		 */
+		static void reverseRunner(void *runnerParam, PngWriter::TaskFn fn,
+					  void *param, int count);
+
+		static const char filename[];
+		static const int WIDTH = 320;
+		static const int HEIGHT = 224;
+};
+
+const char PngWriterTest::filename[] = "PngWriterTest.png";
+
+void PngWriterTest::TearDown(void)
+{
+	remove(filename);
+}
+
+/**
+ * Task runner that runs tasks in reverse order.
+ * This makes sure bands don't depend on running in order.
+ */
+void PngWriterTest::reverseRunner(void *runnerParam, PngWriter::TaskFn fn,
+				  void *param, int count)
+{
+	int *const calls = static_cast<int*>(runnerParam);
+	(*calls)++;
+	for (int i = count - 1; i >= 0; i--) {
+		fn(param, i, count);
+	}
+}
+
+/**
+ * Write an image and read it back.
+ */
+TEST_P(PngWriterTest, roundTrip)
+{
+	const PngWriterTest_mode mode = GetParam();
+
+	// Test image: gradients with some noise.
+	// Row pitch is larger than the width to test pitch handling.
+	const int pxPitch = WIDTH + 16;
+	vector<uint32_t> img32(pxPitch * HEIGHT);
+	vector<uint16_t> img16(pxPitch * HEIGHT);
+	uint32_t lfsr = 0xC0FFEE;
+	for (int y = 0; y < HEIGHT; y++) {
+		for (int x = 0; x < WIDTH; x++) {
+			lfsr ^= (lfsr << 13);
+			lfsr ^= (lfsr >> 17);
+			lfsr ^= (lfsr << 5);
+			const uint8_t r = (uint8_t)(x * 255 / WIDTH);
+			const uint8_t g = (uint8_t)(y * 255 / HEIGHT);
+			const uint8_t b = ((x / 8) & 1) ? (uint8_t)lfsr : 0x80;
+			img32[y * pxPitch + x] = (r << 16) | (g << 8) | b;
+			if (mode.bpp == 15) {
+				img16[y * pxPitch + x] = ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+			} else {
+				img16[y * pxPitch + x] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+			}
+		}
+	}
+
+	Zomg_Img_Data_t img_data;
+	memset(&img_data, 0, sizeof(img_data));
+	img_data.w = WIDTH;
+	img_data.h = HEIGHT;
+	img_data.bpp = mode.bpp;
+	if (mode.bpp == 32) {
+		img_data.data = img32.data();
+		img_data.pitch = pxPitch * sizeof(uint32_t);
+	} else {
+		img_data.data = img16.data();
+		img_data.pitch = pxPitch * sizeof(uint16_t);
+	}
+
+	PngWriter pngWriter;
+	pngWriter.setFilterMode(mode.filterMode);
+	int calls = 0;
+	if (mode.bands > 1) {
+		pngWriter.setTaskRunner(reverseRunner, &calls, mode.bands);
+	}
+	ASSERT_EQ(0, pngWriter.writeToFile(&img_data, filename));
+	if (mode.bands > 1) {
+		// Filtering and compression.
+		EXPECT_EQ(2, calls);
+	}
+
+	// Read the image back.
+	Zomg_Img_Data_t img_read;
+	memset(&img_read, 0, sizeof(img_read));
+	PngReader pngReader;
+	ASSERT_EQ(0, pngReader.readFromFile(&img_read, filename));
+	ASSERT_EQ((uint32_t)WIDTH, img_read.w);
+	ASSERT_EQ((uint32_t)HEIGHT, img_read.h);
+	ASSERT_EQ(32, img_read.bpp);
+
+	// PngReader returns the same 32-bit format used for input.
+	unsigned int errors = 0;
+	for (int y = 0; y < HEIGHT; y++) {
+		const uint32_t *row = (const uint32_t*)((const uint8_t*)img_read.data + (y * img_read.pitch));
+		for (int x = 0; x < WIDTH; x++) {
+			uint8_t r, g, b;
+			if (mode.bpp == 32) {
+				const uint32_t px = img32[y * pxPitch + x];
+				r = (uint8_t)(px >> 16); g = (uint8_t)(px >> 8); b = (uint8_t)px;
+			} else {
+				const uint16_t px = img16[y * pxPitch + x];
+				if (mode.bpp == 15) {
+					r = ((px >> 10) & 0x1F) << 3; r |= (r >> 5);
+					g = ((px >> 5) & 0x1F) << 3; g |= (g >> 5);
+				} else {
+					r = ((px >> 11) & 0x1F) << 3; r |= (r >> 5);
+					g = ((px >> 5) & 0x3F) << 2; g |= (g >> 6);
+				}
+				b = (px & 0x1F) << 3; b |= (b >> 5);
+			}
+			const uint32_t expected = (r << 16) | (g << 8) | b;
+			if ((row[x] & 0xFFFFFF) != expected) {
+				errors++;
+			}
+		}
+	}
+	EXPECT_EQ(0U, errors);
+	free(img_read.data);
+}
+
+/**
+ * Compression level and strategy should not affect the image.
+ */
+TEST_F(PngWriterTest, levelAndStrategy)
+{
+	vector<uint32_t> img32(WIDTH * HEIGHT);
+	for (int i = 0; i < WIDTH * HEIGHT; i++) {
+		img32[i] = (uint32_t)(i * 0x010203);
+	}
+
+	Zomg_Img_Data_t img_data;
+	memset(&img_data, 0, sizeof(img_data));
+	img_data.data = img32.data();
+	img_data.w = WIDTH;
+	img_data.h = HEIGHT;
+	img_data.pitch = WIDTH * sizeof(uint32_t);
+	img_data.bpp = 32;
+
+	PngWriter pngWriter;
+	EXPECT_EQ(5, pngWriter.compressionLevel());
+	EXPECT_EQ(PngWriter::FILTER_NONE, pngWriter.filterMode());
+	EXPECT_EQ(PngWriter::STRATEGY_DEFAULT, pngWriter.strategy());
+
+	for (int level = 0; level <= 9; level += 3) {
+		for (int strategy = 0; strategy < PngWriter::STRATEGY_MAX; strategy++) {
+			pngWriter.setCompressionLevel(level);
+			pngWriter.setStrategy((PngWriter::Strategy)strategy);
+			ASSERT_EQ(0, pngWriter.writeToFile(&img_data, filename));
+
+			Zomg_Img_Data_t img_read;
+			memset(&img_read, 0, sizeof(img_read));
+			PngReader pngReader;
+			ASSERT_EQ(0, pngReader.readFromFile(&img_read, filename));
+			unsigned int errors = 0;
+			for (int i = 0; i < WIDTH * HEIGHT; i++) {
+				const uint32_t expected = img32[i] & 0xFFFFFF;
+				if ((((const uint32_t*)img_read.data)[i] & 0xFFFFFF) != expected) {
+					errors++;
+				}
+			}
+			EXPECT_EQ(0U, errors) << "level " << level << ", strategy " << strategy;
+			free(img_read.data);
+		}
+	}
+}
+
+// Test cases.
+INSTANTIATE_TEST_CASE_P(PngWriterTest_32, PngWriterTest,
+	::testing::Values(
+		PngWriterTest_mode(32, PngWriter::FILTER_NONE, 1),
+		PngWriterTest_mode(32, PngWriter::FILTER_SUB, 1),
+		PngWriterTest_mode(32, PngWriter::FILTER_UP, 1),
+		PngWriterTest_mode(32, PngWriter::FILTER_AVERAGE, 1),
+		PngWriterTest_mode(32, PngWriter::FILTER_PAETH, 1),
+		PngWriterTest_mode(32, PngWriter::FILTER_ADAPTIVE, 1),
+		PngWriterTest_mode(32, PngWriter::FILTER_NONE, 4),
+		PngWriterTest_mode(32, PngWriter::FILTER_PAETH, 4),
+		PngWriterTest_mode(32, PngWriter::FILTER_ADAPTIVE, 4),
+		PngWriterTest_mode(32, PngWriter::FILTER_ADAPTIVE, 64)
+		));
+
+INSTANTIATE_TEST_CASE_P(PngWriterTest_16, PngWriterTest,
+	::testing::Values(
+		PngWriterTest_mode(15, PngWriter::FILTER_NONE, 1),
+		PngWriterTest_mode(15, PngWriter::FILTER_ADAPTIVE, 3),
+		PngWriterTest_mode(16, PngWriter::FILTER_NONE, 1),
+		PngWriterTest_mode(16, PngWriter::FILTER_AVERAGE, 3),
+		PngWriterTest_mode(16, PngWriter::FILTER_ADAPTIVE, 3)
+		));
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibZomg test suite: PNG writer tests.\n\n");
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
@@ -0,0 +1,230 @@
+/***************************************************************************
+ * libzomg/tests: Zipped Original Memory from Genesis. (Test Suite)        *
+ * ZomgV2Test.cpp: ZOMG v2 payload tests.                                  *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+// Google Test
+#include "gtest/gtest.h"
+
+#include "Zomg.hpp"
+#include "zomg_psg.h"
+#include "zomg_payload.h"
+
+// LZ4
+#include <lz4.h>
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ includes.
+#include <vector>
+using std::vector;
+
+namespace LibZomg { namespace Tests {
+
+class ZomgV2Test : public ::testing::Test
+{
+	protected:
+		ZomgV2Test()
+			: ::testing::Test() { }
+
+		virtual void SetUp(void);
+		virtual void TearDown(void);
+
+		/**
+		 * Save a test savestate.
+		 * @param format ZOMG format version.
+		 * @return 0 on success; negative errno on error.
+		 */
+		int saveTestState(Zomg::ZomgFormat format);
+
+		// Test data.
+		uint8_t z80_mem[8192];
+		uint16_t m68k_mem[32768];
+		_Zomg_PsgSave_t psg;
+
+		static const char filename[];
+};
+
+const char ZomgV2Test::filename[] = "ZomgV2Test.zomg";
+
+void ZomgV2Test::SetUp(void)
+{
+	// Mostly-compressible data with some noise,
+	// similar to emulated RAM.
+	uint32_t lfsr = 0x12345678;
+	for (unsigned int i = 0; i < sizeof(z80_mem); i++) {
+		lfsr ^= (lfsr << 13);
+		lfsr ^= (lfsr >> 17);
+		lfsr ^= (lfsr << 5);
+		z80_mem[i] = ((i & 0x100) ? (lfsr & 0xFF) : (i & 0x0F));
+	}
+	for (unsigned int i = 0; i < sizeof(m68k_mem)/sizeof(m68k_mem[0]); i++) {
+		m68k_mem[i] = (uint16_t)((i & 0x3F) * 0x0101);
+	}
+	memset(&psg, 0x5A, sizeof(psg));
+}
+
+void ZomgV2Test::TearDown(void)
+{
+	remove(filename);
+}
+
+/**
+ * Save a test savestate.
+ * @param format ZOMG format version.
+ * @return 0 on success; negative errno on error.
+ */
+int ZomgV2Test::saveTestState(Zomg::ZomgFormat format)
+{
+	Zomg zomg(filename, Zomg::ZOMG_SAVE, format);
+	if (!zomg.isOpen())
+		return -ENOENT;
+	EXPECT_EQ(format, zomg.format());
+
+	int ret = zomg.saveZ80Mem(z80_mem, sizeof(z80_mem));
+	if (ret != 0)
+		return ret;
+	ret = zomg.saveM68KMem(m68k_mem, sizeof(m68k_mem), ZOMG_BYTEORDER_16H);
+	if (ret != 0)
+		return ret;
+	ret = zomg.savePsgReg(&psg);
+	if (ret != 0)
+		return ret;
+
+	zomg.close();
+	return zomg.lastError();
+}
+
+/**
+ * Test LZ4 block compression and decompression.
+ */
+TEST_F(ZomgV2Test, lz4RoundTrip)
+{
+	const char *const src = (const char*)z80_mem;
+	vector<char> cbuf(LZ4_compressBound(sizeof(z80_mem)));
+	int csize = LZ4_compress_default(src, cbuf.data(), sizeof(z80_mem), (int)cbuf.size());
+	ASSERT_GT(csize, 0);
+	EXPECT_LT(csize, (int)sizeof(z80_mem));
+
+	char out[sizeof(z80_mem)];
+	EXPECT_EQ((int)sizeof(out), LZ4_decompress_safe(cbuf.data(), out, csize, sizeof(out)));
+	EXPECT_EQ(0, memcmp(z80_mem, out, sizeof(out)));
+
+	// Truncated input and short output buffers must be rejected.
+	EXPECT_LT(LZ4_decompress_safe(cbuf.data(), out, csize - 1, sizeof(out)), 0);
+	EXPECT_LT(LZ4_decompress_safe(cbuf.data(), out, csize, sizeof(out) - 1), 0);
+
+	// Compressing into a buffer that's too small must fail.
+	EXPECT_EQ(0, LZ4_compress_default(src, cbuf.data(), sizeof(z80_mem), 16));
+}
+
+/**
+ * Test saving and loading a ZOMG v2 savestate.
+ */
+TEST_F(ZomgV2Test, v2RoundTrip)
+{
+	ASSERT_EQ(0, saveTestState(Zomg::ZOMG_FORMAT_V2));
+	ASSERT_TRUE(Zomg::DetectFormat(filename));
+
+	Zomg zomg(filename, Zomg::ZOMG_LOAD);
+	ASSERT_TRUE(zomg.isOpen());
+	EXPECT_EQ(Zomg::ZOMG_FORMAT_V2, zomg.format());
+
+	uint8_t z80_load[sizeof(z80_mem)];
+	uint16_t m68k_load[sizeof(m68k_mem)/sizeof(m68k_mem[0])];
+	_Zomg_PsgSave_t psg_load;
+	EXPECT_EQ((int)sizeof(z80_load), zomg.loadZ80Mem(z80_load, sizeof(z80_load)));
+	EXPECT_EQ((int)sizeof(m68k_load), zomg.loadM68KMem(m68k_load, sizeof(m68k_load), ZOMG_BYTEORDER_16H));
+	EXPECT_EQ((int)sizeof(psg_load), zomg.loadPsgReg(&psg_load));
+	EXPECT_EQ(0, memcmp(z80_mem, z80_load, sizeof(z80_load)));
+	EXPECT_EQ(0, memcmp(m68k_mem, m68k_load, sizeof(m68k_load)));
+	EXPECT_EQ(0, memcmp(&psg, &psg_load, sizeof(psg_load)));
+}
+
+/**
+ * Verify that ZOMG v1 savestates are still detected as v1.
+ */
+TEST_F(ZomgV2Test, v1RoundTrip)
+{
+	ASSERT_EQ(0, saveTestState(Zomg::ZOMG_FORMAT_V1));
+
+	Zomg zomg(filename, Zomg::ZOMG_LOAD);
+	ASSERT_TRUE(zomg.isOpen());
+	EXPECT_EQ(Zomg::ZOMG_FORMAT_V1, zomg.format());
+
+	uint8_t z80_load[sizeof(z80_mem)];
+	EXPECT_EQ((int)sizeof(z80_load), zomg.loadZ80Mem(z80_load, sizeof(z80_load)));
+	EXPECT_EQ(0, memcmp(z80_mem, z80_load, sizeof(z80_load)));
+}
+
+/**
+ * Verify that a corrupted payload header is rejected.
+ */
+TEST_F(ZomgV2Test, corruptPayload)
+{
+	ASSERT_EQ(0, saveTestState(Zomg::ZOMG_FORMAT_V2));
+
+	// The payload is stored uncompressed in the Zip archive,
+	// so the header can be located directly.
+	FILE *f = fopen(filename, "r+b");
+	ASSERT_TRUE(f != nullptr);
+	vector<uint8_t> file;
+	uint8_t buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+		file.insert(file.end(), buf, buf + n);
+	}
+
+	static const uint8_t magic[4] = {'Z', 'P', 'K', '2'};
+	size_t pos = 0;
+	for (; pos + sizeof(Zomg_Payload_Header_t) <= file.size(); pos++) {
+		if (!memcmp(&file[pos], magic, sizeof(magic)))
+			break;
+	}
+	ASSERT_LE(pos + sizeof(Zomg_Payload_Header_t), file.size());
+
+	// Set an invalid codec.
+	static const uint8_t bad_codec[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+	fseek(f, (long)(pos + 4), SEEK_SET);
+	fwrite(bad_codec, 1, sizeof(bad_codec), f);
+	fclose(f);
+
+	Zomg zomg(filename, Zomg::ZOMG_LOAD);
+	EXPECT_FALSE(zomg.isOpen());
+	EXPECT_NE(0, zomg.lastError());
+}
+
+} }
+
+/**
+ * Test suite main function.
+ * Called by gtest_main.inc.cpp's main().
+ */
+static int test_main(int argc, char *argv[])
+{
+	fprintf(stderr, "LibZomg test suite: ZOMG v2 payload tests.\n\n");
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+#include "libcompat/tests/gtest_main.inc.cpp"
@@ -0,0 +1,83 @@
+/***************************************************************************
+ * libzomg: Zipped Original Memory from Genesis.                           *
+ * zomg_payload.h: ZOMG save definitions for the v2 payload.               *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+#ifndef __LIBZOMG_ZOMG_PAYLOAD_H__
+#define __LIBZOMG_ZOMG_PAYLOAD_H__
+
+#include "zomg_common.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ZOMG v2 payload.
+ * ZOMG file: payload.bin (stored, not deflated)
+ *
+ * In ZOMG v2, all binary blocks are packed into a single
+ * payload instead of being stored as separate Zip members.
+ * ZOMG.ini and preview.png are still separate members.
+ *
+ * payload.bin consists of Zomg_Payload_Header_t, followed by
+ * the payload compressed with the specified codec.
+ *
+ * Decompressed payload layout:
+ * - Data blocks, each starting at a ZOMG_PAYLOAD_ALIGN-byte boundary.
+ * - Block index: Zomg_Payload_Entry_t[count], aligned.
+ * - Zomg_Payload_Trailer_t.
+ */
+#define ZOMG_PAYLOAD_FILENAME	"payload.bin"
+#define ZOMG_PAYLOAD_HEADER	0x5A504B32	/* "ZPK2" */
+#define ZOMG_PAYLOAD_ALIGN	16
+#define ZOMG_PAYLOAD_MAX_SIZE	(64*1024*1024)
+
+typedef enum {
+	ZOMG_PAYLOAD_CODEC_NONE	= 0,	// Uncompressed.
+	ZOMG_PAYLOAD_CODEC_LZ4	= 1,	// LZ4 block format.
+} Zomg_Payload_Codec_t;
+
+#pragma pack(1)
+typedef struct PACKED _Zomg_Payload_Header_t {
+	uint32_t header;	// 32BE: Should be "ZPK2" (0x5A504B32)
+	uint32_t codec;		// 32BE: Zomg_Payload_Codec_t
+	uint32_t size;		// 32BE: Decompressed payload size.
+	uint32_t csize;		// 32BE: Compressed payload size.
+} Zomg_Payload_Header_t;
+
+typedef struct PACKED _Zomg_Payload_Entry_t {
+	char name[24];		// Block filename, e.g. "common/VRam.bin". (NULL-terminated)
+	uint32_t offset;	// 32BE: Block offset in the decompressed payload.
+	uint32_t size;		// 32BE: Block size.
+} Zomg_Payload_Entry_t;
+
+typedef struct PACKED _Zomg_Payload_Trailer_t {
+	uint32_t index;		// 32BE: Block index offset in the decompressed payload.
+	uint32_t count;		// 32BE: Number of index entries.
+} Zomg_Payload_Trailer_t;
+#pragma pack()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LIBZOMG_ZOMG_PAYLOAD_H__ */
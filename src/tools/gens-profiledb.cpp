@@ -0,0 +1,270 @@
+/***************************************************************************
+ * gens-profiledb: ROM profile database compiler.                          *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+
+/**
+ * Compiles ROM profile text sources into the binary database
+ * that LibGens loads at startup. See doc/RomProfileDB.txt for
+ * the text format.
+ */
+
+// LibGens
+#include "libgens/Cartridge/RomProfileDB.hpp"
+using LibGens::RomProfile;
+using LibGens::RomProfileDB;
+using LibGens::RomProfileDBCompiler;
+
+// C includes.
+#include <locale.h>
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ includes.
+#include <string>
+#include <vector>
+using std::string;
+using std::vector;
+
+// popt
+#include <popt.h>
+
+#ifdef _WIN32
+// Win32 Unicode Translation Layer.
+// Needed for proper Unicode filename support on Windows.
+#include "libcompat/W32U/W32U_mini.h"
+#include "libcompat/W32U/W32U_argv.h"
+#endif
+
+#define GENS_PROFILEDB_VERSION 0x00010000U
+
+static void print_prg_info(void)
+{
+	fprintf(stderr, "gens-profiledb: ROM profile database compiler. (Version %d.%d)\n",
+		((GENS_PROFILEDB_VERSION >> 24) & 0xFF),
+		((GENS_PROFILEDB_VERSION >> 16) & 0xFF));
+	fprintf(stderr, "Part of Gens/GS II.\n");
+}
+
+static void print_help(const poptContext con)
+{
+	print_prg_info();
+	fputc('\n', stderr);
+	poptPrintHelp(con, stderr, 0);
+
+	fprintf(stderr,
+		"\n"
+		"All sources are compiled into a single database. A ROM may\n"
+		"only have one profile per CRC32 or serial number.\n");
+}
+
+/**
+ * Read a text file.
+ * @param filename Filename.
+ * @param text [out] File contents.
+ * @return 0 on success; negative POSIX error code on error.
+ */
+static int readFile(const char *filename, vector<char> &text)
+{
+	FILE *f = fopen(filename, "rb");
+	if (!f)
+		return -errno;
+
+	text.clear();
+	char buf[4096];
+	size_t rd;
+	while ((rd = fread(buf, 1, sizeof(buf), f)) > 0) {
+		text.insert(text.end(), buf, buf + rd);
+	}
+	int err = (ferror(f) ? -EIO : 0);
+	fclose(f);
+	return err;
+}
+
+/**
+ * Look up a ROM in a compiled database and print its profile.
+ * @param db_filename Database filename.
+ * @param key CRC32 (hexadecimal) or serial number.
+ * @return 0 if found; non-zero if not.
+ */
+static int lookupRom(const char *db_filename, const char *key)
+{
+	RomProfileDB db;
+	int ret = db.open(db_filename);
+	if (ret != 0) {
+		fprintf(stderr, "%s: %s\n", db_filename,
+			(ret == -EBADMSG ? "not a valid ROM profile database" : strerror(-ret)));
+		return 1;
+	}
+
+	// Try the key as a CRC32 first, then as a serial number.
+	// CRC32s must have exactly 8 digits, with an optional "0x" prefix.
+	const char *crc_str = key;
+	if (crc_str[0] == '0' && (crc_str[1] == 'x' || crc_str[1] == 'X'))
+		crc_str += 2;
+	char *endptr;
+	uint32_t crc32 = (uint32_t)strtoul(crc_str, &endptr, 16);
+	if (*endptr != 0 || strlen(crc_str) != 8)
+		crc32 = 0;
+	char serial[ROM_PROFILE_SERIAL_LEN + 1];
+	snprintf(serial, sizeof(serial), "%-*s", ROM_PROFILE_SERIAL_LEN, key);
+
+	RomProfile profile;
+	if (!db.find(crc32, serial, &profile)) {
+		printf("%s: no profile\n", key);
+		return 1;
+	}
+
+	printf("%s: %s (fields: 0x%08X)\n", key,
+		(profile.title[0] != 0 ? profile.title : "(untitled)"), profile.fields);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	// Options.
+	const char *out_filename = "romprofile.db";
+	const char *lookup_key = nullptr;
+	int quiet = 0;
+
+	// popt: help options table.
+	struct poptOption helpOptionsTable[] = {
+		{"help", '?', POPT_ARG_NONE, NULL, '?', "Show this help message", NULL},
+		{"usage", 0, POPT_ARG_NONE, NULL, 'u', "Display brief usage message", NULL},
+		{"version", 'V', POPT_ARG_NONE, NULL, 'V', "Display version information", NULL},
+		POPT_TABLEEND
+	};
+
+	// popt: main options table.
+	struct poptOption optionsTable[] = {
+		{"output", 'o', POPT_ARG_STRING, &out_filename, 0,
+			"Output database. (default = romprofile.db)", "FILE"},
+		{"lookup", 'k', POPT_ARG_STRING, &lookup_key, 0,
+			"Look up a CRC32 or serial number in an existing database\n"
+			"instead of compiling one. (Database is the first argument.)", "KEY"},
+		{"quiet", 'q', POPT_ARG_NONE, &quiet, 0,
+			"Only print errors.", NULL},
+		{NULL, 0, POPT_ARG_INCLUDE_TABLE, helpOptionsTable, 0,
+			"Help options:", NULL},
+		POPT_TABLEEND
+	};
+	poptContext optCon;
+	int c;
+
+#ifdef _WIN32
+	// Convert command line parameters to UTF-8.
+	if (W32U_GetArgvU(&argc, &argv, nullptr) != 0) {
+		// ERROR!
+		return EXIT_FAILURE;
+	}
+#endif /* _WIN32 */
+
+	// Initialize locale settings.
+	setlocale(LC_ALL, "");
+
+	// Initialize the popt context.
+	optCon = poptGetContext(NULL, argc, (const char**)argv, optionsTable, 0);
+	poptSetOtherOptionHelp(optCon, "[OPTIONS...] <source.txt> [source.txt...]");
+	if (argc < 2) {
+		poptPrintUsage(optCon, stderr, 0);
+		return EXIT_FAILURE;
+	}
+
+	// Process options.
+	while ((c = poptGetNextOpt(optCon)) >= 0) {
+		switch (c) {
+			case 'V':
+				print_prg_info();
+				return EXIT_SUCCESS;
+
+			case '?':
+				print_help(optCon);
+				return EXIT_SUCCESS;
+
+			case 'u':
+				poptPrintUsage(optCon, stderr, 0);
+				return EXIT_SUCCESS;
+
+			default:
+				break;
+		}
+	}
+
+	if (c < -1) {
+		// An error occurred during option processing.
+		fprintf(stderr, "%s: '%s': %s\n"
+			"Try `%s --help` for more information.\n",
+			argv[0], poptBadOption(optCon, POPT_BADOPTION_NOALIAS),
+			poptStrerror(c), argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (poptPeekArg(optCon) == NULL) {
+		// No files specified.
+		fprintf(stderr, "%s: no %s specified\n"
+			"Try `%s --help` for more information.\n",
+			argv[0], (lookup_key ? "database" : "source files"), argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (lookup_key) {
+		// Look up a ROM in an existing database.
+		int ret = lookupRom(poptGetArg(optCon), lookup_key);
+		poptFreeContext(optCon);
+		return (ret == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	// Compile the sources.
+	RomProfileDBCompiler compiler;
+	vector<char> text;
+	const char *src_filename;
+	while ((src_filename = poptGetArg(optCon)) != NULL) {
+		int ret = readFile(src_filename, text);
+		if (ret != 0) {
+			fprintf(stderr, "%s: %s: %s\n", argv[0], src_filename, strerror(-ret));
+			poptFreeContext(optCon);
+			return EXIT_FAILURE;
+		}
+
+		ret = compiler.parse((text.empty() ? "" : &text[0]), text.size(), src_filename);
+		if (ret != 0) {
+			fprintf(stderr, "%s\n", compiler.lastError().c_str());
+			poptFreeContext(optCon);
+			return EXIT_FAILURE;
+		}
+	}
+
+	int ret = compiler.write(out_filename);
+	if (ret != 0) {
+		fprintf(stderr, "%s: %s: %s\n", argv[0], out_filename, strerror(-ret));
+		poptFreeContext(optCon);
+		return EXIT_FAILURE;
+	}
+
+	if (!quiet) {
+		printf("%s: %u profile(s)\n", out_filename, compiler.count());
+	}
+
+	poptFreeContext(optCon);
+	return EXIT_SUCCESS;
+}
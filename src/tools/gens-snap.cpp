@@ -0,0 +1,357 @@
+/***************************************************************************
+ * gens-snap: Batch screenshot and thumbnail generator.                    *
+ *                                                                         *
+ * Copyright (c) 2016 by David Korth.                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful, but     *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.           *
+ ***************************************************************************/
+
+/**
+ * Loads each ROM image, runs it headless for a number of frames,
+ * and writes a screenshot and/or thumbnail. Emulation runs on the
+ * main thread, since LibGens only supports one emulation context
+ * at a time; PNG encoding runs on a pool of worker threads, so
+ * the next ROM is emulated while the previous images are encoded.
+ */
+
+// LibGens
+#include "libgens/lg_main.hpp"
+#include "libgens/Rom.hpp"
+#include "libgens/EmuContext/EmuContext.hpp"
+#include "libgens/EmuContext/EmuContextFactory.hpp"
+#include "libgens/Vdp/Vdp.hpp"
+#include "libgens/Util/MdFb.hpp"
+#include "libgens/Util/PngEncoder.hpp"
+#include "libgens/Util/Screenshot.hpp"
+#include "libgens/Util/Timing.hpp"
+using namespace LibGens;
+using LibZomg::PngWriter;
+
+// C includes.
+#include <locale.h>
+
+// C includes. (C++ namespace)
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ includes.
+#include <string>
+#include <thread>
+using std::string;
+
+// popt
+#include <popt.h>
+
+#ifdef _WIN32
+// Win32 Unicode Translation Layer.
+// Needed for proper Unicode filename support on Windows.
+#include "libcompat/W32U/W32U_mini.h"
+#include "libcompat/W32U/W32U_argv.h"
+#define DIRSEP_CHR '\\'
+#else
+#define DIRSEP_CHR '/'
+#endif
+
+#define GENS_SNAP_VERSION 0x00010000U
+
+static void print_prg_info(void)
+{
+	fprintf(stderr, "gens-snap: Batch screenshot and thumbnail generator. (Version %d.%d)\n",
+		((GENS_SNAP_VERSION >> 24) & 0xFF),
+		((GENS_SNAP_VERSION >> 16) & 0xFF));
+	fprintf(stderr, "Part of Gens/GS II.\n");
+}
+
+static void print_help(const poptContext con)
+{
+	print_prg_info();
+	fputc('\n', stderr);
+	poptPrintHelp(con, stderr, 0);
+
+	fprintf(stderr,
+		"\n"
+		"Screenshots are written to DIR/ROMNAME.png, and thumbnails\n"
+		"are written to DIR/ROMNAME_thumb.png. Only Mega Drive and\n"
+		"Pico ROMs are supported.\n");
+}
+
+/**
+ * Look up a string option.
+ * @param str String.
+ * @param names Names, NULL-terminated.
+ * @return Index, or -1 if not found.
+ */
+static int lookup(const char *str, const char *const *names)
+{
+	for (int i = 0; names[i] != nullptr; i++) {
+		if (!strcasecmp(str, names[i]))
+			return i;
+	}
+	return -1;
+}
+
+/**
+ * Emulate a ROM and queue its images.
+ * @param encoder	PNG encoder.
+ * @param rom_filename	ROM filename.
+ * @param out_dir	Output directory.
+ * @param frames	Number of frames to run.
+ * @param screenshot	If true, save a full-size screenshot.
+ * @param thumb_width	Thumbnail width. (0 for none)
+ * @return 0 on success; negative errno on error.
+ */
+static int snapRom(PngEncoder *encoder, const char *rom_filename, const char *out_dir,
+		   int frames, bool screenshot, int thumb_width)
+{
+	Rom *rom = new Rom(rom_filename);
+	if (!rom->isOpen()) {
+		delete rom;
+		return -ENOENT;
+	}
+	if (rom->isMultiFile()) {
+		// Select the first file.
+		rom->select_z_entry(rom->get_z_entry_list());
+	}
+	if (!EmuContextFactory::isRomFormatSupported(rom) ||
+	    !EmuContextFactory::isRomSystemSupported(rom))
+	{
+		delete rom;
+		return -EINVAL;
+	}
+
+	// Detect the region. Default to US/NTSC.
+	// NOTE: Rom::regionCode() may be out of range for
+	// ROMs with garbage in the header.
+	SysVersion::RegionCode_t region = SysVersion::REGION_US_NTSC;
+	const int regionCode = rom->regionCode();
+	if (regionCode >= 0x0 && regionCode <= 0xF) {
+		region = SysVersion::DetectRegion(regionCode, 0x4812);
+		if (region == SysVersion::REGION_AUTO)
+			region = SysVersion::REGION_US_NTSC;
+	}
+
+	EmuContext *context = EmuContextFactory::createContext(rom, region);
+	if (!context || !context->isRomOpened()) {
+		delete context;
+		delete rom;
+		return -EIO;
+	}
+
+	// Don't load or save SRam/EEPRom.
+	context->setSaveDataEnable(false);
+	MdFb *fb = context->m_vdp->MD_Screen;
+	fb->setBpp(MdFb::BPP_32);
+
+	// Only the last frame has to be rendered.
+	for (int i = frames - 1; i > 0; i--) {
+		context->execFrameFast();
+	}
+	context->execFrame();
+
+	string out_base(out_dir);
+	out_base += DIRSEP_CHR;
+	out_base += rom->filename_baseNoExt();
+
+	int ret = 0;
+	if (screenshot) {
+		ret = Screenshot::toEncoder(encoder, (out_base + ".png").c_str(), fb, rom);
+	}
+	if (ret == 0 && thumb_width > 0) {
+		ret = Screenshot::toEncoder(encoder, (out_base + "_thumb.png").c_str(),
+					    fb, rom, thumb_width);
+	}
+
+	delete context;
+	delete rom;
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	static const char *const filter_names[] = {
+		"none", "sub", "up", "avg", "paeth", "adaptive", nullptr
+	};
+	static const char *const strategy_names[] = {
+		"default", "filtered", "rle", "huffman", nullptr
+	};
+
+	// Options.
+	const char *out_dir = ".";
+	int frames = 600;
+	int thumb_width = 0;
+	int no_screenshot = 0;
+	int threads = 0;
+	int level = 6;
+	const char *filter = "sub";
+	const char *strategy = "default";
+	int quiet = 0;
+
+	// popt: help options table.
+	struct poptOption helpOptionsTable[] = {
+		{"help", '?', POPT_ARG_NONE, NULL, '?', "Show this help message", NULL},
+		{"usage", 0, POPT_ARG_NONE, NULL, 'u', "Display brief usage message", NULL},
+		{"version", 'V', POPT_ARG_NONE, NULL, 'V', "Display version information", NULL},
+		POPT_TABLEEND
+	};
+
+	// popt: main options table.
+	struct poptOption optionsTable[] = {
+		{"output", 'o', POPT_ARG_STRING, &out_dir, 0,
+			"Output directory. (default = current directory)", "DIR"},
+		{"frames", 'n', POPT_ARG_INT, &frames, 0,
+			"Number of frames to run before taking the screenshot. (default = 600)", "N"},
+		{"thumb-width", 't', POPT_ARG_INT, &thumb_width, 0,
+			"Also write a thumbnail of this width. (default = none)", "WIDTH"},
+		{"no-screenshot", '\0', POPT_ARG_NONE, &no_screenshot, 0,
+			"Don't write full-size screenshots.", NULL},
+		{"jobs", 'j', POPT_ARG_INT, &threads, 0,
+			"Number of PNG encoding threads. (default = number of CPUs)", "N"},
+		{"level", 'l', POPT_ARG_INT, &level, 0,
+			"zlib compression level, 0-9. (default = 6)", "LEVEL"},
+		{"filter", 'f', POPT_ARG_STRING, &filter, 0,
+			"PNG row filter: none, sub (default), up, avg, paeth, adaptive", "FILTER"},
+		{"strategy", 's', POPT_ARG_STRING, &strategy, 0,
+			"zlib strategy: default (default), filtered, rle, huffman", "STRATEGY"},
+		{"quiet", 'q', POPT_ARG_NONE, &quiet, 0,
+			"Only print errors and the summary.", NULL},
+		{NULL, 0, POPT_ARG_INCLUDE_TABLE, helpOptionsTable, 0,
+			"Help options:", NULL},
+		POPT_TABLEEND
+	};
+	poptContext optCon;
+	int c;
+
+#ifdef _WIN32
+	// Convert command line parameters to UTF-8.
+	if (W32U_GetArgvU(&argc, &argv, nullptr) != 0) {
+		// ERROR!
+		return EXIT_FAILURE;
+	}
+#endif /* _WIN32 */
+
+	// Initialize locale settings.
+	setlocale(LC_ALL, "");
+
+	// Initialize the popt context.
+	optCon = poptGetContext(NULL, argc, (const char**)argv, optionsTable, 0);
+	poptSetOtherOptionHelp(optCon, "[OPTIONS...] <rom> [rom...]");
+	if (argc < 2) {
+		poptPrintUsage(optCon, stderr, 0);
+		return EXIT_FAILURE;
+	}
+
+	// Process options.
+	while ((c = poptGetNextOpt(optCon)) >= 0) {
+		switch (c) {
+			case 'V':
+				print_prg_info();
+				return EXIT_SUCCESS;
+
+			case '?':
+				print_help(optCon);
+				return EXIT_SUCCESS;
+
+			case 'u':
+				poptPrintUsage(optCon, stderr, 0);
+				return EXIT_SUCCESS;
+
+			default:
+				break;
+		}
+	}
+
+	if (c < -1) {
+		// An error occurred during option processing.
+		fprintf(stderr, "%s: '%s': %s\n"
+			"Try `%s --help` for more information.\n",
+			argv[0], poptBadOption(optCon, POPT_BADOPTION_NOALIAS),
+			poptStrerror(c), argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// Validate the options.
+	const int filter_idx = lookup(filter, filter_names);
+	const int strategy_idx = lookup(strategy, strategy_names);
+	if (filter_idx < 0 || strategy_idx < 0 || level < 0 || level > 9 ||
+	    frames < 1 || thumb_width < 0 || thumb_width > 4096 ||
+	    (no_screenshot && thumb_width == 0))
+	{
+		fprintf(stderr, "%s: invalid option value\n"
+			"Try `%s --help` for more information.\n",
+			argv[0], argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (poptPeekArg(optCon) == NULL) {
+		// No ROMs specified.
+		fprintf(stderr, "%s: no ROM images specified\n"
+			"Try `%s --help` for more information.\n",
+			argv[0], argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (threads <= 0) {
+		threads = (int)std::thread::hardware_concurrency();
+		if (threads <= 0)
+			threads = 1;
+	}
+
+	// Initialize LibGens.
+	LibGens::Init();
+
+	PngEncoder *encoder = new PngEncoder(threads);
+	encoder->setCompressionLevel(level);
+	encoder->setFilterMode((PngWriter::FilterMode)filter_idx);
+	encoder->setStrategy((PngWriter::Strategy)strategy_idx);
+
+	Timing timing;
+	const double start = timing.getTimeD();
+	unsigned int roms = 0, errors = 0;
+	const char *rom_filename;
+	while ((rom_filename = poptGetArg(optCon)) != NULL) {
+		int ret = snapRom(encoder, rom_filename, out_dir, frames,
+				  !no_screenshot, thumb_width);
+		if (ret != 0) {
+			fprintf(stderr, "%s: %s: %s\n", argv[0], rom_filename,
+				(ret == -EINVAL ? "ROM format or system not supported" : strerror(-ret)));
+			errors++;
+		} else {
+			roms++;
+			if (!quiet) {
+				printf("%s\n", rom_filename);
+			}
+		}
+	}
+	const double emulated = timing.getTimeD();
+	int ret = encoder->wait();
+	const double end = timing.getTimeD();
+	if (ret != 0) {
+		fprintf(stderr, "%s: error writing images: %s\n", argv[0], strerror(-ret));
+	}
+
+	const unsigned int written = encoder->writtenCount();
+	const unsigned int failed = encoder->failedCount();
+	const double elapsed = end - start;
+	printf("%u ROM(s), %u image(s) written, %u error(s) in %.3f s "
+		"(%.1f images/s, %d encoder thread(s), emulation %.3f s)\n",
+		roms, written, errors + failed, elapsed,
+		(elapsed > 0 ? written / elapsed : 0.0),
+		encoder->threadCount(), emulated - start);
+
+	delete encoder;
+	poptFreeContext(optCon);
+	LibGens::End();
+	return ((errors + failed) == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}